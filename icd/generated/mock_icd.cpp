@@ -22,18 +22,3717 @@
 #include "mock_icd.h"
 #include <stdlib.h>
 #include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <thread>
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#endif
 #include "vk_typemap_helper.h"
+#include "mock_icd_stats.h"
+#include "mock_icd_json.h"
+#include "mock_icd_shader.h"
+#include "mock_icd_raster.h"
 namespace vkmock {
 
 
-using std::unordered_map;
+// Backing store for device memory. Small allocations are carved out of per size class arenas and
+// recycled through free lists, large ones get their own reserved but uncommitted mapping so that
+// the advertised heaps can be used without consuming RAM until pages are actually written.
+static const VkDeviceSize MIN_MEMORY_SIZE_CLASS = 256;
+static const VkDeviceSize LARGE_MEMORY_ALLOCATION_SIZE = 256 * 1024;
+static const size_t MEMORY_ARENA_BLOCK_SIZE = 4 * 1024 * 1024;
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+static const size_t MEMORY_MAP_ALIGNMENT = 64;
+static const uint32_t MEMORY_SIZE_CLASS_COUNT = 11;  // MIN_MEMORY_SIZE_CLASS up to LARGE_MEMORY_ALLOCATION_SIZE
+static const uint32_t LARGE_MEMORY_SIZE_CLASS = UINT32_MAX;
+
+struct DeviceMemory {
+    void* data;
+    VkDeviceSize size;  // Size of the backing store, at least the requested allocation size
+    uint32_t size_class;
+    int fd;  // memfd backing exportable or imported memory, -1 otherwise
+    VkDeviceSize allocation_size;
+    uint32_t heap_index;
+    uint32_t physical_device_mask;  // Of the physical devices the memory takes heap space on
+    VkDeviceSize mapped_size;  // Size of the current mapping, 0 when unmapped
+};
+static ObjectTable<DeviceMemory> device_memory_table(STATS_OBJECT_VkDeviceMemory);
+
+static void* AllocateBackingPages(size_t size) {
+#if defined(__linux__) || defined(__APPLE__)
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (data == MAP_FAILED) return nullptr;
+#if defined(MADV_HUGEPAGE)
+    if (size >= HUGE_PAGE_SIZE) madvise(data, size, MADV_HUGEPAGE);
+#endif
+    return data;
+#else
+    // Keep the original pointer right in front of the aligned block so it can be released
+    char* base = static_cast<char*>(malloc(size + MEMORY_MAP_ALIGNMENT));
+    if (!base) return nullptr;
+    char* data = base + MEMORY_MAP_ALIGNMENT - (reinterpret_cast<uintptr_t>(base) & (MEMORY_MAP_ALIGNMENT - 1));
+    reinterpret_cast<char**>(data)[-1] = base;
+    return data;
+#endif
+}
+
+static void ReleaseBackingPages(void* data, size_t size) {
+#if defined(__linux__) || defined(__APPLE__)
+    munmap(data, size);
+#else
+    free(reinterpret_cast<char**>(data)[-1]);
+#endif
+}
+
+static mutex_t memory_arena_lock;
+static std::vector<void*> memory_arena_free_lists[MEMORY_SIZE_CLASS_COUNT];
+static char* memory_arena_cursors[MEMORY_SIZE_CLASS_COUNT];
+static char* memory_arena_ends[MEMORY_SIZE_CLASS_COUNT];
+
+static uint32_t GetMemorySizeClass(VkDeviceSize size) {
+    if (size > LARGE_MEMORY_ALLOCATION_SIZE) return LARGE_MEMORY_SIZE_CLASS;
+    uint32_t size_class = 0;
+    while ((MIN_MEMORY_SIZE_CLASS << size_class) < size) ++size_class;
+    return size_class;
+}
+
+static bool AllocateDeviceMemoryBacking(VkDeviceSize size, DeviceMemory* memory) {
+    memory->fd = -1;
+    memory->size_class = GetMemorySizeClass(size);
+    if (memory->size_class == LARGE_MEMORY_SIZE_CLASS) {
+        memory->size = size;
+        memory->data = AllocateBackingPages((size_t)size);
+        return memory->data != nullptr;
+    }
+    const size_t class_size = (size_t)(MIN_MEMORY_SIZE_CLASS << memory->size_class);
+    memory->size = class_size;
+    lock_guard_t lock(memory_arena_lock);
+    auto& free_list = memory_arena_free_lists[memory->size_class];
+    if (!free_list.empty()) {
+        memory->data = free_list.back();
+        free_list.pop_back();
+        return true;
+    }
+    // Each size class carves from its own block, which keeps every allocation aligned to its class size
+    char*& cursor = memory_arena_cursors[memory->size_class];
+    if (cursor == memory_arena_ends[memory->size_class]) {
+        // A failed block leaves the class as it was, to try again on the next allocation
+        char* block = static_cast<char*>(AllocateBackingPages(MEMORY_ARENA_BLOCK_SIZE));
+        if (!block) return false;
+        cursor = block;
+        memory_arena_ends[memory->size_class] = block + MEMORY_ARENA_BLOCK_SIZE;
+    }
+    memory->data = cursor;
+    cursor += class_size;
+    return true;
+}
+
+static void FreeDeviceMemoryBacking(const DeviceMemory& memory) {
+    if (memory.size_class == LARGE_MEMORY_SIZE_CLASS) {
+        ReleaseBackingPages(memory.data, (size_t)memory.size);
+#if defined(__linux__)
+        if (memory.fd >= 0) close(memory.fd);
+#endif
+        return;
+    }
+    lock_guard_t lock(memory_arena_lock);
+    memory_arena_free_lists[memory.size_class].push_back(memory.data);
+}
+
+// Memory that may be exported as an opaque fd lives in a memfd mapped shared, so every process that
+// imports the fd maps the very same pages and sees writes without any copies
+static bool MapDeviceMemoryFd(int fd, VkDeviceSize size, DeviceMemory* memory) {
+#if defined(__linux__)
+    void* data = mmap(nullptr, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) return false;
+    memory->data = data;
+    memory->size = size;
+    memory->size_class = LARGE_MEMORY_SIZE_CLASS;
+    memory->fd = fd;
+    return true;
+#else
+    return false;
+#endif
+}
+
+static bool AllocateDeviceMemoryFd(VkDeviceSize size, DeviceMemory* memory) {
+#if defined(__linux__) && defined(SYS_memfd_create)
+    const unsigned int memfd_cloexec = 0x1U;  // MFD_CLOEXEC
+    int fd = (int)syscall(SYS_memfd_create, "mock_icd_device_memory", memfd_cloexec);
+    if (fd < 0) return false;
+    if (ftruncate(fd, (off_t)size) != 0 || !MapDeviceMemoryFd(fd, size, memory)) {
+        close(fd);
+        return false;
+    }
+    return true;
+#else
+    return AllocateDeviceMemoryBacking(size, memory);
+#endif
+}
+
+static bool ImportDeviceMemoryFd(int fd, VkDeviceSize size, DeviceMemory* memory) {
+#if defined(__linux__)
+    struct stat fd_stat;
+    if (fstat(fd, &fd_stat) != 0 || (VkDeviceSize)fd_stat.st_size < size) return false;
+#endif
+    return MapDeviceMemoryFd(fd, size, memory);
+}
+
+// Physical devices, VK_MOCK_PHYSICAL_DEVICES of them (default 1), all reporting the device profile. With
+// VK_MOCK_DEVICE_GROUP set to something other than 0 they form one device group, otherwise each is a group of its own.
+// Created by the first vkEnumeratePhysicalDevices or vkEnumeratePhysicalDeviceGroups and destroyed with the instance.
+static const uint32_t MAX_PHYSICAL_DEVICES = 8;
+struct PhysicalDevice {
+    VK_LOADER_DATA loader_data;  // Must come first, the VkPhysicalDevice handle points at it
+    uint32_t index;              // In physical_devices
+    std::atomic<VkDeviceSize> heap_usage[VK_MAX_MEMORY_HEAPS];  // Bytes allocated from each heap
+};
+static PhysicalDevice* physical_devices[MAX_PHYSICAL_DEVICES];
+static uint32_t physical_device_count = 0;
+static bool physical_device_group = false;
+
+static void InitPhysicalDevices() {
+    lock_guard_t lock(global_lock);
+    if (physical_device_count) return;
+    const char* count = getenv("VK_MOCK_PHYSICAL_DEVICES");
+    physical_device_count = count ? std::min(std::max((uint32_t)strtoul(count, nullptr, 10), 1u), MAX_PHYSICAL_DEVICES) : 1;
+    physical_device_group = getenv("VK_MOCK_DEVICE_GROUP") && strcmp(getenv("VK_MOCK_DEVICE_GROUP"), "0") != 0;
+    for (uint32_t i = 0; i < physical_device_count; ++i) {
+        physical_devices[i] = new PhysicalDevice();
+        set_loader_magic_value(&physical_devices[i]->loader_data);
+        physical_devices[i]->index = i;
+    }
+}
+
+// Fences and semaphores are signalled by the queue workers and waited on by the host and by the queues of the device
+// they belong to. Every signal bumps the device's epoch, waiters sleep on it (a futex on Linux) and then re-check
+// whatever they are waiting for, so signals on one device never wake the waiters of another.
+struct SyncEpoch {
+    std::atomic<uint32_t> epoch{0};
+    std::atomic<uint32_t> waiters{0};
+#if !defined(__linux__)
+    mutex_t lock;
+    std::condition_variable cv;
+#endif
+};
+
+// Devices only lock their own objects, so threads using different devices never contend. Queues are created the
+// first time they are retrieved, and kept by family and index.
+struct Device {
+    VK_LOADER_DATA loader_data;  // Must come first, the VkDevice handle points at it
+    std::vector<PhysicalDevice*> physical_devices;  // By device index, more than one for devices of a device group
+    mutex_t lock;  // Guards queues
+    std::vector<std::vector<VkQueue>> queues;
+    mutex_t descriptor_lock;  // Guards the descriptor pools and sets
+    mutex_t sync_lock;        // Guards the submitted counters of the semaphores, and the swapchains
+    SyncEpoch sync;
+    std::atomic<uint64_t> pending_submissions{0};  // Enqueued on the queues and not finished executing
+};
+
+// Memory bound to a buffer or image. Queue workers look the memory up when they execute transfers, so
+// commands using memory freed since the binding are skipped rather than touching freed pages.
+struct MemoryBinding {
+    VkDeviceMemory memory;
+    VkDeviceSize offset;
+};
+
+struct Buffer {
+    VkBufferCreateInfo create_info;  // pNext is not kept
+    MemoryBinding binding;
+};
+static ObjectTable<Buffer> buffer_table(STATS_OBJECT_VkBuffer);
+
+// Descriptor types are counted in arrays indexed by GetDescriptorTypeIndex
+static const uint32_t DESCRIPTOR_TYPE_COUNT = VK_DESCRIPTOR_TYPE_RANGE_SIZE + 2;
+
+// DESCRIPTOR_TYPE_COUNT for types the mock does not know
+static uint32_t GetDescriptorTypeIndex(VkDescriptorType type) {
+    if (type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) return VK_DESCRIPTOR_TYPE_RANGE_SIZE;
+    if (type == VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_NV) return VK_DESCRIPTOR_TYPE_RANGE_SIZE + 1;
+    return (uint32_t)type < VK_DESCRIPTOR_TYPE_RANGE_SIZE ? (uint32_t)type : DESCRIPTOR_TYPE_COUNT;
+}
+
+static bool IsBufferDescriptor(VkDescriptorType type) {
+    return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+           type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+}
+
+static bool IsDynamicBufferDescriptor(VkDescriptorType type) {
+    return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+}
+
+static bool IsTexelBufferDescriptor(VkDescriptorType type) {
+    return type == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+}
+
+// Descriptors shaders sample through
+static bool IsImageDescriptor(VkDescriptorType type) {
+    return type == VK_DESCRIPTOR_TYPE_SAMPLER || type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER || type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+}
+
+// A descriptor written to a set, held in the member the type of its binding uses
+union Descriptor {
+    VkDescriptorBufferInfo buffer;  // Uniform and storage buffers
+    VkDescriptorImageInfo image;    // Samplers, images and input attachments
+    VkBufferView texel_buffer;      // Uniform and storage texel buffers
+};
+
+// A set holds the descriptors of all the bindings of its layout in one array, each binding's from its first, in
+// binding order. Inline uniform blocks count bytes, which are not kept, so they take no descriptors.
+struct DescriptorLayoutBinding {
+    VkDescriptorType type;
+    uint32_t count;    // 0 for binding numbers the layout does not use
+    uint32_t first;    // Index of the binding's first descriptor in a set's
+    uint32_t dynamic;  // Index of the binding's first dynamic offset, for dynamic buffers
+    std::vector<VkSampler> immutable_samplers;  // Empty without
+};
+struct DescriptorTypeCount {
+    uint32_t index;  // GetDescriptorTypeIndex of the type
+    uint32_t count;
+};
+// Sets share the layout they were allocated with, which outlives its handle as long as they do
+struct DescriptorSetLayout {
+    std::vector<DescriptorLayoutBinding> bindings;  // By binding number
+    std::vector<DescriptorTypeCount> type_counts;   // Descriptors of each type the layout uses a set takes from its pool
+    uint32_t descriptor_count = 0;                  // Size of a set's array
+    uint32_t dynamic_count = 0;                     // Dynamic offsets binding a set takes
+    bool variable_count = false;  // The last binding's count is given when sets are allocated, up to the count above
+};
+static ObjectTable<std::shared_ptr<const DescriptorSetLayout>> descriptor_set_layout_table(STATS_OBJECT_VkDescriptorSetLayout);
+
+// Descriptor pools keep the descriptors of their sets in one array, with room for all their pool sizes. Each set
+// takes a range of it: one a freed set of the same size left, else the next one no set has used. Sets or descriptors
+// of a type beyond what the pool was created with fail with VK_ERROR_OUT_OF_POOL_MEMORY, and like a driver's, a pool
+// whose sets are freed and allocated with layouts of different sizes can fail with VK_ERROR_FRAGMENTED_POOL with
+// descriptors to spare. Guarded by the descriptor_lock of their device.
+struct DescriptorPool {
+    uint32_t max_sets = 0;
+    uint32_t capacity[DESCRIPTOR_TYPE_COUNT] = {};   // Descriptors of each type, from the pool sizes
+    uint32_t allocated[DESCRIPTOR_TYPE_COUNT] = {};  // Taken by the pool's sets
+    std::unique_ptr<Descriptor[]> descriptors;      // Left uninitialized until sets take them
+    uint32_t descriptor_count = 0;
+    uint32_t next_descriptor = 0;  // First of the descriptors no set has used
+    std::map<uint32_t, std::vector<uint32_t>> free_ranges;  // First descriptors of the ranges freed sets left, by size
+    std::vector<VkDescriptorSet> sets;  // Destroyed along with the pool when it is reset or destroyed
+};
+struct DescriptorSet {
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    size_t pool_index = 0;  // Position in the pool's sets
+    std::shared_ptr<const DescriptorSetLayout> layout;
+    Descriptor* descriptors = nullptr;  // In the pool's array
+    uint32_t first = 0;                 // Index of the set's first descriptor in the pool's array
+    uint32_t descriptor_count = 0;
+    uint32_t variable_count = 0;  // Count of the last binding of layouts with a variable count
+};
+static ObjectTable<DescriptorPool> descriptor_pool_table(STATS_OBJECT_VkDescriptorPool);
+static ObjectTable<DescriptorSet> descriptor_set_table(STATS_OBJECT_VkDescriptorSet);
+
+static std::shared_ptr<const DescriptorSetLayout> CreateDescriptorSetLayoutState(const VkDescriptorSetLayoutCreateInfo& create_info) {
+    std::shared_ptr<DescriptorSetLayout> layout(new DescriptorSetLayout());
+    const auto flags_info = lvl_find_in_chain<VkDescriptorSetLayoutBindingFlagsCreateInfo>(create_info.pNext);
+    uint32_t variable_binding = UINT32_MAX;
+    for (uint32_t i = 0; i < create_info.bindingCount; ++i) {
+        const VkDescriptorSetLayoutBinding& binding = create_info.pBindings[i];
+        if (binding.binding >= layout->bindings.size()) layout->bindings.resize(binding.binding + 1);
+        DescriptorLayoutBinding& entry = layout->bindings[binding.binding];
+        entry.type = binding.descriptorType;
+        entry.count = binding.descriptorCount;
+        if (binding.pImmutableSamplers &&
+            (binding.descriptorType == VK_DESCRIPTOR_TYPE_SAMPLER || binding.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)) {
+            entry.immutable_samplers.assign(binding.pImmutableSamplers, binding.pImmutableSamplers + binding.descriptorCount);
+        }
+        if (flags_info && i < flags_info->bindingCount && (flags_info->pBindingFlags[i] & VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT)) {
+            variable_binding = binding.binding;
+        }
+    }
+    layout->variable_count = variable_binding != UINT32_MAX && variable_binding + 1 == layout->bindings.size();
+    uint32_t type_counts[DESCRIPTOR_TYPE_COUNT] = {};
+    for (auto& binding : layout->bindings) {
+        binding.first = layout->descriptor_count;
+        binding.dynamic = layout->dynamic_count;
+        if (binding.type != VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) layout->descriptor_count += binding.count;
+        if (IsDynamicBufferDescriptor(binding.type)) layout->dynamic_count += binding.count;
+        const uint32_t index = GetDescriptorTypeIndex(binding.type);
+        if (index < DESCRIPTOR_TYPE_COUNT) type_counts[index] += binding.count;
+    }
+    for (uint32_t i = 0; i < DESCRIPTOR_TYPE_COUNT; ++i) {
+        if (type_counts[i]) layout->type_counts.push_back({i, type_counts[i]});
+    }
+    return layout;
+}
+
+static DescriptorPool CreateDescriptorPoolState(const VkDescriptorPoolCreateInfo& create_info) {
+    DescriptorPool pool;
+    pool.max_sets = create_info.maxSets;
+    for (uint32_t i = 0; i < create_info.poolSizeCount; ++i) {
+        const VkDescriptorPoolSize& size = create_info.pPoolSizes[i];
+        const uint32_t index = GetDescriptorTypeIndex(size.type);
+        if (index == DESCRIPTOR_TYPE_COUNT) continue;
+        pool.capacity[index] += size.descriptorCount;
+        if (size.type != VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) pool.descriptor_count += size.descriptorCount;
+    }
+    pool.descriptors.reset(new Descriptor[pool.descriptor_count]);
+    return pool;
+}
+
+static uint32_t GetBindingCount(const DescriptorSet& set, uint32_t binding) {
+    const DescriptorSetLayout& layout = *set.layout;
+    if (layout.variable_count && binding + 1 == layout.bindings.size()) return std::min(set.variable_count, layout.bindings[binding].count);
+    return layout.bindings[binding].count;
+}
+
+// Descriptors of one of the types of its layout a set takes from its pool
+static uint32_t GetDescriptorCount(const DescriptorSet& set, const DescriptorTypeCount& type_count) {
+    const DescriptorSetLayout& layout = *set.layout;
+    if (!layout.variable_count || GetDescriptorTypeIndex(layout.bindings.back().type) != type_count.index) return type_count.count;
+    return type_count.count - (layout.bindings.back().count - GetBindingCount(set, (uint32_t)layout.bindings.size() - 1));
+}
+
+// The following helpers must be called with the descriptor_lock of the device held
+
+// Takes the descriptors of a set with its layout and variable count from the pool, and clears them
+static VkResult AllocateDescriptors(DescriptorPool* pool, DescriptorSet* set) {
+    if (pool->sets.size() >= pool->max_sets) return VK_ERROR_OUT_OF_POOL_MEMORY;
+    const DescriptorSetLayout& layout = *set->layout;
+    for (const auto& type_count : layout.type_counts) {
+        if (GetDescriptorCount(*set, type_count) > pool->capacity[type_count.index] - pool->allocated[type_count.index]) {
+            return VK_ERROR_OUT_OF_POOL_MEMORY;
+        }
+    }
+    set->descriptor_count = layout.descriptor_count;
+    if (layout.variable_count && layout.bindings.back().type != VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) {
+        set->descriptor_count -= layout.bindings.back().count - GetBindingCount(*set, (uint32_t)layout.bindings.size() - 1);
+    }
+    auto range = pool->free_ranges.find(set->descriptor_count);
+    if (range != pool->free_ranges.end()) {
+        set->first = range->second.back();
+        range->second.pop_back();
+        if (range->second.empty()) pool->free_ranges.erase(range);
+    } else if (set->descriptor_count <= pool->descriptor_count - pool->next_descriptor) {
+        set->first = pool->next_descriptor;
+        pool->next_descriptor += set->descriptor_count;
+    } else {
+        return VK_ERROR_FRAGMENTED_POOL;
+    }
+    for (const auto& type_count : layout.type_counts) pool->allocated[type_count.index] += GetDescriptorCount(*set, type_count);
+    set->descriptors = pool->descriptors.get() + set->first;
+    std::fill(set->descriptors, set->descriptors + set->descriptor_count, Descriptor{});
+    for (uint32_t b = 0; b < layout.bindings.size(); ++b) {
+        const auto& samplers = layout.bindings[b].immutable_samplers;
+        const uint32_t count = std::min((uint32_t)samplers.size(), GetBindingCount(*set, b));
+        for (uint32_t i = 0; i < count; ++i) set->descriptors[layout.bindings[b].first + i].image.sampler = samplers[i];
+    }
+    return VK_SUCCESS;
+}
+
+static void FreeDescriptorSet(VkDescriptorSet descriptor_set) {
+    const DescriptorSet* set = descriptor_set_table.Get(descriptor_set);
+    if (!set) return;
+    if (DescriptorPool* pool = descriptor_pool_table.Get(set->pool)) {
+        for (const auto& type_count : set->layout->type_counts) pool->allocated[type_count.index] -= GetDescriptorCount(*set, type_count);
+        if (set->first + set->descriptor_count == pool->next_descriptor) {
+            pool->next_descriptor = set->first;
+        } else if (set->descriptor_count) {
+            pool->free_ranges[set->descriptor_count].push_back(set->first);
+        }
+        pool->sets[set->pool_index] = pool->sets.back();
+        descriptor_set_table.Get(pool->sets.back())->pool_index = set->pool_index;
+        pool->sets.pop_back();
+        // An empty pool is no longer fragmented
+        if (pool->sets.empty()) {
+            pool->next_descriptor = 0;
+            pool->free_ranges.clear();
+        }
+    }
+    descriptor_set_table.Destroy(descriptor_set);
+}
+
+static void FreeDescriptorPoolSets(DescriptorPool* pool) {
+    for (auto set : pool->sets) descriptor_set_table.Destroy(set);
+    pool->sets.clear();
+    std::fill(pool->allocated, pool->allocated + DESCRIPTOR_TYPE_COUNT, 0);
+    pool->next_descriptor = 0;
+    pool->free_ranges.clear();
+}
+
+// Position of an update in a set. Updates running past the end of a binding continue with the next one.
+struct DescriptorCursor {
+    // Returns the descriptor at the position and moves past it, null once the update runs out of bindings of its type
+    Descriptor* Next(VkDescriptorType type) {
+        const auto& bindings = set->layout->bindings;
+        while (binding < bindings.size() && element >= GetBindingCount(*set, binding)) {
+            element -= GetBindingCount(*set, binding);
+            ++binding;
+        }
+        if (binding >= bindings.size() || bindings[binding].type != type || type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) return nullptr;
+        entry = &bindings[binding];
+        return &set->descriptors[entry->first + element++];
+    }
+    const DescriptorSet* set;
+    uint32_t binding;
+    uint32_t element;
+    const DescriptorLayoutBinding* entry;  // Of the descriptor Next returned last
+};
+
+static void WriteDescriptors(DescriptorSet* set, const VkWriteDescriptorSet& write) {
+    const VkDescriptorType type = write.descriptorType;
+    const bool image = IsImageDescriptor(type) || type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE || type == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    const bool has_info = IsBufferDescriptor(type) ? write.pBufferInfo != nullptr
+                          : IsTexelBufferDescriptor(type) ? write.pTexelBufferView != nullptr
+                          : image && write.pImageInfo != nullptr;
+    if (!has_info) return;
+    DescriptorCursor cursor = {set, write.dstBinding, write.dstArrayElement, nullptr};
+    for (uint32_t i = 0; i < write.descriptorCount; ++i) {
+        Descriptor* descriptor = cursor.Next(type);
+        if (!descriptor) return;
+        if (IsBufferDescriptor(type)) {
+            descriptor->buffer = write.pBufferInfo[i];
+        } else if (IsTexelBufferDescriptor(type)) {
+            descriptor->texel_buffer = write.pTexelBufferView[i];
+        } else {
+            const VkSampler sampler = descriptor->image.sampler;
+            descriptor->image = write.pImageInfo[i];
+            if (!cursor.entry->immutable_samplers.empty()) descriptor->image.sampler = sampler;
+        }
+    }
+}
+
+static void CopyDescriptors(const VkCopyDescriptorSet& copy) {
+    const DescriptorSet* src = descriptor_set_table.Get(copy.srcSet);
+    const DescriptorSet* dst = descriptor_set_table.Get(copy.dstSet);
+    if (!src || !dst || copy.srcBinding >= src->layout->bindings.size()) return;
+    const VkDescriptorType type = src->layout->bindings[copy.srcBinding].type;
+    DescriptorCursor source = {src, copy.srcBinding, copy.srcArrayElement, nullptr};
+    DescriptorCursor destination = {dst, copy.dstBinding, copy.dstArrayElement, nullptr};
+    for (uint32_t i = 0; i < copy.descriptorCount; ++i) {
+        const Descriptor* from = source.Next(type);
+        Descriptor* to = destination.Next(type);
+        if (!from || !to) return;
+        if (destination.entry->immutable_samplers.empty()) {
+            *to = *from;
+        } else {
+            const VkSampler sampler = to->image.sampler;
+            *to = *from;
+            to->image.sampler = sampler;
+        }
+    }
+}
+
+// Identity of the mock device unless a profile says otherwise
+static const uint32_t MOCK_VENDOR_ID = 0xba5eba11;
+static const uint32_t MOCK_DEVICE_ID = 0xf005ba11;
+static const uint8_t PIPELINE_CACHE_UUID[VK_UUID_SIZE] = {18, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1};
+
+// Formats the mock knows about, in the same ranges vulkaninfo reports. Format tables hold an entry for
+// every format of these ranges in order.
+struct FormatRange {
+    VkFormat first;
+    VkFormat last;
+};
+static const FormatRange format_ranges[] = {
+    {VK_FORMAT_BEGIN_RANGE, VK_FORMAT_END_RANGE},
+    {VK_FORMAT_G8B8G8R8_422_UNORM, VK_FORMAT_G16_B16_R16_3PLANE_444_UNORM},
+    {VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG, VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG},
+};
+static const uint32_t FORMAT_COUNT = (VK_FORMAT_END_RANGE - VK_FORMAT_BEGIN_RANGE + 1) +
+                                     (VK_FORMAT_G16_B16_R16_3PLANE_444_UNORM - VK_FORMAT_G8B8G8R8_422_UNORM + 1) +
+                                     (VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG - VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG + 1);
+
+// Returns the format's index in format tables, FORMAT_COUNT for formats the mock does not know
+static uint32_t GetFormatIndex(VkFormat format) {
+    uint32_t base = 0;
+    for (const auto& range : format_ranges) {
+        if (format >= range.first && format <= range.last) return base + (format - range.first);
+        base += range.last - range.first + 1;
+    }
+    return FORMAT_COUNT;
+}
+
+// Returns the texel block layout of a format, nullptr for formats the mock does not know
+static const FormatInfo* GetFormatInfo(VkFormat format) {
+    struct FormatInfoIndex {
+        const FormatInfo* infos[FORMAT_COUNT + 1] = {};  // The last entry collects formats outside the ranges
+        FormatInfoIndex() {
+            for (const auto& info : format_infos) infos[GetFormatIndex(info.format)] = &info;
+            infos[FORMAT_COUNT] = nullptr;
+        }
+    };
+    static const FormatInfoIndex index;
+    return index.infos[GetFormatIndex(format)];
+}
+
+// Images are laid out the way common desktop drivers lay out linear images, whatever their tiling. Each
+// array layer holds a full mip chain, levels start on IMAGE_SUBRESOURCE_ALIGNMENT and rows are padded to
+// IMAGE_ROW_PITCH_ALIGNMENT. The planes of multi-planar formats follow each other, each with all its layers.
+static const VkDeviceSize IMAGE_ROW_PITCH_ALIGNMENT = 256;
+static const VkDeviceSize IMAGE_SUBRESOURCE_ALIGNMENT = 256;
+static const VkDeviceSize IMAGE_ALIGNMENT = 4096;
+// Formats missing from format_infos get the layout of the widest uncompressed texel
+static const FormatInfo UNKNOWN_FORMAT_INFO = {VK_FORMAT_UNDEFINED, 32, {1, 1, 1}, 1, {{32, 1, 1}}};
+
+static inline VkDeviceSize AlignDeviceSize(VkDeviceSize size, VkDeviceSize alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+struct Image {
+    VkImageCreateInfo create_info;  // pNext and the queue family indices are not kept
+    // Layout of every mip level of every plane in array layer 0, indexed by plane * mipLevels + level
+    std::vector<VkSubresourceLayout> subresources;
+    VkDeviceSize plane_offsets[MAX_FORMAT_PLANES + 1];  // The last one is the size of the image
+    // Memory bound to each plane. Planes of disjoint images are bound on their own, the others all share the binding
+    // of the whole image. Swapchain images are backed by their swapchain instead.
+    MemoryBinding bindings[MAX_FORMAT_PLANES] = {};
+    char* swapchain_data = nullptr;
+};
+static ObjectTable<Image> image_table(STATS_OBJECT_VkImage);
+
+static Image CreateImageState(const VkImageCreateInfo& create_info) {
+    Image image;
+    image.create_info = create_info;
+    image.create_info.pNext = nullptr;
+    image.create_info.queueFamilyIndexCount = 0;
+    image.create_info.pQueueFamilyIndices = nullptr;
+    image.create_info.mipLevels = std::max(create_info.mipLevels, 1u);
+    image.create_info.arrayLayers = std::max(create_info.arrayLayers, 1u);
+    const VkImageCreateInfo& info = image.create_info;
+    const FormatInfo* format_info = GetFormatInfo(info.format);
+    if (!format_info) format_info = &UNKNOWN_FORMAT_INFO;
+    // Sample count bits have the value of the count
+    const VkDeviceSize samples = std::max<VkDeviceSize>(info.samples, 1);
+    image.subresources.resize(format_info->plane_count * info.mipLevels);
+    VkDeviceSize offset = 0;
+    for (uint32_t plane = 0; plane < format_info->plane_count; ++plane) {
+        const FormatPlane& plane_info = format_info->planes[plane];
+        const VkExtent3D& block = format_info->block_extent;
+        offset = AlignDeviceSize(offset, IMAGE_ALIGNMENT);
+        image.plane_offsets[plane] = offset;
+        for (uint32_t level = 0; level < info.mipLevels; ++level) {
+            const uint32_t width = std::max(info.extent.width >> level, 1u);
+            const uint32_t height = std::max(info.extent.height >> level, 1u);
+            const uint32_t depth = std::max(info.extent.depth >> level, 1u);
+            const VkDeviceSize blocks_x = (width + plane_info.width_divisor * block.width - 1) / (plane_info.width_divisor * block.width);
+            const VkDeviceSize blocks_y = (height + plane_info.height_divisor * block.height - 1) / (plane_info.height_divisor * block.height);
+            const VkDeviceSize blocks_z = (depth + block.depth - 1) / block.depth;
+            VkSubresourceLayout& layout = image.subresources[plane * info.mipLevels + level];
+            offset = AlignDeviceSize(offset, IMAGE_SUBRESOURCE_ALIGNMENT);
+            layout.offset = offset;
+            layout.rowPitch = AlignDeviceSize(blocks_x * plane_info.block_size, IMAGE_ROW_PITCH_ALIGNMENT);
+            layout.depthPitch = layout.rowPitch * blocks_y;
+            layout.size = layout.depthPitch * blocks_z * samples;
+            offset += layout.size;
+        }
+        const VkDeviceSize array_pitch = AlignDeviceSize(offset - image.plane_offsets[plane], IMAGE_SUBRESOURCE_ALIGNMENT);
+        for (uint32_t level = 0; level < info.mipLevels; ++level) {
+            image.subresources[plane * info.mipLevels + level].arrayPitch = array_pitch;
+        }
+        offset = image.plane_offsets[plane] + array_pitch * info.arrayLayers;
+    }
+    for (uint32_t plane = format_info->plane_count; plane <= MAX_FORMAT_PLANES; ++plane) image.plane_offsets[plane] = offset;
+    return image;
+}
+
+// Returns the plane of a multi-planar format that an aspect selects, 0 for other aspects
+static uint32_t GetAspectPlane(VkImageAspectFlags aspect_mask) {
+    if (aspect_mask & VK_IMAGE_ASPECT_PLANE_1_BIT) return 1;
+    if (aspect_mask & VK_IMAGE_ASPECT_PLANE_2_BIT) return 2;
+    return 0;
+}
+
+// Image views keep the subresources they view, with VK_REMAINING_MIP_LEVELS and VK_REMAINING_ARRAY_LAYERS resolved
+struct ImageView {
+    VkImage image;
+    VkImageViewType view_type;
+    VkFormat format;
+    VkComponentMapping components;
+    VkImageSubresourceRange range;
+};
+static ObjectTable<ImageView> image_view_table(STATS_OBJECT_VkImageView);
+
+static ImageView CreateImageViewState(const VkImageViewCreateInfo& create_info) {
+    ImageView view = {create_info.image, create_info.viewType, create_info.format, create_info.components, create_info.subresourceRange};
+    if (const Image* image = image_table.Get(create_info.image)) {
+        const VkImageCreateInfo& info = image->create_info;
+        if (view.range.levelCount == VK_REMAINING_MIP_LEVELS) view.range.levelCount = info.mipLevels - std::min(view.range.baseMipLevel, info.mipLevels);
+        if (view.range.layerCount == VK_REMAINING_ARRAY_LAYERS) {
+            view.range.layerCount = info.arrayLayers - std::min(view.range.baseArrayLayer, info.arrayLayers);
+        }
+    }
+    return view;
+}
+
+struct Sampler {
+    VkSamplerCreateInfo create_info;  // pNext is not kept
+};
+static ObjectTable<Sampler> sampler_table(STATS_OBJECT_VkSampler);
+
+static ObjectTable<RenderPass> render_pass_table(STATS_OBJECT_VkRenderPass);
+
+// Takes VkRenderPassCreateInfo or VkRenderPassCreateInfo2, whose structures share the members kept
+template <typename CreateInfo>
+static RenderPass CreateRenderPassState(const CreateInfo& create_info) {
+    RenderPass render_pass;
+    for (uint32_t i = 0; i < create_info.attachmentCount; ++i) {
+        const auto& attachment = create_info.pAttachments[i];
+        const VkAttachmentDescription description = {attachment.flags,         attachment.format,        attachment.samples,
+                                                     attachment.loadOp,        attachment.storeOp,       attachment.stencilLoadOp,
+                                                     attachment.stencilStoreOp, attachment.initialLayout, attachment.finalLayout};
+        render_pass.attachments.push_back(description);
+    }
+    render_pass.first_subpasses.assign(create_info.attachmentCount, UINT32_MAX);
+    render_pass.last_subpasses.assign(create_info.attachmentCount, UINT32_MAX);
+    for (uint32_t s = 0; s < create_info.subpassCount; ++s) {
+        const auto& description = create_info.pSubpasses[s];
+        const auto use = [&render_pass, s](uint32_t attachment) {
+            if (attachment >= render_pass.attachments.size()) return;
+            if (render_pass.first_subpasses[attachment] == UINT32_MAX) render_pass.first_subpasses[attachment] = s;
+            render_pass.last_subpasses[attachment] = s;
+        };
+        RenderSubpass subpass;
+        for (uint32_t i = 0; i < description.colorAttachmentCount; ++i) {
+            subpass.colors.push_back(description.pColorAttachments[i].attachment);
+            use(description.pColorAttachments[i].attachment);
+            if (description.pResolveAttachments) use(description.pResolveAttachments[i].attachment);
+        }
+        for (uint32_t i = 0; i < description.inputAttachmentCount; ++i) use(description.pInputAttachments[i].attachment);
+        if (description.pDepthStencilAttachment) {
+            subpass.depth_stencil = description.pDepthStencilAttachment->attachment;
+            use(subpass.depth_stencil);
+        }
+        render_pass.subpasses.push_back(subpass);
+    }
+    return render_pass;
+}
+
+// Imageless framebuffers get their attachments when a render pass begins, which the mock does not record, so they
+// have none
+struct Framebuffer {
+    std::vector<VkImageView> attachments;
+    uint32_t width;
+    uint32_t height;
+    uint32_t layers;
+};
+static ObjectTable<Framebuffer> framebuffer_table(STATS_OBJECT_VkFramebuffer);
+
+// Everything the physical device reports, set up once by the first vkCreateInstance either from the
+// built-in defaults or from the vulkaninfo JSON profile named by VK_MOCK_PROFILE
+static const uint32_t MAX_PROFILE_QUEUE_FAMILIES = 16;
+struct DeviceProfile {
+    bool loaded = false;
+    bool from_file = false;
+    VkPhysicalDeviceProperties properties;
+    VkPhysicalDeviceFeatures features;
+    VkPhysicalDeviceMemoryProperties memory_properties;
+    uint32_t queue_family_count;
+    VkQueueFamilyProperties queue_families[MAX_PROFILE_QUEUE_FAMILIES];
+    VkFormatProperties format_properties[FORMAT_COUNT];
+};
+static DeviceProfile device_profile;
+
+static const VkFormatProperties* GetProfileFormatProperties(VkFormat format) {
+    const uint32_t index = GetFormatIndex(format);
+    return index < FORMAT_COUNT ? &device_profile.format_properties[index] : nullptr;
+}
+
+// Physical devices keep count of the bytes of each heap the application's allocations take, reported through
+// VK_EXT_memory_budget. The application has the device to itself, so its budget is the whole heap, and allocations
+// that would go past the size the profile gives the heap fail with VK_ERROR_OUT_OF_DEVICE_MEMORY. Memory allocated on
+// several physical devices of a group counts on each of them, though they share a single copy of it.
+
+// Physical devices, as a mask of their indices in physical_devices, an allocation of a device is made on
+static uint32_t GetAllocationPhysicalDeviceMask(const Device& device, const VkMemoryAllocateFlagsInfo* flags_info) {
+    const bool masked = flags_info && (flags_info->flags & VK_MEMORY_ALLOCATE_DEVICE_MASK_BIT);
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < device.physical_devices.size(); ++i) {
+        if (!masked || (flags_info->deviceMask & (1u << i))) mask |= 1u << device.physical_devices[i]->index;
+    }
+    return mask;
+}
+
+static void ReleaseHeapMemory(uint32_t physical_device_mask, uint32_t heap_index, VkDeviceSize size) {
+    for (uint32_t i = 0; i < physical_device_count; ++i) {
+        if (physical_device_mask & (1u << i)) physical_devices[i]->heap_usage[heap_index].fetch_sub(size, std::memory_order_relaxed);
+    }
+}
+
+// Returns false, taking nothing, if the heap has less than size bytes left on any of the physical devices
+static bool ReserveHeapMemory(uint32_t physical_device_mask, uint32_t heap_index, VkDeviceSize size) {
+    if (heap_index >= device_profile.memory_properties.memoryHeapCount) return false;
+    const VkDeviceSize heap_size = device_profile.memory_properties.memoryHeaps[heap_index].size;
+    for (uint32_t i = 0; i < physical_device_count; ++i) {
+        if (!(physical_device_mask & (1u << i))) continue;
+        std::atomic<VkDeviceSize>& heap_usage = physical_devices[i]->heap_usage[heap_index];
+        VkDeviceSize usage = heap_usage.load(std::memory_order_relaxed);
+        do {
+            if (size > heap_size - std::min(usage, heap_size)) {
+                ReleaseHeapMemory(physical_device_mask & ((1u << i) - 1), heap_index, size);
+                return false;
+            }
+        } while (!heap_usage.compare_exchange_weak(usage, usage + size, std::memory_order_relaxed));
+    }
+    return true;
+}
+
+// Every memory type of the profile can back buffers and images
+static uint32_t GetMemoryTypeBits() {
+    return (uint32_t)((1ull << device_profile.memory_properties.memoryTypeCount) - 1);
+}
+
+// Pipeline cache data is only accepted back when its header matches the device
+static const size_t PIPELINE_CACHE_HEADER_SIZE = 16 + VK_UUID_SIZE;
+
+// 64-bit FNV-1a. Pipelines are identified by a hash of everything in their create info that affects
+// the compiled result: shader code, entry points, specialization constants and fixed-function state.
+// Layout and render pass handles are left out so that keys are stable across runs.
+struct Hasher {
+    uint64_t hash = 14695981039346656037ULL;
+    void Add(const void* data, size_t size) {
+        auto bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    template <typename T>
+    void AddValue(const T& value) { Add(&value, sizeof(T)); }
+    // Hashes the fields from first to last inclusive, which must all be 4 bytes wide
+    template <typename F, typename L>
+    void AddFields(const F& first, const L& last) {
+        Add(&first, reinterpret_cast<const char*>(&last + 1) - reinterpret_cast<const char*>(&first));
+    }
+    template <typename T>
+    void AddArray(const T* data, uint32_t count) {
+        AddValue(data ? count : 0);
+        if (data) Add(data, sizeof(T) * count);
+    }
+    void AddString(const char* string) {
+        if (string) Add(string, strlen(string));
+        AddValue('\0');
+    }
+};
+
+// Pipelines translate the SPIR-V of their stages into the programs mock_icd_shader.h runs
+struct ShaderModule {
+    uint64_t hash;               // Hash of the SPIR-V
+    std::vector<uint32_t> code;  // Translated when pipelines are created
+};
+static ObjectTable<ShaderModule> shader_module_table(STATS_OBJECT_VkShaderModule);
+
+static void HashShaderStage(Hasher* hasher, const VkPipelineShaderStageCreateInfo& stage) {
+    hasher->AddFields(stage.flags, stage.stage);
+    const ShaderModule* module = shader_module_table.Get(stage.module);
+    hasher->AddValue(module ? module->hash : 0);
+    hasher->AddString(stage.pName);
+    const VkSpecializationInfo* specialization = stage.pSpecializationInfo;
+    hasher->AddValue(specialization != nullptr);
+    if (specialization) {
+        hasher->AddArray(specialization->pMapEntries, specialization->mapEntryCount);
+        hasher->AddValue(specialization->dataSize);
+        if (specialization->pData) hasher->Add(specialization->pData, specialization->dataSize);
+    }
+}
+
+static uint64_t GetGraphicsPipelineKey(const VkGraphicsPipelineCreateInfo& create_info) {
+    Hasher hasher;
+    hasher.AddValue(VK_PIPELINE_BIND_POINT_GRAPHICS);
+    hasher.AddFields(create_info.flags, create_info.stageCount);
+    for (uint32_t i = 0; i < create_info.stageCount; ++i) HashShaderStage(&hasher, create_info.pStages[i]);
+    if (const auto state = create_info.pVertexInputState) {
+        hasher.AddValue(state->flags);
+        hasher.AddArray(state->pVertexBindingDescriptions, state->vertexBindingDescriptionCount);
+        hasher.AddArray(state->pVertexAttributeDescriptions, state->vertexAttributeDescriptionCount);
+    }
+    if (const auto state = create_info.pInputAssemblyState) hasher.AddFields(state->flags, state->primitiveRestartEnable);
+    if (const auto state = create_info.pTessellationState) hasher.AddFields(state->flags, state->patchControlPoints);
+    if (const auto state = create_info.pViewportState) {
+        hasher.AddValue(state->flags);
+        hasher.AddArray(state->pViewports, state->viewportCount);
+        hasher.AddArray(state->pScissors, state->scissorCount);
+    }
+    if (const auto state = create_info.pRasterizationState) hasher.AddFields(state->flags, state->lineWidth);
+    if (const auto state = create_info.pMultisampleState) {
+        hasher.AddFields(state->flags, state->minSampleShading);
+        hasher.AddArray(state->pSampleMask, (state->rasterizationSamples + 31) / 32);
+        hasher.AddFields(state->alphaToCoverageEnable, state->alphaToOneEnable);
+    }
+    if (const auto state = create_info.pDepthStencilState) hasher.AddFields(state->flags, state->maxDepthBounds);
+    if (const auto state = create_info.pColorBlendState) {
+        hasher.AddFields(state->flags, state->logicOp);
+        hasher.AddArray(state->pAttachments, state->attachmentCount);
+        hasher.AddValue(state->blendConstants);
+    }
+    if (const auto state = create_info.pDynamicState) {
+        hasher.AddValue(state->flags);
+        hasher.AddArray(state->pDynamicStates, state->dynamicStateCount);
+    }
+    hasher.AddValue(create_info.subpass);
+    return hasher.hash;
+}
+
+static uint64_t GetComputePipelineKey(const VkComputePipelineCreateInfo& create_info) {
+    Hasher hasher;
+    hasher.AddValue(VK_PIPELINE_BIND_POINT_COMPUTE);
+    hasher.AddValue(create_info.flags);
+    HashShaderStage(&hasher, create_info.stage);
+    return hasher.hash;
+}
+
+static std::unique_ptr<ShaderProgram> TranslateShaderStage(const VkPipelineShaderStageCreateInfo& stage, uint32_t execution_model) {
+    const ShaderModule* module = shader_module_table.Get(stage.module);
+    if (!module) return nullptr;
+    return TranslateShader(module->code.data(), module->code.size(), stage.pName, execution_model, stage.pSpecializationInfo);
+}
+
+// Draws are rasterized when VK_MOCK_RASTERIZE is set to something other than 0
+static bool GetRasterizationEnabled() {
+    static const bool enabled = getenv("VK_MOCK_RASTERIZE") && strcmp(getenv("VK_MOCK_RASTERIZE"), "0") != 0;
+    return enabled;
+}
+
+static std::shared_ptr<const RasterPipeline> CreateRasterPipeline(const VkGraphicsPipelineCreateInfo& create_info) {
+    const auto input_assembly = create_info.pInputAssemblyState;
+    const auto rasterization = create_info.pRasterizationState;
+    const auto multisample = create_info.pMultisampleState;
+    if (!input_assembly || !rasterization || rasterization->polygonMode != VK_POLYGON_MODE_FILL) return nullptr;
+    if (input_assembly->topology != VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST && input_assembly->topology != VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP &&
+        input_assembly->topology != VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN) {
+        return nullptr;
+    }
+    if (!rasterization->rasterizerDiscardEnable && multisample && multisample->rasterizationSamples != VK_SAMPLE_COUNT_1_BIT) return nullptr;
+    std::shared_ptr<RasterPipeline> pipeline(new RasterPipeline());
+    for (uint32_t i = 0; i < create_info.stageCount; ++i) {
+        const VkPipelineShaderStageCreateInfo& stage = create_info.pStages[i];
+        if (stage.stage == VK_SHADER_STAGE_VERTEX_BIT) {
+            pipeline->vertex = TranslateShaderStage(stage, SPIRV_EXECUTION_MODEL_VERTEX);
+            if (!pipeline->vertex) return nullptr;
+        } else if (stage.stage == VK_SHADER_STAGE_FRAGMENT_BIT) {
+            pipeline->fragment = TranslateShaderStage(stage, SPIRV_EXECUTION_MODEL_FRAGMENT);
+            if (!pipeline->fragment) return nullptr;
+        } else {
+            return nullptr;
+        }
+    }
+    if (!pipeline->vertex) return nullptr;
+    if (const auto state = create_info.pVertexInputState) {
+        pipeline->bindings.assign(state->pVertexBindingDescriptions, state->pVertexBindingDescriptions + state->vertexBindingDescriptionCount);
+        pipeline->attributes.assign(state->pVertexAttributeDescriptions, state->pVertexAttributeDescriptions + state->vertexAttributeDescriptionCount);
+    }
+    pipeline->topology = input_assembly->topology;
+    pipeline->primitive_restart = input_assembly->primitiveRestartEnable;
+    pipeline->depth_clamp = rasterization->depthClampEnable;
+    pipeline->discard = rasterization->rasterizerDiscardEnable;
+    pipeline->cull_mode = rasterization->cullMode;
+    pipeline->front_face = rasterization->frontFace;
+    const auto depth_stencil = create_info.pDepthStencilState;
+    pipeline->depth_test = depth_stencil && depth_stencil->depthTestEnable;
+    pipeline->depth_write = pipeline->depth_test && depth_stencil->depthWriteEnable;
+    pipeline->depth_compare = depth_stencil ? depth_stencil->depthCompareOp : VK_COMPARE_OP_ALWAYS;
+    if (const auto state = create_info.pColorBlendState) {
+        pipeline->blend_attachments.assign(state->pAttachments, state->pAttachments + state->attachmentCount);
+        memcpy(pipeline->blend_constants, state->blendConstants, sizeof(pipeline->blend_constants));
+    }
+    const auto viewport = create_info.pViewportState;
+    pipeline->viewport = viewport && viewport->viewportCount && viewport->pViewports ? viewport->pViewports[0] : VkViewport();
+    pipeline->scissor = viewport && viewport->scissorCount && viewport->pScissors ? viewport->pScissors[0] : VkRect2D();
+    if (const auto state = create_info.pDynamicState) {
+        for (uint32_t i = 0; i < state->dynamicStateCount; ++i) {
+            switch (state->pDynamicStates[i]) {
+                case VK_DYNAMIC_STATE_VIEWPORT: pipeline->dynamic_viewport = true; break;
+                case VK_DYNAMIC_STATE_SCISSOR: pipeline->dynamic_scissor = true; break;
+                case VK_DYNAMIC_STATE_BLEND_CONSTANTS: pipeline->dynamic_blend_constants = true; break;
+                default: break;
+            }
+        }
+    }
+    return pipeline;
+}
+
+// Compute pipelines hold the program their shader translated to, unless the interpreter does not handle it, and
+// graphics pipelines the state to rasterize their draws with
+struct Pipeline {
+    std::shared_ptr<const ShaderProgram> program;
+    std::shared_ptr<const RasterPipeline> raster;
+};
+static ObjectTable<Pipeline> pipeline_table(STATS_OBJECT_VkPipeline);
+
+// Pipeline caches hold the keys of the pipelines created with them. Their data is the standard header
+// followed by the keys in ascending order. Caches are internally synchronized.
+struct PipelineCache {
+    mutex_t lock;
+    std::set<uint64_t> keys;
+};
+static ObjectTable<PipelineCache> pipeline_cache_table(STATS_OBJECT_VkPipelineCache);
+
+static PipelineCache* GetPipelineCache(VkPipelineCache pipeline_cache) {
+    return pipeline_cache_table.Get(pipeline_cache);
+}
+
+static void WritePipelineCacheHeader(char* data) {
+    const VkPhysicalDeviceProperties& properties = device_profile.properties;
+    const uint32_t header[4] = {(uint32_t)PIPELINE_CACHE_HEADER_SIZE, VK_PIPELINE_CACHE_HEADER_VERSION_ONE, properties.vendorID, properties.deviceID};
+    memcpy(data, header, sizeof(header));
+    memcpy(data + sizeof(header), properties.pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+// Data from a different device or cache format is ignored, as the spec requires
+static void LoadPipelineCacheData(PipelineCache* cache, const void* data, size_t size) {
+    if (!data || size < PIPELINE_CACHE_HEADER_SIZE) return;
+    char header[PIPELINE_CACHE_HEADER_SIZE];
+    WritePipelineCacheHeader(header);
+    if (memcmp(data, header, PIPELINE_CACHE_HEADER_SIZE) != 0) return;
+    const size_t count = (size - PIPELINE_CACHE_HEADER_SIZE) / sizeof(uint64_t);
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t key;
+        memcpy(&key, static_cast<const char*>(data) + PIPELINE_CACHE_HEADER_SIZE + i * sizeof(uint64_t), sizeof(key));
+        cache->keys.insert(key);
+    }
+}
+
+// Simulated time to compile a pipeline that misses the cache, in microseconds from VK_MOCK_PIPELINE_COMPILE_US
+static std::chrono::microseconds GetPipelineCompileCost() {
+    static const std::chrono::microseconds cost(getenv("VK_MOCK_PIPELINE_COMPILE_US") ? strtoull(getenv("VK_MOCK_PIPELINE_COMPILE_US"), nullptr, 10) : 0);
+    return cost;
+}
+
+// Looks the pipeline up in the cache, "compiles" it on a miss and reports the outcome through
+// VK_EXT_pipeline_creation_feedback
+static VkPipeline CreatePipeline(VkPipelineCache pipeline_cache, uint64_t key, const void* create_info_next, Pipeline pipeline) {
+    const auto start = std::chrono::steady_clock::now();
+    bool hit = false;
+    if (PipelineCache* cache = GetPipelineCache(pipeline_cache)) {
+        lock_guard_t lock(cache->lock);
+        hit = !cache->keys.insert(key).second;
+    }
+    if (!hit && GetPipelineCompileCost().count() > 0) std::this_thread::sleep_for(GetPipelineCompileCost());
+    const auto feedback_info = lvl_find_in_chain<VkPipelineCreationFeedbackCreateInfoEXT>(create_info_next);
+    if (feedback_info) {
+        VkPipelineCreationFeedbackFlagsEXT flags = VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT;
+        if (hit) flags |= VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT;
+        feedback_info->pPipelineCreationFeedback->flags = flags;
+        feedback_info->pPipelineCreationFeedback->duration =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        // Stages are compiled together, so they get no duration of their own
+        for (uint32_t i = 0; i < feedback_info->pipelineStageCreationFeedbackCount; ++i) {
+            feedback_info->pPipelineStageCreationFeedbacks[i].flags = flags;
+            feedback_info->pPipelineStageCreationFeedbacks[i].duration = 0;
+        }
+    }
+    return (VkPipeline)pipeline_table.Create(std::move(pipeline));
+}
+
+// Recorded commands are stored as a stream of packets, each a CommandHeader followed by the
+// command's parameter record and any arrays it points to. Arrays are copied into the packet and the
+// record's pointers are redirected to those copies; pNext chains are not captured.
+struct ExecutionContext;
+struct CommandInfo {
+    const char* name;
+    void (*execute)(const void* record, ExecutionContext* context);  // Null for commands with no effect at execution
+};
+struct CommandHeader {
+    const CommandInfo* info;
+    size_t size;  // Size of the whole packet, header included
+};
+static const size_t COMMAND_ALIGNMENT = 8;
+static const size_t COMMAND_CHUNK_SIZE = 64 * 1024;
+
+static inline size_t AlignCommandSize(size_t size) { return (size + COMMAND_ALIGNMENT - 1) & ~(COMMAND_ALIGNMENT - 1); }
+
+// Command streams live in chunks owned by the command pool and chained per command buffer
+struct CommandChunk {
+    CommandChunk* next;
+    size_t capacity;  // Bytes available for packets after the chunk header
+    size_t used;      // Bytes of packets written, final for every chunk but the one being recorded
+    char* Data() { return reinterpret_cast<char*>(this) + AlignCommandSize(sizeof(CommandChunk)); }
+};
+
+struct CommandPool;
+struct CommandBuffer {
+    VK_LOADER_DATA loader_data;  // Must come first, the VkCommandBuffer handle points at it
+    CommandPool* pool;
+    CommandChunk* first_chunk;
+    CommandChunk* last_chunk;
+    char* cursor;
+    char* end;
+    uint64_t reset_epoch;  // Chunks are only valid while this matches the pool's reset_epoch
+    uint32_t command_count;
+    VkResult result;  // VK_ERROR_OUT_OF_HOST_MEMORY once a command could not be recorded, returned by vkEndCommandBuffer
+};
+
+// Command buffers and their command streams are allocated from their pool. Access to a pool is
+// externally synchronized by the application, so recording, allocating and freeing take no lock.
+// Resetting a command buffer splices its chunks back onto the pool's free list; resetting the pool
+// bumps its epoch and makes every chunk available again, both without visiting individual chunks.
+struct CommandPool {
+    SlabAllocator<CommandBuffer> command_buffers;
+    std::vector<CommandChunk*> chunks;
+    size_t next_unused_chunk = 0;  // chunks from this index on are not used since the last pool reset
+    CommandChunk* free_chunks = nullptr;
+    uint64_t reset_epoch = 0;
+    ~CommandPool() {
+        for (auto chunk : chunks) free(chunk);
+    }
+};
+static ObjectTable<CommandPool> command_pool_table(STATS_OBJECT_VkCommandPool);
+
+static CommandChunk* AcquireCommandChunk(CommandPool* pool, size_t size) {
+    if (pool->free_chunks && pool->free_chunks->capacity >= size) {
+        CommandChunk* chunk = pool->free_chunks;
+        pool->free_chunks = chunk->next;
+        return chunk;
+    }
+    while (pool->next_unused_chunk < pool->chunks.size()) {
+        CommandChunk* chunk = pool->chunks[pool->next_unused_chunk++];
+        if (chunk->capacity >= size) return chunk;
+        chunk->next = pool->free_chunks;
+        pool->free_chunks = chunk;
+    }
+    const size_t capacity = size > COMMAND_CHUNK_SIZE ? size : COMMAND_CHUNK_SIZE;
+    auto chunk = static_cast<CommandChunk*>(malloc(AlignCommandSize(sizeof(CommandChunk)) + capacity));
+    if (!chunk) return nullptr;
+    chunk->capacity = capacity;
+    pool->chunks.push_back(chunk);
+    pool->next_unused_chunk = pool->chunks.size();
+    return chunk;
+}
+
+static void ResetCommandStream(CommandBuffer* command_buffer) {
+    CommandPool* pool = command_buffer->pool;
+    if (command_buffer->reset_epoch == pool->reset_epoch && command_buffer->first_chunk) {
+        command_buffer->last_chunk->next = pool->free_chunks;
+        pool->free_chunks = command_buffer->first_chunk;
+    }
+    command_buffer->first_chunk = nullptr;
+    command_buffer->last_chunk = nullptr;
+    command_buffer->cursor = nullptr;
+    command_buffer->end = nullptr;
+    command_buffer->reset_epoch = pool->reset_epoch;
+    command_buffer->command_count = 0;
+    command_buffer->result = VK_SUCCESS;
+}
+
+static bool GrowCommandStream(CommandBuffer* command_buffer, size_t size) {
+    CommandChunk* chunk = AcquireCommandChunk(command_buffer->pool, size);
+    if (!chunk) return false;
+    chunk->next = nullptr;
+    chunk->used = 0;
+    if (command_buffer->last_chunk) {
+        command_buffer->last_chunk->used = command_buffer->cursor - command_buffer->last_chunk->Data();
+        command_buffer->last_chunk->next = chunk;
+    } else {
+        command_buffer->first_chunk = chunk;
+    }
+    command_buffer->last_chunk = chunk;
+    command_buffer->cursor = chunk->Data();
+    command_buffer->end = command_buffer->cursor + chunk->capacity;
+    return true;
+}
+
+// Reserves a packet for one command and returns its parameter record, extra_size bytes of storage
+// for copied arrays follow the record. Returns null, and fails the command buffer, when the pool
+// cannot get the memory for it.
+template <typename T>
+static inline T* RecordCommand(VkCommandBuffer commandBuffer, size_t extra_size, char** storage) {
+    auto command_buffer = reinterpret_cast<CommandBuffer*>(commandBuffer);
+    const size_t size = AlignCommandSize(sizeof(CommandHeader)) + AlignCommandSize(sizeof(T)) + extra_size;
+    if ((size_t)(command_buffer->end - command_buffer->cursor) < size && !GrowCommandStream(command_buffer, size)) {
+        command_buffer->result = VK_ERROR_OUT_OF_HOST_MEMORY;
+        return nullptr;
+    }
+    auto header = reinterpret_cast<CommandHeader*>(command_buffer->cursor);
+    header->info = &T::info;
+    header->size = size;
+    command_buffer->cursor += size;
+    command_buffer->command_count++;
+    char* record = reinterpret_cast<char*>(header) + AlignCommandSize(sizeof(CommandHeader));
+    *storage = record + AlignCommandSize(sizeof(T));
+    return reinterpret_cast<T*>(record);
+}
+
+template <typename T>
+static inline T* RecordCommand(VkCommandBuffer commandBuffer) {
+    char* storage;
+    return RecordCommand<T>(commandBuffer, 0, &storage);
+}
+
+template <typename T>
+static inline size_t CommandArraySize(const T* data, size_t count) {
+    return data ? AlignCommandSize(sizeof(T) * count) : 0;
+}
+static inline size_t CommandArraySize(const void* data, size_t size) { return data ? AlignCommandSize(size) : 0; }
+static inline size_t CommandArraySize(const char* data) { return data ? AlignCommandSize(strlen(data) + 1) : 0; }
+
+template <typename T>
+static inline T* CopyCommandArray(char** storage, const T* data, size_t count) {
+    if (!data) return nullptr;
+    T* copy = reinterpret_cast<T*>(*storage);
+    memcpy(copy, data, sizeof(T) * count);
+    *storage += AlignCommandSize(sizeof(T) * count);
+    return copy;
+}
+static inline void* CopyCommandArray(char** storage, const void* data, size_t size) {
+    if (!data) return nullptr;
+    void* copy = *storage;
+    memcpy(copy, data, size);
+    *storage += AlignCommandSize(size);
+    return copy;
+}
+static inline const char* CopyCommandArray(char** storage, const char* data) {
+    return data ? static_cast<char*>(CopyCommandArray(storage, static_cast<const void*>(data), strlen(data) + 1)) : nullptr;
+}
+
+// Structures passed to vkCmd* that point at further arrays overload these to capture them as well,
+// everything else is copied shallowly
+template <typename T>
+static inline size_t CommandNestedSize(const T* data, size_t count) { return 0; }
+template <typename T>
+static inline void CopyCommandNested(char** storage, T* data, size_t count) {}
+
+static inline size_t CommandNestedSize(const VkRenderPassBeginInfo* data, size_t count) {
+    size_t size = 0;
+    for (size_t i = 0; data && i < count; ++i) size += CommandArraySize(data[i].pClearValues, data[i].clearValueCount);
+    return size;
+}
+static inline void CopyCommandNested(char** storage, VkRenderPassBeginInfo* data, size_t count) {
+    for (size_t i = 0; data && i < count; ++i) data[i].pClearValues = CopyCommandArray(storage, data[i].pClearValues, data[i].clearValueCount);
+}
+
+static inline size_t CommandNestedSize(const VkDebugUtilsLabelEXT* data, size_t count) {
+    size_t size = 0;
+    for (size_t i = 0; data && i < count; ++i) size += CommandArraySize(data[i].pLabelName);
+    return size;
+}
+static inline void CopyCommandNested(char** storage, VkDebugUtilsLabelEXT* data, size_t count) {
+    for (size_t i = 0; data && i < count; ++i) data[i].pLabelName = CopyCommandArray(storage, data[i].pLabelName);
+}
+
+static inline size_t CommandNestedSize(const VkDebugMarkerMarkerInfoEXT* data, size_t count) {
+    size_t size = 0;
+    for (size_t i = 0; data && i < count; ++i) size += CommandArraySize(data[i].pMarkerName);
+    return size;
+}
+static inline void CopyCommandNested(char** storage, VkDebugMarkerMarkerInfoEXT* data, size_t count) {
+    for (size_t i = 0; data && i < count; ++i) data[i].pMarkerName = CopyCommandArray(storage, data[i].pMarkerName);
+}
+
+static inline size_t CommandNestedSize(const VkWriteDescriptorSet* data, size_t count) {
+    size_t size = 0;
+    for (size_t i = 0; data && i < count; ++i) {
+        switch (data[i].descriptorType) {
+            case VK_DESCRIPTOR_TYPE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                size += CommandArraySize(data[i].pImageInfo, data[i].descriptorCount);
+                break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                size += CommandArraySize(data[i].pTexelBufferView, data[i].descriptorCount);
+                break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                size += CommandArraySize(data[i].pBufferInfo, data[i].descriptorCount);
+                break;
+            default:
+                break;
+        }
+    }
+    return size;
+}
+static inline void CopyCommandNested(char** storage, VkWriteDescriptorSet* data, size_t count) {
+    for (size_t i = 0; data && i < count; ++i) {
+        switch (data[i].descriptorType) {
+            case VK_DESCRIPTOR_TYPE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                data[i].pImageInfo = CopyCommandArray(storage, data[i].pImageInfo, data[i].descriptorCount);
+                break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                data[i].pTexelBufferView = CopyCommandArray(storage, data[i].pTexelBufferView, data[i].descriptorCount);
+                break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                data[i].pBufferInfo = CopyCommandArray(storage, data[i].pBufferInfo, data[i].descriptorCount);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static CommandPool* GetCommandPool(VkCommandPool command_pool) {
+    return command_pool_table.Get(command_pool);
+}
+
+static void SignalSyncObjects(Device* device) {
+    SyncEpoch& sync = device->sync;
+    sync.epoch.fetch_add(1);
+    if (sync.waiters.load() == 0) return;
+#if defined(__linux__)
+    syscall(SYS_futex, &sync.epoch, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+    { lock_guard_t lock(sync.lock); }
+    sync.cv.notify_all();
+#endif
+}
+
+static std::chrono::steady_clock::time_point GetSyncDeadline(uint64_t timeout_ns) {
+    // Anything beyond a century is as good as UINT64_MAX, which means no timeout
+    if (timeout_ns > (uint64_t)INT64_MAX / 2) return std::chrono::steady_clock::time_point::max();
+    return std::chrono::steady_clock::now() + std::chrono::nanoseconds(timeout_ns);
+}
+
+// Blocks until done() holds or the deadline passes, returns whether done() held. Only the signals of the device
+// wake the wait.
+template <typename Predicate>
+static bool WaitForSyncObjects(Device* device, Predicate done, std::chrono::steady_clock::time_point deadline) {
+    SyncEpoch& sync = device->sync;
+    const bool infinite = deadline == std::chrono::steady_clock::time_point::max();
+    bool result = false;
+    sync.waiters.fetch_add(1);
+    for (;;) {
+        const uint32_t epoch = sync.epoch.load();
+        if (done()) {
+            result = true;
+            break;
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) break;
+#if defined(__linux__)
+        struct timespec timeout;
+        if (!infinite) {
+            const int64_t remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+            timeout.tv_sec = (time_t)(remaining / 1000000000);
+            timeout.tv_nsec = (long)(remaining % 1000000000);
+        }
+        syscall(SYS_futex, &sync.epoch, FUTEX_WAIT_PRIVATE, epoch, infinite ? nullptr : &timeout, nullptr, 0);
+#else
+        unique_lock_t lock(sync.lock);
+        auto changed = [&sync, epoch] { return sync.epoch.load() != epoch; };
+        if (infinite) {
+            sync.cv.wait(lock, changed);
+        } else {
+            sync.cv.wait_until(lock, deadline, changed);
+        }
+#endif
+    }
+    sync.waiters.fetch_sub(1);
+    return result;
+}
+
+struct Fence {
+    std::atomic<bool> signaled{false};
+};
+
+// Every semaphore is waited on by waiting for its value to reach a target. For timeline semaphores
+// value is the payload. Binary semaphores hand out tickets instead: value counts completed signals and
+// a wait submitted after the n-th signal was submitted waits for value to reach n.
+// The submitted counters are guarded by the sync_lock of the semaphore's device.
+struct Semaphore {
+    VkSemaphoreType type = VK_SEMAPHORE_TYPE_BINARY;
+    uint64_t signals_submitted = 0;
+    uint64_t waits_submitted = 0;
+    std::atomic<uint64_t> value{0};
+};
+
+static ObjectTable<Fence> fence_table(STATS_OBJECT_VkFence);
+static ObjectTable<Semaphore> semaphore_table(STATS_OBJECT_VkSemaphore);
+
+struct Submission {
+    std::vector<std::pair<Semaphore*, uint64_t>> waits;    // Semaphore and the value to wait for
+    std::vector<std::pair<Semaphore*, uint64_t>> signals;  // Semaphore and the value to set
+    std::vector<VkCommandBuffer> command_buffers;
+    std::vector<std::pair<VkSwapchainKHR, uint32_t>> presents;  // Swapchain and the index of the image to present
+    Fence* fence = nullptr;
+};
+
+// Each queue executes its submissions in order on its own worker thread
+struct Queue {
+    VK_LOADER_DATA loader_data;  // Must come first, the VkQueue handle points at it
+    Device* device;
+    mutex_t lock;
+    std::condition_variable work_cv;
+    std::condition_variable idle_cv;
+    std::deque<Submission> submissions;
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+};
+
+// Device timestamps count nanoseconds of CLOCK_MONOTONIC, so they line up with the host's clock
+static uint64_t GetDeviceTimestamp() {
+#if defined(__linux__) || defined(__APPLE__)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Query results are written by the queue workers when they execute the commands that produce them.
+// A query's values are only read by the host once its available flag is set.
+struct QueryPool {
+    VkQueryType type;
+    VkQueryPipelineStatisticFlags pipeline_statistics;
+    uint32_t values_per_query;
+    std::vector<uint64_t> values;
+    std::vector<std::atomic<bool>> available;
+    explicit QueryPool(const VkQueryPoolCreateInfo* create_info)
+        : type(create_info->queryType),
+          pipeline_statistics(create_info->pipelineStatistics),
+          values_per_query(1),
+          available(create_info->queryCount) {
+        if (type == VK_QUERY_TYPE_PIPELINE_STATISTICS) {
+            values_per_query = 0;
+            for (uint32_t bits = pipeline_statistics; bits; bits &= bits - 1) values_per_query++;
+        }
+        values.resize((size_t)create_info->queryCount * values_per_query);
+        for (auto& flag : available) flag = false;
+    }
+};
+static ObjectTable<QueryPool> query_pool_table(STATS_OBJECT_VkQueryPool);
+
+static QueryPool* GetQueryPool(VkQueryPool query_pool) {
+    return query_pool_table.Get(query_pool);
+}
+
+// Cost model of the simulated device. Topology is not tracked, every draw is taken to be a triangle
+// list covering SAMPLES_PER_PRIMITIVE samples per triangle, and every workgroup of a pipeline without a program
+// to run INVOCATIONS_PER_WORKGROUP invocations. Indirect draw parameters are not read: each indirect draw
+// counts as a single triangle.
+static const uint64_t SAMPLES_PER_PRIMITIVE = 64;
+static const uint64_t INVOCATIONS_PER_WORKGROUP = 64;
+static const uint64_t COMMAND_COST_NS = 100;
+static const uint64_t PRIMITIVE_COST_NS = 1;
+static const uint64_t WORKGROUP_COST_NS = 10;
+
+// Counters that queries sample, the pipeline statistics in VkQueryPipelineStatisticFlagBits order
+enum QueryCounter {
+    COUNTER_INPUT_ASSEMBLY_VERTICES,
+    COUNTER_INPUT_ASSEMBLY_PRIMITIVES,
+    COUNTER_VERTEX_SHADER_INVOCATIONS,
+    COUNTER_GEOMETRY_SHADER_INVOCATIONS,
+    COUNTER_GEOMETRY_SHADER_PRIMITIVES,
+    COUNTER_CLIPPING_INVOCATIONS,
+    COUNTER_CLIPPING_PRIMITIVES,
+    COUNTER_FRAGMENT_SHADER_INVOCATIONS,
+    COUNTER_TESSELLATION_CONTROL_SHADER_PATCHES,
+    COUNTER_TESSELLATION_EVALUATION_SHADER_INVOCATIONS,
+    COUNTER_COMPUTE_SHADER_INVOCATIONS,
+    COUNTER_SAMPLES_PASSED,
+    QUERY_COUNTER_COUNT
+};
+
+struct ActiveQuery {
+    QueryPool* pool;
+    uint32_t query;
+    uint64_t begin_counters[QUERY_COUNTER_COUNT];
+};
+
+// Largest number of descriptor sets and bytes of push constants commands can bind, whatever the limits say
+static const uint32_t MAX_BOUND_DESCRIPTOR_SETS = 32;
+static const uint32_t MAX_PUSH_CONSTANTS_SIZE = 256;
+
+struct BoundDescriptorSet {
+    const DescriptorSet* set = nullptr;
+    std::vector<uint32_t> dynamic_offsets;  // Of the set's dynamic buffers in binding order
+};
+
+// What the commands of a command buffer bound to a pipeline bind point
+struct BindPointState {
+    std::shared_ptr<const ShaderProgram> program;
+    BoundDescriptorSet sets[MAX_BOUND_DESCRIPTOR_SETS];
+    DescriptorSet pushed_sets[MAX_BOUND_DESCRIPTOR_SETS];  // Written by vkCmdPushDescriptorSetKHR
+    std::vector<Descriptor> pushed_descriptors[MAX_BOUND_DESCRIPTOR_SETS];  // Of the pushed sets
+    char push_constants[MAX_PUSH_CONSTANTS_SIZE] = {};
+};
+
+static const uint32_t MAX_BOUND_VERTEX_BUFFERS = 32;
+
+// What the commands of a command buffer set for draws besides the graphics bind point
+struct DrawState {
+    std::shared_ptr<const RasterPipeline> pipeline;  // Null unless the bound pipeline's draws are rasterized
+    VkViewport viewport = {};
+    VkRect2D scissor = {};
+    float blend_constants[4] = {};
+    VkBuffer vertex_buffers[MAX_BOUND_VERTEX_BUFFERS] = {};
+    VkDeviceSize vertex_offsets[MAX_BOUND_VERTEX_BUFFERS] = {};
+    VkBuffer index_buffer = VK_NULL_HANDLE;
+    VkDeviceSize index_offset = 0;
+    VkIndexType index_type = VK_INDEX_TYPE_UINT16;
+};
+
+struct RenderPassInstance;
+
+// State of one batch of command buffers while a queue worker executes it
+struct ExecutionContext {
+    uint64_t start_time = 0;  // Device timestamp when the batch started executing
+    uint64_t elapsed = 0;     // Simulated time spent on the batch so far, in nanoseconds
+    uint64_t counters[QUERY_COUNTER_COUNT] = {};
+    std::vector<ActiveQuery> active_queries;
+    BindPointState compute;   // Reset by every command buffer
+    BindPointState graphics;  // Reset by every command buffer
+    DrawState draw;           // Reset by every command buffer
+    // Render pass draws are rasterized in, which secondary command buffers continue
+    std::shared_ptr<RenderPassInstance> render_pass;
+};
+
+// Null for bind points commands are not executed for
+static BindPointState* GetBindPointState(ExecutionContext* context, VkPipelineBindPoint bind_point) {
+    if (bind_point == VK_PIPELINE_BIND_POINT_COMPUTE) return &context->compute;
+    if (bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS) return &context->graphics;
+    return nullptr;
+}
+
+static void ExecuteCommandBuffer(VkCommandBuffer commandBuffer, ExecutionContext* context) {
+    auto command_buffer = reinterpret_cast<CommandBuffer*>(commandBuffer);
+    // Nothing recorded survives a reset of the pool
+    if (command_buffer->reset_epoch != command_buffer->pool->reset_epoch) return;
+    context->compute = BindPointState();
+    context->graphics = BindPointState();
+    context->draw = DrawState();
+    for (CommandChunk* chunk = command_buffer->first_chunk; chunk; chunk = chunk->next) {
+        const char* data = chunk->Data();
+        const char* end = chunk == command_buffer->last_chunk ? command_buffer->cursor : data + chunk->used;
+        while (data < end) {
+            auto header = reinterpret_cast<const CommandHeader*>(data);
+            if (header->info->execute) header->info->execute(data + AlignCommandSize(sizeof(CommandHeader)), context);
+            data += header->size;
+        }
+    }
+}
+
+static void ExecuteDraw(ExecutionContext* context, uint64_t vertex_count, uint64_t instance_count) {
+    const uint64_t vertices = vertex_count * instance_count;
+    const uint64_t primitives = vertex_count / 3 * instance_count;
+    context->counters[COUNTER_INPUT_ASSEMBLY_VERTICES] += vertices;
+    context->counters[COUNTER_INPUT_ASSEMBLY_PRIMITIVES] += primitives;
+    context->counters[COUNTER_VERTEX_SHADER_INVOCATIONS] += vertices;
+    context->counters[COUNTER_CLIPPING_INVOCATIONS] += primitives;
+    context->counters[COUNTER_CLIPPING_PRIMITIVES] += primitives;
+    context->counters[COUNTER_FRAGMENT_SHADER_INVOCATIONS] += primitives * SAMPLES_PER_PRIMITIVE;
+    context->counters[COUNTER_SAMPLES_PASSED] += primitives * SAMPLES_PER_PRIMITIVE;
+    context->elapsed += COMMAND_COST_NS + primitives * PRIMITIVE_COST_NS;
+}
+
+static void ExecuteBindDescriptorSets(BindPointState* state, uint32_t first_set, uint32_t set_count, const VkDescriptorSet* sets,
+                                      uint32_t dynamic_offset_count, const uint32_t* dynamic_offsets) {
+    uint32_t next_offset = 0;
+    for (uint32_t i = 0; i < set_count && first_set + i < MAX_BOUND_DESCRIPTOR_SETS; ++i) {
+        BoundDescriptorSet& bound = state->sets[first_set + i];
+        bound.set = descriptor_set_table.Get(sets[i]);
+        bound.dynamic_offsets.clear();
+        if (!bound.set) continue;
+        const uint32_t count = std::min(bound.set->layout->dynamic_count, dynamic_offset_count - next_offset);
+        bound.dynamic_offsets.assign(dynamic_offsets + next_offset, dynamic_offsets + next_offset + count);
+        next_offset += count;
+    }
+}
+
+// Pushed sets get a layout of their own, which grows to fit what is pushed to them
+static void ExecutePushDescriptorSet(BindPointState* state, uint32_t set, uint32_t write_count, const VkWriteDescriptorSet* writes) {
+    if (set >= MAX_BOUND_DESCRIPTOR_SETS) return;
+    DescriptorSet* pushed = &state->pushed_sets[set];
+    std::vector<Descriptor>& descriptors = state->pushed_descriptors[set];
+    if (!pushed->layout) pushed->layout.reset(new DescriptorSetLayout());
+    for (uint32_t i = 0; i < write_count; ++i) {
+        const VkWriteDescriptorSet& write = writes[i];
+        if (write.descriptorType == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) continue;
+        const auto& bindings = pushed->layout->bindings;
+        const uint32_t count = write.dstArrayElement + write.descriptorCount;
+        if (write.dstBinding >= bindings.size() || bindings[write.dstBinding].type != write.descriptorType ||
+            bindings[write.dstBinding].count < count) {
+            // The binding moves to the end of the descriptors, keeping them unless its type changes
+            std::shared_ptr<DescriptorSetLayout> layout(new DescriptorSetLayout(*pushed->layout));
+            if (write.dstBinding >= layout->bindings.size()) layout->bindings.resize(write.dstBinding + 1);
+            DescriptorLayoutBinding& binding = layout->bindings[write.dstBinding];
+            descriptors.resize(descriptors.size() + count, Descriptor{});
+            if (binding.type == write.descriptorType) {
+                std::copy(descriptors.begin() + binding.first, descriptors.begin() + binding.first + binding.count, descriptors.end() - count);
+            }
+            binding.type = write.descriptorType;
+            binding.count = count;
+            binding.first = (uint32_t)(descriptors.size() - count);
+            layout->descriptor_count = (uint32_t)descriptors.size();
+            pushed->layout = std::move(layout);
+            pushed->descriptors = descriptors.data();
+            pushed->descriptor_count = (uint32_t)descriptors.size();
+        }
+        WriteDescriptors(pushed, write);
+    }
+    state->sets[set].set = pushed;
+    state->sets[set].dynamic_offsets.clear();
+}
+
+static void MakeQueryAvailable(QueryPool* pool, uint32_t query, bool available) {
+    if (query < pool->available.size()) pool->available[query].store(available, std::memory_order_release);
+}
+
+static void ExecuteWriteTimestamp(ExecutionContext* context, VkQueryPool query_pool, uint32_t query) {
+    QueryPool* pool = GetQueryPool(query_pool);
+    if (!pool || query >= pool->available.size()) return;
+    pool->values[(size_t)query * pool->values_per_query] = context->start_time + context->elapsed;
+    MakeQueryAvailable(pool, query, true);
+}
+
+static void ExecuteBeginQuery(ExecutionContext* context, VkQueryPool query_pool, uint32_t query) {
+    QueryPool* pool = GetQueryPool(query_pool);
+    if (!pool || query >= pool->available.size()) return;
+    ActiveQuery active;
+    active.pool = pool;
+    active.query = query;
+    memcpy(active.begin_counters, context->counters, sizeof(context->counters));
+    context->active_queries.push_back(active);
+}
+
+static void ExecuteEndQuery(ExecutionContext* context, VkQueryPool query_pool, uint32_t query) {
+    QueryPool* pool = GetQueryPool(query_pool);
+    auto active = std::find_if(context->active_queries.begin(), context->active_queries.end(),
+                               [&](const ActiveQuery& active) { return active.pool == pool && active.query == query; });
+    // A query begun in another submission has nothing counted
+    if (active == context->active_queries.end()) return;
+    uint64_t* values = &pool->values[(size_t)query * pool->values_per_query];
+    if (pool->type == VK_QUERY_TYPE_OCCLUSION) {
+        values[0] = context->counters[COUNTER_SAMPLES_PASSED] - active->begin_counters[COUNTER_SAMPLES_PASSED];
+    } else if (pool->type == VK_QUERY_TYPE_PIPELINE_STATISTICS) {
+        uint32_t value = 0;
+        for (uint32_t counter = 0; counter < COUNTER_SAMPLES_PASSED; ++counter) {
+            if (pool->pipeline_statistics & (1u << counter)) values[value++] = context->counters[counter] - active->begin_counters[counter];
+        }
+    }
+    context->active_queries.erase(active);
+    MakeQueryAvailable(pool, query, true);
+}
+
+// Writes the results of one query where vkGetQueryPoolResults and vkCmdCopyQueryPoolResults put them
+static void WriteQueryResult(const QueryPool* pool, uint32_t query, bool available, char* data, VkQueryResultFlags flags) {
+    auto write_value = [flags](char* data, uint32_t index, uint64_t value) {
+        if (flags & VK_QUERY_RESULT_64_BIT) {
+            memcpy(data + index * sizeof(uint64_t), &value, sizeof(uint64_t));
+        } else {
+            const uint32_t value32 = (uint32_t)value;
+            memcpy(data + index * sizeof(uint32_t), &value32, sizeof(uint32_t));
+        }
+    };
+    if (available || (flags & VK_QUERY_RESULT_PARTIAL_BIT)) {
+        const uint64_t* values = &pool->values[(size_t)query * pool->values_per_query];
+        for (uint32_t value = 0; value < pool->values_per_query; ++value) write_value(data, value, available ? values[value] : 0);
+    }
+    if (flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) write_value(data, pool->values_per_query, available ? 1 : 0);
+}
+
+// Transfer commands run on the queue workers, straight on the memory bound to their buffers and images. A command
+// reaching past a resource or the memory bound to it, or using one without memory, is skipped as a whole.
+
+// Returns the host address of size bytes at offset in a buffer, nullptr if they are not all backed by memory
+static char* GetBufferData(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size) {
+    const Buffer* buffer_state = buffer_table.Get(buffer);
+    if (!buffer_state || offset > buffer_state->create_info.size || size > buffer_state->create_info.size - offset) return nullptr;
+    const DeviceMemory* memory = device_memory_table.Get(buffer_state->binding.memory);
+    const VkDeviceSize memory_offset = buffer_state->binding.offset + offset;
+    if (!memory || memory_offset > memory->allocation_size || size > memory->allocation_size - memory_offset) return nullptr;
+    return static_cast<char*>(memory->data) + memory_offset;
+}
+
+// Returns the host address of a plane of an image and in size the bytes backing it from there, nullptr if it has no memory
+static char* GetImagePlaneData(const Image* image, uint32_t plane, VkDeviceSize* size) {
+    if (image->swapchain_data) {
+        *size = image->plane_offsets[MAX_FORMAT_PLANES] - image->plane_offsets[plane];
+        return image->swapchain_data + image->plane_offsets[plane];
+    }
+    const MemoryBinding& binding = image->bindings[plane];
+    const DeviceMemory* memory = device_memory_table.Get(binding.memory);
+    const bool disjoint = (image->create_info.flags & VK_IMAGE_CREATE_DISJOINT_BIT) != 0;
+    const VkDeviceSize offset = binding.offset + (disjoint ? 0 : image->plane_offsets[plane]);
+    if (!memory || offset > memory->allocation_size) return nullptr;
+    *size = memory->allocation_size - offset;
+    return static_cast<char*>(memory->data) + offset;
+}
+
+static inline uint32_t DivideRoundingUp(uint32_t value, uint32_t divisor) { return value / divisor + (value % divisor != 0); }
+
+// A box of texel blocks of one aspect of an image subresource, resolved to host memory. The box is a stack of
+// slices, the layers of array images or the depth slices of 3D ones. Combined depth/stencil formats keep the depth
+// bytes of each texel before its stencil byte, while buffers hold either aspect on its own, with D24 depth in the
+// low bytes of 4. Both aspects together cover whole texels. The samples of multisampled images follow each other
+// like the depth slices of a 3D image.
+struct ImageRegion {
+    char* data;  // First block of the box
+    const FormatInfo* format_info;
+    VkDeviceSize row_pitch;
+    VkDeviceSize slice_pitch;
+    VkDeviceSize sample_pitch;
+    VkExtent3D block_extent;
+    uint32_t block_size;
+    uint32_t aspect_offset;  // Bytes of each block the aspect occupies
+    uint32_t aspect_size;
+    uint32_t buffer_block_size;  // Bytes a block of the aspect takes in a buffer
+    uint32_t blocks_x;
+    uint32_t blocks_y;
+    uint32_t depth;  // Slices of each layer
+    uint32_t slices;
+    uint32_t samples;
+};
+
+// Resolves the box of an image subresource at a texel offset with a texel extent, clipped to the subresource.
+// Returns false if it is empty, out of range or not backed by memory.
+static bool GetImageRegion(VkImage image, const VkImageSubresourceLayers& subresource, VkOffset3D offset, VkExtent3D extent,
+                           ImageRegion* region) {
+    const Image* image_state = image_table.Get(image);
+    if (!image_state) return false;
+    const VkImageCreateInfo& info = image_state->create_info;
+    const FormatInfo* format_info = GetFormatInfo(info.format);
+    if (!format_info) format_info = &UNKNOWN_FORMAT_INFO;
+    const uint32_t plane = GetAspectPlane(subresource.aspectMask);
+    if (plane >= format_info->plane_count || subresource.mipLevel >= info.mipLevels ||
+        subresource.baseArrayLayer >= info.arrayLayers || offset.x < 0 || offset.y < 0 || offset.z < 0) {
+        return false;
+    }
+    const FormatPlane& plane_info = format_info->planes[plane];
+    const VkSubresourceLayout& layout = image_state->subresources[plane * info.mipLevels + subresource.mipLevel];
+    const VkExtent3D block = format_info->plane_count > 1 ? VkExtent3D{1, 1, 1} : format_info->block_extent;
+    const uint32_t width = DivideRoundingUp(std::max(info.extent.width >> subresource.mipLevel, 1u), plane_info.width_divisor);
+    const uint32_t height = DivideRoundingUp(std::max(info.extent.height >> subresource.mipLevel, 1u), plane_info.height_divisor);
+    const uint32_t depth = std::max(info.extent.depth >> subresource.mipLevel, 1u);
+    const uint32_t x = offset.x / block.width;
+    const uint32_t y = offset.y / block.height;
+    const uint32_t z = offset.z / block.depth;
+    const uint32_t level_blocks_x = DivideRoundingUp(width, block.width);
+    const uint32_t level_blocks_y = DivideRoundingUp(height, block.height);
+    const uint32_t level_blocks_z = DivideRoundingUp(depth, block.depth);
+    if (x >= level_blocks_x || y >= level_blocks_y || z >= level_blocks_z) return false;
+    const uint32_t layers = std::min(subresource.layerCount, info.arrayLayers - subresource.baseArrayLayer);
+    region->block_extent = block;
+    region->blocks_x = std::min(DivideRoundingUp(extent.width, block.width), level_blocks_x - x);
+    region->blocks_y = std::min(DivideRoundingUp(extent.height, block.height), level_blocks_y - y);
+    region->depth = std::min(DivideRoundingUp(extent.depth, block.depth), level_blocks_z - z);
+    region->slices = layers * region->depth;
+    if (!region->blocks_x || !region->blocks_y || !region->slices) return false;
+    region->format_info = format_info;
+    region->row_pitch = layout.rowPitch;
+    region->slice_pitch = info.imageType == VK_IMAGE_TYPE_3D ? layout.depthPitch : layout.arrayPitch;
+    region->samples = std::max<uint32_t>(info.samples, 1);
+    region->sample_pitch = layout.size / region->samples;
+    region->block_size = plane_info.block_size;
+    region->aspect_offset = 0;
+    region->aspect_size = plane_info.block_size;
+    region->buffer_block_size = plane_info.block_size;
+    const VkImageAspectFlags depth_stencil = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    if ((info.format == VK_FORMAT_D16_UNORM_S8_UINT || info.format == VK_FORMAT_D24_UNORM_S8_UINT ||
+         info.format == VK_FORMAT_D32_SFLOAT_S8_UINT) && (subresource.aspectMask & depth_stencil) != depth_stencil) {
+        if (subresource.aspectMask & VK_IMAGE_ASPECT_STENCIL_BIT) {
+            region->aspect_offset = region->block_size - 1;
+            region->aspect_size = 1;
+            region->buffer_block_size = 1;
+        } else {
+            region->aspect_size = region->block_size - 1;
+            region->buffer_block_size = info.format == VK_FORMAT_D16_UNORM_S8_UINT ? 2 : 4;
+        }
+    }
+    const VkDeviceSize start = layout.offset + subresource.baseArrayLayer * layout.arrayPitch + z * layout.depthPitch +
+                               y * layout.rowPitch + (VkDeviceSize)x * region->block_size;
+    const VkDeviceSize end = start + (region->slices - 1) * region->slice_pitch + (region->samples - 1) * region->sample_pitch +
+                             (region->blocks_y - 1) * layout.rowPitch + (VkDeviceSize)region->blocks_x * region->block_size;
+    VkDeviceSize size;
+    char* data = GetImagePlaneData(image_state, plane, &size);
+    if (!data || end > size) return false;
+    region->data = data + start;
+    return true;
+}
+
+// Copies count blocks of size bytes, stepping through dst and src by their own block sizes. With zero_fill the
+// bytes of each dst block past the copied ones are cleared, for depth copied into buffers.
+static void CopyBlocks(char* dst, uint32_t dst_step, const char* src, uint32_t src_step, uint32_t size, uint32_t count, bool zero_fill) {
+    if (dst_step == size && src_step == size) {
+        memmove(dst, src, (size_t)count * size);
+        return;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        memcpy(dst + (size_t)i * dst_step, src + (size_t)i * src_step, size);
+        if (zero_fill) memset(dst + (size_t)i * dst_step + size, 0, dst_step - size);
+    }
+}
+
+// Copies between a buffer and an image as vkCmdCopyBufferToImage and vkCmdCopyImageToBuffer lay them out
+static void CopyBufferImage(VkBuffer buffer, VkImage image, const VkBufferImageCopy& copy, bool to_image) {
+    ImageRegion region;
+    if (!GetImageRegion(image, copy.imageSubresource, copy.imageOffset, copy.imageExtent, &region)) return;
+    // Buffer rows and slices are given in texels, and are as long as the copy when left 0
+    const uint32_t row_length = std::max(copy.bufferRowLength, copy.imageExtent.width);
+    const uint32_t image_height = std::max(copy.bufferImageHeight, copy.imageExtent.height);
+    const VkDeviceSize row_pitch = (VkDeviceSize)DivideRoundingUp(row_length, region.block_extent.width) * region.buffer_block_size;
+    const VkDeviceSize slice_pitch = DivideRoundingUp(image_height, region.block_extent.height) * row_pitch;
+    const VkDeviceSize size = (region.slices - 1) * slice_pitch + (region.blocks_y - 1) * row_pitch +
+                              (VkDeviceSize)region.blocks_x * region.buffer_block_size;
+    char* buffer_data = GetBufferData(buffer, copy.bufferOffset, size);
+    if (!buffer_data) return;
+    for (uint32_t slice = 0; slice < region.slices; ++slice) {
+        for (uint32_t y = 0; y < region.blocks_y; ++y) {
+            char* image_row = region.data + slice * region.slice_pitch + y * region.row_pitch + region.aspect_offset;
+            char* buffer_row = buffer_data + slice * slice_pitch + y * row_pitch;
+            if (to_image) {
+                CopyBlocks(image_row, region.block_size, buffer_row, region.buffer_block_size, region.aspect_size, region.blocks_x, false);
+            } else {
+                CopyBlocks(buffer_row, region.buffer_block_size, image_row, region.block_size, region.aspect_size, region.blocks_x, true);
+            }
+        }
+    }
+}
+
+// Copies between images as vkCmdCopyImage does. The extent is in texels of the source, and covers as many blocks
+// of the destination as of the source when the formats have blocks of different sizes.
+static void CopyImageToImage(VkImage src_image, VkImage dst_image, const VkImageCopy& copy) {
+    ImageRegion src;
+    ImageRegion dst;
+    const VkExtent3D whole_level = {UINT32_MAX, UINT32_MAX, UINT32_MAX};
+    if (!GetImageRegion(src_image, copy.srcSubresource, copy.srcOffset, copy.extent, &src) ||
+        !GetImageRegion(dst_image, copy.dstSubresource, copy.dstOffset, whole_level, &dst) || src.aspect_size != dst.aspect_size) {
+        return;
+    }
+    const uint32_t slices = std::min(src.slices, dst.slices);
+    const uint32_t samples = std::min(src.samples, dst.samples);
+    const uint32_t blocks_x = std::min(src.blocks_x, dst.blocks_x);
+    const uint32_t blocks_y = std::min(src.blocks_y, dst.blocks_y);
+    for (uint32_t slice = 0; slice < slices; ++slice) {
+        for (uint32_t sample = 0; sample < samples; ++sample) {
+            for (uint32_t y = 0; y < blocks_y; ++y) {
+                CopyBlocks(dst.data + slice * dst.slice_pitch + sample * dst.sample_pitch + y * dst.row_pitch + dst.aspect_offset,
+                           dst.block_size,
+                           src.data + slice * src.slice_pitch + sample * src.sample_pitch + y * src.row_pitch + src.aspect_offset,
+                           src.block_size, src.aspect_size, blocks_x, false);
+            }
+        }
+    }
+}
+
+// Fills size bytes, a multiple of pattern_size, with copies of a pattern. Past the first copy the fill doubles what
+// is written with memcpy, which uses the widest stores the host has, in steps of at most FILL_STEP_SIZE bytes so the
+// source stays in cache.
+static const VkDeviceSize FILL_STEP_SIZE = 64 * 1024;
+static void FillPattern(char* data, VkDeviceSize size, const void* pattern, uint32_t pattern_size) {
+    if (size < pattern_size) return;
+    memcpy(data, pattern, pattern_size);
+    const VkDeviceSize max_step = FILL_STEP_SIZE / pattern_size * pattern_size;
+    VkDeviceSize filled = pattern_size;
+    while (filled < size) {
+        const VkDeviceSize step = std::min(std::min(filled, max_step), size - filled);
+        memcpy(data + filled, data, step);
+        filled += step;
+    }
+}
+
+// Fills size bytes, a multiple of 4, with a 32-bit pattern
+static void FillMemory(char* data, VkDeviceSize size, uint32_t pattern) {
+    const uint8_t byte = (uint8_t)pattern;
+    if (pattern == byte * 0x01010101u) {
+        memset(data, byte, size);
+        return;
+    }
+    FillPattern(data, size, &pattern, sizeof(pattern));
+}
+
+static void ExecuteCopyBuffer(ExecutionContext* context, VkBuffer src_buffer, VkBuffer dst_buffer, uint32_t region_count,
+                              const VkBufferCopy* regions) {
+    for (uint32_t i = 0; i < region_count; ++i) {
+        const char* src = GetBufferData(src_buffer, regions[i].srcOffset, regions[i].size);
+        char* dst = GetBufferData(dst_buffer, regions[i].dstOffset, regions[i].size);
+        if (src && dst) memmove(dst, src, regions[i].size);
+    }
+    context->elapsed += COMMAND_COST_NS;
+}
+
+static void ExecuteFillBuffer(ExecutionContext* context, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, uint32_t data) {
+    const Buffer* buffer_state = buffer_table.Get(buffer);
+    if (buffer_state && size == VK_WHOLE_SIZE) size = offset < buffer_state->create_info.size ? (buffer_state->create_info.size - offset) & ~3ull : 0;
+    if (char* dst = GetBufferData(buffer, offset, size)) FillMemory(dst, size, data);
+    context->elapsed += COMMAND_COST_NS;
+}
+
+static void ExecuteUpdateBuffer(ExecutionContext* context, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, const void* data) {
+    if (char* dst = GetBufferData(buffer, offset, size)) memcpy(dst, data, size);
+    context->elapsed += COMMAND_COST_NS;
+}
+
+static void ExecuteCopyBufferImage(ExecutionContext* context, VkBuffer buffer, VkImage image, uint32_t region_count,
+                                   const VkBufferImageCopy* regions, bool to_image) {
+    for (uint32_t i = 0; i < region_count; ++i) CopyBufferImage(buffer, image, regions[i], to_image);
+    context->elapsed += COMMAND_COST_NS;
+}
+
+static void ExecuteCopyImage(ExecutionContext* context, VkImage src_image, VkImage dst_image, uint32_t region_count,
+                             const VkImageCopy* regions) {
+    for (uint32_t i = 0; i < region_count; ++i) CopyImageToImage(src_image, dst_image, regions[i]);
+    context->elapsed += COMMAND_COST_NS;
+}
+
+// Results are never waited for on the queue. Queries written by earlier commands of the queue are available by
+// then, those that only another queue can still make available are copied as unavailable.
+static void ExecuteCopyQueryPoolResults(ExecutionContext* context, VkQueryPool query_pool, uint32_t first_query, uint32_t query_count,
+                                        VkBuffer buffer, VkDeviceSize offset, VkDeviceSize stride, VkQueryResultFlags flags) {
+    context->elapsed += COMMAND_COST_NS;
+    const QueryPool* pool = GetQueryPool(query_pool);
+    if (!pool || !query_count) return;
+    const uint32_t value_count = pool->values_per_query + ((flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) ? 1 : 0);
+    const VkDeviceSize value_size = (flags & VK_QUERY_RESULT_64_BIT) ? sizeof(uint64_t) : sizeof(uint32_t);
+    char* data = GetBufferData(buffer, offset, (query_count - 1) * stride + value_count * value_size);
+    if (!data) return;
+    for (uint32_t i = 0; i < query_count && first_query + i < pool->available.size(); ++i) {
+        const uint32_t query = first_query + i;
+        WriteQueryResult(pool, query, pool->available[query].load(std::memory_order_acquire), data + i * stride, flags);
+    }
+}
+
+// Clears, blits and resolves run on the queue workers like transfers. Texels are converted through
+// VkClearColorValue, which holds floats for normalized, scaled and floating point formats and 32-bit integers for
+// integer ones, so they only work on formats with components in format_infos. The host is taken to be
+// little-endian, as the packed words of formats are. Images large enough are split into bands of rows that the
+// threads of compute_pool work on.
+static const uint32_t MAX_CONVERTED_BLOCK_SIZE = 16;
+static const VkDeviceSize MIN_ROW_BAND_SIZE = 1024 * 1024;
+
+// Calls function(first_row, end_row) for bands of rows covering row_count rows, one per thread of compute_pool at
+// most and none smaller than MIN_ROW_BAND_SIZE of the size bytes the rows hold
+template <typename Function>
+static void ForEachRowBand(uint32_t row_count, VkDeviceSize size, const Function& function) {
+    const uint32_t band_count = (uint32_t)std::min<VkDeviceSize>(std::min(compute_pool.GetThreadCount(), row_count),
+                                                                 std::max<VkDeviceSize>(size / MIN_ROW_BAND_SIZE, 1));
+    if (band_count <= 1) {
+        function(0, row_count);
+        return;
+    }
+    compute_pool.Run(band_count, [&](uint32_t, uint64_t band) {
+        function((uint32_t)(row_count * band / band_count), (uint32_t)(row_count * (band + 1) / band_count));
+    });
+}
+
+// Returns the first byte of the aspect in a row of a region, counting rows through every sample of every slice
+static inline char* GetRegionRow(const ImageRegion& region, uint32_t row) {
+    const uint32_t y = row % region.blocks_y;
+    const uint32_t sample = row / region.blocks_y % region.samples;
+    const uint32_t slice = row / region.blocks_y / region.samples;
+    return region.data + slice * region.slice_pitch + sample * region.sample_pitch + y * region.row_pitch + region.aspect_offset;
+}
+
+static inline bool IsColorFormat(const FormatInfo& info) {
+    return info.component_count && info.components[0].channel <= FORMAT_CHANNEL_A;
+}
+
+static inline bool IsIntegerFormat(const FormatInfo& info) {
+    return info.component_count &&
+           (info.components[0].numeric == FORMAT_NUMERIC_UINT || info.components[0].numeric == FORMAT_NUMERIC_SINT);
+}
+
+// Formats whose every byte is an 8-bit unsigned normalized component can be filtered and averaged byte by byte
+static bool IsUnorm8Format(const FormatInfo& info) {
+    if (info.plane_count != 1 || info.component_count != info.block_size) return false;
+    for (uint32_t i = 0; i < info.component_count; ++i) {
+        const FormatComponent& component = info.components[i];
+        if (component.numeric != FORMAT_NUMERIC_UNORM || component.bits != 8 || component.offset % 8) return false;
+    }
+    return true;
+}
+
+// Components are at most 32 bits wide, so with the bits before them in their first byte they span at most 5 bytes
+static inline uint32_t ReadComponent(const char* block, const FormatComponent& component) {
+    if (component.offset % 8 == 0) {
+        const char* data = block + component.offset / 8;
+        if (component.bits == 8) return (uint8_t)*data;
+        if (component.bits == 16) {
+            uint16_t bits;
+            memcpy(&bits, data, sizeof(bits));
+            return bits;
+        }
+        if (component.bits == 32) {
+            uint32_t bits;
+            memcpy(&bits, data, sizeof(bits));
+            return bits;
+        }
+    }
+    uint64_t bits = 0;
+    memcpy(&bits, block + component.offset / 8, (component.offset % 8 + component.bits + 7) / 8);
+    return (uint32_t)((bits >> (component.offset % 8)) & ((1ull << component.bits) - 1));
+}
+
+static inline void WriteComponent(char* block, const FormatComponent& component, uint32_t value) {
+    const uint32_t shift = component.offset % 8;
+    const size_t size = (shift + component.bits + 7) / 8;
+    const uint64_t mask = ((1ull << component.bits) - 1) << shift;
+    uint64_t bits = 0;
+    memcpy(&bits, block + component.offset / 8, size);
+    bits = (bits & ~mask) | (((uint64_t)value << shift) & mask);
+    memcpy(block + component.offset / 8, &bits, size);
+}
+
+// Converts floats to the 16-bit floats of SFLOAT formats, or with 6 and 5 mantissa bits and no sign to the 11 and
+// 10-bit floats of UFLOAT formats. Rounds to nearest, saturating to infinity and flushing negative values of unsigned
+// floats to 0.
+static uint32_t PackSmallFloat(float value, uint32_t mantissa_bits, bool is_signed) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = is_signed ? (bits >> 31) << (mantissa_bits + 5) : 0;
+    const uint32_t magnitude = bits & 0x7fffffff;
+    const uint32_t infinity = 0x1fu << mantissa_bits;
+    if (magnitude > 0x7f800000) return infinity | 1;
+    if (!is_signed && (bits >> 31)) return 0;
+    const int32_t exponent = (int32_t)(magnitude >> 23) - 127 + 15;
+    const uint32_t mantissa = magnitude & 0x7fffff;
+    if (exponent >= 31) return sign | infinity;
+    if (exponent <= 0) {
+        const uint32_t shift = (uint32_t)(24 - (int32_t)mantissa_bits - exponent);
+        if (shift > 24) return sign;
+        return sign | (((mantissa | 0x800000) + (1u << (shift - 1))) >> shift);
+    }
+    const uint32_t packed = ((uint32_t)exponent << mantissa_bits) | (mantissa >> (23 - mantissa_bits));
+    return sign | (packed + ((mantissa >> (22 - mantissa_bits)) & 1));
+}
+
+static float UnpackSmallFloat(uint32_t bits, uint32_t mantissa_bits, bool is_signed) {
+    const uint32_t mantissa = bits & ((1u << mantissa_bits) - 1);
+    const uint32_t exponent = (bits >> mantissa_bits) & 0x1f;
+    float value;
+    if (exponent == 0x1f) {
+        value = mantissa ? NAN : INFINITY;
+    } else if (exponent == 0) {
+        value = std::ldexp((float)mantissa, -14 - (int32_t)mantissa_bits);
+    } else {
+        value = std::ldexp((float)(mantissa | (1u << mantissa_bits)), (int32_t)exponent - 15 - (int32_t)mantissa_bits);
+    }
+    return is_signed && ((bits >> (mantissa_bits + 5)) & 1) ? -value : value;
+}
+
+static inline float SrgbToLinear(float value) {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static inline float LinearToSrgb(float value) {
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+// Linear values of the components of sRGB formats, which are all 8 bits wide
+static const float* GetSrgbDecodeTable() {
+    static const struct SrgbDecodeTable {
+        SrgbDecodeTable() {
+            for (uint32_t i = 0; i < 256; ++i) values[i] = SrgbToLinear(i / 255.0f);
+        }
+        float values[256];
+    } table;
+    return table.values;
+}
+
+// Rounds to the nearest integer in [low, high], NaN to low
+static inline int64_t ClampRound(double value, double low, double high) {
+    return (int64_t)std::floor(std::min(std::max(low, value), high) + 0.5);
+}
+
+// Converts the component of a texel block to the channels of a color, missing channels read as 0 and alpha as 1
+static void DecodeTexel(const FormatInfo& info, const char* block, VkClearColorValue* color) {
+    color->uint32[0] = color->uint32[1] = color->uint32[2] = 0;
+    if (IsIntegerFormat(info)) {
+        color->uint32[3] = 1;
+    } else {
+        color->float32[3] = 1.0f;
+    }
+    for (uint32_t i = 0; i < info.component_count; ++i) {
+        const FormatComponent& component = info.components[i];
+        if (component.channel > FORMAT_CHANNEL_A) continue;
+        const uint32_t bits = ReadComponent(block, component);
+        const uint32_t max = (uint32_t)((1ull << component.bits) - 1);
+        const int32_t value = (bits >> (component.bits - 1)) ? (int32_t)(bits | ~max) : (int32_t)bits;
+        float& channel = color->float32[component.channel];
+        switch (component.numeric) {
+            case FORMAT_NUMERIC_UNORM:
+                channel = bits / (float)max;
+                break;
+            case FORMAT_NUMERIC_SNORM:
+                channel = std::max(value / (float)(max >> 1), -1.0f);
+                break;
+            case FORMAT_NUMERIC_USCALED:
+                channel = (float)bits;
+                break;
+            case FORMAT_NUMERIC_SSCALED:
+                channel = (float)value;
+                break;
+            case FORMAT_NUMERIC_UINT:
+                color->uint32[component.channel] = bits;
+                break;
+            case FORMAT_NUMERIC_SINT:
+                color->int32[component.channel] = value;
+                break;
+            case FORMAT_NUMERIC_UFLOAT:
+                channel = UnpackSmallFloat(bits, component.bits - 5, false);
+                break;
+            case FORMAT_NUMERIC_SFLOAT:
+                if (component.bits == 32) {
+                    memcpy(&channel, &bits, sizeof(channel));
+                } else {
+                    channel = UnpackSmallFloat(bits, 10, true);
+                }
+                break;
+            case FORMAT_NUMERIC_SRGB:
+                channel = GetSrgbDecodeTable()[bits & 0xff];
+                break;
+        }
+    }
+}
+
+// Converts channel index of a color to the bits of a component, clamped to what the component holds
+static uint32_t EncodeComponent(const FormatComponent& component, const VkClearColorValue& color, uint32_t index) {
+    const uint32_t max = (uint32_t)((1ull << component.bits) - 1);
+    const double half = max >> 1;
+    const float value = color.float32[index];
+    switch (component.numeric) {
+        case FORMAT_NUMERIC_UNORM:
+            return (uint32_t)ClampRound((double)value * max, 0, max);
+        case FORMAT_NUMERIC_SNORM:
+            return (uint32_t)ClampRound((double)value * half, -half, half) & max;
+        case FORMAT_NUMERIC_USCALED:
+            return (uint32_t)ClampRound(value, 0, max);
+        case FORMAT_NUMERIC_SSCALED:
+            return (uint32_t)ClampRound(value, -half - 1, half) & max;
+        case FORMAT_NUMERIC_UINT:
+            return std::min(color.uint32[index], max);
+        case FORMAT_NUMERIC_SINT:
+            return (uint32_t)std::max(-(int32_t)half - 1, std::min(color.int32[index], (int32_t)half)) & max;
+        case FORMAT_NUMERIC_UFLOAT:
+            return PackSmallFloat(value, component.bits - 5, false);
+        case FORMAT_NUMERIC_SFLOAT:
+            if (component.bits == 32) {
+                uint32_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                return bits;
+            }
+            return PackSmallFloat(value, 10, true);
+        case FORMAT_NUMERIC_SRGB:
+            return (uint32_t)ClampRound((double)LinearToSrgb(value) * max, 0, max);
+    }
+    return 0;
+}
+
+// Writes the color channels of a texel block, leaving padding bits as they are
+static void EncodeTexel(const FormatInfo& info, const VkClearColorValue& color, char* block) {
+    for (uint32_t i = 0; i < info.component_count; ++i) {
+        const FormatComponent& component = info.components[i];
+        if (component.channel <= FORMAT_CHANNEL_A) WriteComponent(block, component, EncodeComponent(component, color, component.channel));
+    }
+}
+
+// Sets the aspects each range selects of every texel in the ranges to those of block. The first row of each band
+// is filled with copies of the block and copied to the others.
+static void ClearImage(VkImage image, const char* block, uint32_t range_count, const VkImageSubresourceRange* ranges) {
+    const Image* image_state = image_table.Get(image);
+    if (!image_state) return;
+    const VkImageCreateInfo& info = image_state->create_info;
+    const VkExtent3D whole_level = {UINT32_MAX, UINT32_MAX, UINT32_MAX};
+    for (uint32_t i = 0; i < range_count; ++i) {
+        const VkImageSubresourceRange& range = ranges[i];
+        if (range.baseMipLevel >= info.mipLevels) continue;
+        const uint32_t end_level = range.baseMipLevel + std::min(range.levelCount, info.mipLevels - range.baseMipLevel);
+        for (uint32_t level = range.baseMipLevel; level < end_level; ++level) {
+            ImageRegion region;
+            const VkImageSubresourceLayers subresource = {range.aspectMask, level, range.baseArrayLayer, range.layerCount};
+            if (!GetImageRegion(image, subresource, {0, 0, 0}, whole_level, &region)) continue;
+            const bool whole_blocks = region.aspect_size == region.block_size;
+            const uint32_t row_size = region.blocks_x * region.block_size;
+            const uint32_t row_count = region.slices * region.samples * region.blocks_y;
+            ForEachRowBand(row_count, (VkDeviceSize)row_count * row_size, [&](uint32_t first_row, uint32_t end_row) {
+                char* first = GetRegionRow(region, first_row);
+                if (whole_blocks) {
+                    FillPattern(first, row_size, block, region.block_size);
+                } else {
+                    CopyBlocks(first, region.block_size, block + region.aspect_offset, 0, region.aspect_size, region.blocks_x, false);
+                }
+                for (uint32_t row = first_row + 1; row < end_row; ++row) {
+                    if (whole_blocks) {
+                        memcpy(GetRegionRow(region, row), first, row_size);
+                    } else {
+                        CopyBlocks(GetRegionRow(region, row), region.block_size, first, region.block_size, region.aspect_size,
+                                   region.blocks_x, false);
+                    }
+                }
+            });
+        }
+    }
+}
+
+// Source texels that a destination texel of a blit samples along one axis, with the weight of the second one
+struct BlitSample {
+    uint32_t first;
+    uint32_t second;
+    float weight;
+};
+
+// Maps the destination texels of a blit along one axis to the source texels they sample. The centers of the texels
+// in the destination box map linearly into the source box, mirrored when one box is given from its far end, and
+// samples are clamped to the edge of the source level. Returns false if the destination box is empty.
+static bool GetBlitSamples(int32_t src0, int32_t src1, int32_t dst0, int32_t dst1, uint32_t src_size, uint32_t dst_size, bool linear,
+                           uint32_t* dst_begin, std::vector<BlitSample>* samples) {
+    const int64_t begin = std::max<int64_t>(std::min(dst0, dst1), 0);
+    const int64_t end = std::min<int64_t>(std::max(dst0, dst1), dst_size);
+    if (begin >= end || src0 == src1) return false;
+    const double scale = (double)(src1 - src0) / (dst1 - dst0);
+    *dst_begin = (uint32_t)begin;
+    samples->resize(end - begin);
+    for (int64_t dst = begin; dst < end; ++dst) {
+        const double position = src0 + (dst + 0.5 - dst0) * scale - (linear ? 0.5 : 0.0);
+        const double first = std::floor(position);
+        BlitSample& sample = (*samples)[dst - begin];
+        sample.first = (uint32_t)std::min(std::max(first, 0.0), src_size - 1.0);
+        sample.second = (uint32_t)std::min(std::max(first + 1, 0.0), src_size - 1.0);
+        sample.weight = linear ? (float)(position - first) : 0.0f;
+    }
+    return true;
+}
+
+// Blits a region as vkCmdBlitImage does. Nearest filtering between images of the same format moves the aspects
+// unconverted, everything else decodes the source rows it samples, filters them and encodes the result.
+static void BlitImageRegion(VkImage src_image, VkImage dst_image, const VkImageBlit& blit, VkFilter filter) {
+    ImageRegion src;
+    ImageRegion dst;
+    const VkExtent3D whole_level = {UINT32_MAX, UINT32_MAX, UINT32_MAX};
+    if (!GetImageRegion(src_image, blit.srcSubresource, {0, 0, 0}, whole_level, &src) ||
+        !GetImageRegion(dst_image, blit.dstSubresource, {0, 0, 0}, whole_level, &dst)) {
+        return;
+    }
+    const FormatInfo& src_format = *src.format_info;
+    const FormatInfo& dst_format = *dst.format_info;
+    for (const FormatInfo* format : {&src_format, &dst_format}) {
+        if (format->plane_count != 1 || format->block_extent.width != 1 || format->block_extent.height != 1) return;
+    }
+    const bool linear = filter == VK_FILTER_LINEAR && IsColorFormat(src_format) && !IsIntegerFormat(src_format);
+    const bool convert = linear || &src_format != &dst_format;
+    // Linear blits within a format of 8-bit normalized components, as mip generation does, filter each byte as a
+    // channel of its own instead of converting texels
+    const bool byte_channels = linear && &src_format == &dst_format && IsUnorm8Format(src_format) && src_format.block_size <= 4;
+    if (convert ? !IsColorFormat(src_format) || !IsColorFormat(dst_format) : src.aspect_size != dst.aspect_size) return;
+    uint32_t x_begin, y_begin, z_begin;
+    std::vector<BlitSample> xs, ys, zs;
+    if (!GetBlitSamples(blit.srcOffsets[0].x, blit.srcOffsets[1].x, blit.dstOffsets[0].x, blit.dstOffsets[1].x, src.blocks_x,
+                        dst.blocks_x, linear, &x_begin, &xs) ||
+        !GetBlitSamples(blit.srcOffsets[0].y, blit.srcOffsets[1].y, blit.dstOffsets[0].y, blit.dstOffsets[1].y, src.blocks_y,
+                        dst.blocks_y, linear, &y_begin, &ys) ||
+        !GetBlitSamples(blit.srcOffsets[0].z, blit.srcOffsets[1].z, blit.dstOffsets[0].z, blit.dstOffsets[1].z, src.depth,
+                        dst.depth, linear, &z_begin, &zs)) {
+        return;
+    }
+    uint32_t x_min = UINT32_MAX;
+    uint32_t x_max = 0;
+    bool contiguous = src.aspect_size == src.block_size;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        x_min = std::min(x_min, std::min(xs[i].first, xs[i].second));
+        x_max = std::max(x_max, std::max(xs[i].first, xs[i].second));
+        contiguous = contiguous && xs[i].first == xs[0].first + i;
+    }
+    const uint32_t layers = std::min(src.slices / src.depth, dst.slices / dst.depth);
+    const uint32_t rows_per_layer = (uint32_t)(zs.size() * ys.size());
+    const uint32_t row_count = layers * rows_per_layer;
+    ForEachRowBand(row_count, (VkDeviceSize)row_count * xs.size() * dst.block_size, [&](uint32_t first_row, uint32_t end_row) {
+        // Decoded source rows, least recently used first out. Destination rows sample at most four and often share
+        // them with the previous row.
+        struct DecodedRow {
+            uint64_t key = UINT64_MAX;
+            uint64_t last_use = 0;
+            std::vector<VkClearColorValue> texels;
+        };
+        DecodedRow decoded_rows[4];
+        uint64_t use = 0;
+        for (uint32_t row = first_row; row < end_row; ++row) {
+            const uint32_t layer = row / rows_per_layer;
+            const uint32_t dst_z = row / (uint32_t)ys.size() % (uint32_t)zs.size();
+            const uint32_t dst_y = row % (uint32_t)ys.size();
+            const BlitSample& z = zs[dst_z];
+            const BlitSample& y = ys[dst_y];
+            char* dst_row = dst.data + (layer * dst.depth + z_begin + dst_z) * dst.slice_pitch + (y_begin + dst_y) * dst.row_pitch +
+                            (VkDeviceSize)x_begin * dst.block_size + dst.aspect_offset;
+            auto get_src_row = [&](uint32_t src_z, uint32_t src_y) {
+                return src.data + (layer * src.depth + src_z) * src.slice_pitch + src_y * src.row_pitch + src.aspect_offset;
+            };
+            if (!convert) {
+                const char* src_row = get_src_row(z.first, y.first);
+                if (contiguous) {
+                    memcpy(dst_row, src_row + (VkDeviceSize)xs[0].first * src.block_size, xs.size() * src.block_size);
+                    continue;
+                }
+                for (size_t i = 0; i < xs.size(); ++i) {
+                    memcpy(dst_row + i * dst.block_size, src_row + (VkDeviceSize)xs[i].first * src.block_size, src.aspect_size);
+                }
+                continue;
+            }
+            auto decode_row = [&](uint32_t src_z, uint32_t src_y) -> const VkClearColorValue* {
+                const uint64_t key = ((uint64_t)(layer * src.depth + src_z) << 32) | src_y;
+                DecodedRow* decoded = &decoded_rows[0];
+                for (DecodedRow& candidate : decoded_rows) {
+                    if (candidate.key == key) {
+                        candidate.last_use = ++use;
+                        return candidate.texels.data();
+                    }
+                    if (candidate.last_use < decoded->last_use) decoded = &candidate;
+                }
+                decoded->key = key;
+                decoded->last_use = ++use;
+                decoded->texels.resize(x_max - x_min + 1);
+                const char* src_row = get_src_row(src_z, src_y) + (VkDeviceSize)x_min * src.block_size;
+                for (uint32_t i = 0; i <= x_max - x_min; ++i) {
+                    const char* block = src_row + i * src.block_size;
+                    if (byte_channels) {
+                        for (uint32_t c = 0; c < 4; ++c) decoded->texels[i].float32[c] = c < src.block_size ? (uint8_t)block[c] : 0.0f;
+                    } else {
+                        DecodeTexel(src_format, block, &decoded->texels[i]);
+                    }
+                }
+                return decoded->texels.data();
+            };
+            const VkClearColorValue* row00 = decode_row(z.first, y.first);
+            if (!linear) {
+                for (size_t i = 0; i < xs.size(); ++i) EncodeTexel(dst_format, row00[xs[i].first - x_min], dst_row + i * dst.block_size);
+                continue;
+            }
+            const VkClearColorValue* row01 = decode_row(z.first, y.second);
+            const VkClearColorValue* row10 = decode_row(z.second, y.first);
+            const VkClearColorValue* row11 = decode_row(z.second, y.second);
+            for (size_t i = 0; i < xs.size(); ++i) {
+                const uint32_t x0 = xs[i].first - x_min;
+                const uint32_t x1 = xs[i].second - x_min;
+                const float wx = xs[i].weight;
+                VkClearColorValue texel;
+                for (uint32_t c = 0; c < 4; ++c) {
+                    const float v00 = row00[x0].float32[c] + (row00[x1].float32[c] - row00[x0].float32[c]) * wx;
+                    const float v01 = row01[x0].float32[c] + (row01[x1].float32[c] - row01[x0].float32[c]) * wx;
+                    const float v10 = row10[x0].float32[c] + (row10[x1].float32[c] - row10[x0].float32[c]) * wx;
+                    const float v11 = row11[x0].float32[c] + (row11[x1].float32[c] - row11[x0].float32[c]) * wx;
+                    const float v0 = v00 + (v01 - v00) * y.weight;
+                    const float v1 = v10 + (v11 - v10) * y.weight;
+                    texel.float32[c] = v0 + (v1 - v0) * z.weight;
+                }
+                if (byte_channels) {
+                    for (uint32_t c = 0; c < dst.block_size; ++c) dst_row[i * dst.block_size + c] = (char)(uint8_t)(texel.float32[c] + 0.5f);
+                } else {
+                    EncodeTexel(dst_format, texel, dst_row + i * dst.block_size);
+                }
+            }
+        }
+    });
+}
+
+// Resolves a region as vkCmdResolveImage does. Normalized and floating point formats average the samples of each
+// texel, integer formats take sample 0. Formats of 8-bit unsigned normalized components average the bytes of whole
+// rows at once without decoding them.
+static void ResolveImageRegion(VkImage src_image, VkImage dst_image, const VkImageResolve& resolve) {
+    ImageRegion src;
+    ImageRegion dst;
+    if (!GetImageRegion(src_image, resolve.srcSubresource, resolve.srcOffset, resolve.extent, &src) ||
+        !GetImageRegion(dst_image, resolve.dstSubresource, resolve.dstOffset, resolve.extent, &dst) ||
+        src.format_info != dst.format_info || !IsColorFormat(*src.format_info)) {
+        return;
+    }
+    const FormatInfo& format = *src.format_info;
+    const uint32_t blocks_x = std::min(src.blocks_x, dst.blocks_x);
+    const uint32_t blocks_y = std::min(src.blocks_y, dst.blocks_y);
+    const uint32_t slices = std::min(src.slices, dst.slices);
+    const uint32_t row_size = blocks_x * format.block_size;
+    const uint32_t samples = src.samples;
+    const bool average = samples > 1 && !IsIntegerFormat(format);
+    const bool unorm8 = IsUnorm8Format(format);
+    // Sample counts are powers of two
+    uint32_t sample_shift = 0;
+    while ((1u << sample_shift) < samples) ++sample_shift;
+    const uint32_t row_count = slices * blocks_y;
+    ForEachRowBand(row_count, (VkDeviceSize)row_count * row_size * samples, [&](uint32_t first_row, uint32_t end_row) {
+        std::vector<uint16_t> sums;
+        std::vector<VkClearColorValue> texels;
+        for (uint32_t row = first_row; row < end_row; ++row) {
+            const char* src_row = src.data + row / blocks_y * src.slice_pitch + row % blocks_y * src.row_pitch;
+            char* dst_row = dst.data + row / blocks_y * dst.slice_pitch + row % blocks_y * dst.row_pitch;
+            if (!average) {
+                memcpy(dst_row, src_row, row_size);
+            } else if (unorm8) {
+                sums.assign(row_size, 0);
+                for (uint32_t sample = 0; sample < samples; ++sample) {
+                    const uint8_t* sample_row = reinterpret_cast<const uint8_t*>(src_row + sample * src.sample_pitch);
+                    for (uint32_t i = 0; i < row_size; ++i) sums[i] += sample_row[i];
+                }
+                for (uint32_t i = 0; i < row_size; ++i) dst_row[i] = (char)((sums[i] + (samples >> 1)) >> sample_shift);
+            } else {
+                texels.resize(blocks_x);
+                for (uint32_t x = 0; x < blocks_x; ++x) {
+                    VkClearColorValue& texel = texels[x];
+                    texel = {};
+                    for (uint32_t sample = 0; sample < samples; ++sample) {
+                        VkClearColorValue value;
+                        DecodeTexel(format, src_row + sample * src.sample_pitch + x * format.block_size, &value);
+                        for (uint32_t c = 0; c < 4; ++c) texel.float32[c] += value.float32[c];
+                    }
+                    for (uint32_t c = 0; c < 4; ++c) texel.float32[c] /= samples;
+                    EncodeTexel(format, texel, dst_row + x * format.block_size);
+                }
+            }
+        }
+    });
+}
+
+static void ExecuteClearColorImage(ExecutionContext* context, VkImage image, const VkClearColorValue& color, uint32_t range_count,
+                                   const VkImageSubresourceRange* ranges) {
+    context->elapsed += COMMAND_COST_NS;
+    const Image* image_state = image_table.Get(image);
+    const FormatInfo* format_info = image_state ? GetFormatInfo(image_state->create_info.format) : nullptr;
+    if (!format_info || !IsColorFormat(*format_info) || format_info->block_size > MAX_CONVERTED_BLOCK_SIZE) return;
+    char block[MAX_CONVERTED_BLOCK_SIZE] = {};
+    EncodeTexel(*format_info, color, block);
+    ClearImage(image, block, range_count, ranges);
+}
+
+static void ExecuteClearDepthStencilImage(ExecutionContext* context, VkImage image, const VkClearDepthStencilValue& depth_stencil,
+                                          uint32_t range_count, const VkImageSubresourceRange* ranges) {
+    context->elapsed += COMMAND_COST_NS;
+    const Image* image_state = image_table.Get(image);
+    const FormatInfo* format_info = image_state ? GetFormatInfo(image_state->create_info.format) : nullptr;
+    if (!format_info || !format_info->component_count || IsColorFormat(*format_info) ||
+        format_info->block_size > MAX_CONVERTED_BLOCK_SIZE) {
+        return;
+    }
+    // Depth goes through the first channel as a float, stencil through the second as an integer
+    VkClearColorValue value = {};
+    value.float32[0] = depth_stencil.depth;
+    value.uint32[1] = depth_stencil.stencil;
+    char block[MAX_CONVERTED_BLOCK_SIZE] = {};
+    for (uint32_t i = 0; i < format_info->component_count; ++i) {
+        const FormatComponent& component = format_info->components[i];
+        WriteComponent(block, component, EncodeComponent(component, value, component.channel == FORMAT_CHANNEL_DEPTH ? 0 : 1));
+    }
+    ClearImage(image, block, range_count, ranges);
+}
+
+static void ExecuteBlitImage(ExecutionContext* context, VkImage src_image, VkImage dst_image, uint32_t region_count,
+                             const VkImageBlit* regions, VkFilter filter) {
+    for (uint32_t i = 0; i < region_count; ++i) BlitImageRegion(src_image, dst_image, regions[i], filter);
+    context->elapsed += COMMAND_COST_NS;
+}
+
+static void ExecuteResolveImage(ExecutionContext* context, VkImage src_image, VkImage dst_image, uint32_t region_count,
+                                const VkImageResolve* regions) {
+    for (uint32_t i = 0; i < region_count; ++i) ResolveImageRegion(src_image, dst_image, regions[i]);
+    context->elapsed += COMMAND_COST_NS;
+}
+
+// Shaders sample image views through textures resolved to host memory when a dispatch or draw starts. 1D and 2D
+// views, arrayed or not, of the formats clears convert can be sampled, with depth read as red. Filtering follows the
+// sampler's filters, mipmap mode, address modes, border color and LOD bias and clamps; integer formats are always
+// sampled nearest. Anisotropy, compare ops and cube maps are not implemented.
+struct ShaderTexture {
+    const FormatInfo* format_info = nullptr;  // Null without an image view, or with one that cannot be sampled
+    bool unorm8 = false;
+    bool depth = false;
+    VkComponentMapping components = {};
+    std::vector<ImageRegion> levels;  // Of the view, each with all the view's layers
+    bool has_sampler = false;
+    VkSamplerCreateInfo sampler;
+};
+
+// Samplers missing from descriptors, such as immutable ones, sample nearest texels clamped to the edge
+static const VkSamplerCreateInfo& GetDefaultSampler() {
+    static const struct DefaultSampler {
+        DefaultSampler() {
+            memset(&create_info, 0, sizeof(create_info));
+            create_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+            create_info.addressModeU = create_info.addressModeV = create_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            create_info.maxLod = VK_LOD_CLAMP_NONE;
+        }
+        VkSamplerCreateInfo create_info;
+    } sampler;
+    return sampler.create_info;
+}
+
+// Reads the depth of a texel block, 0 for formats without depth
+static float DecodeDepth(const FormatInfo& info, const char* block) {
+    for (uint32_t i = 0; i < info.component_count; ++i) {
+        const FormatComponent& component = info.components[i];
+        if (component.channel != FORMAT_CHANNEL_DEPTH) continue;
+        const uint32_t bits = ReadComponent(block, component);
+        if (component.numeric == FORMAT_NUMERIC_SFLOAT) return ShaderFloat(bits);
+        return bits / (float)((1ull << component.bits) - 1);
+    }
+    return 0.0f;
+}
+
+static void ResolveShaderTexture(VkImageView image_view, ShaderTexture* texture) {
+    const ImageView* view = image_view_table.Get(image_view);
+    if (!view) return;
+    const FormatInfo* format_info = GetFormatInfo(view->format);
+    if (!format_info || format_info->plane_count != 1 || !format_info->component_count || format_info->block_size > MAX_CONVERTED_BLOCK_SIZE ||
+        format_info->block_extent.width != 1 || format_info->block_extent.height != 1 || format_info->block_extent.depth != 1) {
+        return;
+    }
+    switch (view->view_type) {
+        case VK_IMAGE_VIEW_TYPE_1D:
+        case VK_IMAGE_VIEW_TYPE_2D:
+        case VK_IMAGE_VIEW_TYPE_1D_ARRAY:
+        case VK_IMAGE_VIEW_TYPE_2D_ARRAY:
+            break;
+        default:
+            return;
+    }
+    const bool depth = !IsColorFormat(*format_info);
+    for (uint32_t level = 0; level < view->range.levelCount; ++level) {
+        const VkImageSubresourceLayers subresource = {depth ? (VkImageAspectFlags)VK_IMAGE_ASPECT_DEPTH_BIT : (VkImageAspectFlags)VK_IMAGE_ASPECT_COLOR_BIT,
+                                                      view->range.baseMipLevel + level, view->range.baseArrayLayer, view->range.layerCount};
+        ImageRegion region;
+        if (!GetImageRegion(view->image, subresource, {0, 0, 0}, {UINT32_MAX, UINT32_MAX, 1}, &region) || region.samples != 1) break;
+        texture->levels.push_back(region);
+    }
+    if (texture->levels.empty()) return;
+    texture->format_info = format_info;
+    texture->unorm8 = IsUnorm8Format(*format_info);
+    texture->depth = depth;
+    texture->components = view->components;
+}
+
+static inline int32_t FloorTexelCoordinate(float value) {
+    if (!(value > -1e9f)) return -1000000000;  // NaN too
+    return (int32_t)std::floor(std::min(value, 1e9f));
+}
+
+// Applies an address mode to a texel coordinate, giving -1 outside the level with CLAMP_TO_BORDER
+static int32_t WrapTexelCoordinate(int32_t i, int32_t size, VkSamplerAddressMode mode) {
+    switch (mode) {
+        case VK_SAMPLER_ADDRESS_MODE_REPEAT:
+            return ((i % size) + size) % size;
+        case VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT: {
+            const int32_t t = ((i % (2 * size)) + 2 * size) % (2 * size);
+            return t < size ? t : 2 * size - 1 - t;
+        }
+        case VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE:
+            return std::min(i < 0 ? -1 - i : i, size - 1);
+        case VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER:
+            return i < 0 || i >= size ? -1 : i;
+        default:
+            return std::min(std::max(i, 0), size - 1);
+    }
+}
+
+static void ReadTexture(const ShaderTexture& texture, const ImageRegion& level, const char* block, VkClearColorValue* color) {
+    const FormatInfo& info = *texture.format_info;
+    if (texture.unorm8) {
+        color->float32[0] = color->float32[1] = color->float32[2] = 0.0f;
+        color->float32[3] = 1.0f;
+        for (uint32_t i = 0; i < info.component_count; ++i) {
+            color->float32[info.components[i].channel] = (uint8_t)block[info.components[i].offset / 8] * (1.0f / 255.0f);
+        }
+    } else if (texture.depth) {
+        color->float32[0] = DecodeDepth(info, block);
+        color->float32[1] = color->float32[2] = 0.0f;
+        color->float32[3] = 1.0f;
+    } else {
+        DecodeTexel(info, block, color);
+    }
+}
+
+// Reads a texel of a level, or the sampler's border color outside it with CLAMP_TO_BORDER
+static void ReadTexel(const ShaderTexture& texture, const ImageRegion& level, const VkSamplerCreateInfo& sampler, int32_t x, int32_t y,
+                      uint32_t layer, VkClearColorValue* color) {
+    x = WrapTexelCoordinate(x, (int32_t)level.blocks_x, sampler.addressModeU);
+    y = WrapTexelCoordinate(y, (int32_t)level.blocks_y, sampler.addressModeV);
+    if (x < 0 || y < 0) {
+        const bool integer = IsIntegerFormat(*texture.format_info);
+        const bool opaque = sampler.borderColor >= VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+        const bool white = sampler.borderColor >= VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+        for (uint32_t c = 0; c < 4; ++c) {
+            const bool one = c == 3 ? opaque : white;
+            color->uint32[c] = one ? (integer ? 1 : ShaderBits(1.0f)) : 0;
+        }
+        return;
+    }
+    const char* block = level.data + layer * level.slice_pitch + (VkDeviceSize)y * level.row_pitch + (VkDeviceSize)x * level.block_size;
+    ReadTexture(texture, level, block, color);
+}
+
+// Filters a level at coordinates normalized unless the sampler says otherwise
+static void FilterTexture(const ShaderTexture& texture, uint32_t level_index, const VkSamplerCreateInfo& sampler, VkFilter filter,
+                          uint32_t dimensions, const float* coordinates, uint32_t layer, const int32_t* offset, VkClearColorValue* color) {
+    const ImageRegion& level = texture.levels[level_index];
+    float u = coordinates[0];
+    float v = dimensions > 1 ? coordinates[1] : 0.0f;
+    if (!sampler.unnormalizedCoordinates) {
+        u *= level.blocks_x;
+        v *= level.blocks_y;
+    }
+    if (filter == VK_FILTER_NEAREST || IsIntegerFormat(*texture.format_info)) {
+        ReadTexel(texture, level, sampler, FloorTexelCoordinate(u) + offset[0], dimensions > 1 ? FloorTexelCoordinate(v) + offset[1] : 0,
+                  layer, color);
+        return;
+    }
+    u -= 0.5f;
+    v -= 0.5f;
+    const int32_t x = FloorTexelCoordinate(u) + offset[0];
+    const int32_t y = dimensions > 1 ? FloorTexelCoordinate(v) + offset[1] : 0;
+    const float a = u - std::floor(u);
+    const float b = dimensions > 1 ? v - std::floor(v) : 0.0f;
+    VkClearColorValue texels[4];
+    ReadTexel(texture, level, sampler, x, y, layer, &texels[0]);
+    ReadTexel(texture, level, sampler, x + 1, y, layer, &texels[1]);
+    if (dimensions > 1) {
+        ReadTexel(texture, level, sampler, x, y + 1, layer, &texels[2]);
+        ReadTexel(texture, level, sampler, x + 1, y + 1, layer, &texels[3]);
+    } else {
+        texels[2] = texels[0];
+        texels[3] = texels[1];
+    }
+    for (uint32_t c = 0; c < 4; ++c) {
+        const float top = texels[0].float32[c] + (texels[1].float32[c] - texels[0].float32[c]) * a;
+        const float bottom = texels[2].float32[c] + (texels[3].float32[c] - texels[2].float32[c]) * a;
+        color->float32[c] = top + (bottom - top) * b;
+    }
+}
+
+static void SwizzleColor(const VkComponentMapping& mapping, bool integer, VkClearColorValue* color) {
+    const VkClearColorValue source = *color;
+    const VkComponentSwizzle swizzles[4] = {mapping.r, mapping.g, mapping.b, mapping.a};
+    for (uint32_t c = 0; c < 4; ++c) {
+        switch (swizzles[c]) {
+            case VK_COMPONENT_SWIZZLE_ZERO: color->uint32[c] = 0; break;
+            case VK_COMPONENT_SWIZZLE_ONE: color->uint32[c] = integer ? 1 : ShaderBits(1.0f); break;
+            case VK_COMPONENT_SWIZZLE_R:
+            case VK_COMPONENT_SWIZZLE_G:
+            case VK_COMPONENT_SWIZZLE_B:
+            case VK_COMPONENT_SWIZZLE_A: color->uint32[c] = source.uint32[swizzles[c] - VK_COMPONENT_SWIZZLE_R]; break;
+            default: break;
+        }
+    }
+}
+
+// Samples a texture at a level of detail, before the sampler's bias and clamps
+static void SampleTexture(const ShaderTexture& texture, const VkSamplerCreateInfo& sampler, uint32_t dimensions, bool arrayed,
+                          const float* coordinates, float lambda, const int32_t* offset, VkClearColorValue* color) {
+    const uint32_t layer = arrayed ? (uint32_t)ClampRound(coordinates[dimensions], 0, texture.levels[0].slices - 1) : 0;
+    lambda = std::fmin(std::fmax(lambda + sampler.mipLodBias, sampler.minLod), sampler.maxLod);
+    const VkFilter filter = lambda > 0.0f ? sampler.minFilter : sampler.magFilter;
+    const float level = std::max(lambda, 0.0f);
+    const float last = (float)(texture.levels.size() - 1);
+    const bool integer = IsIntegerFormat(*texture.format_info);
+    if (sampler.mipmapMode == VK_SAMPLER_MIPMAP_MODE_NEAREST || integer) {
+        const uint32_t index = level <= 0.5f ? 0 : (uint32_t)std::min(std::ceil(level + 0.5f) - 1.0f, last);
+        FilterTexture(texture, index, sampler, filter, dimensions, coordinates, layer, offset, color);
+    } else {
+        const float first = std::min(std::floor(level), last);
+        const float weight = first < last ? level - first : 0.0f;
+        FilterTexture(texture, (uint32_t)first, sampler, filter, dimensions, coordinates, layer, offset, color);
+        if (weight > 0.0f) {
+            VkClearColorValue next;
+            FilterTexture(texture, (uint32_t)first + 1, sampler, filter, dimensions, coordinates, layer, offset, &next);
+            for (uint32_t c = 0; c < 4; ++c) color->float32[c] += (next.float32[c] - color->float32[c]) * weight;
+        }
+    }
+    SwizzleColor(texture.components, integer, color);
+}
+
+// Texel fetches read a level at integer coordinates, 0 outside it
+static void FetchTexture(const ShaderTexture& texture, uint32_t dimensions, bool arrayed, const int32_t* coordinates, int32_t lod,
+                         VkClearColorValue* color) {
+    memset(color, 0, sizeof(*color));
+    if (lod < 0 || (uint32_t)lod >= texture.levels.size()) return;
+    const ImageRegion& level = texture.levels[lod];
+    const int32_t x = coordinates[0];
+    const int32_t y = dimensions > 1 ? coordinates[1] : 0;
+    const int32_t layer = arrayed ? coordinates[dimensions] : 0;
+    if (x < 0 || y < 0 || layer < 0 || (uint32_t)x >= level.blocks_x || (uint32_t)y >= level.blocks_y || (uint32_t)layer >= level.slices) return;
+    ReadTexture(texture, level, level.data + layer * level.slice_pitch + (VkDeviceSize)y * level.row_pitch + (VkDeviceSize)x * level.block_size,
+                color);
+    SwizzleColor(texture.components, IsIntegerFormat(*texture.format_info), color);
+}
+
+// Sampled images hold the texture index plus one of their image and of their sampler. Implicit LODs come from the
+// coarse derivatives of the coordinates in the lane's quad, and are 0 outside fragment shaders.
+void ShaderInvocations::Sample(const ShaderInstruction& instruction, LaneMask active) {
+    const uint32_t operands = instruction.aux[0];
+    const uint32_t dimensions = instruction.aux[1] & 0xff;
+    const bool arrayed = (instruction.aux[1] & SHADER_IMAGE_ARRAYED) != 0;
+    const bool fetch = instruction.op == SPIRV_OP_IMAGE_FETCH;
+    const uint32_t* image = OperandRegister(instruction, 0);
+    const uint32_t* coordinates = OperandRegister(instruction, 1);
+    const uint32_t coordinate_count = Components(program_.value_types[Operand(instruction, 1)]);
+    // Optional operands follow the mask in the order of its bits
+    const uint32_t* bias = nullptr;
+    const uint32_t* lod = nullptr;
+    const uint32_t* gradients[2] = {};
+    const uint32_t* offset = nullptr;
+    uint32_t next = 3;
+    if (operands & SPIRV_IMAGE_OPERANDS_BIAS) bias = FindRegister(instruction, next++);
+    if (operands & SPIRV_IMAGE_OPERANDS_LOD) lod = FindRegister(instruction, next++);
+    if (operands & SPIRV_IMAGE_OPERANDS_GRAD) {
+        gradients[0] = FindRegister(instruction, next++);
+        gradients[1] = FindRegister(instruction, next++);
+    }
+    if (operands & (SPIRV_IMAGE_OPERANDS_CONST_OFFSET | SPIRV_IMAGE_OPERANDS_OFFSET)) offset = FindRegister(instruction, next++);
+    const bool implicit = instruction.op == SPIRV_OP_IMAGE_SAMPLE_IMPLICIT_LOD && !gradients[0] &&
+                          program_.execution_model == SPIRV_EXECUTION_MODEL_FRAGMENT;
+    uint32_t* result = scratch_.data();
+    for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+        VkClearColorValue color = {};
+        const uint32_t texture_index = image[l] - 1;
+        if ((active >> l & 1) && texture_index < texture_count_ && textures_[texture_index].format_info) {
+            const ShaderTexture& texture = textures_[texture_index];
+            float position[3] = {};
+            int32_t texel[3] = {};
+            int32_t texel_offset[2] = {};
+            for (uint32_t c = 0; c < 3 && c < coordinate_count; ++c) {
+                position[c] = ShaderFloat(coordinates[c * SHADER_LANES + l]);
+                texel[c] = (int32_t)coordinates[c * SHADER_LANES + l];
+            }
+            for (uint32_t c = 0; offset && c < dimensions; ++c) texel_offset[c] = (int32_t)offset[c * SHADER_LANES + l];
+            if (fetch) {
+                FetchTexture(texture, dimensions, arrayed, texel, lod ? (int32_t)lod[l] : 0, &color);
+            } else {
+                const uint32_t sampler_index = image[SHADER_LANES + l] - 1;
+                const VkSamplerCreateInfo& sampler = sampler_index < texture_count_ && textures_[sampler_index].has_sampler
+                                                         ? textures_[sampler_index].sampler
+                                                         : GetDefaultSampler();
+                // Scale of texels per unit of the derivatives, 1 for unnormalized coordinates
+                const float scale[2] = {sampler.unnormalizedCoordinates ? 1.0f : (float)texture.levels[0].blocks_x,
+                                        sampler.unnormalizedCoordinates ? 1.0f : (float)texture.levels[0].blocks_y};
+                float lambda = 0.0f;
+                if (lod) {
+                    lambda = ShaderFloat(lod[l]);
+                } else if (gradients[0] || implicit) {
+                    float rho[2] = {};
+                    for (uint32_t d = 0; d < 2; ++d) {
+                        for (uint32_t c = 0; c < dimensions; ++c) {
+                            const uint32_t* value = coordinates + c * SHADER_LANES;
+                            const uint32_t quad = l & ~3u;
+                            const float derivative = gradients[0] ? ShaderFloat(gradients[d][c * SHADER_LANES + l])
+                                                                  : ShaderFloat(value[quad + 1 + d]) - ShaderFloat(value[quad]);
+                            rho[d] += derivative * scale[c] * derivative * scale[c];
+                        }
+                    }
+                    lambda = 0.5f * std::log2(std::max(rho[0], rho[1]));
+                }
+                if (bias) lambda += ShaderFloat(bias[l]);
+                SampleTexture(texture, sampler, dimensions, arrayed, position, lambda, texel_offset, &color);
+            }
+        }
+        for (uint32_t c = 0; c < 4; ++c) result[c * SHADER_LANES + l] = color.uint32[c];
+    }
+    Commit(instruction.result, result, 4);
+}
+
+// What the descriptors of a program are bound to. Buffer descriptors get regions of their buffers, left null like the
+// ranges that do not fit in their buffer or its memory. Image and sampler descriptors get regions holding the index
+// plus one of their texture twice, where loading an image, a sampler or a combined image sampler finds it.
+struct ShaderBindings {
+    std::vector<ShaderRegion> regions;
+    std::vector<ShaderTexture> textures;
+    std::vector<uint32_t> texture_indices;  // Backing the regions of image and sampler descriptors
+};
+
+static void GetShaderBindings(BindPointState* state, const ShaderProgram& program, ShaderBindings* bindings) {
+    std::vector<ShaderRegion>& regions = bindings->regions;
+    regions.assign(program.region_count, ShaderRegion{nullptr, 0});
+    regions[SHADER_PUSH_CONSTANT_REGION] = {state->push_constants, sizeof(state->push_constants)};
+    size_t index_count = 0;
+    for (const auto& descriptor : program.descriptors) {
+        if (descriptor.image) index_count += 2 * (size_t)descriptor.count;
+    }
+    // Regions point into the indices, which must not move
+    bindings->texture_indices.reserve(index_count);
+    for (const auto& descriptor : program.descriptors) {
+        if (descriptor.set >= MAX_BOUND_DESCRIPTOR_SETS || !state->sets[descriptor.set].set) continue;
+        const BoundDescriptorSet& bound = state->sets[descriptor.set];
+        const DescriptorSet& set = *bound.set;
+        if (descriptor.binding >= set.layout->bindings.size()) continue;
+        const DescriptorLayoutBinding& binding = set.layout->bindings[descriptor.binding];
+        const Descriptor* descriptors = set.descriptors + binding.first;
+        const uint32_t count = std::min(descriptor.count, GetBindingCount(set, descriptor.binding));
+        for (uint32_t i = 0; descriptor.image && IsImageDescriptor(binding.type) && i < count; ++i) {
+            ShaderTexture texture;
+            if (binding.type != VK_DESCRIPTOR_TYPE_SAMPLER) ResolveShaderTexture(descriptors[i].image.imageView, &texture);
+            const Sampler* sampler = binding.type != VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE ? sampler_table.Get(descriptors[i].image.sampler) : nullptr;
+            if (sampler) {
+                texture.has_sampler = true;
+                texture.sampler = sampler->create_info;
+            }
+            bindings->textures.push_back(std::move(texture));
+            bindings->texture_indices.push_back((uint32_t)bindings->textures.size());
+            bindings->texture_indices.push_back((uint32_t)bindings->textures.size());
+            regions[descriptor.region + i] = {reinterpret_cast<char*>(&bindings->texture_indices.back() - 1), 2 * sizeof(uint32_t)};
+        }
+        const bool dynamic = IsDynamicBufferDescriptor(binding.type);
+        for (uint32_t i = 0; !descriptor.image && IsBufferDescriptor(binding.type) && i < count; ++i) {
+            const VkDescriptorBufferInfo& info = descriptors[i].buffer;
+            const Buffer* buffer = buffer_table.Get(info.buffer);
+            VkDeviceSize offset = info.offset;
+            if (dynamic && binding.dynamic + i < bound.dynamic_offsets.size()) offset += bound.dynamic_offsets[binding.dynamic + i];
+            if (!buffer || offset > buffer->create_info.size) continue;
+            const VkDeviceSize size = info.range == VK_WHOLE_SIZE ? buffer->create_info.size - offset : info.range;
+            if (char* data = GetBufferData(info.buffer, offset, size)) regions[descriptor.region + i] = {data, size};
+        }
+    }
+}
+
+// Dispatches run the program of the bound pipeline, when it has one, and are charged by the cost model either way
+static void ExecuteDispatch(ExecutionContext* context, const uint32_t base[3], const uint32_t group_count[3]) {
+    const uint64_t workgroups = (uint64_t)group_count[0] * group_count[1] * group_count[2];
+    const ShaderProgram* program = context->compute.program.get();
+    const uint64_t invocations =
+        program ? (uint64_t)program->local_size[0] * program->local_size[1] * program->local_size[2] : INVOCATIONS_PER_WORKGROUP;
+    context->counters[COUNTER_COMPUTE_SHADER_INVOCATIONS] += workgroups * invocations;
+    context->elapsed += COMMAND_COST_NS + workgroups * WORKGROUP_COST_NS;
+    if (!program) return;
+    ShaderBindings bindings;
+    GetShaderBindings(&context->compute, *program, &bindings);
+    RunWorkgroups(*program, bindings.regions, bindings.textures.data(), (uint32_t)bindings.textures.size(), base, group_count);
+}
+
+static void ExecuteDispatchIndirect(ExecutionContext* context, VkBuffer buffer, VkDeviceSize offset) {
+    VkDispatchIndirectCommand command = {};
+    if (const char* data = GetBufferData(buffer, offset, sizeof(command))) memcpy(&command, data, sizeof(command));
+    const uint32_t base[3] = {0, 0, 0};
+    const uint32_t group_count[3] = {command.x, command.y, command.z};
+    ExecuteDispatch(context, base, group_count);
+}
+
+// Draws in render passes are rasterized by mock_icd_raster.cpp, with the front end below resolving what they use to
+// host memory and shading their vertices
+
+// Fragment shader bindings of a draw, with the copy of the push constants their push constant region points to
+struct RasterBindings {
+    ShaderBindings bindings;
+    char push_constants[MAX_PUSH_CONSTANTS_SIZE];
+};
+
+// Vertex attribute read by a location of the vertex shader, resolved to the bound vertex buffer
+struct RasterVertexInput {
+    uint32_t offset;  // Of the location in the vertex invocation's memory
+    uint32_t size;
+    const FormatInfo* format_info;
+    const char* data;  // Vertex buffer from its bound offset on
+    VkDeviceSize data_size;
+    uint32_t attribute_offset;
+    uint32_t stride;
+    bool per_instance;
+};
+
+static void ResolveRasterAttachment(VkImageView image_view, RasterAttachment* attachment) {
+    const ImageView* view = image_view_table.Get(image_view);
+    const FormatInfo* format_info = view ? GetFormatInfo(view->format) : nullptr;
+    if (!format_info || format_info->plane_count != 1 || !format_info->component_count || format_info->block_size > MAX_CONVERTED_BLOCK_SIZE ||
+        format_info->block_extent.width != 1 || format_info->block_extent.height != 1 || format_info->block_extent.depth != 1) {
+        return;
+    }
+    const bool color = IsColorFormat(*format_info);
+    const VkImageSubresourceLayers subresource = {color ? (VkImageAspectFlags)VK_IMAGE_ASPECT_COLOR_BIT : (VkImageAspectFlags)VK_IMAGE_ASPECT_DEPTH_BIT,
+                                                  view->range.baseMipLevel, view->range.baseArrayLayer, 1};
+    ImageRegion region;
+    if (!GetImageRegion(view->image, subresource, {0, 0, 0}, {UINT32_MAX, UINT32_MAX, 1}, &region) || region.samples != 1 ||
+        region.block_size != format_info->block_size) {
+        return;
+    }
+    attachment->data = region.data;
+    attachment->row_pitch = region.row_pitch;
+    attachment->texel_size = region.block_size;
+    attachment->width = region.blocks_x;
+    attachment->height = region.blocks_y;
+    if (color) {
+        const FormatNumeric numeric = format_info->components[0].numeric;
+        if (numeric == FORMAT_NUMERIC_UNORM || numeric == FORMAT_NUMERIC_SRGB) attachment->low = 0.0f;
+        if (numeric == FORMAT_NUMERIC_SNORM) attachment->low = -1.0f;
+        if (numeric == FORMAT_NUMERIC_UNORM || numeric == FORMAT_NUMERIC_SRGB || numeric == FORMAT_NUMERIC_SNORM) attachment->high = 1.0f;
+        attachment->unorm8 = IsUnorm8Format(*format_info);
+        attachment->integer = IsIntegerFormat(*format_info);
+    } else {
+        for (uint32_t i = 0; i < format_info->component_count; ++i) {
+            if (format_info->components[i].channel == FORMAT_CHANNEL_DEPTH) attachment->depth = &format_info->components[i];
+        }
+        // Stencil only formats are left alone
+        if (!attachment->depth) return;
+        if (attachment->depth->numeric == FORMAT_NUMERIC_UNORM) {
+            attachment->low = 0.0f;
+            attachment->high = 1.0f;
+        }
+    }
+    attachment->format_info = format_info;
+}
+
+// Conversions of the rows of texels tiles load and store, for the attachments resolved above
+void LoadRasterColors(const RasterAttachment& attachment, const char* texels, uint32_t count, VkClearColorValue* colors) {
+    const FormatInfo& info = *attachment.format_info;
+    for (uint32_t x = 0; x < count; ++x, texels += info.block_size) {
+        VkClearColorValue& value = colors[x];
+        if (attachment.unorm8) {
+            value.float32[0] = value.float32[1] = value.float32[2] = 0.0f;
+            value.float32[3] = 1.0f;
+            for (uint32_t i = 0; i < info.component_count; ++i) {
+                value.float32[info.components[i].channel] = (uint8_t)texels[info.components[i].offset / 8] * (1.0f / 255.0f);
+            }
+        } else {
+            DecodeTexel(info, texels, &value);
+        }
+    }
+}
+
+void StoreRasterColors(const RasterAttachment& attachment, const VkClearColorValue* colors, uint32_t count, char* texels) {
+    const FormatInfo& info = *attachment.format_info;
+    for (uint32_t x = 0; x < count; ++x, texels += info.block_size) {
+        if (attachment.unorm8) {
+            for (uint32_t i = 0; i < info.component_count; ++i) {
+                texels[info.components[i].offset / 8] = (char)ClampRound(colors[x].float32[info.components[i].channel] * 255.0, 0, 255);
+            }
+        } else {
+            EncodeTexel(info, colors[x], texels);
+        }
+    }
+}
+
+void LoadRasterDepths(const RasterAttachment& attachment, const char* texels, uint32_t count, float* depths) {
+    for (uint32_t x = 0; x < count; ++x, texels += attachment.texel_size) depths[x] = DecodeDepth(*attachment.format_info, texels);
+}
+
+void StoreRasterDepths(const RasterAttachment& attachment, const float* depths, uint32_t count, char* texels) {
+    const FormatComponent& component = *attachment.depth;
+    for (uint32_t x = 0; x < count; ++x, texels += attachment.texel_size) {
+        VkClearColorValue value;
+        value.float32[0] = depths[x];
+        WriteComponent(texels, component, EncodeComponent(component, value, 0));
+    }
+}
+
+static void ExecuteBeginRenderPass(ExecutionContext* context, const VkRenderPassBeginInfo& begin_info) {
+    context->render_pass.reset();
+    if (!GetRasterizationEnabled()) return;
+    const RenderPass* render_pass = render_pass_table.Get(begin_info.renderPass);
+    const Framebuffer* framebuffer = framebuffer_table.Get(begin_info.framebuffer);
+    if (!render_pass || !framebuffer || render_pass->subpasses.empty()) return;
+    std::shared_ptr<RenderPassInstance> instance(new RenderPassInstance());
+    instance->render_area = {{0, 0}, {framebuffer->width, framebuffer->height}};
+    if (!ClipToRenderArea(*instance, begin_info.renderArea, &instance->render_area)) return;
+    instance->render_pass = *render_pass;
+    instance->attachments.resize(render_pass->attachments.size());
+    for (size_t i = 0; i < instance->attachments.size() && i < framebuffer->attachments.size(); ++i) {
+        RasterAttachment& attachment = instance->attachments[i];
+        if (begin_info.pClearValues && i < begin_info.clearValueCount) attachment.clear_value = begin_info.pClearValues[i];
+        ResolveRasterAttachment(framebuffer->attachments[i], &attachment);
+    }
+    const VkRect2D& area = instance->render_area;
+    instance->tiles_x = DivideRoundingUp(area.offset.x + area.extent.width, RASTER_TILE_SIZE);
+    instance->tiles_y = DivideRoundingUp(area.offset.y + area.extent.height, RASTER_TILE_SIZE);
+    instance->bins.resize((size_t)instance->tiles_x * instance->tiles_y);
+    context->render_pass = std::move(instance);
+}
+
+static void ExecuteClearAttachments(ExecutionContext* context, uint32_t attachment_count, const VkClearAttachment* attachments,
+                                    uint32_t rect_count, const VkClearRect* rects) {
+    RenderPassInstance* instance = context->render_pass.get();
+    if (!instance) return;
+    const RenderSubpass& subpass = instance->render_pass.subpasses[instance->subpass];
+    for (uint32_t i = 0; i < attachment_count; ++i) {
+        const VkClearAttachment& attachment = attachments[i];
+        RasterClear clear;
+        clear.value = attachment.clearValue;
+        if (attachment.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT) {
+            if (attachment.colorAttachment >= subpass.colors.size() || subpass.colors[attachment.colorAttachment] == VK_ATTACHMENT_UNUSED) continue;
+            clear.color = attachment.colorAttachment;
+        } else if ((attachment.aspectMask & VK_IMAGE_ASPECT_DEPTH_BIT) && subpass.depth_stencil != VK_ATTACHMENT_UNUSED) {
+            clear.color = UINT32_MAX;
+        } else {
+            continue;
+        }
+        for (uint32_t r = 0; r < rect_count; ++r) {
+            if (rects[r].baseArrayLayer != 0 || rects[r].layerCount == 0 || !ClipToRenderArea(*instance, rects[r].rect, &clear.rect)) continue;
+            AddRasterClear(instance, clear);
+        }
+    }
+}
+
+// Shades the vertices of a draw and bins its triangles, for the tiles to render at the end of the subpass
+static void RasterizeDraw(ExecutionContext* context, bool indexed, uint32_t count, uint32_t instance_count, uint32_t first,
+                          int32_t vertex_offset, uint32_t first_instance, uint32_t draw_index) {
+    RenderPassInstance* instance = context->render_pass.get();
+    const DrawState& state = context->draw;
+    const RasterPipeline* pipeline = state.pipeline.get();
+    const uint64_t vertex_count = (uint64_t)count * instance_count;
+    if (!instance || !pipeline || pipeline->discard || vertex_count == 0 || vertex_count > RASTER_MAX_VERTICES) return;
+    RasterSetup setup;
+    setup.viewport = pipeline->dynamic_viewport ? state.viewport : pipeline->viewport;
+    VkRect2D scissor;
+    if (setup.viewport.width == 0.0f || setup.viewport.height == 0.0f ||
+        !ClipToRenderArea(*instance, pipeline->dynamic_scissor ? state.scissor : pipeline->scissor, &scissor)) {
+        return;
+    }
+    setup.guard[0] = std::max(1.0, 2.0 * RASTER_GUARD_BAND / std::fabs(setup.viewport.width));
+    setup.guard[1] = std::max(1.0, 2.0 * RASTER_GUARD_BAND / std::fabs(setup.viewport.height));
+    setup.bounds[0] = scissor.offset.x;
+    setup.bounds[1] = scissor.offset.y;
+    setup.bounds[2] = scissor.offset.x + (int32_t)scissor.extent.width;
+    setup.bounds[3] = scissor.offset.y + (int32_t)scissor.extent.height;
+    setup.cull_mode = pipeline->cull_mode;
+    setup.counter_clockwise = pipeline->front_face == VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    setup.depth_clamp = pipeline->depth_clamp;
+
+    // Vertex indices, with primitive restarts marked
+    std::vector<uint32_t> indices(count);
+    std::vector<bool> restarts;
+    if (indexed) {
+        const uint32_t index_size = state.index_type == VK_INDEX_TYPE_UINT16 ? 2 : state.index_type == VK_INDEX_TYPE_UINT32 ? 4 : 0;
+        const char* data = index_size ? GetBufferData(state.index_buffer, state.index_offset + (VkDeviceSize)first * index_size,
+                                                      (VkDeviceSize)count * index_size)
+                                      : nullptr;
+        if (!data) return;
+        restarts.resize(count);
+        const uint32_t restart_index = index_size == 2 ? 0xFFFF : 0xFFFFFFFF;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t index = 0;
+            memcpy(&index, data + (size_t)i * index_size, index_size);
+            restarts[i] = pipeline->primitive_restart && index == restart_index;
+            indices[i] = restarts[i] ? 0 : index + (uint32_t)vertex_offset;
+        }
+    } else {
+        for (uint32_t i = 0; i < count; ++i) indices[i] = first + i;
+    }
+
+    const uint64_t vertex_start = GetDeviceTimestamp();
+    const ShaderProgram& vertex_program = *pipeline->vertex;
+    const ShaderProgram* fragment_program = pipeline->fragment.get();
+    std::unique_ptr<RasterDraw> draw(new RasterDraw());
+    draw->pipeline = state.pipeline;
+    uint32_t position = UINT32_MAX;
+    for (const auto& entry : vertex_program.interface) {
+        if (entry.storage_class == SPIRV_STORAGE_CLASS_OUTPUT && entry.built_in == SPIRV_BUILT_IN_POSITION && entry.size >= 16) position = entry.offset;
+    }
+    if (position == UINT32_MAX) return;
+    // Fragment inputs with a location come from the vertex shader output with the same location, or are 0 without one
+    struct VaryingSource {
+        uint32_t offset;  // In the vertex invocation's memory, UINT32_MAX without an output
+        uint32_t word;
+        uint32_t words;
+    };
+    std::vector<VaryingSource> sources;
+    static const std::vector<ShaderInterface> no_interface;
+    for (const auto& entry : fragment_program ? fragment_program->interface : no_interface) {
+        if (entry.storage_class == SPIRV_STORAGE_CLASS_OUTPUT) {
+            if (entry.built_in == SPIRV_BUILT_IN_FRAG_DEPTH) draw->frag_depth = entry.offset;
+            if (entry.location != UINT32_MAX) draw->outputs.push_back({entry.offset, std::min(entry.size, 16u), entry.location});
+            continue;
+        }
+        RasterVarying varying = {entry.offset, entry.built_in, draw->vertex_size, entry.size / 4, entry.interpolation};
+        if (entry.location != UINT32_MAX) {
+            VaryingSource source = {UINT32_MAX, draw->vertex_size, varying.words};
+            for (const auto& output : vertex_program.interface) {
+                if (output.storage_class != SPIRV_STORAGE_CLASS_OUTPUT || output.location != entry.location) continue;
+                source.offset = output.offset;
+                source.words = std::min(output.size, entry.size) / 4;
+            }
+            sources.push_back(source);
+            draw->vertex_size += varying.words;
+        }
+        draw->varyings.push_back(varying);
+    }
+    draw->late_depth = fragment_program && !fragment_program->early_fragment_tests && (fragment_program->discards || draw->frag_depth != UINT32_MAX);
+    memcpy(draw->blend_constants, pipeline->dynamic_blend_constants ? state.blend_constants : pipeline->blend_constants, sizeof(draw->blend_constants));
+    draw->min_depth = std::min(setup.viewport.minDepth, setup.viewport.maxDepth);
+    draw->max_depth = std::max(setup.viewport.minDepth, setup.viewport.maxDepth);
+    if (fragment_program) {
+        std::shared_ptr<RasterBindings> bindings(new RasterBindings());
+        memcpy(bindings->push_constants, context->graphics.push_constants, sizeof(bindings->push_constants));
+        GetShaderBindings(&context->graphics, *fragment_program, &bindings->bindings);
+        bindings->bindings.regions[SHADER_PUSH_CONSTANT_REGION] = {bindings->push_constants, sizeof(bindings->push_constants)};
+        draw->regions = bindings->bindings.regions;
+        draw->textures = bindings->bindings.textures.data();
+        draw->texture_count = (uint32_t)bindings->bindings.textures.size();
+        draw->bindings = std::move(bindings);
+    }
+
+    // Vertex attributes, those outside their buffer read as 0
+    std::vector<RasterVertexInput> inputs;
+    for (const auto& attribute : pipeline->attributes) {
+        const FormatInfo* format_info = GetFormatInfo(attribute.format);
+        if (!format_info || !format_info->component_count || format_info->plane_count != 1 || format_info->block_size > MAX_CONVERTED_BLOCK_SIZE ||
+            attribute.binding >= MAX_BOUND_VERTEX_BUFFERS) {
+            continue;
+        }
+        const VkVertexInputBindingDescription* binding = nullptr;
+        for (const auto& description : pipeline->bindings) {
+            if (description.binding == attribute.binding) binding = &description;
+        }
+        const Buffer* buffer = buffer_table.Get(state.vertex_buffers[attribute.binding]);
+        const VkDeviceSize offset = state.vertex_offsets[attribute.binding];
+        if (!binding || !buffer || offset >= buffer->create_info.size) continue;
+        const VkDeviceSize size = buffer->create_info.size - offset;
+        const char* data = GetBufferData(state.vertex_buffers[attribute.binding], offset, size);
+        for (const auto& entry : vertex_program.interface) {
+            if (!data || entry.storage_class != SPIRV_STORAGE_CLASS_INPUT || entry.location != attribute.location) continue;
+            inputs.push_back({entry.offset, std::min(entry.size, 16u), format_info, data, size, attribute.offset, binding->stride,
+                              binding->inputRate == VK_VERTEX_INPUT_RATE_INSTANCE});
+        }
+    }
+    ShaderBindings vertex_bindings;
+    GetShaderBindings(&context->graphics, vertex_program, &vertex_bindings);
+    draw->vertices.resize(vertex_count * draw->vertex_size);
+    std::vector<std::unique_ptr<ShaderInvocations>> invocations(compute_pool.GetThreadCount());
+    compute_pool.Run((vertex_count + RASTER_VERTEX_BATCH - 1) / RASTER_VERTEX_BATCH, [&](uint32_t thread, uint64_t batch) {
+        if (!invocations[thread]) {
+            invocations[thread].reset(new ShaderInvocations(&vertex_program, vertex_bindings.regions, vertex_bindings.textures.data(),
+                                                            (uint32_t)vertex_bindings.textures.size()));
+        }
+        ShaderInvocations* shader = invocations[thread].get();
+        const uint64_t begin = batch * RASTER_VERTEX_BATCH;
+        const uint32_t batch_size = (uint32_t)std::min<uint64_t>(RASTER_VERTEX_BATCH, vertex_count - begin);
+        shader->Begin(batch_size);
+        for (uint32_t i = 0; i < batch_size; ++i) {
+            const uint32_t instance_index = first_instance + (uint32_t)((begin + i) / count);
+            const uint32_t vertex_index = indices[(begin + i) % count];
+            char* memory = shader->GetInvocationMemory(i);
+            for (const auto& input : inputs) {
+                VkClearColorValue value = {};
+                const VkDeviceSize address = input.attribute_offset + (VkDeviceSize)(input.per_instance ? instance_index : vertex_index) * input.stride;
+                if (address < input.data_size && input.format_info->block_size <= input.data_size - address) {
+                    DecodeTexel(*input.format_info, input.data + address, &value);
+                }
+                memcpy(memory + input.offset, &value, input.size);
+            }
+            for (const auto& entry : vertex_program.interface) {
+                uint32_t value;
+                switch (entry.storage_class == SPIRV_STORAGE_CLASS_INPUT ? entry.built_in : SPIRV_BUILT_IN_NONE) {
+                    case SPIRV_BUILT_IN_VERTEX_INDEX: value = vertex_index; break;
+                    case SPIRV_BUILT_IN_INSTANCE_INDEX: value = instance_index; break;
+                    case SPIRV_BUILT_IN_BASE_VERTEX: value = indexed ? (uint32_t)vertex_offset : first; break;
+                    case SPIRV_BUILT_IN_BASE_INSTANCE: value = first_instance; break;
+                    case SPIRV_BUILT_IN_DRAW_INDEX: value = draw_index; break;
+                    default: continue;
+                }
+                memcpy(memory + entry.offset, &value, sizeof(value));
+            }
+        }
+        shader->Run();
+        for (uint32_t i = 0; i < batch_size; ++i) {
+            const char* memory = shader->GetInvocationMemory(i);
+            uint32_t* vertex = &draw->vertices[(begin + i) * draw->vertex_size];
+            memcpy(vertex, memory + position, RASTER_POSITION_WORDS * sizeof(uint32_t));
+            for (const auto& source : sources) {
+                if (source.offset != UINT32_MAX) memcpy(vertex + source.word, memory + source.offset, source.words * sizeof(uint32_t));
+                if (source.offset == UINT32_MAX) memset(vertex + source.word, 0, source.words * sizeof(uint32_t));
+            }
+        }
+    });
+    invocations.clear();
+    const uint64_t binning_start = GetDeviceTimestamp();
+    raster_stats.vertex_ns += binning_start - vertex_start;
+
+    // Triangles in the order of the spec's primitive topologies, each starting with its provoking vertex
+    const uint32_t index = (uint32_t)instance->draws.size();
+    std::vector<uint32_t> polygon;
+    for (uint32_t instance_index = 0; instance_index < instance_count; ++instance_index) {
+        const uint32_t base = instance_index * count;
+        uint32_t start = 0;  // First vertex since the last restart
+        for (uint32_t i = 0; i < count; ++i) {
+            if (indexed && restarts[i]) {
+                start = i + 1;
+                continue;
+            }
+            const uint32_t n = i - start + 1;
+            uint32_t vertices[3];
+            if (pipeline->topology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST) {
+                if (n % 3) continue;
+                vertices[0] = i - 2, vertices[1] = i - 1, vertices[2] = i;
+            } else if (pipeline->topology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP) {
+                if (n < 3) continue;
+                vertices[0] = i - 2, vertices[1] = n % 2 ? i - 1 : i, vertices[2] = n % 2 ? i : i - 1;
+            } else {
+                if (n < 3) continue;
+                vertices[0] = i - 1, vertices[1] = i, vertices[2] = start;
+            }
+            for (uint32_t v = 0; v < 3; ++v) vertices[v] += base;
+            AddRasterTriangle(instance, draw.get(), index, setup, vertices, &polygon);
+        }
+    }
+    instance->draws.push_back(std::move(draw));
+    raster_stats.draws++;
+    raster_stats.binning_ns += GetDeviceTimestamp() - binning_start;
+}
+
+static void RasterizeIndirectDraws(ExecutionContext* context, bool indexed, VkBuffer buffer, VkDeviceSize offset, uint32_t draw_count,
+                                   uint32_t stride, VkBuffer count_buffer, VkDeviceSize count_offset) {
+    if (!context->render_pass || !context->draw.pipeline) return;
+    if (count_buffer != VK_NULL_HANDLE) {
+        const char* data = GetBufferData(count_buffer, count_offset, sizeof(uint32_t));
+        if (!data) return;
+        uint32_t count;
+        memcpy(&count, data, sizeof(count));
+        draw_count = std::min(draw_count, count);
+    }
+    for (uint32_t i = 0; i < draw_count; ++i) {
+        if (indexed) {
+            VkDrawIndexedIndirectCommand command;
+            const char* data = GetBufferData(buffer, offset + (VkDeviceSize)i * stride, sizeof(command));
+            if (!data) return;
+            memcpy(&command, data, sizeof(command));
+            RasterizeDraw(context, true, command.indexCount, command.instanceCount, command.firstIndex, command.vertexOffset, command.firstInstance, i);
+        } else {
+            VkDrawIndirectCommand command;
+            const char* data = GetBufferData(buffer, offset + (VkDeviceSize)i * stride, sizeof(command));
+            if (!data) return;
+            memcpy(&command, data, sizeof(command));
+            RasterizeDraw(context, false, command.vertexCount, command.instanceCount, command.firstVertex, 0, command.firstInstance, i);
+        }
+    }
+}
+
+static void ExecuteNextSubpass(ExecutionContext* context) {
+    RenderPassInstance* instance = context->render_pass.get();
+    if (!instance) return;
+    RenderTiles(instance);
+    if (instance->subpass + 1 < instance->render_pass.subpasses.size()) instance->subpass++;
+}
+
+static void ExecuteEndRenderPass(ExecutionContext* context) {
+    if (!context->render_pass) return;
+    RenderTiles(context->render_pass.get());
+    context->render_pass.reset();
+}
+
+// Minimum simulated execution time of every batch of command buffers, in microseconds from VK_MOCK_SUBMIT_DELAY_US
+static std::chrono::microseconds GetSubmitDelay() {
+    static const std::chrono::microseconds delay(getenv("VK_MOCK_SUBMIT_DELAY_US") ? strtoull(getenv("VK_MOCK_SUBMIT_DELAY_US"), nullptr, 10) : 0);
+    return delay;
+}
+
+// Presented frames can be written out, to see what an application renders without a display. When
+// VK_MOCK_PRESENT_FILE is set, each frame goes to a file named by it with %u replaced by the frame number, as a binary
+// PPM image when the name ends in .ppm and as raw texels otherwise. When VK_MOCK_PRESENT_SHM names a shared memory
+// object, frames go to a ring in it for viewers to read the latest ones from. The queue executing a present copies the
+// image into a frame and a writer thread writes it out. Presents wait for the writer once it falls PRESENT_QUEUE_DEPTH
+// frames behind, so no frame is lost. Frames are numbered from 0 in the order their presents execute.
+static const uint32_t PRESENT_QUEUE_DEPTH = 3;
+static const char PRESENT_RING_MAGIC[8] = {'V', 'K', 'M', 'O', 'C', 'K', 'F', 'R'};
+static const uint32_t PRESENT_RING_VERSION = 1;
+static const uint32_t PRESENT_RING_SLOT_COUNT = 3;
+
+// The ring starts with a PresentRingHeader followed at slots_offset by slot_count slots slot_stride bytes apart, each a
+// PresentRingSlot followed by up to slot_size bytes of texels, rows of row_pitch bytes. The ring is created when the
+// first frame is presented and slot_size is the size of that frame, larger frames are dropped. Frame n goes to slot
+// n % slot_count. A slot's sequence is 0 while it is written and n + 1 once it holds frame n, so readers copy a slot
+// and then check its sequence is unchanged.
+struct PresentRingHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t slot_count;
+    uint64_t slots_offset;
+    uint64_t slot_stride;
+    uint64_t slot_size;
+    std::atomic<uint64_t> frames;   // Frames written to the ring
+    std::atomic<uint64_t> dropped;  // Frames too large for a slot
+};
+
+struct PresentRingSlot {
+    std::atomic<uint64_t> sequence;
+    uint32_t format;  // VkFormat
+    uint32_t width;
+    uint32_t height;
+    uint32_t row_pitch;
+    uint64_t size;
+};
+
+struct PresentFrame {
+    uint64_t number;
+    VkFormat format;
+    VkExtent2D extent;
+    std::vector<char> texels;
+};
+
+static void PresentWriter();
+
+struct PresentSink {
+    PresentSink() {
+        const char* pattern = getenv("VK_MOCK_PRESENT_FILE");
+        if (pattern && *pattern && IsFramePattern(pattern)) file_pattern = pattern;
+#if defined(__linux__) || defined(__APPLE__)
+        const char* name = getenv("VK_MOCK_PRESENT_SHM");
+        if (name && *name) shm_name = name[0] == '/' ? name : std::string("/") + name;
+#endif
+        enabled = !file_pattern.empty() || !shm_name.empty();
+    }
+    // Writes out the frames still queued, before the ring goes away
+    ~PresentSink() {
+        if (!enabled) return;
+        {
+            lock_guard_t lock(this->lock);
+            stopping = true;
+        }
+        work_cv.notify_all();
+        if (writer.joinable()) writer.join();
+#if defined(__linux__) || defined(__APPLE__)
+        if (ring) {
+            munmap(ring, ring_size);
+            shm_unlink(shm_name.c_str());
+        }
+#endif
+    }
+    // The pattern is used as a printf format, so it may only convert the frame number
+    static bool IsFramePattern(const char* pattern) {
+        uint32_t conversions = 0;
+        for (const char* c = pattern; *c; ++c) {
+            if (*c != '%') continue;
+            if (*++c == '%') continue;
+            while (isdigit((unsigned char)*c)) ++c;
+            if (*c != 'u' || ++conversions > 1) return false;
+        }
+        return true;
+    }
+    bool enabled = false;
+    std::string file_pattern;
+    std::string shm_name;
+    PresentRingHeader* ring = nullptr;  // Only used by the writer thread
+    size_t ring_size = 0;
+    mutex_t lock;  // Guards everything below
+    std::condition_variable work_cv;
+    std::condition_variable space_cv;
+    std::deque<PresentFrame> frames;
+    std::vector<std::vector<char>> spare_texels;  // Buffers of frames written out, for reuse
+    uint32_t frames_in_flight = 0;                // Frames being copied, queued or written
+    uint64_t frame_count = 0;
+    bool stopping = false;
+    std::thread writer;
+};
+static PresentSink present_sink;
+
+static void WritePresentFile(const PresentFrame& frame) {
+    std::vector<char> path(present_sink.file_pattern.size() + 24);
+    snprintf(path.data(), path.size(), present_sink.file_pattern.c_str(), (unsigned)frame.number);
+    FILE* file = fopen(path.data(), "wb");
+    if (!file) return;
+    const size_t length = strlen(path.data());
+    if (length >= 4 && strcmp(path.data() + length - 4, ".ppm") == 0) {
+        // Swapchain images have four 8-bit channels, written out without alpha
+        const bool bgra = frame.format == VK_FORMAT_B8G8R8A8_UNORM || frame.format == VK_FORMAT_B8G8R8A8_SRGB;
+        std::vector<char> row(frame.extent.width * 3);
+        fprintf(file, "P6\n%u %u\n255\n", frame.extent.width, frame.extent.height);
+        for (uint32_t y = 0; y < frame.extent.height; ++y) {
+            const char* texel = frame.texels.data() + (size_t)y * frame.extent.width * 4;
+            for (uint32_t x = 0; x < frame.extent.width; ++x, texel += 4) {
+                row[x * 3 + 0] = texel[bgra ? 2 : 0];
+                row[x * 3 + 1] = texel[1];
+                row[x * 3 + 2] = texel[bgra ? 0 : 2];
+            }
+            fwrite(row.data(), 1, row.size(), file);
+        }
+    } else {
+        fwrite(frame.texels.data(), 1, frame.texels.size(), file);
+    }
+    fclose(file);
+}
+
+static PresentRingHeader* CreatePresentRing(uint64_t slot_size) {
+#if defined(__linux__) || defined(__APPLE__)
+    const uint64_t slot_stride = (sizeof(PresentRingSlot) + slot_size + 63) & ~uint64_t(63);
+    const uint64_t slots_offset = (sizeof(PresentRingHeader) + 63) & ~uint64_t(63);
+    const size_t size = (size_t)(slots_offset + PRESENT_RING_SLOT_COUNT * slot_stride);
+    const int fd = shm_open(present_sink.shm_name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) return nullptr;
+    void* data = MAP_FAILED;
+    if (ftruncate(fd, 0) == 0 && ftruncate(fd, size) == 0) data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        shm_unlink(present_sink.shm_name.c_str());
+        return nullptr;
+    }
+    auto ring = static_cast<PresentRingHeader*>(data);
+    ring->version = PRESENT_RING_VERSION;
+    ring->slot_count = PRESENT_RING_SLOT_COUNT;
+    ring->slots_offset = slots_offset;
+    ring->slot_stride = slot_stride;
+    ring->slot_size = slot_size;
+    present_sink.ring_size = size;
+    // Readers check the magic last, once everything else is in place
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(ring->magic, PRESENT_RING_MAGIC, sizeof(PRESENT_RING_MAGIC));
+    return ring;
+#else
+    return nullptr;
+#endif
+}
+
+static void WritePresentRing(const PresentFrame& frame) {
+    if (!present_sink.ring && !(present_sink.ring = CreatePresentRing(frame.texels.size()))) return;
+    PresentRingHeader* ring = present_sink.ring;
+    if (frame.texels.size() > ring->slot_size) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const uint64_t slot_index = ring->frames.load(std::memory_order_relaxed) % ring->slot_count;
+    auto slot = reinterpret_cast<PresentRingSlot*>(reinterpret_cast<char*>(ring) + ring->slots_offset + slot_index * ring->slot_stride);
+    slot->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->format = frame.format;
+    slot->width = frame.extent.width;
+    slot->height = frame.extent.height;
+    slot->row_pitch = frame.extent.width * 4;
+    slot->size = frame.texels.size();
+    memcpy(reinterpret_cast<char*>(slot + 1), frame.texels.data(), frame.texels.size());
+    slot->sequence.store(frame.number + 1, std::memory_order_release);
+    ring->frames.fetch_add(1, std::memory_order_release);
+}
+
+static void PresentWriter() {
+    unique_lock_t lock(present_sink.lock);
+    for (;;) {
+        present_sink.work_cv.wait(lock, [] { return present_sink.stopping || !present_sink.frames.empty(); });
+        if (present_sink.frames.empty()) break;
+        PresentFrame frame = std::move(present_sink.frames.front());
+        present_sink.frames.pop_front();
+        lock.unlock();
+        if (!present_sink.file_pattern.empty()) WritePresentFile(frame);
+        if (!present_sink.shm_name.empty()) WritePresentRing(frame);
+        lock.lock();
+        present_sink.spare_texels.push_back(std::move(frame.texels));
+        present_sink.frames_in_flight--;
+        present_sink.space_cv.notify_all();
+    }
+}
+
+// Copies a presented image into a frame for the writer thread. Surfaces only report formats with four 8-bit
+// channels, frames keep the image's rows without their padding.
+static void SendPresentedFrame(VkFormat format, VkExtent2D extent, const void* texels, size_t row_pitch) {
+    unique_lock_t lock(present_sink.lock);
+    present_sink.space_cv.wait(lock, [] { return present_sink.stopping || present_sink.frames_in_flight < PRESENT_QUEUE_DEPTH; });
+    if (present_sink.stopping) return;
+    present_sink.frames_in_flight++;
+    PresentFrame frame;
+    frame.format = format;
+    frame.extent = extent;
+    if (!present_sink.spare_texels.empty()) {
+        frame.texels = std::move(present_sink.spare_texels.back());
+        present_sink.spare_texels.pop_back();
+    }
+    lock.unlock();
+    const size_t row_size = (size_t)extent.width * 4;
+    frame.texels.resize(row_size * extent.height);
+    for (uint32_t y = 0; y < extent.height; ++y) {
+        memcpy(&frame.texels[y * row_size], static_cast<const char*>(texels) + y * row_pitch, row_size);
+    }
+    lock.lock();
+    frame.number = present_sink.frame_count++;
+    present_sink.frames.push_back(std::move(frame));
+    if (!present_sink.writer.joinable() && !present_sink.stopping) present_sink.writer = std::thread(PresentWriter);
+    lock.unlock();
+    present_sink.work_cv.notify_one();
+}
+
+// Swapchains rotate their images through a simulated presentation engine that flips on the vblanks of a
+// display refreshing VK_MOCK_REFRESH_HZ times a second (default 60). The image on screen stays there until
+// a flip replaces it, and only then becomes available to acquire again. FIFO modes flip to the oldest
+// queued image on each vblank, MAILBOX to the newest one with the images it replaced released unshown, and
+// IMMEDIATE flips as soon as the present executes. FIFO_RELAXED flips right away when the image is late,
+// that is when the last vblank passed without a flip. Shared modes have a single image that stays acquired.
+// Nothing ticks the vblank clock: a swapchain catches up with the vblanks that passed whenever it is looked at.
+// Swapchain state is guarded by the sync_lock of the swapchain's device.
+struct QueuedPresent {
+    uint32_t image_index;
+    uint64_t first_vblank;  // The image cannot be shown before this vblank
+};
+
+struct Swapchain {
+    VkPresentModeKHR present_mode = VK_PRESENT_MODE_FIFO_KHR;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkExtent2D extent = {0, 0};
+    std::vector<VkImage> images;
+    std::vector<void*> image_data;      // Backing store of each image, laid out like any other image
+    size_t image_size = 0;
+    size_t row_pitch = 0;
+    std::deque<uint32_t> available;     // Images that can be acquired, in the order they became available
+    std::deque<QueuedPresent> queued;   // Presented images waiting for a flip
+    uint32_t displayed = UINT32_MAX;    // Image on screen
+    uint64_t displayed_vblank = 0;      // Vblank the image on screen was shown at
+    uint64_t vblank = 0;                // Last vblank the swapchain has caught up with
+    bool retired = false;               // Replaced by a newer swapchain
+    uint32_t pending_presents = 0;      // Presents the queues have not executed yet, which still read the images
+    bool destroyed = false;             // Destroyed by the application, the last pending present frees it
+};
+
+static ObjectTable<Swapchain> swapchain_table(STATS_OBJECT_VkSwapchainKHR);
+
+static std::chrono::nanoseconds GetRefreshPeriod() {
+    static const double refresh_rate = getenv("VK_MOCK_REFRESH_HZ") ? strtod(getenv("VK_MOCK_REFRESH_HZ"), nullptr) : 60.0;
+    static const std::chrono::nanoseconds period((int64_t)(1e9 / (refresh_rate > 0.0 ? refresh_rate : 60.0)));
+    return period;
+}
+
+// Vblanks are numbered from the epoch of the steady clock, so all swapchains share one display
+static uint64_t GetVblank(std::chrono::steady_clock::time_point time) {
+    return (uint64_t)(time.time_since_epoch() / GetRefreshPeriod());
+}
+
+static std::chrono::steady_clock::time_point GetVblankTime(uint64_t vblank) {
+    return std::chrono::steady_clock::time_point(GetRefreshPeriod() * (int64_t)vblank);
+}
+
+static void DestroySwapchainImages(Swapchain* swapchain) {
+    for (auto image : swapchain->images) image_table.Destroy(image);
+    for (auto data : swapchain->image_data) ReleaseBackingPages(data, std::max<size_t>(swapchain->image_size, 1));
+    swapchain->images.clear();
+    swapchain->image_data.clear();
+}
+
+static bool IsSharedPresentMode(VkPresentModeKHR present_mode) {
+    return present_mode == VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR || present_mode == VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR;
+}
+
+static void ShowSwapchainImage(Swapchain* swapchain, uint32_t image_index, uint64_t vblank) {
+    if (swapchain->displayed != UINT32_MAX) swapchain->available.push_back(swapchain->displayed);
+    swapchain->displayed = image_index;
+    swapchain->displayed_vblank = vblank;
+}
+
+// Flips to the queued images whose vblanks have passed, at most one per vblank
+static void UpdateSwapchain(Swapchain* swapchain) {
+    const uint64_t now = GetVblank(std::chrono::steady_clock::now());
+    while (!swapchain->queued.empty()) {
+        const QueuedPresent& next = swapchain->queued.front();
+        const uint64_t vblank = std::max(swapchain->vblank + 1, next.first_vblank);
+        if (vblank > now) break;
+        ShowSwapchainImage(swapchain, next.image_index, vblank);
+        swapchain->queued.pop_front();
+        swapchain->vblank = vblank;
+    }
+    swapchain->vblank = std::max(swapchain->vblank, now);
+}
+
+// Takes the next available image, or returns false and when the next flip makes one available
+static bool AcquireSwapchainImage(Swapchain* swapchain, uint32_t* image_index, std::chrono::steady_clock::time_point* next_flip) {
+    UpdateSwapchain(swapchain);
+    if (swapchain->available.empty()) {
+        *next_flip = swapchain->queued.empty() ? std::chrono::steady_clock::time_point::max()
+                                               : GetVblankTime(std::max(swapchain->vblank + 1, swapchain->queued.front().first_vblank));
+        return false;
+    }
+    *image_index = swapchain->available.front();
+    swapchain->available.pop_front();
+    return true;
+}
+
+// Hands a presented image to the presentation engine once the present's semaphore waits are done
+static void PresentSwapchainImage(Device* device, VkSwapchainKHR handle, uint32_t image_index) {
+    LogRasterFrame();
+    unique_lock_t lock(device->sync_lock);
+    Swapchain* swapchain = swapchain_table.Get(handle);
+    if (!swapchain) return;
+    if (present_sink.enabled && !swapchain->destroyed) {
+        // The image does not change until the presentation engine releases it, and the pending present keeps the
+        // swapchain alive, so it is copied without the lock
+        lock.unlock();
+        SendPresentedFrame(swapchain->format, swapchain->extent, swapchain->image_data[image_index], swapchain->row_pitch);
+        lock.lock();
+    }
+    swapchain->pending_presents--;
+    if (swapchain->destroyed) {
+        if (!swapchain->pending_presents) {
+            DestroySwapchainImages(swapchain);
+            swapchain_table.Destroy(handle);
+        }
+        return;
+    }
+    UpdateSwapchain(swapchain);
+    const uint64_t vblank = swapchain->vblank;
+    switch (swapchain->present_mode) {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:
+            ShowSwapchainImage(swapchain, image_index, vblank);
+            break;
+        case VK_PRESENT_MODE_MAILBOX_KHR:
+            for (const auto& replaced : swapchain->queued) swapchain->available.push_back(replaced.image_index);
+            swapchain->queued.clear();
+            swapchain->queued.push_back({image_index, vblank + 1});
+            break;
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+            if (swapchain->queued.empty() && swapchain->displayed_vblank < vblank) {
+                ShowSwapchainImage(swapchain, image_index, vblank);
+                break;
+            }
+            swapchain->queued.push_back({image_index, vblank + 1});
+            break;
+        case VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR:
+        case VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR:
+            // The shared image is never given back
+            break;
+        default:
+            swapchain->queued.push_back({image_index, vblank + 1});
+            break;
+    }
+}
+
+static void ExecuteSubmission(Queue* queue, const Submission& submission) {
+    for (const auto& wait : submission.waits) {
+        Semaphore* semaphore = wait.first;
+        const uint64_t value = wait.second;
+        WaitForSyncObjects(queue->device, [&] { return semaphore->value.load() >= value || queue->stopping.load(); },
+                           std::chrono::steady_clock::time_point::max());
+    }
+    if (!submission.command_buffers.empty()) {
+        ExecutionContext context;
+        context.start_time = GetDeviceTimestamp();
+        for (auto command_buffer : submission.command_buffers) ExecuteCommandBuffer(command_buffer, &context);
+        // The batch takes as long as the cost model says, or the submit delay if that is longer
+        const uint64_t duration = std::max<uint64_t>(context.elapsed, std::chrono::duration_cast<std::chrono::nanoseconds>(GetSubmitDelay()).count());
+        const uint64_t now = GetDeviceTimestamp();
+        if (context.start_time + duration > now) std::this_thread::sleep_for(std::chrono::nanoseconds(context.start_time + duration - now));
+    }
+    for (const auto& present : submission.presents) PresentSwapchainImage(queue->device, present.first, present.second);
+    for (const auto& signal : submission.signals) signal.first->value = signal.second;
+    if (submission.fence) submission.fence->signaled = true;
+    // Also wakes hosts waiting on query results, which may have become available
+    queue->device->pending_submissions.fetch_sub(1);
+    SignalSyncObjects(queue->device);
+}
+
+static void QueueWorker(Queue* queue) {
+    unique_lock_t lock(queue->lock);
+    for (;;) {
+        queue->work_cv.wait(lock, [queue] { return queue->stopping.load() || !queue->submissions.empty(); });
+        if (queue->submissions.empty()) break;
+        Submission submission = std::move(queue->submissions.front());
+        queue->submissions.pop_front();
+        lock.unlock();
+        ExecuteSubmission(queue, submission);
+        lock.lock();
+        queue->completed++;
+        queue->idle_cv.notify_all();
+    }
+}
+
+static Queue* CreateQueue(Device* device) {
+    auto queue = new Queue();
+    set_loader_magic_value(&queue->loader_data);
+    queue->device = device;
+    queue->worker = std::thread(QueueWorker, queue);
+    return queue;
+}
+
+static void DestroyQueue(Queue* queue) {
+    {
+        lock_guard_t lock(queue->lock);
+        queue->stopping = true;
+    }
+    queue->work_cv.notify_all();
+    // Releases the worker if it is stuck on a semaphore that will never be signalled
+    SignalSyncObjects(queue->device);
+    queue->worker.join();
+    delete queue;
+}
+
+static void EnqueueSubmissions(Queue* queue, std::vector<Submission>& submissions) {
+    if (submissions.empty()) return;
+    lock_guard_t lock(queue->lock);
+    for (auto& submission : submissions) queue->submissions.push_back(std::move(submission));
+    queue->submitted += submissions.size();
+    queue->device->pending_submissions.fetch_add(submissions.size());
+    queue->work_cv.notify_one();
+}
+
+static void WaitQueueIdle(Queue* queue) {
+    unique_lock_t lock(queue->lock);
+    queue->idle_cv.wait(lock, [queue] { return queue->completed == queue->submitted; });
+}
+
+static Fence* GetFence(VkFence fence) {
+    return fence_table.Get(fence);
+}
+
+static Semaphore* GetSemaphore(VkSemaphore semaphore) {
+    return semaphore_table.Get(semaphore);
+}
+
+// Acquires a swapchain image for vkAcquireNextImageKHR and vkAcquireNextImage2KHR
+static VkResult AcquireNextImage(Device* device, VkSwapchainKHR swapchain, uint64_t timeout, VkSemaphore semaphore, VkFence fence,
+                                 uint32_t* pImageIndex) {
+    const auto deadline = GetSyncDeadline(timeout);
+    unique_lock_t lock(device->sync_lock);
+    // Stale handles, and swapchains destroyed while presents were pending, are out of date
+    Swapchain* acquire_swapchain = swapchain_table.Get(swapchain);
+    if (!acquire_swapchain || acquire_swapchain->destroyed || acquire_swapchain->retired) return VK_ERROR_OUT_OF_DATE_KHR;
+    if (IsSharedPresentMode(acquire_swapchain->present_mode)) {
+        *pImageIndex = 0;
+    } else {
+        // Flips happen on the vblank clock without waking anyone, so wait until the next flip at most. Presents
+        // do wake waiters, and when one queues an image the wait starts over to wait for its flip instead.
+        auto next_flip = std::chrono::steady_clock::now();
+        bool acquired = false;
+        bool out_of_date = false;
+        lock.unlock();
+        for (;;) {
+            const auto wait_deadline = std::min(deadline, next_flip);
+            WaitForSyncObjects(device, [&] {
+                lock_guard_t acquire_lock(device->sync_lock);
+                // The swapchain is looked up again on every wake, as the last pending present may have freed it
+                acquire_swapchain = swapchain_table.Get(swapchain);
+                out_of_date = !acquire_swapchain || acquire_swapchain->destroyed;
+                if (out_of_date) return true;
+                acquired = AcquireSwapchainImage(acquire_swapchain, pImageIndex, &next_flip);
+                return acquired || next_flip < wait_deadline;
+            }, wait_deadline);
+            if (out_of_date) return VK_ERROR_OUT_OF_DATE_KHR;
+            if (acquired) break;
+            if (std::chrono::steady_clock::now() >= deadline) return timeout ? VK_TIMEOUT : VK_NOT_READY;
+        }
+        lock.lock();
+    }
+    // The image is available once it is acquired, signal the semaphore and fence from the host
+    Semaphore* acquire_semaphore = GetSemaphore(semaphore);
+    if (acquire_semaphore) acquire_semaphore->value = ++acquire_semaphore->signals_submitted;
+    Fence* acquire_fence = GetFence(fence);
+    if (acquire_fence) acquire_fence->signaled = true;
+    lock.unlock();
+    SignalSyncObjects(device);
+    return VK_SUCCESS;
+}
+
+// The following helpers must be called with the sync_lock of the semaphores' device held
+// timeline_value is ignored for binary semaphores
+static void AddSemaphoreWait(Submission* submission, VkSemaphore handle, uint64_t timeline_value) {
+    Semaphore* semaphore = GetSemaphore(handle);
+    if (!semaphore) return;
+    if (semaphore->type == VK_SEMAPHORE_TYPE_TIMELINE) {
+        // Timeline waits may be submitted before their signal, the worker simply blocks until it arrives
+        submission->waits.push_back(std::make_pair(semaphore, timeline_value));
+    } else if (semaphore->waits_submitted < semaphore->signals_submitted) {
+        // Waiting on a binary semaphore with no signal pending is invalid, skip it rather than stall the queue forever
+        submission->waits.push_back(std::make_pair(semaphore, ++semaphore->waits_submitted));
+    }
+}
 
-// Map device memory handle to any mapped allocations that we'll need to free on unmap
-static unordered_map<VkDeviceMemory, std::vector<void*>> mapped_memory_map;
+static void AddSemaphoreSignal(Submission* submission, VkSemaphore handle, uint64_t timeline_value) {
+    Semaphore* semaphore = GetSemaphore(handle);
+    if (!semaphore) return;
+    if (semaphore->type == VK_SEMAPHORE_TYPE_TIMELINE) {
+        submission->signals.push_back(std::make_pair(semaphore, timeline_value));
+    } else {
+        submission->signals.push_back(std::make_pair(semaphore, ++semaphore->signals_submitted));
+    }
+}
 
-static VkPhysicalDevice physical_device = nullptr;
-static unordered_map<VkDevice, unordered_map<uint32_t, unordered_map<uint32_t, VkQueue>>> queue_map;
-static unordered_map<VkDevice, unordered_map<VkBuffer, VkBufferCreateInfo>> buffer_map;
+// Values for the semaphores of a VkSubmitInfo or VkBindSparseInfo, zero when none are chained
+static uint64_t GetTimelineWaitValue(const VkTimelineSemaphoreSubmitInfo* timeline_info, uint32_t index) {
+    return (timeline_info && timeline_info->pWaitSemaphoreValues && index < timeline_info->waitSemaphoreValueCount) ? timeline_info->pWaitSemaphoreValues[index] : 0;
+}
+static uint64_t GetTimelineSignalValue(const VkTimelineSemaphoreSubmitInfo* timeline_info, uint32_t index) {
+    return (timeline_info && timeline_info->pSignalSemaphoreValues && index < timeline_info->signalSemaphoreValueCount) ? timeline_info->pSignalSemaphoreValues[index] : 0;
+}
 
 // TODO: Would like to codegen this but limits aren't in XML
 static VkPhysicalDeviceLimits SetLimits(VkPhysicalDeviceLimits *limits) {
@@ -152,16 +3851,630 @@ static VkPhysicalDeviceLimits SetLimits(VkPhysicalDeviceLimits *limits) {
     limits->optimalBufferCopyRowPitchAlignment = 1;
     limits->nonCoherentAtomSize = 256;
 
-    return *limits;
+    return *limits;
+}
+
+void SetBoolArrayTrue(VkBool32* bool_array, uint32_t num_bools)
+{
+    for (uint32_t i = 0; i < num_bools; ++i) {
+        bool_array[i] = VK_TRUE;
+    }
+}
+
+static uint64_t GetJsonUint(const JsonValue* value, uint64_t default_value) {
+    if (!value) return default_value;
+    if (value->type == JsonValue::BOOLEAN) return value->boolean ? 1 : 0;
+    if (value->type != JsonValue::NUMBER) return default_value;
+    return value->exact ? value->integer : (uint64_t)(int64_t)value->number;
+}
+
+static void SetProfileField(void* base, const ProfileField& field, uint32_t element, const JsonValue& value) {
+    char* data = static_cast<char*>(base) + field.offset;
+    switch (field.type) {
+        case PROFILE_FIELD_UINT32:
+            reinterpret_cast<uint32_t*>(data)[element] = (uint32_t)GetJsonUint(&value, 0);
+            break;
+        case PROFILE_FIELD_INT32:
+            reinterpret_cast<int32_t*>(data)[element] = (int32_t)value.number;
+            break;
+        case PROFILE_FIELD_UINT64:
+            reinterpret_cast<uint64_t*>(data)[element] = GetJsonUint(&value, 0);
+            break;
+        case PROFILE_FIELD_SIZE:
+            reinterpret_cast<size_t*>(data)[element] = (size_t)GetJsonUint(&value, 0);
+            break;
+        case PROFILE_FIELD_FLOAT:
+            reinterpret_cast<float*>(data)[element] = (float)value.number;
+            break;
+    }
+}
+
+// Sets the members of base named in object, members the profile leaves out keep their defaults
+template <size_t FIELD_COUNT>
+static void ApplyProfileFields(void* base, const ProfileField (&fields)[FIELD_COUNT], const JsonValue* object) {
+    if (!object) return;
+    for (const auto& field : fields) {
+        const JsonValue* value = object->Find(field.name);
+        if (!value) continue;
+        if (value->type == JsonValue::ARRAY) {
+            for (uint32_t i = 0; i < field.count && i < value->elements.size(); ++i) SetProfileField(base, field, i, value->elements[i]);
+        } else {
+            SetProfileField(base, field, 0, *value);
+        }
+    }
+}
+
+static void SetDefaultDeviceProfile(DeviceProfile* profile) {
+    VkPhysicalDeviceProperties& properties = profile->properties;
+    properties.apiVersion = VK_API_VERSION_1_0;
+    properties.driverVersion = 1;
+    properties.vendorID = MOCK_VENDOR_ID;
+    properties.deviceID = MOCK_DEVICE_ID;
+    properties.deviceType = VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU;
+    strcpy(properties.deviceName, "Vulkan Mock Device");
+    memcpy(properties.pipelineCacheUUID, PIPELINE_CACHE_UUID, VK_UUID_SIZE);
+    SetLimits(&properties.limits);
+    properties.sparseProperties = { VK_TRUE, VK_TRUE, VK_TRUE, VK_TRUE, VK_TRUE };
+
+    SetBoolArrayTrue(&profile->features.robustBufferAccess, sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32));
+
+    VkPhysicalDeviceMemoryProperties& memory_properties = profile->memory_properties;
+    memory_properties.memoryTypeCount = 2;
+    memory_properties.memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    memory_properties.memoryTypes[0].heapIndex = 0;
+    memory_properties.memoryTypes[1].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    memory_properties.memoryTypes[1].heapIndex = 1;
+    memory_properties.memoryHeapCount = 2;
+    memory_properties.memoryHeaps[0].flags = 0;
+    memory_properties.memoryHeaps[0].size = 8000000000;
+    memory_properties.memoryHeaps[1].flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+    memory_properties.memoryHeaps[1].size = 8000000000;
+
+    profile->queue_family_count = 1;
+    profile->queue_families[0].queueFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT | VK_QUEUE_SPARSE_BINDING_BIT;
+    profile->queue_families[0].queueCount = 1;
+    profile->queue_families[0].timestampValidBits = 64;
+    profile->queue_families[0].minImageTransferGranularity = {1,1,1};
+
+    // TODO: Just returning full support for everything initially
+    for (auto& format_properties : profile->format_properties) format_properties = { 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF };
+    profile->format_properties[GetFormatIndex(VK_FORMAT_UNDEFINED)] = { 0x0, 0x0, 0x0 };
+}
+
+// Reads a profile in the format of vulkaninfo --json on top of the defaults. Only formats the profile
+// lists are supported, everything else it leaves out keeps its default.
+static bool LoadDeviceProfile(const char* path, DeviceProfile* profile) {
+    JsonValue root;
+    if (!ParseJsonFile(path, &root) || root.type != JsonValue::OBJECT) return false;
+
+    if (const JsonValue* properties = root.Find("VkPhysicalDeviceProperties")) {
+        VkPhysicalDeviceProperties& device_properties = profile->properties;
+        device_properties.apiVersion = (uint32_t)GetJsonUint(properties->Find("apiVersion"), device_properties.apiVersion);
+        device_properties.driverVersion = (uint32_t)GetJsonUint(properties->Find("driverVersion"), device_properties.driverVersion);
+        device_properties.vendorID = (uint32_t)GetJsonUint(properties->Find("vendorID"), device_properties.vendorID);
+        device_properties.deviceID = (uint32_t)GetJsonUint(properties->Find("deviceID"), device_properties.deviceID);
+        device_properties.deviceType = (VkPhysicalDeviceType)GetJsonUint(properties->Find("deviceType"), device_properties.deviceType);
+        const JsonValue* name = properties->Find("deviceName");
+        if (name && name->type == JsonValue::STRING) {
+            strncpy(device_properties.deviceName, name->string.c_str(), VK_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1);
+            device_properties.deviceName[VK_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1] = '\0';
+        }
+        const JsonValue* uuid = properties->Find("pipelineCacheUUID");
+        if (uuid && uuid->type == JsonValue::ARRAY && uuid->elements.size() == VK_UUID_SIZE) {
+            for (uint32_t i = 0; i < VK_UUID_SIZE; ++i) device_properties.pipelineCacheUUID[i] = (uint8_t)GetJsonUint(&uuid->elements[i], 0);
+        }
+        ApplyProfileFields(&device_properties.limits, physical_device_limits_fields, properties->Find("VkPhysicalDeviceLimits"));
+        ApplyProfileFields(&device_properties.sparseProperties, physical_device_sparse_properties_fields, properties->Find("VkPhysicalDeviceSparseProperties"));
+    }
+    ApplyProfileFields(&profile->features, physical_device_features_fields, root.Find("VkPhysicalDeviceFeatures"));
+
+    if (const JsonValue* memory = root.Find("VkPhysicalDeviceMemoryProperties")) {
+        VkPhysicalDeviceMemoryProperties& memory_properties = profile->memory_properties;
+        const JsonValue* heaps = memory->Find("memoryHeaps");
+        if (heaps && heaps->type == JsonValue::ARRAY) {
+            memory_properties.memoryHeapCount = std::min<uint32_t>((uint32_t)heaps->elements.size(), VK_MAX_MEMORY_HEAPS);
+            for (uint32_t i = 0; i < memory_properties.memoryHeapCount; ++i) {
+                memory_properties.memoryHeaps[i].flags = (VkMemoryHeapFlags)GetJsonUint(heaps->elements[i].Find("flags"), 0);
+                memory_properties.memoryHeaps[i].size = GetJsonUint(heaps->elements[i].Find("size"), 0);
+            }
+        }
+        const JsonValue* types = memory->Find("memoryTypes");
+        if (types && types->type == JsonValue::ARRAY) {
+            memory_properties.memoryTypeCount = std::min<uint32_t>((uint32_t)types->elements.size(), VK_MAX_MEMORY_TYPES);
+            for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i) {
+                memory_properties.memoryTypes[i].heapIndex = (uint32_t)GetJsonUint(types->elements[i].Find("heapIndex"), 0);
+                memory_properties.memoryTypes[i].propertyFlags = (VkMemoryPropertyFlags)GetJsonUint(types->elements[i].Find("propertyFlags"), 0);
+            }
+        }
+    }
+
+    const JsonValue* queue_families = root.Find("ArrayOfVkQueueFamilyProperties");
+    if (queue_families && queue_families->type == JsonValue::ARRAY && !queue_families->elements.empty()) {
+        profile->queue_family_count = std::min<uint32_t>((uint32_t)queue_families->elements.size(), MAX_PROFILE_QUEUE_FAMILIES);
+        for (uint32_t i = 0; i < profile->queue_family_count; ++i) {
+            const JsonValue& family = queue_families->elements[i];
+            VkQueueFamilyProperties& properties = profile->queue_families[i];
+            properties.queueFlags = (VkQueueFlags)GetJsonUint(family.Find("queueFlags"), 0);
+            properties.queueCount = (uint32_t)GetJsonUint(family.Find("queueCount"), 1);
+            properties.timestampValidBits = (uint32_t)GetJsonUint(family.Find("timestampValidBits"), 0);
+            properties.minImageTransferGranularity = {1, 1, 1};
+            if (const JsonValue* granularity = family.Find("minImageTransferGranularity")) {
+                properties.minImageTransferGranularity.width = (uint32_t)GetJsonUint(granularity->Find("width"), 1);
+                properties.minImageTransferGranularity.height = (uint32_t)GetJsonUint(granularity->Find("height"), 1);
+                properties.minImageTransferGranularity.depth = (uint32_t)GetJsonUint(granularity->Find("depth"), 1);
+            }
+        }
+    }
+
+    const JsonValue* formats = root.Find("ArrayOfVkFormatProperties");
+    if (formats && formats->type == JsonValue::ARRAY) {
+        for (auto& format_properties : profile->format_properties) format_properties = { 0x0, 0x0, 0x0 };
+        for (const auto& format : formats->elements) {
+            const VkFormat id = (VkFormat)GetJsonUint(format.Find("formatID"), VK_FORMAT_UNDEFINED);
+            const uint32_t index = GetFormatIndex(id);
+            if (index == FORMAT_COUNT || id == VK_FORMAT_UNDEFINED) continue;
+            profile->format_properties[index].linearTilingFeatures = (VkFormatFeatureFlags)GetJsonUint(format.Find("linearTilingFeatures"), 0);
+            profile->format_properties[index].optimalTilingFeatures = (VkFormatFeatureFlags)GetJsonUint(format.Find("optimalTilingFeatures"), 0);
+            profile->format_properties[index].bufferFeatures = (VkFormatFeatureFlags)GetJsonUint(format.Find("bufferFeatures"), 0);
+        }
+    }
+    profile->from_file = true;
+    return true;
+}
+
+// Called by vkCreateInstance, fails if VK_MOCK_PROFILE names a profile that cannot be read. A profile is only
+// taken once it loads completely, so a failed call leaves nothing behind for the next one.
+static bool InitDeviceProfile() {
+    unique_lock_t lock(global_lock);
+    if (device_profile.loaded) return true;
+    std::unique_ptr<DeviceProfile> profile(new DeviceProfile());
+    SetDefaultDeviceProfile(profile.get());
+    const char* path = getenv("VK_MOCK_PROFILE");
+    if (path && *path && !LoadDeviceProfile(path, profile.get())) return false;
+    profile->loaded = true;
+    device_profile = *profile;
+    return true;
+}
+
+// Entrypoint tracing. When VK_MOCK_TRACE names a file, every entrypoint the application calls appends a record to a
+// ring owned by the calling thread, and a flush thread, started with the first ring and woken whenever one fills up
+// past half its size, drains the rings into the file. vkDestroyInstance flushes too. Callers never lock or wait:
+// a record that does not fit in a full ring is dropped and counted instead. The file starts with a TraceFileHeader
+// and the entrypoint names, NUL terminated and in Entrypoint order, followed by blocks of one thread's records.
+// scripts/mock_icd_trace_decoder.py prints them.
+static const char TRACE_FILE_MAGIC[8] = {'V', 'K', 'M', 'O', 'C', 'K', 'T', 'R'};
+static const uint32_t TRACE_FILE_VERSION = 1;
+static const uint64_t TRACE_RING_SIZE = 1 << 20;  // Bytes per thread, a power of two
+static const uint64_t TRACE_FLUSH_WATERMARK = TRACE_RING_SIZE / 2;  // Filling a ring past this wakes the flush thread
+
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entrypoint_count;
+};
+
+struct TraceBlockHeader {
+    uint32_t thread;   // Threads are numbered in the order they first call an entrypoint
+    uint32_t size;     // Bytes of records following the header
+    uint64_t dropped;  // Records the thread dropped since its previous block
+};
+
+// Followed by the values of the entrypoint's handle parameters
+struct TraceRecord {
+    uint64_t timestamp;  // Same clock as device timestamps
+    uint32_t entrypoint;
+    uint32_t handle_count;
+};
+
+struct TraceRing {
+    uint32_t thread = 0;
+    std::atomic<uint64_t> head{0};    // Bytes written by the owning thread
+    std::atomic<uint64_t> dropped{0};
+    char padding[64];                 // Keeps the flush thread's writes off the owning thread's cache line
+    std::atomic<uint64_t> tail{0};    // Bytes written out by the flush thread
+    std::atomic<bool> retired{false};  // The owning thread has exited, the ring is freed once drained
+    char data[TRACE_RING_SIZE];
+};
+
+static void FlushTraceRings();
+static void TraceFlusher();
+static void RequestTraceFlush();
+
+struct TraceWriter {
+    TraceWriter() {
+        const char* path = getenv("VK_MOCK_TRACE");
+        if (!path || !*path || !(file = fopen(path, "wb"))) return;
+        TraceFileHeader header = {{}, TRACE_FILE_VERSION, ENTRYPOINT_COUNT};
+        memcpy(header.magic, TRACE_FILE_MAGIC, sizeof(TRACE_FILE_MAGIC));
+        fwrite(&header, sizeof(header), 1, file);
+        for (auto name : entrypoint_names) fwrite(name, strlen(name) + 1, 1, file);
+        enabled = true;
+    }
+    // Runs when the process exits or the ICD is unloaded, after the exiting thread has retired its ring
+    ~TraceWriter() {
+        if (!enabled) return;
+        {
+            lock_guard_t lock(this->lock);
+            stopping = true;
+        }
+        RequestTraceFlush();
+        if (flusher.joinable()) flusher.join();
+        lock_guard_t lock(this->lock);
+        FlushTraceRings();
+        fclose(file);
+        file = nullptr;
+    }
+    bool enabled = false;
+    mutex_t lock;  // Guards everything below
+    FILE* file = nullptr;
+    std::vector<TraceRing*> rings;
+    uint32_t thread_count = 0;
+    bool stopping = false;
+    std::thread flusher;
+    // The flush thread sleeps until this changes, a futex on Linux
+    std::atomic<uint32_t> flush_requests{0};
+#if !defined(__linux__)
+    mutex_t flush_lock;
+    std::condition_variable flush_cv;
+#endif
+};
+static TraceWriter trace_writer;
+
+// Wakes the flush thread. Threads tracing calls only do so when their ring fills past the watermark or they exit,
+// so an idle or lightly traced application leaves the flush thread asleep.
+static void RequestTraceFlush() {
+    trace_writer.flush_requests.fetch_add(1, std::memory_order_release);
+#if defined(__linux__)
+    syscall(SYS_futex, &trace_writer.flush_requests, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+    { lock_guard_t lock(trace_writer.flush_lock); }
+    trace_writer.flush_cv.notify_one();
+#endif
+}
+
+// Writes out every ring's records, the caller holds trace_writer.lock
+static void FlushTraceRings() {
+    if (!trace_writer.file) return;
+    for (auto it = trace_writer.rings.begin(); it != trace_writer.rings.end();) {
+        TraceRing* ring = *it;
+        // Checked before reading head, so the records a retired ring ends with are not missed
+        const bool retired = ring->retired.load(std::memory_order_acquire);
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        const uint64_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+        if (head != tail || dropped) {
+            const TraceBlockHeader block = {ring->thread, (uint32_t)(head - tail), dropped};
+            const uint64_t start = tail & (TRACE_RING_SIZE - 1);
+            const uint64_t first = std::min(head - tail, TRACE_RING_SIZE - start);
+            fwrite(&block, sizeof(block), 1, trace_writer.file);
+            fwrite(ring->data + start, 1, first, trace_writer.file);
+            fwrite(ring->data, 1, head - tail - first, trace_writer.file);
+            ring->tail.store(head, std::memory_order_release);
+        }
+        if (retired) {
+            delete ring;
+            it = trace_writer.rings.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+static void TraceFlusher() {
+    for (;;) {
+        // Read before flushing, so a request made while the rings are written out is not slept through
+        const uint32_t requests = trace_writer.flush_requests.load(std::memory_order_acquire);
+        {
+            lock_guard_t lock(trace_writer.lock);
+            if (trace_writer.stopping) break;
+            FlushTraceRings();
+        }
+#if defined(__linux__)
+        syscall(SYS_futex, &trace_writer.flush_requests, FUTEX_WAIT_PRIVATE, requests, nullptr, nullptr, 0);
+#else
+        unique_lock_t lock(trace_writer.flush_lock);
+        trace_writer.flush_cv.wait(lock, [requests] { return trace_writer.flush_requests.load() != requests; });
+#endif
+    }
+}
+
+// Writes out everything traced so far, so the file is complete even if the process does not exit cleanly
+static void FlushTrace() {
+    if (!trace_writer.enabled) return;
+    lock_guard_t lock(trace_writer.lock);
+    FlushTraceRings();
+    if (trace_writer.file) fflush(trace_writer.file);
 }
 
-void SetBoolArrayTrue(VkBool32* bool_array, uint32_t num_bools)
-{
-    for (uint32_t i = 0; i < num_bools; ++i) {
-        bool_array[i] = VK_TRUE;
+static TraceRing* CreateTraceRing() {
+    auto ring = new TraceRing;
+    lock_guard_t lock(trace_writer.lock);
+    ring->thread = trace_writer.thread_count++;
+    trace_writer.rings.push_back(ring);
+    if (!trace_writer.flusher.joinable() && !trace_writer.stopping) trace_writer.flusher = std::thread(TraceFlusher);
+    return ring;
+}
+
+static void WriteTraceRing(TraceRing* ring, uint64_t position, const void* data, uint64_t size) {
+    const uint64_t start = position & (TRACE_RING_SIZE - 1);
+    const uint64_t first = std::min(size, TRACE_RING_SIZE - start);
+    memcpy(ring->data + start, data, first);
+    memcpy(ring->data, static_cast<const char*>(data) + first, size - first);
+}
+
+static void AppendTraceRecord(TraceRing* ring, Entrypoint entrypoint, const uint64_t* handles, uint32_t handle_count) {
+    const TraceRecord record = {GetDeviceTimestamp(), entrypoint, handle_count};
+    const uint64_t size = sizeof(record) + handle_count * sizeof(uint64_t);
+    const uint64_t head = ring->head.load(std::memory_order_relaxed);
+    const uint64_t tail = ring->tail.load(std::memory_order_acquire);
+    if (head + size - tail > TRACE_RING_SIZE) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    WriteTraceRing(ring, head, &record, sizeof(record));
+    WriteTraceRing(ring, head + sizeof(record), handles, size - sizeof(record));
+    ring->head.store(head + size, std::memory_order_release);
+    if (head - tail < TRACE_FLUSH_WATERMARK && head + size - tail >= TRACE_FLUSH_WATERMARK) RequestTraceFlush();
+}
+
+template <typename T>
+static uint64_t TraceHandle(T* handle) { return (uint64_t)(uintptr_t)handle; }
+static uint64_t TraceHandle(uint64_t handle) { return handle; }
+
+// Cost model. VK_MOCK_COST_MODEL names a JSON file that maps entrypoint names to the time a call takes, as
+//   "vkUpdateDescriptorSets": { "fixed_us": 2, "per_element_us": 0.25, "wait": "spin" }
+// where the elements of a call are the entries of its array parameters, such as descriptorWriteCount +
+// descriptorCopyCount. A call spins on the clock for its cost, so it shows up as CPU time in a profile like a real
+// driver's, or sleeps when "wait" is "sleep".
+struct EntrypointCost {
+    uint64_t fixed = 0;        // Nanoseconds
+    uint64_t per_element = 0;  // Nanoseconds
+    bool sleep = false;
+};
+
+struct CostModel {
+    std::atomic<bool> enabled{false};
+    bool loaded = false;
+    EntrypointCost costs[ENTRYPOINT_COUNT];
+};
+static CostModel cost_model;
+
+static bool LoadCostModel(const char* path, EntrypointCost* costs) {
+    JsonValue root;
+    if (!ParseJsonFile(path, &root) || root.type != JsonValue::OBJECT) return false;
+    for (size_t i = 0; i < root.keys.size(); ++i) {
+        // Unknown names are rejected rather than ignored, a misspelt entrypoint would silently cost nothing
+        const auto name = std::find_if(std::begin(entrypoint_names), std::end(entrypoint_names),
+                                       [&](const char* entrypoint_name) { return root.keys[i] == entrypoint_name; });
+        const JsonValue& entry = root.elements[i];
+        if (name == std::end(entrypoint_names) || entry.type != JsonValue::OBJECT) return false;
+        EntrypointCost& cost = costs[name - std::begin(entrypoint_names)];
+        const JsonValue* fixed = entry.Find("fixed_us");
+        const JsonValue* per_element = entry.Find("per_element_us");
+        const JsonValue* wait = entry.Find("wait");
+        cost.fixed = fixed ? (uint64_t)std::max(fixed->number * 1000.0, 0.0) : 0;
+        cost.per_element = per_element ? (uint64_t)std::max(per_element->number * 1000.0, 0.0) : 0;
+        cost.sleep = wait && wait->string == "sleep";
+    }
+    return true;
+}
+
+// Called by vkCreateInstance, fails if VK_MOCK_COST_MODEL names a cost model that cannot be read. Like the device
+// profile, the costs are only taken from a file that loads completely.
+static bool InitCostModel() {
+    unique_lock_t lock(global_lock);
+    if (cost_model.loaded) return true;
+    const char* path = getenv("VK_MOCK_COST_MODEL");
+    if (path && *path) {
+        std::unique_ptr<EntrypointCost[]> costs(new EntrypointCost[ENTRYPOINT_COUNT]);
+        if (!LoadCostModel(path, costs.get())) return false;
+        std::copy(costs.get(), costs.get() + ENTRYPOINT_COUNT, cost_model.costs);
+        cost_model.enabled = true;
+    }
+    cost_model.loaded = true;
+    return true;
+}
+
+static void ChargeCost(Entrypoint entrypoint, uint64_t elements) {
+    const EntrypointCost& cost = cost_model.costs[entrypoint];
+    const uint64_t duration = cost.fixed + cost.per_element * elements;
+    if (!duration) return;
+    if (cost.sleep) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(duration));
+        return;
+    }
+    const uint64_t end = GetDeviceTimestamp() + duration;
+    while (GetDeviceTimestamp() < end) {
+    }
+}
+
+
+// Live statistics. When VK_MOCK_STATS names a shared memory object, the first vkCreateInstance creates it and the
+// mock counts calls, objects, memory and descriptor pool failures in it for other processes to read while the
+// application runs, as vulkaninfo --watch-mock does. mock_icd_stats.h describes the layout. A thread owns a slot and
+// is its only writer, threads beyond the slots share the last one.
+static const uint32_t STATS_SLOT_COUNT = 64;
+
+// Counters of a slot, in this order
+enum StatsCounter : uint32_t {
+    STATS_CALLS = 0,                                                  // Per entrypoint
+    STATS_OBJECTS_CREATED = STATS_CALLS + ENTRYPOINT_COUNT,           // Per object type
+    STATS_OBJECTS_DESTROYED = STATS_OBJECTS_CREATED + STATS_OBJECT_COUNT,
+    STATS_MEMORY_ALLOCATED = STATS_OBJECTS_DESTROYED + STATS_OBJECT_COUNT,  // Bytes per heap
+    STATS_MEMORY_FREED = STATS_MEMORY_ALLOCATED + VK_MAX_MEMORY_HEAPS,
+    STATS_MEMORY_MAPPED = STATS_MEMORY_FREED + VK_MAX_MEMORY_HEAPS,    // First of the StatsTrailingCounter ones
+    STATS_MEMORY_UNMAPPED = STATS_MEMORY_MAPPED + STATS_TRAILING_MEMORY_UNMAPPED,
+    STATS_DESCRIPTOR_POOLS_EXHAUSTED = STATS_MEMORY_MAPPED + STATS_TRAILING_DESCRIPTOR_POOLS_EXHAUSTED,
+    STATS_DESCRIPTOR_POOLS_FRAGMENTED = STATS_MEMORY_MAPPED + STATS_TRAILING_DESCRIPTOR_POOLS_FRAGMENTED,
+    STATS_COUNTER_COUNT = STATS_MEMORY_MAPPED + STATS_TRAILING_COUNTER_COUNT
+};
+
+struct StatsSlot {
+    std::atomic<uint64_t> counters[STATS_COUNTER_COUNT];
+};
+static_assert(sizeof(StatsSlot) == STATS_COUNTER_COUNT * sizeof(uint64_t), "Readers see the counters as plain 64-bit integers");
+
+struct StatsWriter {
+    void Open() {
+#if defined(__linux__) || defined(__APPLE__)
+        const char* name = getenv("VK_MOCK_STATS");
+        if (!name || !*name) return;
+        shm_name = name[0] == '/' ? name : std::string("/") + name;
+        size_t names_size = 0;
+        for (auto entrypoint_name : entrypoint_names) names_size += strlen(entrypoint_name) + 1;
+        for (auto object_name : stats_object_names) names_size += strlen(object_name) + 1;
+        const size_t slots_offset = (sizeof(StatsHeader) + names_size + 63) & ~size_t(63);
+        const size_t size = slots_offset + STATS_SLOT_COUNT * sizeof(StatsSlot);
+        // A segment left under the name, by a process that crashed or still runs, is replaced rather than truncated,
+        // as truncating it would fault the process that maps it. Unlinking only removes the name, its mappings stay valid.
+        shm_unlink(shm_name.c_str());
+        const int fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) return;
+        void* data = MAP_FAILED;
+        if (ftruncate(fd, size) == 0) data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            shm_unlink(shm_name.c_str());
+            return;
+        }
+        // The segment is never unmapped, threads may still count into it while the process exits
+        header = static_cast<StatsHeader*>(data);
+        header->version = STATS_VERSION;
+        header->process_id = (uint32_t)getpid();
+        header->entrypoint_count = ENTRYPOINT_COUNT;
+        header->object_type_count = STATS_OBJECT_COUNT;
+        header->heap_count = VK_MAX_MEMORY_HEAPS;
+        header->slot_count = STATS_SLOT_COUNT;
+        header->counter_count = STATS_COUNTER_COUNT;
+        header->names_offset = sizeof(StatsHeader);
+        header->slots_offset = slots_offset;
+        char* names = static_cast<char*>(data) + sizeof(StatsHeader);
+        for (auto entrypoint_name : entrypoint_names) names = strcpy(names, entrypoint_name) + strlen(entrypoint_name) + 1;
+        for (auto object_name : stats_object_names) names = strcpy(names, object_name) + strlen(object_name) + 1;
+        slots = reinterpret_cast<StatsSlot*>(static_cast<char*>(data) + slots_offset);
+        // Readers check the magic last, once everything else is in place
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(header->magic, STATS_MAGIC, sizeof(STATS_MAGIC));
+        enabled.store(true, std::memory_order_release);
+#endif
+    }
+    ~StatsWriter() {
+#if defined(__linux__) || defined(__APPLE__)
+        if (enabled) shm_unlink(shm_name.c_str());
+#endif
+    }
+    std::atomic<bool> enabled{false};
+    std::string shm_name;
+    StatsHeader* header = nullptr;
+    StatsSlot* slots = nullptr;
+    mutex_t lock;  // Guards the slot assignment below
+    uint32_t slots_used = 0;
+    std::vector<StatsSlot*> free_slots;  // Slots of threads that have exited
+};
+static StatsWriter stats_writer;
+
+// Called by vkCreateInstance
+static void InitStats() {
+    static std::once_flag once;
+    std::call_once(once, [] { stats_writer.Open(); });
+}
+
+// Returns the slot the calling thread counts into, shared is set if other threads count into it too
+static StatsSlot* AcquireStatsSlot(bool* shared) {
+    lock_guard_t lock(stats_writer.lock);
+    *shared = false;
+    if (!stats_writer.free_slots.empty()) {
+        StatsSlot* slot = stats_writer.free_slots.back();
+        stats_writer.free_slots.pop_back();
+        return slot;
+    }
+    if (stats_writer.slots_used == STATS_SLOT_COUNT - 1) {
+        *shared = true;
+        return &stats_writer.slots[STATS_SLOT_COUNT - 1];
+    }
+    return &stats_writer.slots[stats_writer.slots_used++];
+}
+
+// A slot keeps its counts when its thread exits, the next thread to start continues from them
+static void ReleaseStatsSlot(StatsSlot* slot) {
+    lock_guard_t lock(stats_writer.lock);
+    stats_writer.free_slots.push_back(slot);
+}
+
+// Per thread state of the entrypoint calls in progress. Hands the thread's trace ring over to the flush thread
+// and its statistics slot to the next thread when the thread exits.
+struct EntrypointThread {
+    ~EntrypointThread() {
+        if (ring) {
+            ring->retired.store(true, std::memory_order_release);
+            RequestTraceFlush();
+        }
+        if (stats_slot && !stats_shared) ReleaseStatsSlot(stats_slot);
+    }
+    uint32_t depth = 0;  // Nesting of entrypoint calls, the mock calls its own entrypoints too
+    TraceRing* ring = nullptr;
+    StatsSlot* stats_slot = nullptr;
+    bool stats_shared = false;
+};
+static thread_local EntrypointThread entrypoint_thread;
+
+static void AddStat(uint32_t counter, uint64_t value) {
+    if (!stats_writer.enabled.load(std::memory_order_acquire) || !value) return;
+    EntrypointThread& thread = entrypoint_thread;
+    if (!thread.stats_slot) thread.stats_slot = AcquireStatsSlot(&thread.stats_shared);
+    std::atomic<uint64_t>& total = thread.stats_slot->counters[counter];
+    if (thread.stats_shared) {
+        total.fetch_add(value, std::memory_order_relaxed);
+    } else {
+        total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
     }
 }
 
+// Declared first in every entrypoint. Traces, counts and charges the cost of the call, unless the mock made the
+// call itself.
+class EntrypointScope {
+   public:
+    template <typename... Handles>
+    EntrypointScope(Entrypoint entrypoint, uint64_t elements, Handles... handles) {
+        if (!trace_writer.enabled && !stats_writer.enabled.load(std::memory_order_relaxed) && !cost_model.enabled.load(std::memory_order_relaxed)) return;
+        thread_ = &entrypoint_thread;
+        if (thread_->depth++ != 0) return;
+        outermost_ = true;
+        AddStat(STATS_CALLS + entrypoint, 1);
+        if (trace_writer.enabled) {
+            if (!thread_->ring) thread_->ring = CreateTraceRing();
+            const uint64_t values[] = {0, TraceHandle(handles)...};
+            AppendTraceRecord(thread_->ring, entrypoint, values + 1, sizeof...(handles));
+        }
+        if (cost_model.enabled.load(std::memory_order_relaxed)) ChargeCost(entrypoint, elements);
+    }
+    ~EntrypointScope() {
+        if (thread_) thread_->depth--;
+    }
+    EntrypointScope(const EntrypointScope&) = delete;
+    EntrypointScope& operator=(const EntrypointScope&) = delete;
+
+    // Objects the call creates or destroys, as requested by the application. A scope opened while nothing was
+    // enabled is outermost as well, which counts the instance of the vkCreateInstance that enables the statistics.
+    void CountCreated(StatsObject object, uint64_t count) {
+        if (outermost_ || !thread_) AddStat(STATS_OBJECTS_CREATED + object, count);
+    }
+    void CountDestroyed(StatsObject object, uint64_t count) {
+        if (outermost_) AddStat(STATS_OBJECTS_DESTROYED + object, count);
+    }
+    // Freeing an array of handles destroys its elements that are not VK_NULL_HANDLE
+    template <typename Handle>
+    void CountDestroyed(StatsObject object, const Handle* handles, uint32_t count) {
+        if (!outermost_) return;
+        AddStat(STATS_OBJECTS_DESTROYED + object,
+                std::count_if(handles, handles + count, [](Handle handle) { return handle != VK_NULL_HANDLE; }));
+    }
+
+   private:
+    EntrypointThread* thread_ = nullptr;
+    bool outermost_ = false;
+};
+
 
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateInstance(
@@ -169,6 +4482,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateInstance(
     const VkAllocationCallbacks*                pAllocator,
     VkInstance*                                 pInstance)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateInstance, 0);
 
     // TODO: If loader ver <=4 ICD must fail with VK_ERROR_INCOMPATIBLE_DRIVER for all vkCreateInstance calls with
     //  apiVersion set to > Vulkan 1.0 because the loader is still at interface version <= 4. Otherwise, the
@@ -176,8 +4490,13 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateInstance(
     if (loader_interface_version <= 4) {
         return VK_ERROR_INCOMPATIBLE_DRIVER;
     }
+    // The device profile is read once, every physical device query after this answers from it
+    if (!InitDeviceProfile() || !InitCostModel()) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    InitStats();
     *pInstance = (VkInstance)CreateDispObjHandle();
-    // TODO: If emulating specific device caps, will need to add intelligence here
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkInstance, 1);
     return VK_SUCCESS;
 }
 
@@ -185,11 +4504,17 @@ static VKAPI_ATTR void VKAPI_CALL DestroyInstance(
     VkInstance                                  instance,
     const VkAllocationCallbacks*                pAllocator)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyInstance, 0, instance);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkInstance, instance != VK_NULL_HANDLE);
 
-    // Destroy physical device
-    DestroyDispObjHandle((void*)physical_device);
+    // Destroy physical devices
+    unique_lock_t lock(global_lock);
+    for (uint32_t i = 0; i < physical_device_count; ++i) delete physical_devices[i];
+    physical_device_count = 0;
+    lock.unlock();
 
     DestroyDispObjHandle((void*)instance);
+    FlushTrace();
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL EnumeratePhysicalDevices(
@@ -197,24 +4522,24 @@ static VKAPI_ATTR VkResult VKAPI_CALL EnumeratePhysicalDevices(
     uint32_t*                                   pPhysicalDeviceCount,
     VkPhysicalDevice*                           pPhysicalDevices)
 {
-    if (pPhysicalDevices) {
-        if (!physical_device) {
-            physical_device = (VkPhysicalDevice)CreateDispObjHandle();
-        }
-        *pPhysicalDevices = physical_device;
-    } else {
-        *pPhysicalDeviceCount = 1;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkEnumeratePhysicalDevices, 0, instance);
+    InitPhysicalDevices();
+    if (!pPhysicalDevices) {
+        *pPhysicalDeviceCount = physical_device_count;
+        return VK_SUCCESS;
     }
-    return VK_SUCCESS;
+    const uint32_t count = std::min(*pPhysicalDeviceCount, physical_device_count);
+    for (uint32_t i = 0; i < count; ++i) pPhysicalDevices[i] = reinterpret_cast<VkPhysicalDevice>(physical_devices[i]);
+    *pPhysicalDeviceCount = count;
+    return count < physical_device_count ? VK_INCOMPLETE : VK_SUCCESS;
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceFeatures(
     VkPhysicalDevice                            physicalDevice,
     VkPhysicalDeviceFeatures*                   pFeatures)
 {
-    uint32_t num_bools = sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32);
-    VkBool32 *bool_array = &pFeatures->robustBufferAccess;
-    SetBoolArrayTrue(bool_array, num_bools);
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceFeatures, 0, physicalDevice);
+    *pFeatures = device_profile.features;
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceFormatProperties(
@@ -222,12 +4547,9 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceFormatProperties(
     VkFormat                                    format,
     VkFormatProperties*                         pFormatProperties)
 {
-    if (VK_FORMAT_UNDEFINED == format) {
-        *pFormatProperties = { 0x0, 0x0, 0x0 };
-    } else {
-        // TODO: Just returning full support for everything initially
-        *pFormatProperties = { 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF };
-    }
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceFormatProperties, 0, physicalDevice);
+    const VkFormatProperties* format_properties = GetProfileFormatProperties(format);
+    *pFormatProperties = format_properties ? *format_properties : VkFormatProperties{ 0x0, 0x0, 0x0 };
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceImageFormatProperties(
@@ -239,18 +4561,70 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceImageFormatProperties(
     VkImageCreateFlags                          flags,
     VkImageFormatProperties*                    pImageFormatProperties)
 {
-    // A hardcoded unsupported format
-    if (format == VK_FORMAT_E5B9G9R9_UFLOAT_PACK32) {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceImageFormatProperties, 0, physicalDevice);
+    const VkFormatProperties* format_properties = GetProfileFormatProperties(format);
+    const VkFormatFeatureFlags features = !format_properties ? 0 :
+        VK_IMAGE_TILING_LINEAR == tiling ? format_properties->linearTilingFeatures : format_properties->optimalTilingFeatures;
+    if (!features) {
         return VK_ERROR_FORMAT_NOT_SUPPORTED;
     }
+    if (!device_profile.from_file) {
+        // A hardcoded unsupported format
+        if (format == VK_FORMAT_E5B9G9R9_UFLOAT_PACK32) {
+            return VK_ERROR_FORMAT_NOT_SUPPORTED;
+        }
+        if (VK_IMAGE_TILING_LINEAR == tiling) {
+            *pImageFormatProperties = { { 4096, 4096, 256 }, 1, 1, VK_SAMPLE_COUNT_1_BIT, 4294967296 };
+        } else {
+            // We hard-code support for all sample counts except 64 bits.
+            *pImageFormatProperties = { { 4096, 4096, 256 }, 12, 256, 0x7F & ~VK_SAMPLE_COUNT_64_BIT, 4294967296 };
+        }
+        return VK_SUCCESS;
+    }
 
-    // TODO: Just hard-coding some values for now
-    // TODO: If tiling is linear, limit the mips, levels, & sample count
-    if (VK_IMAGE_TILING_LINEAR == tiling) {
-        *pImageFormatProperties = { { 4096, 4096, 256 }, 1, 1, VK_SAMPLE_COUNT_1_BIT, 4294967296 };
-    } else {
-        // We hard-code support for all sample counts except 64 bits.
-        *pImageFormatProperties = { { 4096, 4096, 256 }, 12, 256, 0x7F & ~VK_SAMPLE_COUNT_64_BIT, 4294967296 };
+    // Otherwise derive the answer from the profile's format features and limits
+    static const struct { VkImageUsageFlags usage; VkFormatFeatureFlags feature; } usage_features[] = {
+        { VK_IMAGE_USAGE_SAMPLED_BIT, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT },
+        { VK_IMAGE_USAGE_STORAGE_BIT, VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT },
+        { VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT },
+        { VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT },
+    };
+    for (const auto& usage_feature : usage_features) {
+        if ((usage & usage_feature.usage) && !(features & usage_feature.feature)) {
+            return VK_ERROR_FORMAT_NOT_SUPPORTED;
+        }
+    }
+    const VkPhysicalDeviceLimits& limits = device_profile.properties.limits;
+    uint32_t max_dimension;
+    switch (type) {
+        case VK_IMAGE_TYPE_1D:
+            max_dimension = limits.maxImageDimension1D;
+            pImageFormatProperties->maxExtent = { max_dimension, 1, 1 };
+            break;
+        case VK_IMAGE_TYPE_3D:
+            max_dimension = limits.maxImageDimension3D;
+            pImageFormatProperties->maxExtent = { max_dimension, max_dimension, max_dimension };
+            break;
+        default:
+            max_dimension = (flags & VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT) ? limits.maxImageDimensionCube : limits.maxImageDimension2D;
+            pImageFormatProperties->maxExtent = { max_dimension, max_dimension, 1 };
+            break;
+    }
+    uint32_t mip_levels = 1;
+    while (max_dimension >> mip_levels) ++mip_levels;
+    const bool linear = VK_IMAGE_TILING_LINEAR == tiling;
+    pImageFormatProperties->maxMipLevels = linear ? 1 : mip_levels;
+    pImageFormatProperties->maxArrayLayers = (linear || VK_IMAGE_TYPE_3D == type) ? 1 : limits.maxImageArrayLayers;
+    pImageFormatProperties->sampleCounts = VK_SAMPLE_COUNT_1_BIT;
+    if (!linear && VK_IMAGE_TYPE_2D == type && !(flags & VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT)) {
+        pImageFormatProperties->sampleCounts = (features & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) ?
+            limits.framebufferDepthSampleCounts : limits.framebufferColorSampleCounts;
+        if (usage & VK_IMAGE_USAGE_STORAGE_BIT) pImageFormatProperties->sampleCounts &= limits.storageImageSampleCounts;
+        pImageFormatProperties->sampleCounts |= VK_SAMPLE_COUNT_1_BIT;
+    }
+    pImageFormatProperties->maxResourceSize = 0;
+    for (uint32_t i = 0; i < device_profile.memory_properties.memoryHeapCount; ++i) {
+        pImageFormatProperties->maxResourceSize = std::max(pImageFormatProperties->maxResourceSize, device_profile.memory_properties.memoryHeaps[i].size);
     }
     return VK_SUCCESS;
 }
@@ -259,17 +4633,8 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceProperties(
     VkPhysicalDevice                            physicalDevice,
     VkPhysicalDeviceProperties*                 pProperties)
 {
-    // TODO: Just hard-coding some values for now
-    pProperties->apiVersion = VK_API_VERSION_1_0;
-    pProperties->driverVersion = 1;
-    pProperties->vendorID = 0xba5eba11;
-    pProperties->deviceID = 0xf005ba11;
-    pProperties->deviceType = VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU;
-    //std::string devName = "Vulkan Mock Device";
-    strcpy(pProperties->deviceName, "Vulkan Mock Device");
-    pProperties->pipelineCacheUUID[0] = 18;
-    pProperties->limits = SetLimits(&pProperties->limits);
-    pProperties->sparseProperties = { VK_TRUE, VK_TRUE, VK_TRUE, VK_TRUE, VK_TRUE };
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceProperties, 0, physicalDevice);
+    *pProperties = device_profile.properties;
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceQueueFamilyProperties(
@@ -277,15 +4642,12 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceQueueFamilyProperties(
     uint32_t*                                   pQueueFamilyPropertyCount,
     VkQueueFamilyProperties*                    pQueueFamilyProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceQueueFamilyProperties, 0, physicalDevice);
     if (!pQueueFamilyProperties) {
-        *pQueueFamilyPropertyCount = 1;
+        *pQueueFamilyPropertyCount = device_profile.queue_family_count;
     } else {
-        if (*pQueueFamilyPropertyCount) {
-            pQueueFamilyProperties[0].queueFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT | VK_QUEUE_SPARSE_BINDING_BIT;
-            pQueueFamilyProperties[0].queueCount = 1;
-            pQueueFamilyProperties[0].timestampValidBits = 0;
-            pQueueFamilyProperties[0].minImageTransferGranularity = {1,1,1};
-        }
+        *pQueueFamilyPropertyCount = std::min(*pQueueFamilyPropertyCount, device_profile.queue_family_count);
+        memcpy(pQueueFamilyProperties, device_profile.queue_families, *pQueueFamilyPropertyCount * sizeof(VkQueueFamilyProperties));
     }
 }
 
@@ -293,29 +4655,22 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceMemoryProperties(
     VkPhysicalDevice                            physicalDevice,
     VkPhysicalDeviceMemoryProperties*           pMemoryProperties)
 {
-    pMemoryProperties->memoryTypeCount = 2;
-    pMemoryProperties->memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-    pMemoryProperties->memoryTypes[0].heapIndex = 0;
-    pMemoryProperties->memoryTypes[1].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-    pMemoryProperties->memoryTypes[1].heapIndex = 1;
-    pMemoryProperties->memoryHeapCount = 2;
-    pMemoryProperties->memoryHeaps[0].flags = 0;
-    pMemoryProperties->memoryHeaps[0].size = 8000000000;
-    pMemoryProperties->memoryHeaps[1].flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
-    pMemoryProperties->memoryHeaps[1].size = 8000000000;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceMemoryProperties, 0, physicalDevice);
+    *pMemoryProperties = device_profile.memory_properties;
 }
 
 static VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetInstanceProcAddr(
     VkInstance                                  instance,
     const char*                                 pName)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetInstanceProcAddr, 0, instance);
 
     if (!negotiate_loader_icd_interface_called) {
         loader_interface_version = 0;
     }
-    const auto &item = name_to_funcptr_map.find(pName);
-    if (item != name_to_funcptr_map.end()) {
-        return reinterpret_cast<PFN_vkVoidFunction>(item->second);
+    const auto item = name_to_funcptr_map.Find(pName);
+    if (item) {
+        return reinterpret_cast<PFN_vkVoidFunction>(*item);
     }
     // Mock should intercept all functions so if we get here just return null
     return nullptr;
@@ -325,6 +4680,7 @@ static VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetDeviceProcAddr(
     VkDevice                                    device,
     const char*                                 pName)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDeviceProcAddr, 0, device);
 
     return GetInstanceProcAddr(nullptr, pName);
 }
@@ -335,8 +4691,20 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateDevice(
     const VkAllocationCallbacks*                pAllocator,
     VkDevice*                                   pDevice)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateDevice, 0, physicalDevice);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkDevice, 1);
 
-    *pDevice = (VkDevice)CreateDispObjHandle();
+    auto new_device = new Device();
+    set_loader_magic_value(&new_device->loader_data);
+    const auto *group_info = lvl_find_in_chain<VkDeviceGroupDeviceCreateInfo>(pCreateInfo->pNext);
+    if (group_info && group_info->physicalDeviceCount) {
+        for (uint32_t i = 0; i < group_info->physicalDeviceCount; ++i) {
+            new_device->physical_devices.push_back(reinterpret_cast<PhysicalDevice*>(group_info->pPhysicalDevices[i]));
+        }
+    } else {
+        new_device->physical_devices.push_back(reinterpret_cast<PhysicalDevice*>(physicalDevice));
+    }
+    *pDevice = reinterpret_cast<VkDevice>(new_device);
     // TODO: If emulating specific device caps, will need to add intelligence here
     return VK_SUCCESS;
 }
@@ -345,20 +4713,19 @@ static VKAPI_ATTR void VKAPI_CALL DestroyDevice(
     VkDevice                                    device,
     const VkAllocationCallbacks*                pAllocator)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyDevice, 0, device);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkDevice, device != VK_NULL_HANDLE);
 
-    unique_lock_t lock(global_lock);
     // First destroy sub-device objects
-    // Destroy Queues
-    for (auto dev_queue_map_pair : queue_map) {
-        for (auto queue_family_map_pair : queue_map[dev_queue_map_pair.first]) {
-            for (auto index_queue_pair : queue_map[dev_queue_map_pair.first][queue_family_map_pair.first]) {
-                DestroyDispObjHandle((void*)index_queue_pair.second);
-            }
+    // Destroy Queues, stopping their workers. Only this device's queues, the others are still running.
+    Device* destroyed_device = reinterpret_cast<Device*>(device);
+    for (const auto& family_queues : destroyed_device->queues) {
+        for (auto queue : family_queues) {
+            if (queue) DestroyQueue(reinterpret_cast<Queue*>(queue));
         }
     }
-    queue_map.clear();
     // Now destroy device
-    DestroyDispObjHandle((void*)device);
+    delete destroyed_device;
     // TODO: If emulating specific device caps, will need to add intelligence here
 }
 
@@ -367,26 +4734,26 @@ static VKAPI_ATTR VkResult VKAPI_CALL EnumerateInstanceExtensionProperties(
     uint32_t*                                   pPropertyCount,
     VkExtensionProperties*                      pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkEnumerateInstanceExtensionProperties, 0);
 
     // If requesting number of extensions, return that
     if (!pLayerName) {
-        if (!pProperties) {
-            *pPropertyCount = (uint32_t)instance_extension_map.size();
-        } else {
-            uint32_t i = 0;
-            for (const auto &name_ver_pair : instance_extension_map) {
+        uint32_t i = 0;
+        for (const auto &entry : instance_extension_map.entries) {
+            if (!entry.name) {
+                continue;
+            }
+            if (pProperties) {
                 if (i == *pPropertyCount) {
-                    break;
+                    return VK_INCOMPLETE;
                 }
-                std::strncpy(pProperties[i].extensionName, name_ver_pair.first.c_str(), sizeof(pProperties[i].extensionName));
+                std::strncpy(pProperties[i].extensionName, entry.name, sizeof(pProperties[i].extensionName));
                 pProperties[i].extensionName[sizeof(pProperties[i].extensionName) - 1] = 0;
-                pProperties[i].specVersion = name_ver_pair.second;
-                ++i;
-            }
-            if (i != instance_extension_map.size()) {
-                return VK_INCOMPLETE;
+                pProperties[i].specVersion = entry.value;
             }
+            ++i;
         }
+        *pPropertyCount = i;
     }
     // If requesting extension properties, fill in data struct for number of extensions
     return VK_SUCCESS;
@@ -398,26 +4765,26 @@ static VKAPI_ATTR VkResult VKAPI_CALL EnumerateDeviceExtensionProperties(
     uint32_t*                                   pPropertyCount,
     VkExtensionProperties*                      pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkEnumerateDeviceExtensionProperties, 0, physicalDevice);
 
     // If requesting number of extensions, return that
     if (!pLayerName) {
-        if (!pProperties) {
-            *pPropertyCount = (uint32_t)device_extension_map.size();
-        } else {
-            uint32_t i = 0;
-            for (const auto &name_ver_pair : device_extension_map) {
+        uint32_t i = 0;
+        for (const auto &entry : device_extension_map.entries) {
+            if (!entry.name) {
+                continue;
+            }
+            if (pProperties) {
                 if (i == *pPropertyCount) {
-                    break;
+                    return VK_INCOMPLETE;
                 }
-                std::strncpy(pProperties[i].extensionName, name_ver_pair.first.c_str(), sizeof(pProperties[i].extensionName));
+                std::strncpy(pProperties[i].extensionName, entry.name, sizeof(pProperties[i].extensionName));
                 pProperties[i].extensionName[sizeof(pProperties[i].extensionName) - 1] = 0;
-                pProperties[i].specVersion = name_ver_pair.second;
-                ++i;
-            }
-            if (i != device_extension_map.size()) {
-                return VK_INCOMPLETE;
+                pProperties[i].specVersion = entry.value;
             }
+            ++i;
         }
+        *pPropertyCount = i;
     }
     // If requesting extension properties, fill in data struct for number of extensions
     return VK_SUCCESS;
@@ -427,6 +4794,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL EnumerateInstanceLayerProperties(
     uint32_t*                                   pPropertyCount,
     VkLayerProperties*                          pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkEnumerateInstanceLayerProperties, 0);
 
     return VK_SUCCESS;
 }
@@ -436,6 +4804,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL EnumerateDeviceLayerProperties(
     uint32_t*                                   pPropertyCount,
     VkLayerProperties*                          pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkEnumerateDeviceLayerProperties, 0, physicalDevice);
 
     return VK_SUCCESS;
 }
@@ -446,13 +4815,15 @@ static VKAPI_ATTR void VKAPI_CALL GetDeviceQueue(
     uint32_t                                    queueIndex,
     VkQueue*                                    pQueue)
 {
-    unique_lock_t lock(global_lock);
-    auto queue = queue_map[device][queueFamilyIndex][queueIndex];
-    if (queue) {
-        *pQueue = queue;
-    } else {
-        *pQueue = queue_map[device][queueFamilyIndex][queueIndex] = (VkQueue)CreateDispObjHandle();
-    }
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDeviceQueue, 0, device);
+    Device* mock_device = reinterpret_cast<Device*>(device);
+    unique_lock_t lock(mock_device->lock);
+    auto& queues = mock_device->queues;
+    if (queueFamilyIndex >= queues.size()) queues.resize(queueFamilyIndex + 1);
+    if (queueIndex >= queues[queueFamilyIndex].size()) queues[queueFamilyIndex].resize(queueIndex + 1);
+    VkQueue& queue = queues[queueFamilyIndex][queueIndex];
+    if (!queue) queue = reinterpret_cast<VkQueue>(CreateQueue(mock_device));
+    *pQueue = queue;
     // TODO: If emulating specific device caps, will need to add intelligence here
     return;
 }
@@ -463,21 +4834,52 @@ static VKAPI_ATTR VkResult VKAPI_CALL QueueSubmit(
     const VkSubmitInfo*                         pSubmits,
     VkFence                                     fence)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkQueueSubmit, submitCount, queue, fence);
+    Queue* submit_queue = reinterpret_cast<Queue*>(queue);
+    std::vector<Submission> submissions(submitCount);
+    unique_lock_t lock(submit_queue->device->sync_lock);
+    for (uint32_t i = 0; i < submitCount; ++i) {
+        const VkSubmitInfo& submit = pSubmits[i];
+        const auto *timeline_info = lvl_find_in_chain<VkTimelineSemaphoreSubmitInfo>(submit.pNext);
+        for (uint32_t j = 0; j < submit.waitSemaphoreCount; ++j) {
+            AddSemaphoreWait(&submissions[i], submit.pWaitSemaphores[j], GetTimelineWaitValue(timeline_info, j));
+        }
+        for (uint32_t j = 0; j < submit.signalSemaphoreCount; ++j) {
+            AddSemaphoreSignal(&submissions[i], submit.pSignalSemaphores[j], GetTimelineSignalValue(timeline_info, j));
+        }
+        submissions[i].command_buffers.assign(submit.pCommandBuffers, submit.pCommandBuffers + submit.commandBufferCount);
+    }
+    if (fence != VK_NULL_HANDLE) {
+        if (submissions.empty()) submissions.resize(1);
+        submissions.back().fence = GetFence(fence);
+    }
+    lock.unlock();
+    EnqueueSubmissions(submit_queue, submissions);
     return VK_SUCCESS;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL QueueWaitIdle(
     VkQueue                                     queue)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkQueueWaitIdle, 0, queue);
+    WaitQueueIdle(reinterpret_cast<Queue*>(queue));
     return VK_SUCCESS;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL DeviceWaitIdle(
     VkDevice                                    device)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDeviceWaitIdle, 0, device);
+    std::vector<Queue*> queues;
+    Device* mock_device = reinterpret_cast<Device*>(device);
+    unique_lock_t lock(mock_device->lock);
+    for (const auto& family_queues : mock_device->queues) {
+        for (auto queue : family_queues) {
+            if (queue) queues.push_back(reinterpret_cast<Queue*>(queue));
+        }
+    }
+    lock.unlock();
+    for (auto queue : queues) WaitQueueIdle(queue);
     return VK_SUCCESS;
 }
 
@@ -487,8 +4889,37 @@ static VKAPI_ATTR VkResult VKAPI_CALL AllocateMemory(
     const VkAllocationCallbacks*                pAllocator,
     VkDeviceMemory*                             pMemory)
 {
-    unique_lock_t lock(global_lock);
-    *pMemory = (VkDeviceMemory)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkAllocateMemory, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkDeviceMemory, 1);
+    DeviceMemory memory;
+    memory.allocation_size = pAllocateInfo->allocationSize;
+    memory.heap_index = device_profile.memory_properties.memoryTypes[pAllocateInfo->memoryTypeIndex].heapIndex;
+    memory.physical_device_mask = GetAllocationPhysicalDeviceMask(*reinterpret_cast<Device*>(device),
+                                                                  lvl_find_in_chain<VkMemoryAllocateFlagsInfo>(pAllocateInfo->pNext));
+    memory.mapped_size = 0;
+    // A full heap fails before anything is allocated
+    if (!ReserveHeapMemory(memory.physical_device_mask, memory.heap_index, memory.allocation_size)) {
+        entrypoint_scope.CountDestroyed(STATS_OBJECT_VkDeviceMemory, 1);
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+    VkResult result = VK_SUCCESS;
+    const auto *import_fd_info = lvl_find_in_chain<VkImportMemoryFdInfoKHR>(pAllocateInfo->pNext);
+    const auto *export_info = lvl_find_in_chain<VkExportMemoryAllocateInfo>(pAllocateInfo->pNext);
+    if (import_fd_info && import_fd_info->handleType) {
+        // On success the implementation owns the fd, it is closed when the memory is freed
+        if (!ImportDeviceMemoryFd(import_fd_info->fd, pAllocateInfo->allocationSize, &memory)) result = VK_ERROR_INVALID_EXTERNAL_HANDLE;
+    } else if (export_info && (export_info->handleTypes & VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT)) {
+        if (!AllocateDeviceMemoryFd(pAllocateInfo->allocationSize, &memory)) result = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    } else if (!AllocateDeviceMemoryBacking(pAllocateInfo->allocationSize, &memory)) {
+        result = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+    if (result != VK_SUCCESS) {
+        ReleaseHeapMemory(memory.physical_device_mask, memory.heap_index, memory.allocation_size);
+        entrypoint_scope.CountDestroyed(STATS_OBJECT_VkDeviceMemory, 1);
+        return result;
+    }
+    AddStat(STATS_MEMORY_ALLOCATED + memory.heap_index, memory.allocation_size);
+    *pMemory = (VkDeviceMemory)device_memory_table.Create(memory);
     return VK_SUCCESS;
 }
 
@@ -497,7 +4928,17 @@ static VKAPI_ATTR void VKAPI_CALL FreeMemory(
     VkDeviceMemory                              memory,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkFreeMemory, 0, device, memory);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkDeviceMemory, memory != VK_NULL_HANDLE);
+    DeviceMemory* device_memory = device_memory_table.Get(memory);
+    if (!device_memory) return;
+    DeviceMemory backing = *device_memory;
+    device_memory_table.Destroy(memory);
+    // Freeing memory implicitly unmaps it
+    AddStat(STATS_MEMORY_UNMAPPED, backing.mapped_size);
+    AddStat(STATS_MEMORY_FREED + backing.heap_index, backing.allocation_size);
+    FreeDeviceMemoryBacking(backing);
+    ReleaseHeapMemory(backing.physical_device_mask, backing.heap_index, backing.allocation_size);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL MapMemory(
@@ -508,13 +4949,13 @@ static VKAPI_ATTR VkResult VKAPI_CALL MapMemory(
     VkMemoryMapFlags                            flags,
     void**                                      ppData)
 {
-    unique_lock_t lock(global_lock);
-    // TODO: Just hard-coding 64k whole size for now
-    if (VK_WHOLE_SIZE == size)
-        size = 0x10000;
-    void* map_addr = malloc((size_t)size);
-    mapped_memory_map[memory].push_back(map_addr);
-    *ppData = map_addr;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkMapMemory, 0, device, memory);
+    DeviceMemory* device_memory = device_memory_table.Get(memory);
+    if (!device_memory) return VK_ERROR_MEMORY_MAP_FAILED;
+    // Mappings point straight into the backing store, so they persist and keep their contents across unmap
+    *ppData = static_cast<char*>(device_memory->data) + offset;
+    device_memory->mapped_size = size == VK_WHOLE_SIZE ? device_memory->allocation_size - offset : size;
+    AddStat(STATS_MEMORY_MAPPED, device_memory->mapped_size);
     return VK_SUCCESS;
 }
 
@@ -522,11 +4963,12 @@ static VKAPI_ATTR void VKAPI_CALL UnmapMemory(
     VkDevice                                    device,
     VkDeviceMemory                              memory)
 {
-    unique_lock_t lock(global_lock);
-    for (auto map_addr : mapped_memory_map[memory]) {
-        free(map_addr);
-    }
-    mapped_memory_map.erase(memory);
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkUnmapMemory, 0, device, memory);
+    // Mappings alias the backing store which lives until the memory is freed, nothing to release here
+    DeviceMemory* device_memory = device_memory_table.Get(memory);
+    if (!device_memory) return;
+    AddStat(STATS_MEMORY_UNMAPPED, device_memory->mapped_size);
+    device_memory->mapped_size = 0;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL FlushMappedMemoryRanges(
@@ -534,6 +4976,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL FlushMappedMemoryRanges(
     uint32_t                                    memoryRangeCount,
     const VkMappedMemoryRange*                  pMemoryRanges)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkFlushMappedMemoryRanges, memoryRangeCount, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -543,6 +4986,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL InvalidateMappedMemoryRanges(
     uint32_t                                    memoryRangeCount,
     const VkMappedMemoryRange*                  pMemoryRanges)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkInvalidateMappedMemoryRanges, memoryRangeCount, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -552,6 +4996,7 @@ static VKAPI_ATTR void VKAPI_CALL GetDeviceMemoryCommitment(
     VkDeviceMemory                              memory,
     VkDeviceSize*                               pCommittedMemoryInBytes)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDeviceMemoryCommitment, 0, device, memory);
 //Not a CREATE or DESTROY function
 }
 
@@ -561,7 +5006,8 @@ static VKAPI_ATTR VkResult VKAPI_CALL BindBufferMemory(
     VkDeviceMemory                              memory,
     VkDeviceSize                                memoryOffset)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkBindBufferMemory, 0, device, buffer, memory);
+    if (Buffer* buffer_state = buffer_table.Get(buffer)) buffer_state->binding = {memory, memoryOffset};
     return VK_SUCCESS;
 }
 
@@ -571,7 +5017,10 @@ static VKAPI_ATTR VkResult VKAPI_CALL BindImageMemory(
     VkDeviceMemory                              memory,
     VkDeviceSize                                memoryOffset)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkBindImageMemory, 0, device, image, memory);
+    if (Image* image_state = image_table.Get(image)) {
+        for (auto& binding : image_state->bindings) binding = {memory, memoryOffset};
+    }
     return VK_SUCCESS;
 }
 
@@ -580,17 +5029,14 @@ static VKAPI_ATTR void VKAPI_CALL GetBufferMemoryRequirements(
     VkBuffer                                    buffer,
     VkMemoryRequirements*                       pMemoryRequirements)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetBufferMemoryRequirements, 0, device, buffer);
     // TODO: Just hard-coding reqs for now
     pMemoryRequirements->size = 4096;
     pMemoryRequirements->alignment = 1;
-    pMemoryRequirements->memoryTypeBits = 0xFFFF;
+    pMemoryRequirements->memoryTypeBits = GetMemoryTypeBits();
     // Return a better size based on the buffer size from the create info.
-    auto d_iter = buffer_map.find(device);
-    if (d_iter != buffer_map.end()) {
-        auto iter = d_iter->second.find(buffer);
-        if (iter != d_iter->second.end()) {
-            pMemoryRequirements->size = ((iter->second.size + 4095) / 4096) * 4096;
-        }
+    if (const Buffer* buffer_state = buffer_table.Get(buffer)) {
+        pMemoryRequirements->size = ((buffer_state->create_info.size + 4095) / 4096) * 4096;
     }
 }
 
@@ -599,12 +5045,13 @@ static VKAPI_ATTR void VKAPI_CALL GetImageMemoryRequirements(
     VkImage                                     image,
     VkMemoryRequirements*                       pMemoryRequirements)
 {
-    // TODO: Just hard-coding reqs for now
-    pMemoryRequirements->size = 4096;
-    pMemoryRequirements->alignment = 1;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetImageMemoryRequirements, 0, device, image);
+    const Image* image_state = image_table.Get(image);
+    pMemoryRequirements->size = image_state ? AlignDeviceSize(image_state->plane_offsets[MAX_FORMAT_PLANES], IMAGE_ALIGNMENT) : IMAGE_ALIGNMENT;
+    pMemoryRequirements->alignment = IMAGE_ALIGNMENT;
 
     // Here we hard-code that the memory type at index 3 doesn't support this image.
-    pMemoryRequirements->memoryTypeBits = 0xFFFF & ~(0x1 << 3);
+    pMemoryRequirements->memoryTypeBits = GetMemoryTypeBits() & ~(0x1 << 3);
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetImageSparseMemoryRequirements(
@@ -613,6 +5060,7 @@ static VKAPI_ATTR void VKAPI_CALL GetImageSparseMemoryRequirements(
     uint32_t*                                   pSparseMemoryRequirementCount,
     VkSparseImageMemoryRequirements*            pSparseMemoryRequirements)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetImageSparseMemoryRequirements, 0, device, image);
 //Not a CREATE or DESTROY function
 }
 
@@ -626,6 +5074,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceSparseImageFormatProperties(
     uint32_t*                                   pPropertyCount,
     VkSparseImageFormatProperties*              pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceSparseImageFormatProperties, 0, physicalDevice);
 //Not a CREATE or DESTROY function
 }
 
@@ -635,7 +5084,27 @@ static VKAPI_ATTR VkResult VKAPI_CALL QueueBindSparse(
     const VkBindSparseInfo*                     pBindInfo,
     VkFence                                     fence)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkQueueBindSparse, bindInfoCount, queue, fence);
+    // Binds take effect immediately, only the semaphores and fence go through the queue
+    Queue* bind_queue = reinterpret_cast<Queue*>(queue);
+    std::vector<Submission> submissions(bindInfoCount);
+    unique_lock_t lock(bind_queue->device->sync_lock);
+    for (uint32_t i = 0; i < bindInfoCount; ++i) {
+        const VkBindSparseInfo& bind = pBindInfo[i];
+        const auto *timeline_info = lvl_find_in_chain<VkTimelineSemaphoreSubmitInfo>(bind.pNext);
+        for (uint32_t j = 0; j < bind.waitSemaphoreCount; ++j) {
+            AddSemaphoreWait(&submissions[i], bind.pWaitSemaphores[j], GetTimelineWaitValue(timeline_info, j));
+        }
+        for (uint32_t j = 0; j < bind.signalSemaphoreCount; ++j) {
+            AddSemaphoreSignal(&submissions[i], bind.pSignalSemaphores[j], GetTimelineSignalValue(timeline_info, j));
+        }
+    }
+    if (fence != VK_NULL_HANDLE) {
+        if (submissions.empty()) submissions.resize(1);
+        submissions.back().fence = GetFence(fence);
+    }
+    lock.unlock();
+    EnqueueSubmissions(bind_queue, submissions);
     return VK_SUCCESS;
 }
 
@@ -645,8 +5114,10 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateFence(
     const VkAllocationCallbacks*                pAllocator,
     VkFence*                                    pFence)
 {
-    unique_lock_t lock(global_lock);
-    *pFence = (VkFence)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateFence, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkFence, 1);
+    *pFence = (VkFence)fence_table.Create();
+    GetFence(*pFence)->signaled = (pCreateInfo->flags & VK_FENCE_CREATE_SIGNALED_BIT) != 0;
     return VK_SUCCESS;
 }
 
@@ -655,7 +5126,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyFence(
     VkFence                                     fence,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyFence, 0, device, fence);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkFence, fence != VK_NULL_HANDLE);
+    fence_table.Destroy(fence);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL ResetFences(
@@ -663,7 +5136,11 @@ static VKAPI_ATTR VkResult VKAPI_CALL ResetFences(
     uint32_t                                    fenceCount,
     const VkFence*                              pFences)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkResetFences, fenceCount, device);
+    for (uint32_t i = 0; i < fenceCount; ++i) {
+        Fence* reset_fence = GetFence(pFences[i]);
+        if (reset_fence) reset_fence->signaled = false;
+    }
     return VK_SUCCESS;
 }
 
@@ -671,8 +5148,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetFenceStatus(
     VkDevice                                    device,
     VkFence                                     fence)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetFenceStatus, 0, device, fence);
+    Fence* status_fence = GetFence(fence);
+    return (!status_fence || status_fence->signaled.load()) ? VK_SUCCESS : VK_NOT_READY;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL WaitForFences(
@@ -682,8 +5160,22 @@ static VKAPI_ATTR VkResult VKAPI_CALL WaitForFences(
     VkBool32                                    waitAll,
     uint64_t                                    timeout)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkWaitForFences, fenceCount, device);
+    std::vector<Fence*> fences;
+    for (uint32_t i = 0; i < fenceCount; ++i) {
+        Fence* wait_fence = GetFence(pFences[i]);
+        if (wait_fence) fences.push_back(wait_fence);
+    }
+    const bool wait_all = waitAll == VK_TRUE;
+    auto signaled = [&fences, wait_all] {
+        for (auto wait_fence : fences) {
+            const bool fence_signaled = wait_fence->signaled.load();
+            if (wait_all && !fence_signaled) return false;
+            if (!wait_all && fence_signaled) return true;
+        }
+        return wait_all || fences.empty();
+    };
+    return WaitForSyncObjects(reinterpret_cast<Device*>(device), signaled, GetSyncDeadline(timeout)) ? VK_SUCCESS : VK_TIMEOUT;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateSemaphore(
@@ -692,8 +5184,15 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateSemaphore(
     const VkAllocationCallbacks*                pAllocator,
     VkSemaphore*                                pSemaphore)
 {
-    unique_lock_t lock(global_lock);
-    *pSemaphore = (VkSemaphore)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateSemaphore, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSemaphore, 1);
+    *pSemaphore = (VkSemaphore)semaphore_table.Create();
+    Semaphore* new_semaphore = GetSemaphore(*pSemaphore);
+    const auto *type_info = lvl_find_in_chain<VkSemaphoreTypeCreateInfo>(pCreateInfo->pNext);
+    if (type_info && type_info->semaphoreType == VK_SEMAPHORE_TYPE_TIMELINE) {
+        new_semaphore->type = VK_SEMAPHORE_TYPE_TIMELINE;
+        new_semaphore->value = type_info->initialValue;
+    }
     return VK_SUCCESS;
 }
 
@@ -702,7 +5201,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroySemaphore(
     VkSemaphore                                 semaphore,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroySemaphore, 0, device, semaphore);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkSemaphore, semaphore != VK_NULL_HANDLE);
+    semaphore_table.Destroy(semaphore);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateEvent(
@@ -711,8 +5212,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateEvent(
     const VkAllocationCallbacks*                pAllocator,
     VkEvent*                                    pEvent)
 {
-    unique_lock_t lock(global_lock);
-    *pEvent = (VkEvent)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateEvent, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkEvent, 1);
+    *pEvent = (VkEvent)event_table.Create();
     return VK_SUCCESS;
 }
 
@@ -721,13 +5223,16 @@ static VKAPI_ATTR void VKAPI_CALL DestroyEvent(
     VkEvent                                     event,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyEvent, 0, device, event);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkEvent, event != VK_NULL_HANDLE);
+    event_table.Destroy(event);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL GetEventStatus(
     VkDevice                                    device,
     VkEvent                                     event)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetEventStatus, 0, device, event);
 //Not a CREATE or DESTROY function
     return VK_EVENT_SET;
 }
@@ -736,6 +5241,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL SetEvent(
     VkDevice                                    device,
     VkEvent                                     event)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkSetEvent, 0, device, event);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -744,6 +5250,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL ResetEvent(
     VkDevice                                    device,
     VkEvent                                     event)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkResetEvent, 0, device, event);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -754,8 +5261,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateQueryPool(
     const VkAllocationCallbacks*                pAllocator,
     VkQueryPool*                                pQueryPool)
 {
-    unique_lock_t lock(global_lock);
-    *pQueryPool = (VkQueryPool)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateQueryPool, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkQueryPool, 1);
+    *pQueryPool = (VkQueryPool)query_pool_table.Create(pCreateInfo);
     return VK_SUCCESS;
 }
 
@@ -764,7 +5272,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyQueryPool(
     VkQueryPool                                 queryPool,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyQueryPool, 0, device, queryPool);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkQueryPool, queryPool != VK_NULL_HANDLE);
+    query_pool_table.Destroy(queryPool);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL GetQueryPoolResults(
@@ -777,8 +5287,25 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetQueryPoolResults(
     VkDeviceSize                                stride,
     VkQueryResultFlags                          flags)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetQueryPoolResults, dataSize, device, queryPool);
+    QueryPool* pool = GetQueryPool(queryPool);
+    if (!pool) return VK_SUCCESS;
+    VkResult result = VK_SUCCESS;
+    for (uint32_t i = 0; i < queryCount; ++i) {
+        const uint32_t query = firstQuery + i;
+        if (query >= pool->available.size()) break;
+        bool available = pool->available[query].load(std::memory_order_acquire);
+        if (!available && (flags & VK_QUERY_RESULT_WAIT_BIT)) {
+            // Once all submitted work has executed nothing is left that could make the query available
+            Device* query_device = reinterpret_cast<Device*>(device);
+            WaitForSyncObjects(query_device, [&] { return pool->available[query].load() || query_device->pending_submissions.load() == 0; },
+                               std::chrono::steady_clock::time_point::max());
+            available = pool->available[query].load(std::memory_order_acquire);
+        }
+        if (!available) result = VK_NOT_READY;
+        WriteQueryResult(pool, query, available, static_cast<char*>(pData) + i * stride, flags);
+    }
+    return result;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateBuffer(
@@ -787,9 +5314,11 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateBuffer(
     const VkAllocationCallbacks*                pAllocator,
     VkBuffer*                                   pBuffer)
 {
-    unique_lock_t lock(global_lock);
-    *pBuffer = (VkBuffer)global_unique_handle++;
-    buffer_map[device][*pBuffer] = *pCreateInfo;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateBuffer, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkBuffer, 1);
+    Buffer buffer = {*pCreateInfo};
+    buffer.create_info.pNext = nullptr;
+    *pBuffer = (VkBuffer)buffer_table.Create(buffer);
     return VK_SUCCESS;
 }
 
@@ -798,8 +5327,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyBuffer(
     VkBuffer                                    buffer,
     const VkAllocationCallbacks*                pAllocator)
 {
-    unique_lock_t lock(global_lock);
-    buffer_map[device].erase(buffer);
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyBuffer, 0, device, buffer);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkBuffer, buffer != VK_NULL_HANDLE);
+    buffer_table.Destroy(buffer);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateBufferView(
@@ -808,8 +5338,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateBufferView(
     const VkAllocationCallbacks*                pAllocator,
     VkBufferView*                               pView)
 {
-    unique_lock_t lock(global_lock);
-    *pView = (VkBufferView)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateBufferView, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkBufferView, 1);
+    *pView = (VkBufferView)buffer_view_table.Create();
     return VK_SUCCESS;
 }
 
@@ -818,7 +5349,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyBufferView(
     VkBufferView                                bufferView,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyBufferView, 0, device, bufferView);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkBufferView, bufferView != VK_NULL_HANDLE);
+    buffer_view_table.Destroy(bufferView);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateImage(
@@ -827,8 +5360,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateImage(
     const VkAllocationCallbacks*                pAllocator,
     VkImage*                                    pImage)
 {
-    unique_lock_t lock(global_lock);
-    *pImage = (VkImage)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateImage, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkImage, 1);
+    *pImage = (VkImage)image_table.Create(CreateImageState(*pCreateInfo));
     return VK_SUCCESS;
 }
 
@@ -837,7 +5371,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyImage(
     VkImage                                     image,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyImage, 0, device, image);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkImage, image != VK_NULL_HANDLE);
+    image_table.Destroy(image);
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetImageSubresourceLayout(
@@ -846,8 +5382,19 @@ static VKAPI_ATTR void VKAPI_CALL GetImageSubresourceLayout(
     const VkImageSubresource*                   pSubresource,
     VkSubresourceLayout*                        pLayout)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetImageSubresourceLayout, 0, device, image);
     // Need safe values. Callers are computing memory offsets from pLayout, with no return code to flag failure. 
     *pLayout = VkSubresourceLayout(); // Default constructor zero values.
+    const Image* image_state = image_table.Get(image);
+    if (!image_state) return;
+    const VkImageCreateInfo& info = image_state->create_info;
+    const uint32_t plane = GetAspectPlane(pSubresource->aspectMask);
+    const size_t index = plane * info.mipLevels + pSubresource->mipLevel;
+    if (pSubresource->mipLevel >= info.mipLevels || pSubresource->arrayLayer >= info.arrayLayers || index >= image_state->subresources.size()) return;
+    *pLayout = image_state->subresources[index];
+    pLayout->offset += pSubresource->arrayLayer * pLayout->arrayPitch;
+    // Offsets into the planes of disjoint images are relative to the memory bound to the plane
+    if (info.flags & VK_IMAGE_CREATE_DISJOINT_BIT) pLayout->offset -= image_state->plane_offsets[plane];
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateImageView(
@@ -856,8 +5403,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateImageView(
     const VkAllocationCallbacks*                pAllocator,
     VkImageView*                                pView)
 {
-    unique_lock_t lock(global_lock);
-    *pView = (VkImageView)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateImageView, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkImageView, 1);
+    *pView = (VkImageView)image_view_table.Create(CreateImageViewState(*pCreateInfo));
     return VK_SUCCESS;
 }
 
@@ -866,7 +5414,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyImageView(
     VkImageView                                 imageView,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyImageView, 0, device, imageView);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkImageView, imageView != VK_NULL_HANDLE);
+    image_view_table.Destroy(imageView);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateShaderModule(
@@ -875,8 +5425,12 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateShaderModule(
     const VkAllocationCallbacks*                pAllocator,
     VkShaderModule*                             pShaderModule)
 {
-    unique_lock_t lock(global_lock);
-    *pShaderModule = (VkShaderModule)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateShaderModule, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkShaderModule, 1);
+    Hasher hasher;
+    hasher.Add(pCreateInfo->pCode, pCreateInfo->codeSize);
+    ShaderModule module = {hasher.hash, std::vector<uint32_t>(pCreateInfo->pCode, pCreateInfo->pCode + pCreateInfo->codeSize / sizeof(uint32_t))};
+    *pShaderModule = (VkShaderModule)shader_module_table.Create(std::move(module));
     return VK_SUCCESS;
 }
 
@@ -885,7 +5439,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyShaderModule(
     VkShaderModule                              shaderModule,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyShaderModule, 0, device, shaderModule);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkShaderModule, shaderModule != VK_NULL_HANDLE);
+    shader_module_table.Destroy(shaderModule);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreatePipelineCache(
@@ -894,8 +5450,10 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreatePipelineCache(
     const VkAllocationCallbacks*                pAllocator,
     VkPipelineCache*                            pPipelineCache)
 {
-    unique_lock_t lock(global_lock);
-    *pPipelineCache = (VkPipelineCache)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreatePipelineCache, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkPipelineCache, 1);
+    *pPipelineCache = (VkPipelineCache)pipeline_cache_table.Create();
+    LoadPipelineCacheData(GetPipelineCache(*pPipelineCache), pCreateInfo->pInitialData, pCreateInfo->initialDataSize);
     return VK_SUCCESS;
 }
 
@@ -904,7 +5462,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyPipelineCache(
     VkPipelineCache                             pipelineCache,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyPipelineCache, 0, device, pipelineCache);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkPipelineCache, pipelineCache != VK_NULL_HANDLE);
+    pipeline_cache_table.Destroy(pipelineCache);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL GetPipelineCacheData(
@@ -913,8 +5473,30 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPipelineCacheData(
     size_t*                                     pDataSize,
     void*                                       pData)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPipelineCacheData, 0, device, pipelineCache);
+    PipelineCache* cache = GetPipelineCache(pipelineCache);
+    if (!cache) {
+        *pDataSize = 0;
+        return VK_SUCCESS;
+    }
+    lock_guard_t lock(cache->lock);
+    const size_t size = PIPELINE_CACHE_HEADER_SIZE + cache->keys.size() * sizeof(uint64_t);
+    if (!pData) {
+        *pDataSize = size;
+        return VK_SUCCESS;
+    }
+    // Only whole entries are written, and nothing at all if the header does not fit
+    if (*pDataSize < PIPELINE_CACHE_HEADER_SIZE) {
+        *pDataSize = 0;
+        return VK_INCOMPLETE;
+    }
+    char* data = static_cast<char*>(pData);
+    WritePipelineCacheHeader(data);
+    const size_t count = std::min(cache->keys.size(), (*pDataSize - PIPELINE_CACHE_HEADER_SIZE) / sizeof(uint64_t));
+    auto key = cache->keys.begin();
+    for (size_t i = 0; i < count; ++i, ++key) memcpy(data + PIPELINE_CACHE_HEADER_SIZE + i * sizeof(uint64_t), &*key, sizeof(uint64_t));
+    *pDataSize = PIPELINE_CACHE_HEADER_SIZE + count * sizeof(uint64_t);
+    return count < cache->keys.size() ? VK_INCOMPLETE : VK_SUCCESS;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL MergePipelineCaches(
@@ -923,7 +5505,17 @@ static VKAPI_ATTR VkResult VKAPI_CALL MergePipelineCaches(
     uint32_t                                    srcCacheCount,
     const VkPipelineCache*                      pSrcCaches)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkMergePipelineCaches, srcCacheCount, device, dstCache);
+    PipelineCache* dst = GetPipelineCache(dstCache);
+    if (!dst) return VK_SUCCESS;
+    for (uint32_t i = 0; i < srcCacheCount; ++i) {
+        PipelineCache* src = GetPipelineCache(pSrcCaches[i]);
+        if (!src || src == dst) continue;
+        std::lock(dst->lock, src->lock);
+        lock_guard_t dst_lock(dst->lock, std::adopt_lock);
+        lock_guard_t src_lock(src->lock, std::adopt_lock);
+        dst->keys.insert(src->keys.begin(), src->keys.end());
+    }
     return VK_SUCCESS;
 }
 
@@ -935,9 +5527,16 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateGraphicsPipelines(
     const VkAllocationCallbacks*                pAllocator,
     VkPipeline*                                 pPipelines)
 {
-    unique_lock_t lock(global_lock);
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateGraphicsPipelines, createInfoCount, device, pipelineCache);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkPipeline, createInfoCount);
+    std::vector<uint64_t> keys(createInfoCount);
+    std::vector<Pipeline> pipelines(createInfoCount);
+    for (uint32_t i = 0; i < createInfoCount; ++i) {
+        keys[i] = GetGraphicsPipelineKey(pCreateInfos[i]);
+        if (GetRasterizationEnabled()) pipelines[i].raster = CreateRasterPipeline(pCreateInfos[i]);
+    }
     for (uint32_t i = 0; i < createInfoCount; ++i) {
-        pPipelines[i] = (VkPipeline)global_unique_handle++;
+        pPipelines[i] = CreatePipeline(pipelineCache, keys[i], pCreateInfos[i].pNext, std::move(pipelines[i]));
     }
     return VK_SUCCESS;
 }
@@ -950,9 +5549,16 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateComputePipelines(
     const VkAllocationCallbacks*                pAllocator,
     VkPipeline*                                 pPipelines)
 {
-    unique_lock_t lock(global_lock);
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateComputePipelines, createInfoCount, device, pipelineCache);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkPipeline, createInfoCount);
+    std::vector<uint64_t> keys(createInfoCount);
+    std::vector<Pipeline> pipelines(createInfoCount);
     for (uint32_t i = 0; i < createInfoCount; ++i) {
-        pPipelines[i] = (VkPipeline)global_unique_handle++;
+        keys[i] = GetComputePipelineKey(pCreateInfos[i]);
+        pipelines[i].program = TranslateShaderStage(pCreateInfos[i].stage, SPIRV_EXECUTION_MODEL_GL_COMPUTE);
+    }
+    for (uint32_t i = 0; i < createInfoCount; ++i) {
+        pPipelines[i] = CreatePipeline(pipelineCache, keys[i], pCreateInfos[i].pNext, std::move(pipelines[i]));
     }
     return VK_SUCCESS;
 }
@@ -962,7 +5568,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyPipeline(
     VkPipeline                                  pipeline,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyPipeline, 0, device, pipeline);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkPipeline, pipeline != VK_NULL_HANDLE);
+    pipeline_table.Destroy(pipeline);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreatePipelineLayout(
@@ -971,8 +5579,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreatePipelineLayout(
     const VkAllocationCallbacks*                pAllocator,
     VkPipelineLayout*                           pPipelineLayout)
 {
-    unique_lock_t lock(global_lock);
-    *pPipelineLayout = (VkPipelineLayout)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreatePipelineLayout, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkPipelineLayout, 1);
+    *pPipelineLayout = (VkPipelineLayout)pipeline_layout_table.Create();
     return VK_SUCCESS;
 }
 
@@ -981,7 +5590,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyPipelineLayout(
     VkPipelineLayout                            pipelineLayout,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyPipelineLayout, 0, device, pipelineLayout);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkPipelineLayout, pipelineLayout != VK_NULL_HANDLE);
+    pipeline_layout_table.Destroy(pipelineLayout);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateSampler(
@@ -990,8 +5601,11 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateSampler(
     const VkAllocationCallbacks*                pAllocator,
     VkSampler*                                  pSampler)
 {
-    unique_lock_t lock(global_lock);
-    *pSampler = (VkSampler)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateSampler, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSampler, 1);
+    Sampler sampler = {*pCreateInfo};
+    sampler.create_info.pNext = nullptr;
+    *pSampler = (VkSampler)sampler_table.Create(sampler);
     return VK_SUCCESS;
 }
 
@@ -1000,7 +5614,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroySampler(
     VkSampler                                   sampler,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroySampler, 0, device, sampler);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkSampler, sampler != VK_NULL_HANDLE);
+    sampler_table.Destroy(sampler);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateDescriptorSetLayout(
@@ -1009,8 +5625,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateDescriptorSetLayout(
     const VkAllocationCallbacks*                pAllocator,
     VkDescriptorSetLayout*                      pSetLayout)
 {
-    unique_lock_t lock(global_lock);
-    *pSetLayout = (VkDescriptorSetLayout)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateDescriptorSetLayout, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkDescriptorSetLayout, 1);
+    *pSetLayout = (VkDescriptorSetLayout)descriptor_set_layout_table.Create(CreateDescriptorSetLayoutState(*pCreateInfo));
     return VK_SUCCESS;
 }
 
@@ -1019,7 +5636,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyDescriptorSetLayout(
     VkDescriptorSetLayout                       descriptorSetLayout,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyDescriptorSetLayout, 0, device, descriptorSetLayout);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkDescriptorSetLayout, descriptorSetLayout != VK_NULL_HANDLE);
+    descriptor_set_layout_table.Destroy(descriptorSetLayout);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateDescriptorPool(
@@ -1028,8 +5647,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateDescriptorPool(
     const VkAllocationCallbacks*                pAllocator,
     VkDescriptorPool*                           pDescriptorPool)
 {
-    unique_lock_t lock(global_lock);
-    *pDescriptorPool = (VkDescriptorPool)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateDescriptorPool, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkDescriptorPool, 1);
+    *pDescriptorPool = (VkDescriptorPool)descriptor_pool_table.Create(CreateDescriptorPoolState(*pCreateInfo));
     return VK_SUCCESS;
 }
 
@@ -1038,7 +5658,11 @@ static VKAPI_ATTR void VKAPI_CALL DestroyDescriptorPool(
     VkDescriptorPool                            descriptorPool,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyDescriptorPool, 0, device, descriptorPool);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkDescriptorPool, descriptorPool != VK_NULL_HANDLE);
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->descriptor_lock);
+    if (DescriptorPool* pool = descriptor_pool_table.Get(descriptorPool)) FreeDescriptorPoolSets(pool);
+    descriptor_pool_table.Destroy(descriptorPool);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL ResetDescriptorPool(
@@ -1046,7 +5670,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL ResetDescriptorPool(
     VkDescriptorPool                            descriptorPool,
     VkDescriptorPoolResetFlags                  flags)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkResetDescriptorPool, 0, device, descriptorPool);
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->descriptor_lock);
+    if (DescriptorPool* pool = descriptor_pool_table.Get(descriptorPool)) FreeDescriptorPoolSets(pool);
     return VK_SUCCESS;
 }
 
@@ -1055,9 +5681,33 @@ static VKAPI_ATTR VkResult VKAPI_CALL AllocateDescriptorSets(
     const VkDescriptorSetAllocateInfo*          pAllocateInfo,
     VkDescriptorSet*                            pDescriptorSets)
 {
-    unique_lock_t lock(global_lock);
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkAllocateDescriptorSets, pAllocateInfo->descriptorSetCount, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkDescriptorSet, pAllocateInfo->descriptorSetCount);
+    // Sets allocated with layouts the mock does not know hold no descriptors
+    static const std::shared_ptr<const DescriptorSetLayout> empty_layout(new DescriptorSetLayout());
+    const auto variable_info = lvl_find_in_chain<VkDescriptorSetVariableDescriptorCountAllocateInfo>(pAllocateInfo->pNext);
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->descriptor_lock);
+    DescriptorPool* pool = descriptor_pool_table.Get(pAllocateInfo->descriptorPool);
     for (uint32_t i = 0; i < pAllocateInfo->descriptorSetCount; ++i) {
-        pDescriptorSets[i] = (VkDescriptorSet)global_unique_handle++;
+        const auto layout = descriptor_set_layout_table.Get(pAllocateInfo->pSetLayouts[i]);
+        DescriptorSet set;
+        set.pool = pAllocateInfo->descriptorPool;
+        set.pool_index = pool ? pool->sets.size() : 0;
+        set.layout = layout ? *layout : empty_layout;
+        if (variable_info && i < variable_info->descriptorSetCount) set.variable_count = variable_info->pDescriptorCounts[i];
+        const VkResult result = pool ? AllocateDescriptors(pool, &set) : VK_ERROR_OUT_OF_POOL_MEMORY;
+        if (result != VK_SUCCESS) {
+            // Nothing is allocated when a set fails. The sets are freed last first, which gives each its descriptors
+            // back where it took them and leaves the pool as the call found it.
+            for (uint32_t j = i; j-- > 0;) FreeDescriptorSet(pDescriptorSets[j]);
+            std::fill(pDescriptorSets, pDescriptorSets + pAllocateInfo->descriptorSetCount, (VkDescriptorSet)VK_NULL_HANDLE);
+            lock.unlock();
+            entrypoint_scope.CountDestroyed(STATS_OBJECT_VkDescriptorSet, pAllocateInfo->descriptorSetCount);
+            AddStat(result == VK_ERROR_FRAGMENTED_POOL ? STATS_DESCRIPTOR_POOLS_FRAGMENTED : STATS_DESCRIPTOR_POOLS_EXHAUSTED, 1);
+            return result;
+        }
+        pDescriptorSets[i] = (VkDescriptorSet)descriptor_set_table.Create(std::move(set));
+        pool->sets.push_back(pDescriptorSets[i]);
     }
     return VK_SUCCESS;
 }
@@ -1068,7 +5718,10 @@ static VKAPI_ATTR VkResult VKAPI_CALL FreeDescriptorSets(
     uint32_t                                    descriptorSetCount,
     const VkDescriptorSet*                      pDescriptorSets)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkFreeDescriptorSets, descriptorSetCount, device, descriptorPool);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkDescriptorSet, pDescriptorSets, descriptorSetCount);
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->descriptor_lock);
+    for (uint32_t i = 0; i < descriptorSetCount; ++i) FreeDescriptorSet(pDescriptorSets[i]);
     return VK_SUCCESS;
 }
 
@@ -1079,7 +5732,12 @@ static VKAPI_ATTR void VKAPI_CALL UpdateDescriptorSets(
     uint32_t                                    descriptorCopyCount,
     const VkCopyDescriptorSet*                  pDescriptorCopies)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkUpdateDescriptorSets, descriptorWriteCount + descriptorCopyCount, device);
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->descriptor_lock);
+    for (uint32_t i = 0; i < descriptorWriteCount; ++i) {
+        if (DescriptorSet* set = descriptor_set_table.Get(pDescriptorWrites[i].dstSet)) WriteDescriptors(set, pDescriptorWrites[i]);
+    }
+    for (uint32_t i = 0; i < descriptorCopyCount; ++i) CopyDescriptors(pDescriptorCopies[i]);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateFramebuffer(
@@ -1088,8 +5746,13 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateFramebuffer(
     const VkAllocationCallbacks*                pAllocator,
     VkFramebuffer*                              pFramebuffer)
 {
-    unique_lock_t lock(global_lock);
-    *pFramebuffer = (VkFramebuffer)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateFramebuffer, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkFramebuffer, 1);
+    Framebuffer framebuffer = {{}, pCreateInfo->width, pCreateInfo->height, pCreateInfo->layers};
+    if (!(pCreateInfo->flags & VK_FRAMEBUFFER_CREATE_IMAGELESS_BIT)) {
+        framebuffer.attachments.assign(pCreateInfo->pAttachments, pCreateInfo->pAttachments + pCreateInfo->attachmentCount);
+    }
+    *pFramebuffer = (VkFramebuffer)framebuffer_table.Create(framebuffer);
     return VK_SUCCESS;
 }
 
@@ -1098,7 +5761,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyFramebuffer(
     VkFramebuffer                               framebuffer,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyFramebuffer, 0, device, framebuffer);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkFramebuffer, framebuffer != VK_NULL_HANDLE);
+    framebuffer_table.Destroy(framebuffer);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateRenderPass(
@@ -1107,8 +5772,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateRenderPass(
     const VkAllocationCallbacks*                pAllocator,
     VkRenderPass*                               pRenderPass)
 {
-    unique_lock_t lock(global_lock);
-    *pRenderPass = (VkRenderPass)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateRenderPass, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkRenderPass, 1);
+    *pRenderPass = (VkRenderPass)render_pass_table.Create(CreateRenderPassState(*pCreateInfo));
     return VK_SUCCESS;
 }
 
@@ -1117,7 +5783,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyRenderPass(
     VkRenderPass                                renderPass,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyRenderPass, 0, device, renderPass);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkRenderPass, renderPass != VK_NULL_HANDLE);
+    render_pass_table.Destroy(renderPass);
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetRenderAreaGranularity(
@@ -1125,6 +5793,7 @@ static VKAPI_ATTR void VKAPI_CALL GetRenderAreaGranularity(
     VkRenderPass                                renderPass,
     VkExtent2D*                                 pGranularity)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetRenderAreaGranularity, 0, device, renderPass);
 //Not a CREATE or DESTROY function
 }
 
@@ -1134,8 +5803,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateCommandPool(
     const VkAllocationCallbacks*                pAllocator,
     VkCommandPool*                              pCommandPool)
 {
-    unique_lock_t lock(global_lock);
-    *pCommandPool = (VkCommandPool)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateCommandPool, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkCommandPool, 1);
+    *pCommandPool = (VkCommandPool)command_pool_table.Create();
     return VK_SUCCESS;
 }
 
@@ -1144,7 +5814,10 @@ static VKAPI_ATTR void VKAPI_CALL DestroyCommandPool(
     VkCommandPool                               commandPool,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyCommandPool, 0, device, commandPool);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkCommandPool, commandPool != VK_NULL_HANDLE);
+    // Frees every command buffer still allocated from the pool
+    command_pool_table.Destroy(commandPool);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL ResetCommandPool(
@@ -1152,7 +5825,13 @@ static VKAPI_ATTR VkResult VKAPI_CALL ResetCommandPool(
     VkCommandPool                               commandPool,
     VkCommandPoolResetFlags                     flags)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkResetCommandPool, 0, device, commandPool);
+    auto pool = GetCommandPool(commandPool);
+    if (!pool) return VK_SUCCESS;
+    // Invalidates the streams of all command buffers at once, they notice the new epoch when next reset
+    pool->reset_epoch++;
+    pool->next_unused_chunk = 0;
+    pool->free_chunks = nullptr;
     return VK_SUCCESS;
 }
 
@@ -1161,9 +5840,16 @@ static VKAPI_ATTR VkResult VKAPI_CALL AllocateCommandBuffers(
     const VkCommandBufferAllocateInfo*          pAllocateInfo,
     VkCommandBuffer*                            pCommandBuffers)
 {
-    unique_lock_t lock(global_lock);
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkAllocateCommandBuffers, pAllocateInfo->commandBufferCount, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkCommandBuffer, pAllocateInfo->commandBufferCount);
+    auto pool = GetCommandPool(pAllocateInfo->commandPool);
+    if (!pool) return VK_ERROR_OUT_OF_HOST_MEMORY;
     for (uint32_t i = 0; i < pAllocateInfo->commandBufferCount; ++i) {
-        pCommandBuffers[i] = (VkCommandBuffer)CreateDispObjHandle();
+        auto command_buffer = pool->command_buffers.Allocate();
+        set_loader_magic_value(&command_buffer->loader_data);
+        command_buffer->pool = pool;
+        ResetCommandStream(command_buffer);
+        pCommandBuffers[i] = reinterpret_cast<VkCommandBuffer>(command_buffer);
     }
     return VK_SUCCESS;
 }
@@ -1174,39 +5860,80 @@ static VKAPI_ATTR void VKAPI_CALL FreeCommandBuffers(
     uint32_t                                    commandBufferCount,
     const VkCommandBuffer*                      pCommandBuffers)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkFreeCommandBuffers, commandBufferCount, device, commandPool);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkCommandBuffer, pCommandBuffers, commandBufferCount);
+    auto pool = GetCommandPool(commandPool);
+    if (!pool) return;
+    for (uint32_t i = 0; i < commandBufferCount; ++i) {
+        if (!pCommandBuffers[i]) continue;
+        auto command_buffer = reinterpret_cast<CommandBuffer*>(pCommandBuffers[i]);
+        ResetCommandStream(command_buffer);
+        pool->command_buffers.Free(command_buffer);
+    }
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL BeginCommandBuffer(
     VkCommandBuffer                             commandBuffer,
     const VkCommandBufferBeginInfo*             pBeginInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkBeginCommandBuffer, 0, commandBuffer);
+    ResetCommandStream(reinterpret_cast<CommandBuffer*>(commandBuffer));
     return VK_SUCCESS;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL EndCommandBuffer(
     VkCommandBuffer                             commandBuffer)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkEndCommandBuffer, 0, commandBuffer);
+    return reinterpret_cast<CommandBuffer*>(commandBuffer)->result;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL ResetCommandBuffer(
     VkCommandBuffer                             commandBuffer,
     VkCommandBufferResetFlags                   flags)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkResetCommandBuffer, 0, commandBuffer);
+    ResetCommandStream(reinterpret_cast<CommandBuffer*>(commandBuffer));
     return VK_SUCCESS;
 }
 
+struct CmdBindPipelineRecord {
+    static const CommandInfo info;
+    VkPipelineBindPoint pipelineBindPoint;
+    VkPipeline pipeline;
+};
+static void ExecuteCmdBindPipeline(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdBindPipelineRecord*>(data);
+    const Pipeline* pipeline = pipeline_table.Get(record.pipeline);
+    if (record.pipelineBindPoint == VK_PIPELINE_BIND_POINT_COMPUTE) context->compute.program = pipeline ? pipeline->program : nullptr;
+    if (record.pipelineBindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS) context->draw.pipeline = pipeline ? pipeline->raster : nullptr;
+}
+const CommandInfo CmdBindPipelineRecord::info = {"vkCmdBindPipeline", ExecuteCmdBindPipeline};
+
 static VKAPI_ATTR void VKAPI_CALL CmdBindPipeline(
     VkCommandBuffer                             commandBuffer,
     VkPipelineBindPoint                         pipelineBindPoint,
     VkPipeline                                  pipeline)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBindPipeline, 0, commandBuffer, pipeline);
+    auto record = RecordCommand<CmdBindPipelineRecord>(commandBuffer);
+    if (!record) return;
+    record->pipelineBindPoint = pipelineBindPoint;
+    record->pipeline = pipeline;
+}
+
+struct CmdSetViewportRecord {
+    static const CommandInfo info;
+    uint32_t firstViewport;
+    uint32_t viewportCount;
+    const VkViewport* pViewports;
+};
+
+static void ExecuteCmdSetViewport(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdSetViewportRecord*>(data);
+    if (record.firstViewport == 0 && record.viewportCount > 0) context->draw.viewport = record.pViewports[0];
 }
+const CommandInfo CmdSetViewportRecord::info = {"vkCmdSetViewport", ExecuteCmdSetViewport};
 
 static VKAPI_ATTR void VKAPI_CALL CmdSetViewport(
     VkCommandBuffer                             commandBuffer,
@@ -1214,8 +5941,29 @@ static VKAPI_ATTR void VKAPI_CALL CmdSetViewport(
     uint32_t                                    viewportCount,
     const VkViewport*                           pViewports)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetViewport, viewportCount, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdSetViewportRecord>(commandBuffer, CommandArraySize(pViewports, viewportCount) + CommandNestedSize(pViewports, viewportCount), &storage);
+    if (!record) return;
+    record->firstViewport = firstViewport;
+    record->viewportCount = viewportCount;
+    auto pViewports_copy = CopyCommandArray(&storage, pViewports, viewportCount);
+    CopyCommandNested(&storage, pViewports_copy, viewportCount);
+    record->pViewports = pViewports_copy;
+}
+
+struct CmdSetScissorRecord {
+    static const CommandInfo info;
+    uint32_t firstScissor;
+    uint32_t scissorCount;
+    const VkRect2D* pScissors;
+};
+
+static void ExecuteCmdSetScissor(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdSetScissorRecord*>(data);
+    if (record.firstScissor == 0 && record.scissorCount > 0) context->draw.scissor = record.pScissors[0];
 }
+const CommandInfo CmdSetScissorRecord::info = {"vkCmdSetScissor", ExecuteCmdSetScissor};
 
 static VKAPI_ATTR void VKAPI_CALL CmdSetScissor(
     VkCommandBuffer                             commandBuffer,
@@ -1223,63 +5971,170 @@ static VKAPI_ATTR void VKAPI_CALL CmdSetScissor(
     uint32_t                                    scissorCount,
     const VkRect2D*                             pScissors)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetScissor, scissorCount, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdSetScissorRecord>(commandBuffer, CommandArraySize(pScissors, scissorCount) + CommandNestedSize(pScissors, scissorCount), &storage);
+    if (!record) return;
+    record->firstScissor = firstScissor;
+    record->scissorCount = scissorCount;
+    auto pScissors_copy = CopyCommandArray(&storage, pScissors, scissorCount);
+    CopyCommandNested(&storage, pScissors_copy, scissorCount);
+    record->pScissors = pScissors_copy;
 }
 
+struct CmdSetLineWidthRecord {
+    static const CommandInfo info;
+    float lineWidth;
+};
+const CommandInfo CmdSetLineWidthRecord::info = {"vkCmdSetLineWidth", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdSetLineWidth(
     VkCommandBuffer                             commandBuffer,
     float                                       lineWidth)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetLineWidth, 0, commandBuffer);
+    auto record = RecordCommand<CmdSetLineWidthRecord>(commandBuffer);
+    if (!record) return;
+    record->lineWidth = lineWidth;
 }
 
+struct CmdSetDepthBiasRecord {
+    static const CommandInfo info;
+    float depthBiasConstantFactor;
+    float depthBiasClamp;
+    float depthBiasSlopeFactor;
+};
+const CommandInfo CmdSetDepthBiasRecord::info = {"vkCmdSetDepthBias", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdSetDepthBias(
     VkCommandBuffer                             commandBuffer,
     float                                       depthBiasConstantFactor,
     float                                       depthBiasClamp,
     float                                       depthBiasSlopeFactor)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetDepthBias, 0, commandBuffer);
+    auto record = RecordCommand<CmdSetDepthBiasRecord>(commandBuffer);
+    if (!record) return;
+    record->depthBiasConstantFactor = depthBiasConstantFactor;
+    record->depthBiasClamp = depthBiasClamp;
+    record->depthBiasSlopeFactor = depthBiasSlopeFactor;
+}
+
+struct CmdSetBlendConstantsRecord {
+    static const CommandInfo info;
+    float blendConstants[4];
+};
+
+static void ExecuteCmdSetBlendConstants(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdSetBlendConstantsRecord*>(data);
+    memcpy(context->draw.blend_constants, record.blendConstants, sizeof(record.blendConstants));
 }
+const CommandInfo CmdSetBlendConstantsRecord::info = {"vkCmdSetBlendConstants", ExecuteCmdSetBlendConstants};
 
 static VKAPI_ATTR void VKAPI_CALL CmdSetBlendConstants(
     VkCommandBuffer                             commandBuffer,
     const float                                 blendConstants[4])
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetBlendConstants, 0, commandBuffer);
+    auto record = RecordCommand<CmdSetBlendConstantsRecord>(commandBuffer);
+    if (!record) return;
+    memcpy(record->blendConstants, blendConstants, sizeof(record->blendConstants));
 }
 
+struct CmdSetDepthBoundsRecord {
+    static const CommandInfo info;
+    float minDepthBounds;
+    float maxDepthBounds;
+};
+const CommandInfo CmdSetDepthBoundsRecord::info = {"vkCmdSetDepthBounds", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdSetDepthBounds(
     VkCommandBuffer                             commandBuffer,
     float                                       minDepthBounds,
     float                                       maxDepthBounds)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetDepthBounds, 0, commandBuffer);
+    auto record = RecordCommand<CmdSetDepthBoundsRecord>(commandBuffer);
+    if (!record) return;
+    record->minDepthBounds = minDepthBounds;
+    record->maxDepthBounds = maxDepthBounds;
 }
 
+struct CmdSetStencilCompareMaskRecord {
+    static const CommandInfo info;
+    VkStencilFaceFlags faceMask;
+    uint32_t compareMask;
+};
+const CommandInfo CmdSetStencilCompareMaskRecord::info = {"vkCmdSetStencilCompareMask", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdSetStencilCompareMask(
     VkCommandBuffer                             commandBuffer,
     VkStencilFaceFlags                          faceMask,
     uint32_t                                    compareMask)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetStencilCompareMask, 0, commandBuffer);
+    auto record = RecordCommand<CmdSetStencilCompareMaskRecord>(commandBuffer);
+    if (!record) return;
+    record->faceMask = faceMask;
+    record->compareMask = compareMask;
 }
 
+struct CmdSetStencilWriteMaskRecord {
+    static const CommandInfo info;
+    VkStencilFaceFlags faceMask;
+    uint32_t writeMask;
+};
+const CommandInfo CmdSetStencilWriteMaskRecord::info = {"vkCmdSetStencilWriteMask", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdSetStencilWriteMask(
     VkCommandBuffer                             commandBuffer,
     VkStencilFaceFlags                          faceMask,
     uint32_t                                    writeMask)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetStencilWriteMask, 0, commandBuffer);
+    auto record = RecordCommand<CmdSetStencilWriteMaskRecord>(commandBuffer);
+    if (!record) return;
+    record->faceMask = faceMask;
+    record->writeMask = writeMask;
 }
 
+struct CmdSetStencilReferenceRecord {
+    static const CommandInfo info;
+    VkStencilFaceFlags faceMask;
+    uint32_t reference;
+};
+const CommandInfo CmdSetStencilReferenceRecord::info = {"vkCmdSetStencilReference", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdSetStencilReference(
     VkCommandBuffer                             commandBuffer,
     VkStencilFaceFlags                          faceMask,
     uint32_t                                    reference)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetStencilReference, 0, commandBuffer);
+    auto record = RecordCommand<CmdSetStencilReferenceRecord>(commandBuffer);
+    if (!record) return;
+    record->faceMask = faceMask;
+    record->reference = reference;
+}
+
+struct CmdBindDescriptorSetsRecord {
+    static const CommandInfo info;
+    VkPipelineBindPoint pipelineBindPoint;
+    VkPipelineLayout layout;
+    uint32_t firstSet;
+    uint32_t descriptorSetCount;
+    const VkDescriptorSet* pDescriptorSets;
+    uint32_t dynamicOffsetCount;
+    const uint32_t* pDynamicOffsets;
+};
+static void ExecuteCmdBindDescriptorSets(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdBindDescriptorSetsRecord*>(data);
+    BindPointState* state = GetBindPointState(context, record.pipelineBindPoint);
+    if (!state) return;
+    ExecuteBindDescriptorSets(state, record.firstSet, record.descriptorSetCount, record.pDescriptorSets, record.dynamicOffsetCount,
+                              record.pDynamicOffsets);
+}
+const CommandInfo CmdBindDescriptorSetsRecord::info = {"vkCmdBindDescriptorSets", ExecuteCmdBindDescriptorSets};
 
 static VKAPI_ATTR void VKAPI_CALL CmdBindDescriptorSets(
     VkCommandBuffer                             commandBuffer,
@@ -1291,8 +6146,33 @@ static VKAPI_ATTR void VKAPI_CALL CmdBindDescriptorSets(
     uint32_t                                    dynamicOffsetCount,
     const uint32_t*                             pDynamicOffsets)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBindDescriptorSets, descriptorSetCount + dynamicOffsetCount, commandBuffer, layout);
+    char* storage;
+    auto record = RecordCommand<CmdBindDescriptorSetsRecord>(commandBuffer, CommandArraySize(pDescriptorSets, descriptorSetCount) + CommandArraySize(pDynamicOffsets, dynamicOffsetCount), &storage);
+    if (!record) return;
+    record->pipelineBindPoint = pipelineBindPoint;
+    record->layout = layout;
+    record->firstSet = firstSet;
+    record->descriptorSetCount = descriptorSetCount;
+    record->pDescriptorSets = CopyCommandArray(&storage, pDescriptorSets, descriptorSetCount);
+    record->dynamicOffsetCount = dynamicOffsetCount;
+    record->pDynamicOffsets = CopyCommandArray(&storage, pDynamicOffsets, dynamicOffsetCount);
+}
+
+struct CmdBindIndexBufferRecord {
+    static const CommandInfo info;
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    VkIndexType indexType;
+};
+
+static void ExecuteCmdBindIndexBuffer(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdBindIndexBufferRecord*>(data);
+    context->draw.index_buffer = record.buffer;
+    context->draw.index_offset = record.offset;
+    context->draw.index_type = record.indexType;
+}
+const CommandInfo CmdBindIndexBufferRecord::info = {"vkCmdBindIndexBuffer", ExecuteCmdBindIndexBuffer};
 
 static VKAPI_ATTR void VKAPI_CALL CmdBindIndexBuffer(
     VkCommandBuffer                             commandBuffer,
@@ -1300,8 +6180,30 @@ static VKAPI_ATTR void VKAPI_CALL CmdBindIndexBuffer(
     VkDeviceSize                                offset,
     VkIndexType                                 indexType)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBindIndexBuffer, 0, commandBuffer, buffer);
+    auto record = RecordCommand<CmdBindIndexBufferRecord>(commandBuffer);
+    if (!record) return;
+    record->buffer = buffer;
+    record->offset = offset;
+    record->indexType = indexType;
+}
+
+struct CmdBindVertexBuffersRecord {
+    static const CommandInfo info;
+    uint32_t firstBinding;
+    uint32_t bindingCount;
+    const VkBuffer* pBuffers;
+    const VkDeviceSize* pOffsets;
+};
+
+static void ExecuteCmdBindVertexBuffers(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdBindVertexBuffersRecord*>(data);
+    for (uint32_t i = 0; i < record.bindingCount && record.firstBinding + i < MAX_BOUND_VERTEX_BUFFERS; ++i) {
+        context->draw.vertex_buffers[record.firstBinding + i] = record.pBuffers[i];
+        context->draw.vertex_offsets[record.firstBinding + i] = record.pOffsets[i];
+    }
 }
+const CommandInfo CmdBindVertexBuffersRecord::info = {"vkCmdBindVertexBuffers", ExecuteCmdBindVertexBuffers};
 
 static VKAPI_ATTR void VKAPI_CALL CmdBindVertexBuffers(
     VkCommandBuffer                             commandBuffer,
@@ -1310,8 +6212,32 @@ static VKAPI_ATTR void VKAPI_CALL CmdBindVertexBuffers(
     const VkBuffer*                             pBuffers,
     const VkDeviceSize*                         pOffsets)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBindVertexBuffers, bindingCount, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdBindVertexBuffersRecord>(commandBuffer, CommandArraySize(pBuffers, bindingCount) + CommandArraySize(pOffsets, bindingCount) + CommandNestedSize(pOffsets, bindingCount), &storage);
+    if (!record) return;
+    record->firstBinding = firstBinding;
+    record->bindingCount = bindingCount;
+    record->pBuffers = CopyCommandArray(&storage, pBuffers, bindingCount);
+    auto pOffsets_copy = CopyCommandArray(&storage, pOffsets, bindingCount);
+    CopyCommandNested(&storage, pOffsets_copy, bindingCount);
+    record->pOffsets = pOffsets_copy;
+}
+
+struct CmdDrawRecord {
+    static const CommandInfo info;
+    uint32_t vertexCount;
+    uint32_t instanceCount;
+    uint32_t firstVertex;
+    uint32_t firstInstance;
+};
+
+static void ExecuteCmdDraw(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdDrawRecord*>(data);
+    ExecuteDraw(context, record.vertexCount, record.instanceCount);
+    RasterizeDraw(context, false, record.vertexCount, record.instanceCount, record.firstVertex, 0, record.firstInstance, 0);
+}
+const CommandInfo CmdDrawRecord::info = {"vkCmdDraw", ExecuteCmdDraw};
 
 static VKAPI_ATTR void VKAPI_CALL CmdDraw(
     VkCommandBuffer                             commandBuffer,
@@ -1320,8 +6246,30 @@ static VKAPI_ATTR void VKAPI_CALL CmdDraw(
     uint32_t                                    firstVertex,
     uint32_t                                    firstInstance)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDraw, 0, commandBuffer);
+    auto record = RecordCommand<CmdDrawRecord>(commandBuffer);
+    if (!record) return;
+    record->vertexCount = vertexCount;
+    record->instanceCount = instanceCount;
+    record->firstVertex = firstVertex;
+    record->firstInstance = firstInstance;
+}
+
+struct CmdDrawIndexedRecord {
+    static const CommandInfo info;
+    uint32_t indexCount;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    uint32_t firstInstance;
+};
+
+static void ExecuteCmdDrawIndexed(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdDrawIndexedRecord*>(data);
+    ExecuteDraw(context, record.indexCount, record.instanceCount);
+    RasterizeDraw(context, true, record.indexCount, record.instanceCount, record.firstIndex, record.vertexOffset, record.firstInstance, 0);
 }
+const CommandInfo CmdDrawIndexedRecord::info = {"vkCmdDrawIndexed", ExecuteCmdDrawIndexed};
 
 static VKAPI_ATTR void VKAPI_CALL CmdDrawIndexed(
     VkCommandBuffer                             commandBuffer,
@@ -1331,8 +6279,30 @@ static VKAPI_ATTR void VKAPI_CALL CmdDrawIndexed(
     int32_t                                     vertexOffset,
     uint32_t                                    firstInstance)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDrawIndexed, 0, commandBuffer);
+    auto record = RecordCommand<CmdDrawIndexedRecord>(commandBuffer);
+    if (!record) return;
+    record->indexCount = indexCount;
+    record->instanceCount = instanceCount;
+    record->firstIndex = firstIndex;
+    record->vertexOffset = vertexOffset;
+    record->firstInstance = firstInstance;
+}
+
+struct CmdDrawIndirectRecord {
+    static const CommandInfo info;
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    uint32_t drawCount;
+    uint32_t stride;
+};
+
+static void ExecuteCmdDrawIndirect(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdDrawIndirectRecord*>(data);
+    ExecuteDraw(context, 3, record.drawCount);
+    RasterizeIndirectDraws(context, false, record.buffer, record.offset, record.drawCount, record.stride, VK_NULL_HANDLE, 0);
 }
+const CommandInfo CmdDrawIndirectRecord::info = {"vkCmdDrawIndirect", ExecuteCmdDrawIndirect};
 
 static VKAPI_ATTR void VKAPI_CALL CmdDrawIndirect(
     VkCommandBuffer                             commandBuffer,
@@ -1341,8 +6311,29 @@ static VKAPI_ATTR void VKAPI_CALL CmdDrawIndirect(
     uint32_t                                    drawCount,
     uint32_t                                    stride)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDrawIndirect, 0, commandBuffer, buffer);
+    auto record = RecordCommand<CmdDrawIndirectRecord>(commandBuffer);
+    if (!record) return;
+    record->buffer = buffer;
+    record->offset = offset;
+    record->drawCount = drawCount;
+    record->stride = stride;
+}
+
+struct CmdDrawIndexedIndirectRecord {
+    static const CommandInfo info;
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    uint32_t drawCount;
+    uint32_t stride;
+};
+
+static void ExecuteCmdDrawIndexedIndirect(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdDrawIndexedIndirectRecord*>(data);
+    ExecuteDraw(context, 3, record.drawCount);
+    RasterizeIndirectDraws(context, true, record.buffer, record.offset, record.drawCount, record.stride, VK_NULL_HANDLE, 0);
 }
+const CommandInfo CmdDrawIndexedIndirectRecord::info = {"vkCmdDrawIndexedIndirect", ExecuteCmdDrawIndexedIndirect};
 
 static VKAPI_ATTR void VKAPI_CALL CmdDrawIndexedIndirect(
     VkCommandBuffer                             commandBuffer,
@@ -1351,8 +6342,29 @@ static VKAPI_ATTR void VKAPI_CALL CmdDrawIndexedIndirect(
     uint32_t                                    drawCount,
     uint32_t                                    stride)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDrawIndexedIndirect, 0, commandBuffer, buffer);
+    auto record = RecordCommand<CmdDrawIndexedIndirectRecord>(commandBuffer);
+    if (!record) return;
+    record->buffer = buffer;
+    record->offset = offset;
+    record->drawCount = drawCount;
+    record->stride = stride;
+}
+
+struct CmdDispatchRecord {
+    static const CommandInfo info;
+    uint32_t groupCountX;
+    uint32_t groupCountY;
+    uint32_t groupCountZ;
+};
+
+static void ExecuteCmdDispatch(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdDispatchRecord*>(data);
+    const uint32_t base[3] = {0, 0, 0};
+    const uint32_t group_count[3] = {record.groupCountX, record.groupCountY, record.groupCountZ};
+    ExecuteDispatch(context, base, group_count);
 }
+const CommandInfo CmdDispatchRecord::info = {"vkCmdDispatch", ExecuteCmdDispatch};
 
 static VKAPI_ATTR void VKAPI_CALL CmdDispatch(
     VkCommandBuffer                             commandBuffer,
@@ -1360,16 +6372,51 @@ static VKAPI_ATTR void VKAPI_CALL CmdDispatch(
     uint32_t                                    groupCountY,
     uint32_t                                    groupCountZ)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDispatch, 0, commandBuffer);
+    auto record = RecordCommand<CmdDispatchRecord>(commandBuffer);
+    if (!record) return;
+    record->groupCountX = groupCountX;
+    record->groupCountY = groupCountY;
+    record->groupCountZ = groupCountZ;
+}
+
+struct CmdDispatchIndirectRecord {
+    static const CommandInfo info;
+    VkBuffer buffer;
+    VkDeviceSize offset;
+};
+
+static void ExecuteCmdDispatchIndirect(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdDispatchIndirectRecord*>(data);
+    ExecuteDispatchIndirect(context, record.buffer, record.offset);
 }
+const CommandInfo CmdDispatchIndirectRecord::info = {"vkCmdDispatchIndirect", ExecuteCmdDispatchIndirect};
 
 static VKAPI_ATTR void VKAPI_CALL CmdDispatchIndirect(
     VkCommandBuffer                             commandBuffer,
     VkBuffer                                    buffer,
     VkDeviceSize                                offset)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDispatchIndirect, 0, commandBuffer, buffer);
+    auto record = RecordCommand<CmdDispatchIndirectRecord>(commandBuffer);
+    if (!record) return;
+    record->buffer = buffer;
+    record->offset = offset;
+}
+
+struct CmdCopyBufferRecord {
+    static const CommandInfo info;
+    VkBuffer srcBuffer;
+    VkBuffer dstBuffer;
+    uint32_t regionCount;
+    const VkBufferCopy* pRegions;
+};
+
+static void ExecuteCmdCopyBuffer(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdCopyBufferRecord*>(data);
+    ExecuteCopyBuffer(context, record.srcBuffer, record.dstBuffer, record.regionCount, record.pRegions);
 }
+const CommandInfo CmdCopyBufferRecord::info = {"vkCmdCopyBuffer", ExecuteCmdCopyBuffer};
 
 static VKAPI_ATTR void VKAPI_CALL CmdCopyBuffer(
     VkCommandBuffer                             commandBuffer,
@@ -1378,8 +6425,33 @@ static VKAPI_ATTR void VKAPI_CALL CmdCopyBuffer(
     uint32_t                                    regionCount,
     const VkBufferCopy*                         pRegions)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdCopyBuffer, regionCount, commandBuffer, srcBuffer, dstBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdCopyBufferRecord>(commandBuffer, CommandArraySize(pRegions, regionCount) + CommandNestedSize(pRegions, regionCount), &storage);
+    if (!record) return;
+    record->srcBuffer = srcBuffer;
+    record->dstBuffer = dstBuffer;
+    record->regionCount = regionCount;
+    auto pRegions_copy = CopyCommandArray(&storage, pRegions, regionCount);
+    CopyCommandNested(&storage, pRegions_copy, regionCount);
+    record->pRegions = pRegions_copy;
+}
+
+struct CmdCopyImageRecord {
+    static const CommandInfo info;
+    VkImage srcImage;
+    VkImageLayout srcImageLayout;
+    VkImage dstImage;
+    VkImageLayout dstImageLayout;
+    uint32_t regionCount;
+    const VkImageCopy* pRegions;
+};
+
+static void ExecuteCmdCopyImage(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdCopyImageRecord*>(data);
+    ExecuteCopyImage(context, record.srcImage, record.dstImage, record.regionCount, record.pRegions);
+}
+const CommandInfo CmdCopyImageRecord::info = {"vkCmdCopyImage", ExecuteCmdCopyImage};
 
 static VKAPI_ATTR void VKAPI_CALL CmdCopyImage(
     VkCommandBuffer                             commandBuffer,
@@ -1390,8 +6462,36 @@ static VKAPI_ATTR void VKAPI_CALL CmdCopyImage(
     uint32_t                                    regionCount,
     const VkImageCopy*                          pRegions)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdCopyImage, regionCount, commandBuffer, srcImage, dstImage);
+    char* storage;
+    auto record = RecordCommand<CmdCopyImageRecord>(commandBuffer, CommandArraySize(pRegions, regionCount) + CommandNestedSize(pRegions, regionCount), &storage);
+    if (!record) return;
+    record->srcImage = srcImage;
+    record->srcImageLayout = srcImageLayout;
+    record->dstImage = dstImage;
+    record->dstImageLayout = dstImageLayout;
+    record->regionCount = regionCount;
+    auto pRegions_copy = CopyCommandArray(&storage, pRegions, regionCount);
+    CopyCommandNested(&storage, pRegions_copy, regionCount);
+    record->pRegions = pRegions_copy;
+}
+
+struct CmdBlitImageRecord {
+    static const CommandInfo info;
+    VkImage srcImage;
+    VkImageLayout srcImageLayout;
+    VkImage dstImage;
+    VkImageLayout dstImageLayout;
+    uint32_t regionCount;
+    const VkImageBlit* pRegions;
+    VkFilter filter;
+};
+
+static void ExecuteCmdBlitImage(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdBlitImageRecord*>(data);
+    ExecuteBlitImage(context, record.srcImage, record.dstImage, record.regionCount, record.pRegions, record.filter);
+}
+const CommandInfo CmdBlitImageRecord::info = {"vkCmdBlitImage", ExecuteCmdBlitImage};
 
 static VKAPI_ATTR void VKAPI_CALL CmdBlitImage(
     VkCommandBuffer                             commandBuffer,
@@ -1403,8 +6503,35 @@ static VKAPI_ATTR void VKAPI_CALL CmdBlitImage(
     const VkImageBlit*                          pRegions,
     VkFilter                                    filter)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBlitImage, regionCount, commandBuffer, srcImage, dstImage);
+    char* storage;
+    auto record = RecordCommand<CmdBlitImageRecord>(commandBuffer, CommandArraySize(pRegions, regionCount) + CommandNestedSize(pRegions, regionCount), &storage);
+    if (!record) return;
+    record->srcImage = srcImage;
+    record->srcImageLayout = srcImageLayout;
+    record->dstImage = dstImage;
+    record->dstImageLayout = dstImageLayout;
+    record->regionCount = regionCount;
+    auto pRegions_copy = CopyCommandArray(&storage, pRegions, regionCount);
+    CopyCommandNested(&storage, pRegions_copy, regionCount);
+    record->pRegions = pRegions_copy;
+    record->filter = filter;
+}
+
+struct CmdCopyBufferToImageRecord {
+    static const CommandInfo info;
+    VkBuffer srcBuffer;
+    VkImage dstImage;
+    VkImageLayout dstImageLayout;
+    uint32_t regionCount;
+    const VkBufferImageCopy* pRegions;
+};
+
+static void ExecuteCmdCopyBufferToImage(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdCopyBufferToImageRecord*>(data);
+    ExecuteCopyBufferImage(context, record.srcBuffer, record.dstImage, record.regionCount, record.pRegions, true);
+}
+const CommandInfo CmdCopyBufferToImageRecord::info = {"vkCmdCopyBufferToImage", ExecuteCmdCopyBufferToImage};
 
 static VKAPI_ATTR void VKAPI_CALL CmdCopyBufferToImage(
     VkCommandBuffer                             commandBuffer,
@@ -1414,8 +6541,33 @@ static VKAPI_ATTR void VKAPI_CALL CmdCopyBufferToImage(
     uint32_t                                    regionCount,
     const VkBufferImageCopy*                    pRegions)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdCopyBufferToImage, regionCount, commandBuffer, srcBuffer, dstImage);
+    char* storage;
+    auto record = RecordCommand<CmdCopyBufferToImageRecord>(commandBuffer, CommandArraySize(pRegions, regionCount) + CommandNestedSize(pRegions, regionCount), &storage);
+    if (!record) return;
+    record->srcBuffer = srcBuffer;
+    record->dstImage = dstImage;
+    record->dstImageLayout = dstImageLayout;
+    record->regionCount = regionCount;
+    auto pRegions_copy = CopyCommandArray(&storage, pRegions, regionCount);
+    CopyCommandNested(&storage, pRegions_copy, regionCount);
+    record->pRegions = pRegions_copy;
+}
+
+struct CmdCopyImageToBufferRecord {
+    static const CommandInfo info;
+    VkImage srcImage;
+    VkImageLayout srcImageLayout;
+    VkBuffer dstBuffer;
+    uint32_t regionCount;
+    const VkBufferImageCopy* pRegions;
+};
+
+static void ExecuteCmdCopyImageToBuffer(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdCopyImageToBufferRecord*>(data);
+    ExecuteCopyBufferImage(context, record.dstBuffer, record.srcImage, record.regionCount, record.pRegions, false);
+}
+const CommandInfo CmdCopyImageToBufferRecord::info = {"vkCmdCopyImageToBuffer", ExecuteCmdCopyImageToBuffer};
 
 static VKAPI_ATTR void VKAPI_CALL CmdCopyImageToBuffer(
     VkCommandBuffer                             commandBuffer,
@@ -1425,8 +6577,32 @@ static VKAPI_ATTR void VKAPI_CALL CmdCopyImageToBuffer(
     uint32_t                                    regionCount,
     const VkBufferImageCopy*                    pRegions)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdCopyImageToBuffer, regionCount, commandBuffer, srcImage, dstBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdCopyImageToBufferRecord>(commandBuffer, CommandArraySize(pRegions, regionCount) + CommandNestedSize(pRegions, regionCount), &storage);
+    if (!record) return;
+    record->srcImage = srcImage;
+    record->srcImageLayout = srcImageLayout;
+    record->dstBuffer = dstBuffer;
+    record->regionCount = regionCount;
+    auto pRegions_copy = CopyCommandArray(&storage, pRegions, regionCount);
+    CopyCommandNested(&storage, pRegions_copy, regionCount);
+    record->pRegions = pRegions_copy;
+}
+
+struct CmdUpdateBufferRecord {
+    static const CommandInfo info;
+    VkBuffer dstBuffer;
+    VkDeviceSize dstOffset;
+    VkDeviceSize dataSize;
+    const void* pData;
+};
+
+static void ExecuteCmdUpdateBuffer(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdUpdateBufferRecord*>(data);
+    ExecuteUpdateBuffer(context, record.dstBuffer, record.dstOffset, record.dataSize, record.pData);
+}
+const CommandInfo CmdUpdateBufferRecord::info = {"vkCmdUpdateBuffer", ExecuteCmdUpdateBuffer};
 
 static VKAPI_ATTR void VKAPI_CALL CmdUpdateBuffer(
     VkCommandBuffer                             commandBuffer,
@@ -1435,8 +6611,29 @@ static VKAPI_ATTR void VKAPI_CALL CmdUpdateBuffer(
     VkDeviceSize                                dataSize,
     const void*                                 pData)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdUpdateBuffer, dataSize, commandBuffer, dstBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdUpdateBufferRecord>(commandBuffer, CommandArraySize(pData, dataSize), &storage);
+    if (!record) return;
+    record->dstBuffer = dstBuffer;
+    record->dstOffset = dstOffset;
+    record->dataSize = dataSize;
+    record->pData = CopyCommandArray(&storage, pData, dataSize);
+}
+
+struct CmdFillBufferRecord {
+    static const CommandInfo info;
+    VkBuffer dstBuffer;
+    VkDeviceSize dstOffset;
+    VkDeviceSize size;
+    uint32_t data;
+};
+
+static void ExecuteCmdFillBuffer(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdFillBufferRecord*>(data);
+    ExecuteFillBuffer(context, record.dstBuffer, record.dstOffset, record.size, record.data);
 }
+const CommandInfo CmdFillBufferRecord::info = {"vkCmdFillBuffer", ExecuteCmdFillBuffer};
 
 static VKAPI_ATTR void VKAPI_CALL CmdFillBuffer(
     VkCommandBuffer                             commandBuffer,
@@ -1445,8 +6642,29 @@ static VKAPI_ATTR void VKAPI_CALL CmdFillBuffer(
     VkDeviceSize                                size,
     uint32_t                                    data)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdFillBuffer, 0, commandBuffer, dstBuffer);
+    auto record = RecordCommand<CmdFillBufferRecord>(commandBuffer);
+    if (!record) return;
+    record->dstBuffer = dstBuffer;
+    record->dstOffset = dstOffset;
+    record->size = size;
+    record->data = data;
+}
+
+struct CmdClearColorImageRecord {
+    static const CommandInfo info;
+    VkImage image;
+    VkImageLayout imageLayout;
+    const VkClearColorValue* pColor;
+    uint32_t rangeCount;
+    const VkImageSubresourceRange* pRanges;
+};
+
+static void ExecuteCmdClearColorImage(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdClearColorImageRecord*>(data);
+    ExecuteClearColorImage(context, record.image, *record.pColor, record.rangeCount, record.pRanges);
 }
+const CommandInfo CmdClearColorImageRecord::info = {"vkCmdClearColorImage", ExecuteCmdClearColorImage};
 
 static VKAPI_ATTR void VKAPI_CALL CmdClearColorImage(
     VkCommandBuffer                             commandBuffer,
@@ -1456,8 +6674,35 @@ static VKAPI_ATTR void VKAPI_CALL CmdClearColorImage(
     uint32_t                                    rangeCount,
     const VkImageSubresourceRange*              pRanges)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdClearColorImage, rangeCount, commandBuffer, image);
+    char* storage;
+    auto record = RecordCommand<CmdClearColorImageRecord>(commandBuffer, CommandArraySize(pColor, 1) + CommandNestedSize(pColor, 1) + CommandArraySize(pRanges, rangeCount) + CommandNestedSize(pRanges, rangeCount), &storage);
+    if (!record) return;
+    record->image = image;
+    record->imageLayout = imageLayout;
+    auto pColor_copy = CopyCommandArray(&storage, pColor, 1);
+    CopyCommandNested(&storage, pColor_copy, 1);
+    record->pColor = pColor_copy;
+    record->rangeCount = rangeCount;
+    auto pRanges_copy = CopyCommandArray(&storage, pRanges, rangeCount);
+    CopyCommandNested(&storage, pRanges_copy, rangeCount);
+    record->pRanges = pRanges_copy;
+}
+
+struct CmdClearDepthStencilImageRecord {
+    static const CommandInfo info;
+    VkImage image;
+    VkImageLayout imageLayout;
+    const VkClearDepthStencilValue* pDepthStencil;
+    uint32_t rangeCount;
+    const VkImageSubresourceRange* pRanges;
+};
+
+static void ExecuteCmdClearDepthStencilImage(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdClearDepthStencilImageRecord*>(data);
+    ExecuteClearDepthStencilImage(context, record.image, *record.pDepthStencil, record.rangeCount, record.pRanges);
+}
+const CommandInfo CmdClearDepthStencilImageRecord::info = {"vkCmdClearDepthStencilImage", ExecuteCmdClearDepthStencilImage};
 
 static VKAPI_ATTR void VKAPI_CALL CmdClearDepthStencilImage(
     VkCommandBuffer                             commandBuffer,
@@ -1467,8 +6712,34 @@ static VKAPI_ATTR void VKAPI_CALL CmdClearDepthStencilImage(
     uint32_t                                    rangeCount,
     const VkImageSubresourceRange*              pRanges)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdClearDepthStencilImage, rangeCount, commandBuffer, image);
+    char* storage;
+    auto record = RecordCommand<CmdClearDepthStencilImageRecord>(commandBuffer, CommandArraySize(pDepthStencil, 1) + CommandNestedSize(pDepthStencil, 1) + CommandArraySize(pRanges, rangeCount) + CommandNestedSize(pRanges, rangeCount), &storage);
+    if (!record) return;
+    record->image = image;
+    record->imageLayout = imageLayout;
+    auto pDepthStencil_copy = CopyCommandArray(&storage, pDepthStencil, 1);
+    CopyCommandNested(&storage, pDepthStencil_copy, 1);
+    record->pDepthStencil = pDepthStencil_copy;
+    record->rangeCount = rangeCount;
+    auto pRanges_copy = CopyCommandArray(&storage, pRanges, rangeCount);
+    CopyCommandNested(&storage, pRanges_copy, rangeCount);
+    record->pRanges = pRanges_copy;
+}
+
+struct CmdClearAttachmentsRecord {
+    static const CommandInfo info;
+    uint32_t attachmentCount;
+    const VkClearAttachment* pAttachments;
+    uint32_t rectCount;
+    const VkClearRect* pRects;
+};
+
+static void ExecuteCmdClearAttachments(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdClearAttachmentsRecord*>(data);
+    ExecuteClearAttachments(context, record.attachmentCount, record.pAttachments, record.rectCount, record.pRects);
+}
+const CommandInfo CmdClearAttachmentsRecord::info = {"vkCmdClearAttachments", ExecuteCmdClearAttachments};
 
 static VKAPI_ATTR void VKAPI_CALL CmdClearAttachments(
     VkCommandBuffer                             commandBuffer,
@@ -1477,8 +6748,35 @@ static VKAPI_ATTR void VKAPI_CALL CmdClearAttachments(
     uint32_t                                    rectCount,
     const VkClearRect*                          pRects)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdClearAttachments, attachmentCount + rectCount, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdClearAttachmentsRecord>(commandBuffer, CommandArraySize(pAttachments, attachmentCount) + CommandNestedSize(pAttachments, attachmentCount) + CommandArraySize(pRects, rectCount) + CommandNestedSize(pRects, rectCount), &storage);
+    if (!record) return;
+    record->attachmentCount = attachmentCount;
+    auto pAttachments_copy = CopyCommandArray(&storage, pAttachments, attachmentCount);
+    CopyCommandNested(&storage, pAttachments_copy, attachmentCount);
+    record->pAttachments = pAttachments_copy;
+    record->rectCount = rectCount;
+    auto pRects_copy = CopyCommandArray(&storage, pRects, rectCount);
+    CopyCommandNested(&storage, pRects_copy, rectCount);
+    record->pRects = pRects_copy;
+}
+
+struct CmdResolveImageRecord {
+    static const CommandInfo info;
+    VkImage srcImage;
+    VkImageLayout srcImageLayout;
+    VkImage dstImage;
+    VkImageLayout dstImageLayout;
+    uint32_t regionCount;
+    const VkImageResolve* pRegions;
+};
+
+static void ExecuteCmdResolveImage(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdResolveImageRecord*>(data);
+    ExecuteResolveImage(context, record.srcImage, record.dstImage, record.regionCount, record.pRegions);
+}
+const CommandInfo CmdResolveImageRecord::info = {"vkCmdResolveImage", ExecuteCmdResolveImage};
 
 static VKAPI_ATTR void VKAPI_CALL CmdResolveImage(
     VkCommandBuffer                             commandBuffer,
@@ -1489,24 +6787,72 @@ static VKAPI_ATTR void VKAPI_CALL CmdResolveImage(
     uint32_t                                    regionCount,
     const VkImageResolve*                       pRegions)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdResolveImage, regionCount, commandBuffer, srcImage, dstImage);
+    char* storage;
+    auto record = RecordCommand<CmdResolveImageRecord>(commandBuffer, CommandArraySize(pRegions, regionCount) + CommandNestedSize(pRegions, regionCount), &storage);
+    if (!record) return;
+    record->srcImage = srcImage;
+    record->srcImageLayout = srcImageLayout;
+    record->dstImage = dstImage;
+    record->dstImageLayout = dstImageLayout;
+    record->regionCount = regionCount;
+    auto pRegions_copy = CopyCommandArray(&storage, pRegions, regionCount);
+    CopyCommandNested(&storage, pRegions_copy, regionCount);
+    record->pRegions = pRegions_copy;
+}
+
+struct CmdSetEventRecord {
+    static const CommandInfo info;
+    VkEvent event;
+    VkPipelineStageFlags stageMask;
+};
+const CommandInfo CmdSetEventRecord::info = {"vkCmdSetEvent", nullptr};
 
 static VKAPI_ATTR void VKAPI_CALL CmdSetEvent(
     VkCommandBuffer                             commandBuffer,
     VkEvent                                     event,
     VkPipelineStageFlags                        stageMask)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetEvent, 0, commandBuffer, event);
+    auto record = RecordCommand<CmdSetEventRecord>(commandBuffer);
+    if (!record) return;
+    record->event = event;
+    record->stageMask = stageMask;
 }
 
+struct CmdResetEventRecord {
+    static const CommandInfo info;
+    VkEvent event;
+    VkPipelineStageFlags stageMask;
+};
+const CommandInfo CmdResetEventRecord::info = {"vkCmdResetEvent", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdResetEvent(
     VkCommandBuffer                             commandBuffer,
     VkEvent                                     event,
     VkPipelineStageFlags                        stageMask)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdResetEvent, 0, commandBuffer, event);
+    auto record = RecordCommand<CmdResetEventRecord>(commandBuffer);
+    if (!record) return;
+    record->event = event;
+    record->stageMask = stageMask;
+}
+
+struct CmdWaitEventsRecord {
+    static const CommandInfo info;
+    uint32_t eventCount;
+    const VkEvent* pEvents;
+    VkPipelineStageFlags srcStageMask;
+    VkPipelineStageFlags dstStageMask;
+    uint32_t memoryBarrierCount;
+    const VkMemoryBarrier* pMemoryBarriers;
+    uint32_t bufferMemoryBarrierCount;
+    const VkBufferMemoryBarrier* pBufferMemoryBarriers;
+    uint32_t imageMemoryBarrierCount;
+    const VkImageMemoryBarrier* pImageMemoryBarriers;
+};
+const CommandInfo CmdWaitEventsRecord::info = {"vkCmdWaitEvents", nullptr};
 
 static VKAPI_ATTR void VKAPI_CALL CmdWaitEvents(
     VkCommandBuffer                             commandBuffer,
@@ -1521,8 +6867,41 @@ static VKAPI_ATTR void VKAPI_CALL CmdWaitEvents(
     uint32_t                                    imageMemoryBarrierCount,
     const VkImageMemoryBarrier*                 pImageMemoryBarriers)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdWaitEvents, eventCount + memoryBarrierCount + bufferMemoryBarrierCount + imageMemoryBarrierCount, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdWaitEventsRecord>(commandBuffer, CommandArraySize(pEvents, eventCount) + CommandArraySize(pMemoryBarriers, memoryBarrierCount) + CommandNestedSize(pMemoryBarriers, memoryBarrierCount) + CommandArraySize(pBufferMemoryBarriers, bufferMemoryBarrierCount) + CommandNestedSize(pBufferMemoryBarriers, bufferMemoryBarrierCount) + CommandArraySize(pImageMemoryBarriers, imageMemoryBarrierCount) + CommandNestedSize(pImageMemoryBarriers, imageMemoryBarrierCount), &storage);
+    if (!record) return;
+    record->eventCount = eventCount;
+    record->pEvents = CopyCommandArray(&storage, pEvents, eventCount);
+    record->srcStageMask = srcStageMask;
+    record->dstStageMask = dstStageMask;
+    record->memoryBarrierCount = memoryBarrierCount;
+    auto pMemoryBarriers_copy = CopyCommandArray(&storage, pMemoryBarriers, memoryBarrierCount);
+    CopyCommandNested(&storage, pMemoryBarriers_copy, memoryBarrierCount);
+    record->pMemoryBarriers = pMemoryBarriers_copy;
+    record->bufferMemoryBarrierCount = bufferMemoryBarrierCount;
+    auto pBufferMemoryBarriers_copy = CopyCommandArray(&storage, pBufferMemoryBarriers, bufferMemoryBarrierCount);
+    CopyCommandNested(&storage, pBufferMemoryBarriers_copy, bufferMemoryBarrierCount);
+    record->pBufferMemoryBarriers = pBufferMemoryBarriers_copy;
+    record->imageMemoryBarrierCount = imageMemoryBarrierCount;
+    auto pImageMemoryBarriers_copy = CopyCommandArray(&storage, pImageMemoryBarriers, imageMemoryBarrierCount);
+    CopyCommandNested(&storage, pImageMemoryBarriers_copy, imageMemoryBarrierCount);
+    record->pImageMemoryBarriers = pImageMemoryBarriers_copy;
+}
+
+struct CmdPipelineBarrierRecord {
+    static const CommandInfo info;
+    VkPipelineStageFlags srcStageMask;
+    VkPipelineStageFlags dstStageMask;
+    VkDependencyFlags dependencyFlags;
+    uint32_t memoryBarrierCount;
+    const VkMemoryBarrier* pMemoryBarriers;
+    uint32_t bufferMemoryBarrierCount;
+    const VkBufferMemoryBarrier* pBufferMemoryBarriers;
+    uint32_t imageMemoryBarrierCount;
+    const VkImageMemoryBarrier* pImageMemoryBarriers;
+};
+const CommandInfo CmdPipelineBarrierRecord::info = {"vkCmdPipelineBarrier", nullptr};
 
 static VKAPI_ATTR void VKAPI_CALL CmdPipelineBarrier(
     VkCommandBuffer                             commandBuffer,
@@ -1536,8 +6915,39 @@ static VKAPI_ATTR void VKAPI_CALL CmdPipelineBarrier(
     uint32_t                                    imageMemoryBarrierCount,
     const VkImageMemoryBarrier*                 pImageMemoryBarriers)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdPipelineBarrier, memoryBarrierCount + bufferMemoryBarrierCount + imageMemoryBarrierCount, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdPipelineBarrierRecord>(commandBuffer, CommandArraySize(pMemoryBarriers, memoryBarrierCount) + CommandNestedSize(pMemoryBarriers, memoryBarrierCount) + CommandArraySize(pBufferMemoryBarriers, bufferMemoryBarrierCount) + CommandNestedSize(pBufferMemoryBarriers, bufferMemoryBarrierCount) + CommandArraySize(pImageMemoryBarriers, imageMemoryBarrierCount) + CommandNestedSize(pImageMemoryBarriers, imageMemoryBarrierCount), &storage);
+    if (!record) return;
+    record->srcStageMask = srcStageMask;
+    record->dstStageMask = dstStageMask;
+    record->dependencyFlags = dependencyFlags;
+    record->memoryBarrierCount = memoryBarrierCount;
+    auto pMemoryBarriers_copy = CopyCommandArray(&storage, pMemoryBarriers, memoryBarrierCount);
+    CopyCommandNested(&storage, pMemoryBarriers_copy, memoryBarrierCount);
+    record->pMemoryBarriers = pMemoryBarriers_copy;
+    record->bufferMemoryBarrierCount = bufferMemoryBarrierCount;
+    auto pBufferMemoryBarriers_copy = CopyCommandArray(&storage, pBufferMemoryBarriers, bufferMemoryBarrierCount);
+    CopyCommandNested(&storage, pBufferMemoryBarriers_copy, bufferMemoryBarrierCount);
+    record->pBufferMemoryBarriers = pBufferMemoryBarriers_copy;
+    record->imageMemoryBarrierCount = imageMemoryBarrierCount;
+    auto pImageMemoryBarriers_copy = CopyCommandArray(&storage, pImageMemoryBarriers, imageMemoryBarrierCount);
+    CopyCommandNested(&storage, pImageMemoryBarriers_copy, imageMemoryBarrierCount);
+    record->pImageMemoryBarriers = pImageMemoryBarriers_copy;
+}
+
+struct CmdBeginQueryRecord {
+    static const CommandInfo info;
+    VkQueryPool queryPool;
+    uint32_t query;
+    VkQueryControlFlags flags;
+};
+
+static void ExecuteCmdBeginQuery(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdBeginQueryRecord*>(data);
+    ExecuteBeginQuery(context, record.queryPool, record.query);
+}
+const CommandInfo CmdBeginQueryRecord::info = {"vkCmdBeginQuery", ExecuteCmdBeginQuery};
 
 static VKAPI_ATTR void VKAPI_CALL CmdBeginQuery(
     VkCommandBuffer                             commandBuffer,
@@ -1545,16 +6955,52 @@ static VKAPI_ATTR void VKAPI_CALL CmdBeginQuery(
     uint32_t                                    query,
     VkQueryControlFlags                         flags)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBeginQuery, 0, commandBuffer, queryPool);
+    auto record = RecordCommand<CmdBeginQueryRecord>(commandBuffer);
+    if (!record) return;
+    record->queryPool = queryPool;
+    record->query = query;
+    record->flags = flags;
+}
+
+struct CmdEndQueryRecord {
+    static const CommandInfo info;
+    VkQueryPool queryPool;
+    uint32_t query;
+};
+
+static void ExecuteCmdEndQuery(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdEndQueryRecord*>(data);
+    ExecuteEndQuery(context, record.queryPool, record.query);
 }
+const CommandInfo CmdEndQueryRecord::info = {"vkCmdEndQuery", ExecuteCmdEndQuery};
 
 static VKAPI_ATTR void VKAPI_CALL CmdEndQuery(
     VkCommandBuffer                             commandBuffer,
     VkQueryPool                                 queryPool,
     uint32_t                                    query)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdEndQuery, 0, commandBuffer, queryPool);
+    auto record = RecordCommand<CmdEndQueryRecord>(commandBuffer);
+    if (!record) return;
+    record->queryPool = queryPool;
+    record->query = query;
+}
+
+struct CmdResetQueryPoolRecord {
+    static const CommandInfo info;
+    VkQueryPool queryPool;
+    uint32_t firstQuery;
+    uint32_t queryCount;
+};
+
+static void ExecuteCmdResetQueryPool(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdResetQueryPoolRecord*>(data);
+    QueryPool* pool = GetQueryPool(record.queryPool);
+    if (!pool) return;
+    for (uint32_t i = 0; i < record.queryCount; ++i) MakeQueryAvailable(pool, record.firstQuery + i, false);
 }
+const CommandInfo CmdResetQueryPoolRecord::info = {"vkCmdResetQueryPool", ExecuteCmdResetQueryPool};
 
 static VKAPI_ATTR void VKAPI_CALL CmdResetQueryPool(
     VkCommandBuffer                             commandBuffer,
@@ -1562,8 +7008,26 @@ static VKAPI_ATTR void VKAPI_CALL CmdResetQueryPool(
     uint32_t                                    firstQuery,
     uint32_t                                    queryCount)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdResetQueryPool, 0, commandBuffer, queryPool);
+    auto record = RecordCommand<CmdResetQueryPoolRecord>(commandBuffer);
+    if (!record) return;
+    record->queryPool = queryPool;
+    record->firstQuery = firstQuery;
+    record->queryCount = queryCount;
+}
+
+struct CmdWriteTimestampRecord {
+    static const CommandInfo info;
+    VkPipelineStageFlagBits pipelineStage;
+    VkQueryPool queryPool;
+    uint32_t query;
+};
+
+static void ExecuteCmdWriteTimestamp(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdWriteTimestampRecord*>(data);
+    ExecuteWriteTimestamp(context, record.queryPool, record.query);
 }
+const CommandInfo CmdWriteTimestampRecord::info = {"vkCmdWriteTimestamp", ExecuteCmdWriteTimestamp};
 
 static VKAPI_ATTR void VKAPI_CALL CmdWriteTimestamp(
     VkCommandBuffer                             commandBuffer,
@@ -1571,8 +7035,31 @@ static VKAPI_ATTR void VKAPI_CALL CmdWriteTimestamp(
     VkQueryPool                                 queryPool,
     uint32_t                                    query)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdWriteTimestamp, 0, commandBuffer, queryPool);
+    auto record = RecordCommand<CmdWriteTimestampRecord>(commandBuffer);
+    if (!record) return;
+    record->pipelineStage = pipelineStage;
+    record->queryPool = queryPool;
+    record->query = query;
+}
+
+struct CmdCopyQueryPoolResultsRecord {
+    static const CommandInfo info;
+    VkQueryPool queryPool;
+    uint32_t firstQuery;
+    uint32_t queryCount;
+    VkBuffer dstBuffer;
+    VkDeviceSize dstOffset;
+    VkDeviceSize stride;
+    VkQueryResultFlags flags;
+};
+
+static void ExecuteCmdCopyQueryPoolResults(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdCopyQueryPoolResultsRecord*>(data);
+    ExecuteCopyQueryPoolResults(context, record.queryPool, record.firstQuery, record.queryCount, record.dstBuffer, record.dstOffset,
+                                record.stride, record.flags);
 }
+const CommandInfo CmdCopyQueryPoolResultsRecord::info = {"vkCmdCopyQueryPoolResults", ExecuteCmdCopyQueryPoolResults};
 
 static VKAPI_ATTR void VKAPI_CALL CmdCopyQueryPoolResults(
     VkCommandBuffer                             commandBuffer,
@@ -1584,8 +7071,33 @@ static VKAPI_ATTR void VKAPI_CALL CmdCopyQueryPoolResults(
     VkDeviceSize                                stride,
     VkQueryResultFlags                          flags)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdCopyQueryPoolResults, 0, commandBuffer, queryPool, dstBuffer);
+    auto record = RecordCommand<CmdCopyQueryPoolResultsRecord>(commandBuffer);
+    if (!record) return;
+    record->queryPool = queryPool;
+    record->firstQuery = firstQuery;
+    record->queryCount = queryCount;
+    record->dstBuffer = dstBuffer;
+    record->dstOffset = dstOffset;
+    record->stride = stride;
+    record->flags = flags;
+}
+
+struct CmdPushConstantsRecord {
+    static const CommandInfo info;
+    VkPipelineLayout layout;
+    VkShaderStageFlags stageFlags;
+    uint32_t offset;
+    uint32_t size;
+    const void* pValues;
+};
+static void ExecuteCmdPushConstants(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdPushConstantsRecord*>(data);
+    if (record.offset > MAX_PUSH_CONSTANTS_SIZE || record.size > MAX_PUSH_CONSTANTS_SIZE - record.offset) return;
+    if (record.stageFlags & VK_SHADER_STAGE_COMPUTE_BIT) memcpy(context->compute.push_constants + record.offset, record.pValues, record.size);
+    if (record.stageFlags & VK_SHADER_STAGE_ALL_GRAPHICS) memcpy(context->graphics.push_constants + record.offset, record.pValues, record.size);
+}
+const CommandInfo CmdPushConstantsRecord::info = {"vkCmdPushConstants", ExecuteCmdPushConstants};
 
 static VKAPI_ATTR void VKAPI_CALL CmdPushConstants(
     VkCommandBuffer                             commandBuffer,
@@ -1595,42 +7107,110 @@ static VKAPI_ATTR void VKAPI_CALL CmdPushConstants(
     uint32_t                                    size,
     const void*                                 pValues)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdPushConstants, size, commandBuffer, layout);
+    char* storage;
+    auto record = RecordCommand<CmdPushConstantsRecord>(commandBuffer, CommandArraySize(pValues, size), &storage);
+    if (!record) return;
+    record->layout = layout;
+    record->stageFlags = stageFlags;
+    record->offset = offset;
+    record->size = size;
+    record->pValues = CopyCommandArray(&storage, pValues, size);
+}
+
+struct CmdBeginRenderPassRecord {
+    static const CommandInfo info;
+    const VkRenderPassBeginInfo* pRenderPassBegin;
+    VkSubpassContents contents;
+};
+
+static void ExecuteCmdBeginRenderPass(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdBeginRenderPassRecord*>(data);
+    ExecuteBeginRenderPass(context, *record.pRenderPassBegin);
 }
+const CommandInfo CmdBeginRenderPassRecord::info = {"vkCmdBeginRenderPass", ExecuteCmdBeginRenderPass};
 
 static VKAPI_ATTR void VKAPI_CALL CmdBeginRenderPass(
     VkCommandBuffer                             commandBuffer,
     const VkRenderPassBeginInfo*                pRenderPassBegin,
     VkSubpassContents                           contents)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBeginRenderPass, 0, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdBeginRenderPassRecord>(commandBuffer, CommandArraySize(pRenderPassBegin, 1) + CommandNestedSize(pRenderPassBegin, 1), &storage);
+    if (!record) return;
+    auto pRenderPassBegin_copy = CopyCommandArray(&storage, pRenderPassBegin, 1);
+    CopyCommandNested(&storage, pRenderPassBegin_copy, 1);
+    record->pRenderPassBegin = pRenderPassBegin_copy;
+    record->contents = contents;
+}
+
+struct CmdNextSubpassRecord {
+    static const CommandInfo info;
+    VkSubpassContents contents;
+};
+
+static void ExecuteCmdNextSubpass(const void*, ExecutionContext* context) {
+    ExecuteNextSubpass(context);
 }
+const CommandInfo CmdNextSubpassRecord::info = {"vkCmdNextSubpass", ExecuteCmdNextSubpass};
 
 static VKAPI_ATTR void VKAPI_CALL CmdNextSubpass(
     VkCommandBuffer                             commandBuffer,
     VkSubpassContents                           contents)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdNextSubpass, 0, commandBuffer);
+    auto record = RecordCommand<CmdNextSubpassRecord>(commandBuffer);
+    if (!record) return;
+    record->contents = contents;
+}
+
+struct CmdEndRenderPassRecord {
+    static const CommandInfo info;
+};
+
+static void ExecuteCmdEndRenderPass(const void*, ExecutionContext* context) {
+    ExecuteEndRenderPass(context);
 }
+const CommandInfo CmdEndRenderPassRecord::info = {"vkCmdEndRenderPass", ExecuteCmdEndRenderPass};
 
 static VKAPI_ATTR void VKAPI_CALL CmdEndRenderPass(
     VkCommandBuffer                             commandBuffer)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdEndRenderPass, 0, commandBuffer);
+    RecordCommand<CmdEndRenderPassRecord>(commandBuffer);
+}
+
+struct CmdExecuteCommandsRecord {
+    static const CommandInfo info;
+    uint32_t commandBufferCount;
+    const VkCommandBuffer* pCommandBuffers;
+};
+
+static void ExecuteCmdExecuteCommands(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdExecuteCommandsRecord*>(data);
+    for (uint32_t i = 0; i < record.commandBufferCount; ++i) ExecuteCommandBuffer(record.pCommandBuffers[i], context);
 }
+const CommandInfo CmdExecuteCommandsRecord::info = {"vkCmdExecuteCommands", ExecuteCmdExecuteCommands};
 
 static VKAPI_ATTR void VKAPI_CALL CmdExecuteCommands(
     VkCommandBuffer                             commandBuffer,
     uint32_t                                    commandBufferCount,
     const VkCommandBuffer*                      pCommandBuffers)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdExecuteCommands, commandBufferCount, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdExecuteCommandsRecord>(commandBuffer, CommandArraySize(pCommandBuffers, commandBufferCount), &storage);
+    if (!record) return;
+    record->commandBufferCount = commandBufferCount;
+    record->pCommandBuffers = CopyCommandArray(&storage, pCommandBuffers, commandBufferCount);
 }
 
 
 static VKAPI_ATTR VkResult VKAPI_CALL EnumerateInstanceVersion(
     uint32_t*                                   pApiVersion)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkEnumerateInstanceVersion, 0);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -1640,8 +7220,8 @@ static VKAPI_ATTR VkResult VKAPI_CALL BindBufferMemory2(
     uint32_t                                    bindInfoCount,
     const VkBindBufferMemoryInfo*               pBindInfos)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkBindBufferMemory2, bindInfoCount, device);
+    return BindBufferMemory2KHR(device, bindInfoCount, pBindInfos);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL BindImageMemory2(
@@ -1649,8 +7229,8 @@ static VKAPI_ATTR VkResult VKAPI_CALL BindImageMemory2(
     uint32_t                                    bindInfoCount,
     const VkBindImageMemoryInfo*                pBindInfos)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkBindImageMemory2, bindInfoCount, device);
+    return BindImageMemory2KHR(device, bindInfoCount, pBindInfos);
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetDeviceGroupPeerMemoryFeatures(
@@ -1660,16 +7240,44 @@ static VKAPI_ATTR void VKAPI_CALL GetDeviceGroupPeerMemoryFeatures(
     uint32_t                                    remoteDeviceIndex,
     VkPeerMemoryFeatureFlags*                   pPeerMemoryFeatures)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDeviceGroupPeerMemoryFeatures, 0, device);
+    GetDeviceGroupPeerMemoryFeaturesKHR(device, heapIndex, localDeviceIndex, remoteDeviceIndex, pPeerMemoryFeatures);
 }
 
+struct CmdSetDeviceMaskRecord {
+    static const CommandInfo info;
+    uint32_t deviceMask;
+};
+const CommandInfo CmdSetDeviceMaskRecord::info = {"vkCmdSetDeviceMask", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdSetDeviceMask(
     VkCommandBuffer                             commandBuffer,
     uint32_t                                    deviceMask)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetDeviceMask, 0, commandBuffer);
+    auto record = RecordCommand<CmdSetDeviceMaskRecord>(commandBuffer);
+    if (!record) return;
+    record->deviceMask = deviceMask;
 }
 
+struct CmdDispatchBaseRecord {
+    static const CommandInfo info;
+    uint32_t baseGroupX;
+    uint32_t baseGroupY;
+    uint32_t baseGroupZ;
+    uint32_t groupCountX;
+    uint32_t groupCountY;
+    uint32_t groupCountZ;
+};
+
+static void ExecuteCmdDispatchBase(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdDispatchBaseRecord*>(data);
+    const uint32_t base[3] = {record.baseGroupX, record.baseGroupY, record.baseGroupZ};
+    const uint32_t group_count[3] = {record.groupCountX, record.groupCountY, record.groupCountZ};
+    ExecuteDispatch(context, base, group_count);
+}
+const CommandInfo CmdDispatchBaseRecord::info = {"vkCmdDispatchBase", ExecuteCmdDispatchBase};
+
 static VKAPI_ATTR void VKAPI_CALL CmdDispatchBase(
     VkCommandBuffer                             commandBuffer,
     uint32_t                                    baseGroupX,
@@ -1679,7 +7287,15 @@ static VKAPI_ATTR void VKAPI_CALL CmdDispatchBase(
     uint32_t                                    groupCountY,
     uint32_t                                    groupCountZ)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDispatchBase, 0, commandBuffer);
+    auto record = RecordCommand<CmdDispatchBaseRecord>(commandBuffer);
+    if (!record) return;
+    record->baseGroupX = baseGroupX;
+    record->baseGroupY = baseGroupY;
+    record->baseGroupZ = baseGroupZ;
+    record->groupCountX = groupCountX;
+    record->groupCountY = groupCountY;
+    record->groupCountZ = groupCountZ;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL EnumeratePhysicalDeviceGroups(
@@ -1687,8 +7303,8 @@ static VKAPI_ATTR VkResult VKAPI_CALL EnumeratePhysicalDeviceGroups(
     uint32_t*                                   pPhysicalDeviceGroupCount,
     VkPhysicalDeviceGroupProperties*            pPhysicalDeviceGroupProperties)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkEnumeratePhysicalDeviceGroups, 0, instance);
+    return EnumeratePhysicalDeviceGroupsKHR(instance, pPhysicalDeviceGroupCount, pPhysicalDeviceGroupProperties);
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetImageMemoryRequirements2(
@@ -1696,6 +7312,7 @@ static VKAPI_ATTR void VKAPI_CALL GetImageMemoryRequirements2(
     const VkImageMemoryRequirementsInfo2*       pInfo,
     VkMemoryRequirements2*                      pMemoryRequirements)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetImageMemoryRequirements2, 0, device);
     GetImageMemoryRequirements2KHR(device, pInfo, pMemoryRequirements);
 }
 
@@ -1704,6 +7321,7 @@ static VKAPI_ATTR void VKAPI_CALL GetBufferMemoryRequirements2(
     const VkBufferMemoryRequirementsInfo2*      pInfo,
     VkMemoryRequirements2*                      pMemoryRequirements)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetBufferMemoryRequirements2, 0, device);
     GetBufferMemoryRequirements2KHR(device, pInfo, pMemoryRequirements);
 }
 
@@ -1713,6 +7331,7 @@ static VKAPI_ATTR void VKAPI_CALL GetImageSparseMemoryRequirements2(
     uint32_t*                                   pSparseMemoryRequirementCount,
     VkSparseImageMemoryRequirements2*           pSparseMemoryRequirements)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetImageSparseMemoryRequirements2, 0, device);
 //Not a CREATE or DESTROY function
 }
 
@@ -1720,6 +7339,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceFeatures2(
     VkPhysicalDevice                            physicalDevice,
     VkPhysicalDeviceFeatures2*                  pFeatures)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceFeatures2, 0, physicalDevice);
     GetPhysicalDeviceFeatures2KHR(physicalDevice, pFeatures);
 }
 
@@ -1727,6 +7347,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceProperties2(
     VkPhysicalDevice                            physicalDevice,
     VkPhysicalDeviceProperties2*                pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceProperties2, 0, physicalDevice);
     GetPhysicalDeviceProperties2KHR(physicalDevice, pProperties);
 }
 
@@ -1735,6 +7356,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceFormatProperties2(
     VkFormat                                    format,
     VkFormatProperties2*                        pFormatProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceFormatProperties2, 0, physicalDevice);
     GetPhysicalDeviceFormatProperties2KHR(physicalDevice, format, pFormatProperties);
 }
 
@@ -1743,6 +7365,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceImageFormatProperties2(
     const VkPhysicalDeviceImageFormatInfo2*     pImageFormatInfo,
     VkImageFormatProperties2*                   pImageFormatProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceImageFormatProperties2, 0, physicalDevice);
     return GetPhysicalDeviceImageFormatProperties2KHR(physicalDevice, pImageFormatInfo, pImageFormatProperties);
 }
 
@@ -1751,6 +7374,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceQueueFamilyProperties2(
     uint32_t*                                   pQueueFamilyPropertyCount,
     VkQueueFamilyProperties2*                   pQueueFamilyProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceQueueFamilyProperties2, 0, physicalDevice);
     GetPhysicalDeviceQueueFamilyProperties2KHR(physicalDevice, pQueueFamilyPropertyCount, pQueueFamilyProperties);
 }
 
@@ -1758,6 +7382,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceMemoryProperties2(
     VkPhysicalDevice                            physicalDevice,
     VkPhysicalDeviceMemoryProperties2*          pMemoryProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceMemoryProperties2, 0, physicalDevice);
     GetPhysicalDeviceMemoryProperties2KHR(physicalDevice, pMemoryProperties);
 }
 
@@ -1767,6 +7392,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceSparseImageFormatProperties2(
     uint32_t*                                   pPropertyCount,
     VkSparseImageFormatProperties2*             pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceSparseImageFormatProperties2, 0, physicalDevice);
 //Not a CREATE or DESTROY function
 }
 
@@ -1775,6 +7401,7 @@ static VKAPI_ATTR void VKAPI_CALL TrimCommandPool(
     VkCommandPool                               commandPool,
     VkCommandPoolTrimFlags                      flags)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkTrimCommandPool, 0, device, commandPool);
 //Not a CREATE or DESTROY function
 }
 
@@ -1783,6 +7410,7 @@ static VKAPI_ATTR void VKAPI_CALL GetDeviceQueue2(
     const VkDeviceQueueInfo2*                   pQueueInfo,
     VkQueue*                                    pQueue)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDeviceQueue2, 0, device);
     GetDeviceQueue(device, pQueueInfo->queueFamilyIndex, pQueueInfo->queueIndex, pQueue);
     // TODO: Add further support for GetDeviceQueue2 features
 }
@@ -1793,8 +7421,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateSamplerYcbcrConversion(
     const VkAllocationCallbacks*                pAllocator,
     VkSamplerYcbcrConversion*                   pYcbcrConversion)
 {
-    unique_lock_t lock(global_lock);
-    *pYcbcrConversion = (VkSamplerYcbcrConversion)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateSamplerYcbcrConversion, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSamplerYcbcrConversion, 1);
+    *pYcbcrConversion = (VkSamplerYcbcrConversion)sampler_ycbcr_conversion_table.Create();
     return VK_SUCCESS;
 }
 
@@ -1803,7 +7432,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroySamplerYcbcrConversion(
     VkSamplerYcbcrConversion                    ycbcrConversion,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroySamplerYcbcrConversion, 0, device, ycbcrConversion);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkSamplerYcbcrConversion, ycbcrConversion != VK_NULL_HANDLE);
+    sampler_ycbcr_conversion_table.Destroy(ycbcrConversion);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateDescriptorUpdateTemplate(
@@ -1812,8 +7443,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateDescriptorUpdateTemplate(
     const VkAllocationCallbacks*                pAllocator,
     VkDescriptorUpdateTemplate*                 pDescriptorUpdateTemplate)
 {
-    unique_lock_t lock(global_lock);
-    *pDescriptorUpdateTemplate = (VkDescriptorUpdateTemplate)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateDescriptorUpdateTemplate, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkDescriptorUpdateTemplate, 1);
+    *pDescriptorUpdateTemplate = (VkDescriptorUpdateTemplate)descriptor_update_template_table.Create();
     return VK_SUCCESS;
 }
 
@@ -1822,7 +7454,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyDescriptorUpdateTemplate(
     VkDescriptorUpdateTemplate                  descriptorUpdateTemplate,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyDescriptorUpdateTemplate, 0, device, descriptorUpdateTemplate);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkDescriptorUpdateTemplate, descriptorUpdateTemplate != VK_NULL_HANDLE);
+    descriptor_update_template_table.Destroy(descriptorUpdateTemplate);
 }
 
 static VKAPI_ATTR void VKAPI_CALL UpdateDescriptorSetWithTemplate(
@@ -1831,6 +7465,7 @@ static VKAPI_ATTR void VKAPI_CALL UpdateDescriptorSetWithTemplate(
     VkDescriptorUpdateTemplate                  descriptorUpdateTemplate,
     const void*                                 pData)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkUpdateDescriptorSetWithTemplate, 0, device, descriptorSet, descriptorUpdateTemplate);
 //Not a CREATE or DESTROY function
 }
 
@@ -1839,6 +7474,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceExternalBufferProperties(
     const VkPhysicalDeviceExternalBufferInfo*   pExternalBufferInfo,
     VkExternalBufferProperties*                 pExternalBufferProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceExternalBufferProperties, 0, physicalDevice);
     // Hard-code support for all handle types and features
     pExternalBufferProperties->externalMemoryProperties.externalMemoryFeatures = 0x7;
     pExternalBufferProperties->externalMemoryProperties.exportFromImportedHandleTypes = 0x1FF;
@@ -1850,6 +7486,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceExternalFenceProperties(
     const VkPhysicalDeviceExternalFenceInfo*    pExternalFenceInfo,
     VkExternalFenceProperties*                  pExternalFenceProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceExternalFenceProperties, 0, physicalDevice);
     // Hard-code support for all handle types and features
     pExternalFenceProperties->exportFromImportedHandleTypes = 0xF;
     pExternalFenceProperties->compatibleHandleTypes = 0xF;
@@ -1861,6 +7498,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceExternalSemaphoreProperties(
     const VkPhysicalDeviceExternalSemaphoreInfo* pExternalSemaphoreInfo,
     VkExternalSemaphoreProperties*              pExternalSemaphoreProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceExternalSemaphoreProperties, 0, physicalDevice);
     // Hard code support for all handle types and features
     pExternalSemaphoreProperties->exportFromImportedHandleTypes = 0x1F;
     pExternalSemaphoreProperties->compatibleHandleTypes = 0x1F;
@@ -1872,10 +7510,29 @@ static VKAPI_ATTR void VKAPI_CALL GetDescriptorSetLayoutSupport(
     const VkDescriptorSetLayoutCreateInfo*      pCreateInfo,
     VkDescriptorSetLayoutSupport*               pSupport)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDescriptorSetLayoutSupport, 0, device);
 //Not a CREATE or DESTROY function
 }
 
 
+struct CmdDrawIndirectCountRecord {
+    static const CommandInfo info;
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    VkBuffer countBuffer;
+    VkDeviceSize countBufferOffset;
+    uint32_t maxDrawCount;
+    uint32_t stride;
+};
+
+static void ExecuteCmdDrawIndirectCount(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdDrawIndirectCountRecord*>(data);
+    ExecuteDraw(context, 3, record.maxDrawCount);
+    RasterizeIndirectDraws(context, false, record.buffer, record.offset, record.maxDrawCount, record.stride, record.countBuffer,
+                           record.countBufferOffset);
+}
+const CommandInfo CmdDrawIndirectCountRecord::info = {"vkCmdDrawIndirectCount", ExecuteCmdDrawIndirectCount};
+
 static VKAPI_ATTR void VKAPI_CALL CmdDrawIndirectCount(
     VkCommandBuffer                             commandBuffer,
     VkBuffer                                    buffer,
@@ -1885,8 +7542,34 @@ static VKAPI_ATTR void VKAPI_CALL CmdDrawIndirectCount(
     uint32_t                                    maxDrawCount,
     uint32_t                                    stride)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDrawIndirectCount, 0, commandBuffer, buffer, countBuffer);
+    auto record = RecordCommand<CmdDrawIndirectCountRecord>(commandBuffer);
+    if (!record) return;
+    record->buffer = buffer;
+    record->offset = offset;
+    record->countBuffer = countBuffer;
+    record->countBufferOffset = countBufferOffset;
+    record->maxDrawCount = maxDrawCount;
+    record->stride = stride;
+}
+
+struct CmdDrawIndexedIndirectCountRecord {
+    static const CommandInfo info;
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    VkBuffer countBuffer;
+    VkDeviceSize countBufferOffset;
+    uint32_t maxDrawCount;
+    uint32_t stride;
+};
+
+static void ExecuteCmdDrawIndexedIndirectCount(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdDrawIndexedIndirectCountRecord*>(data);
+    ExecuteDraw(context, 3, record.maxDrawCount);
+    RasterizeIndirectDraws(context, true, record.buffer, record.offset, record.maxDrawCount, record.stride, record.countBuffer,
+                           record.countBufferOffset);
+}
+const CommandInfo CmdDrawIndexedIndirectCountRecord::info = {"vkCmdDrawIndexedIndirectCount", ExecuteCmdDrawIndexedIndirectCount};
 
 static VKAPI_ATTR void VKAPI_CALL CmdDrawIndexedIndirectCount(
     VkCommandBuffer                             commandBuffer,
@@ -1897,7 +7580,15 @@ static VKAPI_ATTR void VKAPI_CALL CmdDrawIndexedIndirectCount(
     uint32_t                                    maxDrawCount,
     uint32_t                                    stride)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDrawIndexedIndirectCount, 0, commandBuffer, buffer, countBuffer);
+    auto record = RecordCommand<CmdDrawIndexedIndirectCountRecord>(commandBuffer);
+    if (!record) return;
+    record->buffer = buffer;
+    record->offset = offset;
+    record->countBuffer = countBuffer;
+    record->countBufferOffset = countBufferOffset;
+    record->maxDrawCount = maxDrawCount;
+    record->stride = stride;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateRenderPass2(
@@ -1906,32 +7597,90 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateRenderPass2(
     const VkAllocationCallbacks*                pAllocator,
     VkRenderPass*                               pRenderPass)
 {
-    unique_lock_t lock(global_lock);
-    *pRenderPass = (VkRenderPass)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateRenderPass2, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkRenderPass, 1);
+    *pRenderPass = (VkRenderPass)render_pass_table.Create(CreateRenderPassState(*pCreateInfo));
     return VK_SUCCESS;
 }
 
+struct CmdBeginRenderPass2Record {
+    static const CommandInfo info;
+    const VkRenderPassBeginInfo* pRenderPassBegin;
+    const VkSubpassBeginInfo* pSubpassBeginInfo;
+};
+
+static void ExecuteCmdBeginRenderPass2(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdBeginRenderPass2Record*>(data);
+    ExecuteBeginRenderPass(context, *record.pRenderPassBegin);
+}
+const CommandInfo CmdBeginRenderPass2Record::info = {"vkCmdBeginRenderPass2", ExecuteCmdBeginRenderPass2};
+
 static VKAPI_ATTR void VKAPI_CALL CmdBeginRenderPass2(
     VkCommandBuffer                             commandBuffer,
     const VkRenderPassBeginInfo*                pRenderPassBegin,
     const VkSubpassBeginInfo*                   pSubpassBeginInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBeginRenderPass2, 0, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdBeginRenderPass2Record>(commandBuffer, CommandArraySize(pRenderPassBegin, 1) + CommandNestedSize(pRenderPassBegin, 1) + CommandArraySize(pSubpassBeginInfo, 1) + CommandNestedSize(pSubpassBeginInfo, 1), &storage);
+    if (!record) return;
+    auto pRenderPassBegin_copy = CopyCommandArray(&storage, pRenderPassBegin, 1);
+    CopyCommandNested(&storage, pRenderPassBegin_copy, 1);
+    record->pRenderPassBegin = pRenderPassBegin_copy;
+    auto pSubpassBeginInfo_copy = CopyCommandArray(&storage, pSubpassBeginInfo, 1);
+    CopyCommandNested(&storage, pSubpassBeginInfo_copy, 1);
+    record->pSubpassBeginInfo = pSubpassBeginInfo_copy;
+}
+
+struct CmdNextSubpass2Record {
+    static const CommandInfo info;
+    const VkSubpassBeginInfo* pSubpassBeginInfo;
+    const VkSubpassEndInfo* pSubpassEndInfo;
+};
+
+static void ExecuteCmdNextSubpass2(const void*, ExecutionContext* context) {
+    ExecuteNextSubpass(context);
 }
+const CommandInfo CmdNextSubpass2Record::info = {"vkCmdNextSubpass2", ExecuteCmdNextSubpass2};
 
 static VKAPI_ATTR void VKAPI_CALL CmdNextSubpass2(
     VkCommandBuffer                             commandBuffer,
     const VkSubpassBeginInfo*                   pSubpassBeginInfo,
     const VkSubpassEndInfo*                     pSubpassEndInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdNextSubpass2, 0, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdNextSubpass2Record>(commandBuffer, CommandArraySize(pSubpassBeginInfo, 1) + CommandNestedSize(pSubpassBeginInfo, 1) + CommandArraySize(pSubpassEndInfo, 1) + CommandNestedSize(pSubpassEndInfo, 1), &storage);
+    if (!record) return;
+    auto pSubpassBeginInfo_copy = CopyCommandArray(&storage, pSubpassBeginInfo, 1);
+    CopyCommandNested(&storage, pSubpassBeginInfo_copy, 1);
+    record->pSubpassBeginInfo = pSubpassBeginInfo_copy;
+    auto pSubpassEndInfo_copy = CopyCommandArray(&storage, pSubpassEndInfo, 1);
+    CopyCommandNested(&storage, pSubpassEndInfo_copy, 1);
+    record->pSubpassEndInfo = pSubpassEndInfo_copy;
+}
+
+struct CmdEndRenderPass2Record {
+    static const CommandInfo info;
+    const VkSubpassEndInfo* pSubpassEndInfo;
+};
+
+static void ExecuteCmdEndRenderPass2(const void*, ExecutionContext* context) {
+    ExecuteEndRenderPass(context);
 }
+const CommandInfo CmdEndRenderPass2Record::info = {"vkCmdEndRenderPass2", ExecuteCmdEndRenderPass2};
 
 static VKAPI_ATTR void VKAPI_CALL CmdEndRenderPass2(
     VkCommandBuffer                             commandBuffer,
     const VkSubpassEndInfo*                     pSubpassEndInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdEndRenderPass2, 0, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdEndRenderPass2Record>(commandBuffer, CommandArraySize(pSubpassEndInfo, 1) + CommandNestedSize(pSubpassEndInfo, 1), &storage);
+    if (!record) return;
+    auto pSubpassEndInfo_copy = CopyCommandArray(&storage, pSubpassEndInfo, 1);
+    CopyCommandNested(&storage, pSubpassEndInfo_copy, 1);
+    record->pSubpassEndInfo = pSubpassEndInfo_copy;
 }
 
 static VKAPI_ATTR void VKAPI_CALL ResetQueryPool(
@@ -1940,7 +7689,10 @@ static VKAPI_ATTR void VKAPI_CALL ResetQueryPool(
     uint32_t                                    firstQuery,
     uint32_t                                    queryCount)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkResetQueryPool, 0, device, queryPool);
+    QueryPool* pool = GetQueryPool(queryPool);
+    if (!pool) return;
+    for (uint32_t i = 0; i < queryCount; ++i) MakeQueryAvailable(pool, firstQuery + i, false);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL GetSemaphoreCounterValue(
@@ -1948,8 +7700,8 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetSemaphoreCounterValue(
     VkSemaphore                                 semaphore,
     uint64_t*                                   pValue)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetSemaphoreCounterValue, 0, device, semaphore);
+    return GetSemaphoreCounterValueKHR(device, semaphore, pValue);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL WaitSemaphores(
@@ -1957,22 +7709,23 @@ static VKAPI_ATTR VkResult VKAPI_CALL WaitSemaphores(
     const VkSemaphoreWaitInfo*                  pWaitInfo,
     uint64_t                                    timeout)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkWaitSemaphores, 0, device);
+    return WaitSemaphoresKHR(device, pWaitInfo, timeout);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL SignalSemaphore(
     VkDevice                                    device,
     const VkSemaphoreSignalInfo*                pSignalInfo)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkSignalSemaphore, 0, device);
+    return SignalSemaphoreKHR(device, pSignalInfo);
 }
 
 static VKAPI_ATTR VkDeviceAddress VKAPI_CALL GetBufferDeviceAddress(
     VkDevice                                    device,
     const VkBufferDeviceAddressInfo*            pInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetBufferDeviceAddress, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -1981,6 +7734,7 @@ static VKAPI_ATTR uint64_t VKAPI_CALL GetBufferOpaqueCaptureAddress(
     VkDevice                                    device,
     const VkBufferDeviceAddressInfo*            pInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetBufferOpaqueCaptureAddress, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -1989,6 +7743,7 @@ static VKAPI_ATTR uint64_t VKAPI_CALL GetDeviceMemoryOpaqueCaptureAddress(
     VkDevice                                    device,
     const VkDeviceMemoryOpaqueCaptureAddressInfo* pInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDeviceMemoryOpaqueCaptureAddress, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -1999,7 +7754,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroySurfaceKHR(
     VkSurfaceKHR                                surface,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroySurfaceKHR, 0, instance, surface);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkSurfaceKHR, surface != VK_NULL_HANDLE);
+    surface_khr_table.Destroy(surface);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfaceSupportKHR(
@@ -2008,6 +7765,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfaceSupportKHR(
     VkSurfaceKHR                                surface,
     VkBool32*                                   pSupported)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceSurfaceSupportKHR, 0, physicalDevice, surface);
     // Currently say that all surface/queue combos are supported
     *pSupported = VK_TRUE;
     return VK_SUCCESS;
@@ -2018,6 +7776,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfaceCapabilitiesKHR(
     VkSurfaceKHR                                surface,
     VkSurfaceCapabilitiesKHR*                   pSurfaceCapabilities)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceSurfaceCapabilitiesKHR, 0, physicalDevice, surface);
     // In general just say max supported is available for requested surface
     pSurfaceCapabilities->minImageCount = 1;
     pSurfaceCapabilities->maxImageCount = 0;
@@ -2059,6 +7818,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfaceFormatsKHR(
     uint32_t*                                   pSurfaceFormatCount,
     VkSurfaceFormatKHR*                         pSurfaceFormats)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceSurfaceFormatsKHR, 0, physicalDevice, surface);
     // Currently always say that RGBA8 & BGRA8 are supported
     if (!pSurfaceFormats) {
         *pSurfaceFormatCount = 2;
@@ -2084,6 +7844,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfacePresentModesKHR(
     uint32_t*                                   pPresentModeCount,
     VkPresentModeKHR*                           pPresentModes)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceSurfacePresentModesKHR, 0, physicalDevice, surface);
     // Currently always say that all present modes are supported
     if (!pPresentModes) {
         *pPresentModeCount = 6;
@@ -2120,8 +7881,45 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateSwapchainKHR(
     const VkAllocationCallbacks*                pAllocator,
     VkSwapchainKHR*                             pSwapchain)
 {
-    unique_lock_t lock(global_lock);
-    *pSwapchain = (VkSwapchainKHR)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateSwapchainKHR, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSwapchainKHR, 1);
+    Swapchain new_swapchain;
+    new_swapchain.present_mode = pCreateInfo->presentMode;
+    new_swapchain.format = pCreateInfo->imageFormat;
+    new_swapchain.extent = pCreateInfo->imageExtent;
+    // Swapchain images answer layout queries like the images the application creates
+    VkImageCreateInfo image_info = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+    image_info.flags = (pCreateInfo->flags & VK_SWAPCHAIN_CREATE_MUTABLE_FORMAT_BIT_KHR) ? VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT : 0;
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.format = pCreateInfo->imageFormat;
+    image_info.extent = {pCreateInfo->imageExtent.width, pCreateInfo->imageExtent.height, 1};
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = pCreateInfo->imageArrayLayers;
+    image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_info.usage = pCreateInfo->imageUsage;
+    image_info.sharingMode = pCreateInfo->imageSharingMode;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    const Image image_state = CreateImageState(image_info);
+    new_swapchain.image_size = (size_t)image_state.plane_offsets[MAX_FORMAT_PLANES];
+    new_swapchain.row_pitch = (size_t)image_state.subresources[0].rowPitch;
+    // One image is always on screen, so it takes two to have one to acquire
+    const uint32_t image_count = IsSharedPresentMode(pCreateInfo->presentMode) ? 1 : std::max(pCreateInfo->minImageCount, 2u);
+    for (uint32_t i = 0; i < image_count; ++i) {
+        void* data = AllocateBackingPages(std::max<size_t>(new_swapchain.image_size, 1));
+        if (!data) {
+            DestroySwapchainImages(&new_swapchain);
+            return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+        }
+        Image image = image_state;
+        image.swapchain_data = static_cast<char*>(data);
+        new_swapchain.images.push_back((VkImage)image_table.Create(std::move(image)));
+        new_swapchain.image_data.push_back(data);
+        new_swapchain.available.push_back(i);
+    }
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->sync_lock);
+    if (Swapchain* old_swapchain = swapchain_table.Get(pCreateInfo->oldSwapchain)) old_swapchain->retired = true;
+    *pSwapchain = (VkSwapchainKHR)swapchain_table.Create(std::move(new_swapchain));
     return VK_SUCCESS;
 }
 
@@ -2130,7 +7928,19 @@ static VKAPI_ATTR void VKAPI_CALL DestroySwapchainKHR(
     VkSwapchainKHR                              swapchain,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroySwapchainKHR, 0, device, swapchain);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkSwapchainKHR, swapchain != VK_NULL_HANDLE);
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->sync_lock);
+    if (Swapchain* destroyed_swapchain = swapchain_table.Get(swapchain)) {
+        // Presents still queued read the images, so the last of them destroys the swapchain instead
+        if (destroyed_swapchain->pending_presents) {
+            destroyed_swapchain->destroyed = true;
+            destroyed_swapchain->retired = true;
+        } else {
+            DestroySwapchainImages(destroyed_swapchain);
+            swapchain_table.Destroy(swapchain);
+        }
+    }
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL GetSwapchainImagesKHR(
@@ -2139,15 +7949,22 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetSwapchainImagesKHR(
     uint32_t*                                   pSwapchainImageCount,
     VkImage*                                    pSwapchainImages)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetSwapchainImagesKHR, 0, device, swapchain);
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->sync_lock);
+    const Swapchain* images_swapchain = swapchain_table.Get(swapchain);
+    if (!images_swapchain || images_swapchain->destroyed) {
+        *pSwapchainImageCount = 0;
+        return VK_ERROR_OUT_OF_DATE_KHR;
+    }
+    const std::vector<VkImage>& images = images_swapchain->images;
     if (!pSwapchainImages) {
-        *pSwapchainImageCount = 1;
-    } else if (*pSwapchainImageCount > 0) {
-        pSwapchainImages[0] = (VkImage)global_unique_handle++;
-        if (*pSwapchainImageCount != 1) {
-            return VK_INCOMPLETE;
-        }
+        *pSwapchainImageCount = (uint32_t)images.size();
+        return VK_SUCCESS;
     }
-    return VK_SUCCESS;
+    const uint32_t count = std::min(*pSwapchainImageCount, (uint32_t)images.size());
+    std::copy(images.begin(), images.begin() + count, pSwapchainImages);
+    *pSwapchainImageCount = count;
+    return count < images.size() ? VK_INCOMPLETE : VK_SUCCESS;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL AcquireNextImageKHR(
@@ -2158,22 +7975,43 @@ static VKAPI_ATTR VkResult VKAPI_CALL AcquireNextImageKHR(
     VkFence                                     fence,
     uint32_t*                                   pImageIndex)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkAcquireNextImageKHR, 0, device, swapchain, semaphore, fence);
+    return AcquireNextImage(reinterpret_cast<Device*>(device), swapchain, timeout, semaphore, fence, pImageIndex);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL QueuePresentKHR(
     VkQueue                                     queue,
     const VkPresentInfoKHR*                     pPresentInfo)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkQueuePresentKHR, 0, queue);
+    // Images go to the presentation engine once the semaphores are waited for in queue order
+    Queue* present_queue = reinterpret_cast<Queue*>(queue);
+    std::vector<Submission> submissions(1);
+    VkResult result = VK_SUCCESS;
+    unique_lock_t lock(present_queue->device->sync_lock);
+    for (uint32_t i = 0; i < pPresentInfo->waitSemaphoreCount; ++i) AddSemaphoreWait(&submissions[0], pPresentInfo->pWaitSemaphores[i], 0);
+    for (uint32_t i = 0; i < pPresentInfo->swapchainCount; ++i) {
+        // Images of a swapchain that was replaced are not shown any more
+        Swapchain* swapchain = swapchain_table.Get(pPresentInfo->pSwapchains[i]);
+        const VkResult swapchain_result = swapchain && !swapchain->retired ? VK_SUCCESS : VK_ERROR_OUT_OF_DATE_KHR;
+        if (swapchain_result == VK_SUCCESS) {
+            swapchain->pending_presents++;
+            submissions[0].presents.emplace_back(pPresentInfo->pSwapchains[i], pPresentInfo->pImageIndices[i]);
+        } else {
+            result = swapchain_result;
+        }
+        if (pPresentInfo->pResults) pPresentInfo->pResults[i] = swapchain_result;
+    }
+    lock.unlock();
+    EnqueueSubmissions(present_queue, submissions);
+    return result;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL GetDeviceGroupPresentCapabilitiesKHR(
     VkDevice                                    device,
     VkDeviceGroupPresentCapabilitiesKHR*        pDeviceGroupPresentCapabilities)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDeviceGroupPresentCapabilitiesKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2183,6 +8021,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetDeviceGroupSurfacePresentModesKHR(
     VkSurfaceKHR                                surface,
     VkDeviceGroupPresentModeFlagsKHR*           pModes)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDeviceGroupSurfacePresentModesKHR, 0, device, surface);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2193,6 +8032,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDevicePresentRectanglesKHR(
     uint32_t*                                   pRectCount,
     VkRect2D*                                   pRects)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDevicePresentRectanglesKHR, 0, physicalDevice, surface);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2202,8 +8042,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL AcquireNextImage2KHR(
     const VkAcquireNextImageInfoKHR*            pAcquireInfo,
     uint32_t*                                   pImageIndex)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkAcquireNextImage2KHR, 0, device);
+    return AcquireNextImage(reinterpret_cast<Device*>(device), pAcquireInfo->swapchain, pAcquireInfo->timeout, pAcquireInfo->semaphore,
+                            pAcquireInfo->fence, pImageIndex);
 }
 
 
@@ -2212,6 +8053,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceDisplayPropertiesKHR(
     uint32_t*                                   pPropertyCount,
     VkDisplayPropertiesKHR*                     pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceDisplayPropertiesKHR, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2221,6 +8063,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceDisplayPlanePropertiesKHR
     uint32_t*                                   pPropertyCount,
     VkDisplayPlanePropertiesKHR*                pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceDisplayPlanePropertiesKHR, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2231,6 +8074,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetDisplayPlaneSupportedDisplaysKHR(
     uint32_t*                                   pDisplayCount,
     VkDisplayKHR*                               pDisplays)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDisplayPlaneSupportedDisplaysKHR, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2241,6 +8085,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetDisplayModePropertiesKHR(
     uint32_t*                                   pPropertyCount,
     VkDisplayModePropertiesKHR*                 pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDisplayModePropertiesKHR, 0, physicalDevice, display);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2252,8 +8097,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateDisplayModeKHR(
     const VkAllocationCallbacks*                pAllocator,
     VkDisplayModeKHR*                           pMode)
 {
-    unique_lock_t lock(global_lock);
-    *pMode = (VkDisplayModeKHR)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateDisplayModeKHR, 0, physicalDevice, display);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkDisplayModeKHR, 1);
+    *pMode = (VkDisplayModeKHR)display_mode_khr_table.Create();
     return VK_SUCCESS;
 }
 
@@ -2263,6 +8109,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetDisplayPlaneCapabilitiesKHR(
     uint32_t                                    planeIndex,
     VkDisplayPlaneCapabilitiesKHR*              pCapabilities)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDisplayPlaneCapabilitiesKHR, 0, physicalDevice, mode);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2273,8 +8120,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateDisplayPlaneSurfaceKHR(
     const VkAllocationCallbacks*                pAllocator,
     VkSurfaceKHR*                               pSurface)
 {
-    unique_lock_t lock(global_lock);
-    *pSurface = (VkSurfaceKHR)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateDisplayPlaneSurfaceKHR, 0, instance);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSurfaceKHR, 1);
+    *pSurface = (VkSurfaceKHR)surface_khr_table.Create();
     return VK_SUCCESS;
 }
 
@@ -2286,9 +8134,10 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateSharedSwapchainsKHR(
     const VkAllocationCallbacks*                pAllocator,
     VkSwapchainKHR*                             pSwapchains)
 {
-    unique_lock_t lock(global_lock);
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateSharedSwapchainsKHR, swapchainCount, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSwapchainKHR, swapchainCount);
     for (uint32_t i = 0; i < swapchainCount; ++i) {
-        pSwapchains[i] = (VkSwapchainKHR)global_unique_handle++;
+        pSwapchains[i] = (VkSwapchainKHR)swapchain_table.Create();
     }
     return VK_SUCCESS;
 }
@@ -2301,8 +8150,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateXlibSurfaceKHR(
     const VkAllocationCallbacks*                pAllocator,
     VkSurfaceKHR*                               pSurface)
 {
-    unique_lock_t lock(global_lock);
-    *pSurface = (VkSurfaceKHR)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateXlibSurfaceKHR, 0, instance);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSurfaceKHR, 1);
+    *pSurface = (VkSurfaceKHR)surface_khr_table.Create();
     return VK_SUCCESS;
 }
 
@@ -2312,6 +8162,7 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL GetPhysicalDeviceXlibPresentationSupportKH
     Display*                                    dpy,
     VisualID                                    visualID)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceXlibPresentationSupportKHR, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2325,8 +8176,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateXcbSurfaceKHR(
     const VkAllocationCallbacks*                pAllocator,
     VkSurfaceKHR*                               pSurface)
 {
-    unique_lock_t lock(global_lock);
-    *pSurface = (VkSurfaceKHR)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateXcbSurfaceKHR, 0, instance);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSurfaceKHR, 1);
+    *pSurface = (VkSurfaceKHR)surface_khr_table.Create();
     return VK_SUCCESS;
 }
 
@@ -2336,6 +8188,7 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL GetPhysicalDeviceXcbPresentationSupportKHR
     xcb_connection_t*                           connection,
     xcb_visualid_t                              visual_id)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceXcbPresentationSupportKHR, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2349,8 +8202,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateWaylandSurfaceKHR(
     const VkAllocationCallbacks*                pAllocator,
     VkSurfaceKHR*                               pSurface)
 {
-    unique_lock_t lock(global_lock);
-    *pSurface = (VkSurfaceKHR)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateWaylandSurfaceKHR, 0, instance);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSurfaceKHR, 1);
+    *pSurface = (VkSurfaceKHR)surface_khr_table.Create();
     return VK_SUCCESS;
 }
 
@@ -2359,6 +8213,7 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL GetPhysicalDeviceWaylandPresentationSuppor
     uint32_t                                    queueFamilyIndex,
     struct wl_display*                          display)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceWaylandPresentationSupportKHR, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2372,8 +8227,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateAndroidSurfaceKHR(
     const VkAllocationCallbacks*                pAllocator,
     VkSurfaceKHR*                               pSurface)
 {
-    unique_lock_t lock(global_lock);
-    *pSurface = (VkSurfaceKHR)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateAndroidSurfaceKHR, 0, instance);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSurfaceKHR, 1);
+    *pSurface = (VkSurfaceKHR)surface_khr_table.Create();
     return VK_SUCCESS;
 }
 #endif /* VK_USE_PLATFORM_ANDROID_KHR */
@@ -2386,8 +8242,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateWin32SurfaceKHR(
     const VkAllocationCallbacks*                pAllocator,
     VkSurfaceKHR*                               pSurface)
 {
-    unique_lock_t lock(global_lock);
-    *pSurface = (VkSurfaceKHR)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateWin32SurfaceKHR, 0, instance);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSurfaceKHR, 1);
+    *pSurface = (VkSurfaceKHR)surface_khr_table.Create();
     return VK_SUCCESS;
 }
 
@@ -2395,6 +8252,7 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL GetPhysicalDeviceWin32PresentationSupportK
     VkPhysicalDevice                            physicalDevice,
     uint32_t                                    queueFamilyIndex)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceWin32PresentationSupportKHR, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2407,6 +8265,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceFeatures2KHR(
     VkPhysicalDevice                            physicalDevice,
     VkPhysicalDeviceFeatures2*                  pFeatures)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceFeatures2KHR, 0, physicalDevice);
     GetPhysicalDeviceFeatures(physicalDevice, &pFeatures->features);
     uint32_t num_bools = 0; // Count number of VkBool32s in extension structs
     VkBool32* feat_bools = nullptr;
@@ -2424,12 +8283,21 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceFeatures2KHR(
         feat_bools = (VkBool32*)&blendop_features->advancedBlendCoherentOperations;
         SetBoolArrayTrue(feat_bools, num_bools);
     }
+    const auto *timeline_features = lvl_find_in_chain<VkPhysicalDeviceTimelineSemaphoreFeatures>(pFeatures->pNext);
+    if (timeline_features) {
+        ((VkPhysicalDeviceTimelineSemaphoreFeatures*)timeline_features)->timelineSemaphore = VK_TRUE;
+    }
+    const auto *host_query_reset_features = lvl_find_in_chain<VkPhysicalDeviceHostQueryResetFeatures>(pFeatures->pNext);
+    if (host_query_reset_features) {
+        ((VkPhysicalDeviceHostQueryResetFeatures*)host_query_reset_features)->hostQueryReset = VK_TRUE;
+    }
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceProperties2KHR(
     VkPhysicalDevice                            physicalDevice,
     VkPhysicalDeviceProperties2*                pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceProperties2KHR, 0, physicalDevice);
     GetPhysicalDeviceProperties(physicalDevice, &pProperties->properties);
     const auto *desc_idx_props = lvl_find_in_chain<VkPhysicalDeviceDescriptorIndexingPropertiesEXT>(pProperties->pNext);
     if (desc_idx_props) {
@@ -2471,6 +8339,24 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceProperties2KHR(
         write_props->supportedDepthResolveModes = VK_RESOLVE_MODE_SAMPLE_ZERO_BIT_KHR;
         write_props->supportedStencilResolveModes = VK_RESOLVE_MODE_SAMPLE_ZERO_BIT_KHR;
     }
+
+    const auto *timeline_semaphore_props = lvl_find_in_chain<VkPhysicalDeviceTimelineSemaphoreProperties>(pProperties->pNext);
+    if (timeline_semaphore_props) {
+        VkPhysicalDeviceTimelineSemaphoreProperties* write_props = (VkPhysicalDeviceTimelineSemaphoreProperties*)timeline_semaphore_props;
+        write_props->maxTimelineSemaphoreValueDifference = UINT64_MAX;
+    }
+
+    const auto *id_props = lvl_find_in_chain<VkPhysicalDeviceIDProperties>(pProperties->pNext);
+    if (id_props) {
+        VkPhysicalDeviceIDProperties* write_props = (VkPhysicalDeviceIDProperties*)id_props;
+        // Physical devices only differ in the last byte of their UUID
+        memcpy(write_props->deviceUUID, PIPELINE_CACHE_UUID, VK_UUID_SIZE);
+        write_props->deviceUUID[VK_UUID_SIZE - 1] = (uint8_t)reinterpret_cast<PhysicalDevice*>(physicalDevice)->index;
+        memcpy(write_props->driverUUID, PIPELINE_CACHE_UUID, VK_UUID_SIZE);
+        memset(write_props->deviceLUID, 0, VK_LUID_SIZE);
+        write_props->deviceNodeMask = 0;
+        write_props->deviceLUIDValid = VK_FALSE;
+    }
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceFormatProperties2KHR(
@@ -2478,6 +8364,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceFormatProperties2KHR(
     VkFormat                                    format,
     VkFormatProperties2*                        pFormatProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceFormatProperties2KHR, 0, physicalDevice);
     GetPhysicalDeviceFormatProperties(physicalDevice, format, &pFormatProperties->formatProperties);
 }
 
@@ -2486,8 +8373,8 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceImageFormatProperties2KHR
     const VkPhysicalDeviceImageFormatInfo2*     pImageFormatInfo,
     VkImageFormatProperties2*                   pImageFormatProperties)
 {
-    GetPhysicalDeviceImageFormatProperties(physicalDevice, pImageFormatInfo->format, pImageFormatInfo->type, pImageFormatInfo->tiling, pImageFormatInfo->usage, pImageFormatInfo->flags, &pImageFormatProperties->imageFormatProperties);
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceImageFormatProperties2KHR, 0, physicalDevice);
+    return GetPhysicalDeviceImageFormatProperties(physicalDevice, pImageFormatInfo->format, pImageFormatInfo->type, pImageFormatInfo->tiling, pImageFormatInfo->usage, pImageFormatInfo->flags, &pImageFormatProperties->imageFormatProperties);
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceQueueFamilyProperties2KHR(
@@ -2495,10 +8382,14 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceQueueFamilyProperties2KHR(
     uint32_t*                                   pQueueFamilyPropertyCount,
     VkQueueFamilyProperties2*                   pQueueFamilyProperties)
 {
-    if (pQueueFamilyPropertyCount && pQueueFamilyProperties) {
-        GetPhysicalDeviceQueueFamilyProperties(physicalDevice, pQueueFamilyPropertyCount, &pQueueFamilyProperties->queueFamilyProperties);
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceQueueFamilyProperties2KHR, 0, physicalDevice);
+    if (!pQueueFamilyProperties) {
+        *pQueueFamilyPropertyCount = device_profile.queue_family_count;
     } else {
-        GetPhysicalDeviceQueueFamilyProperties(physicalDevice, pQueueFamilyPropertyCount, nullptr);
+        *pQueueFamilyPropertyCount = std::min(*pQueueFamilyPropertyCount, device_profile.queue_family_count);
+        for (uint32_t i = 0; i < *pQueueFamilyPropertyCount; ++i) {
+            pQueueFamilyProperties[i].queueFamilyProperties = device_profile.queue_families[i];
+        }
     }
 }
 
@@ -2506,7 +8397,19 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceMemoryProperties2KHR(
     VkPhysicalDevice                            physicalDevice,
     VkPhysicalDeviceMemoryProperties2*          pMemoryProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceMemoryProperties2KHR, 0, physicalDevice);
     GetPhysicalDeviceMemoryProperties(physicalDevice, &pMemoryProperties->memoryProperties);
+    const auto *budget_props = lvl_find_in_chain<VkPhysicalDeviceMemoryBudgetPropertiesEXT>(pMemoryProperties->pNext);
+    if (budget_props) {
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT* write_props = (VkPhysicalDeviceMemoryBudgetPropertiesEXT*)budget_props;
+        const VkPhysicalDeviceMemoryProperties& memory_properties = device_profile.memory_properties;
+        const PhysicalDevice* physical_device = reinterpret_cast<PhysicalDevice*>(physicalDevice);
+        for (uint32_t i = 0; i < VK_MAX_MEMORY_HEAPS; ++i) {
+            const bool used = i < memory_properties.memoryHeapCount;
+            write_props->heapBudget[i] = used ? memory_properties.memoryHeaps[i].size : 0;
+            write_props->heapUsage[i] = used ? physical_device->heap_usage[i].load(std::memory_order_relaxed) : 0;
+        }
+    }
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceSparseImageFormatProperties2KHR(
@@ -2515,6 +8418,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceSparseImageFormatProperties2K
     uint32_t*                                   pPropertyCount,
     VkSparseImageFormatProperties2*             pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceSparseImageFormatProperties2KHR, 0, physicalDevice);
 //Not a CREATE or DESTROY function
 }
 
@@ -2526,14 +8430,18 @@ static VKAPI_ATTR void VKAPI_CALL GetDeviceGroupPeerMemoryFeaturesKHR(
     uint32_t                                    remoteDeviceIndex,
     VkPeerMemoryFeatureFlags*                   pPeerMemoryFeatures)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDeviceGroupPeerMemoryFeaturesKHR, 0, device);
+    // The physical devices of a group share all their memory
+    *pPeerMemoryFeatures = VK_PEER_MEMORY_FEATURE_COPY_SRC_BIT | VK_PEER_MEMORY_FEATURE_COPY_DST_BIT |
+                           VK_PEER_MEMORY_FEATURE_GENERIC_SRC_BIT | VK_PEER_MEMORY_FEATURE_GENERIC_DST_BIT;
 }
 
 static VKAPI_ATTR void VKAPI_CALL CmdSetDeviceMaskKHR(
     VkCommandBuffer                             commandBuffer,
     uint32_t                                    deviceMask)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetDeviceMaskKHR, 0, commandBuffer);
+    CmdSetDeviceMask(commandBuffer, deviceMask);
 }
 
 static VKAPI_ATTR void VKAPI_CALL CmdDispatchBaseKHR(
@@ -2545,7 +8453,8 @@ static VKAPI_ATTR void VKAPI_CALL CmdDispatchBaseKHR(
     uint32_t                                    groupCountY,
     uint32_t                                    groupCountZ)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDispatchBaseKHR, 0, commandBuffer);
+    CmdDispatchBase(commandBuffer, baseGroupX, baseGroupY, baseGroupZ, groupCountX, groupCountY, groupCountZ);
 }
 
 
@@ -2555,6 +8464,7 @@ static VKAPI_ATTR void VKAPI_CALL TrimCommandPoolKHR(
     VkCommandPool                               commandPool,
     VkCommandPoolTrimFlags                      flags)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkTrimCommandPoolKHR, 0, device, commandPool);
 //Not a CREATE or DESTROY function
 }
 
@@ -2564,8 +8474,24 @@ static VKAPI_ATTR VkResult VKAPI_CALL EnumeratePhysicalDeviceGroupsKHR(
     uint32_t*                                   pPhysicalDeviceGroupCount,
     VkPhysicalDeviceGroupProperties*            pPhysicalDeviceGroupProperties)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkEnumeratePhysicalDeviceGroupsKHR, 0, instance);
+    InitPhysicalDevices();
+    const uint32_t group_count = physical_device_group ? 1 : physical_device_count;
+    if (!pPhysicalDeviceGroupProperties) {
+        *pPhysicalDeviceGroupCount = group_count;
+        return VK_SUCCESS;
+    }
+    const uint32_t count = std::min(*pPhysicalDeviceGroupCount, group_count);
+    for (uint32_t i = 0; i < count; ++i) {
+        VkPhysicalDeviceGroupProperties& group = pPhysicalDeviceGroupProperties[i];
+        group.physicalDeviceCount = physical_device_group ? physical_device_count : 1;
+        for (uint32_t j = 0; j < group.physicalDeviceCount; ++j) {
+            group.physicalDevices[j] = reinterpret_cast<VkPhysicalDevice>(physical_devices[physical_device_group ? j : i]);
+        }
+        group.subsetAllocation = group.physicalDeviceCount > 1;
+    }
+    *pPhysicalDeviceGroupCount = count;
+    return count < group_count ? VK_INCOMPLETE : VK_SUCCESS;
 }
 
 
@@ -2574,6 +8500,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceExternalBufferPropertiesKHR(
     const VkPhysicalDeviceExternalBufferInfo*   pExternalBufferInfo,
     VkExternalBufferProperties*                 pExternalBufferProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceExternalBufferPropertiesKHR, 0, physicalDevice);
     GetPhysicalDeviceExternalBufferProperties(physicalDevice, pExternalBufferInfo, pExternalBufferProperties);
 }
 
@@ -2585,6 +8512,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetMemoryWin32HandleKHR(
     const VkMemoryGetWin32HandleInfoKHR*        pGetWin32HandleInfo,
     HANDLE*                                     pHandle)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetMemoryWin32HandleKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2595,6 +8523,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetMemoryWin32HandlePropertiesKHR(
     HANDLE                                      handle,
     VkMemoryWin32HandlePropertiesKHR*           pMemoryWin32HandleProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetMemoryWin32HandlePropertiesKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2606,8 +8535,17 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetMemoryFdKHR(
     const VkMemoryGetFdInfoKHR*                 pGetFdInfo,
     int*                                        pFd)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetMemoryFdKHR, 0, device);
+    DeviceMemory* device_memory = device_memory_table.Get(pGetFdInfo->memory);
+    if (!device_memory || device_memory->fd < 0) return VK_ERROR_TOO_MANY_OBJECTS;
+#if defined(__linux__)
+    // Each export hands out a new reference to the same memfd, owned by the application
+    *pFd = dup(device_memory->fd);
+    if (*pFd < 0) return VK_ERROR_TOO_MANY_OBJECTS;
     return VK_SUCCESS;
+#else
+    return VK_ERROR_TOO_MANY_OBJECTS;
+#endif
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL GetMemoryFdPropertiesKHR(
@@ -2616,7 +8554,10 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetMemoryFdPropertiesKHR(
     int                                         fd,
     VkMemoryFdPropertiesKHR*                    pMemoryFdProperties)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetMemoryFdPropertiesKHR, 0, device);
+    // Opaque fds are imported through AllocateInfo, only non-opaque types report properties
+    if (handleType == VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT) return VK_ERROR_INVALID_EXTERNAL_HANDLE;
+    pMemoryFdProperties->memoryTypeBits = 0x3;
     return VK_SUCCESS;
 }
 
@@ -2629,6 +8570,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceExternalSemaphorePropertiesKH
     const VkPhysicalDeviceExternalSemaphoreInfo* pExternalSemaphoreInfo,
     VkExternalSemaphoreProperties*              pExternalSemaphoreProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceExternalSemaphorePropertiesKHR, 0, physicalDevice);
     GetPhysicalDeviceExternalSemaphoreProperties(physicalDevice, pExternalSemaphoreInfo, pExternalSemaphoreProperties);
 }
 
@@ -2639,6 +8581,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL ImportSemaphoreWin32HandleKHR(
     VkDevice                                    device,
     const VkImportSemaphoreWin32HandleInfoKHR*  pImportSemaphoreWin32HandleInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkImportSemaphoreWin32HandleKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2648,6 +8591,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetSemaphoreWin32HandleKHR(
     const VkSemaphoreGetWin32HandleInfoKHR*     pGetWin32HandleInfo,
     HANDLE*                                     pHandle)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetSemaphoreWin32HandleKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2658,6 +8602,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL ImportSemaphoreFdKHR(
     VkDevice                                    device,
     const VkImportSemaphoreFdInfoKHR*           pImportSemaphoreFdInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkImportSemaphoreFdKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2667,11 +8612,28 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetSemaphoreFdKHR(
     const VkSemaphoreGetFdInfoKHR*              pGetFdInfo,
     int*                                        pFd)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetSemaphoreFdKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
 
 
+struct CmdPushDescriptorSetKHRRecord {
+    static const CommandInfo info;
+    VkPipelineBindPoint pipelineBindPoint;
+    VkPipelineLayout layout;
+    uint32_t set;
+    uint32_t descriptorWriteCount;
+    const VkWriteDescriptorSet* pDescriptorWrites;
+};
+static void ExecuteCmdPushDescriptorSetKHR(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdPushDescriptorSetKHRRecord*>(data);
+    BindPointState* state = GetBindPointState(context, record.pipelineBindPoint);
+    if (!state) return;
+    ExecutePushDescriptorSet(state, record.set, record.descriptorWriteCount, record.pDescriptorWrites);
+}
+const CommandInfo CmdPushDescriptorSetKHRRecord::info = {"vkCmdPushDescriptorSetKHR", ExecuteCmdPushDescriptorSetKHR};
+
 static VKAPI_ATTR void VKAPI_CALL CmdPushDescriptorSetKHR(
     VkCommandBuffer                             commandBuffer,
     VkPipelineBindPoint                         pipelineBindPoint,
@@ -2680,8 +8642,27 @@ static VKAPI_ATTR void VKAPI_CALL CmdPushDescriptorSetKHR(
     uint32_t                                    descriptorWriteCount,
     const VkWriteDescriptorSet*                 pDescriptorWrites)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdPushDescriptorSetKHR, descriptorWriteCount, commandBuffer, layout);
+    char* storage;
+    auto record = RecordCommand<CmdPushDescriptorSetKHRRecord>(commandBuffer, CommandArraySize(pDescriptorWrites, descriptorWriteCount) + CommandNestedSize(pDescriptorWrites, descriptorWriteCount), &storage);
+    if (!record) return;
+    record->pipelineBindPoint = pipelineBindPoint;
+    record->layout = layout;
+    record->set = set;
+    record->descriptorWriteCount = descriptorWriteCount;
+    auto pDescriptorWrites_copy = CopyCommandArray(&storage, pDescriptorWrites, descriptorWriteCount);
+    CopyCommandNested(&storage, pDescriptorWrites_copy, descriptorWriteCount);
+    record->pDescriptorWrites = pDescriptorWrites_copy;
+}
+
+struct CmdPushDescriptorSetWithTemplateKHRRecord {
+    static const CommandInfo info;
+    VkDescriptorUpdateTemplate descriptorUpdateTemplate;
+    VkPipelineLayout layout;
+    uint32_t set;
+    const void* pData;
+};
+const CommandInfo CmdPushDescriptorSetWithTemplateKHRRecord::info = {"vkCmdPushDescriptorSetWithTemplateKHR", nullptr};
 
 static VKAPI_ATTR void VKAPI_CALL CmdPushDescriptorSetWithTemplateKHR(
     VkCommandBuffer                             commandBuffer,
@@ -2690,7 +8671,13 @@ static VKAPI_ATTR void VKAPI_CALL CmdPushDescriptorSetWithTemplateKHR(
     uint32_t                                    set,
     const void*                                 pData)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdPushDescriptorSetWithTemplateKHR, 0, commandBuffer, descriptorUpdateTemplate, layout);
+    auto record = RecordCommand<CmdPushDescriptorSetWithTemplateKHRRecord>(commandBuffer);
+    if (!record) return;
+    record->descriptorUpdateTemplate = descriptorUpdateTemplate;
+    record->layout = layout;
+    record->set = set;
+    record->pData = pData;
 }
 
 
@@ -2703,8 +8690,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateDescriptorUpdateTemplateKHR(
     const VkAllocationCallbacks*                pAllocator,
     VkDescriptorUpdateTemplate*                 pDescriptorUpdateTemplate)
 {
-    unique_lock_t lock(global_lock);
-    *pDescriptorUpdateTemplate = (VkDescriptorUpdateTemplate)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateDescriptorUpdateTemplateKHR, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkDescriptorUpdateTemplate, 1);
+    *pDescriptorUpdateTemplate = (VkDescriptorUpdateTemplate)descriptor_update_template_table.Create();
     return VK_SUCCESS;
 }
 
@@ -2713,7 +8701,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyDescriptorUpdateTemplateKHR(
     VkDescriptorUpdateTemplate                  descriptorUpdateTemplate,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyDescriptorUpdateTemplateKHR, 0, device, descriptorUpdateTemplate);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkDescriptorUpdateTemplate, descriptorUpdateTemplate != VK_NULL_HANDLE);
+    descriptor_update_template_table.Destroy(descriptorUpdateTemplate);
 }
 
 static VKAPI_ATTR void VKAPI_CALL UpdateDescriptorSetWithTemplateKHR(
@@ -2722,6 +8712,7 @@ static VKAPI_ATTR void VKAPI_CALL UpdateDescriptorSetWithTemplateKHR(
     VkDescriptorUpdateTemplate                  descriptorUpdateTemplate,
     const void*                                 pData)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkUpdateDescriptorSetWithTemplateKHR, 0, device, descriptorSet, descriptorUpdateTemplate);
 //Not a CREATE or DESTROY function
 }
 
@@ -2733,8 +8724,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateRenderPass2KHR(
     const VkAllocationCallbacks*                pAllocator,
     VkRenderPass*                               pRenderPass)
 {
-    unique_lock_t lock(global_lock);
-    *pRenderPass = (VkRenderPass)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateRenderPass2KHR, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkRenderPass, 1);
+    *pRenderPass = (VkRenderPass)render_pass_table.Create(CreateRenderPassState(*pCreateInfo));
     return VK_SUCCESS;
 }
 
@@ -2743,7 +8735,8 @@ static VKAPI_ATTR void VKAPI_CALL CmdBeginRenderPass2KHR(
     const VkRenderPassBeginInfo*                pRenderPassBegin,
     const VkSubpassBeginInfo*                   pSubpassBeginInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBeginRenderPass2KHR, 0, commandBuffer);
+    CmdBeginRenderPass2(commandBuffer, pRenderPassBegin, pSubpassBeginInfo);
 }
 
 static VKAPI_ATTR void VKAPI_CALL CmdNextSubpass2KHR(
@@ -2751,14 +8744,16 @@ static VKAPI_ATTR void VKAPI_CALL CmdNextSubpass2KHR(
     const VkSubpassBeginInfo*                   pSubpassBeginInfo,
     const VkSubpassEndInfo*                     pSubpassEndInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdNextSubpass2KHR, 0, commandBuffer);
+    CmdNextSubpass2(commandBuffer, pSubpassBeginInfo, pSubpassEndInfo);
 }
 
 static VKAPI_ATTR void VKAPI_CALL CmdEndRenderPass2KHR(
     VkCommandBuffer                             commandBuffer,
     const VkSubpassEndInfo*                     pSubpassEndInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdEndRenderPass2KHR, 0, commandBuffer);
+    CmdEndRenderPass2(commandBuffer, pSubpassEndInfo);
 }
 
 
@@ -2766,6 +8761,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetSwapchainStatusKHR(
     VkDevice                                    device,
     VkSwapchainKHR                              swapchain)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetSwapchainStatusKHR, 0, device, swapchain);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2776,6 +8772,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceExternalFencePropertiesKHR(
     const VkPhysicalDeviceExternalFenceInfo*    pExternalFenceInfo,
     VkExternalFenceProperties*                  pExternalFenceProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceExternalFencePropertiesKHR, 0, physicalDevice);
     GetPhysicalDeviceExternalFenceProperties(physicalDevice, pExternalFenceInfo, pExternalFenceProperties);
 }
 
@@ -2786,6 +8783,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL ImportFenceWin32HandleKHR(
     VkDevice                                    device,
     const VkImportFenceWin32HandleInfoKHR*      pImportFenceWin32HandleInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkImportFenceWin32HandleKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2795,6 +8793,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetFenceWin32HandleKHR(
     const VkFenceGetWin32HandleInfoKHR*         pGetWin32HandleInfo,
     HANDLE*                                     pHandle)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetFenceWin32HandleKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2805,6 +8804,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL ImportFenceFdKHR(
     VkDevice                                    device,
     const VkImportFenceFdInfoKHR*               pImportFenceFdInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkImportFenceFdKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2814,6 +8814,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetFenceFdKHR(
     const VkFenceGetFdInfoKHR*                  pGetFdInfo,
     int*                                        pFd)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetFenceFdKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2826,6 +8827,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL EnumeratePhysicalDeviceQueueFamilyPerforma
     VkPerformanceCounterKHR*                    pCounters,
     VkPerformanceCounterDescriptionKHR*         pCounterDescriptions)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2835,6 +8837,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceQueueFamilyPerformanceQueryPa
     const VkQueryPoolPerformanceCreateInfoKHR*  pPerformanceQueryCreateInfo,
     uint32_t*                                   pNumPasses)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR, 0, physicalDevice);
 //Not a CREATE or DESTROY function
 }
 
@@ -2842,6 +8845,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL AcquireProfilingLockKHR(
     VkDevice                                    device,
     const VkAcquireProfilingLockInfoKHR*        pInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkAcquireProfilingLockKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2849,6 +8853,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL AcquireProfilingLockKHR(
 static VKAPI_ATTR void VKAPI_CALL ReleaseProfilingLockKHR(
     VkDevice                                    device)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkReleaseProfilingLockKHR, 0, device);
 //Not a CREATE or DESTROY function
 }
 
@@ -2859,6 +8864,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfaceCapabilities2KHR(
     const VkPhysicalDeviceSurfaceInfo2KHR*      pSurfaceInfo,
     VkSurfaceCapabilities2KHR*                  pSurfaceCapabilities)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceSurfaceCapabilities2KHR, 0, physicalDevice);
     GetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, pSurfaceInfo->surface, &pSurfaceCapabilities->surfaceCapabilities);
     return VK_SUCCESS;
 }
@@ -2869,6 +8875,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfaceFormats2KHR(
     uint32_t*                                   pSurfaceFormatCount,
     VkSurfaceFormat2KHR*                        pSurfaceFormats)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceSurfaceFormats2KHR, 0, physicalDevice);
     // Currently always say that RGBA8 & BGRA8 are supported
     if (!pSurfaceFormats) {
         *pSurfaceFormatCount = 2;
@@ -2897,6 +8904,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceDisplayProperties2KHR(
     uint32_t*                                   pPropertyCount,
     VkDisplayProperties2KHR*                    pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceDisplayProperties2KHR, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2906,6 +8914,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceDisplayPlaneProperties2KH
     uint32_t*                                   pPropertyCount,
     VkDisplayPlaneProperties2KHR*               pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceDisplayPlaneProperties2KHR, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2916,6 +8925,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetDisplayModeProperties2KHR(
     uint32_t*                                   pPropertyCount,
     VkDisplayModeProperties2KHR*                pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDisplayModeProperties2KHR, 0, physicalDevice, display);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2925,6 +8935,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetDisplayPlaneCapabilities2KHR(
     const VkDisplayPlaneInfo2KHR*               pDisplayPlaneInfo,
     VkDisplayPlaneCapabilities2KHR*             pCapabilities)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDisplayPlaneCapabilities2KHR, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -2938,7 +8949,16 @@ static VKAPI_ATTR void VKAPI_CALL GetImageMemoryRequirements2KHR(
     const VkImageMemoryRequirementsInfo2*       pInfo,
     VkMemoryRequirements2*                      pMemoryRequirements)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetImageMemoryRequirements2KHR, 0, device);
     GetImageMemoryRequirements(device, pInfo->image, &pMemoryRequirements->memoryRequirements);
+    // The planes of disjoint images are bound one at a time
+    const auto *plane_info = lvl_find_in_chain<VkImagePlaneMemoryRequirementsInfo>(pInfo->pNext);
+    const Image* image_state = image_table.Get(pInfo->image);
+    if (plane_info && image_state && (image_state->create_info.flags & VK_IMAGE_CREATE_DISJOINT_BIT)) {
+        const uint32_t plane = GetAspectPlane(plane_info->planeAspect);
+        const VkDeviceSize plane_size = image_state->plane_offsets[plane + 1] - image_state->plane_offsets[plane];
+        pMemoryRequirements->memoryRequirements.size = AlignDeviceSize(plane_size, IMAGE_ALIGNMENT);
+    }
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetBufferMemoryRequirements2KHR(
@@ -2946,6 +8966,7 @@ static VKAPI_ATTR void VKAPI_CALL GetBufferMemoryRequirements2KHR(
     const VkBufferMemoryRequirementsInfo2*      pInfo,
     VkMemoryRequirements2*                      pMemoryRequirements)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetBufferMemoryRequirements2KHR, 0, device);
     GetBufferMemoryRequirements(device, pInfo->buffer, &pMemoryRequirements->memoryRequirements);
 }
 
@@ -2955,6 +8976,7 @@ static VKAPI_ATTR void VKAPI_CALL GetImageSparseMemoryRequirements2KHR(
     uint32_t*                                   pSparseMemoryRequirementCount,
     VkSparseImageMemoryRequirements2*           pSparseMemoryRequirements)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetImageSparseMemoryRequirements2KHR, 0, device);
 //Not a CREATE or DESTROY function
 }
 
@@ -2966,8 +8988,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateSamplerYcbcrConversionKHR(
     const VkAllocationCallbacks*                pAllocator,
     VkSamplerYcbcrConversion*                   pYcbcrConversion)
 {
-    unique_lock_t lock(global_lock);
-    *pYcbcrConversion = (VkSamplerYcbcrConversion)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateSamplerYcbcrConversionKHR, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSamplerYcbcrConversion, 1);
+    *pYcbcrConversion = (VkSamplerYcbcrConversion)sampler_ycbcr_conversion_table.Create();
     return VK_SUCCESS;
 }
 
@@ -2976,7 +8999,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroySamplerYcbcrConversionKHR(
     VkSamplerYcbcrConversion                    ycbcrConversion,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroySamplerYcbcrConversionKHR, 0, device, ycbcrConversion);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkSamplerYcbcrConversion, ycbcrConversion != VK_NULL_HANDLE);
+    sampler_ycbcr_conversion_table.Destroy(ycbcrConversion);
 }
 
 
@@ -2985,7 +9010,10 @@ static VKAPI_ATTR VkResult VKAPI_CALL BindBufferMemory2KHR(
     uint32_t                                    bindInfoCount,
     const VkBindBufferMemoryInfo*               pBindInfos)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkBindBufferMemory2KHR, bindInfoCount, device);
+    for (uint32_t i = 0; i < bindInfoCount; ++i) {
+        BindBufferMemory(device, pBindInfos[i].buffer, pBindInfos[i].memory, pBindInfos[i].memoryOffset);
+    }
     return VK_SUCCESS;
 }
 
@@ -2994,7 +9022,16 @@ static VKAPI_ATTR VkResult VKAPI_CALL BindImageMemory2KHR(
     uint32_t                                    bindInfoCount,
     const VkBindImageMemoryInfo*                pBindInfos)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkBindImageMemory2KHR, bindInfoCount, device);
+    for (uint32_t i = 0; i < bindInfoCount; ++i) {
+        const auto *plane_info = lvl_find_in_chain<VkBindImagePlaneMemoryInfo>(pBindInfos[i].pNext);
+        Image* image_state = image_table.Get(pBindInfos[i].image);
+        if (plane_info && image_state) {
+            image_state->bindings[GetAspectPlane(plane_info->planeAspect)] = {pBindInfos[i].memory, pBindInfos[i].memoryOffset};
+        } else {
+            BindImageMemory(device, pBindInfos[i].image, pBindInfos[i].memory, pBindInfos[i].memoryOffset);
+        }
+    }
     return VK_SUCCESS;
 }
 
@@ -3004,6 +9041,7 @@ static VKAPI_ATTR void VKAPI_CALL GetDescriptorSetLayoutSupportKHR(
     const VkDescriptorSetLayoutCreateInfo*      pCreateInfo,
     VkDescriptorSetLayoutSupport*               pSupport)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDescriptorSetLayoutSupportKHR, 0, device);
 //Not a CREATE or DESTROY function
 }
 
@@ -3017,7 +9055,8 @@ static VKAPI_ATTR void VKAPI_CALL CmdDrawIndirectCountKHR(
     uint32_t                                    maxDrawCount,
     uint32_t                                    stride)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDrawIndirectCountKHR, 0, commandBuffer, buffer, countBuffer);
+    CmdDrawIndirectCount(commandBuffer, buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
 }
 
 static VKAPI_ATTR void VKAPI_CALL CmdDrawIndexedIndirectCountKHR(
@@ -3029,7 +9068,8 @@ static VKAPI_ATTR void VKAPI_CALL CmdDrawIndexedIndirectCountKHR(
     uint32_t                                    maxDrawCount,
     uint32_t                                    stride)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDrawIndexedIndirectCountKHR, 0, commandBuffer, buffer, countBuffer);
+    CmdDrawIndexedIndirectCount(commandBuffer, buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
 }
 
 
@@ -3046,7 +9086,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetSemaphoreCounterValueKHR(
     VkSemaphore                                 semaphore,
     uint64_t*                                   pValue)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetSemaphoreCounterValueKHR, 0, device, semaphore);
+    Semaphore* counter_semaphore = GetSemaphore(semaphore);
+    *pValue = counter_semaphore ? counter_semaphore->value.load() : 0;
     return VK_SUCCESS;
 }
 
@@ -3055,15 +9097,32 @@ static VKAPI_ATTR VkResult VKAPI_CALL WaitSemaphoresKHR(
     const VkSemaphoreWaitInfo*                  pWaitInfo,
     uint64_t                                    timeout)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkWaitSemaphoresKHR, 0, device);
+    std::vector<std::pair<Semaphore*, uint64_t>> waits;
+    for (uint32_t i = 0; i < pWaitInfo->semaphoreCount; ++i) {
+        Semaphore* wait_semaphore = GetSemaphore(pWaitInfo->pSemaphores[i]);
+        if (wait_semaphore) waits.push_back(std::make_pair(wait_semaphore, pWaitInfo->pValues[i]));
+    }
+    const bool wait_any = (pWaitInfo->flags & VK_SEMAPHORE_WAIT_ANY_BIT) != 0;
+    auto reached = [&waits, wait_any] {
+        for (const auto& wait : waits) {
+            const bool wait_reached = wait.first->value.load() >= wait.second;
+            if (!wait_any && !wait_reached) return false;
+            if (wait_any && wait_reached) return true;
+        }
+        return !wait_any || waits.empty();
+    };
+    return WaitForSyncObjects(reinterpret_cast<Device*>(device), reached, GetSyncDeadline(timeout)) ? VK_SUCCESS : VK_TIMEOUT;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL SignalSemaphoreKHR(
     VkDevice                                    device,
     const VkSemaphoreSignalInfo*                pSignalInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkSignalSemaphoreKHR, 0, device);
+    Semaphore* signal_semaphore = GetSemaphore(pSignalInfo->semaphore);
+    if (signal_semaphore) signal_semaphore->value = pSignalInfo->value;
+    SignalSyncObjects(reinterpret_cast<Device*>(device));
     return VK_SUCCESS;
 }
 
@@ -3077,6 +9136,7 @@ static VKAPI_ATTR VkDeviceAddress VKAPI_CALL GetBufferDeviceAddressKHR(
     VkDevice                                    device,
     const VkBufferDeviceAddressInfo*            pInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetBufferDeviceAddressKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3085,6 +9145,7 @@ static VKAPI_ATTR uint64_t VKAPI_CALL GetBufferOpaqueCaptureAddressKHR(
     VkDevice                                    device,
     const VkBufferDeviceAddressInfo*            pInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetBufferOpaqueCaptureAddressKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3093,6 +9154,7 @@ static VKAPI_ATTR uint64_t VKAPI_CALL GetDeviceMemoryOpaqueCaptureAddressKHR(
     VkDevice                                    device,
     const VkDeviceMemoryOpaqueCaptureAddressInfo* pInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDeviceMemoryOpaqueCaptureAddressKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3104,6 +9166,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPipelineExecutablePropertiesKHR(
     uint32_t*                                   pExecutableCount,
     VkPipelineExecutablePropertiesKHR*          pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPipelineExecutablePropertiesKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3114,6 +9177,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPipelineExecutableStatisticsKHR(
     uint32_t*                                   pStatisticCount,
     VkPipelineExecutableStatisticKHR*           pStatistics)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPipelineExecutableStatisticsKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3124,6 +9188,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPipelineExecutableInternalRepresentatio
     uint32_t*                                   pInternalRepresentationCount,
     VkPipelineExecutableInternalRepresentationKHR* pInternalRepresentations)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPipelineExecutableInternalRepresentationsKHR, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3135,8 +9200,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateDebugReportCallbackEXT(
     const VkAllocationCallbacks*                pAllocator,
     VkDebugReportCallbackEXT*                   pCallback)
 {
-    unique_lock_t lock(global_lock);
-    *pCallback = (VkDebugReportCallbackEXT)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateDebugReportCallbackEXT, 0, instance);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkDebugReportCallbackEXT, 1);
+    *pCallback = (VkDebugReportCallbackEXT)debug_report_callback_ext_table.Create();
     return VK_SUCCESS;
 }
 
@@ -3145,7 +9211,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyDebugReportCallbackEXT(
     VkDebugReportCallbackEXT                    callback,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyDebugReportCallbackEXT, 0, instance, callback);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkDebugReportCallbackEXT, callback != VK_NULL_HANDLE);
+    debug_report_callback_ext_table.Destroy(callback);
 }
 
 static VKAPI_ATTR void VKAPI_CALL DebugReportMessageEXT(
@@ -3158,6 +9226,7 @@ static VKAPI_ATTR void VKAPI_CALL DebugReportMessageEXT(
     const char*                                 pLayerPrefix,
     const char*                                 pMessage)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDebugReportMessageEXT, 0, instance);
 //Not a CREATE or DESTROY function
 }
 
@@ -3172,6 +9241,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL DebugMarkerSetObjectTagEXT(
     VkDevice                                    device,
     const VkDebugMarkerObjectTagInfoEXT*        pTagInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDebugMarkerSetObjectTagEXT, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3180,33 +9250,74 @@ static VKAPI_ATTR VkResult VKAPI_CALL DebugMarkerSetObjectNameEXT(
     VkDevice                                    device,
     const VkDebugMarkerObjectNameInfoEXT*       pNameInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDebugMarkerSetObjectNameEXT, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
 
+struct CmdDebugMarkerBeginEXTRecord {
+    static const CommandInfo info;
+    const VkDebugMarkerMarkerInfoEXT* pMarkerInfo;
+};
+const CommandInfo CmdDebugMarkerBeginEXTRecord::info = {"vkCmdDebugMarkerBeginEXT", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdDebugMarkerBeginEXT(
     VkCommandBuffer                             commandBuffer,
     const VkDebugMarkerMarkerInfoEXT*           pMarkerInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDebugMarkerBeginEXT, 0, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdDebugMarkerBeginEXTRecord>(commandBuffer, CommandArraySize(pMarkerInfo, 1) + CommandNestedSize(pMarkerInfo, 1), &storage);
+    if (!record) return;
+    auto pMarkerInfo_copy = CopyCommandArray(&storage, pMarkerInfo, 1);
+    CopyCommandNested(&storage, pMarkerInfo_copy, 1);
+    record->pMarkerInfo = pMarkerInfo_copy;
 }
 
+struct CmdDebugMarkerEndEXTRecord {
+    static const CommandInfo info;
+};
+const CommandInfo CmdDebugMarkerEndEXTRecord::info = {"vkCmdDebugMarkerEndEXT", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdDebugMarkerEndEXT(
     VkCommandBuffer                             commandBuffer)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDebugMarkerEndEXT, 0, commandBuffer);
+    RecordCommand<CmdDebugMarkerEndEXTRecord>(commandBuffer);
 }
 
+struct CmdDebugMarkerInsertEXTRecord {
+    static const CommandInfo info;
+    const VkDebugMarkerMarkerInfoEXT* pMarkerInfo;
+};
+const CommandInfo CmdDebugMarkerInsertEXTRecord::info = {"vkCmdDebugMarkerInsertEXT", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdDebugMarkerInsertEXT(
     VkCommandBuffer                             commandBuffer,
     const VkDebugMarkerMarkerInfoEXT*           pMarkerInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDebugMarkerInsertEXT, 0, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdDebugMarkerInsertEXTRecord>(commandBuffer, CommandArraySize(pMarkerInfo, 1) + CommandNestedSize(pMarkerInfo, 1), &storage);
+    if (!record) return;
+    auto pMarkerInfo_copy = CopyCommandArray(&storage, pMarkerInfo, 1);
+    CopyCommandNested(&storage, pMarkerInfo_copy, 1);
+    record->pMarkerInfo = pMarkerInfo_copy;
 }
 
 
 
 
+struct CmdBindTransformFeedbackBuffersEXTRecord {
+    static const CommandInfo info;
+    uint32_t firstBinding;
+    uint32_t bindingCount;
+    const VkBuffer* pBuffers;
+    const VkDeviceSize* pOffsets;
+    const VkDeviceSize* pSizes;
+};
+const CommandInfo CmdBindTransformFeedbackBuffersEXTRecord::info = {"vkCmdBindTransformFeedbackBuffersEXT", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdBindTransformFeedbackBuffersEXT(
     VkCommandBuffer                             commandBuffer,
     uint32_t                                    firstBinding,
@@ -3215,8 +9326,29 @@ static VKAPI_ATTR void VKAPI_CALL CmdBindTransformFeedbackBuffersEXT(
     const VkDeviceSize*                         pOffsets,
     const VkDeviceSize*                         pSizes)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBindTransformFeedbackBuffersEXT, bindingCount, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdBindTransformFeedbackBuffersEXTRecord>(commandBuffer, CommandArraySize(pBuffers, bindingCount) + CommandArraySize(pOffsets, bindingCount) + CommandNestedSize(pOffsets, bindingCount) + CommandArraySize(pSizes, bindingCount) + CommandNestedSize(pSizes, bindingCount), &storage);
+    if (!record) return;
+    record->firstBinding = firstBinding;
+    record->bindingCount = bindingCount;
+    record->pBuffers = CopyCommandArray(&storage, pBuffers, bindingCount);
+    auto pOffsets_copy = CopyCommandArray(&storage, pOffsets, bindingCount);
+    CopyCommandNested(&storage, pOffsets_copy, bindingCount);
+    record->pOffsets = pOffsets_copy;
+    auto pSizes_copy = CopyCommandArray(&storage, pSizes, bindingCount);
+    CopyCommandNested(&storage, pSizes_copy, bindingCount);
+    record->pSizes = pSizes_copy;
+}
+
+struct CmdBeginTransformFeedbackEXTRecord {
+    static const CommandInfo info;
+    uint32_t firstCounterBuffer;
+    uint32_t counterBufferCount;
+    const VkBuffer* pCounterBuffers;
+    const VkDeviceSize* pCounterBufferOffsets;
+};
+const CommandInfo CmdBeginTransformFeedbackEXTRecord::info = {"vkCmdBeginTransformFeedbackEXT", nullptr};
 
 static VKAPI_ATTR void VKAPI_CALL CmdBeginTransformFeedbackEXT(
     VkCommandBuffer                             commandBuffer,
@@ -3225,8 +9357,26 @@ static VKAPI_ATTR void VKAPI_CALL CmdBeginTransformFeedbackEXT(
     const VkBuffer*                             pCounterBuffers,
     const VkDeviceSize*                         pCounterBufferOffsets)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBeginTransformFeedbackEXT, counterBufferCount, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdBeginTransformFeedbackEXTRecord>(commandBuffer, CommandArraySize(pCounterBuffers, counterBufferCount) + CommandArraySize(pCounterBufferOffsets, counterBufferCount) + CommandNestedSize(pCounterBufferOffsets, counterBufferCount), &storage);
+    if (!record) return;
+    record->firstCounterBuffer = firstCounterBuffer;
+    record->counterBufferCount = counterBufferCount;
+    record->pCounterBuffers = CopyCommandArray(&storage, pCounterBuffers, counterBufferCount);
+    auto pCounterBufferOffsets_copy = CopyCommandArray(&storage, pCounterBufferOffsets, counterBufferCount);
+    CopyCommandNested(&storage, pCounterBufferOffsets_copy, counterBufferCount);
+    record->pCounterBufferOffsets = pCounterBufferOffsets_copy;
+}
+
+struct CmdEndTransformFeedbackEXTRecord {
+    static const CommandInfo info;
+    uint32_t firstCounterBuffer;
+    uint32_t counterBufferCount;
+    const VkBuffer* pCounterBuffers;
+    const VkDeviceSize* pCounterBufferOffsets;
+};
+const CommandInfo CmdEndTransformFeedbackEXTRecord::info = {"vkCmdEndTransformFeedbackEXT", nullptr};
 
 static VKAPI_ATTR void VKAPI_CALL CmdEndTransformFeedbackEXT(
     VkCommandBuffer                             commandBuffer,
@@ -3235,8 +9385,31 @@ static VKAPI_ATTR void VKAPI_CALL CmdEndTransformFeedbackEXT(
     const VkBuffer*                             pCounterBuffers,
     const VkDeviceSize*                         pCounterBufferOffsets)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdEndTransformFeedbackEXT, counterBufferCount, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdEndTransformFeedbackEXTRecord>(commandBuffer, CommandArraySize(pCounterBuffers, counterBufferCount) + CommandArraySize(pCounterBufferOffsets, counterBufferCount) + CommandNestedSize(pCounterBufferOffsets, counterBufferCount), &storage);
+    if (!record) return;
+    record->firstCounterBuffer = firstCounterBuffer;
+    record->counterBufferCount = counterBufferCount;
+    record->pCounterBuffers = CopyCommandArray(&storage, pCounterBuffers, counterBufferCount);
+    auto pCounterBufferOffsets_copy = CopyCommandArray(&storage, pCounterBufferOffsets, counterBufferCount);
+    CopyCommandNested(&storage, pCounterBufferOffsets_copy, counterBufferCount);
+    record->pCounterBufferOffsets = pCounterBufferOffsets_copy;
+}
+
+struct CmdBeginQueryIndexedEXTRecord {
+    static const CommandInfo info;
+    VkQueryPool queryPool;
+    uint32_t query;
+    VkQueryControlFlags flags;
+    uint32_t index;
+};
+
+static void ExecuteCmdBeginQueryIndexedEXT(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdBeginQueryIndexedEXTRecord*>(data);
+    ExecuteBeginQuery(context, record.queryPool, record.query);
 }
+const CommandInfo CmdBeginQueryIndexedEXTRecord::info = {"vkCmdBeginQueryIndexedEXT", ExecuteCmdBeginQueryIndexedEXT};
 
 static VKAPI_ATTR void VKAPI_CALL CmdBeginQueryIndexedEXT(
     VkCommandBuffer                             commandBuffer,
@@ -3245,8 +9418,27 @@ static VKAPI_ATTR void VKAPI_CALL CmdBeginQueryIndexedEXT(
     VkQueryControlFlags                         flags,
     uint32_t                                    index)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBeginQueryIndexedEXT, 0, commandBuffer, queryPool);
+    auto record = RecordCommand<CmdBeginQueryIndexedEXTRecord>(commandBuffer);
+    if (!record) return;
+    record->queryPool = queryPool;
+    record->query = query;
+    record->flags = flags;
+    record->index = index;
+}
+
+struct CmdEndQueryIndexedEXTRecord {
+    static const CommandInfo info;
+    VkQueryPool queryPool;
+    uint32_t query;
+    uint32_t index;
+};
+
+static void ExecuteCmdEndQueryIndexedEXT(const void* data, ExecutionContext* context) {
+    const auto& record = *static_cast<const CmdEndQueryIndexedEXTRecord*>(data);
+    ExecuteEndQuery(context, record.queryPool, record.query);
 }
+const CommandInfo CmdEndQueryIndexedEXTRecord::info = {"vkCmdEndQueryIndexedEXT", ExecuteCmdEndQueryIndexedEXT};
 
 static VKAPI_ATTR void VKAPI_CALL CmdEndQueryIndexedEXT(
     VkCommandBuffer                             commandBuffer,
@@ -3254,8 +9446,24 @@ static VKAPI_ATTR void VKAPI_CALL CmdEndQueryIndexedEXT(
     uint32_t                                    query,
     uint32_t                                    index)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdEndQueryIndexedEXT, 0, commandBuffer, queryPool);
+    auto record = RecordCommand<CmdEndQueryIndexedEXTRecord>(commandBuffer);
+    if (!record) return;
+    record->queryPool = queryPool;
+    record->query = query;
+    record->index = index;
+}
+
+struct CmdDrawIndirectByteCountEXTRecord {
+    static const CommandInfo info;
+    uint32_t instanceCount;
+    uint32_t firstInstance;
+    VkBuffer counterBuffer;
+    VkDeviceSize counterBufferOffset;
+    uint32_t counterOffset;
+    uint32_t vertexStride;
+};
+const CommandInfo CmdDrawIndirectByteCountEXTRecord::info = {"vkCmdDrawIndirectByteCountEXT", nullptr};
 
 static VKAPI_ATTR void VKAPI_CALL CmdDrawIndirectByteCountEXT(
     VkCommandBuffer                             commandBuffer,
@@ -3266,7 +9474,15 @@ static VKAPI_ATTR void VKAPI_CALL CmdDrawIndirectByteCountEXT(
     uint32_t                                    counterOffset,
     uint32_t                                    vertexStride)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDrawIndirectByteCountEXT, 0, commandBuffer, counterBuffer);
+    auto record = RecordCommand<CmdDrawIndirectByteCountEXTRecord>(commandBuffer);
+    if (!record) return;
+    record->instanceCount = instanceCount;
+    record->firstInstance = firstInstance;
+    record->counterBuffer = counterBuffer;
+    record->counterBufferOffset = counterBufferOffset;
+    record->counterOffset = counterOffset;
+    record->vertexStride = vertexStride;
 }
 
 
@@ -3274,6 +9490,7 @@ static VKAPI_ATTR uint32_t VKAPI_CALL GetImageViewHandleNVX(
     VkDevice                                    device,
     const VkImageViewHandleInfoNVX*             pInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetImageViewHandleNVX, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3288,7 +9505,8 @@ static VKAPI_ATTR void VKAPI_CALL CmdDrawIndirectCountAMD(
     uint32_t                                    maxDrawCount,
     uint32_t                                    stride)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDrawIndirectCountAMD, 0, commandBuffer, buffer, countBuffer);
+    CmdDrawIndirectCount(commandBuffer, buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
 }
 
 static VKAPI_ATTR void VKAPI_CALL CmdDrawIndexedIndirectCountAMD(
@@ -3300,7 +9518,8 @@ static VKAPI_ATTR void VKAPI_CALL CmdDrawIndexedIndirectCountAMD(
     uint32_t                                    maxDrawCount,
     uint32_t                                    stride)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDrawIndexedIndirectCountAMD, 0, commandBuffer, buffer, countBuffer);
+    CmdDrawIndexedIndirectCount(commandBuffer, buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
 }
 
 
@@ -3316,6 +9535,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetShaderInfoAMD(
     size_t*                                     pInfoSize,
     void*                                       pInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetShaderInfoAMD, 0, device, pipeline);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3329,8 +9549,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateStreamDescriptorSurfaceGGP(
     const VkAllocationCallbacks*                pAllocator,
     VkSurfaceKHR*                               pSurface)
 {
-    unique_lock_t lock(global_lock);
-    *pSurface = (VkSurfaceKHR)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateStreamDescriptorSurfaceGGP, 0, instance);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSurfaceKHR, 1);
+    *pSurface = (VkSurfaceKHR)surface_khr_table.Create();
     return VK_SUCCESS;
 }
 #endif /* VK_USE_PLATFORM_GGP */
@@ -3348,6 +9569,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceExternalImageFormatProper
     VkExternalMemoryHandleTypeFlagsNV           externalHandleType,
     VkExternalImageFormatPropertiesNV*          pExternalImageFormatProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceExternalImageFormatPropertiesNV, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3361,6 +9583,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetMemoryWin32HandleNV(
     VkExternalMemoryHandleTypeFlagsNV           handleType,
     HANDLE*                                     pHandle)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetMemoryWin32HandleNV, 0, device, memory);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3378,8 +9601,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateViSurfaceNN(
     const VkAllocationCallbacks*                pAllocator,
     VkSurfaceKHR*                               pSurface)
 {
-    unique_lock_t lock(global_lock);
-    *pSurface = (VkSurfaceKHR)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateViSurfaceNN, 0, instance);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSurfaceKHR, 1);
+    *pSurface = (VkSurfaceKHR)surface_khr_table.Create();
     return VK_SUCCESS;
 }
 #endif /* VK_USE_PLATFORM_VI_NN */
@@ -3389,32 +9613,74 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateViSurfaceNN(
 
 
 
+struct CmdBeginConditionalRenderingEXTRecord {
+    static const CommandInfo info;
+    const VkConditionalRenderingBeginInfoEXT* pConditionalRenderingBegin;
+};
+const CommandInfo CmdBeginConditionalRenderingEXTRecord::info = {"vkCmdBeginConditionalRenderingEXT", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdBeginConditionalRenderingEXT(
     VkCommandBuffer                             commandBuffer,
     const VkConditionalRenderingBeginInfoEXT*   pConditionalRenderingBegin)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBeginConditionalRenderingEXT, 0, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdBeginConditionalRenderingEXTRecord>(commandBuffer, CommandArraySize(pConditionalRenderingBegin, 1) + CommandNestedSize(pConditionalRenderingBegin, 1), &storage);
+    if (!record) return;
+    auto pConditionalRenderingBegin_copy = CopyCommandArray(&storage, pConditionalRenderingBegin, 1);
+    CopyCommandNested(&storage, pConditionalRenderingBegin_copy, 1);
+    record->pConditionalRenderingBegin = pConditionalRenderingBegin_copy;
 }
 
+struct CmdEndConditionalRenderingEXTRecord {
+    static const CommandInfo info;
+};
+const CommandInfo CmdEndConditionalRenderingEXTRecord::info = {"vkCmdEndConditionalRenderingEXT", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdEndConditionalRenderingEXT(
     VkCommandBuffer                             commandBuffer)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdEndConditionalRenderingEXT, 0, commandBuffer);
+    RecordCommand<CmdEndConditionalRenderingEXTRecord>(commandBuffer);
 }
 
 
+struct CmdProcessCommandsNVXRecord {
+    static const CommandInfo info;
+    const VkCmdProcessCommandsInfoNVX* pProcessCommandsInfo;
+};
+const CommandInfo CmdProcessCommandsNVXRecord::info = {"vkCmdProcessCommandsNVX", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdProcessCommandsNVX(
     VkCommandBuffer                             commandBuffer,
     const VkCmdProcessCommandsInfoNVX*          pProcessCommandsInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdProcessCommandsNVX, 0, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdProcessCommandsNVXRecord>(commandBuffer, CommandArraySize(pProcessCommandsInfo, 1) + CommandNestedSize(pProcessCommandsInfo, 1), &storage);
+    if (!record) return;
+    auto pProcessCommandsInfo_copy = CopyCommandArray(&storage, pProcessCommandsInfo, 1);
+    CopyCommandNested(&storage, pProcessCommandsInfo_copy, 1);
+    record->pProcessCommandsInfo = pProcessCommandsInfo_copy;
 }
 
+struct CmdReserveSpaceForCommandsNVXRecord {
+    static const CommandInfo info;
+    const VkCmdReserveSpaceForCommandsInfoNVX* pReserveSpaceInfo;
+};
+const CommandInfo CmdReserveSpaceForCommandsNVXRecord::info = {"vkCmdReserveSpaceForCommandsNVX", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdReserveSpaceForCommandsNVX(
     VkCommandBuffer                             commandBuffer,
     const VkCmdReserveSpaceForCommandsInfoNVX*  pReserveSpaceInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdReserveSpaceForCommandsNVX, 0, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdReserveSpaceForCommandsNVXRecord>(commandBuffer, CommandArraySize(pReserveSpaceInfo, 1) + CommandNestedSize(pReserveSpaceInfo, 1), &storage);
+    if (!record) return;
+    auto pReserveSpaceInfo_copy = CopyCommandArray(&storage, pReserveSpaceInfo, 1);
+    CopyCommandNested(&storage, pReserveSpaceInfo_copy, 1);
+    record->pReserveSpaceInfo = pReserveSpaceInfo_copy;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateIndirectCommandsLayoutNVX(
@@ -3423,8 +9689,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateIndirectCommandsLayoutNVX(
     const VkAllocationCallbacks*                pAllocator,
     VkIndirectCommandsLayoutNVX*                pIndirectCommandsLayout)
 {
-    unique_lock_t lock(global_lock);
-    *pIndirectCommandsLayout = (VkIndirectCommandsLayoutNVX)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateIndirectCommandsLayoutNVX, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkIndirectCommandsLayoutNVX, 1);
+    *pIndirectCommandsLayout = (VkIndirectCommandsLayoutNVX)indirect_commands_layout_nvx_table.Create();
     return VK_SUCCESS;
 }
 
@@ -3433,7 +9700,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyIndirectCommandsLayoutNVX(
     VkIndirectCommandsLayoutNVX                 indirectCommandsLayout,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyIndirectCommandsLayoutNVX, 0, device, indirectCommandsLayout);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkIndirectCommandsLayoutNVX, indirectCommandsLayout != VK_NULL_HANDLE);
+    indirect_commands_layout_nvx_table.Destroy(indirectCommandsLayout);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateObjectTableNVX(
@@ -3442,8 +9711,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateObjectTableNVX(
     const VkAllocationCallbacks*                pAllocator,
     VkObjectTableNVX*                           pObjectTable)
 {
-    unique_lock_t lock(global_lock);
-    *pObjectTable = (VkObjectTableNVX)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateObjectTableNVX, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkObjectTableNVX, 1);
+    *pObjectTable = (VkObjectTableNVX)object_table_nvx_table.Create();
     return VK_SUCCESS;
 }
 
@@ -3452,7 +9722,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyObjectTableNVX(
     VkObjectTableNVX                            objectTable,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyObjectTableNVX, 0, device, objectTable);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkObjectTableNVX, objectTable != VK_NULL_HANDLE);
+    object_table_nvx_table.Destroy(objectTable);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL RegisterObjectsNVX(
@@ -3462,6 +9734,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL RegisterObjectsNVX(
     const VkObjectTableEntryNVX* const*         ppObjectTableEntries,
     const uint32_t*                             pObjectIndices)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkRegisterObjectsNVX, objectCount, device, objectTable);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3473,6 +9746,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL UnregisterObjectsNVX(
     const VkObjectEntryTypeNVX*                 pObjectEntryTypes,
     const uint32_t*                             pObjectIndices)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkUnregisterObjectsNVX, objectCount, device, objectTable);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3482,17 +9756,34 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceGeneratedCommandsPropertiesNV
     VkDeviceGeneratedCommandsFeaturesNVX*       pFeatures,
     VkDeviceGeneratedCommandsLimitsNVX*         pLimits)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceGeneratedCommandsPropertiesNVX, 0, physicalDevice);
 //Not a CREATE or DESTROY function
 }
 
 
+struct CmdSetViewportWScalingNVRecord {
+    static const CommandInfo info;
+    uint32_t firstViewport;
+    uint32_t viewportCount;
+    const VkViewportWScalingNV* pViewportWScalings;
+};
+const CommandInfo CmdSetViewportWScalingNVRecord::info = {"vkCmdSetViewportWScalingNV", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdSetViewportWScalingNV(
     VkCommandBuffer                             commandBuffer,
     uint32_t                                    firstViewport,
     uint32_t                                    viewportCount,
     const VkViewportWScalingNV*                 pViewportWScalings)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetViewportWScalingNV, viewportCount, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdSetViewportWScalingNVRecord>(commandBuffer, CommandArraySize(pViewportWScalings, viewportCount) + CommandNestedSize(pViewportWScalings, viewportCount), &storage);
+    if (!record) return;
+    record->firstViewport = firstViewport;
+    record->viewportCount = viewportCount;
+    auto pViewportWScalings_copy = CopyCommandArray(&storage, pViewportWScalings, viewportCount);
+    CopyCommandNested(&storage, pViewportWScalings_copy, viewportCount);
+    record->pViewportWScalings = pViewportWScalings_copy;
 }
 
 
@@ -3500,6 +9791,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL ReleaseDisplayEXT(
     VkPhysicalDevice                            physicalDevice,
     VkDisplayKHR                                display)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkReleaseDisplayEXT, 0, physicalDevice, display);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3511,6 +9803,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL AcquireXlibDisplayEXT(
     Display*                                    dpy,
     VkDisplayKHR                                display)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkAcquireXlibDisplayEXT, 0, physicalDevice, display);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3521,6 +9814,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetRandROutputDisplayEXT(
     RROutput                                    rrOutput,
     VkDisplayKHR*                               pDisplay)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetRandROutputDisplayEXT, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3532,6 +9826,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfaceCapabilities2EXT(
     VkSurfaceKHR                                surface,
     VkSurfaceCapabilities2EXT*                  pSurfaceCapabilities)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceSurfaceCapabilities2EXT, 0, physicalDevice, surface);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3542,6 +9837,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL DisplayPowerControlEXT(
     VkDisplayKHR                                display,
     const VkDisplayPowerInfoEXT*                pDisplayPowerInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDisplayPowerControlEXT, 0, device, display);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3552,6 +9848,8 @@ static VKAPI_ATTR VkResult VKAPI_CALL RegisterDeviceEventEXT(
     const VkAllocationCallbacks*                pAllocator,
     VkFence*                                    pFence)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkRegisterDeviceEventEXT, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkFence, 1);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3563,6 +9861,8 @@ static VKAPI_ATTR VkResult VKAPI_CALL RegisterDisplayEventEXT(
     const VkAllocationCallbacks*                pAllocator,
     VkFence*                                    pFence)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkRegisterDisplayEventEXT, 0, device, display);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkFence, 1);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3573,6 +9873,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetSwapchainCounterEXT(
     VkSurfaceCounterFlagBitsEXT                 counter,
     uint64_t*                                   pCounterValue)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetSwapchainCounterEXT, 0, device, swapchain);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3583,6 +9884,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetRefreshCycleDurationGOOGLE(
     VkSwapchainKHR                              swapchain,
     VkRefreshCycleDurationGOOGLE*               pDisplayTimingProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetRefreshCycleDurationGOOGLE, 0, device, swapchain);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3593,6 +9895,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPastPresentationTimingGOOGLE(
     uint32_t*                                   pPresentationTimingCount,
     VkPastPresentationTimingGOOGLE*             pPresentationTimings)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPastPresentationTimingGOOGLE, 0, device, swapchain);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3603,13 +9906,29 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPastPresentationTimingGOOGLE(
 
 
 
+struct CmdSetDiscardRectangleEXTRecord {
+    static const CommandInfo info;
+    uint32_t firstDiscardRectangle;
+    uint32_t discardRectangleCount;
+    const VkRect2D* pDiscardRectangles;
+};
+const CommandInfo CmdSetDiscardRectangleEXTRecord::info = {"vkCmdSetDiscardRectangleEXT", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdSetDiscardRectangleEXT(
     VkCommandBuffer                             commandBuffer,
     uint32_t                                    firstDiscardRectangle,
     uint32_t                                    discardRectangleCount,
     const VkRect2D*                             pDiscardRectangles)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetDiscardRectangleEXT, discardRectangleCount, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdSetDiscardRectangleEXTRecord>(commandBuffer, CommandArraySize(pDiscardRectangles, discardRectangleCount) + CommandNestedSize(pDiscardRectangles, discardRectangleCount), &storage);
+    if (!record) return;
+    record->firstDiscardRectangle = firstDiscardRectangle;
+    record->discardRectangleCount = discardRectangleCount;
+    auto pDiscardRectangles_copy = CopyCommandArray(&storage, pDiscardRectangles, discardRectangleCount);
+    CopyCommandNested(&storage, pDiscardRectangles_copy, discardRectangleCount);
+    record->pDiscardRectangles = pDiscardRectangles_copy;
 }
 
 
@@ -3622,6 +9941,7 @@ static VKAPI_ATTR void VKAPI_CALL SetHdrMetadataEXT(
     const VkSwapchainKHR*                       pSwapchains,
     const VkHdrMetadataEXT*                     pMetadata)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkSetHdrMetadataEXT, swapchainCount, device);
 //Not a CREATE or DESTROY function
 }
 
@@ -3633,8 +9953,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateIOSSurfaceMVK(
     const VkAllocationCallbacks*                pAllocator,
     VkSurfaceKHR*                               pSurface)
 {
-    unique_lock_t lock(global_lock);
-    *pSurface = (VkSurfaceKHR)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateIOSSurfaceMVK, 0, instance);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSurfaceKHR, 1);
+    *pSurface = (VkSurfaceKHR)surface_khr_table.Create();
     return VK_SUCCESS;
 }
 #endif /* VK_USE_PLATFORM_IOS_MVK */
@@ -3647,8 +9968,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateMacOSSurfaceMVK(
     const VkAllocationCallbacks*                pAllocator,
     VkSurfaceKHR*                               pSurface)
 {
-    unique_lock_t lock(global_lock);
-    *pSurface = (VkSurfaceKHR)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateMacOSSurfaceMVK, 0, instance);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSurfaceKHR, 1);
+    *pSurface = (VkSurfaceKHR)surface_khr_table.Create();
     return VK_SUCCESS;
 }
 #endif /* VK_USE_PLATFORM_MACOS_MVK */
@@ -3660,6 +9982,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL SetDebugUtilsObjectNameEXT(
     VkDevice                                    device,
     const VkDebugUtilsObjectNameInfoEXT*        pNameInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkSetDebugUtilsObjectNameEXT, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3668,6 +9991,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL SetDebugUtilsObjectTagEXT(
     VkDevice                                    device,
     const VkDebugUtilsObjectTagInfoEXT*         pTagInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkSetDebugUtilsObjectTagEXT, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3676,12 +10000,14 @@ static VKAPI_ATTR void VKAPI_CALL QueueBeginDebugUtilsLabelEXT(
     VkQueue                                     queue,
     const VkDebugUtilsLabelEXT*                 pLabelInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkQueueBeginDebugUtilsLabelEXT, 0, queue);
 //Not a CREATE or DESTROY function
 }
 
 static VKAPI_ATTR void VKAPI_CALL QueueEndDebugUtilsLabelEXT(
     VkQueue                                     queue)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkQueueEndDebugUtilsLabelEXT, 0, queue);
 //Not a CREATE or DESTROY function
 }
 
@@ -3689,27 +10015,58 @@ static VKAPI_ATTR void VKAPI_CALL QueueInsertDebugUtilsLabelEXT(
     VkQueue                                     queue,
     const VkDebugUtilsLabelEXT*                 pLabelInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkQueueInsertDebugUtilsLabelEXT, 0, queue);
 //Not a CREATE or DESTROY function
 }
 
+struct CmdBeginDebugUtilsLabelEXTRecord {
+    static const CommandInfo info;
+    const VkDebugUtilsLabelEXT* pLabelInfo;
+};
+const CommandInfo CmdBeginDebugUtilsLabelEXTRecord::info = {"vkCmdBeginDebugUtilsLabelEXT", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdBeginDebugUtilsLabelEXT(
     VkCommandBuffer                             commandBuffer,
     const VkDebugUtilsLabelEXT*                 pLabelInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBeginDebugUtilsLabelEXT, 0, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdBeginDebugUtilsLabelEXTRecord>(commandBuffer, CommandArraySize(pLabelInfo, 1) + CommandNestedSize(pLabelInfo, 1), &storage);
+    if (!record) return;
+    auto pLabelInfo_copy = CopyCommandArray(&storage, pLabelInfo, 1);
+    CopyCommandNested(&storage, pLabelInfo_copy, 1);
+    record->pLabelInfo = pLabelInfo_copy;
 }
 
+struct CmdEndDebugUtilsLabelEXTRecord {
+    static const CommandInfo info;
+};
+const CommandInfo CmdEndDebugUtilsLabelEXTRecord::info = {"vkCmdEndDebugUtilsLabelEXT", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdEndDebugUtilsLabelEXT(
     VkCommandBuffer                             commandBuffer)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdEndDebugUtilsLabelEXT, 0, commandBuffer);
+    RecordCommand<CmdEndDebugUtilsLabelEXTRecord>(commandBuffer);
 }
 
+struct CmdInsertDebugUtilsLabelEXTRecord {
+    static const CommandInfo info;
+    const VkDebugUtilsLabelEXT* pLabelInfo;
+};
+const CommandInfo CmdInsertDebugUtilsLabelEXTRecord::info = {"vkCmdInsertDebugUtilsLabelEXT", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdInsertDebugUtilsLabelEXT(
     VkCommandBuffer                             commandBuffer,
     const VkDebugUtilsLabelEXT*                 pLabelInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdInsertDebugUtilsLabelEXT, 0, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdInsertDebugUtilsLabelEXTRecord>(commandBuffer, CommandArraySize(pLabelInfo, 1) + CommandNestedSize(pLabelInfo, 1), &storage);
+    if (!record) return;
+    auto pLabelInfo_copy = CopyCommandArray(&storage, pLabelInfo, 1);
+    CopyCommandNested(&storage, pLabelInfo_copy, 1);
+    record->pLabelInfo = pLabelInfo_copy;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateDebugUtilsMessengerEXT(
@@ -3718,8 +10075,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateDebugUtilsMessengerEXT(
     const VkAllocationCallbacks*                pAllocator,
     VkDebugUtilsMessengerEXT*                   pMessenger)
 {
-    unique_lock_t lock(global_lock);
-    *pMessenger = (VkDebugUtilsMessengerEXT)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateDebugUtilsMessengerEXT, 0, instance);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkDebugUtilsMessengerEXT, 1);
+    *pMessenger = (VkDebugUtilsMessengerEXT)debug_utils_messenger_ext_table.Create();
     return VK_SUCCESS;
 }
 
@@ -3728,7 +10086,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyDebugUtilsMessengerEXT(
     VkDebugUtilsMessengerEXT                    messenger,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyDebugUtilsMessengerEXT, 0, instance, messenger);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkDebugUtilsMessengerEXT, messenger != VK_NULL_HANDLE);
+    debug_utils_messenger_ext_table.Destroy(messenger);
 }
 
 static VKAPI_ATTR void VKAPI_CALL SubmitDebugUtilsMessageEXT(
@@ -3737,6 +10097,7 @@ static VKAPI_ATTR void VKAPI_CALL SubmitDebugUtilsMessageEXT(
     VkDebugUtilsMessageTypeFlagsEXT             messageTypes,
     const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkSubmitDebugUtilsMessageEXT, 0, instance);
 //Not a CREATE or DESTROY function
 }
 
@@ -3747,6 +10108,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetAndroidHardwareBufferPropertiesANDROID(
     const struct AHardwareBuffer*               buffer,
     VkAndroidHardwareBufferPropertiesANDROID*   pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetAndroidHardwareBufferPropertiesANDROID, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3756,6 +10118,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetMemoryAndroidHardwareBufferANDROID(
     const VkMemoryGetAndroidHardwareBufferInfoANDROID* pInfo,
     struct AHardwareBuffer**                    pBuffer)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetMemoryAndroidHardwareBufferANDROID, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3768,11 +10131,23 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetMemoryAndroidHardwareBufferANDROID(
 
 
 
+struct CmdSetSampleLocationsEXTRecord {
+    static const CommandInfo info;
+    const VkSampleLocationsInfoEXT* pSampleLocationsInfo;
+};
+const CommandInfo CmdSetSampleLocationsEXTRecord::info = {"vkCmdSetSampleLocationsEXT", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdSetSampleLocationsEXT(
     VkCommandBuffer                             commandBuffer,
     const VkSampleLocationsInfoEXT*             pSampleLocationsInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetSampleLocationsEXT, 0, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdSetSampleLocationsEXTRecord>(commandBuffer, CommandArraySize(pSampleLocationsInfo, 1) + CommandNestedSize(pSampleLocationsInfo, 1), &storage);
+    if (!record) return;
+    auto pSampleLocationsInfo_copy = CopyCommandArray(&storage, pSampleLocationsInfo, 1);
+    CopyCommandNested(&storage, pSampleLocationsInfo_copy, 1);
+    record->pSampleLocationsInfo = pSampleLocationsInfo_copy;
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceMultisamplePropertiesEXT(
@@ -3780,6 +10155,7 @@ static VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceMultisamplePropertiesEXT(
     VkSampleCountFlagBits                       samples,
     VkMultisamplePropertiesEXT*                 pMultisampleProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceMultisamplePropertiesEXT, 0, physicalDevice);
 //Not a CREATE or DESTROY function
 }
 
@@ -3795,6 +10171,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetImageDrmFormatModifierPropertiesEXT(
     VkImage                                     image,
     VkImageDrmFormatModifierPropertiesEXT*      pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetImageDrmFormatModifierPropertiesEXT, 0, device, image);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3806,8 +10183,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateValidationCacheEXT(
     const VkAllocationCallbacks*                pAllocator,
     VkValidationCacheEXT*                       pValidationCache)
 {
-    unique_lock_t lock(global_lock);
-    *pValidationCache = (VkValidationCacheEXT)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateValidationCacheEXT, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkValidationCacheEXT, 1);
+    *pValidationCache = (VkValidationCacheEXT)validation_cache_ext_table.Create();
     return VK_SUCCESS;
 }
 
@@ -3816,7 +10194,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyValidationCacheEXT(
     VkValidationCacheEXT                        validationCache,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyValidationCacheEXT, 0, device, validationCache);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkValidationCacheEXT, validationCache != VK_NULL_HANDLE);
+    validation_cache_ext_table.Destroy(validationCache);
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL MergeValidationCachesEXT(
@@ -3825,6 +10205,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL MergeValidationCachesEXT(
     uint32_t                                    srcCacheCount,
     const VkValidationCacheEXT*                 pSrcCaches)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkMergeValidationCachesEXT, srcCacheCount, device, dstCache);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3835,6 +10216,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetValidationCacheDataEXT(
     size_t*                                     pDataSize,
     void*                                       pData)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetValidationCacheDataEXT, 0, device, validationCache);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3842,22 +10224,57 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetValidationCacheDataEXT(
 
 
 
+struct CmdBindShadingRateImageNVRecord {
+    static const CommandInfo info;
+    VkImageView imageView;
+    VkImageLayout imageLayout;
+};
+const CommandInfo CmdBindShadingRateImageNVRecord::info = {"vkCmdBindShadingRateImageNV", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdBindShadingRateImageNV(
     VkCommandBuffer                             commandBuffer,
     VkImageView                                 imageView,
     VkImageLayout                               imageLayout)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBindShadingRateImageNV, 0, commandBuffer, imageView);
+    auto record = RecordCommand<CmdBindShadingRateImageNVRecord>(commandBuffer);
+    if (!record) return;
+    record->imageView = imageView;
+    record->imageLayout = imageLayout;
 }
 
+struct CmdSetViewportShadingRatePaletteNVRecord {
+    static const CommandInfo info;
+    uint32_t firstViewport;
+    uint32_t viewportCount;
+    const VkShadingRatePaletteNV* pShadingRatePalettes;
+};
+const CommandInfo CmdSetViewportShadingRatePaletteNVRecord::info = {"vkCmdSetViewportShadingRatePaletteNV", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdSetViewportShadingRatePaletteNV(
     VkCommandBuffer                             commandBuffer,
     uint32_t                                    firstViewport,
     uint32_t                                    viewportCount,
     const VkShadingRatePaletteNV*               pShadingRatePalettes)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetViewportShadingRatePaletteNV, viewportCount, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdSetViewportShadingRatePaletteNVRecord>(commandBuffer, CommandArraySize(pShadingRatePalettes, viewportCount) + CommandNestedSize(pShadingRatePalettes, viewportCount), &storage);
+    if (!record) return;
+    record->firstViewport = firstViewport;
+    record->viewportCount = viewportCount;
+    auto pShadingRatePalettes_copy = CopyCommandArray(&storage, pShadingRatePalettes, viewportCount);
+    CopyCommandNested(&storage, pShadingRatePalettes_copy, viewportCount);
+    record->pShadingRatePalettes = pShadingRatePalettes_copy;
+}
+
+struct CmdSetCoarseSampleOrderNVRecord {
+    static const CommandInfo info;
+    VkCoarseSampleOrderTypeNV sampleOrderType;
+    uint32_t customSampleOrderCount;
+    const VkCoarseSampleOrderCustomNV* pCustomSampleOrders;
+};
+const CommandInfo CmdSetCoarseSampleOrderNVRecord::info = {"vkCmdSetCoarseSampleOrderNV", nullptr};
 
 static VKAPI_ATTR void VKAPI_CALL CmdSetCoarseSampleOrderNV(
     VkCommandBuffer                             commandBuffer,
@@ -3865,7 +10282,15 @@ static VKAPI_ATTR void VKAPI_CALL CmdSetCoarseSampleOrderNV(
     uint32_t                                    customSampleOrderCount,
     const VkCoarseSampleOrderCustomNV*          pCustomSampleOrders)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetCoarseSampleOrderNV, customSampleOrderCount, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdSetCoarseSampleOrderNVRecord>(commandBuffer, CommandArraySize(pCustomSampleOrders, customSampleOrderCount) + CommandNestedSize(pCustomSampleOrders, customSampleOrderCount), &storage);
+    if (!record) return;
+    record->sampleOrderType = sampleOrderType;
+    record->customSampleOrderCount = customSampleOrderCount;
+    auto pCustomSampleOrders_copy = CopyCommandArray(&storage, pCustomSampleOrders, customSampleOrderCount);
+    CopyCommandNested(&storage, pCustomSampleOrders_copy, customSampleOrderCount);
+    record->pCustomSampleOrders = pCustomSampleOrders_copy;
 }
 
 
@@ -3875,8 +10300,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateAccelerationStructureNV(
     const VkAllocationCallbacks*                pAllocator,
     VkAccelerationStructureNV*                  pAccelerationStructure)
 {
-    unique_lock_t lock(global_lock);
-    *pAccelerationStructure = (VkAccelerationStructureNV)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateAccelerationStructureNV, 0, device);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkAccelerationStructureNV, 1);
+    *pAccelerationStructure = (VkAccelerationStructureNV)acceleration_structure_nv_table.Create();
     return VK_SUCCESS;
 }
 
@@ -3885,7 +10311,9 @@ static VKAPI_ATTR void VKAPI_CALL DestroyAccelerationStructureNV(
     VkAccelerationStructureNV                   accelerationStructure,
     const VkAllocationCallbacks*                pAllocator)
 {
-//Destroy object
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkDestroyAccelerationStructureNV, 0, device, accelerationStructure);
+    entrypoint_scope.CountDestroyed(STATS_OBJECT_VkAccelerationStructureNV, accelerationStructure != VK_NULL_HANDLE);
+    acceleration_structure_nv_table.Destroy(accelerationStructure);
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetAccelerationStructureMemoryRequirementsNV(
@@ -3893,6 +10321,7 @@ static VKAPI_ATTR void VKAPI_CALL GetAccelerationStructureMemoryRequirementsNV(
     const VkAccelerationStructureMemoryRequirementsInfoNV* pInfo,
     VkMemoryRequirements2KHR*                   pMemoryRequirements)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetAccelerationStructureMemoryRequirementsNV, 0, device);
 //Not a CREATE or DESTROY function
 }
 
@@ -3901,10 +10330,24 @@ static VKAPI_ATTR VkResult VKAPI_CALL BindAccelerationStructureMemoryNV(
     uint32_t                                    bindInfoCount,
     const VkBindAccelerationStructureMemoryInfoNV* pBindInfos)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkBindAccelerationStructureMemoryNV, bindInfoCount, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
 
+struct CmdBuildAccelerationStructureNVRecord {
+    static const CommandInfo info;
+    const VkAccelerationStructureInfoNV* pInfo;
+    VkBuffer instanceData;
+    VkDeviceSize instanceOffset;
+    VkBool32 update;
+    VkAccelerationStructureNV dst;
+    VkAccelerationStructureNV src;
+    VkBuffer scratch;
+    VkDeviceSize scratchOffset;
+};
+const CommandInfo CmdBuildAccelerationStructureNVRecord::info = {"vkCmdBuildAccelerationStructureNV", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdBuildAccelerationStructureNV(
     VkCommandBuffer                             commandBuffer,
     const VkAccelerationStructureInfoNV*        pInfo,
@@ -3916,8 +10359,29 @@ static VKAPI_ATTR void VKAPI_CALL CmdBuildAccelerationStructureNV(
     VkBuffer                                    scratch,
     VkDeviceSize                                scratchOffset)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdBuildAccelerationStructureNV, 0, commandBuffer, instanceData, dst, src, scratch);
+    char* storage;
+    auto record = RecordCommand<CmdBuildAccelerationStructureNVRecord>(commandBuffer, CommandArraySize(pInfo, 1) + CommandNestedSize(pInfo, 1), &storage);
+    if (!record) return;
+    auto pInfo_copy = CopyCommandArray(&storage, pInfo, 1);
+    CopyCommandNested(&storage, pInfo_copy, 1);
+    record->pInfo = pInfo_copy;
+    record->instanceData = instanceData;
+    record->instanceOffset = instanceOffset;
+    record->update = update;
+    record->dst = dst;
+    record->src = src;
+    record->scratch = scratch;
+    record->scratchOffset = scratchOffset;
+}
+
+struct CmdCopyAccelerationStructureNVRecord {
+    static const CommandInfo info;
+    VkAccelerationStructureNV dst;
+    VkAccelerationStructureNV src;
+    VkCopyAccelerationStructureModeNV mode;
+};
+const CommandInfo CmdCopyAccelerationStructureNVRecord::info = {"vkCmdCopyAccelerationStructureNV", nullptr};
 
 static VKAPI_ATTR void VKAPI_CALL CmdCopyAccelerationStructureNV(
     VkCommandBuffer                             commandBuffer,
@@ -3925,8 +10389,32 @@ static VKAPI_ATTR void VKAPI_CALL CmdCopyAccelerationStructureNV(
     VkAccelerationStructureNV                   src,
     VkCopyAccelerationStructureModeNV           mode)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdCopyAccelerationStructureNV, 0, commandBuffer, dst, src);
+    auto record = RecordCommand<CmdCopyAccelerationStructureNVRecord>(commandBuffer);
+    if (!record) return;
+    record->dst = dst;
+    record->src = src;
+    record->mode = mode;
+}
+
+struct CmdTraceRaysNVRecord {
+    static const CommandInfo info;
+    VkBuffer raygenShaderBindingTableBuffer;
+    VkDeviceSize raygenShaderBindingOffset;
+    VkBuffer missShaderBindingTableBuffer;
+    VkDeviceSize missShaderBindingOffset;
+    VkDeviceSize missShaderBindingStride;
+    VkBuffer hitShaderBindingTableBuffer;
+    VkDeviceSize hitShaderBindingOffset;
+    VkDeviceSize hitShaderBindingStride;
+    VkBuffer callableShaderBindingTableBuffer;
+    VkDeviceSize callableShaderBindingOffset;
+    VkDeviceSize callableShaderBindingStride;
+    uint32_t width;
+    uint32_t height;
+    uint32_t depth;
+};
+const CommandInfo CmdTraceRaysNVRecord::info = {"vkCmdTraceRaysNV", nullptr};
 
 static VKAPI_ATTR void VKAPI_CALL CmdTraceRaysNV(
     VkCommandBuffer                             commandBuffer,
@@ -3945,7 +10433,23 @@ static VKAPI_ATTR void VKAPI_CALL CmdTraceRaysNV(
     uint32_t                                    height,
     uint32_t                                    depth)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdTraceRaysNV, 0, commandBuffer, raygenShaderBindingTableBuffer, missShaderBindingTableBuffer, hitShaderBindingTableBuffer, callableShaderBindingTableBuffer);
+    auto record = RecordCommand<CmdTraceRaysNVRecord>(commandBuffer);
+    if (!record) return;
+    record->raygenShaderBindingTableBuffer = raygenShaderBindingTableBuffer;
+    record->raygenShaderBindingOffset = raygenShaderBindingOffset;
+    record->missShaderBindingTableBuffer = missShaderBindingTableBuffer;
+    record->missShaderBindingOffset = missShaderBindingOffset;
+    record->missShaderBindingStride = missShaderBindingStride;
+    record->hitShaderBindingTableBuffer = hitShaderBindingTableBuffer;
+    record->hitShaderBindingOffset = hitShaderBindingOffset;
+    record->hitShaderBindingStride = hitShaderBindingStride;
+    record->callableShaderBindingTableBuffer = callableShaderBindingTableBuffer;
+    record->callableShaderBindingOffset = callableShaderBindingOffset;
+    record->callableShaderBindingStride = callableShaderBindingStride;
+    record->width = width;
+    record->height = height;
+    record->depth = depth;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CreateRayTracingPipelinesNV(
@@ -3956,9 +10460,10 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateRayTracingPipelinesNV(
     const VkAllocationCallbacks*                pAllocator,
     VkPipeline*                                 pPipelines)
 {
-    unique_lock_t lock(global_lock);
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateRayTracingPipelinesNV, createInfoCount, device, pipelineCache);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkPipeline, createInfoCount);
     for (uint32_t i = 0; i < createInfoCount; ++i) {
-        pPipelines[i] = (VkPipeline)global_unique_handle++;
+        pPipelines[i] = (VkPipeline)pipeline_table.Create();
     }
     return VK_SUCCESS;
 }
@@ -3971,6 +10476,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetRayTracingShaderGroupHandlesNV(
     size_t                                      dataSize,
     void*                                       pData)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetRayTracingShaderGroupHandlesNV, dataSize, device, pipeline);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -3981,10 +10487,21 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetAccelerationStructureHandleNV(
     size_t                                      dataSize,
     void*                                       pData)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetAccelerationStructureHandleNV, dataSize, device, accelerationStructure);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
 
+struct CmdWriteAccelerationStructuresPropertiesNVRecord {
+    static const CommandInfo info;
+    uint32_t accelerationStructureCount;
+    const VkAccelerationStructureNV* pAccelerationStructures;
+    VkQueryType queryType;
+    VkQueryPool queryPool;
+    uint32_t firstQuery;
+};
+const CommandInfo CmdWriteAccelerationStructuresPropertiesNVRecord::info = {"vkCmdWriteAccelerationStructuresPropertiesNV", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdWriteAccelerationStructuresPropertiesNV(
     VkCommandBuffer                             commandBuffer,
     uint32_t                                    accelerationStructureCount,
@@ -3993,7 +10510,15 @@ static VKAPI_ATTR void VKAPI_CALL CmdWriteAccelerationStructuresPropertiesNV(
     VkQueryPool                                 queryPool,
     uint32_t                                    firstQuery)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdWriteAccelerationStructuresPropertiesNV, accelerationStructureCount, commandBuffer, queryPool);
+    char* storage;
+    auto record = RecordCommand<CmdWriteAccelerationStructuresPropertiesNVRecord>(commandBuffer, CommandArraySize(pAccelerationStructures, accelerationStructureCount), &storage);
+    if (!record) return;
+    record->accelerationStructureCount = accelerationStructureCount;
+    record->pAccelerationStructures = CopyCommandArray(&storage, pAccelerationStructures, accelerationStructureCount);
+    record->queryType = queryType;
+    record->queryPool = queryPool;
+    record->firstQuery = firstQuery;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL CompileDeferredNV(
@@ -4001,6 +10526,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL CompileDeferredNV(
     VkPipeline                                  pipeline,
     uint32_t                                    shader)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCompileDeferredNV, 0, device, pipeline);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -4015,11 +10541,21 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetMemoryHostPointerPropertiesEXT(
     const void*                                 pHostPointer,
     VkMemoryHostPointerPropertiesEXT*           pMemoryHostPointerProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetMemoryHostPointerPropertiesEXT, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
 
 
+struct CmdWriteBufferMarkerAMDRecord {
+    static const CommandInfo info;
+    VkPipelineStageFlagBits pipelineStage;
+    VkBuffer dstBuffer;
+    VkDeviceSize dstOffset;
+    uint32_t marker;
+};
+const CommandInfo CmdWriteBufferMarkerAMDRecord::info = {"vkCmdWriteBufferMarkerAMD", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdWriteBufferMarkerAMD(
     VkCommandBuffer                             commandBuffer,
     VkPipelineStageFlagBits                     pipelineStage,
@@ -4027,7 +10563,13 @@ static VKAPI_ATTR void VKAPI_CALL CmdWriteBufferMarkerAMD(
     VkDeviceSize                                dstOffset,
     uint32_t                                    marker)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdWriteBufferMarkerAMD, 0, commandBuffer, dstBuffer);
+    auto record = RecordCommand<CmdWriteBufferMarkerAMDRecord>(commandBuffer);
+    if (!record) return;
+    record->pipelineStage = pipelineStage;
+    record->dstBuffer = dstBuffer;
+    record->dstOffset = dstOffset;
+    record->marker = marker;
 }
 
 
@@ -4037,8 +10579,21 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceCalibrateableTimeDomainsE
     uint32_t*                                   pTimeDomainCount,
     VkTimeDomainEXT*                            pTimeDomains)
 {
-//Not a CREATE or DESTROY function
-    return VK_SUCCESS;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT, 0, physicalDevice);
+#if defined(__linux__)
+    static const VkTimeDomainEXT time_domains[] = {VK_TIME_DOMAIN_DEVICE_EXT, VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT,
+                                                   VK_TIME_DOMAIN_CLOCK_MONOTONIC_RAW_EXT};
+#else
+    static const VkTimeDomainEXT time_domains[] = {VK_TIME_DOMAIN_DEVICE_EXT};
+#endif
+    const uint32_t count = sizeof(time_domains) / sizeof(time_domains[0]);
+    if (!pTimeDomains) {
+        *pTimeDomainCount = count;
+        return VK_SUCCESS;
+    }
+    *pTimeDomainCount = std::min(*pTimeDomainCount, count);
+    memcpy(pTimeDomains, time_domains, *pTimeDomainCount * sizeof(VkTimeDomainEXT));
+    return *pTimeDomainCount < count ? VK_INCOMPLETE : VK_SUCCESS;
 }
 
 static VKAPI_ATTR VkResult VKAPI_CALL GetCalibratedTimestampsEXT(
@@ -4048,7 +10603,26 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetCalibratedTimestampsEXT(
     uint64_t*                                   pTimestamps,
     uint64_t*                                   pMaxDeviation)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetCalibratedTimestampsEXT, timestampCount, device);
+    // Device timestamps are CLOCK_MONOTONIC, so both domains share one reading. Only the raw clock needs
+    // a reading of its own, the deviation is the time spent taking all of them.
+    const uint64_t begin = GetDeviceTimestamp();
+    for (uint32_t i = 0; i < timestampCount; ++i) {
+        switch (pTimestampInfos[i].timeDomain) {
+#if defined(__linux__)
+            case VK_TIME_DOMAIN_CLOCK_MONOTONIC_RAW_EXT: {
+                struct timespec now;
+                clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+                pTimestamps[i] = (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+                break;
+            }
+#endif
+            default:
+                pTimestamps[i] = begin;
+                break;
+        }
+    }
+    *pMaxDeviation = std::max<uint64_t>(GetDeviceTimestamp() - begin, 1);
     return VK_SUCCESS;
 }
 
@@ -4062,14 +10636,34 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetCalibratedTimestampsEXT(
 
 
 
+struct CmdDrawMeshTasksNVRecord {
+    static const CommandInfo info;
+    uint32_t taskCount;
+    uint32_t firstTask;
+};
+const CommandInfo CmdDrawMeshTasksNVRecord::info = {"vkCmdDrawMeshTasksNV", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdDrawMeshTasksNV(
     VkCommandBuffer                             commandBuffer,
     uint32_t                                    taskCount,
     uint32_t                                    firstTask)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDrawMeshTasksNV, 0, commandBuffer);
+    auto record = RecordCommand<CmdDrawMeshTasksNVRecord>(commandBuffer);
+    if (!record) return;
+    record->taskCount = taskCount;
+    record->firstTask = firstTask;
 }
 
+struct CmdDrawMeshTasksIndirectNVRecord {
+    static const CommandInfo info;
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    uint32_t drawCount;
+    uint32_t stride;
+};
+const CommandInfo CmdDrawMeshTasksIndirectNVRecord::info = {"vkCmdDrawMeshTasksIndirectNV", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdDrawMeshTasksIndirectNV(
     VkCommandBuffer                             commandBuffer,
     VkBuffer                                    buffer,
@@ -4077,8 +10671,25 @@ static VKAPI_ATTR void VKAPI_CALL CmdDrawMeshTasksIndirectNV(
     uint32_t                                    drawCount,
     uint32_t                                    stride)
 {
-//Not a CREATE or DESTROY function
-}
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDrawMeshTasksIndirectNV, 0, commandBuffer, buffer);
+    auto record = RecordCommand<CmdDrawMeshTasksIndirectNVRecord>(commandBuffer);
+    if (!record) return;
+    record->buffer = buffer;
+    record->offset = offset;
+    record->drawCount = drawCount;
+    record->stride = stride;
+}
+
+struct CmdDrawMeshTasksIndirectCountNVRecord {
+    static const CommandInfo info;
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    VkBuffer countBuffer;
+    VkDeviceSize countBufferOffset;
+    uint32_t maxDrawCount;
+    uint32_t stride;
+};
+const CommandInfo CmdDrawMeshTasksIndirectCountNVRecord::info = {"vkCmdDrawMeshTasksIndirectCountNV", nullptr};
 
 static VKAPI_ATTR void VKAPI_CALL CmdDrawMeshTasksIndirectCountNV(
     VkCommandBuffer                             commandBuffer,
@@ -4089,27 +10700,60 @@ static VKAPI_ATTR void VKAPI_CALL CmdDrawMeshTasksIndirectCountNV(
     uint32_t                                    maxDrawCount,
     uint32_t                                    stride)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdDrawMeshTasksIndirectCountNV, 0, commandBuffer, buffer, countBuffer);
+    auto record = RecordCommand<CmdDrawMeshTasksIndirectCountNVRecord>(commandBuffer);
+    if (!record) return;
+    record->buffer = buffer;
+    record->offset = offset;
+    record->countBuffer = countBuffer;
+    record->countBufferOffset = countBufferOffset;
+    record->maxDrawCount = maxDrawCount;
+    record->stride = stride;
 }
 
 
 
 
+struct CmdSetExclusiveScissorNVRecord {
+    static const CommandInfo info;
+    uint32_t firstExclusiveScissor;
+    uint32_t exclusiveScissorCount;
+    const VkRect2D* pExclusiveScissors;
+};
+const CommandInfo CmdSetExclusiveScissorNVRecord::info = {"vkCmdSetExclusiveScissorNV", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdSetExclusiveScissorNV(
     VkCommandBuffer                             commandBuffer,
     uint32_t                                    firstExclusiveScissor,
     uint32_t                                    exclusiveScissorCount,
     const VkRect2D*                             pExclusiveScissors)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetExclusiveScissorNV, exclusiveScissorCount, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdSetExclusiveScissorNVRecord>(commandBuffer, CommandArraySize(pExclusiveScissors, exclusiveScissorCount) + CommandNestedSize(pExclusiveScissors, exclusiveScissorCount), &storage);
+    if (!record) return;
+    record->firstExclusiveScissor = firstExclusiveScissor;
+    record->exclusiveScissorCount = exclusiveScissorCount;
+    auto pExclusiveScissors_copy = CopyCommandArray(&storage, pExclusiveScissors, exclusiveScissorCount);
+    CopyCommandNested(&storage, pExclusiveScissors_copy, exclusiveScissorCount);
+    record->pExclusiveScissors = pExclusiveScissors_copy;
 }
 
 
+struct CmdSetCheckpointNVRecord {
+    static const CommandInfo info;
+    const void* pCheckpointMarker;
+};
+const CommandInfo CmdSetCheckpointNVRecord::info = {"vkCmdSetCheckpointNV", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdSetCheckpointNV(
     VkCommandBuffer                             commandBuffer,
     const void*                                 pCheckpointMarker)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetCheckpointNV, 0, commandBuffer);
+    auto record = RecordCommand<CmdSetCheckpointNVRecord>(commandBuffer);
+    if (!record) return;
+    record->pCheckpointMarker = pCheckpointMarker;
 }
 
 static VKAPI_ATTR void VKAPI_CALL GetQueueCheckpointDataNV(
@@ -4117,6 +10761,7 @@ static VKAPI_ATTR void VKAPI_CALL GetQueueCheckpointDataNV(
     uint32_t*                                   pCheckpointDataCount,
     VkCheckpointDataNV*                         pCheckpointData)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetQueueCheckpointDataNV, 0, queue);
 //Not a CREATE or DESTROY function
 }
 
@@ -4126,6 +10771,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL InitializePerformanceApiINTEL(
     VkDevice                                    device,
     const VkInitializePerformanceApiInfoINTEL*  pInitializeInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkInitializePerformanceApiINTEL, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -4133,30 +10779,67 @@ static VKAPI_ATTR VkResult VKAPI_CALL InitializePerformanceApiINTEL(
 static VKAPI_ATTR void VKAPI_CALL UninitializePerformanceApiINTEL(
     VkDevice                                    device)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkUninitializePerformanceApiINTEL, 0, device);
 //Not a CREATE or DESTROY function
 }
 
+struct CmdSetPerformanceMarkerINTELRecord {
+    static const CommandInfo info;
+    const VkPerformanceMarkerInfoINTEL* pMarkerInfo;
+};
+const CommandInfo CmdSetPerformanceMarkerINTELRecord::info = {"vkCmdSetPerformanceMarkerINTEL", nullptr};
+
 static VKAPI_ATTR VkResult VKAPI_CALL CmdSetPerformanceMarkerINTEL(
     VkCommandBuffer                             commandBuffer,
     const VkPerformanceMarkerInfoINTEL*         pMarkerInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetPerformanceMarkerINTEL, 0, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdSetPerformanceMarkerINTELRecord>(commandBuffer, CommandArraySize(pMarkerInfo, 1) + CommandNestedSize(pMarkerInfo, 1), &storage);
+    if (!record) return;
+    auto pMarkerInfo_copy = CopyCommandArray(&storage, pMarkerInfo, 1);
+    CopyCommandNested(&storage, pMarkerInfo_copy, 1);
+    record->pMarkerInfo = pMarkerInfo_copy;
     return VK_SUCCESS;
 }
 
+struct CmdSetPerformanceStreamMarkerINTELRecord {
+    static const CommandInfo info;
+    const VkPerformanceStreamMarkerInfoINTEL* pMarkerInfo;
+};
+const CommandInfo CmdSetPerformanceStreamMarkerINTELRecord::info = {"vkCmdSetPerformanceStreamMarkerINTEL", nullptr};
+
 static VKAPI_ATTR VkResult VKAPI_CALL CmdSetPerformanceStreamMarkerINTEL(
     VkCommandBuffer                             commandBuffer,
     const VkPerformanceStreamMarkerInfoINTEL*   pMarkerInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetPerformanceStreamMarkerINTEL, 0, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdSetPerformanceStreamMarkerINTELRecord>(commandBuffer, CommandArraySize(pMarkerInfo, 1) + CommandNestedSize(pMarkerInfo, 1), &storage);
+    if (!record) return;
+    auto pMarkerInfo_copy = CopyCommandArray(&storage, pMarkerInfo, 1);
+    CopyCommandNested(&storage, pMarkerInfo_copy, 1);
+    record->pMarkerInfo = pMarkerInfo_copy;
     return VK_SUCCESS;
 }
 
+struct CmdSetPerformanceOverrideINTELRecord {
+    static const CommandInfo info;
+    const VkPerformanceOverrideInfoINTEL* pOverrideInfo;
+};
+const CommandInfo CmdSetPerformanceOverrideINTELRecord::info = {"vkCmdSetPerformanceOverrideINTEL", nullptr};
+
 static VKAPI_ATTR VkResult VKAPI_CALL CmdSetPerformanceOverrideINTEL(
     VkCommandBuffer                             commandBuffer,
     const VkPerformanceOverrideInfoINTEL*       pOverrideInfo)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetPerformanceOverrideINTEL, 0, commandBuffer);
+    char* storage;
+    auto record = RecordCommand<CmdSetPerformanceOverrideINTELRecord>(commandBuffer, CommandArraySize(pOverrideInfo, 1) + CommandNestedSize(pOverrideInfo, 1), &storage);
+    if (!record) return;
+    auto pOverrideInfo_copy = CopyCommandArray(&storage, pOverrideInfo, 1);
+    CopyCommandNested(&storage, pOverrideInfo_copy, 1);
+    record->pOverrideInfo = pOverrideInfo_copy;
     return VK_SUCCESS;
 }
 
@@ -4165,6 +10848,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL AcquirePerformanceConfigurationINTEL(
     const VkPerformanceConfigurationAcquireInfoINTEL* pAcquireInfo,
     VkPerformanceConfigurationINTEL*            pConfiguration)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkAcquirePerformanceConfigurationINTEL, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -4173,6 +10857,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL ReleasePerformanceConfigurationINTEL(
     VkDevice                                    device,
     VkPerformanceConfigurationINTEL             configuration)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkReleasePerformanceConfigurationINTEL, 0, device, configuration);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -4181,6 +10866,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL QueueSetPerformanceConfigurationINTEL(
     VkQueue                                     queue,
     VkPerformanceConfigurationINTEL             configuration)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkQueueSetPerformanceConfigurationINTEL, 0, queue, configuration);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -4190,6 +10876,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPerformanceParameterINTEL(
     VkPerformanceParameterTypeINTEL             parameter,
     VkPerformanceValueINTEL*                    pValue)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPerformanceParameterINTEL, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -4201,6 +10888,7 @@ static VKAPI_ATTR void VKAPI_CALL SetLocalDimmingAMD(
     VkSwapchainKHR                              swapChain,
     VkBool32                                    localDimmingEnable)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkSetLocalDimmingAMD, 0, device, swapChain);
 //Not a CREATE or DESTROY function
 }
 
@@ -4212,8 +10900,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateImagePipeSurfaceFUCHSIA(
     const VkAllocationCallbacks*                pAllocator,
     VkSurfaceKHR*                               pSurface)
 {
-    unique_lock_t lock(global_lock);
-    *pSurface = (VkSurfaceKHR)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateImagePipeSurfaceFUCHSIA, 0, instance);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSurfaceKHR, 1);
+    *pSurface = (VkSurfaceKHR)surface_khr_table.Create();
     return VK_SUCCESS;
 }
 #endif /* VK_USE_PLATFORM_FUCHSIA */
@@ -4226,8 +10915,9 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateMetalSurfaceEXT(
     const VkAllocationCallbacks*                pAllocator,
     VkSurfaceKHR*                               pSurface)
 {
-    unique_lock_t lock(global_lock);
-    *pSurface = (VkSurfaceKHR)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateMetalSurfaceEXT, 0, instance);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSurfaceKHR, 1);
+    *pSurface = (VkSurfaceKHR)surface_khr_table.Create();
     return VK_SUCCESS;
 }
 #endif /* VK_USE_PLATFORM_METAL_EXT */
@@ -4247,6 +10937,7 @@ static VKAPI_ATTR VkDeviceAddress VKAPI_CALL GetBufferDeviceAddressEXT(
     VkDevice                                    device,
     const VkBufferDeviceAddressInfo*            pInfo)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetBufferDeviceAddressEXT, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -4257,6 +10948,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceToolPropertiesEXT(
     uint32_t*                                   pToolCount,
     VkPhysicalDeviceToolPropertiesEXT*          pToolProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceToolPropertiesEXT, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -4269,6 +10961,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceCooperativeMatrixProperti
     uint32_t*                                   pPropertyCount,
     VkCooperativeMatrixPropertiesNV*            pProperties)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceCooperativeMatrixPropertiesNV, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -4279,6 +10972,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSupportedFramebufferMixed
     uint32_t*                                   pCombinationCount,
     VkFramebufferMixedSamplesCombinationNV*     pCombinations)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceSupportedFramebufferMixedSamplesCombinationsNV, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -4293,6 +10987,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfacePresentModes2EXT(
     uint32_t*                                   pPresentModeCount,
     VkPresentModeKHR*                           pPresentModes)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetPhysicalDeviceSurfacePresentModes2EXT, 0, physicalDevice);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -4301,6 +10996,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL AcquireFullScreenExclusiveModeEXT(
     VkDevice                                    device,
     VkSwapchainKHR                              swapchain)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkAcquireFullScreenExclusiveModeEXT, 0, device, swapchain);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -4309,6 +11005,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL ReleaseFullScreenExclusiveModeEXT(
     VkDevice                                    device,
     VkSwapchainKHR                              swapchain)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkReleaseFullScreenExclusiveModeEXT, 0, device, swapchain);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -4318,6 +11015,7 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetDeviceGroupSurfacePresentModes2EXT(
     const VkPhysicalDeviceSurfaceInfo2KHR*      pSurfaceInfo,
     VkDeviceGroupPresentModeFlagsKHR*           pModes)
 {
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkGetDeviceGroupSurfacePresentModes2EXT, 0, device);
 //Not a CREATE or DESTROY function
     return VK_SUCCESS;
 }
@@ -4330,18 +11028,30 @@ static VKAPI_ATTR VkResult VKAPI_CALL CreateHeadlessSurfaceEXT(
     const VkAllocationCallbacks*                pAllocator,
     VkSurfaceKHR*                               pSurface)
 {
-    unique_lock_t lock(global_lock);
-    *pSurface = (VkSurfaceKHR)global_unique_handle++;
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCreateHeadlessSurfaceEXT, 0, instance);
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkSurfaceKHR, 1);
+    *pSurface = (VkSurfaceKHR)surface_khr_table.Create();
     return VK_SUCCESS;
 }
 
 
+struct CmdSetLineStippleEXTRecord {
+    static const CommandInfo info;
+    uint32_t lineStippleFactor;
+    uint16_t lineStipplePattern;
+};
+const CommandInfo CmdSetLineStippleEXTRecord::info = {"vkCmdSetLineStippleEXT", nullptr};
+
 static VKAPI_ATTR void VKAPI_CALL CmdSetLineStippleEXT(
     VkCommandBuffer                             commandBuffer,
     uint32_t                                    lineStippleFactor,
     uint16_t                                    lineStipplePattern)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkCmdSetLineStippleEXT, 0, commandBuffer);
+    auto record = RecordCommand<CmdSetLineStippleEXTRecord>(commandBuffer);
+    if (!record) return;
+    record->lineStippleFactor = lineStippleFactor;
+    record->lineStipplePattern = lineStipplePattern;
 }
 
 
@@ -4351,7 +11061,8 @@ static VKAPI_ATTR void VKAPI_CALL ResetQueryPoolEXT(
     uint32_t                                    firstQuery,
     uint32_t                                    queryCount)
 {
-//Not a CREATE or DESTROY function
+    EntrypointScope entrypoint_scope(ENTRYPOINT_vkResetQueryPoolEXT, 0, device, queryPool);
+    ResetQueryPool(device, queryPool, firstQuery, queryCount);
 }
 
 
@@ -4362,9 +11073,9 @@ static VKAPI_ATTR void VKAPI_CALL ResetQueryPoolEXT(
 
 static VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetPhysicalDeviceProcAddr(VkInstance instance, const char *funcName) {
     // TODO: This function should only care about physical device functions and return nullptr for other functions
-    const auto &item = name_to_funcptr_map.find(funcName);
-    if (item != name_to_funcptr_map.end()) {
-        return reinterpret_cast<PFN_vkVoidFunction>(item->second);
+    const auto item = name_to_funcptr_map.Find(funcName);
+    if (item) {
+        return reinterpret_cast<PFN_vkVoidFunction>(*item);
     }
     // Mock should intercept all functions so if we get here just return null
     return nullptr;
@@ -22,10 +22,14 @@
 **
 */
 
-#include <unordered_map>
+#include <atomic>
 #include <mutex>
 #include <string>
+#include <cstddef>
 #include <cstring>
+#include <new>
+#include <type_traits>
+#include <vector>
 #include "vulkan/vk_icd.h"
 namespace vkmock {
 
@@ -35,216 +39,1022 @@ using lock_guard_t = std::lock_guard<mutex_t>;
 using unique_lock_t = std::unique_lock<mutex_t>;
 
 static mutex_t global_lock;
-static uint64_t global_unique_handle = 1;
 static const uint32_t SUPPORTED_LOADER_ICD_INTERFACE_VERSION = 5;
 static uint32_t loader_interface_version = 0;
 static bool negotiate_loader_icd_interface_called = false;
+
+// Fixed-size object allocator. Objects are carved out of chunks and recycled through an intrusive
+// free list; all chunks are released together when the allocator itself is destroyed.
+// Not thread safe, callers provide their own synchronization.
+template <typename T>
+class SlabAllocator {
+   public:
+    SlabAllocator() : free_list_(nullptr) {}
+    ~SlabAllocator() {
+        for (auto chunk : chunks_) delete[] chunk;
+    }
+    T* Allocate() {
+        if (!free_list_) Grow();
+        Block* block = free_list_;
+        free_list_ = block->next;
+        return new (&block->storage) T();
+    }
+    void Free(T* object) {
+        object->~T();
+        Block* block = reinterpret_cast<Block*>(object);
+        block->next = free_list_;
+        free_list_ = block;
+    }
+
+   private:
+    static const size_t BLOCKS_PER_CHUNK = 64;
+    union Block {
+        Block* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+    void Grow() {
+        Block* chunk = new Block[BLOCKS_PER_CHUNK];
+        chunks_.push_back(chunk);
+        for (size_t i = BLOCKS_PER_CHUNK; i > 0; --i) {
+            chunk[i - 1].next = free_list_;
+            free_list_ = &chunk[i - 1];
+        }
+    }
+    Block* free_list_;
+    std::vector<Block*> chunks_;
+};
+
+// Non-dispatchable handles encode where their object lives: the object type in the top 8 bits, the
+// generation of the object's slot in the next 24 and the index of the slot in the table of its type in
+// the low 32. A slot's generation is odd while an object lives in it and goes up when the object is
+// created and destroyed, so the handles of destroyed objects stop resolving even once the slot is reused.
+static const uint32_t HANDLE_TYPE_SHIFT = 56;
+static const uint32_t HANDLE_GENERATION_SHIFT = 32;
+static const uint32_t HANDLE_GENERATION_MASK = 0xFFFFFF;
+
+// Objects without state of their own only have their handles tracked
+struct ObjectState {};
+
+// Dense table of the objects of one handle type, holding their state in slots addressed by their
+// handles. Slots are allocated in chunks that never move, so pointers to objects stay valid until the
+// objects are destroyed. Creating, destroying and looking up objects take no lock: slots no object used
+// yet are reserved with a counter, and slots of destroyed objects are reused from a lock-free free list
+// whose head carries the generation of its top slot, so that a slot that is taken and put back while
+// another thread pops the list changes the head and fails that thread's compare-exchange. The application
+// already has to synchronize destroying an object with its other uses. The objects' state is guarded by
+// whatever guards it for callers.
+template <typename T>
+class ObjectTable {
+   public:
+    explicit ObjectTable(uint32_t type) : type_(type) {}
+    // Creates an object from args and returns its handle, or 0 once the table is full
+    template <typename... Args>
+    uint64_t Create(Args&&... args) {
+        uint32_t index;
+        if (!PopFreeSlot(&index) && !ReserveSlot(&index)) return 0;
+        Slot& slot = GetSlot(index);
+        new (&slot.storage) T(std::forward<Args>(args)...);
+        const uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+        slot.generation.store(generation, std::memory_order_release);
+        return ((uint64_t)type_ << HANDLE_TYPE_SHIFT) | ((uint64_t)generation << HANDLE_GENERATION_SHIFT) | index;
+    }
+    // Returns the object of a handle, null for handles of destroyed objects, other types or VK_NULL_HANDLE
+    template <typename Handle>
+    T* Get(Handle handle) const {
+        const uint64_t value = (uint64_t)handle;
+        const uint32_t index = (uint32_t)value;
+        if ((value >> HANDLE_TYPE_SHIFT) != type_ || index >= SLOT_COUNT) return nullptr;
+        const Page* page = pages_[index / SLOTS_PER_PAGE].load(std::memory_order_acquire);
+        if (!page) return nullptr;
+        const Chunk* chunk = page->chunks[index / CHUNK_SIZE % CHUNKS_PER_PAGE].load(std::memory_order_acquire);
+        if (!chunk) return nullptr;
+        const Slot& slot = chunk->slots[index % CHUNK_SIZE];
+        const uint32_t generation = slot.generation.load(std::memory_order_acquire);
+        if (!(generation & 1) || generation != ((value >> HANDLE_GENERATION_SHIFT) & HANDLE_GENERATION_MASK)) return nullptr;
+        return reinterpret_cast<T*>(const_cast<typename std::aligned_storage<sizeof(T), alignof(T)>::type*>(&slot.storage));
+    }
+    // Destroys the object of a handle, returns false if there is none
+    template <typename Handle>
+    bool Destroy(Handle handle) {
+        T* object = Get(handle);
+        if (!object) return false;
+        const uint32_t index = (uint32_t)(uint64_t)handle;
+        Slot& slot = GetSlot(index);
+        object->~T();
+        const uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+        slot.generation.store(generation, std::memory_order_release);
+        // Slots whose generations ran out are retired, so that no handle is ever handed out twice
+        if (generation < HANDLE_GENERATION_MASK) PushFreeSlot(index, generation);
+        return true;
+    }
+
+   private:
+    // Up to 64M objects of each type. The chunks of slots, and the directory pages that point to them, are
+    // only allocated once objects need them, so a type the application does not create costs a few pointers.
+    static const uint32_t CHUNK_SIZE = 4096;
+    static const uint32_t CHUNKS_PER_PAGE = 128;
+    static const uint32_t PAGE_COUNT = 128;
+    static const uint32_t SLOTS_PER_PAGE = CHUNK_SIZE * CHUNKS_PER_PAGE;
+    static const uint32_t SLOT_COUNT = SLOTS_PER_PAGE * PAGE_COUNT;
+    struct Slot {
+        std::atomic<uint32_t> generation;
+        std::atomic<uint32_t> next_free;  // While on the free list, index + 1 of the slot below it or 0
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+    struct Chunk {
+        Slot slots[CHUNK_SIZE];
+    };
+    struct Page {
+        std::atomic<Chunk*> chunks[CHUNKS_PER_PAGE];
+    };
+    Slot& GetSlot(uint32_t index) const {
+        Page* page = pages_[index / SLOTS_PER_PAGE].load(std::memory_order_acquire);
+        return page->chunks[index / CHUNK_SIZE % CHUNKS_PER_PAGE].load(std::memory_order_acquire)->slots[index % CHUNK_SIZE];
+    }
+    // Stores a page or chunk unless another thread stored one first, and returns the one stored. Both are
+    // value initialized, which leaves every pointer null and every generation 0.
+    template <typename U>
+    static U* Publish(std::atomic<U*>& pointer) {
+        U* stored = pointer.load(std::memory_order_acquire);
+        if (stored) return stored;
+        U* created = new U();
+        if (pointer.compare_exchange_strong(stored, created, std::memory_order_acq_rel, std::memory_order_acquire)) return created;
+        delete created;
+        return stored;
+    }
+    // Takes a slot no object used yet
+    bool ReserveSlot(uint32_t* index) {
+        uint32_t count = slot_count_.load(std::memory_order_relaxed);
+        do {
+            if (count == SLOT_COUNT) return false;
+        } while (!slot_count_.compare_exchange_weak(count, count + 1, std::memory_order_relaxed));
+        Page* page = Publish(pages_[count / SLOTS_PER_PAGE]);
+        Publish(page->chunks[count / CHUNK_SIZE % CHUNKS_PER_PAGE]);
+        *index = count;
+        return true;
+    }
+    // The free list's head holds index + 1 of its top slot, 0 when empty, and that slot's generation in the high bits
+    bool PopFreeSlot(uint32_t* index) {
+        uint64_t head = free_head_.load(std::memory_order_acquire);
+        while ((uint32_t)head) {
+            const uint32_t top = (uint32_t)head - 1;
+            const uint32_t next = GetSlot(top).next_free.load(std::memory_order_relaxed);
+            const uint64_t next_head = next ? ((uint64_t)GetSlot(next - 1).generation.load(std::memory_order_relaxed) << 32) | next : 0;
+            if (free_head_.compare_exchange_weak(head, next_head, std::memory_order_acquire, std::memory_order_acquire)) {
+                *index = top;
+                return true;
+            }
+        }
+        return false;
+    }
+    void PushFreeSlot(uint32_t index, uint32_t generation) {
+        Slot& slot = GetSlot(index);
+        const uint64_t new_head = ((uint64_t)generation << 32) | (index + 1);
+        uint64_t head = free_head_.load(std::memory_order_relaxed);
+        do {
+            slot.next_free.store((uint32_t)head, std::memory_order_relaxed);
+        } while (!free_head_.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
+    }
+    const uint32_t type_;
+    std::atomic<uint32_t> slot_count_{0};
+    std::atomic<uint64_t> free_head_{0};
+    // Never released, threads may still use objects while the process exits. Null from static initialization.
+    std::atomic<Page*> pages_[PAGE_COUNT];
+};
+
+// Instances, physical devices, devices and queues share one slab with its own lock so that
+// creating them never contends with global_lock
+static mutex_t disp_obj_lock;
+static SlabAllocator<VK_LOADER_DATA> disp_obj_slab;
 static void* CreateDispObjHandle() {
-    auto handle = new VK_LOADER_DATA;
+    lock_guard_t lock(disp_obj_lock);
+    auto handle = disp_obj_slab.Allocate();
     set_loader_magic_value(handle);
     return handle;
 }
 static void DestroyDispObjHandle(void* handle) {
-    delete reinterpret_cast<VK_LOADER_DATA*>(handle);
+    lock_guard_t lock(disp_obj_lock);
+    disp_obj_slab.Free(reinterpret_cast<VK_LOADER_DATA*>(handle));
 }
 
-// Map of instance extension name to version
-static const std::unordered_map<std::string, uint32_t> instance_extension_map = {
-    {"VK_KHR_surface", 25},
-    {"VK_KHR_display", 23},
-    {"VK_KHR_xlib_surface", 6},
-    {"VK_KHR_xcb_surface", 6},
-    {"VK_KHR_wayland_surface", 6},
-    {"VK_KHR_android_surface", 6},
-    {"VK_KHR_win32_surface", 6},
-    {"VK_EXT_debug_report", 9},
-    {"VK_GGP_stream_descriptor_surface", 1},
-    {"VK_NV_external_memory_capabilities", 1},
-    {"VK_KHR_get_physical_device_properties2", 2},
-    {"VK_EXT_validation_flags", 2},
-    {"VK_NN_vi_surface", 1},
-    {"VK_KHR_device_group_creation", 1},
-    {"VK_KHR_external_memory_capabilities", 1},
-    {"VK_KHR_external_semaphore_capabilities", 1},
-    {"VK_EXT_direct_mode_display", 1},
-    {"VK_EXT_acquire_xlib_display", 1},
-    {"VK_EXT_display_surface_counter", 1},
-    {"VK_EXT_swapchain_colorspace", 4},
-    {"VK_KHR_external_fence_capabilities", 1},
-    {"VK_KHR_get_surface_capabilities2", 1},
-    {"VK_KHR_get_display_properties2", 1},
-    {"VK_MVK_ios_surface", 2},
-    {"VK_MVK_macos_surface", 2},
-    {"VK_EXT_debug_utils", 1},
-    {"VK_FUCHSIA_imagepipe_surface", 1},
-    {"VK_EXT_metal_surface", 1},
-    {"VK_KHR_surface_protected_capabilities", 1},
-    {"VK_EXT_validation_features", 2},
-    {"VK_EXT_headless_surface", 1},
+// Entrypoint and extension names are looked up in perfect hash tables built by the generator. A
+// name's FNV-1a hash selects a bucket, whose seed scrambles the hash into the one slot that name can
+// occupy. The slot's length and hash reject nearly every other string before the names are compared.
+static inline uint32_t HashName(const char* name, uint32_t* length) {
+    uint32_t hash = 2166136261u;
+    const char* c = name;
+    for (; *c; ++c) hash = (hash ^ (uint8_t)*c) * 16777619u;
+    *length = (uint32_t)(c - name);
+    return hash;
+}
+
+static inline uint32_t MixNameHash(uint32_t hash) {
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    return hash ^ (hash >> 16);
+}
+
+template <typename T>
+struct NameTableEntry {
+    const char* name;  // Null for unused slots
+    uint32_t length;
+    uint32_t hash;
+    T value;
+};
+
+template <typename T, size_t SIZE>
+struct NameTable {
+    static_assert((SIZE & (SIZE - 1)) == 0, "NameTable size must be a power of two");
+    NameTableEntry<T> entries[SIZE];
+    uint16_t seeds[SIZE];
+    const T* Find(const char* name) const {
+        if (!name) return nullptr;
+        uint32_t length;
+        const uint32_t hash = HashName(name, &length);
+        const NameTableEntry<T>& entry = entries[MixNameHash(hash ^ seeds[hash & (SIZE - 1)]) & (SIZE - 1)];
+        if (entry.hash != hash || entry.length != length || !entry.name || memcmp(entry.name, name, length) != 0) return nullptr;
+        return &entry.value;
+    }
+};
+
+// Members of Vulkan structures that device profiles can set. The tables of them are generated from the registry.
+enum ProfileFieldType { PROFILE_FIELD_UINT32, PROFILE_FIELD_INT32, PROFILE_FIELD_UINT64, PROFILE_FIELD_SIZE, PROFILE_FIELD_FLOAT };
+struct ProfileField {
+    const char* name;
+    size_t offset;
+    ProfileFieldType type;
+    uint32_t count;  // Number of elements of array members
+};
+
+// Texel block layout of a format. The table of them is generated from the format names in the registry.
+static const uint32_t MAX_FORMAT_PLANES = 3;
+struct FormatPlane {
+    uint32_t block_size;
+    uint32_t width_divisor;  // Chroma planes of subsampled formats are smaller than the image
+    uint32_t height_divisor;
+};
+// Components of the formats whose texels clears, blits and resolves convert, at bit offsets within the block.
+// Packed formats count bits from the least significant one of their little-endian words.
+static const uint32_t MAX_FORMAT_COMPONENTS = 4;
+enum FormatChannel { FORMAT_CHANNEL_R, FORMAT_CHANNEL_G, FORMAT_CHANNEL_B, FORMAT_CHANNEL_A, FORMAT_CHANNEL_DEPTH, FORMAT_CHANNEL_STENCIL };
+enum FormatNumeric {
+    FORMAT_NUMERIC_UNORM,
+    FORMAT_NUMERIC_SNORM,
+    FORMAT_NUMERIC_USCALED,
+    FORMAT_NUMERIC_SSCALED,
+    FORMAT_NUMERIC_UINT,
+    FORMAT_NUMERIC_SINT,
+    FORMAT_NUMERIC_UFLOAT,
+    FORMAT_NUMERIC_SFLOAT,
+    FORMAT_NUMERIC_SRGB
+};
+struct FormatComponent {
+    FormatChannel channel;
+    FormatNumeric numeric;
+    uint32_t offset;
+    uint32_t bits;
 };
+struct FormatInfo {
+    VkFormat format;
+    uint32_t block_size;  // Summed over the planes of multi-planar formats
+    VkExtent3D block_extent;
+    uint32_t plane_count;
+    FormatPlane planes[MAX_FORMAT_PLANES];
+    uint32_t component_count;  // 0 for compressed, subsampled and multi-planar formats, and others not converted
+    FormatComponent components[MAX_FORMAT_COMPONENTS];
+};
+
+// Map of instance extension name to version
+static const NameTable<uint32_t, 32> instance_extension_map = {{
+    {"VK_EXT_acquire_xlib_display", 27, 0xde3e9090u, 1},
+    {"VK_GGP_stream_descriptor_surface", 32, 0xf031ed40u, 1},
+    {"VK_EXT_headless_surface", 23, 0x509690e8u, 1},
+    {"VK_KHR_external_fence_capabilities", 34, 0x32df8c91u, 1},
+    {"VK_MVK_macos_surface", 20, 0x2c97c737u, 2},
+    {"VK_FUCHSIA_imagepipe_surface", 28, 0x8dac6cf6u, 1},
+    {"VK_KHR_get_display_properties2", 30, 0x6a3e326eu, 1},
+    {"VK_KHR_get_surface_capabilities2", 32, 0x2d2c56e6u, 1},
+    {"VK_KHR_xlib_surface", 19, 0xd61ebb2cu, 6},
+    {"VK_KHR_android_surface", 22, 0x06505dcau, 6},
+    {"VK_EXT_display_surface_counter", 30, 0x7571bf0cu, 1},
+    {"VK_KHR_wayland_surface", 22, 0x8317b66fu, 6},
+    {"VK_EXT_debug_report", 19, 0xa1d4d1d9u, 9},
+    {"VK_MVK_ios_surface", 18, 0x94b1c7e3u, 2},
+    {"VK_KHR_external_semaphore_capabilities", 38, 0x34671d20u, 1},
+    {"VK_KHR_get_physical_device_properties2", 38, 0x6556ff70u, 2},
+    {"VK_KHR_surface_protected_capabilities", 37, 0x28af697au, 1},
+    {"VK_KHR_device_group_creation", 28, 0x342ad6cfu, 1},
+    {"VK_EXT_validation_flags", 23, 0xe22150f0u, 2},
+    {"VK_KHR_xcb_surface", 18, 0xef399ed0u, 6},
+    {"VK_EXT_direct_mode_display", 26, 0x15d26525u, 1},
+    {"VK_EXT_swapchain_colorspace", 27, 0xcb5667f1u, 4},
+    {"VK_KHR_surface", 14, 0x311266aeu, 25},
+    {"VK_NV_external_memory_capabilities", 34, 0x68bbfbb6u, 1},
+    {"VK_EXT_validation_features", 26, 0xc3f75756u, 2},
+    {"VK_NN_vi_surface", 16, 0xb0ce3d75u, 1},
+    {"VK_KHR_display", 14, 0x72aab013u, 23},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_external_memory_capabilities", 35, 0x43f3a689u, 1},
+    {"VK_EXT_metal_surface", 20, 0x05524f8eu, 1},
+    {"VK_KHR_win32_surface", 20, 0x1988d866u, 6},
+    {"VK_EXT_debug_utils", 18, 0x25456810u, 1},
+}, {
+    0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 4, 0, 0, 0, 0, 1,
+    0, 0, 0, 0, 0, 2, 1, 19, 0, 11, 0, 0, 0, 0, 0, 0,
+}};
 // Map of device extension name to version
-static const std::unordered_map<std::string, uint32_t> device_extension_map = {
-    {"VK_KHR_swapchain", 70},
-    {"VK_KHR_display_swapchain", 10},
-    {"VK_NV_glsl_shader", 1},
-    {"VK_EXT_depth_range_unrestricted", 1},
-    {"VK_KHR_sampler_mirror_clamp_to_edge", 3},
-    {"VK_IMG_filter_cubic", 1},
-    {"VK_AMD_rasterization_order", 1},
-    {"VK_AMD_shader_trinary_minmax", 1},
-    {"VK_AMD_shader_explicit_vertex_parameter", 1},
-    {"VK_EXT_debug_marker", 4},
-    {"VK_AMD_gcn_shader", 1},
-    {"VK_NV_dedicated_allocation", 1},
-    {"VK_EXT_transform_feedback", 1},
-    {"VK_NVX_image_view_handle", 1},
-    {"VK_AMD_draw_indirect_count", 2},
-    {"VK_AMD_negative_viewport_height", 1},
-    {"VK_AMD_gpu_shader_half_float", 2},
-    {"VK_AMD_shader_ballot", 1},
-    {"VK_AMD_texture_gather_bias_lod", 1},
-    {"VK_AMD_shader_info", 1},
-    {"VK_AMD_shader_image_load_store_lod", 1},
-    {"VK_NV_corner_sampled_image", 2},
-    {"VK_KHR_multiview", 1},
-    {"VK_IMG_format_pvrtc", 1},
-    {"VK_NV_external_memory", 1},
-    {"VK_NV_external_memory_win32", 1},
-    {"VK_NV_win32_keyed_mutex", 2},
-    {"VK_KHR_device_group", 4},
-    {"VK_KHR_shader_draw_parameters", 1},
-    {"VK_EXT_shader_subgroup_ballot", 1},
-    {"VK_EXT_shader_subgroup_vote", 1},
-    {"VK_EXT_texture_compression_astc_hdr", 1},
-    {"VK_EXT_astc_decode_mode", 1},
-    {"VK_KHR_maintenance1", 2},
-    {"VK_KHR_external_memory", 1},
-    {"VK_KHR_external_memory_win32", 1},
-    {"VK_KHR_external_memory_fd", 1},
-    {"VK_KHR_win32_keyed_mutex", 1},
-    {"VK_KHR_external_semaphore", 1},
-    {"VK_KHR_external_semaphore_win32", 1},
-    {"VK_KHR_external_semaphore_fd", 1},
-    {"VK_KHR_push_descriptor", 2},
-    {"VK_EXT_conditional_rendering", 2},
-    {"VK_KHR_shader_float16_int8", 1},
-    {"VK_KHR_16bit_storage", 1},
-    {"VK_KHR_incremental_present", 1},
-    {"VK_KHR_descriptor_update_template", 1},
-    {"VK_NVX_device_generated_commands", 3},
-    {"VK_NV_clip_space_w_scaling", 1},
-    {"VK_EXT_display_control", 1},
-    {"VK_GOOGLE_display_timing", 1},
-    {"VK_NV_sample_mask_override_coverage", 1},
-    {"VK_NV_geometry_shader_passthrough", 1},
-    {"VK_NV_viewport_array2", 1},
-    {"VK_NVX_multiview_per_view_attributes", 1},
-    {"VK_NV_viewport_swizzle", 1},
-    {"VK_EXT_discard_rectangles", 1},
-    {"VK_EXT_conservative_rasterization", 1},
-    {"VK_EXT_depth_clip_enable", 1},
-    {"VK_EXT_hdr_metadata", 2},
-    {"VK_KHR_imageless_framebuffer", 1},
-    {"VK_KHR_create_renderpass2", 1},
-    {"VK_KHR_shared_presentable_image", 1},
-    {"VK_KHR_external_fence", 1},
-    {"VK_KHR_external_fence_win32", 1},
-    {"VK_KHR_external_fence_fd", 1},
-    {"VK_KHR_performance_query", 1},
-    {"VK_KHR_maintenance2", 1},
-    {"VK_KHR_variable_pointers", 1},
-    {"VK_EXT_external_memory_dma_buf", 1},
-    {"VK_EXT_queue_family_foreign", 1},
-    {"VK_KHR_dedicated_allocation", 3},
-    {"VK_ANDROID_external_memory_android_hardware_buffer", 3},
-    {"VK_EXT_sampler_filter_minmax", 2},
-    {"VK_KHR_storage_buffer_storage_class", 1},
-    {"VK_AMD_gpu_shader_int16", 2},
-    {"VK_AMD_mixed_attachment_samples", 1},
-    {"VK_AMD_shader_fragment_mask", 1},
-    {"VK_EXT_inline_uniform_block", 1},
-    {"VK_EXT_shader_stencil_export", 1},
-    {"VK_EXT_sample_locations", 1},
-    {"VK_KHR_relaxed_block_layout", 1},
-    {"VK_KHR_get_memory_requirements2", 1},
-    {"VK_KHR_image_format_list", 1},
-    {"VK_EXT_blend_operation_advanced", 2},
-    {"VK_NV_fragment_coverage_to_color", 1},
-    {"VK_NV_framebuffer_mixed_samples", 1},
-    {"VK_NV_fill_rectangle", 1},
-    {"VK_NV_shader_sm_builtins", 1},
-    {"VK_EXT_post_depth_coverage", 1},
-    {"VK_KHR_sampler_ycbcr_conversion", 14},
-    {"VK_KHR_bind_memory2", 1},
-    {"VK_EXT_image_drm_format_modifier", 1},
-    {"VK_EXT_descriptor_indexing", 2},
-    {"VK_EXT_shader_viewport_index_layer", 1},
-    {"VK_NV_shading_rate_image", 3},
-    {"VK_NV_ray_tracing", 3},
-    {"VK_NV_representative_fragment_test", 2},
-    {"VK_KHR_maintenance3", 1},
-    {"VK_KHR_draw_indirect_count", 1},
-    {"VK_EXT_filter_cubic", 3},
-    {"VK_EXT_global_priority", 2},
-    {"VK_KHR_shader_subgroup_extended_types", 1},
-    {"VK_KHR_8bit_storage", 1},
-    {"VK_EXT_external_memory_host", 1},
-    {"VK_AMD_buffer_marker", 1},
-    {"VK_KHR_shader_atomic_int64", 1},
-    {"VK_KHR_shader_clock", 1},
-    {"VK_AMD_pipeline_compiler_control", 1},
-    {"VK_EXT_calibrated_timestamps", 1},
-    {"VK_AMD_shader_core_properties", 2},
-    {"VK_AMD_memory_overallocation_behavior", 1},
-    {"VK_EXT_vertex_attribute_divisor", 3},
-    {"VK_GGP_frame_token", 1},
-    {"VK_EXT_pipeline_creation_feedback", 1},
-    {"VK_KHR_driver_properties", 1},
-    {"VK_KHR_shader_float_controls", 4},
-    {"VK_NV_shader_subgroup_partitioned", 1},
-    {"VK_KHR_depth_stencil_resolve", 1},
-    {"VK_KHR_swapchain_mutable_format", 1},
-    {"VK_NV_compute_shader_derivatives", 1},
-    {"VK_NV_mesh_shader", 1},
-    {"VK_NV_fragment_shader_barycentric", 1},
-    {"VK_NV_shader_image_footprint", 2},
-    {"VK_NV_scissor_exclusive", 1},
-    {"VK_NV_device_diagnostic_checkpoints", 2},
-    {"VK_KHR_timeline_semaphore", 2},
-    {"VK_INTEL_shader_integer_functions2", 1},
-    {"VK_INTEL_performance_query", 1},
-    {"VK_KHR_vulkan_memory_model", 3},
-    {"VK_EXT_pci_bus_info", 2},
-    {"VK_AMD_display_native_hdr", 1},
-    {"VK_EXT_fragment_density_map", 1},
-    {"VK_EXT_scalar_block_layout", 1},
-    {"VK_GOOGLE_hlsl_functionality1", 1},
-    {"VK_GOOGLE_decorate_string", 1},
-    {"VK_EXT_subgroup_size_control", 2},
-    {"VK_AMD_shader_core_properties2", 1},
-    {"VK_AMD_device_coherent_memory", 1},
-    {"VK_KHR_spirv_1_4", 1},
-    {"VK_EXT_memory_budget", 1},
-    {"VK_EXT_memory_priority", 1},
-    {"VK_NV_dedicated_allocation_image_aliasing", 1},
-    {"VK_KHR_separate_depth_stencil_layouts", 1},
-    {"VK_EXT_buffer_device_address", 2},
-    {"VK_EXT_tooling_info", 1},
-    {"VK_EXT_separate_stencil_usage", 1},
-    {"VK_NV_cooperative_matrix", 1},
-    {"VK_NV_coverage_reduction_mode", 1},
-    {"VK_EXT_fragment_shader_interlock", 1},
-    {"VK_EXT_ycbcr_image_arrays", 1},
-    {"VK_KHR_uniform_buffer_standard_layout", 1},
-    {"VK_EXT_full_screen_exclusive", 4},
-    {"VK_KHR_buffer_device_address", 1},
-    {"VK_EXT_line_rasterization", 1},
-    {"VK_EXT_host_query_reset", 1},
-    {"VK_EXT_index_type_uint8", 1},
-    {"VK_KHR_pipeline_executable_properties", 1},
-    {"VK_EXT_shader_demote_to_helper_invocation", 1},
-    {"VK_EXT_texel_buffer_alignment", 1},
-    {"VK_GOOGLE_user_type", 1},
+static const NameTable<uint32_t, 256> device_extension_map = {{
+    {"VK_KHR_dedicated_allocation", 27, 0xa6e18667u, 3},
+    {"VK_EXT_sample_locations", 23, 0x5f258e0eu, 1},
+    {"VK_GOOGLE_hlsl_functionality1", 29, 0xc07a7f51u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_GOOGLE_user_type", 19, 0xd8404633u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_shader_stencil_export", 28, 0xa86ce840u, 1},
+    {"VK_KHR_performance_query", 24, 0xf87e1614u, 1},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_shader_subgroup_vote", 27, 0xa9ece493u, 1},
+    {"VK_AMD_draw_indirect_count", 26, 0x82b81125u, 2},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_external_fence_win32", 27, 0x2df40b06u, 1},
+    {"VK_EXT_index_type_uint8", 23, 0x6816d495u, 1},
+    {"VK_AMD_mixed_attachment_samples", 31, 0xc38708d5u, 1},
+    {"VK_EXT_pci_bus_info", 19, 0xf42d46a5u, 2},
+    {"VK_NV_external_memory_win32", 27, 0x79918bdfu, 1},
+    {"VK_EXT_memory_priority", 22, 0x116a4e45u, 1},
+    {"VK_KHR_external_semaphore_fd", 28, 0x877344d4u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_depth_clip_enable", 24, 0xdf1cdd4fu, 1},
+    {"VK_AMD_shader_ballot", 20, 0x4a630670u, 1},
+    {"VK_INTEL_shader_integer_functions2", 34, 0x96ef4ef2u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_imageless_framebuffer", 28, 0xa11741d1u, 1},
+    {"VK_GGP_frame_token", 18, 0x68b4b657u, 1},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_calibrated_timestamps", 28, 0x0aa00a0cu, 1},
+    {"VK_KHR_maintenance1", 19, 0xa91f6641u, 2},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_uniform_buffer_standard_layout", 37, 0xf0a2ca27u, 1},
+    {"VK_EXT_external_memory_host", 27, 0x927f6a6du, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_AMD_shader_fragment_mask", 27, 0x78e21653u, 1},
+    {"VK_EXT_image_drm_format_modifier", 32, 0x7584a998u, 1},
+    {"VK_KHR_sampler_ycbcr_conversion", 31, 0x54f335feu, 14},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_full_screen_exclusive", 28, 0xc9813d60u, 4},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_queue_family_foreign", 27, 0x483922e0u, 1},
+    {"VK_NV_framebuffer_mixed_samples", 31, 0x54928c7bu, 1},
+    {"VK_EXT_sampler_filter_minmax", 28, 0x5b69767bu, 2},
+    {"VK_EXT_global_priority", 22, 0x5a0931a1u, 2},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_device_group", 19, 0x0815cc75u, 4},
+    {nullptr, 0, 0, 0},
+    {"VK_NV_geometry_shader_passthrough", 33, 0xadd23a6du, 1},
+    {"VK_AMD_texture_gather_bias_lod", 30, 0xdf87b321u, 1},
+    {"VK_EXT_texture_compression_astc_hdr", 35, 0x549ca688u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_NV_sample_mask_override_coverage", 35, 0xe4ffd843u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_shader_draw_parameters", 29, 0xdcb249eau, 1},
+    {"VK_EXT_conservative_rasterization", 33, 0xca87d742u, 1},
+    {"VK_KHR_external_fence_fd", 24, 0xd49ecdf1u, 1},
+    {"VK_KHR_win32_keyed_mutex", 24, 0x4b7d344fu, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_INTEL_performance_query", 26, 0x699ab36bu, 1},
+    {"VK_EXT_conditional_rendering", 28, 0x53144bb2u, 2},
+    {"VK_EXT_hdr_metadata", 19, 0xdefe6055u, 2},
+    {"VK_KHR_shader_atomic_int64", 26, 0xe8c32fc6u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_pipeline_executable_properties", 37, 0xb77d1702u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_NV_dedicated_allocation_image_aliasing", 41, 0xf7c370abu, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_debug_marker", 19, 0x09c99985u, 4},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_line_rasterization", 25, 0x60688ee9u, 1},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_spirv_1_4", 16, 0x091bcd58u, 1},
+    {"VK_KHR_shader_float16_int8", 26, 0xb7bf3736u, 1},
+    {"VK_EXT_scalar_block_layout", 26, 0x7d7ef96cu, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_subgroup_size_control", 28, 0xcb9aac50u, 2},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_AMD_pipeline_compiler_control", 32, 0xba62dd64u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_separate_depth_stencil_layouts", 37, 0xc6808d27u, 1},
+    {"VK_KHR_display_swapchain", 24, 0xe6bf0704u, 10},
+    {"VK_AMD_buffer_marker", 20, 0x23734045u, 1},
+    {"VK_AMD_shader_info", 18, 0x088af40au, 1},
+    {"VK_NV_representative_fragment_test", 34, 0xd37e0e9fu, 2},
+    {nullptr, 0, 0, 0},
+    {"VK_AMD_gcn_shader", 17, 0x8d0c5dfcu, 1},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_AMD_memory_overallocation_behavior", 37, 0xa49792cbu, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_ycbcr_image_arrays", 25, 0xdfd3dbcbu, 1},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_AMD_gpu_shader_int16", 23, 0x5180a2bbu, 2},
+    {"VK_NV_shader_sm_builtins", 24, 0xfada3833u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_create_renderpass2", 25, 0x2a202a5du, 1},
+    {"VK_KHR_timeline_semaphore", 25, 0x20a7a39du, 2},
+    {"VK_EXT_display_control", 22, 0x21575571u, 1},
+    {"VK_KHR_swapchain", 16, 0x2fab4bbdu, 70},
+    {"VK_AMD_device_coherent_memory", 29, 0x58004d99u, 1},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_NV_fragment_coverage_to_color", 32, 0x271b414du, 1},
+    {"VK_KHR_incremental_present", 26, 0x6348ff39u, 1},
+    {"VK_IMG_filter_cubic", 19, 0x1e4accf0u, 1},
+    {"VK_NV_fragment_shader_barycentric", 33, 0x22369273u, 1},
+    {"VK_NVX_multiview_per_view_attributes", 36, 0x3de57f02u, 1},
+    {"VK_KHR_storage_buffer_storage_class", 35, 0xf9c44506u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_NV_ray_tracing", 17, 0xe11701c9u, 3},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_shader_subgroup_extended_types", 37, 0xfb08ca5cu, 1},
+    {"VK_KHR_external_fence", 21, 0x3a3f597eu, 1},
+    {"VK_EXT_memory_budget", 20, 0xd05f701cu, 1},
+    {"VK_KHR_16bit_storage", 20, 0x58e58ef5u, 1},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_NVX_image_view_handle", 24, 0xc224ceacu, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_NV_viewport_array2", 21, 0x5bce8e76u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_vulkan_memory_model", 26, 0xadf1143cu, 3},
+    {"VK_GOOGLE_display_timing", 24, 0x98d7e19cu, 1},
+    {"VK_NV_shader_subgroup_partitioned", 33, 0xc27b859fu, 1},
+    {"VK_KHR_relaxed_block_layout", 27, 0x790863e7u, 1},
+    {"VK_AMD_shader_image_load_store_lod", 34, 0x2a911212u, 1},
+    {"VK_NV_coverage_reduction_mode", 29, 0x588ebd36u, 1},
+    {"VK_EXT_buffer_device_address", 28, 0x268cfeb7u, 2},
+    {"VK_NV_scissor_exclusive", 23, 0x45119ad1u, 1},
+    {"VK_EXT_shader_viewport_index_layer", 34, 0xb4d5bfe4u, 1},
+    {"VK_KHR_driver_properties", 24, 0x3241c517u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_shader_demote_to_helper_invocation", 41, 0x4db98305u, 1},
+    {"VK_EXT_descriptor_indexing", 26, 0x3159762bu, 2},
+    {"VK_EXT_fragment_density_map", 27, 0xdc78563du, 1},
+    {"VK_KHR_external_semaphore", 25, 0x025b44a5u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_separate_stencil_usage", 29, 0x0026c765u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_external_memory_win32", 28, 0xaf36d6ceu, 1},
+    {"VK_AMD_display_native_hdr", 25, 0xe135bfd1u, 1},
+    {"VK_NV_device_diagnostic_checkpoints", 35, 0xe1acaba4u, 2},
+    {"VK_KHR_external_semaphore_win32", 31, 0xe3f18249u, 1},
+    {"VK_NV_shading_rate_image", 24, 0xd0774eafu, 3},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_NV_clip_space_w_scaling", 26, 0xffb93f2bu, 1},
+    {"VK_EXT_fragment_shader_interlock", 32, 0x6cb49913u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_AMD_shader_core_properties", 29, 0x2d4adbfbu, 2},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_inline_uniform_block", 27, 0x6ca2871fu, 1},
+    {"VK_EXT_blend_operation_advanced", 31, 0x22bfc717u, 2},
+    {"VK_NV_mesh_shader", 17, 0xdad15e43u, 1},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_external_memory", 22, 0x518a9c36u, 1},
+    {"VK_AMD_negative_viewport_height", 31, 0xcb66a5d0u, 1},
+    {"VK_AMD_rasterization_order", 26, 0x0915e6dcu, 1},
+    {"VK_KHR_shared_presentable_image", 31, 0xcb0188e4u, 1},
+    {"VK_IMG_format_pvrtc", 19, 0x8d304442u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_bind_memory2", 19, 0x8b4eeb50u, 1},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_depth_range_unrestricted", 31, 0xda40e195u, 1},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_variable_pointers", 24, 0x6ffb0526u, 1},
+    {"VK_AMD_shader_trinary_minmax", 28, 0xe2a19d36u, 1},
+    {"VK_NV_compute_shader_derivatives", 32, 0x27bb48e6u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_shader_clock", 19, 0xe4e1a547u, 1},
+    {"VK_KHR_push_descriptor", 22, 0x2368ff59u, 2},
+    {"VK_NV_viewport_swizzle", 22, 0x97ad2a4bu, 1},
+    {"VK_EXT_astc_decode_mode", 23, 0xe4444d25u, 1},
+    {"VK_KHR_maintenance2", 19, 0xa61f6188u, 1},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_discard_rectangles", 25, 0x7da0779au, 1},
+    {"VK_KHR_sampler_mirror_clamp_to_edge", 35, 0xd98eb7f1u, 3},
+    {"VK_NV_cooperative_matrix", 24, 0xf805d1b5u, 1},
+    {"VK_KHR_multiview", 16, 0x4cca54ddu, 1},
+    {"VK_NV_shader_image_footprint", 28, 0x776724d7u, 2},
+    {nullptr, 0, 0, 0},
+    {"VK_NVX_device_generated_commands", 32, 0x7ca3d469u, 3},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_get_memory_requirements2", 31, 0x3c8f0038u, 1},
+    {"VK_EXT_host_query_reset", 23, 0x2cadaaa6u, 1},
+    {"VK_KHR_draw_indirect_count", 26, 0x51dddd70u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_AMD_shader_explicit_vertex_parameter", 39, 0xc54dd9c5u, 1},
+    {"VK_KHR_8bit_storage", 19, 0xd4026772u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_NV_win32_keyed_mutex", 23, 0xdaf88312u, 2},
+    {"VK_EXT_filter_cubic", 19, 0x6a470e24u, 3},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_texel_buffer_alignment", 29, 0x07d98f12u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_ANDROID_external_memory_android_hardware_buffer", 50, 0xbe74f77eu, 3},
+    {"VK_EXT_pipeline_creation_feedback", 33, 0x12d3cf47u, 1},
+    {"VK_KHR_image_format_list", 24, 0x32b2745fu, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_vertex_attribute_divisor", 31, 0x00c4fe6bu, 3},
+    {"VK_KHR_depth_stencil_resolve", 28, 0x4a47ecfcu, 1},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_NV_glsl_shader", 17, 0x047c1250u, 1},
+    {"VK_KHR_swapchain_mutable_format", 31, 0xe2f7cc3au, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_external_memory_dma_buf", 30, 0x46174831u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_NV_corner_sampled_image", 26, 0x4278892eu, 2},
+    {"VK_NV_dedicated_allocation", 26, 0xb8fbf524u, 1},
+    {"VK_KHR_maintenance3", 19, 0xa71f631bu, 1},
+    {"VK_KHR_external_memory_fd", 25, 0x2b04acc9u, 1},
+    {"VK_NV_fill_rectangle", 20, 0x33be33b7u, 1},
+    {"VK_EXT_post_depth_coverage", 26, 0x4745d01au, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_tooling_info", 19, 0x0618eaf0u, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_shader_float_controls", 28, 0x5736dfeau, 4},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_EXT_transform_feedback", 25, 0x1a1a72fdu, 1},
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0},
+    {"VK_AMD_gpu_shader_half_float", 28, 0x71660537u, 2},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_buffer_device_address", 28, 0x22d0c0afu, 1},
+    {"VK_EXT_shader_subgroup_ballot", 29, 0xeca878a5u, 1},
+    {"VK_GOOGLE_decorate_string", 25, 0xa23a6912u, 1},
+    {"VK_AMD_shader_core_properties2", 30, 0x15d7fd6bu, 1},
+    {nullptr, 0, 0, 0},
+    {"VK_KHR_descriptor_update_template", 33, 0x34937c19u, 1},
+    {"VK_NV_external_memory", 21, 0x89481e6fu, 1},
+    {nullptr, 0, 0, 0},
+}, {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0,
+    0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0,
+    0, 1, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 3, 0, 2, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0,
+    0, 1, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1,
+    0, 0, 1, 0, 0, 0, 5, 0, 0, 0, 0, 2, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 3, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 4, 0, 0, 0,
+    0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 2, 0, 1, 0, 0,
+    0, 0, 0, 0, 0, 3, 0, 0, 0, 1, 0, 2, 0, 0, 0, 0,
+    0, 0, 0, 0, 1, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 3, 2, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 4, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 2, 1, 0,
+}};
+// Fields of the structures that device profiles set
+static const ProfileField physical_device_limits_fields[] = {
+    {"maxImageDimension1D", offsetof(VkPhysicalDeviceLimits, maxImageDimension1D), PROFILE_FIELD_UINT32, 1},
+    {"maxImageDimension2D", offsetof(VkPhysicalDeviceLimits, maxImageDimension2D), PROFILE_FIELD_UINT32, 1},
+    {"maxImageDimension3D", offsetof(VkPhysicalDeviceLimits, maxImageDimension3D), PROFILE_FIELD_UINT32, 1},
+    {"maxImageDimensionCube", offsetof(VkPhysicalDeviceLimits, maxImageDimensionCube), PROFILE_FIELD_UINT32, 1},
+    {"maxImageArrayLayers", offsetof(VkPhysicalDeviceLimits, maxImageArrayLayers), PROFILE_FIELD_UINT32, 1},
+    {"maxTexelBufferElements", offsetof(VkPhysicalDeviceLimits, maxTexelBufferElements), PROFILE_FIELD_UINT32, 1},
+    {"maxUniformBufferRange", offsetof(VkPhysicalDeviceLimits, maxUniformBufferRange), PROFILE_FIELD_UINT32, 1},
+    {"maxStorageBufferRange", offsetof(VkPhysicalDeviceLimits, maxStorageBufferRange), PROFILE_FIELD_UINT32, 1},
+    {"maxPushConstantsSize", offsetof(VkPhysicalDeviceLimits, maxPushConstantsSize), PROFILE_FIELD_UINT32, 1},
+    {"maxMemoryAllocationCount", offsetof(VkPhysicalDeviceLimits, maxMemoryAllocationCount), PROFILE_FIELD_UINT32, 1},
+    {"maxSamplerAllocationCount", offsetof(VkPhysicalDeviceLimits, maxSamplerAllocationCount), PROFILE_FIELD_UINT32, 1},
+    {"bufferImageGranularity", offsetof(VkPhysicalDeviceLimits, bufferImageGranularity), PROFILE_FIELD_UINT64, 1},
+    {"sparseAddressSpaceSize", offsetof(VkPhysicalDeviceLimits, sparseAddressSpaceSize), PROFILE_FIELD_UINT64, 1},
+    {"maxBoundDescriptorSets", offsetof(VkPhysicalDeviceLimits, maxBoundDescriptorSets), PROFILE_FIELD_UINT32, 1},
+    {"maxPerStageDescriptorSamplers", offsetof(VkPhysicalDeviceLimits, maxPerStageDescriptorSamplers), PROFILE_FIELD_UINT32, 1},
+    {"maxPerStageDescriptorUniformBuffers", offsetof(VkPhysicalDeviceLimits, maxPerStageDescriptorUniformBuffers), PROFILE_FIELD_UINT32, 1},
+    {"maxPerStageDescriptorStorageBuffers", offsetof(VkPhysicalDeviceLimits, maxPerStageDescriptorStorageBuffers), PROFILE_FIELD_UINT32, 1},
+    {"maxPerStageDescriptorSampledImages", offsetof(VkPhysicalDeviceLimits, maxPerStageDescriptorSampledImages), PROFILE_FIELD_UINT32, 1},
+    {"maxPerStageDescriptorStorageImages", offsetof(VkPhysicalDeviceLimits, maxPerStageDescriptorStorageImages), PROFILE_FIELD_UINT32, 1},
+    {"maxPerStageDescriptorInputAttachments", offsetof(VkPhysicalDeviceLimits, maxPerStageDescriptorInputAttachments), PROFILE_FIELD_UINT32, 1},
+    {"maxPerStageResources", offsetof(VkPhysicalDeviceLimits, maxPerStageResources), PROFILE_FIELD_UINT32, 1},
+    {"maxDescriptorSetSamplers", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetSamplers), PROFILE_FIELD_UINT32, 1},
+    {"maxDescriptorSetUniformBuffers", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetUniformBuffers), PROFILE_FIELD_UINT32, 1},
+    {"maxDescriptorSetUniformBuffersDynamic", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetUniformBuffersDynamic), PROFILE_FIELD_UINT32, 1},
+    {"maxDescriptorSetStorageBuffers", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetStorageBuffers), PROFILE_FIELD_UINT32, 1},
+    {"maxDescriptorSetStorageBuffersDynamic", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetStorageBuffersDynamic), PROFILE_FIELD_UINT32, 1},
+    {"maxDescriptorSetSampledImages", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetSampledImages), PROFILE_FIELD_UINT32, 1},
+    {"maxDescriptorSetStorageImages", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetStorageImages), PROFILE_FIELD_UINT32, 1},
+    {"maxDescriptorSetInputAttachments", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetInputAttachments), PROFILE_FIELD_UINT32, 1},
+    {"maxVertexInputAttributes", offsetof(VkPhysicalDeviceLimits, maxVertexInputAttributes), PROFILE_FIELD_UINT32, 1},
+    {"maxVertexInputBindings", offsetof(VkPhysicalDeviceLimits, maxVertexInputBindings), PROFILE_FIELD_UINT32, 1},
+    {"maxVertexInputAttributeOffset", offsetof(VkPhysicalDeviceLimits, maxVertexInputAttributeOffset), PROFILE_FIELD_UINT32, 1},
+    {"maxVertexInputBindingStride", offsetof(VkPhysicalDeviceLimits, maxVertexInputBindingStride), PROFILE_FIELD_UINT32, 1},
+    {"maxVertexOutputComponents", offsetof(VkPhysicalDeviceLimits, maxVertexOutputComponents), PROFILE_FIELD_UINT32, 1},
+    {"maxTessellationGenerationLevel", offsetof(VkPhysicalDeviceLimits, maxTessellationGenerationLevel), PROFILE_FIELD_UINT32, 1},
+    {"maxTessellationPatchSize", offsetof(VkPhysicalDeviceLimits, maxTessellationPatchSize), PROFILE_FIELD_UINT32, 1},
+    {"maxTessellationControlPerVertexInputComponents", offsetof(VkPhysicalDeviceLimits, maxTessellationControlPerVertexInputComponents), PROFILE_FIELD_UINT32, 1},
+    {"maxTessellationControlPerVertexOutputComponents", offsetof(VkPhysicalDeviceLimits, maxTessellationControlPerVertexOutputComponents), PROFILE_FIELD_UINT32, 1},
+    {"maxTessellationControlPerPatchOutputComponents", offsetof(VkPhysicalDeviceLimits, maxTessellationControlPerPatchOutputComponents), PROFILE_FIELD_UINT32, 1},
+    {"maxTessellationControlTotalOutputComponents", offsetof(VkPhysicalDeviceLimits, maxTessellationControlTotalOutputComponents), PROFILE_FIELD_UINT32, 1},
+    {"maxTessellationEvaluationInputComponents", offsetof(VkPhysicalDeviceLimits, maxTessellationEvaluationInputComponents), PROFILE_FIELD_UINT32, 1},
+    {"maxTessellationEvaluationOutputComponents", offsetof(VkPhysicalDeviceLimits, maxTessellationEvaluationOutputComponents), PROFILE_FIELD_UINT32, 1},
+    {"maxGeometryShaderInvocations", offsetof(VkPhysicalDeviceLimits, maxGeometryShaderInvocations), PROFILE_FIELD_UINT32, 1},
+    {"maxGeometryInputComponents", offsetof(VkPhysicalDeviceLimits, maxGeometryInputComponents), PROFILE_FIELD_UINT32, 1},
+    {"maxGeometryOutputComponents", offsetof(VkPhysicalDeviceLimits, maxGeometryOutputComponents), PROFILE_FIELD_UINT32, 1},
+    {"maxGeometryOutputVertices", offsetof(VkPhysicalDeviceLimits, maxGeometryOutputVertices), PROFILE_FIELD_UINT32, 1},
+    {"maxGeometryTotalOutputComponents", offsetof(VkPhysicalDeviceLimits, maxGeometryTotalOutputComponents), PROFILE_FIELD_UINT32, 1},
+    {"maxFragmentInputComponents", offsetof(VkPhysicalDeviceLimits, maxFragmentInputComponents), PROFILE_FIELD_UINT32, 1},
+    {"maxFragmentOutputAttachments", offsetof(VkPhysicalDeviceLimits, maxFragmentOutputAttachments), PROFILE_FIELD_UINT32, 1},
+    {"maxFragmentDualSrcAttachments", offsetof(VkPhysicalDeviceLimits, maxFragmentDualSrcAttachments), PROFILE_FIELD_UINT32, 1},
+    {"maxFragmentCombinedOutputResources", offsetof(VkPhysicalDeviceLimits, maxFragmentCombinedOutputResources), PROFILE_FIELD_UINT32, 1},
+    {"maxComputeSharedMemorySize", offsetof(VkPhysicalDeviceLimits, maxComputeSharedMemorySize), PROFILE_FIELD_UINT32, 1},
+    {"maxComputeWorkGroupCount", offsetof(VkPhysicalDeviceLimits, maxComputeWorkGroupCount), PROFILE_FIELD_UINT32, 3},
+    {"maxComputeWorkGroupInvocations", offsetof(VkPhysicalDeviceLimits, maxComputeWorkGroupInvocations), PROFILE_FIELD_UINT32, 1},
+    {"maxComputeWorkGroupSize", offsetof(VkPhysicalDeviceLimits, maxComputeWorkGroupSize), PROFILE_FIELD_UINT32, 3},
+    {"subPixelPrecisionBits", offsetof(VkPhysicalDeviceLimits, subPixelPrecisionBits), PROFILE_FIELD_UINT32, 1},
+    {"subTexelPrecisionBits", offsetof(VkPhysicalDeviceLimits, subTexelPrecisionBits), PROFILE_FIELD_UINT32, 1},
+    {"mipmapPrecisionBits", offsetof(VkPhysicalDeviceLimits, mipmapPrecisionBits), PROFILE_FIELD_UINT32, 1},
+    {"maxDrawIndexedIndexValue", offsetof(VkPhysicalDeviceLimits, maxDrawIndexedIndexValue), PROFILE_FIELD_UINT32, 1},
+    {"maxDrawIndirectCount", offsetof(VkPhysicalDeviceLimits, maxDrawIndirectCount), PROFILE_FIELD_UINT32, 1},
+    {"maxSamplerLodBias", offsetof(VkPhysicalDeviceLimits, maxSamplerLodBias), PROFILE_FIELD_FLOAT, 1},
+    {"maxSamplerAnisotropy", offsetof(VkPhysicalDeviceLimits, maxSamplerAnisotropy), PROFILE_FIELD_FLOAT, 1},
+    {"maxViewports", offsetof(VkPhysicalDeviceLimits, maxViewports), PROFILE_FIELD_UINT32, 1},
+    {"maxViewportDimensions", offsetof(VkPhysicalDeviceLimits, maxViewportDimensions), PROFILE_FIELD_UINT32, 2},
+    {"viewportBoundsRange", offsetof(VkPhysicalDeviceLimits, viewportBoundsRange), PROFILE_FIELD_FLOAT, 2},
+    {"viewportSubPixelBits", offsetof(VkPhysicalDeviceLimits, viewportSubPixelBits), PROFILE_FIELD_UINT32, 1},
+    {"minMemoryMapAlignment", offsetof(VkPhysicalDeviceLimits, minMemoryMapAlignment), PROFILE_FIELD_SIZE, 1},
+    {"minTexelBufferOffsetAlignment", offsetof(VkPhysicalDeviceLimits, minTexelBufferOffsetAlignment), PROFILE_FIELD_UINT64, 1},
+    {"minUniformBufferOffsetAlignment", offsetof(VkPhysicalDeviceLimits, minUniformBufferOffsetAlignment), PROFILE_FIELD_UINT64, 1},
+    {"minStorageBufferOffsetAlignment", offsetof(VkPhysicalDeviceLimits, minStorageBufferOffsetAlignment), PROFILE_FIELD_UINT64, 1},
+    {"minTexelOffset", offsetof(VkPhysicalDeviceLimits, minTexelOffset), PROFILE_FIELD_INT32, 1},
+    {"maxTexelOffset", offsetof(VkPhysicalDeviceLimits, maxTexelOffset), PROFILE_FIELD_UINT32, 1},
+    {"minTexelGatherOffset", offsetof(VkPhysicalDeviceLimits, minTexelGatherOffset), PROFILE_FIELD_INT32, 1},
+    {"maxTexelGatherOffset", offsetof(VkPhysicalDeviceLimits, maxTexelGatherOffset), PROFILE_FIELD_UINT32, 1},
+    {"minInterpolationOffset", offsetof(VkPhysicalDeviceLimits, minInterpolationOffset), PROFILE_FIELD_FLOAT, 1},
+    {"maxInterpolationOffset", offsetof(VkPhysicalDeviceLimits, maxInterpolationOffset), PROFILE_FIELD_FLOAT, 1},
+    {"subPixelInterpolationOffsetBits", offsetof(VkPhysicalDeviceLimits, subPixelInterpolationOffsetBits), PROFILE_FIELD_UINT32, 1},
+    {"maxFramebufferWidth", offsetof(VkPhysicalDeviceLimits, maxFramebufferWidth), PROFILE_FIELD_UINT32, 1},
+    {"maxFramebufferHeight", offsetof(VkPhysicalDeviceLimits, maxFramebufferHeight), PROFILE_FIELD_UINT32, 1},
+    {"maxFramebufferLayers", offsetof(VkPhysicalDeviceLimits, maxFramebufferLayers), PROFILE_FIELD_UINT32, 1},
+    {"framebufferColorSampleCounts", offsetof(VkPhysicalDeviceLimits, framebufferColorSampleCounts), PROFILE_FIELD_UINT32, 1},
+    {"framebufferDepthSampleCounts", offsetof(VkPhysicalDeviceLimits, framebufferDepthSampleCounts), PROFILE_FIELD_UINT32, 1},
+    {"framebufferStencilSampleCounts", offsetof(VkPhysicalDeviceLimits, framebufferStencilSampleCounts), PROFILE_FIELD_UINT32, 1},
+    {"framebufferNoAttachmentsSampleCounts", offsetof(VkPhysicalDeviceLimits, framebufferNoAttachmentsSampleCounts), PROFILE_FIELD_UINT32, 1},
+    {"maxColorAttachments", offsetof(VkPhysicalDeviceLimits, maxColorAttachments), PROFILE_FIELD_UINT32, 1},
+    {"sampledImageColorSampleCounts", offsetof(VkPhysicalDeviceLimits, sampledImageColorSampleCounts), PROFILE_FIELD_UINT32, 1},
+    {"sampledImageIntegerSampleCounts", offsetof(VkPhysicalDeviceLimits, sampledImageIntegerSampleCounts), PROFILE_FIELD_UINT32, 1},
+    {"sampledImageDepthSampleCounts", offsetof(VkPhysicalDeviceLimits, sampledImageDepthSampleCounts), PROFILE_FIELD_UINT32, 1},
+    {"sampledImageStencilSampleCounts", offsetof(VkPhysicalDeviceLimits, sampledImageStencilSampleCounts), PROFILE_FIELD_UINT32, 1},
+    {"storageImageSampleCounts", offsetof(VkPhysicalDeviceLimits, storageImageSampleCounts), PROFILE_FIELD_UINT32, 1},
+    {"maxSampleMaskWords", offsetof(VkPhysicalDeviceLimits, maxSampleMaskWords), PROFILE_FIELD_UINT32, 1},
+    {"timestampComputeAndGraphics", offsetof(VkPhysicalDeviceLimits, timestampComputeAndGraphics), PROFILE_FIELD_UINT32, 1},
+    {"timestampPeriod", offsetof(VkPhysicalDeviceLimits, timestampPeriod), PROFILE_FIELD_FLOAT, 1},
+    {"maxClipDistances", offsetof(VkPhysicalDeviceLimits, maxClipDistances), PROFILE_FIELD_UINT32, 1},
+    {"maxCullDistances", offsetof(VkPhysicalDeviceLimits, maxCullDistances), PROFILE_FIELD_UINT32, 1},
+    {"maxCombinedClipAndCullDistances", offsetof(VkPhysicalDeviceLimits, maxCombinedClipAndCullDistances), PROFILE_FIELD_UINT32, 1},
+    {"discreteQueuePriorities", offsetof(VkPhysicalDeviceLimits, discreteQueuePriorities), PROFILE_FIELD_UINT32, 1},
+    {"pointSizeRange", offsetof(VkPhysicalDeviceLimits, pointSizeRange), PROFILE_FIELD_FLOAT, 2},
+    {"lineWidthRange", offsetof(VkPhysicalDeviceLimits, lineWidthRange), PROFILE_FIELD_FLOAT, 2},
+    {"pointSizeGranularity", offsetof(VkPhysicalDeviceLimits, pointSizeGranularity), PROFILE_FIELD_FLOAT, 1},
+    {"lineWidthGranularity", offsetof(VkPhysicalDeviceLimits, lineWidthGranularity), PROFILE_FIELD_FLOAT, 1},
+    {"strictLines", offsetof(VkPhysicalDeviceLimits, strictLines), PROFILE_FIELD_UINT32, 1},
+    {"standardSampleLocations", offsetof(VkPhysicalDeviceLimits, standardSampleLocations), PROFILE_FIELD_UINT32, 1},
+    {"optimalBufferCopyOffsetAlignment", offsetof(VkPhysicalDeviceLimits, optimalBufferCopyOffsetAlignment), PROFILE_FIELD_UINT64, 1},
+    {"optimalBufferCopyRowPitchAlignment", offsetof(VkPhysicalDeviceLimits, optimalBufferCopyRowPitchAlignment), PROFILE_FIELD_UINT64, 1},
+    {"nonCoherentAtomSize", offsetof(VkPhysicalDeviceLimits, nonCoherentAtomSize), PROFILE_FIELD_UINT64, 1},
+};
+static const ProfileField physical_device_sparse_properties_fields[] = {
+    {"residencyStandard2DBlockShape", offsetof(VkPhysicalDeviceSparseProperties, residencyStandard2DBlockShape), PROFILE_FIELD_UINT32, 1},
+    {"residencyStandard2DMultisampleBlockShape", offsetof(VkPhysicalDeviceSparseProperties, residencyStandard2DMultisampleBlockShape), PROFILE_FIELD_UINT32, 1},
+    {"residencyStandard3DBlockShape", offsetof(VkPhysicalDeviceSparseProperties, residencyStandard3DBlockShape), PROFILE_FIELD_UINT32, 1},
+    {"residencyAlignedMipSize", offsetof(VkPhysicalDeviceSparseProperties, residencyAlignedMipSize), PROFILE_FIELD_UINT32, 1},
+    {"residencyNonResidentStrict", offsetof(VkPhysicalDeviceSparseProperties, residencyNonResidentStrict), PROFILE_FIELD_UINT32, 1},
+};
+static const ProfileField physical_device_features_fields[] = {
+    {"robustBufferAccess", offsetof(VkPhysicalDeviceFeatures, robustBufferAccess), PROFILE_FIELD_UINT32, 1},
+    {"fullDrawIndexUint32", offsetof(VkPhysicalDeviceFeatures, fullDrawIndexUint32), PROFILE_FIELD_UINT32, 1},
+    {"imageCubeArray", offsetof(VkPhysicalDeviceFeatures, imageCubeArray), PROFILE_FIELD_UINT32, 1},
+    {"independentBlend", offsetof(VkPhysicalDeviceFeatures, independentBlend), PROFILE_FIELD_UINT32, 1},
+    {"geometryShader", offsetof(VkPhysicalDeviceFeatures, geometryShader), PROFILE_FIELD_UINT32, 1},
+    {"tessellationShader", offsetof(VkPhysicalDeviceFeatures, tessellationShader), PROFILE_FIELD_UINT32, 1},
+    {"sampleRateShading", offsetof(VkPhysicalDeviceFeatures, sampleRateShading), PROFILE_FIELD_UINT32, 1},
+    {"dualSrcBlend", offsetof(VkPhysicalDeviceFeatures, dualSrcBlend), PROFILE_FIELD_UINT32, 1},
+    {"logicOp", offsetof(VkPhysicalDeviceFeatures, logicOp), PROFILE_FIELD_UINT32, 1},
+    {"multiDrawIndirect", offsetof(VkPhysicalDeviceFeatures, multiDrawIndirect), PROFILE_FIELD_UINT32, 1},
+    {"drawIndirectFirstInstance", offsetof(VkPhysicalDeviceFeatures, drawIndirectFirstInstance), PROFILE_FIELD_UINT32, 1},
+    {"depthClamp", offsetof(VkPhysicalDeviceFeatures, depthClamp), PROFILE_FIELD_UINT32, 1},
+    {"depthBiasClamp", offsetof(VkPhysicalDeviceFeatures, depthBiasClamp), PROFILE_FIELD_UINT32, 1},
+    {"fillModeNonSolid", offsetof(VkPhysicalDeviceFeatures, fillModeNonSolid), PROFILE_FIELD_UINT32, 1},
+    {"depthBounds", offsetof(VkPhysicalDeviceFeatures, depthBounds), PROFILE_FIELD_UINT32, 1},
+    {"wideLines", offsetof(VkPhysicalDeviceFeatures, wideLines), PROFILE_FIELD_UINT32, 1},
+    {"largePoints", offsetof(VkPhysicalDeviceFeatures, largePoints), PROFILE_FIELD_UINT32, 1},
+    {"alphaToOne", offsetof(VkPhysicalDeviceFeatures, alphaToOne), PROFILE_FIELD_UINT32, 1},
+    {"multiViewport", offsetof(VkPhysicalDeviceFeatures, multiViewport), PROFILE_FIELD_UINT32, 1},
+    {"samplerAnisotropy", offsetof(VkPhysicalDeviceFeatures, samplerAnisotropy), PROFILE_FIELD_UINT32, 1},
+    {"textureCompressionETC2", offsetof(VkPhysicalDeviceFeatures, textureCompressionETC2), PROFILE_FIELD_UINT32, 1},
+    {"textureCompressionASTC_LDR", offsetof(VkPhysicalDeviceFeatures, textureCompressionASTC_LDR), PROFILE_FIELD_UINT32, 1},
+    {"textureCompressionBC", offsetof(VkPhysicalDeviceFeatures, textureCompressionBC), PROFILE_FIELD_UINT32, 1},
+    {"occlusionQueryPrecise", offsetof(VkPhysicalDeviceFeatures, occlusionQueryPrecise), PROFILE_FIELD_UINT32, 1},
+    {"pipelineStatisticsQuery", offsetof(VkPhysicalDeviceFeatures, pipelineStatisticsQuery), PROFILE_FIELD_UINT32, 1},
+    {"vertexPipelineStoresAndAtomics", offsetof(VkPhysicalDeviceFeatures, vertexPipelineStoresAndAtomics), PROFILE_FIELD_UINT32, 1},
+    {"fragmentStoresAndAtomics", offsetof(VkPhysicalDeviceFeatures, fragmentStoresAndAtomics), PROFILE_FIELD_UINT32, 1},
+    {"shaderTessellationAndGeometryPointSize", offsetof(VkPhysicalDeviceFeatures, shaderTessellationAndGeometryPointSize), PROFILE_FIELD_UINT32, 1},
+    {"shaderImageGatherExtended", offsetof(VkPhysicalDeviceFeatures, shaderImageGatherExtended), PROFILE_FIELD_UINT32, 1},
+    {"shaderStorageImageExtendedFormats", offsetof(VkPhysicalDeviceFeatures, shaderStorageImageExtendedFormats), PROFILE_FIELD_UINT32, 1},
+    {"shaderStorageImageMultisample", offsetof(VkPhysicalDeviceFeatures, shaderStorageImageMultisample), PROFILE_FIELD_UINT32, 1},
+    {"shaderStorageImageReadWithoutFormat", offsetof(VkPhysicalDeviceFeatures, shaderStorageImageReadWithoutFormat), PROFILE_FIELD_UINT32, 1},
+    {"shaderStorageImageWriteWithoutFormat", offsetof(VkPhysicalDeviceFeatures, shaderStorageImageWriteWithoutFormat), PROFILE_FIELD_UINT32, 1},
+    {"shaderUniformBufferArrayDynamicIndexing", offsetof(VkPhysicalDeviceFeatures, shaderUniformBufferArrayDynamicIndexing), PROFILE_FIELD_UINT32, 1},
+    {"shaderSampledImageArrayDynamicIndexing", offsetof(VkPhysicalDeviceFeatures, shaderSampledImageArrayDynamicIndexing), PROFILE_FIELD_UINT32, 1},
+    {"shaderStorageBufferArrayDynamicIndexing", offsetof(VkPhysicalDeviceFeatures, shaderStorageBufferArrayDynamicIndexing), PROFILE_FIELD_UINT32, 1},
+    {"shaderStorageImageArrayDynamicIndexing", offsetof(VkPhysicalDeviceFeatures, shaderStorageImageArrayDynamicIndexing), PROFILE_FIELD_UINT32, 1},
+    {"shaderClipDistance", offsetof(VkPhysicalDeviceFeatures, shaderClipDistance), PROFILE_FIELD_UINT32, 1},
+    {"shaderCullDistance", offsetof(VkPhysicalDeviceFeatures, shaderCullDistance), PROFILE_FIELD_UINT32, 1},
+    {"shaderFloat64", offsetof(VkPhysicalDeviceFeatures, shaderFloat64), PROFILE_FIELD_UINT32, 1},
+    {"shaderInt64", offsetof(VkPhysicalDeviceFeatures, shaderInt64), PROFILE_FIELD_UINT32, 1},
+    {"shaderInt16", offsetof(VkPhysicalDeviceFeatures, shaderInt16), PROFILE_FIELD_UINT32, 1},
+    {"shaderResourceResidency", offsetof(VkPhysicalDeviceFeatures, shaderResourceResidency), PROFILE_FIELD_UINT32, 1},
+    {"shaderResourceMinLod", offsetof(VkPhysicalDeviceFeatures, shaderResourceMinLod), PROFILE_FIELD_UINT32, 1},
+    {"sparseBinding", offsetof(VkPhysicalDeviceFeatures, sparseBinding), PROFILE_FIELD_UINT32, 1},
+    {"sparseResidencyBuffer", offsetof(VkPhysicalDeviceFeatures, sparseResidencyBuffer), PROFILE_FIELD_UINT32, 1},
+    {"sparseResidencyImage2D", offsetof(VkPhysicalDeviceFeatures, sparseResidencyImage2D), PROFILE_FIELD_UINT32, 1},
+    {"sparseResidencyImage3D", offsetof(VkPhysicalDeviceFeatures, sparseResidencyImage3D), PROFILE_FIELD_UINT32, 1},
+    {"sparseResidency2Samples", offsetof(VkPhysicalDeviceFeatures, sparseResidency2Samples), PROFILE_FIELD_UINT32, 1},
+    {"sparseResidency4Samples", offsetof(VkPhysicalDeviceFeatures, sparseResidency4Samples), PROFILE_FIELD_UINT32, 1},
+    {"sparseResidency8Samples", offsetof(VkPhysicalDeviceFeatures, sparseResidency8Samples), PROFILE_FIELD_UINT32, 1},
+    {"sparseResidency16Samples", offsetof(VkPhysicalDeviceFeatures, sparseResidency16Samples), PROFILE_FIELD_UINT32, 1},
+    {"sparseResidencyAliased", offsetof(VkPhysicalDeviceFeatures, sparseResidencyAliased), PROFILE_FIELD_UINT32, 1},
+    {"variableMultisampleRate", offsetof(VkPhysicalDeviceFeatures, variableMultisampleRate), PROFILE_FIELD_UINT32, 1},
+    {"inheritedQueries", offsetof(VkPhysicalDeviceFeatures, inheritedQueries), PROFILE_FIELD_UINT32, 1},
+};
+// Texel blocks of the formats
+static constexpr FormatInfo format_infos[] = {
+    {VK_FORMAT_R4G4_UNORM_PACK8, 1, {1, 1, 1}, 1, {{1, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 4, 4}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 0, 4}}},
+    {VK_FORMAT_R4G4B4A4_UNORM_PACK16, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 12, 4}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 8, 4}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 4, 4}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 0, 4}}},
+    {VK_FORMAT_B4G4R4A4_UNORM_PACK16, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 4, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 12, 4}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 8, 4}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 4, 4}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 0, 4}}},
+    {VK_FORMAT_R5G6B5_UNORM_PACK16, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 11, 5}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 5, 6}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 0, 5}}},
+    {VK_FORMAT_B5G6R5_UNORM_PACK16, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 3, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 11, 5}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 5, 6}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 0, 5}}},
+    {VK_FORMAT_R5G5B5A1_UNORM_PACK16, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 11, 5}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 6, 5}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 1, 5}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 0, 1}}},
+    {VK_FORMAT_B5G5R5A1_UNORM_PACK16, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 4, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 11, 5}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 6, 5}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 1, 5}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 0, 1}}},
+    {VK_FORMAT_A1R5G5B5_UNORM_PACK16, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 15, 1}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 10, 5}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 5, 5}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 0, 5}}},
+    {VK_FORMAT_R8_UNORM, 1, {1, 1, 1}, 1, {{1, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 0, 8}}},
+    {VK_FORMAT_R8_SNORM, 1, {1, 1, 1}, 1, {{1, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SNORM, 0, 8}}},
+    {VK_FORMAT_R8_USCALED, 1, {1, 1, 1}, 1, {{1, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_USCALED, 0, 8}}},
+    {VK_FORMAT_R8_SSCALED, 1, {1, 1, 1}, 1, {{1, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SSCALED, 0, 8}}},
+    {VK_FORMAT_R8_UINT, 1, {1, 1, 1}, 1, {{1, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 0, 8}}},
+    {VK_FORMAT_R8_SINT, 1, {1, 1, 1}, 1, {{1, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 0, 8}}},
+    {VK_FORMAT_R8_SRGB, 1, {1, 1, 1}, 1, {{1, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SRGB, 0, 8}}},
+    {VK_FORMAT_R8G8_UNORM, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 8, 8}}},
+    {VK_FORMAT_R8G8_SNORM, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SNORM, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SNORM, 8, 8}}},
+    {VK_FORMAT_R8G8_USCALED, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_USCALED, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_USCALED, 8, 8}}},
+    {VK_FORMAT_R8G8_SSCALED, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SSCALED, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SSCALED, 8, 8}}},
+    {VK_FORMAT_R8G8_UINT, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UINT, 8, 8}}},
+    {VK_FORMAT_R8G8_SINT, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SINT, 8, 8}}},
+    {VK_FORMAT_R8G8_SRGB, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SRGB, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SRGB, 8, 8}}},
+    {VK_FORMAT_R8G8B8_UNORM, 3, {1, 1, 1}, 1, {{3, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 8, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 16, 8}}},
+    {VK_FORMAT_R8G8B8_SNORM, 3, {1, 1, 1}, 1, {{3, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SNORM, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SNORM, 8, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SNORM, 16, 8}}},
+    {VK_FORMAT_R8G8B8_USCALED, 3, {1, 1, 1}, 1, {{3, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_USCALED, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_USCALED, 8, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_USCALED, 16, 8}}},
+    {VK_FORMAT_R8G8B8_SSCALED, 3, {1, 1, 1}, 1, {{3, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SSCALED, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SSCALED, 8, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SSCALED, 16, 8}}},
+    {VK_FORMAT_R8G8B8_UINT, 3, {1, 1, 1}, 1, {{3, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UINT, 8, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UINT, 16, 8}}},
+    {VK_FORMAT_R8G8B8_SINT, 3, {1, 1, 1}, 1, {{3, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SINT, 8, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SINT, 16, 8}}},
+    {VK_FORMAT_R8G8B8_SRGB, 3, {1, 1, 1}, 1, {{3, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SRGB, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SRGB, 8, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SRGB, 16, 8}}},
+    {VK_FORMAT_B8G8R8_UNORM, 3, {1, 1, 1}, 1, {{3, 1, 1}}, 3, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 16, 8}}},
+    {VK_FORMAT_B8G8R8_SNORM, 3, {1, 1, 1}, 1, {{3, 1, 1}}, 3, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_SNORM, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SNORM, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SNORM, 16, 8}}},
+    {VK_FORMAT_B8G8R8_USCALED, 3, {1, 1, 1}, 1, {{3, 1, 1}}, 3, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_USCALED, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_USCALED, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_USCALED, 16, 8}}},
+    {VK_FORMAT_B8G8R8_SSCALED, 3, {1, 1, 1}, 1, {{3, 1, 1}}, 3, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_SSCALED, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SSCALED, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SSCALED, 16, 8}}},
+    {VK_FORMAT_B8G8R8_UINT, 3, {1, 1, 1}, 1, {{3, 1, 1}}, 3, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_UINT, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UINT, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 16, 8}}},
+    {VK_FORMAT_B8G8R8_SINT, 3, {1, 1, 1}, 1, {{3, 1, 1}}, 3, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_SINT, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SINT, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 16, 8}}},
+    {VK_FORMAT_B8G8R8_SRGB, 3, {1, 1, 1}, 1, {{3, 1, 1}}, 3, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_SRGB, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SRGB, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SRGB, 16, 8}}},
+    {VK_FORMAT_R8G8B8A8_UNORM, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 8, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 16, 8}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 24, 8}}},
+    {VK_FORMAT_R8G8B8A8_SNORM, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SNORM, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SNORM, 8, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SNORM, 16, 8}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_SNORM, 24, 8}}},
+    {VK_FORMAT_R8G8B8A8_USCALED, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_USCALED, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_USCALED, 8, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_USCALED, 16, 8}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_USCALED, 24, 8}}},
+    {VK_FORMAT_R8G8B8A8_SSCALED, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SSCALED, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SSCALED, 8, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SSCALED, 16, 8}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_SSCALED, 24, 8}}},
+    {VK_FORMAT_R8G8B8A8_UINT, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UINT, 8, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UINT, 16, 8}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_UINT, 24, 8}}},
+    {VK_FORMAT_R8G8B8A8_SINT, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SINT, 8, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SINT, 16, 8}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_SINT, 24, 8}}},
+    {VK_FORMAT_R8G8B8A8_SRGB, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SRGB, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SRGB, 8, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SRGB, 16, 8}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 24, 8}}},
+    {VK_FORMAT_B8G8R8A8_UNORM, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 16, 8}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 24, 8}}},
+    {VK_FORMAT_B8G8R8A8_SNORM, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_SNORM, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SNORM, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SNORM, 16, 8}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_SNORM, 24, 8}}},
+    {VK_FORMAT_B8G8R8A8_USCALED, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_USCALED, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_USCALED, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_USCALED, 16, 8}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_USCALED, 24, 8}}},
+    {VK_FORMAT_B8G8R8A8_SSCALED, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_SSCALED, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SSCALED, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SSCALED, 16, 8}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_SSCALED, 24, 8}}},
+    {VK_FORMAT_B8G8R8A8_UINT, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_UINT, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UINT, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 16, 8}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_UINT, 24, 8}}},
+    {VK_FORMAT_B8G8R8A8_SINT, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_SINT, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SINT, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 16, 8}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_SINT, 24, 8}}},
+    {VK_FORMAT_B8G8R8A8_SRGB, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_SRGB, 0, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SRGB, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SRGB, 16, 8}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 24, 8}}},
+    {VK_FORMAT_A8B8G8R8_UNORM_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 24, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 16, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 0, 8}}},
+    {VK_FORMAT_A8B8G8R8_SNORM_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_SNORM, 24, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SNORM, 16, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SNORM, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SNORM, 0, 8}}},
+    {VK_FORMAT_A8B8G8R8_USCALED_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_USCALED, 24, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_USCALED, 16, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_USCALED, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_USCALED, 0, 8}}},
+    {VK_FORMAT_A8B8G8R8_SSCALED_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_SSCALED, 24, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SSCALED, 16, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SSCALED, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SSCALED, 0, 8}}},
+    {VK_FORMAT_A8B8G8R8_UINT_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_UINT, 24, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UINT, 16, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UINT, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 0, 8}}},
+    {VK_FORMAT_A8B8G8R8_SINT_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_SINT, 24, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SINT, 16, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SINT, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 0, 8}}},
+    {VK_FORMAT_A8B8G8R8_SRGB_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 24, 8}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SRGB, 16, 8}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SRGB, 8, 8}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SRGB, 0, 8}}},
+    {VK_FORMAT_A2R10G10B10_UNORM_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 30, 2}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 20, 10}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 10, 10}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 0, 10}}},
+    {VK_FORMAT_A2R10G10B10_SNORM_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_SNORM, 30, 2}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SNORM, 20, 10}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SNORM, 10, 10}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SNORM, 0, 10}}},
+    {VK_FORMAT_A2R10G10B10_USCALED_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_USCALED, 30, 2}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_USCALED, 20, 10}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_USCALED, 10, 10}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_USCALED, 0, 10}}},
+    {VK_FORMAT_A2R10G10B10_SSCALED_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_SSCALED, 30, 2}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SSCALED, 20, 10}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SSCALED, 10, 10}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SSCALED, 0, 10}}},
+    {VK_FORMAT_A2R10G10B10_UINT_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_UINT, 30, 2}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 20, 10}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UINT, 10, 10}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UINT, 0, 10}}},
+    {VK_FORMAT_A2R10G10B10_SINT_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_SINT, 30, 2}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 20, 10}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SINT, 10, 10}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SINT, 0, 10}}},
+    {VK_FORMAT_A2B10G10R10_UNORM_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 30, 2}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 20, 10}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 10, 10}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 0, 10}}},
+    {VK_FORMAT_A2B10G10R10_SNORM_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_SNORM, 30, 2}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SNORM, 20, 10}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SNORM, 10, 10}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SNORM, 0, 10}}},
+    {VK_FORMAT_A2B10G10R10_USCALED_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_USCALED, 30, 2}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_USCALED, 20, 10}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_USCALED, 10, 10}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_USCALED, 0, 10}}},
+    {VK_FORMAT_A2B10G10R10_SSCALED_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_SSCALED, 30, 2}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SSCALED, 20, 10}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SSCALED, 10, 10}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SSCALED, 0, 10}}},
+    {VK_FORMAT_A2B10G10R10_UINT_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_UINT, 30, 2}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UINT, 20, 10}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UINT, 10, 10}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 0, 10}}},
+    {VK_FORMAT_A2B10G10R10_SINT_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 4, {{FORMAT_CHANNEL_A, FORMAT_NUMERIC_SINT, 30, 2}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SINT, 20, 10}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SINT, 10, 10}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 0, 10}}},
+    {VK_FORMAT_R16_UNORM, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 0, 16}}},
+    {VK_FORMAT_R16_SNORM, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SNORM, 0, 16}}},
+    {VK_FORMAT_R16_USCALED, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_USCALED, 0, 16}}},
+    {VK_FORMAT_R16_SSCALED, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SSCALED, 0, 16}}},
+    {VK_FORMAT_R16_UINT, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 0, 16}}},
+    {VK_FORMAT_R16_SINT, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 0, 16}}},
+    {VK_FORMAT_R16_SFLOAT, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SFLOAT, 0, 16}}},
+    {VK_FORMAT_R16G16_UNORM, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 16, 16}}},
+    {VK_FORMAT_R16G16_SNORM, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SNORM, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SNORM, 16, 16}}},
+    {VK_FORMAT_R16G16_USCALED, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_USCALED, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_USCALED, 16, 16}}},
+    {VK_FORMAT_R16G16_SSCALED, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SSCALED, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SSCALED, 16, 16}}},
+    {VK_FORMAT_R16G16_UINT, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UINT, 16, 16}}},
+    {VK_FORMAT_R16G16_SINT, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SINT, 16, 16}}},
+    {VK_FORMAT_R16G16_SFLOAT, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SFLOAT, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SFLOAT, 16, 16}}},
+    {VK_FORMAT_R16G16B16_UNORM, 6, {1, 1, 1}, 1, {{6, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 16, 16}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 32, 16}}},
+    {VK_FORMAT_R16G16B16_SNORM, 6, {1, 1, 1}, 1, {{6, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SNORM, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SNORM, 16, 16}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SNORM, 32, 16}}},
+    {VK_FORMAT_R16G16B16_USCALED, 6, {1, 1, 1}, 1, {{6, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_USCALED, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_USCALED, 16, 16}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_USCALED, 32, 16}}},
+    {VK_FORMAT_R16G16B16_SSCALED, 6, {1, 1, 1}, 1, {{6, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SSCALED, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SSCALED, 16, 16}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SSCALED, 32, 16}}},
+    {VK_FORMAT_R16G16B16_UINT, 6, {1, 1, 1}, 1, {{6, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UINT, 16, 16}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UINT, 32, 16}}},
+    {VK_FORMAT_R16G16B16_SINT, 6, {1, 1, 1}, 1, {{6, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SINT, 16, 16}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SINT, 32, 16}}},
+    {VK_FORMAT_R16G16B16_SFLOAT, 6, {1, 1, 1}, 1, {{6, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SFLOAT, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SFLOAT, 16, 16}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SFLOAT, 32, 16}}},
+    {VK_FORMAT_R16G16B16A16_UNORM, 8, {1, 1, 1}, 1, {{8, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 16, 16}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 32, 16}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 48, 16}}},
+    {VK_FORMAT_R16G16B16A16_SNORM, 8, {1, 1, 1}, 1, {{8, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SNORM, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SNORM, 16, 16}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SNORM, 32, 16}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_SNORM, 48, 16}}},
+    {VK_FORMAT_R16G16B16A16_USCALED, 8, {1, 1, 1}, 1, {{8, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_USCALED, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_USCALED, 16, 16}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_USCALED, 32, 16}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_USCALED, 48, 16}}},
+    {VK_FORMAT_R16G16B16A16_SSCALED, 8, {1, 1, 1}, 1, {{8, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SSCALED, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SSCALED, 16, 16}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SSCALED, 32, 16}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_SSCALED, 48, 16}}},
+    {VK_FORMAT_R16G16B16A16_UINT, 8, {1, 1, 1}, 1, {{8, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UINT, 16, 16}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UINT, 32, 16}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_UINT, 48, 16}}},
+    {VK_FORMAT_R16G16B16A16_SINT, 8, {1, 1, 1}, 1, {{8, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SINT, 16, 16}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SINT, 32, 16}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_SINT, 48, 16}}},
+    {VK_FORMAT_R16G16B16A16_SFLOAT, 8, {1, 1, 1}, 1, {{8, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SFLOAT, 0, 16}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SFLOAT, 16, 16}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SFLOAT, 32, 16}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_SFLOAT, 48, 16}}},
+    {VK_FORMAT_R32_UINT, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 0, 32}}},
+    {VK_FORMAT_R32_SINT, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 0, 32}}},
+    {VK_FORMAT_R32_SFLOAT, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SFLOAT, 0, 32}}},
+    {VK_FORMAT_R32G32_UINT, 8, {1, 1, 1}, 1, {{8, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 0, 32}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UINT, 32, 32}}},
+    {VK_FORMAT_R32G32_SINT, 8, {1, 1, 1}, 1, {{8, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 0, 32}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SINT, 32, 32}}},
+    {VK_FORMAT_R32G32_SFLOAT, 8, {1, 1, 1}, 1, {{8, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SFLOAT, 0, 32}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SFLOAT, 32, 32}}},
+    {VK_FORMAT_R32G32B32_UINT, 12, {1, 1, 1}, 1, {{12, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 0, 32}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UINT, 32, 32}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UINT, 64, 32}}},
+    {VK_FORMAT_R32G32B32_SINT, 12, {1, 1, 1}, 1, {{12, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 0, 32}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SINT, 32, 32}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SINT, 64, 32}}},
+    {VK_FORMAT_R32G32B32_SFLOAT, 12, {1, 1, 1}, 1, {{12, 1, 1}}, 3, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SFLOAT, 0, 32}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SFLOAT, 32, 32}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SFLOAT, 64, 32}}},
+    {VK_FORMAT_R32G32B32A32_UINT, 16, {1, 1, 1}, 1, {{16, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UINT, 0, 32}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UINT, 32, 32}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UINT, 64, 32}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_UINT, 96, 32}}},
+    {VK_FORMAT_R32G32B32A32_SINT, 16, {1, 1, 1}, 1, {{16, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SINT, 0, 32}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SINT, 32, 32}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SINT, 64, 32}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_SINT, 96, 32}}},
+    {VK_FORMAT_R32G32B32A32_SFLOAT, 16, {1, 1, 1}, 1, {{16, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_SFLOAT, 0, 32}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_SFLOAT, 32, 32}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_SFLOAT, 64, 32}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_SFLOAT, 96, 32}}},
+    {VK_FORMAT_R64_UINT, 8, {1, 1, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_R64_SINT, 8, {1, 1, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_R64_SFLOAT, 8, {1, 1, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_R64G64_UINT, 16, {1, 1, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_R64G64_SINT, 16, {1, 1, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_R64G64_SFLOAT, 16, {1, 1, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_R64G64B64_UINT, 24, {1, 1, 1}, 1, {{24, 1, 1}}, 0, {}},
+    {VK_FORMAT_R64G64B64_SINT, 24, {1, 1, 1}, 1, {{24, 1, 1}}, 0, {}},
+    {VK_FORMAT_R64G64B64_SFLOAT, 24, {1, 1, 1}, 1, {{24, 1, 1}}, 0, {}},
+    {VK_FORMAT_R64G64B64A64_UINT, 32, {1, 1, 1}, 1, {{32, 1, 1}}, 0, {}},
+    {VK_FORMAT_R64G64B64A64_SINT, 32, {1, 1, 1}, 1, {{32, 1, 1}}, 0, {}},
+    {VK_FORMAT_R64G64B64A64_SFLOAT, 32, {1, 1, 1}, 1, {{32, 1, 1}}, 0, {}},
+    {VK_FORMAT_B10G11R11_UFLOAT_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 3, {{FORMAT_CHANNEL_B, FORMAT_NUMERIC_UFLOAT, 22, 10}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UFLOAT, 11, 11}, {FORMAT_CHANNEL_R, FORMAT_NUMERIC_UFLOAT, 0, 11}}},
+    {VK_FORMAT_E5B9G9R9_UFLOAT_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 0, {}},
+    {VK_FORMAT_D16_UNORM, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 1, {{FORMAT_CHANNEL_DEPTH, FORMAT_NUMERIC_UNORM, 0, 16}}},
+    {VK_FORMAT_X8_D24_UNORM_PACK32, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 1, {{FORMAT_CHANNEL_DEPTH, FORMAT_NUMERIC_UNORM, 0, 24}}},
+    {VK_FORMAT_D32_SFLOAT, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 1, {{FORMAT_CHANNEL_DEPTH, FORMAT_NUMERIC_SFLOAT, 0, 32}}},
+    {VK_FORMAT_S8_UINT, 1, {1, 1, 1}, 1, {{1, 1, 1}}, 1, {{FORMAT_CHANNEL_STENCIL, FORMAT_NUMERIC_UINT, 0, 8}}},
+    {VK_FORMAT_D16_UNORM_S8_UINT, 3, {1, 1, 1}, 1, {{3, 1, 1}}, 2, {{FORMAT_CHANNEL_DEPTH, FORMAT_NUMERIC_UNORM, 0, 16}, {FORMAT_CHANNEL_STENCIL, FORMAT_NUMERIC_UINT, 16, 8}}},
+    {VK_FORMAT_D24_UNORM_S8_UINT, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 2, {{FORMAT_CHANNEL_DEPTH, FORMAT_NUMERIC_UNORM, 0, 24}, {FORMAT_CHANNEL_STENCIL, FORMAT_NUMERIC_UINT, 24, 8}}},
+    {VK_FORMAT_D32_SFLOAT_S8_UINT, 5, {1, 1, 1}, 1, {{5, 1, 1}}, 2, {{FORMAT_CHANNEL_DEPTH, FORMAT_NUMERIC_SFLOAT, 0, 32}, {FORMAT_CHANNEL_STENCIL, FORMAT_NUMERIC_UINT, 32, 8}}},
+    {VK_FORMAT_BC1_RGB_UNORM_BLOCK, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_BC1_RGB_SRGB_BLOCK, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_BC1_RGBA_UNORM_BLOCK, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_BC1_RGBA_SRGB_BLOCK, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_BC2_UNORM_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_BC2_SRGB_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_BC3_UNORM_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_BC3_SRGB_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_BC4_UNORM_BLOCK, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_BC4_SNORM_BLOCK, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_BC5_UNORM_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_BC5_SNORM_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_BC6H_UFLOAT_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_BC6H_SFLOAT_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_BC7_UNORM_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_BC7_SRGB_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_EAC_R11_UNORM_BLOCK, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_EAC_R11_SNORM_BLOCK, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_EAC_R11G11_UNORM_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_EAC_R11G11_SNORM_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_4x4_UNORM_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_4x4_SRGB_BLOCK, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_5x4_UNORM_BLOCK, 16, {5, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_5x4_SRGB_BLOCK, 16, {5, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_5x5_UNORM_BLOCK, 16, {5, 5, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_5x5_SRGB_BLOCK, 16, {5, 5, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_6x5_UNORM_BLOCK, 16, {6, 5, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_6x5_SRGB_BLOCK, 16, {6, 5, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_6x6_UNORM_BLOCK, 16, {6, 6, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_6x6_SRGB_BLOCK, 16, {6, 6, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_8x5_UNORM_BLOCK, 16, {8, 5, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_8x5_SRGB_BLOCK, 16, {8, 5, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_8x6_UNORM_BLOCK, 16, {8, 6, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_8x6_SRGB_BLOCK, 16, {8, 6, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_8x8_UNORM_BLOCK, 16, {8, 8, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_8x8_SRGB_BLOCK, 16, {8, 8, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_10x5_UNORM_BLOCK, 16, {10, 5, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_10x5_SRGB_BLOCK, 16, {10, 5, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_10x6_UNORM_BLOCK, 16, {10, 6, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_10x6_SRGB_BLOCK, 16, {10, 6, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_10x8_UNORM_BLOCK, 16, {10, 8, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_10x8_SRGB_BLOCK, 16, {10, 8, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_10x10_UNORM_BLOCK, 16, {10, 10, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_10x10_SRGB_BLOCK, 16, {10, 10, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_12x10_UNORM_BLOCK, 16, {12, 10, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_12x10_SRGB_BLOCK, 16, {12, 10, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_12x12_UNORM_BLOCK, 16, {12, 12, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_12x12_SRGB_BLOCK, 16, {12, 12, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_G8B8G8R8_422_UNORM, 4, {2, 1, 1}, 1, {{4, 1, 1}}, 0, {}},
+    {VK_FORMAT_B8G8R8G8_422_UNORM, 4, {2, 1, 1}, 1, {{4, 1, 1}}, 0, {}},
+    {VK_FORMAT_G8_B8_R8_3PLANE_420_UNORM, 3, {1, 1, 1}, 3, {{1, 1, 1}, {1, 2, 2}, {1, 2, 2}}, 0, {}},
+    {VK_FORMAT_G8_B8R8_2PLANE_420_UNORM, 3, {1, 1, 1}, 2, {{1, 1, 1}, {2, 2, 2}}, 0, {}},
+    {VK_FORMAT_G8_B8_R8_3PLANE_422_UNORM, 3, {1, 1, 1}, 3, {{1, 1, 1}, {1, 2, 1}, {1, 2, 1}}, 0, {}},
+    {VK_FORMAT_G8_B8R8_2PLANE_422_UNORM, 3, {1, 1, 1}, 2, {{1, 1, 1}, {2, 2, 1}}, 0, {}},
+    {VK_FORMAT_G8_B8_R8_3PLANE_444_UNORM, 3, {1, 1, 1}, 3, {{1, 1, 1}, {1, 1, 1}, {1, 1, 1}}, 0, {}},
+    {VK_FORMAT_R10X6_UNORM_PACK16, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 6, 10}}},
+    {VK_FORMAT_R10X6G10X6_UNORM_2PACK16, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 6, 10}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 22, 10}}},
+    {VK_FORMAT_R10X6G10X6B10X6A10X6_UNORM_4PACK16, 8, {1, 1, 1}, 1, {{8, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 6, 10}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 22, 10}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 38, 10}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 54, 10}}},
+    {VK_FORMAT_G10X6B10X6G10X6R10X6_422_UNORM_4PACK16, 8, {2, 1, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_B10X6G10X6R10X6G10X6_422_UNORM_4PACK16, 8, {2, 1, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_G10X6_B10X6_R10X6_3PLANE_420_UNORM_3PACK16, 6, {1, 1, 1}, 3, {{2, 1, 1}, {2, 2, 2}, {2, 2, 2}}, 0, {}},
+    {VK_FORMAT_G10X6_B10X6R10X6_2PLANE_420_UNORM_3PACK16, 6, {1, 1, 1}, 2, {{2, 1, 1}, {4, 2, 2}}, 0, {}},
+    {VK_FORMAT_G10X6_B10X6_R10X6_3PLANE_422_UNORM_3PACK16, 6, {1, 1, 1}, 3, {{2, 1, 1}, {2, 2, 1}, {2, 2, 1}}, 0, {}},
+    {VK_FORMAT_G10X6_B10X6R10X6_2PLANE_422_UNORM_3PACK16, 6, {1, 1, 1}, 2, {{2, 1, 1}, {4, 2, 1}}, 0, {}},
+    {VK_FORMAT_G10X6_B10X6_R10X6_3PLANE_444_UNORM_3PACK16, 6, {1, 1, 1}, 3, {{2, 1, 1}, {2, 1, 1}, {2, 1, 1}}, 0, {}},
+    {VK_FORMAT_R12X4_UNORM_PACK16, 2, {1, 1, 1}, 1, {{2, 1, 1}}, 1, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 4, 12}}},
+    {VK_FORMAT_R12X4G12X4_UNORM_2PACK16, 4, {1, 1, 1}, 1, {{4, 1, 1}}, 2, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 4, 12}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 20, 12}}},
+    {VK_FORMAT_R12X4G12X4B12X4A12X4_UNORM_4PACK16, 8, {1, 1, 1}, 1, {{8, 1, 1}}, 4, {{FORMAT_CHANNEL_R, FORMAT_NUMERIC_UNORM, 4, 12}, {FORMAT_CHANNEL_G, FORMAT_NUMERIC_UNORM, 20, 12}, {FORMAT_CHANNEL_B, FORMAT_NUMERIC_UNORM, 36, 12}, {FORMAT_CHANNEL_A, FORMAT_NUMERIC_UNORM, 52, 12}}},
+    {VK_FORMAT_G12X4B12X4G12X4R12X4_422_UNORM_4PACK16, 8, {2, 1, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_B12X4G12X4R12X4G12X4_422_UNORM_4PACK16, 8, {2, 1, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_G12X4_B12X4_R12X4_3PLANE_420_UNORM_3PACK16, 6, {1, 1, 1}, 3, {{2, 1, 1}, {2, 2, 2}, {2, 2, 2}}, 0, {}},
+    {VK_FORMAT_G12X4_B12X4R12X4_2PLANE_420_UNORM_3PACK16, 6, {1, 1, 1}, 2, {{2, 1, 1}, {4, 2, 2}}, 0, {}},
+    {VK_FORMAT_G12X4_B12X4_R12X4_3PLANE_422_UNORM_3PACK16, 6, {1, 1, 1}, 3, {{2, 1, 1}, {2, 2, 1}, {2, 2, 1}}, 0, {}},
+    {VK_FORMAT_G12X4_B12X4R12X4_2PLANE_422_UNORM_3PACK16, 6, {1, 1, 1}, 2, {{2, 1, 1}, {4, 2, 1}}, 0, {}},
+    {VK_FORMAT_G12X4_B12X4_R12X4_3PLANE_444_UNORM_3PACK16, 6, {1, 1, 1}, 3, {{2, 1, 1}, {2, 1, 1}, {2, 1, 1}}, 0, {}},
+    {VK_FORMAT_G16B16G16R16_422_UNORM, 8, {2, 1, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_B16G16R16G16_422_UNORM, 8, {2, 1, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_G16_B16_R16_3PLANE_420_UNORM, 6, {1, 1, 1}, 3, {{2, 1, 1}, {2, 2, 2}, {2, 2, 2}}, 0, {}},
+    {VK_FORMAT_G16_B16R16_2PLANE_420_UNORM, 6, {1, 1, 1}, 2, {{2, 1, 1}, {4, 2, 2}}, 0, {}},
+    {VK_FORMAT_G16_B16_R16_3PLANE_422_UNORM, 6, {1, 1, 1}, 3, {{2, 1, 1}, {2, 2, 1}, {2, 2, 1}}, 0, {}},
+    {VK_FORMAT_G16_B16R16_2PLANE_422_UNORM, 6, {1, 1, 1}, 2, {{2, 1, 1}, {4, 2, 1}}, 0, {}},
+    {VK_FORMAT_G16_B16_R16_3PLANE_444_UNORM, 6, {1, 1, 1}, 3, {{2, 1, 1}, {2, 1, 1}, {2, 1, 1}}, 0, {}},
+    {VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG, 8, {8, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG, 8, {8, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG, 8, {8, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG, 8, {8, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG, 8, {4, 4, 1}, 1, {{8, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK_EXT, 16, {4, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_5x4_SFLOAT_BLOCK_EXT, 16, {5, 4, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_5x5_SFLOAT_BLOCK_EXT, 16, {5, 5, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_6x5_SFLOAT_BLOCK_EXT, 16, {6, 5, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_6x6_SFLOAT_BLOCK_EXT, 16, {6, 6, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_8x5_SFLOAT_BLOCK_EXT, 16, {8, 5, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_8x6_SFLOAT_BLOCK_EXT, 16, {8, 6, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_8x8_SFLOAT_BLOCK_EXT, 16, {8, 8, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_10x5_SFLOAT_BLOCK_EXT, 16, {10, 5, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_10x6_SFLOAT_BLOCK_EXT, 16, {10, 6, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_10x8_SFLOAT_BLOCK_EXT, 16, {10, 8, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_10x10_SFLOAT_BLOCK_EXT, 16, {10, 10, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_12x10_SFLOAT_BLOCK_EXT, 16, {12, 10, 1}, 1, {{16, 1, 1}}, 0, {}},
+    {VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK_EXT, 16, {12, 12, 1}, 1, {{16, 1, 1}}, 0, {}},
 };
 
 
@@ -2675,460 +3485,1563 @@ static VKAPI_ATTR void VKAPI_CALL ResetQueryPoolEXT(
 
 
 // Map of all APIs to be intercepted by this layer
-static const std::unordered_map<std::string, void*> name_to_funcptr_map = {
-    {"vkCreateInstance", (void*)CreateInstance},
-    {"vkDestroyInstance", (void*)DestroyInstance},
-    {"vkEnumeratePhysicalDevices", (void*)EnumeratePhysicalDevices},
-    {"vkGetPhysicalDeviceFeatures", (void*)GetPhysicalDeviceFeatures},
-    {"vkGetPhysicalDeviceFormatProperties", (void*)GetPhysicalDeviceFormatProperties},
-    {"vkGetPhysicalDeviceImageFormatProperties", (void*)GetPhysicalDeviceImageFormatProperties},
-    {"vkGetPhysicalDeviceProperties", (void*)GetPhysicalDeviceProperties},
-    {"vkGetPhysicalDeviceQueueFamilyProperties", (void*)GetPhysicalDeviceQueueFamilyProperties},
-    {"vkGetPhysicalDeviceMemoryProperties", (void*)GetPhysicalDeviceMemoryProperties},
-    {"vkGetInstanceProcAddr", (void*)GetInstanceProcAddr},
-    {"vkGetDeviceProcAddr", (void*)GetDeviceProcAddr},
-    {"vkCreateDevice", (void*)CreateDevice},
-    {"vkDestroyDevice", (void*)DestroyDevice},
-    {"vkEnumerateInstanceExtensionProperties", (void*)EnumerateInstanceExtensionProperties},
-    {"vkEnumerateDeviceExtensionProperties", (void*)EnumerateDeviceExtensionProperties},
-    {"vkEnumerateInstanceLayerProperties", (void*)EnumerateInstanceLayerProperties},
-    {"vkEnumerateDeviceLayerProperties", (void*)EnumerateDeviceLayerProperties},
-    {"vkGetDeviceQueue", (void*)GetDeviceQueue},
-    {"vkQueueSubmit", (void*)QueueSubmit},
-    {"vkQueueWaitIdle", (void*)QueueWaitIdle},
-    {"vkDeviceWaitIdle", (void*)DeviceWaitIdle},
-    {"vkAllocateMemory", (void*)AllocateMemory},
-    {"vkFreeMemory", (void*)FreeMemory},
-    {"vkMapMemory", (void*)MapMemory},
-    {"vkUnmapMemory", (void*)UnmapMemory},
-    {"vkFlushMappedMemoryRanges", (void*)FlushMappedMemoryRanges},
-    {"vkInvalidateMappedMemoryRanges", (void*)InvalidateMappedMemoryRanges},
-    {"vkGetDeviceMemoryCommitment", (void*)GetDeviceMemoryCommitment},
-    {"vkBindBufferMemory", (void*)BindBufferMemory},
-    {"vkBindImageMemory", (void*)BindImageMemory},
-    {"vkGetBufferMemoryRequirements", (void*)GetBufferMemoryRequirements},
-    {"vkGetImageMemoryRequirements", (void*)GetImageMemoryRequirements},
-    {"vkGetImageSparseMemoryRequirements", (void*)GetImageSparseMemoryRequirements},
-    {"vkGetPhysicalDeviceSparseImageFormatProperties", (void*)GetPhysicalDeviceSparseImageFormatProperties},
-    {"vkQueueBindSparse", (void*)QueueBindSparse},
-    {"vkCreateFence", (void*)CreateFence},
-    {"vkDestroyFence", (void*)DestroyFence},
-    {"vkResetFences", (void*)ResetFences},
-    {"vkGetFenceStatus", (void*)GetFenceStatus},
-    {"vkWaitForFences", (void*)WaitForFences},
-    {"vkCreateSemaphore", (void*)CreateSemaphore},
-    {"vkDestroySemaphore", (void*)DestroySemaphore},
-    {"vkCreateEvent", (void*)CreateEvent},
-    {"vkDestroyEvent", (void*)DestroyEvent},
-    {"vkGetEventStatus", (void*)GetEventStatus},
-    {"vkSetEvent", (void*)SetEvent},
-    {"vkResetEvent", (void*)ResetEvent},
-    {"vkCreateQueryPool", (void*)CreateQueryPool},
-    {"vkDestroyQueryPool", (void*)DestroyQueryPool},
-    {"vkGetQueryPoolResults", (void*)GetQueryPoolResults},
-    {"vkCreateBuffer", (void*)CreateBuffer},
-    {"vkDestroyBuffer", (void*)DestroyBuffer},
-    {"vkCreateBufferView", (void*)CreateBufferView},
-    {"vkDestroyBufferView", (void*)DestroyBufferView},
-    {"vkCreateImage", (void*)CreateImage},
-    {"vkDestroyImage", (void*)DestroyImage},
-    {"vkGetImageSubresourceLayout", (void*)GetImageSubresourceLayout},
-    {"vkCreateImageView", (void*)CreateImageView},
-    {"vkDestroyImageView", (void*)DestroyImageView},
-    {"vkCreateShaderModule", (void*)CreateShaderModule},
-    {"vkDestroyShaderModule", (void*)DestroyShaderModule},
-    {"vkCreatePipelineCache", (void*)CreatePipelineCache},
-    {"vkDestroyPipelineCache", (void*)DestroyPipelineCache},
-    {"vkGetPipelineCacheData", (void*)GetPipelineCacheData},
-    {"vkMergePipelineCaches", (void*)MergePipelineCaches},
-    {"vkCreateGraphicsPipelines", (void*)CreateGraphicsPipelines},
-    {"vkCreateComputePipelines", (void*)CreateComputePipelines},
-    {"vkDestroyPipeline", (void*)DestroyPipeline},
-    {"vkCreatePipelineLayout", (void*)CreatePipelineLayout},
-    {"vkDestroyPipelineLayout", (void*)DestroyPipelineLayout},
-    {"vkCreateSampler", (void*)CreateSampler},
-    {"vkDestroySampler", (void*)DestroySampler},
-    {"vkCreateDescriptorSetLayout", (void*)CreateDescriptorSetLayout},
-    {"vkDestroyDescriptorSetLayout", (void*)DestroyDescriptorSetLayout},
-    {"vkCreateDescriptorPool", (void*)CreateDescriptorPool},
-    {"vkDestroyDescriptorPool", (void*)DestroyDescriptorPool},
-    {"vkResetDescriptorPool", (void*)ResetDescriptorPool},
-    {"vkAllocateDescriptorSets", (void*)AllocateDescriptorSets},
-    {"vkFreeDescriptorSets", (void*)FreeDescriptorSets},
-    {"vkUpdateDescriptorSets", (void*)UpdateDescriptorSets},
-    {"vkCreateFramebuffer", (void*)CreateFramebuffer},
-    {"vkDestroyFramebuffer", (void*)DestroyFramebuffer},
-    {"vkCreateRenderPass", (void*)CreateRenderPass},
-    {"vkDestroyRenderPass", (void*)DestroyRenderPass},
-    {"vkGetRenderAreaGranularity", (void*)GetRenderAreaGranularity},
-    {"vkCreateCommandPool", (void*)CreateCommandPool},
-    {"vkDestroyCommandPool", (void*)DestroyCommandPool},
-    {"vkResetCommandPool", (void*)ResetCommandPool},
-    {"vkAllocateCommandBuffers", (void*)AllocateCommandBuffers},
-    {"vkFreeCommandBuffers", (void*)FreeCommandBuffers},
-    {"vkBeginCommandBuffer", (void*)BeginCommandBuffer},
-    {"vkEndCommandBuffer", (void*)EndCommandBuffer},
-    {"vkResetCommandBuffer", (void*)ResetCommandBuffer},
-    {"vkCmdBindPipeline", (void*)CmdBindPipeline},
-    {"vkCmdSetViewport", (void*)CmdSetViewport},
-    {"vkCmdSetScissor", (void*)CmdSetScissor},
-    {"vkCmdSetLineWidth", (void*)CmdSetLineWidth},
-    {"vkCmdSetDepthBias", (void*)CmdSetDepthBias},
-    {"vkCmdSetBlendConstants", (void*)CmdSetBlendConstants},
-    {"vkCmdSetDepthBounds", (void*)CmdSetDepthBounds},
-    {"vkCmdSetStencilCompareMask", (void*)CmdSetStencilCompareMask},
-    {"vkCmdSetStencilWriteMask", (void*)CmdSetStencilWriteMask},
-    {"vkCmdSetStencilReference", (void*)CmdSetStencilReference},
-    {"vkCmdBindDescriptorSets", (void*)CmdBindDescriptorSets},
-    {"vkCmdBindIndexBuffer", (void*)CmdBindIndexBuffer},
-    {"vkCmdBindVertexBuffers", (void*)CmdBindVertexBuffers},
-    {"vkCmdDraw", (void*)CmdDraw},
-    {"vkCmdDrawIndexed", (void*)CmdDrawIndexed},
-    {"vkCmdDrawIndirect", (void*)CmdDrawIndirect},
-    {"vkCmdDrawIndexedIndirect", (void*)CmdDrawIndexedIndirect},
-    {"vkCmdDispatch", (void*)CmdDispatch},
-    {"vkCmdDispatchIndirect", (void*)CmdDispatchIndirect},
-    {"vkCmdCopyBuffer", (void*)CmdCopyBuffer},
-    {"vkCmdCopyImage", (void*)CmdCopyImage},
-    {"vkCmdBlitImage", (void*)CmdBlitImage},
-    {"vkCmdCopyBufferToImage", (void*)CmdCopyBufferToImage},
-    {"vkCmdCopyImageToBuffer", (void*)CmdCopyImageToBuffer},
-    {"vkCmdUpdateBuffer", (void*)CmdUpdateBuffer},
-    {"vkCmdFillBuffer", (void*)CmdFillBuffer},
-    {"vkCmdClearColorImage", (void*)CmdClearColorImage},
-    {"vkCmdClearDepthStencilImage", (void*)CmdClearDepthStencilImage},
-    {"vkCmdClearAttachments", (void*)CmdClearAttachments},
-    {"vkCmdResolveImage", (void*)CmdResolveImage},
-    {"vkCmdSetEvent", (void*)CmdSetEvent},
-    {"vkCmdResetEvent", (void*)CmdResetEvent},
-    {"vkCmdWaitEvents", (void*)CmdWaitEvents},
-    {"vkCmdPipelineBarrier", (void*)CmdPipelineBarrier},
-    {"vkCmdBeginQuery", (void*)CmdBeginQuery},
-    {"vkCmdEndQuery", (void*)CmdEndQuery},
-    {"vkCmdResetQueryPool", (void*)CmdResetQueryPool},
-    {"vkCmdWriteTimestamp", (void*)CmdWriteTimestamp},
-    {"vkCmdCopyQueryPoolResults", (void*)CmdCopyQueryPoolResults},
-    {"vkCmdPushConstants", (void*)CmdPushConstants},
-    {"vkCmdBeginRenderPass", (void*)CmdBeginRenderPass},
-    {"vkCmdNextSubpass", (void*)CmdNextSubpass},
-    {"vkCmdEndRenderPass", (void*)CmdEndRenderPass},
-    {"vkCmdExecuteCommands", (void*)CmdExecuteCommands},
-    {"vkEnumerateInstanceVersion", (void*)EnumerateInstanceVersion},
-    {"vkBindBufferMemory2", (void*)BindBufferMemory2},
-    {"vkBindImageMemory2", (void*)BindImageMemory2},
-    {"vkGetDeviceGroupPeerMemoryFeatures", (void*)GetDeviceGroupPeerMemoryFeatures},
-    {"vkCmdSetDeviceMask", (void*)CmdSetDeviceMask},
-    {"vkCmdDispatchBase", (void*)CmdDispatchBase},
-    {"vkEnumeratePhysicalDeviceGroups", (void*)EnumeratePhysicalDeviceGroups},
-    {"vkGetImageMemoryRequirements2", (void*)GetImageMemoryRequirements2},
-    {"vkGetBufferMemoryRequirements2", (void*)GetBufferMemoryRequirements2},
-    {"vkGetImageSparseMemoryRequirements2", (void*)GetImageSparseMemoryRequirements2},
-    {"vkGetPhysicalDeviceFeatures2", (void*)GetPhysicalDeviceFeatures2},
-    {"vkGetPhysicalDeviceProperties2", (void*)GetPhysicalDeviceProperties2},
-    {"vkGetPhysicalDeviceFormatProperties2", (void*)GetPhysicalDeviceFormatProperties2},
-    {"vkGetPhysicalDeviceImageFormatProperties2", (void*)GetPhysicalDeviceImageFormatProperties2},
-    {"vkGetPhysicalDeviceQueueFamilyProperties2", (void*)GetPhysicalDeviceQueueFamilyProperties2},
-    {"vkGetPhysicalDeviceMemoryProperties2", (void*)GetPhysicalDeviceMemoryProperties2},
-    {"vkGetPhysicalDeviceSparseImageFormatProperties2", (void*)GetPhysicalDeviceSparseImageFormatProperties2},
-    {"vkTrimCommandPool", (void*)TrimCommandPool},
-    {"vkGetDeviceQueue2", (void*)GetDeviceQueue2},
-    {"vkCreateSamplerYcbcrConversion", (void*)CreateSamplerYcbcrConversion},
-    {"vkDestroySamplerYcbcrConversion", (void*)DestroySamplerYcbcrConversion},
-    {"vkCreateDescriptorUpdateTemplate", (void*)CreateDescriptorUpdateTemplate},
-    {"vkDestroyDescriptorUpdateTemplate", (void*)DestroyDescriptorUpdateTemplate},
-    {"vkUpdateDescriptorSetWithTemplate", (void*)UpdateDescriptorSetWithTemplate},
-    {"vkGetPhysicalDeviceExternalBufferProperties", (void*)GetPhysicalDeviceExternalBufferProperties},
-    {"vkGetPhysicalDeviceExternalFenceProperties", (void*)GetPhysicalDeviceExternalFenceProperties},
-    {"vkGetPhysicalDeviceExternalSemaphoreProperties", (void*)GetPhysicalDeviceExternalSemaphoreProperties},
-    {"vkGetDescriptorSetLayoutSupport", (void*)GetDescriptorSetLayoutSupport},
-    {"vkCmdDrawIndirectCount", (void*)CmdDrawIndirectCount},
-    {"vkCmdDrawIndexedIndirectCount", (void*)CmdDrawIndexedIndirectCount},
-    {"vkCreateRenderPass2", (void*)CreateRenderPass2},
-    {"vkCmdBeginRenderPass2", (void*)CmdBeginRenderPass2},
-    {"vkCmdNextSubpass2", (void*)CmdNextSubpass2},
-    {"vkCmdEndRenderPass2", (void*)CmdEndRenderPass2},
-    {"vkResetQueryPool", (void*)ResetQueryPool},
-    {"vkGetSemaphoreCounterValue", (void*)GetSemaphoreCounterValue},
-    {"vkWaitSemaphores", (void*)WaitSemaphores},
-    {"vkSignalSemaphore", (void*)SignalSemaphore},
-    {"vkGetBufferDeviceAddress", (void*)GetBufferDeviceAddress},
-    {"vkGetBufferOpaqueCaptureAddress", (void*)GetBufferOpaqueCaptureAddress},
-    {"vkGetDeviceMemoryOpaqueCaptureAddress", (void*)GetDeviceMemoryOpaqueCaptureAddress},
-    {"vkDestroySurfaceKHR", (void*)DestroySurfaceKHR},
-    {"vkGetPhysicalDeviceSurfaceSupportKHR", (void*)GetPhysicalDeviceSurfaceSupportKHR},
-    {"vkGetPhysicalDeviceSurfaceCapabilitiesKHR", (void*)GetPhysicalDeviceSurfaceCapabilitiesKHR},
-    {"vkGetPhysicalDeviceSurfaceFormatsKHR", (void*)GetPhysicalDeviceSurfaceFormatsKHR},
-    {"vkGetPhysicalDeviceSurfacePresentModesKHR", (void*)GetPhysicalDeviceSurfacePresentModesKHR},
-    {"vkCreateSwapchainKHR", (void*)CreateSwapchainKHR},
-    {"vkDestroySwapchainKHR", (void*)DestroySwapchainKHR},
-    {"vkGetSwapchainImagesKHR", (void*)GetSwapchainImagesKHR},
-    {"vkAcquireNextImageKHR", (void*)AcquireNextImageKHR},
-    {"vkQueuePresentKHR", (void*)QueuePresentKHR},
-    {"vkGetDeviceGroupPresentCapabilitiesKHR", (void*)GetDeviceGroupPresentCapabilitiesKHR},
-    {"vkGetDeviceGroupSurfacePresentModesKHR", (void*)GetDeviceGroupSurfacePresentModesKHR},
-    {"vkGetPhysicalDevicePresentRectanglesKHR", (void*)GetPhysicalDevicePresentRectanglesKHR},
-    {"vkAcquireNextImage2KHR", (void*)AcquireNextImage2KHR},
-    {"vkGetPhysicalDeviceDisplayPropertiesKHR", (void*)GetPhysicalDeviceDisplayPropertiesKHR},
-    {"vkGetPhysicalDeviceDisplayPlanePropertiesKHR", (void*)GetPhysicalDeviceDisplayPlanePropertiesKHR},
-    {"vkGetDisplayPlaneSupportedDisplaysKHR", (void*)GetDisplayPlaneSupportedDisplaysKHR},
-    {"vkGetDisplayModePropertiesKHR", (void*)GetDisplayModePropertiesKHR},
-    {"vkCreateDisplayModeKHR", (void*)CreateDisplayModeKHR},
-    {"vkGetDisplayPlaneCapabilitiesKHR", (void*)GetDisplayPlaneCapabilitiesKHR},
-    {"vkCreateDisplayPlaneSurfaceKHR", (void*)CreateDisplayPlaneSurfaceKHR},
-    {"vkCreateSharedSwapchainsKHR", (void*)CreateSharedSwapchainsKHR},
-#ifdef VK_USE_PLATFORM_XLIB_KHR
-    {"vkCreateXlibSurfaceKHR", (void*)CreateXlibSurfaceKHR},
-#endif
-#ifdef VK_USE_PLATFORM_XLIB_KHR
-    {"vkGetPhysicalDeviceXlibPresentationSupportKHR", (void*)GetPhysicalDeviceXlibPresentationSupportKHR},
+static const NameTable<void*, 512> name_to_funcptr_map = {{
+    {"vkGetDisplayPlaneSupportedDisplaysKHR", 37, 0x09cc6192u, (void*)GetDisplayPlaneSupportedDisplaysKHR},
+    {"vkAcquireNextImageKHR", 21, 0xe09f2873u, (void*)AcquireNextImageKHR},
+    {"vkGetPhysicalDeviceImageFormatProperties2", 41, 0x71293356u, (void*)GetPhysicalDeviceImageFormatProperties2},
+    {"vkGetPhysicalDeviceProperties2KHR", 33, 0xcd58d5a9u, (void*)GetPhysicalDeviceProperties2KHR},
+    {"vkQueueSubmit", 13, 0xa702ecf9u, (void*)QueueSubmit},
+    {"vkWaitSemaphores", 16, 0xc2aca738u, (void*)WaitSemaphores},
+    {"vkDestroyDevice", 15, 0x76ce3712u, (void*)DestroyDevice},
+    {"vkDestroyDebugUtilsMessengerEXT", 31, 0xfd8afed2u, (void*)DestroyDebugUtilsMessengerEXT},
+    {"vkCmdEndQueryIndexedEXT", 23, 0xeb029c35u, (void*)CmdEndQueryIndexedEXT},
+    {"vkDestroyImageView", 18, 0xb32c7798u, (void*)DestroyImageView},
+    {"vkGetPhysicalDeviceFormatProperties2", 36, 0xcece3a97u, (void*)GetPhysicalDeviceFormatProperties2},
+    {"vkCmdResolveImage", 17, 0xd84ff14bu, (void*)CmdResolveImage},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdWriteTimestamp", 19, 0xf4fa04efu, (void*)CmdWriteTimestamp},
+#ifdef VK_USE_PLATFORM_FUCHSIA
+    {"vkCreateImagePipeSurfaceFUCHSIA", 31, 0xe7b2368fu, (void*)CreateImagePipeSurfaceFUCHSIA},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
+    {"vkCmdWaitEvents", 15, 0x18acad2eu, (void*)CmdWaitEvents},
+    {nullptr, 0, 0, nullptr},
+    {"vkResetCommandPool", 18, 0x32d3032cu, (void*)ResetCommandPool},
+    {"vkBindAccelerationStructureMemoryNV", 35, 0xa8bf8249u, (void*)BindAccelerationStructureMemoryNV},
+    {"vkGetBufferDeviceAddress", 24, 0x5a76a96eu, (void*)GetBufferDeviceAddress},
+    {"vkGetAccelerationStructureMemoryRequirementsNV", 46, 0xb92c8ff8u, (void*)GetAccelerationStructureMemoryRequirementsNV},
+    {"vkCmdSetPerformanceMarkerINTEL", 30, 0x58912d22u, (void*)CmdSetPerformanceMarkerINTEL},
 #ifdef VK_USE_PLATFORM_XCB_KHR
-    {"vkCreateXcbSurfaceKHR", (void*)CreateXcbSurfaceKHR},
+    {"vkGetPhysicalDeviceXcbPresentationSupportKHR", 44, 0xce393e44u, (void*)GetPhysicalDeviceXcbPresentationSupportKHR},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_XCB_KHR
-    {"vkGetPhysicalDeviceXcbPresentationSupportKHR", (void*)GetPhysicalDeviceXcbPresentationSupportKHR},
+    {"vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR", 63, 0x426d36bcu, (void*)EnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdBeginDebugUtilsLabelEXT", 28, 0x26ebe05au, (void*)CmdBeginDebugUtilsLabelEXT},
+    {"vkDestroyBufferView", 19, 0x827878bbu, (void*)DestroyBufferView},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetPhysicalDeviceGeneratedCommandsPropertiesNVX", 49, 0xdc6ab117u, (void*)GetPhysicalDeviceGeneratedCommandsPropertiesNVX},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdSetDeviceMask", 18, 0xf0313ec8u, (void*)CmdSetDeviceMask},
+    {nullptr, 0, 0, nullptr},
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkGetPhysicalDeviceSurfacePresentModes2EXT", 42, 0xdcfd64b0u, (void*)GetPhysicalDeviceSurfacePresentModes2EXT},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_WAYLAND_KHR
-    {"vkCreateWaylandSurfaceKHR", (void*)CreateWaylandSurfaceKHR},
+    {"vkCreateFence", 13, 0xb758c6a3u, (void*)CreateFence},
+    {"vkGetDisplayPlaneCapabilitiesKHR", 32, 0x5589d607u, (void*)GetDisplayPlaneCapabilitiesKHR},
+    {"vkAllocateCommandBuffers", 24, 0x9b476eedu, (void*)AllocateCommandBuffers},
+    {"vkTrimCommandPoolKHR", 20, 0x87745984u, (void*)TrimCommandPoolKHR},
+#ifdef VK_USE_PLATFORM_XLIB_KHR
+    {"vkCreateXlibSurfaceKHR", 22, 0x321f0457u, (void*)CreateXlibSurfaceKHR},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_WAYLAND_KHR
-    {"vkGetPhysicalDeviceWaylandPresentationSupportKHR", (void*)GetPhysicalDeviceWaylandPresentationSupportKHR},
+    {"vkQueueInsertDebugUtilsLabelEXT", 31, 0x963e0d79u, (void*)QueueInsertDebugUtilsLabelEXT},
+    {"vkDestroyValidationCacheEXT", 27, 0x82240b92u, (void*)DestroyValidationCacheEXT},
+    {"vkGetPhysicalDeviceSurfaceCapabilitiesKHR", 41, 0xfe83d699u, (void*)GetPhysicalDeviceSurfaceCapabilitiesKHR},
+    {"vkCmdClearAttachments", 21, 0x049d5213u, (void*)CmdClearAttachments},
+    {"vkCmdDrawMeshTasksIndirectCountNV", 33, 0xa99feebau, (void*)CmdDrawMeshTasksIndirectCountNV},
+    {"vkWaitForFences", 15, 0xe7c2c7dcu, (void*)WaitForFences},
+    {"vkMergeValidationCachesEXT", 26, 0x6d50d069u, (void*)MergeValidationCachesEXT},
+    {"vkCmdClearColorImage", 20, 0x146f399bu, (void*)CmdClearColorImage},
+    {"vkDestroyDescriptorUpdateTemplate", 33, 0x8769c7c2u, (void*)DestroyDescriptorUpdateTemplate},
+    {"vkCmdDispatchBase", 17, 0x95d77705u, (void*)CmdDispatchBase},
+    {"vkCmdBeginRenderPass2KHR", 24, 0x13c1d8dbu, (void*)CmdBeginRenderPass2KHR},
+    {"vkSetEvent", 10, 0xa73c166au, (void*)SetEvent},
+    {"vkGetImageDrmFormatModifierPropertiesEXT", 40, 0xe442e9b6u, (void*)GetImageDrmFormatModifierPropertiesEXT},
+    {"vkCmdSetLineWidth", 17, 0x89505460u, (void*)CmdSetLineWidth},
+    {"vkGetImageSparseMemoryRequirements2", 35, 0xd207cb22u, (void*)GetImageSparseMemoryRequirements2},
+    {"vkCmdDrawMeshTasksNV", 20, 0x1dac242du, (void*)CmdDrawMeshTasksNV},
+    {"vkCmdSetPerformanceStreamMarkerINTEL", 36, 0x3520d412u, (void*)CmdSetPerformanceStreamMarkerINTEL},
+    {"vkQueueBeginDebugUtilsLabelEXT", 30, 0x46b78797u, (void*)QueueBeginDebugUtilsLabelEXT},
+    {"vkCmdDebugMarkerEndEXT", 22, 0x362846c3u, (void*)CmdDebugMarkerEndEXT},
+    {"vkReleasePerformanceConfigurationINTEL", 38, 0x9c935fddu, (void*)ReleasePerformanceConfigurationINTEL},
+    {"vkCmdSetLineStippleEXT", 22, 0x7c80d680u, (void*)CmdSetLineStippleEXT},
+    {"vkCmdDrawIndirectCountAMD", 25, 0xf2cb30b5u, (void*)CmdDrawIndirectCountAMD},
+    {"vkCmdInsertDebugUtilsLabelEXT", 29, 0x95502ba6u, (void*)CmdInsertDebugUtilsLabelEXT},
+    {"vkGetDisplayPlaneCapabilities2KHR", 33, 0x04443eb1u, (void*)GetDisplayPlaneCapabilities2KHR},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetPhysicalDeviceProperties", 29, 0x89b3ebbcu, (void*)GetPhysicalDeviceProperties},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetPhysicalDeviceSurfacePresentModesKHR", 41, 0x053316e0u, (void*)GetPhysicalDeviceSurfacePresentModesKHR},
+    {"vkAcquirePerformanceConfigurationINTEL", 38, 0x7cbef10au, (void*)AcquirePerformanceConfigurationINTEL},
+    {nullptr, 0, 0, nullptr},
+    {"vkDestroyDescriptorSetLayout", 28, 0x123433f5u, (void*)DestroyDescriptorSetLayout},
+    {"vkGetPipelineExecutableStatisticsKHR", 36, 0x3e749262u, (void*)GetPipelineExecutableStatisticsKHR},
+    {"vkCreateQueryPool", 17, 0x0a03b3a4u, (void*)CreateQueryPool},
+    {"vkCmdDrawIndexedIndirectCount", 29, 0x570f1d66u, (void*)CmdDrawIndexedIndirectCount},
+    {nullptr, 0, 0, nullptr},
+    {"vkCreateDisplayModeKHR", 22, 0x69d6694eu, (void*)CreateDisplayModeKHR},
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkGetMemoryWin32HandlePropertiesKHR", 35, 0x3fd1754au, (void*)GetMemoryWin32HandlePropertiesKHR},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_ANDROID_KHR
-    {"vkCreateAndroidSurfaceKHR", (void*)CreateAndroidSurfaceKHR},
+    {"vkGetPhysicalDeviceSparseImageFormatProperties2", 47, 0xb2cd0dd6u, (void*)GetPhysicalDeviceSparseImageFormatProperties2},
+    {nullptr, 0, 0, nullptr},
+    {"vkCreateComputePipelines", 24, 0xc45193c6u, (void*)CreateComputePipelines},
+    {"vkWaitSemaphoresKHR", 19, 0x0b86bd93u, (void*)WaitSemaphoresKHR},
+    {nullptr, 0, 0, nullptr},
+    {"vkSetLocalDimmingAMD", 20, 0xfb6098ceu, (void*)SetLocalDimmingAMD},
+    {nullptr, 0, 0, nullptr},
+    {"vkCreateSampler", 15, 0x5d12d31eu, (void*)CreateSampler},
+    {"vkRegisterDeviceEventEXT", 24, 0x2effdcc2u, (void*)RegisterDeviceEventEXT},
+    {nullptr, 0, 0, nullptr},
+    {"vkUpdateDescriptorSetWithTemplateKHR", 36, 0xdecdb927u, (void*)UpdateDescriptorSetWithTemplateKHR},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetDeviceGroupPeerMemoryFeatures", 34, 0xf5a1feb7u, (void*)GetDeviceGroupPeerMemoryFeatures},
+    {"vkDestroySamplerYcbcrConversion", 31, 0x8b04a087u, (void*)DestroySamplerYcbcrConversion},
+    {"vkGetPhysicalDeviceCalibrateableTimeDomainsEXT", 46, 0x3eabd5a3u, (void*)GetPhysicalDeviceCalibrateableTimeDomainsEXT},
+    {"vkCmdSetDeviceMaskKHR", 21, 0xcf5f61a3u, (void*)CmdSetDeviceMaskKHR},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetShaderInfoAMD", 18, 0xd29bd973u, (void*)GetShaderInfoAMD},
+    {"vkBeginCommandBuffer", 20, 0x38f0e672u, (void*)BeginCommandBuffer},
+    {"vkResetQueryPool", 16, 0x4f91a755u, (void*)ResetQueryPool},
+    {"vkGetDescriptorSetLayoutSupport", 31, 0xfd510f82u, (void*)GetDescriptorSetLayoutSupport},
+    {"vkCmdBindTransformFeedbackBuffersEXT", 36, 0xc5148846u, (void*)CmdBindTransformFeedbackBuffersEXT},
+    {nullptr, 0, 0, nullptr},
+    {"vkBindImageMemory2KHR", 21, 0x8ee1dbecu, (void*)BindImageMemory2KHR},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkBindBufferMemory2", 19, 0x43784012u, (void*)BindBufferMemory2},
+    {"vkCmdDrawIndexedIndirectCountAMD", 32, 0x6b4245f4u, (void*)CmdDrawIndexedIndirectCountAMD},
+    {"vkGetSemaphoreCounterValueKHR", 29, 0x198479b0u, (void*)GetSemaphoreCounterValueKHR},
+    {"vkGetPhysicalDeviceProperties2", 30, 0x543bd08au, (void*)GetPhysicalDeviceProperties2},
+    {"vkGetPhysicalDeviceCooperativeMatrixPropertiesNV", 48, 0x35f7976cu, (void*)GetPhysicalDeviceCooperativeMatrixPropertiesNV},
+    {"vkCmdEndTransformFeedbackEXT", 28, 0x026d39e9u, (void*)CmdEndTransformFeedbackEXT},
+    {"vkCreateDisplayPlaneSurfaceKHR", 30, 0x52b1d5f8u, (void*)CreateDisplayPlaneSurfaceKHR},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetDeviceMemoryOpaqueCaptureAddressKHR", 40, 0x876c582du, (void*)GetDeviceMemoryOpaqueCaptureAddressKHR},
+    {"vkCreateEvent", 13, 0x42b3f55eu, (void*)CreateEvent},
+    {"vkCreateFramebuffer", 19, 0x8c0b3c69u, (void*)CreateFramebuffer},
+    {"vkDestroyCommandPool", 20, 0x46d07137u, (void*)DestroyCommandPool},
+    {nullptr, 0, 0, nullptr},
+    {"vkDestroyBuffer", 15, 0x8b9013b2u, (void*)DestroyBuffer},
+    {"vkCreateRayTracingPipelinesNV", 29, 0x30a351a3u, (void*)CreateRayTracingPipelinesNV},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdNextSubpass2", 17, 0x115b3e30u, (void*)CmdNextSubpass2},
+    {"vkCreateIndirectCommandsLayoutNVX", 33, 0xe996b9f0u, (void*)CreateIndirectCommandsLayoutNVX},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetPhysicalDeviceDisplayPlanePropertiesKHR", 44, 0x3a0aabcfu, (void*)GetPhysicalDeviceDisplayPlanePropertiesKHR},
+    {"vkCreateDescriptorSetLayout", 27, 0x452f43a7u, (void*)CreateDescriptorSetLayout},
+    {"vkCmdCopyImageToBuffer", 22, 0x0220566fu, (void*)CmdCopyImageToBuffer},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdDraw", 9, 0xa9fdc2c0u, (void*)CmdDraw},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetImageSparseMemoryRequirements2KHR", 38, 0xab26e3f1u, (void*)GetImageSparseMemoryRequirements2KHR},
+    {"vkCmdWriteBufferMarkerAMD", 25, 0x5f238d75u, (void*)CmdWriteBufferMarkerAMD},
+    {nullptr, 0, 0, nullptr},
+    {"vkCreateDescriptorUpdateTemplate", 32, 0xdde2a868u, (void*)CreateDescriptorUpdateTemplate},
+#ifdef VK_USE_PLATFORM_GGP
+    {"vkCreateStreamDescriptorSurfaceGGP", 34, 0xe8296450u, (void*)CreateStreamDescriptorSurfaceGGP},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
+    {"vkGetDeviceQueue", 16, 0x0ef70c2bu, (void*)GetDeviceQueue},
+    {"vkImportFenceFdKHR", 18, 0xdc1dfab5u, (void*)ImportFenceFdKHR},
+    {"vkGetImageViewHandleNVX", 23, 0xe19409e8u, (void*)GetImageViewHandleNVX},
+    {"vkCmdEndRenderPass2KHR", 22, 0x77f38a73u, (void*)CmdEndRenderPass2KHR},
+    {"vkEnumerateInstanceLayerProperties", 34, 0xe844b6e5u, (void*)EnumerateInstanceLayerProperties},
+    {"vkCmdSetViewportShadingRatePaletteNV", 36, 0x315e890fu, (void*)CmdSetViewportShadingRatePaletteNV},
 #ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkCreateWin32SurfaceKHR", (void*)CreateWin32SurfaceKHR},
+    {"vkImportFenceWin32HandleKHR", 27, 0xf6d01c8cu, (void*)ImportFenceWin32HandleKHR},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
+    {"vkCmdExecuteCommands", 20, 0xf5f7e073u, (void*)CmdExecuteCommands},
+    {"vkCmdBeginConditionalRenderingEXT", 33, 0xa200aefau, (void*)CmdBeginConditionalRenderingEXT},
 #ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetPhysicalDeviceWin32PresentationSupportKHR", (void*)GetPhysicalDeviceWin32PresentationSupportKHR},
+    {"vkGetFenceWin32HandleKHR", 24, 0x3fb4717bu, (void*)GetFenceWin32HandleKHR},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-    {"vkGetPhysicalDeviceFeatures2KHR", (void*)GetPhysicalDeviceFeatures2KHR},
-    {"vkGetPhysicalDeviceProperties2KHR", (void*)GetPhysicalDeviceProperties2KHR},
-    {"vkGetPhysicalDeviceFormatProperties2KHR", (void*)GetPhysicalDeviceFormatProperties2KHR},
-    {"vkGetPhysicalDeviceImageFormatProperties2KHR", (void*)GetPhysicalDeviceImageFormatProperties2KHR},
-    {"vkGetPhysicalDeviceQueueFamilyProperties2KHR", (void*)GetPhysicalDeviceQueueFamilyProperties2KHR},
-    {"vkGetPhysicalDeviceMemoryProperties2KHR", (void*)GetPhysicalDeviceMemoryProperties2KHR},
-    {"vkGetPhysicalDeviceSparseImageFormatProperties2KHR", (void*)GetPhysicalDeviceSparseImageFormatProperties2KHR},
-    {"vkGetDeviceGroupPeerMemoryFeaturesKHR", (void*)GetDeviceGroupPeerMemoryFeaturesKHR},
-    {"vkCmdSetDeviceMaskKHR", (void*)CmdSetDeviceMaskKHR},
-    {"vkCmdDispatchBaseKHR", (void*)CmdDispatchBaseKHR},
-    {"vkTrimCommandPoolKHR", (void*)TrimCommandPoolKHR},
-    {"vkEnumeratePhysicalDeviceGroupsKHR", (void*)EnumeratePhysicalDeviceGroupsKHR},
-    {"vkGetPhysicalDeviceExternalBufferPropertiesKHR", (void*)GetPhysicalDeviceExternalBufferPropertiesKHR},
+    {"vkCmdEndDebugUtilsLabelEXT", 26, 0x8cc22c12u, (void*)CmdEndDebugUtilsLabelEXT},
+    {"vkUpdateDescriptorSetWithTemplate", 33, 0xe9650ec4u, (void*)UpdateDescriptorSetWithTemplate},
+    {"vkGetSwapchainStatusKHR", 23, 0x5596f083u, (void*)GetSwapchainStatusKHR},
+    {nullptr, 0, 0, nullptr},
+    {"vkQueueEndDebugUtilsLabelEXT", 28, 0x6aea05b3u, (void*)QueueEndDebugUtilsLabelEXT},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdWriteAccelerationStructuresPropertiesNV", 44, 0xe06f0976u, (void*)CmdWriteAccelerationStructuresPropertiesNV},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetPipelineExecutablePropertiesKHR", 36, 0xffdef8d8u, (void*)GetPipelineExecutablePropertiesKHR},
 #ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetMemoryWin32HandleKHR", (void*)GetMemoryWin32HandleKHR},
+    {"vkGetMemoryWin32HandleKHR", 25, 0xa63e7441u, (void*)GetMemoryWin32HandleKHR},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetMemoryWin32HandlePropertiesKHR", (void*)GetMemoryWin32HandlePropertiesKHR},
+    {"vkDestroySurfaceKHR", 19, 0xb6ddcf76u, (void*)DestroySurfaceKHR},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkQueueBindSparse", 17, 0xe4d99d8eu, (void*)QueueBindSparse},
+    {nullptr, 0, 0, nullptr},
+    {"vkSubmitDebugUtilsMessageEXT", 28, 0xdcfcdff8u, (void*)SubmitDebugUtilsMessageEXT},
+    {"vkCmdResetEvent", 15, 0x7231a513u, (void*)CmdResetEvent},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkDestroyRenderPass", 19, 0x235b7d71u, (void*)DestroyRenderPass},
+    {nullptr, 0, 0, nullptr},
+#ifdef VK_USE_PLATFORM_WAYLAND_KHR
+    {"vkGetPhysicalDeviceWaylandPresentationSupportKHR", 48, 0x03c486dbu, (void*)GetPhysicalDeviceWaylandPresentationSupportKHR},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-    {"vkGetMemoryFdKHR", (void*)GetMemoryFdKHR},
-    {"vkGetMemoryFdPropertiesKHR", (void*)GetMemoryFdPropertiesKHR},
-    {"vkGetPhysicalDeviceExternalSemaphorePropertiesKHR", (void*)GetPhysicalDeviceExternalSemaphorePropertiesKHR},
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkImportSemaphoreWin32HandleKHR", (void*)ImportSemaphoreWin32HandleKHR},
+    {"vkCmdSetDepthBias", 17, 0x9da9f23eu, (void*)CmdSetDepthBias},
+    {nullptr, 0, 0, nullptr},
+    {"vkCreateObjectTableNVX", 22, 0xcd5f95e1u, (void*)CreateObjectTableNVX},
+    {"vkCreateSharedSwapchainsKHR", 27, 0x9a79abe5u, (void*)CreateSharedSwapchainsKHR},
+    {"vkGetPhysicalDeviceQueueFamilyProperties2KHR", 44, 0xde6711d4u, (void*)GetPhysicalDeviceQueueFamilyProperties2KHR},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdBuildAccelerationStructureNV", 33, 0xb2f111c7u, (void*)CmdBuildAccelerationStructureNV},
+    {"vkGetQueryPoolResults", 21, 0x300fc14au, (void*)GetQueryPoolResults},
+    {"vkBindImageMemory2", 18, 0x1bb3d295u, (void*)BindImageMemory2},
+    {"vkDestroyQueryPool", 18, 0xfc8c9742u, (void*)DestroyQueryPool},
+    {"vkReleaseDisplayEXT", 19, 0x8a28db5au, (void*)ReleaseDisplayEXT},
+    {"vkCmdNextSubpass2KHR", 20, 0x4d9f6ddbu, (void*)CmdNextSubpass2KHR},
+    {"vkGetPhysicalDeviceSurfaceFormats2KHR", 37, 0x4ab902a1u, (void*)GetPhysicalDeviceSurfaceFormats2KHR},
+    {"vkCmdPushDescriptorSetKHR", 25, 0x3339de70u, (void*)CmdPushDescriptorSetKHR},
+    {"vkCmdCopyImage", 14, 0x7bf994f0u, (void*)CmdCopyImage},
+    {"vkGetDisplayModeProperties2KHR", 30, 0xd45a062bu, (void*)GetDisplayModeProperties2KHR},
+    {"vkCreateDescriptorUpdateTemplateKHR", 35, 0xa4f4fd03u, (void*)CreateDescriptorUpdateTemplateKHR},
+    {"vkCreatePipelineLayout", 22, 0xaffa89a2u, (void*)CreatePipelineLayout},
+    {"vkCmdBeginRenderPass2", 21, 0x93149f30u, (void*)CmdBeginRenderPass2},
+    {"vkCmdBeginTransformFeedbackEXT", 30, 0xf8339c31u, (void*)CmdBeginTransformFeedbackEXT},
+    {"vkCmdCopyQueryPoolResults", 25, 0xb2cd2b3fu, (void*)CmdCopyQueryPoolResults},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkDestroyAccelerationStructureNV", 32, 0xe40f2851u, (void*)DestroyAccelerationStructureNV},
+    {"vkCmdEndRenderPass", 18, 0xeb0917fau, (void*)CmdEndRenderPass},
+    {"vkCmdSetExclusiveScissorNV", 26, 0xd9937028u, (void*)CmdSetExclusiveScissorNV},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+#ifdef VK_USE_PLATFORM_ANDROID_KHR
+    {"vkCreateAndroidSurfaceKHR", 25, 0xcf49a6dbu, (void*)CreateAndroidSurfaceKHR},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetSemaphoreWin32HandleKHR", (void*)GetSemaphoreWin32HandleKHR},
+    {"vkCmdCopyBuffer", 15, 0x54db4621u, (void*)CmdCopyBuffer},
+    {"vkGetPhysicalDeviceMemoryProperties2KHR", 39, 0xd744d3deu, (void*)GetPhysicalDeviceMemoryProperties2KHR},
+    {"vkCmdEndRenderPass2", 19, 0xc7506fd8u, (void*)CmdEndRenderPass2},
+    {"vkGetEventStatus", 16, 0x66007620u, (void*)GetEventStatus},
+    {nullptr, 0, 0, nullptr},
+#ifdef VK_USE_PLATFORM_IOS_MVK
+    {"vkCreateIOSSurfaceMVK", 21, 0x95d2c6aau, (void*)CreateIOSSurfaceMVK},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-    {"vkImportSemaphoreFdKHR", (void*)ImportSemaphoreFdKHR},
-    {"vkGetSemaphoreFdKHR", (void*)GetSemaphoreFdKHR},
-    {"vkCmdPushDescriptorSetKHR", (void*)CmdPushDescriptorSetKHR},
-    {"vkCmdPushDescriptorSetWithTemplateKHR", (void*)CmdPushDescriptorSetWithTemplateKHR},
-    {"vkCreateDescriptorUpdateTemplateKHR", (void*)CreateDescriptorUpdateTemplateKHR},
-    {"vkDestroyDescriptorUpdateTemplateKHR", (void*)DestroyDescriptorUpdateTemplateKHR},
-    {"vkUpdateDescriptorSetWithTemplateKHR", (void*)UpdateDescriptorSetWithTemplateKHR},
-    {"vkCreateRenderPass2KHR", (void*)CreateRenderPass2KHR},
-    {"vkCmdBeginRenderPass2KHR", (void*)CmdBeginRenderPass2KHR},
-    {"vkCmdNextSubpass2KHR", (void*)CmdNextSubpass2KHR},
-    {"vkCmdEndRenderPass2KHR", (void*)CmdEndRenderPass2KHR},
-    {"vkGetSwapchainStatusKHR", (void*)GetSwapchainStatusKHR},
-    {"vkGetPhysicalDeviceExternalFencePropertiesKHR", (void*)GetPhysicalDeviceExternalFencePropertiesKHR},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetImageSparseMemoryRequirements", 34, 0x0f6505a4u, (void*)GetImageSparseMemoryRequirements},
+    {"vkDeviceWaitIdle", 16, 0xd8f8605fu, (void*)DeviceWaitIdle},
+    {"vkCmdSetPerformanceOverrideINTEL", 32, 0xf39c2628u, (void*)CmdSetPerformanceOverrideINTEL},
+    {"vkCreateSemaphore", 17, 0xd9b8366cu, (void*)CreateSemaphore},
+    {"vkCmdBindIndexBuffer", 20, 0xf1ac7a71u, (void*)CmdBindIndexBuffer},
+    {"vkCmdSetCoarseSampleOrderNV", 27, 0xd826e0a7u, (void*)CmdSetCoarseSampleOrderNV},
+    {"vkCreateShaderModule", 20, 0x6f596ac7u, (void*)CreateShaderModule},
+    {"vkGetDisplayModePropertiesKHR", 29, 0x26193941u, (void*)GetDisplayModePropertiesKHR},
+    {"vkGetImageSubresourceLayout", 27, 0x3bb2e87du, (void*)GetImageSubresourceLayout},
+    {"vkResetCommandBuffer", 20, 0x6ee4b1d0u, (void*)ResetCommandBuffer},
+    {"vkDebugMarkerSetObjectTagEXT", 28, 0x5a37c8bdu, (void*)DebugMarkerSetObjectTagEXT},
+    {"vkCmdDebugMarkerInsertEXT", 25, 0x8cb31949u, (void*)CmdDebugMarkerInsertEXT},
+    {"vkCmdProcessCommandsNVX", 23, 0x3ad5456bu, (void*)CmdProcessCommandsNVX},
+    {"vkCreateDebugUtilsMessengerEXT", 30, 0x38a91304u, (void*)CreateDebugUtilsMessengerEXT},
+    {"vkCreateBufferView", 18, 0x11b7e8d5u, (void*)CreateBufferView},
+    {"vkCmdCopyAccelerationStructureNV", 32, 0x2df19290u, (void*)CmdCopyAccelerationStructureNV},
+    {"vkDestroyObjectTableNVX", 23, 0xcc0a23ebu, (void*)DestroyObjectTableNVX},
+    {"vkGetQueueCheckpointDataNV", 26, 0x274abca7u, (void*)GetQueueCheckpointDataNV},
+    {"vkGetAccelerationStructureHandleNV", 34, 0x0da9ca8du, (void*)GetAccelerationStructureHandleNV},
+    {"vkGetPhysicalDeviceFeatures2KHR", 31, 0x8682cc23u, (void*)GetPhysicalDeviceFeatures2KHR},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetPhysicalDeviceSurfaceSupportKHR", 36, 0xa03a0fa6u, (void*)GetPhysicalDeviceSurfaceSupportKHR},
+    {"vkCmdClearDepthStencilImage", 27, 0x13bc9e59u, (void*)CmdClearDepthStencilImage},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkCreateSwapchainKHR", 20, 0x02e2db2du, (void*)CreateSwapchainKHR},
+    {"vkGetDeviceGroupPeerMemoryFeaturesKHR", 37, 0x3cdaa412u, (void*)GetDeviceGroupPeerMemoryFeaturesKHR},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkCreateRenderPass2KHR", 22, 0xc11e93aau, (void*)CreateRenderPass2KHR},
 #ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkImportFenceWin32HandleKHR", (void*)ImportFenceWin32HandleKHR},
+    {"vkGetMemoryWin32HandleNV", 24, 0x73543d06u, (void*)GetMemoryWin32HandleNV},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
+    {nullptr, 0, 0, nullptr},
+    {"vkCompileDeferredNV", 19, 0x730a5d24u, (void*)CompileDeferredNV},
+    {"vkCreateDevice", 14, 0x87b9b4e4u, (void*)CreateDevice},
+    {"vkBindImageMemory", 17, 0xb59c1405u, (void*)BindImageMemory},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkSignalSemaphore", 17, 0x307d1a20u, (void*)SignalSemaphore},
+    {"vkGetDeviceGroupSurfacePresentModesKHR", 38, 0xc17bfaceu, (void*)GetDeviceGroupSurfacePresentModesKHR},
+    {"vkCreateSamplerYcbcrConversion", 30, 0xf850dd41u, (void*)CreateSamplerYcbcrConversion},
+    {"vkCmdUpdateBuffer", 17, 0x4cafab95u, (void*)CmdUpdateBuffer},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetSwapchainCounterEXT", 24, 0x302569e5u, (void*)GetSwapchainCounterEXT},
+    {nullptr, 0, 0, nullptr},
+    {"vkEnumerateDeviceExtensionProperties", 36, 0x53cd225eu, (void*)EnumerateDeviceExtensionProperties},
+    {"vkMergePipelineCaches", 21, 0xc71137ebu, (void*)MergePipelineCaches},
 #ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetFenceWin32HandleKHR", (void*)GetFenceWin32HandleKHR},
+    {"vkGetPhysicalDeviceWin32PresentationSupportKHR", 46, 0x95d2d4d6u, (void*)GetPhysicalDeviceWin32PresentationSupportKHR},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-    {"vkImportFenceFdKHR", (void*)ImportFenceFdKHR},
-    {"vkGetFenceFdKHR", (void*)GetFenceFdKHR},
-    {"vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR", (void*)EnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR},
-    {"vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR", (void*)GetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR},
-    {"vkAcquireProfilingLockKHR", (void*)AcquireProfilingLockKHR},
-    {"vkReleaseProfilingLockKHR", (void*)ReleaseProfilingLockKHR},
-    {"vkGetPhysicalDeviceSurfaceCapabilities2KHR", (void*)GetPhysicalDeviceSurfaceCapabilities2KHR},
-    {"vkGetPhysicalDeviceSurfaceFormats2KHR", (void*)GetPhysicalDeviceSurfaceFormats2KHR},
-    {"vkGetPhysicalDeviceDisplayProperties2KHR", (void*)GetPhysicalDeviceDisplayProperties2KHR},
-    {"vkGetPhysicalDeviceDisplayPlaneProperties2KHR", (void*)GetPhysicalDeviceDisplayPlaneProperties2KHR},
-    {"vkGetDisplayModeProperties2KHR", (void*)GetDisplayModeProperties2KHR},
-    {"vkGetDisplayPlaneCapabilities2KHR", (void*)GetDisplayPlaneCapabilities2KHR},
-    {"vkGetImageMemoryRequirements2KHR", (void*)GetImageMemoryRequirements2KHR},
-    {"vkGetBufferMemoryRequirements2KHR", (void*)GetBufferMemoryRequirements2KHR},
-    {"vkGetImageSparseMemoryRequirements2KHR", (void*)GetImageSparseMemoryRequirements2KHR},
-    {"vkCreateSamplerYcbcrConversionKHR", (void*)CreateSamplerYcbcrConversionKHR},
-    {"vkDestroySamplerYcbcrConversionKHR", (void*)DestroySamplerYcbcrConversionKHR},
-    {"vkBindBufferMemory2KHR", (void*)BindBufferMemory2KHR},
-    {"vkBindImageMemory2KHR", (void*)BindImageMemory2KHR},
-    {"vkGetDescriptorSetLayoutSupportKHR", (void*)GetDescriptorSetLayoutSupportKHR},
-    {"vkCmdDrawIndirectCountKHR", (void*)CmdDrawIndirectCountKHR},
-    {"vkCmdDrawIndexedIndirectCountKHR", (void*)CmdDrawIndexedIndirectCountKHR},
-    {"vkGetSemaphoreCounterValueKHR", (void*)GetSemaphoreCounterValueKHR},
-    {"vkWaitSemaphoresKHR", (void*)WaitSemaphoresKHR},
-    {"vkSignalSemaphoreKHR", (void*)SignalSemaphoreKHR},
-    {"vkGetBufferDeviceAddressKHR", (void*)GetBufferDeviceAddressKHR},
-    {"vkGetBufferOpaqueCaptureAddressKHR", (void*)GetBufferOpaqueCaptureAddressKHR},
-    {"vkGetDeviceMemoryOpaqueCaptureAddressKHR", (void*)GetDeviceMemoryOpaqueCaptureAddressKHR},
-    {"vkGetPipelineExecutablePropertiesKHR", (void*)GetPipelineExecutablePropertiesKHR},
-    {"vkGetPipelineExecutableStatisticsKHR", (void*)GetPipelineExecutableStatisticsKHR},
-    {"vkGetPipelineExecutableInternalRepresentationsKHR", (void*)GetPipelineExecutableInternalRepresentationsKHR},
-    {"vkCreateDebugReportCallbackEXT", (void*)CreateDebugReportCallbackEXT},
-    {"vkDestroyDebugReportCallbackEXT", (void*)DestroyDebugReportCallbackEXT},
-    {"vkDebugReportMessageEXT", (void*)DebugReportMessageEXT},
-    {"vkDebugMarkerSetObjectTagEXT", (void*)DebugMarkerSetObjectTagEXT},
-    {"vkDebugMarkerSetObjectNameEXT", (void*)DebugMarkerSetObjectNameEXT},
-    {"vkCmdDebugMarkerBeginEXT", (void*)CmdDebugMarkerBeginEXT},
-    {"vkCmdDebugMarkerEndEXT", (void*)CmdDebugMarkerEndEXT},
-    {"vkCmdDebugMarkerInsertEXT", (void*)CmdDebugMarkerInsertEXT},
-    {"vkCmdBindTransformFeedbackBuffersEXT", (void*)CmdBindTransformFeedbackBuffersEXT},
-    {"vkCmdBeginTransformFeedbackEXT", (void*)CmdBeginTransformFeedbackEXT},
-    {"vkCmdEndTransformFeedbackEXT", (void*)CmdEndTransformFeedbackEXT},
-    {"vkCmdBeginQueryIndexedEXT", (void*)CmdBeginQueryIndexedEXT},
-    {"vkCmdEndQueryIndexedEXT", (void*)CmdEndQueryIndexedEXT},
-    {"vkCmdDrawIndirectByteCountEXT", (void*)CmdDrawIndirectByteCountEXT},
-    {"vkGetImageViewHandleNVX", (void*)GetImageViewHandleNVX},
-    {"vkCmdDrawIndirectCountAMD", (void*)CmdDrawIndirectCountAMD},
-    {"vkCmdDrawIndexedIndirectCountAMD", (void*)CmdDrawIndexedIndirectCountAMD},
-    {"vkGetShaderInfoAMD", (void*)GetShaderInfoAMD},
-#ifdef VK_USE_PLATFORM_GGP
-    {"vkCreateStreamDescriptorSurfaceGGP", (void*)CreateStreamDescriptorSurfaceGGP},
+    {"vkResetFences", 13, 0xdbb395d3u, (void*)ResetFences},
+#ifdef VK_USE_PLATFORM_ANDROID_KHR
+    {"vkGetMemoryAndroidHardwareBufferANDROID", 39, 0x3e53800du, (void*)GetMemoryAndroidHardwareBufferANDROID},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-    {"vkGetPhysicalDeviceExternalImageFormatPropertiesNV", (void*)GetPhysicalDeviceExternalImageFormatPropertiesNV},
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetMemoryWin32HandleNV", (void*)GetMemoryWin32HandleNV},
+    {"vkGetPhysicalDeviceDisplayPropertiesKHR", 39, 0x9fb1685fu, (void*)GetPhysicalDeviceDisplayPropertiesKHR},
+    {"vkAllocateDescriptorSets", 24, 0x14a3b709u, (void*)AllocateDescriptorSets},
+    {"vkCmdBlitImage", 14, 0xef654202u, (void*)CmdBlitImage},
+    {"vkCmdBindShadingRateImageNV", 27, 0x2c3dec58u, (void*)CmdBindShadingRateImageNV},
+    {"vkCmdPipelineBarrier", 20, 0x0223af53u, (void*)CmdPipelineBarrier},
+    {nullptr, 0, 0, nullptr},
+    {"vkImportSemaphoreFdKHR", 22, 0xc07a1bd8u, (void*)ImportSemaphoreFdKHR},
+    {"vkDestroySwapchainKHR", 21, 0x93dc4e6bu, (void*)DestroySwapchainKHR},
+    {"vkGetMemoryHostPointerPropertiesEXT", 35, 0x21c55ba0u, (void*)GetMemoryHostPointerPropertiesEXT},
+    {"vkGetPhysicalDeviceDisplayProperties2KHR", 40, 0x5ef41a99u, (void*)GetPhysicalDeviceDisplayProperties2KHR},
+    {"vkEnumeratePhysicalDeviceGroupsKHR", 34, 0xd9a7ffcau, (void*)EnumeratePhysicalDeviceGroupsKHR},
+    {"vkAcquireNextImage2KHR", 22, 0x5d051cb5u, (void*)AcquireNextImage2KHR},
+    {"vkCmdDrawMeshTasksIndirectNV", 28, 0xec7d509fu, (void*)CmdDrawMeshTasksIndirectNV},
+    {"vkCreateRenderPass", 18, 0xe75b2217u, (void*)CreateRenderPass},
+#ifdef VK_USE_PLATFORM_METAL_EXT
+    {"vkCreateMetalSurfaceEXT", 23, 0x1a562643u, (void*)CreateMetalSurfaceEXT},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_VI_NN
-    {"vkCreateViSurfaceNN", (void*)CreateViSurfaceNN},
+    {"vkGetPhysicalDeviceImageFormatProperties2KHR", 44, 0xca8ffcbdu, (void*)GetPhysicalDeviceImageFormatProperties2KHR},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkCreateValidationCacheEXT", 26, 0x6b0b7d18u, (void*)CreateValidationCacheEXT},
+    {nullptr, 0, 0, nullptr},
+    {"vkDestroyDescriptorPool", 23, 0x752f3e6fu, (void*)DestroyDescriptorPool},
+    {"vkDestroyInstance", 17, 0xa64dcfc3u, (void*)DestroyInstance},
+    {"vkGetBufferOpaqueCaptureAddressKHR", 34, 0x00727514u, (void*)GetBufferOpaqueCaptureAddressKHR},
+    {"vkGetPhysicalDeviceQueueFamilyProperties", 40, 0x3d926eedu, (void*)GetPhysicalDeviceQueueFamilyProperties},
+    {nullptr, 0, 0, nullptr},
+    {"vkUpdateDescriptorSets", 22, 0x13d7722fu, (void*)UpdateDescriptorSets},
+    {"vkCmdDispatchIndirect", 21, 0x6d599ab6u, (void*)CmdDispatchIndirect},
+    {"vkInvalidateMappedMemoryRanges", 30, 0x242f4435u, (void*)InvalidateMappedMemoryRanges},
+    {"vkGetRefreshCycleDurationGOOGLE", 31, 0x277dc056u, (void*)GetRefreshCycleDurationGOOGLE},
+    {"vkEnumerateInstanceExtensionProperties", 38, 0xc3a1c67du, (void*)EnumerateInstanceExtensionProperties},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkDisplayPowerControlEXT", 24, 0xf97f8b25u, (void*)DisplayPowerControlEXT},
+    {"vkEndCommandBuffer", 18, 0xcf8708eau, (void*)EndCommandBuffer},
+    {"vkCmdSetCheckpointNV", 20, 0x4e5fa984u, (void*)CmdSetCheckpointNV},
+    {"vkEnumeratePhysicalDevices", 26, 0x09612094u, (void*)EnumeratePhysicalDevices},
+    {"vkCreateCommandPool", 19, 0x1d0cde71u, (void*)CreateCommandPool},
+    {"vkCmdReserveSpaceForCommandsNVX", 31, 0x2fd0407bu, (void*)CmdReserveSpaceForCommandsNVX},
+    {"vkDestroyEvent", 14, 0x624815e0u, (void*)DestroyEvent},
+#ifdef VK_USE_PLATFORM_XCB_KHR
+    {"vkCreateXcbSurfaceKHR", 21, 0xcc9223c9u, (void*)CreateXcbSurfaceKHR},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-    {"vkCmdBeginConditionalRenderingEXT", (void*)CmdBeginConditionalRenderingEXT},
-    {"vkCmdEndConditionalRenderingEXT", (void*)CmdEndConditionalRenderingEXT},
-    {"vkCmdProcessCommandsNVX", (void*)CmdProcessCommandsNVX},
-    {"vkCmdReserveSpaceForCommandsNVX", (void*)CmdReserveSpaceForCommandsNVX},
-    {"vkCreateIndirectCommandsLayoutNVX", (void*)CreateIndirectCommandsLayoutNVX},
-    {"vkDestroyIndirectCommandsLayoutNVX", (void*)DestroyIndirectCommandsLayoutNVX},
-    {"vkCreateObjectTableNVX", (void*)CreateObjectTableNVX},
-    {"vkDestroyObjectTableNVX", (void*)DestroyObjectTableNVX},
-    {"vkRegisterObjectsNVX", (void*)RegisterObjectsNVX},
-    {"vkUnregisterObjectsNVX", (void*)UnregisterObjectsNVX},
-    {"vkGetPhysicalDeviceGeneratedCommandsPropertiesNVX", (void*)GetPhysicalDeviceGeneratedCommandsPropertiesNVX},
-    {"vkCmdSetViewportWScalingNV", (void*)CmdSetViewportWScalingNV},
-    {"vkReleaseDisplayEXT", (void*)ReleaseDisplayEXT},
-#ifdef VK_USE_PLATFORM_XLIB_XRANDR_EXT
-    {"vkAcquireXlibDisplayEXT", (void*)AcquireXlibDisplayEXT},
+    {"vkSetHdrMetadataEXT", 19, 0x04d97c94u, (void*)SetHdrMetadataEXT},
+    {"vkGetPhysicalDeviceSparseImageFormatProperties", 46, 0x763c38a0u, (void*)GetPhysicalDeviceSparseImageFormatProperties},
+    {"vkGetDeviceGroupPresentCapabilitiesKHR", 38, 0xcb70534bu, (void*)GetDeviceGroupPresentCapabilitiesKHR},
+    {"vkGetPhysicalDeviceFormatProperties2KHR", 39, 0xd4b09a32u, (void*)GetPhysicalDeviceFormatProperties2KHR},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkEnumerateDeviceLayerProperties", 32, 0xa37d674au, (void*)EnumerateDeviceLayerProperties},
+    {"vkDestroySamplerYcbcrConversionKHR", 34, 0xd8c4ae62u, (void*)DestroySamplerYcbcrConversionKHR},
+    {"vkGetPhysicalDeviceMultisamplePropertiesEXT", 43, 0x84f1eedcu, (void*)GetPhysicalDeviceMultisamplePropertiesEXT},
+    {"vkCreateInstance", 16, 0xf61c845du, (void*)CreateInstance},
+    {"vkGetPhysicalDeviceMemoryProperties2", 36, 0xd027e2abu, (void*)GetPhysicalDeviceMemoryProperties2},
+    {"vkCreateBuffer", 14, 0x507f87ecu, (void*)CreateBuffer},
+    {"vkDebugReportMessageEXT", 23, 0x90d8d9adu, (void*)DebugReportMessageEXT},
+    {"vkGetDescriptorSetLayoutSupportKHR", 34, 0x42ad0c11u, (void*)GetDescriptorSetLayoutSupportKHR},
+    {"vkCmdSetScissor", 15, 0xbcc3cad4u, (void*)CmdSetScissor},
+    {nullptr, 0, 0, nullptr},
+    {"vkInitializePerformanceApiINTEL", 31, 0x5ec63556u, (void*)InitializePerformanceApiINTEL},
+    {"vkGetPhysicalDeviceFormatProperties", 35, 0xf571955fu, (void*)GetPhysicalDeviceFormatProperties},
+    {nullptr, 0, 0, nullptr},
+    {"vkSignalSemaphoreKHR", 20, 0x31b70fcbu, (void*)SignalSemaphoreKHR},
+    {"vkGetDeviceMemoryCommitment", 27, 0x7edaff3eu, (void*)GetDeviceMemoryCommitment},
+    {"vkFlushMappedMemoryRanges", 25, 0xd4cde7deu, (void*)FlushMappedMemoryRanges},
+    {"vkCreateSamplerYcbcrConversionKHR", 33, 0x6bc53830u, (void*)CreateSamplerYcbcrConversionKHR},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdSetViewportWScalingNV", 26, 0xc316e89eu, (void*)CmdSetViewportWScalingNV},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetPhysicalDeviceDisplayPlaneProperties2KHR", 45, 0x161819c9u, (void*)GetPhysicalDeviceDisplayPlaneProperties2KHR},
+    {"vkGetDeviceMemoryOpaqueCaptureAddress", 37, 0xcf71e086u, (void*)GetDeviceMemoryOpaqueCaptureAddress},
+    {"vkCreateHeadlessSurfaceEXT", 26, 0x6f5291c7u, (void*)CreateHeadlessSurfaceEXT},
+    {nullptr, 0, 0, nullptr},
+    {"vkResetEvent", 12, 0x7de046a3u, (void*)ResetEvent},
+    {"vkDestroyFramebuffer", 20, 0xf60843dbu, (void*)DestroyFramebuffer},
+    {"vkGetPhysicalDeviceSurfaceFormatsKHR", 36, 0x1a746777u, (void*)GetPhysicalDeviceSurfaceFormatsKHR},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdBeginRenderPass", 20, 0x79052222u, (void*)CmdBeginRenderPass},
+    {nullptr, 0, 0, nullptr},
+    {"vkCreateGraphicsPipelines", 25, 0xffdc1506u, (void*)CreateGraphicsPipelines},
+    {nullptr, 0, 0, nullptr},
+    {"vkSetDebugUtilsObjectTagEXT", 27, 0x5e0dab22u, (void*)SetDebugUtilsObjectTagEXT},
+    {nullptr, 0, 0, nullptr},
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkCreateWin32SurfaceKHR", 23, 0x40a42fdfu, (void*)CreateWin32SurfaceKHR},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
+    {"vkRegisterObjectsNVX", 20, 0xe844597fu, (void*)RegisterObjectsNVX},
+    {"vkGetValidationCacheDataEXT", 27, 0x0b761148u, (void*)GetValidationCacheDataEXT},
 #ifdef VK_USE_PLATFORM_XLIB_XRANDR_EXT
-    {"vkGetRandROutputDisplayEXT", (void*)GetRandROutputDisplayEXT},
-#endif
-    {"vkGetPhysicalDeviceSurfaceCapabilities2EXT", (void*)GetPhysicalDeviceSurfaceCapabilities2EXT},
-    {"vkDisplayPowerControlEXT", (void*)DisplayPowerControlEXT},
-    {"vkRegisterDeviceEventEXT", (void*)RegisterDeviceEventEXT},
-    {"vkRegisterDisplayEventEXT", (void*)RegisterDisplayEventEXT},
-    {"vkGetSwapchainCounterEXT", (void*)GetSwapchainCounterEXT},
-    {"vkGetRefreshCycleDurationGOOGLE", (void*)GetRefreshCycleDurationGOOGLE},
-    {"vkGetPastPresentationTimingGOOGLE", (void*)GetPastPresentationTimingGOOGLE},
-    {"vkCmdSetDiscardRectangleEXT", (void*)CmdSetDiscardRectangleEXT},
-    {"vkSetHdrMetadataEXT", (void*)SetHdrMetadataEXT},
-#ifdef VK_USE_PLATFORM_IOS_MVK
-    {"vkCreateIOSSurfaceMVK", (void*)CreateIOSSurfaceMVK},
+    {"vkGetRandROutputDisplayEXT", 26, 0xe72424d5u, (void*)GetRandROutputDisplayEXT},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
+    {"vkGetImageMemoryRequirements2", 29, 0x512e6a1eu, (void*)GetImageMemoryRequirements2},
+    {"vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR", 55, 0x479085d6u, (void*)GetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR},
+    {"vkUnregisterObjectsNVX", 22, 0x2a5f0098u, (void*)UnregisterObjectsNVX},
+    {"vkCmdEndConditionalRenderingEXT", 31, 0x9ff6ef02u, (void*)CmdEndConditionalRenderingEXT},
+    {"vkCreateAccelerationStructureNV", 31, 0x9b585c4bu, (void*)CreateAccelerationStructureNV},
+    {nullptr, 0, 0, nullptr},
 #ifdef VK_USE_PLATFORM_MACOS_MVK
-    {"vkCreateMacOSSurfaceMVK", (void*)CreateMacOSSurfaceMVK},
+    {"vkCreateMacOSSurfaceMVK", 23, 0x780d1dbeu, (void*)CreateMacOSSurfaceMVK},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-    {"vkSetDebugUtilsObjectNameEXT", (void*)SetDebugUtilsObjectNameEXT},
-    {"vkSetDebugUtilsObjectTagEXT", (void*)SetDebugUtilsObjectTagEXT},
-    {"vkQueueBeginDebugUtilsLabelEXT", (void*)QueueBeginDebugUtilsLabelEXT},
-    {"vkQueueEndDebugUtilsLabelEXT", (void*)QueueEndDebugUtilsLabelEXT},
-    {"vkQueueInsertDebugUtilsLabelEXT", (void*)QueueInsertDebugUtilsLabelEXT},
-    {"vkCmdBeginDebugUtilsLabelEXT", (void*)CmdBeginDebugUtilsLabelEXT},
-    {"vkCmdEndDebugUtilsLabelEXT", (void*)CmdEndDebugUtilsLabelEXT},
-    {"vkCmdInsertDebugUtilsLabelEXT", (void*)CmdInsertDebugUtilsLabelEXT},
-    {"vkCreateDebugUtilsMessengerEXT", (void*)CreateDebugUtilsMessengerEXT},
-    {"vkDestroyDebugUtilsMessengerEXT", (void*)DestroyDebugUtilsMessengerEXT},
-    {"vkSubmitDebugUtilsMessageEXT", (void*)SubmitDebugUtilsMessageEXT},
-#ifdef VK_USE_PLATFORM_ANDROID_KHR
-    {"vkGetAndroidHardwareBufferPropertiesANDROID", (void*)GetAndroidHardwareBufferPropertiesANDROID},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdSetSampleLocationsEXT", 26, 0x893ad3bbu, (void*)CmdSetSampleLocationsEXT},
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkReleaseFullScreenExclusiveModeEXT", 35, 0xad8bf02cu, (void*)ReleaseFullScreenExclusiveModeEXT},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
+    {"vkDestroyDescriptorUpdateTemplateKHR", 36, 0x18228c51u, (void*)DestroyDescriptorUpdateTemplateKHR},
+    {"vkDestroyPipelineCache", 22, 0x396c2a34u, (void*)DestroyPipelineCache},
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
-    {"vkGetMemoryAndroidHardwareBufferANDROID", (void*)GetMemoryAndroidHardwareBufferANDROID},
+    {"vkGetAndroidHardwareBufferPropertiesANDROID", 43, 0x80069229u, (void*)GetAndroidHardwareBufferPropertiesANDROID},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-    {"vkCmdSetSampleLocationsEXT", (void*)CmdSetSampleLocationsEXT},
-    {"vkGetPhysicalDeviceMultisamplePropertiesEXT", (void*)GetPhysicalDeviceMultisamplePropertiesEXT},
-    {"vkGetImageDrmFormatModifierPropertiesEXT", (void*)GetImageDrmFormatModifierPropertiesEXT},
-    {"vkCreateValidationCacheEXT", (void*)CreateValidationCacheEXT},
-    {"vkDestroyValidationCacheEXT", (void*)DestroyValidationCacheEXT},
-    {"vkMergeValidationCachesEXT", (void*)MergeValidationCachesEXT},
-    {"vkGetValidationCacheDataEXT", (void*)GetValidationCacheDataEXT},
-    {"vkCmdBindShadingRateImageNV", (void*)CmdBindShadingRateImageNV},
-    {"vkCmdSetViewportShadingRatePaletteNV", (void*)CmdSetViewportShadingRatePaletteNV},
-    {"vkCmdSetCoarseSampleOrderNV", (void*)CmdSetCoarseSampleOrderNV},
-    {"vkCreateAccelerationStructureNV", (void*)CreateAccelerationStructureNV},
-    {"vkDestroyAccelerationStructureNV", (void*)DestroyAccelerationStructureNV},
-    {"vkGetAccelerationStructureMemoryRequirementsNV", (void*)GetAccelerationStructureMemoryRequirementsNV},
-    {"vkBindAccelerationStructureMemoryNV", (void*)BindAccelerationStructureMemoryNV},
-    {"vkCmdBuildAccelerationStructureNV", (void*)CmdBuildAccelerationStructureNV},
-    {"vkCmdCopyAccelerationStructureNV", (void*)CmdCopyAccelerationStructureNV},
-    {"vkCmdTraceRaysNV", (void*)CmdTraceRaysNV},
-    {"vkCreateRayTracingPipelinesNV", (void*)CreateRayTracingPipelinesNV},
-    {"vkGetRayTracingShaderGroupHandlesNV", (void*)GetRayTracingShaderGroupHandlesNV},
-    {"vkGetAccelerationStructureHandleNV", (void*)GetAccelerationStructureHandleNV},
-    {"vkCmdWriteAccelerationStructuresPropertiesNV", (void*)CmdWriteAccelerationStructuresPropertiesNV},
-    {"vkCompileDeferredNV", (void*)CompileDeferredNV},
-    {"vkGetMemoryHostPointerPropertiesEXT", (void*)GetMemoryHostPointerPropertiesEXT},
-    {"vkCmdWriteBufferMarkerAMD", (void*)CmdWriteBufferMarkerAMD},
-    {"vkGetPhysicalDeviceCalibrateableTimeDomainsEXT", (void*)GetPhysicalDeviceCalibrateableTimeDomainsEXT},
-    {"vkGetCalibratedTimestampsEXT", (void*)GetCalibratedTimestampsEXT},
-    {"vkCmdDrawMeshTasksNV", (void*)CmdDrawMeshTasksNV},
-    {"vkCmdDrawMeshTasksIndirectNV", (void*)CmdDrawMeshTasksIndirectNV},
-    {"vkCmdDrawMeshTasksIndirectCountNV", (void*)CmdDrawMeshTasksIndirectCountNV},
-    {"vkCmdSetExclusiveScissorNV", (void*)CmdSetExclusiveScissorNV},
-    {"vkCmdSetCheckpointNV", (void*)CmdSetCheckpointNV},
-    {"vkGetQueueCheckpointDataNV", (void*)GetQueueCheckpointDataNV},
-    {"vkInitializePerformanceApiINTEL", (void*)InitializePerformanceApiINTEL},
-    {"vkUninitializePerformanceApiINTEL", (void*)UninitializePerformanceApiINTEL},
-    {"vkCmdSetPerformanceMarkerINTEL", (void*)CmdSetPerformanceMarkerINTEL},
-    {"vkCmdSetPerformanceStreamMarkerINTEL", (void*)CmdSetPerformanceStreamMarkerINTEL},
-    {"vkCmdSetPerformanceOverrideINTEL", (void*)CmdSetPerformanceOverrideINTEL},
-    {"vkAcquirePerformanceConfigurationINTEL", (void*)AcquirePerformanceConfigurationINTEL},
-    {"vkReleasePerformanceConfigurationINTEL", (void*)ReleasePerformanceConfigurationINTEL},
-    {"vkQueueSetPerformanceConfigurationINTEL", (void*)QueueSetPerformanceConfigurationINTEL},
-    {"vkGetPerformanceParameterINTEL", (void*)GetPerformanceParameterINTEL},
-    {"vkSetLocalDimmingAMD", (void*)SetLocalDimmingAMD},
-#ifdef VK_USE_PLATFORM_FUCHSIA
-    {"vkCreateImagePipeSurfaceFUCHSIA", (void*)CreateImagePipeSurfaceFUCHSIA},
-#endif
-#ifdef VK_USE_PLATFORM_METAL_EXT
-    {"vkCreateMetalSurfaceEXT", (void*)CreateMetalSurfaceEXT},
-#endif
-    {"vkGetBufferDeviceAddressEXT", (void*)GetBufferDeviceAddressEXT},
-    {"vkGetPhysicalDeviceToolPropertiesEXT", (void*)GetPhysicalDeviceToolPropertiesEXT},
-    {"vkGetPhysicalDeviceCooperativeMatrixPropertiesNV", (void*)GetPhysicalDeviceCooperativeMatrixPropertiesNV},
-    {"vkGetPhysicalDeviceSupportedFramebufferMixedSamplesCombinationsNV", (void*)GetPhysicalDeviceSupportedFramebufferMixedSamplesCombinationsNV},
+    {"vkCmdBindDescriptorSets", 23, 0x4f8ac889u, (void*)CmdBindDescriptorSets},
+    {"vkTrimCommandPool", 17, 0x59c4eabdu, (void*)TrimCommandPool},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetPhysicalDeviceSparseImageFormatProperties2KHR", 50, 0xe658803du, (void*)GetPhysicalDeviceSparseImageFormatProperties2KHR},
+    {"vkEnumerateInstanceVersion", 26, 0x2abdf7d1u, (void*)EnumerateInstanceVersion},
+    {"vkGetRayTracingShaderGroupHandlesNV", 35, 0x7321d653u, (void*)GetRayTracingShaderGroupHandlesNV},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetPhysicalDeviceSurfaceCapabilities2EXT", 42, 0xb811cc3bu, (void*)GetPhysicalDeviceSurfaceCapabilities2EXT},
+    {"vkCmdDrawIndexed", 16, 0x44b84ecdu, (void*)CmdDrawIndexed},
+    {"vkQueueSetPerformanceConfigurationINTEL", 39, 0x227fcb85u, (void*)QueueSetPerformanceConfigurationINTEL},
+    {"vkGetSemaphoreCounterValue", 26, 0x036431c1u, (void*)GetSemaphoreCounterValue},
+    {"vkGetPhysicalDeviceFeatures", 27, 0x3407e5aau, (void*)GetPhysicalDeviceFeatures},
+    {"vkAllocateMemory", 16, 0x8fd182beu, (void*)AllocateMemory},
+    {"vkDestroySampler", 16, 0x2842f278u, (void*)DestroySampler},
+    {"vkDestroyPipelineLayout", 23, 0xe5b1e1d0u, (void*)DestroyPipelineLayout},
+    {"vkDestroyIndirectCommandsLayoutNVX", 34, 0xbf0b76d2u, (void*)DestroyIndirectCommandsLayoutNVX},
+    {"vkCmdSetBlendConstants", 22, 0xb11418dau, (void*)CmdSetBlendConstants},
+    {"vkGetFenceFdKHR", 15, 0xbfa75230u, (void*)GetFenceFdKHR},
+    {"vkCmdBindPipeline", 17, 0x3306d993u, (void*)CmdBindPipeline},
+    {"vkAcquireProfilingLockKHR", 25, 0xbf49690eu, (void*)AcquireProfilingLockKHR},
+    {nullptr, 0, 0, nullptr},
 #ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetPhysicalDeviceSurfacePresentModes2EXT", (void*)GetPhysicalDeviceSurfacePresentModes2EXT},
+    {"vkGetSemaphoreWin32HandleKHR", 28, 0x650df93cu, (void*)GetSemaphoreWin32HandleKHR},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
+    {"vkCmdSetStencilReference", 24, 0x1d031387u, (void*)CmdSetStencilReference},
 #ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkAcquireFullScreenExclusiveModeEXT", (void*)AcquireFullScreenExclusiveModeEXT},
+    {"vkGetDeviceGroupSurfacePresentModes2EXT", 39, 0x46d74ae6u, (void*)GetDeviceGroupSurfacePresentModes2EXT},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
+    {"vkGetImageMemoryRequirements2KHR", 32, 0xfc9ea975u, (void*)GetImageMemoryRequirements2KHR},
+    {nullptr, 0, 0, nullptr},
+    {"vkUninitializePerformanceApiINTEL", 33, 0x51a2c77fu, (void*)UninitializePerformanceApiINTEL},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdDrawIndirectByteCountEXT", 29, 0x729b759eu, (void*)CmdDrawIndirectByteCountEXT},
+    {"vkGetInstanceProcAddr", 21, 0x9d4599a6u, (void*)GetInstanceProcAddr},
+    {"vkGetCalibratedTimestampsEXT", 28, 0x6f9a7c47u, (void*)GetCalibratedTimestampsEXT},
+    {"vkCmdDebugMarkerBeginEXT", 24, 0xafc387cfu, (void*)CmdDebugMarkerBeginEXT},
+    {"vkGetPhysicalDeviceToolPropertiesEXT", 36, 0x4d69a41du, (void*)GetPhysicalDeviceToolPropertiesEXT},
+    {"vkCmdDispatchBaseKHR", 20, 0x3fed8b1cu, (void*)CmdDispatchBaseKHR},
+    {nullptr, 0, 0, nullptr},
+    {"vkCreateImage", 13, 0x29aa0da7u, (void*)CreateImage},
+#ifdef VK_USE_PLATFORM_VI_NN
+    {"vkCreateViSurfaceNN", 19, 0x3c2d81c6u, (void*)CreateViSurfaceNN},
+#else
+    {nullptr, 0, 0, nullptr},
+#endif
+    {nullptr, 0, 0, nullptr},
+    {"vkGetPhysicalDevicePresentRectanglesKHR", 39, 0x487ff515u, (void*)GetPhysicalDevicePresentRectanglesKHR},
+    {"vkCmdFillBuffer", 15, 0xe2498171u, (void*)CmdFillBuffer},
+    {"vkCmdNextSubpass", 16, 0x94036722u, (void*)CmdNextSubpass},
+    {"vkFreeCommandBuffers", 20, 0x60cb1fd0u, (void*)FreeCommandBuffers},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdDrawIndexedIndirect", 24, 0xa2dd69bfu, (void*)CmdDrawIndexedIndirect},
+    {"vkDestroyImage", 14, 0x2d239345u, (void*)DestroyImage},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkBindBufferMemory", 18, 0x8fcb92d4u, (void*)BindBufferMemory},
+    {"vkUnmapMemory", 13, 0x45ae8caau, (void*)UnmapMemory},
+    {"vkQueuePresentKHR", 17, 0xd55fb6bbu, (void*)QueuePresentKHR},
+    {"vkDestroySemaphore", 18, 0xaf0834d2u, (void*)DestroySemaphore},
 #ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkReleaseFullScreenExclusiveModeEXT", (void*)ReleaseFullScreenExclusiveModeEXT},
+    {"vkImportSemaphoreWin32HandleKHR", 31, 0x03b7a903u, (void*)ImportSemaphoreWin32HandleKHR},
+#else
+    {nullptr, 0, 0, nullptr},
+#endif
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdDispatch", 13, 0x1f28c0e0u, (void*)CmdDispatch},
+    {"vkGetPhysicalDeviceQueueFamilyProperties2", 41, 0xcc84890du, (void*)GetPhysicalDeviceQueueFamilyProperties2},
+    {"vkCmdBeginQuery", 15, 0x976db859u, (void*)CmdBeginQuery},
+    {"vkCmdDrawIndirectCount", 22, 0x772b9685u, (void*)CmdDrawIndirectCount},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetPhysicalDeviceExternalFenceProperties", 42, 0x9e415ee2u, (void*)GetPhysicalDeviceExternalFenceProperties},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdDrawIndirect", 17, 0x570978d6u, (void*)CmdDrawIndirect},
+    {"vkGetPipelineExecutableInternalRepresentationsKHR", 49, 0xb1c36b30u, (void*)GetPipelineExecutableInternalRepresentationsKHR},
+    {nullptr, 0, 0, nullptr},
+    {"vkFreeMemory", 12, 0x3486e387u, (void*)FreeMemory},
+    {"vkCmdResetQueryPool", 19, 0x21657da5u, (void*)CmdResetQueryPool},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdBindVertexBuffers", 22, 0xadd4e8dau, (void*)CmdBindVertexBuffers},
+    {"vkGetBufferMemoryRequirements", 29, 0x5f571cdbu, (void*)GetBufferMemoryRequirements},
+    {nullptr, 0, 0, nullptr},
+    {"vkDestroyShaderModule", 21, 0x6892d8b1u, (void*)DestroyShaderModule},
+    {"vkCmdTraceRaysNV", 16, 0x5c2e0b66u, (void*)CmdTraceRaysNV},
+    {"vkCmdPushConstants", 18, 0xd617972fu, (void*)CmdPushConstants},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetPipelineCacheData", 22, 0x6855c1a6u, (void*)GetPipelineCacheData},
+#ifdef VK_USE_PLATFORM_XLIB_XRANDR_EXT
+    {"vkAcquireXlibDisplayEXT", 23, 0x380de190u, (void*)AcquireXlibDisplayEXT},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
+    {"vkCmdBeginQueryIndexedEXT", 25, 0x58a08dcdu, (void*)CmdBeginQueryIndexedEXT},
+    {"vkCmdSetViewport", 16, 0x64e0e218u, (void*)CmdSetViewport},
+    {"vkCmdSetStencilCompareMask", 26, 0xb6ee9565u, (void*)CmdSetStencilCompareMask},
+    {"vkGetPhysicalDeviceExternalBufferProperties", 43, 0x0b1f96f9u, (void*)GetPhysicalDeviceExternalBufferProperties},
+    {"vkReleaseProfilingLockKHR", 25, 0xf4fdd0b7u, (void*)ReleaseProfilingLockKHR},
+    {"vkFreeDescriptorSets", 20, 0x2d791f80u, (void*)FreeDescriptorSets},
+    {"vkDestroyPipeline", 17, 0x84481076u, (void*)DestroyPipeline},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetPhysicalDeviceExternalSemaphoreProperties", 46, 0xc98f5959u, (void*)GetPhysicalDeviceExternalSemaphoreProperties},
+    {"vkResetQueryPoolEXT", 19, 0xa4673a84u, (void*)ResetQueryPoolEXT},
+    {"vkGetFenceStatus", 16, 0xd870b975u, (void*)GetFenceStatus},
 #ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetDeviceGroupSurfacePresentModes2EXT", (void*)GetDeviceGroupSurfacePresentModes2EXT},
+    {"vkAcquireFullScreenExclusiveModeEXT", 35, 0x826c6745u, (void*)AcquireFullScreenExclusiveModeEXT},
+#else
+    {nullptr, 0, 0, nullptr},
 #endif
-    {"vkCreateHeadlessSurfaceEXT", (void*)CreateHeadlessSurfaceEXT},
-    {"vkCmdSetLineStippleEXT", (void*)CmdSetLineStippleEXT},
-    {"vkResetQueryPoolEXT", (void*)ResetQueryPoolEXT},
+    {"vkCreateDescriptorPool", 22, 0x6392b8cdu, (void*)CreateDescriptorPool},
+    {"vkGetPerformanceParameterINTEL", 30, 0xa2ea440du, (void*)GetPerformanceParameterINTEL},
+    {"vkMapMemory", 11, 0xeade61a3u, (void*)MapMemory},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetDeviceQueue2", 17, 0xa7e80b5bu, (void*)GetDeviceQueue2},
+    {"vkGetPhysicalDeviceExternalBufferPropertiesKHR", 46, 0x373d8898u, (void*)GetPhysicalDeviceExternalBufferPropertiesKHR},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetMemoryFdKHR", 16, 0xdad4337au, (void*)GetMemoryFdKHR},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetBufferDeviceAddressKHR", 27, 0x68d0b905u, (void*)GetBufferDeviceAddressKHR},
+    {"vkSetDebugUtilsObjectNameEXT", 28, 0xd89ff139u, (void*)SetDebugUtilsObjectNameEXT},
+    {"vkGetPhysicalDeviceExternalImageFormatPropertiesNV", 50, 0x7e02661du, (void*)GetPhysicalDeviceExternalImageFormatPropertiesNV},
+    {"vkCmdDrawIndexedIndirectCountKHR", 32, 0xb0b6f3cdu, (void*)CmdDrawIndexedIndirectCountKHR},
+    {"vkCmdEndQuery", 13, 0xb93efb21u, (void*)CmdEndQuery},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetRenderAreaGranularity", 26, 0x0984abf1u, (void*)GetRenderAreaGranularity},
+    {nullptr, 0, 0, nullptr},
+    {"vkCreateImageView", 17, 0xb838b382u, (void*)CreateImageView},
+    {"vkCreateRenderPass2", 19, 0x5976c03fu, (void*)CreateRenderPass2},
+    {"vkGetPhysicalDeviceExternalSemaphorePropertiesKHR", 49, 0x87e82fb8u, (void*)GetPhysicalDeviceExternalSemaphorePropertiesKHR},
+    {"vkCmdSetDepthBounds", 19, 0x8aad23c2u, (void*)CmdSetDepthBounds},
+    {"vkEnumeratePhysicalDeviceGroups", 31, 0x297b509fu, (void*)EnumeratePhysicalDeviceGroups},
+    {"vkGetPhysicalDeviceMemoryProperties", 35, 0x278fa9bbu, (void*)GetPhysicalDeviceMemoryProperties},
+    {"vkGetBufferMemoryRequirements2", 30, 0xff2282cbu, (void*)GetBufferMemoryRequirements2},
+    {"vkResetDescriptorPool", 21, 0x19c5052au, (void*)ResetDescriptorPool},
+    {"vkGetPhysicalDeviceImageFormatProperties", 40, 0x8bfced20u, (void*)GetPhysicalDeviceImageFormatProperties},
+    {"vkDestroyFence", 14, 0x60073b51u, (void*)DestroyFence},
+    {nullptr, 0, 0, nullptr},
+    {"vkBindBufferMemory2KHR", 22, 0xd9ba5d21u, (void*)BindBufferMemory2KHR},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetSwapchainImagesKHR", 23, 0xb7e4af43u, (void*)GetSwapchainImagesKHR},
+    {"vkGetBufferOpaqueCaptureAddress", 31, 0x7e52a54du, (void*)GetBufferOpaqueCaptureAddress},
+    {"vkCmdCopyBufferToImage", 22, 0xb0b1777du, (void*)CmdCopyBufferToImage},
+    {"vkGetPastPresentationTimingGOOGLE", 33, 0xaa7a8c67u, (void*)GetPastPresentationTimingGOOGLE},
+    {nullptr, 0, 0, nullptr},
+    {"vkDestroyDebugReportCallbackEXT", 31, 0x8b1da119u, (void*)DestroyDebugReportCallbackEXT},
+    {"vkCmdSetStencilWriteMask", 24, 0xe559d0e1u, (void*)CmdSetStencilWriteMask},
+    {"vkQueueWaitIdle", 15, 0x33b1f316u, (void*)QueueWaitIdle},
+    {"vkGetPhysicalDeviceExternalFencePropertiesKHR", 45, 0x0eb732b1u, (void*)GetPhysicalDeviceExternalFencePropertiesKHR},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetSemaphoreFdKHR", 19, 0x119d3c25u, (void*)GetSemaphoreFdKHR},
+    {"vkGetPhysicalDeviceFeatures2", 28, 0x806e6e48u, (void*)GetPhysicalDeviceFeatures2},
+    {"vkCmdPushDescriptorSetWithTemplateKHR", 37, 0xe9d2872eu, (void*)CmdPushDescriptorSetWithTemplateKHR},
+    {"vkRegisterDisplayEventEXT", 25, 0xadc421e4u, (void*)RegisterDisplayEventEXT},
+    {nullptr, 0, 0, nullptr},
+    {"vkGetBufferDeviceAddressEXT", 27, 0x0439224du, (void*)GetBufferDeviceAddressEXT},
+    {"vkCmdDrawIndirectCountKHR", 25, 0x6299459cu, (void*)CmdDrawIndirectCountKHR},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdSetEvent", 13, 0x797f43fau, (void*)CmdSetEvent},
+    {nullptr, 0, 0, nullptr},
+    {"vkCmdSetDiscardRectangleEXT", 27, 0x746a9b6cu, (void*)CmdSetDiscardRectangleEXT},
+    {"vkGetMemoryFdPropertiesKHR", 26, 0x040c9cadu, (void*)GetMemoryFdPropertiesKHR},
+    {"vkGetPhysicalDeviceSurfaceCapabilities2KHR", 42, 0x63821a73u, (void*)GetPhysicalDeviceSurfaceCapabilities2KHR},
+    {"vkGetPhysicalDeviceSupportedFramebufferMixedSamplesCombinationsNV", 65, 0xf9a13cfau, (void*)GetPhysicalDeviceSupportedFramebufferMixedSamplesCombinationsNV},
+    {"vkCreateDebugReportCallbackEXT", 30, 0xd676fd2fu, (void*)CreateDebugReportCallbackEXT},
+    {"vkGetBufferMemoryRequirements2KHR", 33, 0x820dae3eu, (void*)GetBufferMemoryRequirements2KHR},
+    {"vkGetImageMemoryRequirements", 28, 0x5b923818u, (void*)GetImageMemoryRequirements},
+    {"vkGetDeviceProcAddr", 19, 0x228d66e7u, (void*)GetDeviceProcAddr},
+    {"vkCreatePipelineCache", 21, 0x3e71c4c6u, (void*)CreatePipelineCache},
+#ifdef VK_USE_PLATFORM_WAYLAND_KHR
+    {"vkCreateWaylandSurfaceKHR", 25, 0xf307a066u, (void*)CreateWaylandSurfaceKHR},
+#else
+    {nullptr, 0, 0, nullptr},
+#endif
+#ifdef VK_USE_PLATFORM_XLIB_KHR
+    {"vkGetPhysicalDeviceXlibPresentationSupportKHR", 45, 0xfde5a6f8u, (void*)GetPhysicalDeviceXlibPresentationSupportKHR},
+#else
+    {nullptr, 0, 0, nullptr},
+#endif
+    {"vkDebugMarkerSetObjectNameEXT", 29, 0xecefbfccu, (void*)DebugMarkerSetObjectNameEXT},
+}, {
+    0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    2, 1, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 1, 0, 3, 0, 0,
+    1, 2, 0, 0, 0, 0, 1, 0, 3, 0, 0, 0, 0, 3, 1, 0,
+    1, 0, 0, 0, 0, 0, 2, 2, 2, 0, 0, 2, 1, 0, 0, 0,
+    1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0,
+    0, 0, 0, 1, 0, 2, 0, 1, 0, 0, 1, 0, 2, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 6, 0, 1, 0, 0,
+    1, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 5, 0, 0, 0,
+    1, 0, 3, 0, 0, 0, 1, 1, 6, 0, 0, 1, 0, 1, 0, 0,
+    0, 0, 2, 0, 2, 0, 0, 0, 0, 0, 4, 1, 1, 0, 0, 0,
+    0, 15, 4, 0, 1, 0, 6, 0, 0, 0, 5, 0, 0, 0, 0, 4,
+    2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 3, 1,
+    0, 0, 5, 0, 1, 1, 1, 1, 0, 4, 0, 0, 0, 0, 3, 0,
+    1, 0, 0, 0, 1, 3, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 5, 0, 4, 0, 0, 0, 0, 1, 2,
+    0, 1, 0, 4, 0, 3, 0, 0, 5, 0, 2, 0, 0, 0, 1, 0,
+    0, 0, 0, 1, 0, 2, 0, 0, 0, 0, 1, 1, 0, 0, 2, 1,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0,
+    0, 2, 0, 7, 0, 0, 0, 0, 0, 6, 1, 0, 0, 0, 0, 1,
+    3, 0, 1, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0,
+    0, 0, 2, 3, 0, 0, 0, 5, 0, 0, 0, 2, 1, 0, 2, 0,
+    0, 0, 3, 0, 0, 1, 0, 4, 0, 14, 0, 0, 0, 0, 0, 0,
+    10, 0, 0, 3, 0, 0, 2, 0, 3, 0, 0, 4, 3, 0, 3, 2,
+    0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 7, 1, 1, 2, 0, 0,
+    0, 2, 0, 0, 1, 0, 1, 0, 6, 0, 0, 1, 5, 3, 0, 2,
+    1, 3, 0, 0, 1, 3, 0, 0, 3, 4, 0, 2, 1, 0, 0, 0,
+    1, 3, 0, 0, 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+}};
+
+// Entrypoints as numbered in trace files and the cost model
+enum Entrypoint {
+    ENTRYPOINT_vkCreateInstance,
+    ENTRYPOINT_vkDestroyInstance,
+    ENTRYPOINT_vkEnumeratePhysicalDevices,
+    ENTRYPOINT_vkGetPhysicalDeviceFeatures,
+    ENTRYPOINT_vkGetPhysicalDeviceFormatProperties,
+    ENTRYPOINT_vkGetPhysicalDeviceImageFormatProperties,
+    ENTRYPOINT_vkGetPhysicalDeviceProperties,
+    ENTRYPOINT_vkGetPhysicalDeviceQueueFamilyProperties,
+    ENTRYPOINT_vkGetPhysicalDeviceMemoryProperties,
+    ENTRYPOINT_vkGetInstanceProcAddr,
+    ENTRYPOINT_vkGetDeviceProcAddr,
+    ENTRYPOINT_vkCreateDevice,
+    ENTRYPOINT_vkDestroyDevice,
+    ENTRYPOINT_vkEnumerateInstanceExtensionProperties,
+    ENTRYPOINT_vkEnumerateDeviceExtensionProperties,
+    ENTRYPOINT_vkEnumerateInstanceLayerProperties,
+    ENTRYPOINT_vkEnumerateDeviceLayerProperties,
+    ENTRYPOINT_vkGetDeviceQueue,
+    ENTRYPOINT_vkQueueSubmit,
+    ENTRYPOINT_vkQueueWaitIdle,
+    ENTRYPOINT_vkDeviceWaitIdle,
+    ENTRYPOINT_vkAllocateMemory,
+    ENTRYPOINT_vkFreeMemory,
+    ENTRYPOINT_vkMapMemory,
+    ENTRYPOINT_vkUnmapMemory,
+    ENTRYPOINT_vkFlushMappedMemoryRanges,
+    ENTRYPOINT_vkInvalidateMappedMemoryRanges,
+    ENTRYPOINT_vkGetDeviceMemoryCommitment,
+    ENTRYPOINT_vkBindBufferMemory,
+    ENTRYPOINT_vkBindImageMemory,
+    ENTRYPOINT_vkGetBufferMemoryRequirements,
+    ENTRYPOINT_vkGetImageMemoryRequirements,
+    ENTRYPOINT_vkGetImageSparseMemoryRequirements,
+    ENTRYPOINT_vkGetPhysicalDeviceSparseImageFormatProperties,
+    ENTRYPOINT_vkQueueBindSparse,
+    ENTRYPOINT_vkCreateFence,
+    ENTRYPOINT_vkDestroyFence,
+    ENTRYPOINT_vkResetFences,
+    ENTRYPOINT_vkGetFenceStatus,
+    ENTRYPOINT_vkWaitForFences,
+    ENTRYPOINT_vkCreateSemaphore,
+    ENTRYPOINT_vkDestroySemaphore,
+    ENTRYPOINT_vkCreateEvent,
+    ENTRYPOINT_vkDestroyEvent,
+    ENTRYPOINT_vkGetEventStatus,
+    ENTRYPOINT_vkSetEvent,
+    ENTRYPOINT_vkResetEvent,
+    ENTRYPOINT_vkCreateQueryPool,
+    ENTRYPOINT_vkDestroyQueryPool,
+    ENTRYPOINT_vkGetQueryPoolResults,
+    ENTRYPOINT_vkCreateBuffer,
+    ENTRYPOINT_vkDestroyBuffer,
+    ENTRYPOINT_vkCreateBufferView,
+    ENTRYPOINT_vkDestroyBufferView,
+    ENTRYPOINT_vkCreateImage,
+    ENTRYPOINT_vkDestroyImage,
+    ENTRYPOINT_vkGetImageSubresourceLayout,
+    ENTRYPOINT_vkCreateImageView,
+    ENTRYPOINT_vkDestroyImageView,
+    ENTRYPOINT_vkCreateShaderModule,
+    ENTRYPOINT_vkDestroyShaderModule,
+    ENTRYPOINT_vkCreatePipelineCache,
+    ENTRYPOINT_vkDestroyPipelineCache,
+    ENTRYPOINT_vkGetPipelineCacheData,
+    ENTRYPOINT_vkMergePipelineCaches,
+    ENTRYPOINT_vkCreateGraphicsPipelines,
+    ENTRYPOINT_vkCreateComputePipelines,
+    ENTRYPOINT_vkDestroyPipeline,
+    ENTRYPOINT_vkCreatePipelineLayout,
+    ENTRYPOINT_vkDestroyPipelineLayout,
+    ENTRYPOINT_vkCreateSampler,
+    ENTRYPOINT_vkDestroySampler,
+    ENTRYPOINT_vkCreateDescriptorSetLayout,
+    ENTRYPOINT_vkDestroyDescriptorSetLayout,
+    ENTRYPOINT_vkCreateDescriptorPool,
+    ENTRYPOINT_vkDestroyDescriptorPool,
+    ENTRYPOINT_vkResetDescriptorPool,
+    ENTRYPOINT_vkAllocateDescriptorSets,
+    ENTRYPOINT_vkFreeDescriptorSets,
+    ENTRYPOINT_vkUpdateDescriptorSets,
+    ENTRYPOINT_vkCreateFramebuffer,
+    ENTRYPOINT_vkDestroyFramebuffer,
+    ENTRYPOINT_vkCreateRenderPass,
+    ENTRYPOINT_vkDestroyRenderPass,
+    ENTRYPOINT_vkGetRenderAreaGranularity,
+    ENTRYPOINT_vkCreateCommandPool,
+    ENTRYPOINT_vkDestroyCommandPool,
+    ENTRYPOINT_vkResetCommandPool,
+    ENTRYPOINT_vkAllocateCommandBuffers,
+    ENTRYPOINT_vkFreeCommandBuffers,
+    ENTRYPOINT_vkBeginCommandBuffer,
+    ENTRYPOINT_vkEndCommandBuffer,
+    ENTRYPOINT_vkResetCommandBuffer,
+    ENTRYPOINT_vkCmdBindPipeline,
+    ENTRYPOINT_vkCmdSetViewport,
+    ENTRYPOINT_vkCmdSetScissor,
+    ENTRYPOINT_vkCmdSetLineWidth,
+    ENTRYPOINT_vkCmdSetDepthBias,
+    ENTRYPOINT_vkCmdSetBlendConstants,
+    ENTRYPOINT_vkCmdSetDepthBounds,
+    ENTRYPOINT_vkCmdSetStencilCompareMask,
+    ENTRYPOINT_vkCmdSetStencilWriteMask,
+    ENTRYPOINT_vkCmdSetStencilReference,
+    ENTRYPOINT_vkCmdBindDescriptorSets,
+    ENTRYPOINT_vkCmdBindIndexBuffer,
+    ENTRYPOINT_vkCmdBindVertexBuffers,
+    ENTRYPOINT_vkCmdDraw,
+    ENTRYPOINT_vkCmdDrawIndexed,
+    ENTRYPOINT_vkCmdDrawIndirect,
+    ENTRYPOINT_vkCmdDrawIndexedIndirect,
+    ENTRYPOINT_vkCmdDispatch,
+    ENTRYPOINT_vkCmdDispatchIndirect,
+    ENTRYPOINT_vkCmdCopyBuffer,
+    ENTRYPOINT_vkCmdCopyImage,
+    ENTRYPOINT_vkCmdBlitImage,
+    ENTRYPOINT_vkCmdCopyBufferToImage,
+    ENTRYPOINT_vkCmdCopyImageToBuffer,
+    ENTRYPOINT_vkCmdUpdateBuffer,
+    ENTRYPOINT_vkCmdFillBuffer,
+    ENTRYPOINT_vkCmdClearColorImage,
+    ENTRYPOINT_vkCmdClearDepthStencilImage,
+    ENTRYPOINT_vkCmdClearAttachments,
+    ENTRYPOINT_vkCmdResolveImage,
+    ENTRYPOINT_vkCmdSetEvent,
+    ENTRYPOINT_vkCmdResetEvent,
+    ENTRYPOINT_vkCmdWaitEvents,
+    ENTRYPOINT_vkCmdPipelineBarrier,
+    ENTRYPOINT_vkCmdBeginQuery,
+    ENTRYPOINT_vkCmdEndQuery,
+    ENTRYPOINT_vkCmdResetQueryPool,
+    ENTRYPOINT_vkCmdWriteTimestamp,
+    ENTRYPOINT_vkCmdCopyQueryPoolResults,
+    ENTRYPOINT_vkCmdPushConstants,
+    ENTRYPOINT_vkCmdBeginRenderPass,
+    ENTRYPOINT_vkCmdNextSubpass,
+    ENTRYPOINT_vkCmdEndRenderPass,
+    ENTRYPOINT_vkCmdExecuteCommands,
+    ENTRYPOINT_vkEnumerateInstanceVersion,
+    ENTRYPOINT_vkBindBufferMemory2,
+    ENTRYPOINT_vkBindImageMemory2,
+    ENTRYPOINT_vkGetDeviceGroupPeerMemoryFeatures,
+    ENTRYPOINT_vkCmdSetDeviceMask,
+    ENTRYPOINT_vkCmdDispatchBase,
+    ENTRYPOINT_vkEnumeratePhysicalDeviceGroups,
+    ENTRYPOINT_vkGetImageMemoryRequirements2,
+    ENTRYPOINT_vkGetBufferMemoryRequirements2,
+    ENTRYPOINT_vkGetImageSparseMemoryRequirements2,
+    ENTRYPOINT_vkGetPhysicalDeviceFeatures2,
+    ENTRYPOINT_vkGetPhysicalDeviceProperties2,
+    ENTRYPOINT_vkGetPhysicalDeviceFormatProperties2,
+    ENTRYPOINT_vkGetPhysicalDeviceImageFormatProperties2,
+    ENTRYPOINT_vkGetPhysicalDeviceQueueFamilyProperties2,
+    ENTRYPOINT_vkGetPhysicalDeviceMemoryProperties2,
+    ENTRYPOINT_vkGetPhysicalDeviceSparseImageFormatProperties2,
+    ENTRYPOINT_vkTrimCommandPool,
+    ENTRYPOINT_vkGetDeviceQueue2,
+    ENTRYPOINT_vkCreateSamplerYcbcrConversion,
+    ENTRYPOINT_vkDestroySamplerYcbcrConversion,
+    ENTRYPOINT_vkCreateDescriptorUpdateTemplate,
+    ENTRYPOINT_vkDestroyDescriptorUpdateTemplate,
+    ENTRYPOINT_vkUpdateDescriptorSetWithTemplate,
+    ENTRYPOINT_vkGetPhysicalDeviceExternalBufferProperties,
+    ENTRYPOINT_vkGetPhysicalDeviceExternalFenceProperties,
+    ENTRYPOINT_vkGetPhysicalDeviceExternalSemaphoreProperties,
+    ENTRYPOINT_vkGetDescriptorSetLayoutSupport,
+    ENTRYPOINT_vkCmdDrawIndirectCount,
+    ENTRYPOINT_vkCmdDrawIndexedIndirectCount,
+    ENTRYPOINT_vkCreateRenderPass2,
+    ENTRYPOINT_vkCmdBeginRenderPass2,
+    ENTRYPOINT_vkCmdNextSubpass2,
+    ENTRYPOINT_vkCmdEndRenderPass2,
+    ENTRYPOINT_vkResetQueryPool,
+    ENTRYPOINT_vkGetSemaphoreCounterValue,
+    ENTRYPOINT_vkWaitSemaphores,
+    ENTRYPOINT_vkSignalSemaphore,
+    ENTRYPOINT_vkGetBufferDeviceAddress,
+    ENTRYPOINT_vkGetBufferOpaqueCaptureAddress,
+    ENTRYPOINT_vkGetDeviceMemoryOpaqueCaptureAddress,
+    ENTRYPOINT_vkDestroySurfaceKHR,
+    ENTRYPOINT_vkGetPhysicalDeviceSurfaceSupportKHR,
+    ENTRYPOINT_vkGetPhysicalDeviceSurfaceCapabilitiesKHR,
+    ENTRYPOINT_vkGetPhysicalDeviceSurfaceFormatsKHR,
+    ENTRYPOINT_vkGetPhysicalDeviceSurfacePresentModesKHR,
+    ENTRYPOINT_vkCreateSwapchainKHR,
+    ENTRYPOINT_vkDestroySwapchainKHR,
+    ENTRYPOINT_vkGetSwapchainImagesKHR,
+    ENTRYPOINT_vkAcquireNextImageKHR,
+    ENTRYPOINT_vkQueuePresentKHR,
+    ENTRYPOINT_vkGetDeviceGroupPresentCapabilitiesKHR,
+    ENTRYPOINT_vkGetDeviceGroupSurfacePresentModesKHR,
+    ENTRYPOINT_vkGetPhysicalDevicePresentRectanglesKHR,
+    ENTRYPOINT_vkAcquireNextImage2KHR,
+    ENTRYPOINT_vkGetPhysicalDeviceDisplayPropertiesKHR,
+    ENTRYPOINT_vkGetPhysicalDeviceDisplayPlanePropertiesKHR,
+    ENTRYPOINT_vkGetDisplayPlaneSupportedDisplaysKHR,
+    ENTRYPOINT_vkGetDisplayModePropertiesKHR,
+    ENTRYPOINT_vkCreateDisplayModeKHR,
+    ENTRYPOINT_vkGetDisplayPlaneCapabilitiesKHR,
+    ENTRYPOINT_vkCreateDisplayPlaneSurfaceKHR,
+    ENTRYPOINT_vkCreateSharedSwapchainsKHR,
+    ENTRYPOINT_vkCreateXlibSurfaceKHR,
+    ENTRYPOINT_vkGetPhysicalDeviceXlibPresentationSupportKHR,
+    ENTRYPOINT_vkCreateXcbSurfaceKHR,
+    ENTRYPOINT_vkGetPhysicalDeviceXcbPresentationSupportKHR,
+    ENTRYPOINT_vkCreateWaylandSurfaceKHR,
+    ENTRYPOINT_vkGetPhysicalDeviceWaylandPresentationSupportKHR,
+    ENTRYPOINT_vkCreateAndroidSurfaceKHR,
+    ENTRYPOINT_vkCreateWin32SurfaceKHR,
+    ENTRYPOINT_vkGetPhysicalDeviceWin32PresentationSupportKHR,
+    ENTRYPOINT_vkGetPhysicalDeviceFeatures2KHR,
+    ENTRYPOINT_vkGetPhysicalDeviceProperties2KHR,
+    ENTRYPOINT_vkGetPhysicalDeviceFormatProperties2KHR,
+    ENTRYPOINT_vkGetPhysicalDeviceImageFormatProperties2KHR,
+    ENTRYPOINT_vkGetPhysicalDeviceQueueFamilyProperties2KHR,
+    ENTRYPOINT_vkGetPhysicalDeviceMemoryProperties2KHR,
+    ENTRYPOINT_vkGetPhysicalDeviceSparseImageFormatProperties2KHR,
+    ENTRYPOINT_vkGetDeviceGroupPeerMemoryFeaturesKHR,
+    ENTRYPOINT_vkCmdSetDeviceMaskKHR,
+    ENTRYPOINT_vkCmdDispatchBaseKHR,
+    ENTRYPOINT_vkTrimCommandPoolKHR,
+    ENTRYPOINT_vkEnumeratePhysicalDeviceGroupsKHR,
+    ENTRYPOINT_vkGetPhysicalDeviceExternalBufferPropertiesKHR,
+    ENTRYPOINT_vkGetMemoryWin32HandleKHR,
+    ENTRYPOINT_vkGetMemoryWin32HandlePropertiesKHR,
+    ENTRYPOINT_vkGetMemoryFdKHR,
+    ENTRYPOINT_vkGetMemoryFdPropertiesKHR,
+    ENTRYPOINT_vkGetPhysicalDeviceExternalSemaphorePropertiesKHR,
+    ENTRYPOINT_vkImportSemaphoreWin32HandleKHR,
+    ENTRYPOINT_vkGetSemaphoreWin32HandleKHR,
+    ENTRYPOINT_vkImportSemaphoreFdKHR,
+    ENTRYPOINT_vkGetSemaphoreFdKHR,
+    ENTRYPOINT_vkCmdPushDescriptorSetKHR,
+    ENTRYPOINT_vkCmdPushDescriptorSetWithTemplateKHR,
+    ENTRYPOINT_vkCreateDescriptorUpdateTemplateKHR,
+    ENTRYPOINT_vkDestroyDescriptorUpdateTemplateKHR,
+    ENTRYPOINT_vkUpdateDescriptorSetWithTemplateKHR,
+    ENTRYPOINT_vkCreateRenderPass2KHR,
+    ENTRYPOINT_vkCmdBeginRenderPass2KHR,
+    ENTRYPOINT_vkCmdNextSubpass2KHR,
+    ENTRYPOINT_vkCmdEndRenderPass2KHR,
+    ENTRYPOINT_vkGetSwapchainStatusKHR,
+    ENTRYPOINT_vkGetPhysicalDeviceExternalFencePropertiesKHR,
+    ENTRYPOINT_vkImportFenceWin32HandleKHR,
+    ENTRYPOINT_vkGetFenceWin32HandleKHR,
+    ENTRYPOINT_vkImportFenceFdKHR,
+    ENTRYPOINT_vkGetFenceFdKHR,
+    ENTRYPOINT_vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR,
+    ENTRYPOINT_vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR,
+    ENTRYPOINT_vkAcquireProfilingLockKHR,
+    ENTRYPOINT_vkReleaseProfilingLockKHR,
+    ENTRYPOINT_vkGetPhysicalDeviceSurfaceCapabilities2KHR,
+    ENTRYPOINT_vkGetPhysicalDeviceSurfaceFormats2KHR,
+    ENTRYPOINT_vkGetPhysicalDeviceDisplayProperties2KHR,
+    ENTRYPOINT_vkGetPhysicalDeviceDisplayPlaneProperties2KHR,
+    ENTRYPOINT_vkGetDisplayModeProperties2KHR,
+    ENTRYPOINT_vkGetDisplayPlaneCapabilities2KHR,
+    ENTRYPOINT_vkGetImageMemoryRequirements2KHR,
+    ENTRYPOINT_vkGetBufferMemoryRequirements2KHR,
+    ENTRYPOINT_vkGetImageSparseMemoryRequirements2KHR,
+    ENTRYPOINT_vkCreateSamplerYcbcrConversionKHR,
+    ENTRYPOINT_vkDestroySamplerYcbcrConversionKHR,
+    ENTRYPOINT_vkBindBufferMemory2KHR,
+    ENTRYPOINT_vkBindImageMemory2KHR,
+    ENTRYPOINT_vkGetDescriptorSetLayoutSupportKHR,
+    ENTRYPOINT_vkCmdDrawIndirectCountKHR,
+    ENTRYPOINT_vkCmdDrawIndexedIndirectCountKHR,
+    ENTRYPOINT_vkGetSemaphoreCounterValueKHR,
+    ENTRYPOINT_vkWaitSemaphoresKHR,
+    ENTRYPOINT_vkSignalSemaphoreKHR,
+    ENTRYPOINT_vkGetBufferDeviceAddressKHR,
+    ENTRYPOINT_vkGetBufferOpaqueCaptureAddressKHR,
+    ENTRYPOINT_vkGetDeviceMemoryOpaqueCaptureAddressKHR,
+    ENTRYPOINT_vkGetPipelineExecutablePropertiesKHR,
+    ENTRYPOINT_vkGetPipelineExecutableStatisticsKHR,
+    ENTRYPOINT_vkGetPipelineExecutableInternalRepresentationsKHR,
+    ENTRYPOINT_vkCreateDebugReportCallbackEXT,
+    ENTRYPOINT_vkDestroyDebugReportCallbackEXT,
+    ENTRYPOINT_vkDebugReportMessageEXT,
+    ENTRYPOINT_vkDebugMarkerSetObjectTagEXT,
+    ENTRYPOINT_vkDebugMarkerSetObjectNameEXT,
+    ENTRYPOINT_vkCmdDebugMarkerBeginEXT,
+    ENTRYPOINT_vkCmdDebugMarkerEndEXT,
+    ENTRYPOINT_vkCmdDebugMarkerInsertEXT,
+    ENTRYPOINT_vkCmdBindTransformFeedbackBuffersEXT,
+    ENTRYPOINT_vkCmdBeginTransformFeedbackEXT,
+    ENTRYPOINT_vkCmdEndTransformFeedbackEXT,
+    ENTRYPOINT_vkCmdBeginQueryIndexedEXT,
+    ENTRYPOINT_vkCmdEndQueryIndexedEXT,
+    ENTRYPOINT_vkCmdDrawIndirectByteCountEXT,
+    ENTRYPOINT_vkGetImageViewHandleNVX,
+    ENTRYPOINT_vkCmdDrawIndirectCountAMD,
+    ENTRYPOINT_vkCmdDrawIndexedIndirectCountAMD,
+    ENTRYPOINT_vkGetShaderInfoAMD,
+    ENTRYPOINT_vkCreateStreamDescriptorSurfaceGGP,
+    ENTRYPOINT_vkGetPhysicalDeviceExternalImageFormatPropertiesNV,
+    ENTRYPOINT_vkGetMemoryWin32HandleNV,
+    ENTRYPOINT_vkCreateViSurfaceNN,
+    ENTRYPOINT_vkCmdBeginConditionalRenderingEXT,
+    ENTRYPOINT_vkCmdEndConditionalRenderingEXT,
+    ENTRYPOINT_vkCmdProcessCommandsNVX,
+    ENTRYPOINT_vkCmdReserveSpaceForCommandsNVX,
+    ENTRYPOINT_vkCreateIndirectCommandsLayoutNVX,
+    ENTRYPOINT_vkDestroyIndirectCommandsLayoutNVX,
+    ENTRYPOINT_vkCreateObjectTableNVX,
+    ENTRYPOINT_vkDestroyObjectTableNVX,
+    ENTRYPOINT_vkRegisterObjectsNVX,
+    ENTRYPOINT_vkUnregisterObjectsNVX,
+    ENTRYPOINT_vkGetPhysicalDeviceGeneratedCommandsPropertiesNVX,
+    ENTRYPOINT_vkCmdSetViewportWScalingNV,
+    ENTRYPOINT_vkReleaseDisplayEXT,
+    ENTRYPOINT_vkAcquireXlibDisplayEXT,
+    ENTRYPOINT_vkGetRandROutputDisplayEXT,
+    ENTRYPOINT_vkGetPhysicalDeviceSurfaceCapabilities2EXT,
+    ENTRYPOINT_vkDisplayPowerControlEXT,
+    ENTRYPOINT_vkRegisterDeviceEventEXT,
+    ENTRYPOINT_vkRegisterDisplayEventEXT,
+    ENTRYPOINT_vkGetSwapchainCounterEXT,
+    ENTRYPOINT_vkGetRefreshCycleDurationGOOGLE,
+    ENTRYPOINT_vkGetPastPresentationTimingGOOGLE,
+    ENTRYPOINT_vkCmdSetDiscardRectangleEXT,
+    ENTRYPOINT_vkSetHdrMetadataEXT,
+    ENTRYPOINT_vkCreateIOSSurfaceMVK,
+    ENTRYPOINT_vkCreateMacOSSurfaceMVK,
+    ENTRYPOINT_vkSetDebugUtilsObjectNameEXT,
+    ENTRYPOINT_vkSetDebugUtilsObjectTagEXT,
+    ENTRYPOINT_vkQueueBeginDebugUtilsLabelEXT,
+    ENTRYPOINT_vkQueueEndDebugUtilsLabelEXT,
+    ENTRYPOINT_vkQueueInsertDebugUtilsLabelEXT,
+    ENTRYPOINT_vkCmdBeginDebugUtilsLabelEXT,
+    ENTRYPOINT_vkCmdEndDebugUtilsLabelEXT,
+    ENTRYPOINT_vkCmdInsertDebugUtilsLabelEXT,
+    ENTRYPOINT_vkCreateDebugUtilsMessengerEXT,
+    ENTRYPOINT_vkDestroyDebugUtilsMessengerEXT,
+    ENTRYPOINT_vkSubmitDebugUtilsMessageEXT,
+    ENTRYPOINT_vkGetAndroidHardwareBufferPropertiesANDROID,
+    ENTRYPOINT_vkGetMemoryAndroidHardwareBufferANDROID,
+    ENTRYPOINT_vkCmdSetSampleLocationsEXT,
+    ENTRYPOINT_vkGetPhysicalDeviceMultisamplePropertiesEXT,
+    ENTRYPOINT_vkGetImageDrmFormatModifierPropertiesEXT,
+    ENTRYPOINT_vkCreateValidationCacheEXT,
+    ENTRYPOINT_vkDestroyValidationCacheEXT,
+    ENTRYPOINT_vkMergeValidationCachesEXT,
+    ENTRYPOINT_vkGetValidationCacheDataEXT,
+    ENTRYPOINT_vkCmdBindShadingRateImageNV,
+    ENTRYPOINT_vkCmdSetViewportShadingRatePaletteNV,
+    ENTRYPOINT_vkCmdSetCoarseSampleOrderNV,
+    ENTRYPOINT_vkCreateAccelerationStructureNV,
+    ENTRYPOINT_vkDestroyAccelerationStructureNV,
+    ENTRYPOINT_vkGetAccelerationStructureMemoryRequirementsNV,
+    ENTRYPOINT_vkBindAccelerationStructureMemoryNV,
+    ENTRYPOINT_vkCmdBuildAccelerationStructureNV,
+    ENTRYPOINT_vkCmdCopyAccelerationStructureNV,
+    ENTRYPOINT_vkCmdTraceRaysNV,
+    ENTRYPOINT_vkCreateRayTracingPipelinesNV,
+    ENTRYPOINT_vkGetRayTracingShaderGroupHandlesNV,
+    ENTRYPOINT_vkGetAccelerationStructureHandleNV,
+    ENTRYPOINT_vkCmdWriteAccelerationStructuresPropertiesNV,
+    ENTRYPOINT_vkCompileDeferredNV,
+    ENTRYPOINT_vkGetMemoryHostPointerPropertiesEXT,
+    ENTRYPOINT_vkCmdWriteBufferMarkerAMD,
+    ENTRYPOINT_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT,
+    ENTRYPOINT_vkGetCalibratedTimestampsEXT,
+    ENTRYPOINT_vkCmdDrawMeshTasksNV,
+    ENTRYPOINT_vkCmdDrawMeshTasksIndirectNV,
+    ENTRYPOINT_vkCmdDrawMeshTasksIndirectCountNV,
+    ENTRYPOINT_vkCmdSetExclusiveScissorNV,
+    ENTRYPOINT_vkCmdSetCheckpointNV,
+    ENTRYPOINT_vkGetQueueCheckpointDataNV,
+    ENTRYPOINT_vkInitializePerformanceApiINTEL,
+    ENTRYPOINT_vkUninitializePerformanceApiINTEL,
+    ENTRYPOINT_vkCmdSetPerformanceMarkerINTEL,
+    ENTRYPOINT_vkCmdSetPerformanceStreamMarkerINTEL,
+    ENTRYPOINT_vkCmdSetPerformanceOverrideINTEL,
+    ENTRYPOINT_vkAcquirePerformanceConfigurationINTEL,
+    ENTRYPOINT_vkReleasePerformanceConfigurationINTEL,
+    ENTRYPOINT_vkQueueSetPerformanceConfigurationINTEL,
+    ENTRYPOINT_vkGetPerformanceParameterINTEL,
+    ENTRYPOINT_vkSetLocalDimmingAMD,
+    ENTRYPOINT_vkCreateImagePipeSurfaceFUCHSIA,
+    ENTRYPOINT_vkCreateMetalSurfaceEXT,
+    ENTRYPOINT_vkGetBufferDeviceAddressEXT,
+    ENTRYPOINT_vkGetPhysicalDeviceToolPropertiesEXT,
+    ENTRYPOINT_vkGetPhysicalDeviceCooperativeMatrixPropertiesNV,
+    ENTRYPOINT_vkGetPhysicalDeviceSupportedFramebufferMixedSamplesCombinationsNV,
+    ENTRYPOINT_vkGetPhysicalDeviceSurfacePresentModes2EXT,
+    ENTRYPOINT_vkAcquireFullScreenExclusiveModeEXT,
+    ENTRYPOINT_vkReleaseFullScreenExclusiveModeEXT,
+    ENTRYPOINT_vkGetDeviceGroupSurfacePresentModes2EXT,
+    ENTRYPOINT_vkCreateHeadlessSurfaceEXT,
+    ENTRYPOINT_vkCmdSetLineStippleEXT,
+    ENTRYPOINT_vkResetQueryPoolEXT,
+    ENTRYPOINT_COUNT
+};
+static const char* const entrypoint_names[ENTRYPOINT_COUNT] = {
+    "vkCreateInstance",
+    "vkDestroyInstance",
+    "vkEnumeratePhysicalDevices",
+    "vkGetPhysicalDeviceFeatures",
+    "vkGetPhysicalDeviceFormatProperties",
+    "vkGetPhysicalDeviceImageFormatProperties",
+    "vkGetPhysicalDeviceProperties",
+    "vkGetPhysicalDeviceQueueFamilyProperties",
+    "vkGetPhysicalDeviceMemoryProperties",
+    "vkGetInstanceProcAddr",
+    "vkGetDeviceProcAddr",
+    "vkCreateDevice",
+    "vkDestroyDevice",
+    "vkEnumerateInstanceExtensionProperties",
+    "vkEnumerateDeviceExtensionProperties",
+    "vkEnumerateInstanceLayerProperties",
+    "vkEnumerateDeviceLayerProperties",
+    "vkGetDeviceQueue",
+    "vkQueueSubmit",
+    "vkQueueWaitIdle",
+    "vkDeviceWaitIdle",
+    "vkAllocateMemory",
+    "vkFreeMemory",
+    "vkMapMemory",
+    "vkUnmapMemory",
+    "vkFlushMappedMemoryRanges",
+    "vkInvalidateMappedMemoryRanges",
+    "vkGetDeviceMemoryCommitment",
+    "vkBindBufferMemory",
+    "vkBindImageMemory",
+    "vkGetBufferMemoryRequirements",
+    "vkGetImageMemoryRequirements",
+    "vkGetImageSparseMemoryRequirements",
+    "vkGetPhysicalDeviceSparseImageFormatProperties",
+    "vkQueueBindSparse",
+    "vkCreateFence",
+    "vkDestroyFence",
+    "vkResetFences",
+    "vkGetFenceStatus",
+    "vkWaitForFences",
+    "vkCreateSemaphore",
+    "vkDestroySemaphore",
+    "vkCreateEvent",
+    "vkDestroyEvent",
+    "vkGetEventStatus",
+    "vkSetEvent",
+    "vkResetEvent",
+    "vkCreateQueryPool",
+    "vkDestroyQueryPool",
+    "vkGetQueryPoolResults",
+    "vkCreateBuffer",
+    "vkDestroyBuffer",
+    "vkCreateBufferView",
+    "vkDestroyBufferView",
+    "vkCreateImage",
+    "vkDestroyImage",
+    "vkGetImageSubresourceLayout",
+    "vkCreateImageView",
+    "vkDestroyImageView",
+    "vkCreateShaderModule",
+    "vkDestroyShaderModule",
+    "vkCreatePipelineCache",
+    "vkDestroyPipelineCache",
+    "vkGetPipelineCacheData",
+    "vkMergePipelineCaches",
+    "vkCreateGraphicsPipelines",
+    "vkCreateComputePipelines",
+    "vkDestroyPipeline",
+    "vkCreatePipelineLayout",
+    "vkDestroyPipelineLayout",
+    "vkCreateSampler",
+    "vkDestroySampler",
+    "vkCreateDescriptorSetLayout",
+    "vkDestroyDescriptorSetLayout",
+    "vkCreateDescriptorPool",
+    "vkDestroyDescriptorPool",
+    "vkResetDescriptorPool",
+    "vkAllocateDescriptorSets",
+    "vkFreeDescriptorSets",
+    "vkUpdateDescriptorSets",
+    "vkCreateFramebuffer",
+    "vkDestroyFramebuffer",
+    "vkCreateRenderPass",
+    "vkDestroyRenderPass",
+    "vkGetRenderAreaGranularity",
+    "vkCreateCommandPool",
+    "vkDestroyCommandPool",
+    "vkResetCommandPool",
+    "vkAllocateCommandBuffers",
+    "vkFreeCommandBuffers",
+    "vkBeginCommandBuffer",
+    "vkEndCommandBuffer",
+    "vkResetCommandBuffer",
+    "vkCmdBindPipeline",
+    "vkCmdSetViewport",
+    "vkCmdSetScissor",
+    "vkCmdSetLineWidth",
+    "vkCmdSetDepthBias",
+    "vkCmdSetBlendConstants",
+    "vkCmdSetDepthBounds",
+    "vkCmdSetStencilCompareMask",
+    "vkCmdSetStencilWriteMask",
+    "vkCmdSetStencilReference",
+    "vkCmdBindDescriptorSets",
+    "vkCmdBindIndexBuffer",
+    "vkCmdBindVertexBuffers",
+    "vkCmdDraw",
+    "vkCmdDrawIndexed",
+    "vkCmdDrawIndirect",
+    "vkCmdDrawIndexedIndirect",
+    "vkCmdDispatch",
+    "vkCmdDispatchIndirect",
+    "vkCmdCopyBuffer",
+    "vkCmdCopyImage",
+    "vkCmdBlitImage",
+    "vkCmdCopyBufferToImage",
+    "vkCmdCopyImageToBuffer",
+    "vkCmdUpdateBuffer",
+    "vkCmdFillBuffer",
+    "vkCmdClearColorImage",
+    "vkCmdClearDepthStencilImage",
+    "vkCmdClearAttachments",
+    "vkCmdResolveImage",
+    "vkCmdSetEvent",
+    "vkCmdResetEvent",
+    "vkCmdWaitEvents",
+    "vkCmdPipelineBarrier",
+    "vkCmdBeginQuery",
+    "vkCmdEndQuery",
+    "vkCmdResetQueryPool",
+    "vkCmdWriteTimestamp",
+    "vkCmdCopyQueryPoolResults",
+    "vkCmdPushConstants",
+    "vkCmdBeginRenderPass",
+    "vkCmdNextSubpass",
+    "vkCmdEndRenderPass",
+    "vkCmdExecuteCommands",
+    "vkEnumerateInstanceVersion",
+    "vkBindBufferMemory2",
+    "vkBindImageMemory2",
+    "vkGetDeviceGroupPeerMemoryFeatures",
+    "vkCmdSetDeviceMask",
+    "vkCmdDispatchBase",
+    "vkEnumeratePhysicalDeviceGroups",
+    "vkGetImageMemoryRequirements2",
+    "vkGetBufferMemoryRequirements2",
+    "vkGetImageSparseMemoryRequirements2",
+    "vkGetPhysicalDeviceFeatures2",
+    "vkGetPhysicalDeviceProperties2",
+    "vkGetPhysicalDeviceFormatProperties2",
+    "vkGetPhysicalDeviceImageFormatProperties2",
+    "vkGetPhysicalDeviceQueueFamilyProperties2",
+    "vkGetPhysicalDeviceMemoryProperties2",
+    "vkGetPhysicalDeviceSparseImageFormatProperties2",
+    "vkTrimCommandPool",
+    "vkGetDeviceQueue2",
+    "vkCreateSamplerYcbcrConversion",
+    "vkDestroySamplerYcbcrConversion",
+    "vkCreateDescriptorUpdateTemplate",
+    "vkDestroyDescriptorUpdateTemplate",
+    "vkUpdateDescriptorSetWithTemplate",
+    "vkGetPhysicalDeviceExternalBufferProperties",
+    "vkGetPhysicalDeviceExternalFenceProperties",
+    "vkGetPhysicalDeviceExternalSemaphoreProperties",
+    "vkGetDescriptorSetLayoutSupport",
+    "vkCmdDrawIndirectCount",
+    "vkCmdDrawIndexedIndirectCount",
+    "vkCreateRenderPass2",
+    "vkCmdBeginRenderPass2",
+    "vkCmdNextSubpass2",
+    "vkCmdEndRenderPass2",
+    "vkResetQueryPool",
+    "vkGetSemaphoreCounterValue",
+    "vkWaitSemaphores",
+    "vkSignalSemaphore",
+    "vkGetBufferDeviceAddress",
+    "vkGetBufferOpaqueCaptureAddress",
+    "vkGetDeviceMemoryOpaqueCaptureAddress",
+    "vkDestroySurfaceKHR",
+    "vkGetPhysicalDeviceSurfaceSupportKHR",
+    "vkGetPhysicalDeviceSurfaceCapabilitiesKHR",
+    "vkGetPhysicalDeviceSurfaceFormatsKHR",
+    "vkGetPhysicalDeviceSurfacePresentModesKHR",
+    "vkCreateSwapchainKHR",
+    "vkDestroySwapchainKHR",
+    "vkGetSwapchainImagesKHR",
+    "vkAcquireNextImageKHR",
+    "vkQueuePresentKHR",
+    "vkGetDeviceGroupPresentCapabilitiesKHR",
+    "vkGetDeviceGroupSurfacePresentModesKHR",
+    "vkGetPhysicalDevicePresentRectanglesKHR",
+    "vkAcquireNextImage2KHR",
+    "vkGetPhysicalDeviceDisplayPropertiesKHR",
+    "vkGetPhysicalDeviceDisplayPlanePropertiesKHR",
+    "vkGetDisplayPlaneSupportedDisplaysKHR",
+    "vkGetDisplayModePropertiesKHR",
+    "vkCreateDisplayModeKHR",
+    "vkGetDisplayPlaneCapabilitiesKHR",
+    "vkCreateDisplayPlaneSurfaceKHR",
+    "vkCreateSharedSwapchainsKHR",
+    "vkCreateXlibSurfaceKHR",
+    "vkGetPhysicalDeviceXlibPresentationSupportKHR",
+    "vkCreateXcbSurfaceKHR",
+    "vkGetPhysicalDeviceXcbPresentationSupportKHR",
+    "vkCreateWaylandSurfaceKHR",
+    "vkGetPhysicalDeviceWaylandPresentationSupportKHR",
+    "vkCreateAndroidSurfaceKHR",
+    "vkCreateWin32SurfaceKHR",
+    "vkGetPhysicalDeviceWin32PresentationSupportKHR",
+    "vkGetPhysicalDeviceFeatures2KHR",
+    "vkGetPhysicalDeviceProperties2KHR",
+    "vkGetPhysicalDeviceFormatProperties2KHR",
+    "vkGetPhysicalDeviceImageFormatProperties2KHR",
+    "vkGetPhysicalDeviceQueueFamilyProperties2KHR",
+    "vkGetPhysicalDeviceMemoryProperties2KHR",
+    "vkGetPhysicalDeviceSparseImageFormatProperties2KHR",
+    "vkGetDeviceGroupPeerMemoryFeaturesKHR",
+    "vkCmdSetDeviceMaskKHR",
+    "vkCmdDispatchBaseKHR",
+    "vkTrimCommandPoolKHR",
+    "vkEnumeratePhysicalDeviceGroupsKHR",
+    "vkGetPhysicalDeviceExternalBufferPropertiesKHR",
+    "vkGetMemoryWin32HandleKHR",
+    "vkGetMemoryWin32HandlePropertiesKHR",
+    "vkGetMemoryFdKHR",
+    "vkGetMemoryFdPropertiesKHR",
+    "vkGetPhysicalDeviceExternalSemaphorePropertiesKHR",
+    "vkImportSemaphoreWin32HandleKHR",
+    "vkGetSemaphoreWin32HandleKHR",
+    "vkImportSemaphoreFdKHR",
+    "vkGetSemaphoreFdKHR",
+    "vkCmdPushDescriptorSetKHR",
+    "vkCmdPushDescriptorSetWithTemplateKHR",
+    "vkCreateDescriptorUpdateTemplateKHR",
+    "vkDestroyDescriptorUpdateTemplateKHR",
+    "vkUpdateDescriptorSetWithTemplateKHR",
+    "vkCreateRenderPass2KHR",
+    "vkCmdBeginRenderPass2KHR",
+    "vkCmdNextSubpass2KHR",
+    "vkCmdEndRenderPass2KHR",
+    "vkGetSwapchainStatusKHR",
+    "vkGetPhysicalDeviceExternalFencePropertiesKHR",
+    "vkImportFenceWin32HandleKHR",
+    "vkGetFenceWin32HandleKHR",
+    "vkImportFenceFdKHR",
+    "vkGetFenceFdKHR",
+    "vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR",
+    "vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR",
+    "vkAcquireProfilingLockKHR",
+    "vkReleaseProfilingLockKHR",
+    "vkGetPhysicalDeviceSurfaceCapabilities2KHR",
+    "vkGetPhysicalDeviceSurfaceFormats2KHR",
+    "vkGetPhysicalDeviceDisplayProperties2KHR",
+    "vkGetPhysicalDeviceDisplayPlaneProperties2KHR",
+    "vkGetDisplayModeProperties2KHR",
+    "vkGetDisplayPlaneCapabilities2KHR",
+    "vkGetImageMemoryRequirements2KHR",
+    "vkGetBufferMemoryRequirements2KHR",
+    "vkGetImageSparseMemoryRequirements2KHR",
+    "vkCreateSamplerYcbcrConversionKHR",
+    "vkDestroySamplerYcbcrConversionKHR",
+    "vkBindBufferMemory2KHR",
+    "vkBindImageMemory2KHR",
+    "vkGetDescriptorSetLayoutSupportKHR",
+    "vkCmdDrawIndirectCountKHR",
+    "vkCmdDrawIndexedIndirectCountKHR",
+    "vkGetSemaphoreCounterValueKHR",
+    "vkWaitSemaphoresKHR",
+    "vkSignalSemaphoreKHR",
+    "vkGetBufferDeviceAddressKHR",
+    "vkGetBufferOpaqueCaptureAddressKHR",
+    "vkGetDeviceMemoryOpaqueCaptureAddressKHR",
+    "vkGetPipelineExecutablePropertiesKHR",
+    "vkGetPipelineExecutableStatisticsKHR",
+    "vkGetPipelineExecutableInternalRepresentationsKHR",
+    "vkCreateDebugReportCallbackEXT",
+    "vkDestroyDebugReportCallbackEXT",
+    "vkDebugReportMessageEXT",
+    "vkDebugMarkerSetObjectTagEXT",
+    "vkDebugMarkerSetObjectNameEXT",
+    "vkCmdDebugMarkerBeginEXT",
+    "vkCmdDebugMarkerEndEXT",
+    "vkCmdDebugMarkerInsertEXT",
+    "vkCmdBindTransformFeedbackBuffersEXT",
+    "vkCmdBeginTransformFeedbackEXT",
+    "vkCmdEndTransformFeedbackEXT",
+    "vkCmdBeginQueryIndexedEXT",
+    "vkCmdEndQueryIndexedEXT",
+    "vkCmdDrawIndirectByteCountEXT",
+    "vkGetImageViewHandleNVX",
+    "vkCmdDrawIndirectCountAMD",
+    "vkCmdDrawIndexedIndirectCountAMD",
+    "vkGetShaderInfoAMD",
+    "vkCreateStreamDescriptorSurfaceGGP",
+    "vkGetPhysicalDeviceExternalImageFormatPropertiesNV",
+    "vkGetMemoryWin32HandleNV",
+    "vkCreateViSurfaceNN",
+    "vkCmdBeginConditionalRenderingEXT",
+    "vkCmdEndConditionalRenderingEXT",
+    "vkCmdProcessCommandsNVX",
+    "vkCmdReserveSpaceForCommandsNVX",
+    "vkCreateIndirectCommandsLayoutNVX",
+    "vkDestroyIndirectCommandsLayoutNVX",
+    "vkCreateObjectTableNVX",
+    "vkDestroyObjectTableNVX",
+    "vkRegisterObjectsNVX",
+    "vkUnregisterObjectsNVX",
+    "vkGetPhysicalDeviceGeneratedCommandsPropertiesNVX",
+    "vkCmdSetViewportWScalingNV",
+    "vkReleaseDisplayEXT",
+    "vkAcquireXlibDisplayEXT",
+    "vkGetRandROutputDisplayEXT",
+    "vkGetPhysicalDeviceSurfaceCapabilities2EXT",
+    "vkDisplayPowerControlEXT",
+    "vkRegisterDeviceEventEXT",
+    "vkRegisterDisplayEventEXT",
+    "vkGetSwapchainCounterEXT",
+    "vkGetRefreshCycleDurationGOOGLE",
+    "vkGetPastPresentationTimingGOOGLE",
+    "vkCmdSetDiscardRectangleEXT",
+    "vkSetHdrMetadataEXT",
+    "vkCreateIOSSurfaceMVK",
+    "vkCreateMacOSSurfaceMVK",
+    "vkSetDebugUtilsObjectNameEXT",
+    "vkSetDebugUtilsObjectTagEXT",
+    "vkQueueBeginDebugUtilsLabelEXT",
+    "vkQueueEndDebugUtilsLabelEXT",
+    "vkQueueInsertDebugUtilsLabelEXT",
+    "vkCmdBeginDebugUtilsLabelEXT",
+    "vkCmdEndDebugUtilsLabelEXT",
+    "vkCmdInsertDebugUtilsLabelEXT",
+    "vkCreateDebugUtilsMessengerEXT",
+    "vkDestroyDebugUtilsMessengerEXT",
+    "vkSubmitDebugUtilsMessageEXT",
+    "vkGetAndroidHardwareBufferPropertiesANDROID",
+    "vkGetMemoryAndroidHardwareBufferANDROID",
+    "vkCmdSetSampleLocationsEXT",
+    "vkGetPhysicalDeviceMultisamplePropertiesEXT",
+    "vkGetImageDrmFormatModifierPropertiesEXT",
+    "vkCreateValidationCacheEXT",
+    "vkDestroyValidationCacheEXT",
+    "vkMergeValidationCachesEXT",
+    "vkGetValidationCacheDataEXT",
+    "vkCmdBindShadingRateImageNV",
+    "vkCmdSetViewportShadingRatePaletteNV",
+    "vkCmdSetCoarseSampleOrderNV",
+    "vkCreateAccelerationStructureNV",
+    "vkDestroyAccelerationStructureNV",
+    "vkGetAccelerationStructureMemoryRequirementsNV",
+    "vkBindAccelerationStructureMemoryNV",
+    "vkCmdBuildAccelerationStructureNV",
+    "vkCmdCopyAccelerationStructureNV",
+    "vkCmdTraceRaysNV",
+    "vkCreateRayTracingPipelinesNV",
+    "vkGetRayTracingShaderGroupHandlesNV",
+    "vkGetAccelerationStructureHandleNV",
+    "vkCmdWriteAccelerationStructuresPropertiesNV",
+    "vkCompileDeferredNV",
+    "vkGetMemoryHostPointerPropertiesEXT",
+    "vkCmdWriteBufferMarkerAMD",
+    "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT",
+    "vkGetCalibratedTimestampsEXT",
+    "vkCmdDrawMeshTasksNV",
+    "vkCmdDrawMeshTasksIndirectNV",
+    "vkCmdDrawMeshTasksIndirectCountNV",
+    "vkCmdSetExclusiveScissorNV",
+    "vkCmdSetCheckpointNV",
+    "vkGetQueueCheckpointDataNV",
+    "vkInitializePerformanceApiINTEL",
+    "vkUninitializePerformanceApiINTEL",
+    "vkCmdSetPerformanceMarkerINTEL",
+    "vkCmdSetPerformanceStreamMarkerINTEL",
+    "vkCmdSetPerformanceOverrideINTEL",
+    "vkAcquirePerformanceConfigurationINTEL",
+    "vkReleasePerformanceConfigurationINTEL",
+    "vkQueueSetPerformanceConfigurationINTEL",
+    "vkGetPerformanceParameterINTEL",
+    "vkSetLocalDimmingAMD",
+    "vkCreateImagePipeSurfaceFUCHSIA",
+    "vkCreateMetalSurfaceEXT",
+    "vkGetBufferDeviceAddressEXT",
+    "vkGetPhysicalDeviceToolPropertiesEXT",
+    "vkGetPhysicalDeviceCooperativeMatrixPropertiesNV",
+    "vkGetPhysicalDeviceSupportedFramebufferMixedSamplesCombinationsNV",
+    "vkGetPhysicalDeviceSurfacePresentModes2EXT",
+    "vkAcquireFullScreenExclusiveModeEXT",
+    "vkReleaseFullScreenExclusiveModeEXT",
+    "vkGetDeviceGroupSurfacePresentModes2EXT",
+    "vkCreateHeadlessSurfaceEXT",
+    "vkCmdSetLineStippleEXT",
+    "vkResetQueryPoolEXT",
 };
 
+// Object types counted in the statistics
+enum StatsObject {
+    STATS_OBJECT_VkAccelerationStructureNV,
+    STATS_OBJECT_VkBuffer,
+    STATS_OBJECT_VkBufferView,
+    STATS_OBJECT_VkCommandPool,
+    STATS_OBJECT_VkDebugReportCallbackEXT,
+    STATS_OBJECT_VkDebugUtilsMessengerEXT,
+    STATS_OBJECT_VkDescriptorPool,
+    STATS_OBJECT_VkDescriptorSet,
+    STATS_OBJECT_VkDescriptorSetLayout,
+    STATS_OBJECT_VkDescriptorUpdateTemplate,
+    STATS_OBJECT_VkDeviceMemory,
+    STATS_OBJECT_VkDisplayKHR,
+    STATS_OBJECT_VkDisplayModeKHR,
+    STATS_OBJECT_VkEvent,
+    STATS_OBJECT_VkFence,
+    STATS_OBJECT_VkFramebuffer,
+    STATS_OBJECT_VkImage,
+    STATS_OBJECT_VkImageView,
+    STATS_OBJECT_VkIndirectCommandsLayoutNVX,
+    STATS_OBJECT_VkObjectTableNVX,
+    STATS_OBJECT_VkPerformanceConfigurationINTEL,
+    STATS_OBJECT_VkPipeline,
+    STATS_OBJECT_VkPipelineCache,
+    STATS_OBJECT_VkPipelineLayout,
+    STATS_OBJECT_VkQueryPool,
+    STATS_OBJECT_VkRenderPass,
+    STATS_OBJECT_VkSampler,
+    STATS_OBJECT_VkSamplerYcbcrConversion,
+    STATS_OBJECT_VkSemaphore,
+    STATS_OBJECT_VkShaderModule,
+    STATS_OBJECT_VkSurfaceKHR,
+    STATS_OBJECT_VkSwapchainKHR,
+    STATS_OBJECT_VkValidationCacheEXT,
+    STATS_OBJECT_VkInstance,
+    STATS_OBJECT_VkPhysicalDevice,
+    STATS_OBJECT_VkDevice,
+    STATS_OBJECT_VkQueue,
+    STATS_OBJECT_VkCommandBuffer,
+    STATS_OBJECT_COUNT
+};
+static const char* const stats_object_names[STATS_OBJECT_COUNT] = {
+    "VkAccelerationStructureNV",
+    "VkBuffer",
+    "VkBufferView",
+    "VkCommandPool",
+    "VkDebugReportCallbackEXT",
+    "VkDebugUtilsMessengerEXT",
+    "VkDescriptorPool",
+    "VkDescriptorSet",
+    "VkDescriptorSetLayout",
+    "VkDescriptorUpdateTemplate",
+    "VkDeviceMemory",
+    "VkDisplayKHR",
+    "VkDisplayModeKHR",
+    "VkEvent",
+    "VkFence",
+    "VkFramebuffer",
+    "VkImage",
+    "VkImageView",
+    "VkIndirectCommandsLayoutNVX",
+    "VkObjectTableNVX",
+    "VkPerformanceConfigurationINTEL",
+    "VkPipeline",
+    "VkPipelineCache",
+    "VkPipelineLayout",
+    "VkQueryPool",
+    "VkRenderPass",
+    "VkSampler",
+    "VkSamplerYcbcrConversion",
+    "VkSemaphore",
+    "VkShaderModule",
+    "VkSurfaceKHR",
+    "VkSwapchainKHR",
+    "VkValidationCacheEXT",
+    "VkInstance",
+    "VkPhysicalDevice",
+    "VkDevice",
+    "VkQueue",
+    "VkCommandBuffer",
+};
+
+// Tables of the objects without state of their own
+static ObjectTable<ObjectState> acceleration_structure_nv_table(STATS_OBJECT_VkAccelerationStructureNV);
+static ObjectTable<ObjectState> buffer_view_table(STATS_OBJECT_VkBufferView);
+static ObjectTable<ObjectState> debug_report_callback_ext_table(STATS_OBJECT_VkDebugReportCallbackEXT);
+static ObjectTable<ObjectState> debug_utils_messenger_ext_table(STATS_OBJECT_VkDebugUtilsMessengerEXT);
+static ObjectTable<ObjectState> descriptor_update_template_table(STATS_OBJECT_VkDescriptorUpdateTemplate);
+static ObjectTable<ObjectState> display_khr_table(STATS_OBJECT_VkDisplayKHR);
+static ObjectTable<ObjectState> display_mode_khr_table(STATS_OBJECT_VkDisplayModeKHR);
+static ObjectTable<ObjectState> event_table(STATS_OBJECT_VkEvent);
+static ObjectTable<ObjectState> indirect_commands_layout_nvx_table(STATS_OBJECT_VkIndirectCommandsLayoutNVX);
+static ObjectTable<ObjectState> object_table_nvx_table(STATS_OBJECT_VkObjectTableNVX);
+static ObjectTable<ObjectState> performance_configuration_intel_table(STATS_OBJECT_VkPerformanceConfigurationINTEL);
+static ObjectTable<ObjectState> pipeline_layout_table(STATS_OBJECT_VkPipelineLayout);
+static ObjectTable<ObjectState> sampler_ycbcr_conversion_table(STATS_OBJECT_VkSamplerYcbcrConversion);
+static ObjectTable<ObjectState> surface_khr_table(STATS_OBJECT_VkSurfaceKHR);
+static ObjectTable<ObjectState> validation_cache_ext_table(STATS_OBJECT_VkValidationCacheEXT);
+
 
 } // namespace vkmock
 
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mock_icd_json.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace vkmock {
+
+bool JsonParser::Parse(JsonValue* value) {
+    if (!ParseValue(value, 0)) return false;
+    SkipSpace();
+    return *cursor_ == '\0';
+}
+
+void JsonParser::SkipSpace() {
+    while (*cursor_ == ' ' || *cursor_ == '\t' || *cursor_ == '\n' || *cursor_ == '\r') ++cursor_;
+}
+
+bool JsonParser::Consume(const char* literal) {
+    const size_t length = strlen(literal);
+    if (strncmp(cursor_, literal, length) != 0) return false;
+    cursor_ += length;
+    return true;
+}
+
+bool JsonParser::ParseValue(JsonValue* value, int depth) {
+    SkipSpace();
+    if (depth > MAX_DEPTH) return false;
+    switch (*cursor_) {
+        case '{': {
+            ++cursor_;
+            value->type = JsonValue::OBJECT;
+            SkipSpace();
+            if (Consume("}")) return true;
+            do {
+                SkipSpace();
+                value->keys.emplace_back();
+                value->elements.emplace_back();
+                if (!ParseString(&value->keys.back())) return false;
+                SkipSpace();
+                if (!Consume(":") || !ParseValue(&value->elements.back(), depth + 1)) return false;
+                SkipSpace();
+            } while (Consume(","));
+            return Consume("}");
+        }
+        case '[': {
+            ++cursor_;
+            value->type = JsonValue::ARRAY;
+            SkipSpace();
+            if (Consume("]")) return true;
+            do {
+                value->elements.emplace_back();
+                if (!ParseValue(&value->elements.back(), depth + 1)) return false;
+                SkipSpace();
+            } while (Consume(","));
+            return Consume("]");
+        }
+        case '"':
+            value->type = JsonValue::STRING;
+            return ParseString(&value->string);
+        case 't':
+            value->type = JsonValue::BOOLEAN;
+            value->boolean = true;
+            return Consume("true");
+        case 'f':
+            value->type = JsonValue::BOOLEAN;
+            return Consume("false");
+        case 'n':
+            return Consume("null");
+        default:
+            return ParseNumber(value);
+    }
+}
+
+bool JsonParser::ParseNumber(JsonValue* value) {
+    const char* start = cursor_;
+    char* end;
+    value->type = JsonValue::NUMBER;
+    value->number = strtod(start, &end);
+    if (end == start) return false;
+    cursor_ = end;
+    if (*start != '-' && strcspn(start, ".eE") >= (size_t)(end - start)) {
+        value->exact = true;
+        value->integer = strtoull(start, nullptr, 10);
+    }
+    return true;
+}
+
+bool JsonParser::ParseString(std::string* string) {
+    if (!Consume("\"")) return false;
+    while (*cursor_ != '"') {
+        char c = *cursor_++;
+        if (c == '\0') return false;
+        if (c == '\\') {
+            c = *cursor_++;
+            switch (c) {
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                case 'u': {
+                    // Names in profiles are ASCII, anything else is kept as UTF-8 of the BMP code point
+                    char digits[5] = {};
+                    for (int i = 0; i < 4; ++i) {
+                        if (!isxdigit((unsigned char)*cursor_)) return false;
+                        digits[i] = *cursor_++;
+                    }
+                    const unsigned long code_point = strtoul(digits, nullptr, 16);
+                    if (code_point < 0x80) {
+                        c = (char)code_point;
+                    } else if (code_point < 0x800) {
+                        string->push_back((char)(0xC0 | (code_point >> 6)));
+                        c = (char)(0x80 | (code_point & 0x3F));
+                    } else {
+                        string->push_back((char)(0xE0 | (code_point >> 12)));
+                        string->push_back((char)(0x80 | ((code_point >> 6) & 0x3F)));
+                        c = (char)(0x80 | (code_point & 0x3F));
+                    }
+                    break;
+                }
+                case '"':
+                case '\\':
+                case '/':
+                    break;
+                default:
+                    return false;
+            }
+        }
+        string->push_back(c);
+    }
+    ++cursor_;
+    return true;
+}
+
+bool ParseJsonFile(const char* path, JsonValue* value) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    std::string text;
+    char buffer[4096];
+    for (size_t size; (size = fread(buffer, 1, sizeof(buffer), file)) > 0;) text.append(buffer, size);
+    fclose(file);
+    return JsonParser(text.c_str()).Parse(value);
+}
+
+}  // namespace vkmock
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MOCK_ICD_JSON_H
+#define MOCK_ICD_JSON_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace vkmock {
+
+// Minimal JSON reader for the device profiles of VK_MOCK_PROFILE and the cost models of VK_MOCK_COST_MODEL. Values
+// are read into a tree of JsonValues. vulkaninfo only writes JSON, so the mock has its own reader.
+struct JsonValue {
+    enum Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+    Type type = NUL;
+    bool boolean = false;
+    double number = 0.0;
+    bool exact = false;  // Non-negative integer held exactly in integer, which a double may not be able to
+    uint64_t integer = 0;
+    std::string string;
+    std::vector<JsonValue> elements;  // Array elements or object member values
+    std::vector<std::string> keys;    // Object member names
+    const JsonValue* Find(const char* key) const {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] == key) return &elements[i];
+        }
+        return nullptr;
+    }
+};
+
+// Parses a whole text, false unless it is a single JSON value
+class JsonParser {
+   public:
+    explicit JsonParser(const char* text) : cursor_(text) {}
+    bool Parse(JsonValue* value);
+
+   private:
+    static const int MAX_DEPTH = 64;
+    void SkipSpace();
+    bool Consume(const char* literal);
+    bool ParseValue(JsonValue* value, int depth);
+    bool ParseNumber(JsonValue* value);
+    bool ParseString(std::string* string);
+
+    const char* cursor_;
+};
+
+// Reads and parses a whole file, false if it cannot be read or does not hold a single JSON value
+bool ParseJsonFile(const char* path, JsonValue* value);
+
+}  // namespace vkmock
+
+#endif  // MOCK_ICD_JSON_H
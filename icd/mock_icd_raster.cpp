@@ -0,0 +1,626 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mock_icd_raster.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+
+namespace vkmock {
+
+RasterStats raster_stats;
+
+void LogRasterFrame() {
+    static struct RasterLog {
+        RasterLog() {
+            const char* path = getenv("VK_MOCK_RASTER_LOG");
+            if (!path || !*path || !(file = fopen(path, "w"))) return;
+            fprintf(file, "frame,draws,triangles,fragments,vertex_us,binning_us,tiles_us\n");
+            fflush(file);
+        }
+        ~RasterLog() {
+            if (file) fclose(file);
+        }
+        FILE* file = nullptr;
+        std::mutex lock;  // Presents from several queues take turns
+        uint64_t frame = 0;
+    } log;
+    if (!log.file) return;
+    std::lock_guard<std::mutex> lock(log.lock);
+    fprintf(log.file, "%llu,%llu,%llu,%llu,%llu,%llu,%llu\n", (unsigned long long)log.frame++,
+            (unsigned long long)raster_stats.draws.exchange(0), (unsigned long long)raster_stats.triangles.exchange(0),
+            (unsigned long long)raster_stats.fragments.exchange(0), (unsigned long long)raster_stats.vertex_ns.exchange(0) / 1000,
+            (unsigned long long)raster_stats.binning_ns.exchange(0) / 1000, (unsigned long long)raster_stats.tile_ns.exchange(0) / 1000);
+    fflush(log.file);
+}
+
+bool ClipToRenderArea(const RenderPassInstance& instance, const VkRect2D& rect, VkRect2D* clipped) {
+    const VkRect2D& area = instance.render_area;
+    const int64_t x0 = std::max<int64_t>(rect.offset.x, area.offset.x);
+    const int64_t y0 = std::max<int64_t>(rect.offset.y, area.offset.y);
+    const int64_t x1 = std::min<int64_t>((int64_t)rect.offset.x + rect.extent.width, (int64_t)area.offset.x + area.extent.width);
+    const int64_t y1 = std::min<int64_t>((int64_t)rect.offset.y + rect.extent.height, (int64_t)area.offset.y + area.extent.height);
+    if (x1 <= x0 || y1 <= y0) return false;
+    *clipped = {{(int32_t)x0, (int32_t)y0}, {(uint32_t)(x1 - x0), (uint32_t)(y1 - y0)}};
+    return true;
+}
+
+void AddRasterClear(RenderPassInstance* instance, const RasterClear& clear) {
+    const uint32_t index = RASTER_CLEAR_BIT | (uint32_t)instance->clears.size();
+    instance->clears.push_back(clear);
+    const uint32_t tx0 = clear.rect.offset.x / RASTER_TILE_SIZE, ty0 = clear.rect.offset.y / RASTER_TILE_SIZE;
+    const uint32_t tx1 = (clear.rect.offset.x + clear.rect.extent.width - 1) / RASTER_TILE_SIZE;
+    const uint32_t ty1 = (clear.rect.offset.y + clear.rect.extent.height - 1) / RASTER_TILE_SIZE;
+    for (uint32_t ty = ty0; ty <= ty1; ++ty) {
+        for (uint32_t tx = tx0; tx <= tx1; ++tx) instance->bins[ty * instance->tiles_x + tx].push_back(index);
+    }
+}
+
+// Texel of an attachment, null outside it
+static inline char* GetAttachmentTexel(const RasterAttachment& attachment, int32_t x, int32_t y) {
+    if ((uint32_t)x >= attachment.width || (uint32_t)y >= attachment.height) return nullptr;
+    return attachment.data + (VkDeviceSize)y * attachment.row_pitch + (VkDeviceSize)x * attachment.texel_size;
+}
+
+static const uint32_t RASTER_CLIP_PLANES = 7;
+
+// Distance of a clip space position from a clipping plane, negative outside
+static inline float GetClipDistance(const float* position, uint32_t plane, const RasterSetup& setup) {
+    switch (plane) {
+        case 0: return position[3] - RASTER_MIN_W;
+        case 1: return (float)(position[3] * setup.guard[0] + position[0]);
+        case 2: return (float)(position[3] * setup.guard[0] - position[0]);
+        case 3: return (float)(position[3] * setup.guard[1] + position[1]);
+        case 4: return (float)(position[3] * setup.guard[1] - position[1]);
+        case 5: return position[2];
+        default: return position[3] - position[2];
+    }
+}
+
+// Planes a vertex is outside of, a bit each. Depth clamp leaves out the near and far planes.
+static uint32_t GetClipOutcode(const RasterDraw& draw, uint32_t vertex, const RasterSetup& setup) {
+    float position[RASTER_POSITION_WORDS];
+    memcpy(position, &draw.vertices[(size_t)vertex * draw.vertex_size], sizeof(position));
+    const uint32_t plane_count = setup.depth_clamp ? 5 : RASTER_CLIP_PLANES;
+    uint32_t outcode = 0;
+    for (uint32_t plane = 0; plane < plane_count; ++plane) {
+        if (!(GetClipDistance(position, plane, setup) >= 0.0f)) outcode |= 1u << plane;
+    }
+    return outcode;
+}
+
+// Clips a polygon to the planes in outcode, adding the vertices that makes to the draw
+static void ClipRasterPolygon(RasterDraw* draw, const RasterSetup& setup, uint32_t outcode, std::vector<uint32_t>* polygon) {
+    std::vector<uint32_t> clipped;
+    for (uint32_t plane = 0; plane < RASTER_CLIP_PLANES && polygon->size() >= 3; ++plane) {
+        if (!(outcode >> plane & 1)) continue;
+        clipped.clear();
+        for (size_t i = 0; i < polygon->size(); ++i) {
+            const uint32_t from = (*polygon)[i], to = (*polygon)[(i + 1) % polygon->size()];
+            float from_position[RASTER_POSITION_WORDS], to_position[RASTER_POSITION_WORDS];
+            memcpy(from_position, &draw->vertices[(size_t)from * draw->vertex_size], sizeof(from_position));
+            memcpy(to_position, &draw->vertices[(size_t)to * draw->vertex_size], sizeof(to_position));
+            const float from_distance = GetClipDistance(from_position, plane, setup);
+            const float to_distance = GetClipDistance(to_position, plane, setup);
+            if (from_distance >= 0.0f) clipped.push_back(from);
+            if ((from_distance >= 0.0f) == (to_distance >= 0.0f)) continue;
+            // Every word is interpolated as a float, flat inputs come from the provoking vertex anyway
+            const float t = from_distance / (from_distance - to_distance);
+            const size_t size = draw->vertex_size;
+            const uint32_t vertex = (uint32_t)(draw->vertices.size() / size);
+            draw->vertices.resize(draw->vertices.size() + size);
+            const uint32_t* a = &draw->vertices[(size_t)from * size];
+            const uint32_t* b = &draw->vertices[(size_t)to * size];
+            uint32_t* result = &draw->vertices[(size_t)vertex * size];
+            for (size_t w = 0; w < size; ++w) result[w] = ShaderBits(ShaderFloat(a[w]) + t * (ShaderFloat(b[w]) - ShaderFloat(a[w])));
+            clipped.push_back(vertex);
+        }
+        polygon->swap(clipped);
+    }
+}
+
+static inline int64_t FloorDivide(int64_t value, int64_t divisor) {
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+// Sets up a triangle inside the clip volume and bins it into the tiles it may cover
+static void SetUpRasterTriangle(RenderPassInstance* instance, const RasterDraw& draw, uint32_t draw_index, const RasterSetup& setup,
+                                const uint32_t vertices[3], uint32_t provoking) {
+    RasterTriangle triangle;
+    triangle.draw = draw_index;
+    triangle.provoking = provoking;
+    int64_t x[3], y[3];
+    const VkViewport& viewport = setup.viewport;
+    for (uint32_t i = 0; i < 3; ++i) {
+        float position[RASTER_POSITION_WORDS];
+        memcpy(position, &draw.vertices[(size_t)vertices[i] * draw.vertex_size], sizeof(position));
+        const double inv_w = 1.0 / position[3];
+        const double window_x = viewport.x + viewport.width * 0.5 * (position[0] * inv_w + 1.0);
+        const double window_y = viewport.y + viewport.height * 0.5 * (position[1] * inv_w + 1.0);
+        if (!(std::fabs(window_x) < 1e7) || !(std::fabs(window_y) < 1e7)) return;
+        x[i] = (int64_t)std::llround(window_x * RASTER_SUBPIXELS);
+        y[i] = (int64_t)std::llround(window_y * RASTER_SUBPIXELS);
+        triangle.vertices[i] = vertices[i];
+        triangle.z[i] = (float)(viewport.minDepth + (viewport.maxDepth - viewport.minDepth) * position[2] * inv_w);
+        triangle.inv_w[i] = (float)inv_w;
+    }
+    const int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (area == 0) return;
+    // Window coordinates have y pointing down, so counter-clockwise triangles have a negative area here
+    triangle.front_facing = setup.counter_clockwise ? area < 0 : area > 0;
+    if ((setup.cull_mode & VK_CULL_MODE_FRONT_BIT) && triangle.front_facing) return;
+    if ((setup.cull_mode & VK_CULL_MODE_BACK_BIT) && !triangle.front_facing) return;
+    if (area < 0) {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(triangle.vertices[1], triangle.vertices[2]);
+        std::swap(triangle.z[1], triangle.z[2]);
+        std::swap(triangle.inv_w[1], triangle.inv_w[2]);
+    }
+    triangle.inv_area = 1.0 / (double)(area < 0 ? -area : area);
+    for (uint32_t i = 0; i < 3; ++i) {
+        const uint32_t p = (i + 1) % 3, q = (i + 2) % 3;
+        triangle.a[i] = y[p] - y[q];
+        triangle.b[i] = x[q] - x[p];
+        triangle.c[i] = -(triangle.a[i] * x[p] + triangle.b[i] * y[p]);
+        // Pixel centers on an edge belong to the triangle when it is a top or left edge
+        if (!(triangle.a[i] > 0 || (triangle.a[i] == 0 && triangle.b[i] > 0))) triangle.c[i] -= 1;
+    }
+    // Pixels whose centers are within the bounding box
+    const int64_t half = RASTER_SUBPIXELS / 2;
+    const int64_t min_x = std::min(x[0], std::min(x[1], x[2])), max_x = std::max(x[0], std::max(x[1], x[2]));
+    const int64_t min_y = std::min(y[0], std::min(y[1], y[2])), max_y = std::max(y[0], std::max(y[1], y[2]));
+    triangle.x0 = (int32_t)std::max<int64_t>(setup.bounds[0], FloorDivide(min_x - half + RASTER_SUBPIXELS - 1, RASTER_SUBPIXELS));
+    triangle.y0 = (int32_t)std::max<int64_t>(setup.bounds[1], FloorDivide(min_y - half + RASTER_SUBPIXELS - 1, RASTER_SUBPIXELS));
+    triangle.x1 = (int32_t)std::min<int64_t>(setup.bounds[2], FloorDivide(max_x - half, RASTER_SUBPIXELS) + 1);
+    triangle.y1 = (int32_t)std::min<int64_t>(setup.bounds[3], FloorDivide(max_y - half, RASTER_SUBPIXELS) + 1);
+    if (triangle.x1 <= triangle.x0 || triangle.y1 <= triangle.y0 || instance->triangles.size() >= RASTER_CLEAR_BIT) return;
+    const uint32_t index = (uint32_t)instance->triangles.size();
+    instance->triangles.push_back(triangle);
+    raster_stats.triangles++;
+    // Tiles all of whose pixels are outside an edge are left out
+    for (int32_t ty = triangle.y0 / RASTER_TILE_SIZE; ty <= (triangle.y1 - 1) / RASTER_TILE_SIZE; ++ty) {
+        const int64_t top = std::max(triangle.y0, ty * RASTER_TILE_SIZE) * RASTER_SUBPIXELS + half;
+        const int64_t bottom = (std::min(triangle.y1, (ty + 1) * RASTER_TILE_SIZE) - 1) * RASTER_SUBPIXELS + half;
+        for (int32_t tx = triangle.x0 / RASTER_TILE_SIZE; tx <= (triangle.x1 - 1) / RASTER_TILE_SIZE; ++tx) {
+            const int64_t left = std::max(triangle.x0, tx * RASTER_TILE_SIZE) * RASTER_SUBPIXELS + half;
+            const int64_t right = (std::min(triangle.x1, (tx + 1) * RASTER_TILE_SIZE) - 1) * RASTER_SUBPIXELS + half;
+            bool outside = false;
+            for (uint32_t i = 0; i < 3 && !outside; ++i) {
+                outside = triangle.a[i] * (triangle.a[i] > 0 ? right : left) + triangle.b[i] * (triangle.b[i] > 0 ? bottom : top) + triangle.c[i] < 0;
+            }
+            if (!outside) instance->bins[ty * instance->tiles_x + tx].push_back(index);
+        }
+    }
+}
+
+void AddRasterTriangle(RenderPassInstance* instance, RasterDraw* draw, uint32_t draw_index, const RasterSetup& setup,
+                       const uint32_t vertices[3], std::vector<uint32_t>* polygon) {
+    const uint32_t outcodes[3] = {GetClipOutcode(*draw, vertices[0], setup), GetClipOutcode(*draw, vertices[1], setup),
+                                  GetClipOutcode(*draw, vertices[2], setup)};
+    if (outcodes[0] & outcodes[1] & outcodes[2]) return;
+    if (!(outcodes[0] | outcodes[1] | outcodes[2])) {
+        SetUpRasterTriangle(instance, *draw, draw_index, setup, vertices, vertices[0]);
+        return;
+    }
+    polygon->assign(vertices, vertices + 3);
+    ClipRasterPolygon(draw, setup, outcodes[0] | outcodes[1] | outcodes[2], polygon);
+    for (size_t i = 2; i < polygon->size(); ++i) {
+        const uint32_t fan[3] = {(*polygon)[0], (*polygon)[i - 1], (*polygon)[i]};
+        SetUpRasterTriangle(instance, *draw, draw_index, setup, fan, vertices[0]);
+    }
+}
+
+static inline bool CompareDepth(VkCompareOp op, float depth, float stored) {
+    switch (op) {
+        case VK_COMPARE_OP_NEVER: return false;
+        case VK_COMPARE_OP_LESS: return depth < stored;
+        case VK_COMPARE_OP_EQUAL: return depth == stored;
+        case VK_COMPARE_OP_LESS_OR_EQUAL: return depth <= stored;
+        case VK_COMPARE_OP_GREATER: return depth > stored;
+        case VK_COMPARE_OP_NOT_EQUAL: return depth != stored;
+        case VK_COMPARE_OP_GREATER_OR_EQUAL: return depth >= stored;
+        default: return true;
+    }
+}
+
+// Dual source factors are not supported and give 0
+static inline float GetBlendFactor(VkBlendFactor factor, const float* source, const float* destination, const float* constants, uint32_t channel) {
+    switch (factor) {
+        case VK_BLEND_FACTOR_ZERO: return 0.0f;
+        case VK_BLEND_FACTOR_ONE: return 1.0f;
+        case VK_BLEND_FACTOR_SRC_COLOR: return source[channel];
+        case VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR: return 1.0f - source[channel];
+        case VK_BLEND_FACTOR_DST_COLOR: return destination[channel];
+        case VK_BLEND_FACTOR_ONE_MINUS_DST_COLOR: return 1.0f - destination[channel];
+        case VK_BLEND_FACTOR_SRC_ALPHA: return source[3];
+        case VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA: return 1.0f - source[3];
+        case VK_BLEND_FACTOR_DST_ALPHA: return destination[3];
+        case VK_BLEND_FACTOR_ONE_MINUS_DST_ALPHA: return 1.0f - destination[3];
+        case VK_BLEND_FACTOR_CONSTANT_COLOR: return constants[channel];
+        case VK_BLEND_FACTOR_ONE_MINUS_CONSTANT_COLOR: return 1.0f - constants[channel];
+        case VK_BLEND_FACTOR_CONSTANT_ALPHA: return constants[3];
+        case VK_BLEND_FACTOR_ONE_MINUS_CONSTANT_ALPHA: return 1.0f - constants[3];
+        case VK_BLEND_FACTOR_SRC_ALPHA_SATURATE: return channel == 3 ? 1.0f : std::min(source[3], 1.0f - destination[3]);
+        default: return 0.0f;
+    }
+}
+
+// Advanced blend ops are not supported and add
+static inline float BlendChannel(VkBlendOp op, float source, float source_factor, float destination, float destination_factor) {
+    switch (op) {
+        case VK_BLEND_OP_SUBTRACT: return source * source_factor - destination * destination_factor;
+        case VK_BLEND_OP_REVERSE_SUBTRACT: return destination * destination_factor - source * source_factor;
+        case VK_BLEND_OP_MIN: return std::min(source, destination);
+        case VK_BLEND_OP_MAX: return std::max(source, destination);
+        default: return source * source_factor + destination * destination_factor;
+    }
+}
+
+// 2x2 pixels a triangle covers some of, shaded together for derivatives
+struct RasterQuad {
+    uint32_t triangle;
+    int32_t x;  // Top left pixel
+    int32_t y;
+    uint32_t mask;  // Covered pixels, a bit per lane: top left, top right, bottom left, bottom right
+    float depth[4];
+};
+
+// Renders the tiles of a subpass, one at a time. Tiles hold the colors of the subpass's color attachments as
+// VkClearColorValue, converted from and to their formats when they are loaded and stored, and depth as floats. Each
+// thread rendering tiles needs its own renderer.
+class RasterTileRenderer {
+   public:
+    explicit RasterTileRenderer(const RenderPassInstance& instance)
+        : instance_(instance), subpass_(instance.render_pass.subpasses[instance.subpass]) {
+        for (uint32_t attachment : subpass_.colors) color_attachments_.push_back(GetAttachment(attachment));
+        depth_attachment_ = GetAttachment(subpass_.depth_stencil);
+        colors_.resize(color_attachments_.size() * RASTER_TILE_PIXELS);
+        depth_.resize(RASTER_TILE_PIXELS);
+    }
+
+    // Renders the pixels from x0, y0 to x1, y1 of the tile at tile_x, tile_y, all within the render area
+    void Render(int32_t tile_x, int32_t tile_y, int32_t x0, int32_t y0, int32_t x1, int32_t y1, const std::vector<uint32_t>& bin) {
+        tile_x_ = tile_x, tile_y_ = tile_y;
+        x0_ = x0, y0_ = y0, x1_ = x1, y1_ = y1;
+        Load();
+        for (uint32_t entry : bin) {
+            if (entry & RASTER_CLEAR_BIT) {
+                Flush();
+                Clear(instance_.clears[entry & ~RASTER_CLEAR_BIT]);
+            } else {
+                Rasterize(entry);
+            }
+        }
+        Flush();
+        Store();
+    }
+
+    uint64_t GetFragmentCount() const { return fragments_; }
+
+   private:
+    const RasterAttachment* GetAttachment(uint32_t attachment) const {
+        if (attachment >= instance_.attachments.size() || !instance_.attachments[attachment].format_info) return nullptr;
+        return &instance_.attachments[attachment];
+    }
+
+    uint32_t GetPixel(int32_t x, int32_t y) const { return (uint32_t)((y - tile_y_) * RASTER_TILE_SIZE + (x - tile_x_)); }
+
+    // Whether the subpass is the first to use an attachment, whose load op clears it then
+    bool ClearsOnLoad(uint32_t attachment) const {
+        return instance_.render_pass.attachments[attachment].loadOp == VK_ATTACHMENT_LOAD_OP_CLEAR &&
+               instance_.render_pass.first_subpasses[attachment] == instance_.subpass;
+    }
+
+    bool StoresOnEnd(uint32_t attachment) const {
+        return instance_.render_pass.attachments[attachment].storeOp != VK_ATTACHMENT_STORE_OP_DONT_CARE ||
+               instance_.render_pass.last_subpasses[attachment] != instance_.subpass;
+    }
+
+    // Texels of row y of the tile within an attachment, which start at x0_
+    uint32_t GetRowTexels(const RasterAttachment& attachment, int32_t y) const {
+        if ((uint32_t)y >= attachment.height || (uint32_t)x0_ >= attachment.width) return 0;
+        return (uint32_t)(std::min<int64_t>(x1_, attachment.width) - x0_);
+    }
+
+    void Load() {
+        for (size_t color = 0; color < color_attachments_.size(); ++color) {
+            const RasterAttachment* attachment = color_attachments_[color];
+            if (!attachment) continue;
+            const bool clear = ClearsOnLoad(subpass_.colors[color]);
+            VkClearColorValue* colors = &colors_[color * RASTER_TILE_PIXELS];
+            for (int32_t y = y0_; y < y1_; ++y) {
+                if (clear) {
+                    for (int32_t x = x0_; x < x1_; ++x) colors[GetPixel(x, y)] = attachment->clear_value.color;
+                } else if (const uint32_t count = GetRowTexels(*attachment, y)) {
+                    LoadRasterColors(*attachment, GetAttachmentTexel(*attachment, x0_, y), count, &colors[GetPixel(x0_, y)]);
+                }
+            }
+        }
+        if (depth_attachment_) {
+            const bool clear = ClearsOnLoad(subpass_.depth_stencil);
+            for (int32_t y = y0_; y < y1_; ++y) {
+                if (clear) {
+                    for (int32_t x = x0_; x < x1_; ++x) depth_[GetPixel(x, y)] = depth_attachment_->clear_value.depthStencil.depth;
+                } else if (const uint32_t count = GetRowTexels(*depth_attachment_, y)) {
+                    LoadRasterDepths(*depth_attachment_, GetAttachmentTexel(*depth_attachment_, x0_, y), count, &depth_[GetPixel(x0_, y)]);
+                }
+            }
+        }
+    }
+
+    void Store() {
+        for (size_t color = 0; color < color_attachments_.size(); ++color) {
+            const RasterAttachment* attachment = color_attachments_[color];
+            if (!attachment || !StoresOnEnd(subpass_.colors[color])) continue;
+            const VkClearColorValue* colors = &colors_[color * RASTER_TILE_PIXELS];
+            for (int32_t y = y0_; y < y1_; ++y) {
+                if (const uint32_t count = GetRowTexels(*attachment, y)) {
+                    StoreRasterColors(*attachment, &colors[GetPixel(x0_, y)], count, GetAttachmentTexel(*attachment, x0_, y));
+                }
+            }
+        }
+        if (depth_attachment_ && StoresOnEnd(subpass_.depth_stencil)) {
+            for (int32_t y = y0_; y < y1_; ++y) {
+                if (const uint32_t count = GetRowTexels(*depth_attachment_, y)) {
+                    StoreRasterDepths(*depth_attachment_, &depth_[GetPixel(x0_, y)], count, GetAttachmentTexel(*depth_attachment_, x0_, y));
+                }
+            }
+        }
+    }
+
+    void Clear(const RasterClear& clear) {
+        const RasterAttachment* attachment = clear.color == UINT32_MAX ? depth_attachment_ : color_attachments_[clear.color];
+        if (!attachment) return;
+        const int32_t x0 = std::max(x0_, clear.rect.offset.x), x1 = std::min(x1_, clear.rect.offset.x + (int32_t)clear.rect.extent.width);
+        const int32_t y0 = std::max(y0_, clear.rect.offset.y), y1 = std::min(y1_, clear.rect.offset.y + (int32_t)clear.rect.extent.height);
+        for (int32_t y = y0; y < y1; ++y) {
+            for (int32_t x = x0; x < x1; ++x) {
+                if (clear.color == UINT32_MAX) {
+                    depth_[GetPixel(x, y)] = clear.value.depthStencil.depth;
+                } else {
+                    colors_[clear.color * RASTER_TILE_PIXELS + GetPixel(x, y)] = clear.value.color;
+                }
+            }
+        }
+    }
+
+    // Tests a fragment's depth and writes it when it passes, clamping it as the attachment's format does
+    bool TestDepth(const RasterDraw& draw, uint32_t pixel, float depth) {
+        const RasterPipeline& pipeline = *draw.pipeline;
+        if (!depth_attachment_ || !pipeline.depth_test) return true;
+        if (pipeline.depth_clamp) depth = std::min(std::max(depth, draw.min_depth), draw.max_depth);
+        depth = std::min(std::max(depth, depth_attachment_->low), depth_attachment_->high);
+        if (!CompareDepth(pipeline.depth_compare, depth, depth_[pixel])) return false;
+        if (pipeline.depth_write) depth_[pixel] = depth;
+        return true;
+    }
+
+    void Rasterize(uint32_t index) {
+        const RasterTriangle& triangle = instance_.triangles[index];
+        const RasterDraw& draw = *instance_.draws[triangle.draw];
+        if (&draw != draw_) {
+            Flush();
+            draw_ = &draw;
+            shader_ = nullptr;
+            if (const ShaderProgram* program = draw.pipeline->fragment.get()) {
+                std::unique_ptr<ShaderInvocations>& shader = shaders_[program];
+                if (!shader) shader.reset(new ShaderInvocations(program, draw.regions));
+                shader->Bind(draw.regions, draw.textures, draw.texture_count);
+                shader_ = shader.get();
+            }
+        }
+        const int32_t x0 = std::max(x0_, triangle.x0), x1 = std::min(x1_, triangle.x1);
+        const int32_t y0 = std::max(y0_, triangle.y0), y1 = std::min(y1_, triangle.y1);
+        const int64_t half = RASTER_SUBPIXELS / 2;
+        // Quads start at even pixels, as do tiles
+        for (int32_t qy = y0 & ~1; qy < y1; qy += 2) {
+            for (int32_t qx = x0 & ~1; qx < x1; qx += 2) {
+                RasterQuad quad;
+                quad.triangle = index;
+                quad.x = qx;
+                quad.y = qy;
+                quad.mask = 0;
+                for (uint32_t lane = 0; lane < 4; ++lane) {
+                    const int32_t x = qx + (int32_t)(lane & 1), y = qy + (int32_t)(lane >> 1);
+                    const int64_t sx = x * RASTER_SUBPIXELS + half, sy = y * RASTER_SUBPIXELS + half;
+                    int64_t edges[3];
+                    for (uint32_t i = 0; i < 3; ++i) edges[i] = triangle.a[i] * sx + triangle.b[i] * sy + triangle.c[i];
+                    // Relative to the first vertex, so triangles of constant depth get exactly that depth
+                    quad.depth[lane] = (float)(triangle.z[0] + (edges[1] * ((double)triangle.z[1] - triangle.z[0]) +
+                                                                edges[2] * ((double)triangle.z[2] - triangle.z[0])) *
+                                                                   triangle.inv_area);
+                    if (x < x0 || x >= x1 || y < y0 || y >= y1 || edges[0] < 0 || edges[1] < 0 || edges[2] < 0) continue;
+                    if (!draw.late_depth && !TestDepth(draw, GetPixel(x, y), quad.depth[lane])) continue;
+                    quad.mask |= 1u << lane;
+                }
+                if (!quad.mask) continue;
+                if (!shader_) {
+                    for (uint32_t mask = quad.mask; mask; mask &= mask - 1) fragments_++;
+                    continue;
+                }
+                quads_.push_back(quad);
+                if (quads_.size() == RASTER_QUAD_BATCH) Flush();
+            }
+        }
+    }
+
+    // Shades the quads of the batch, then tests the depth of their fragments if that comes late and writes them out
+    void Flush() {
+        if (quads_.empty()) return;
+        const RasterDraw& draw = *draw_;
+        const int64_t half = RASTER_SUBPIXELS / 2;
+        shader_->Begin((uint32_t)quads_.size() * 4);
+        for (size_t q = 0; q < quads_.size(); ++q) {
+            const RasterQuad& quad = quads_[q];
+            const RasterTriangle& triangle = instance_.triangles[quad.triangle];
+            const uint32_t* vertices[3];
+            for (uint32_t i = 0; i < 3; ++i) vertices[i] = &draw.vertices[(size_t)triangle.vertices[i] * draw.vertex_size];
+            const uint32_t* provoking = &draw.vertices[(size_t)triangle.provoking * draw.vertex_size];
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                const int32_t x = quad.x + (int32_t)(lane & 1), y = quad.y + (int32_t)(lane >> 1);
+                const int64_t sx = x * RASTER_SUBPIXELS + half, sy = y * RASTER_SUBPIXELS + half;
+                // Barycentric coordinates, then weighted by 1 / w for perspective correct interpolation. Helper
+                // invocations outside the triangle extrapolate.
+                float linear[3], perspective[3];
+                float inv_w = 0.0f;
+                for (uint32_t i = 0; i < 3; ++i) {
+                    linear[i] = (float)((triangle.a[i] * sx + triangle.b[i] * sy + triangle.c[i]) * triangle.inv_area);
+                    perspective[i] = linear[i] * triangle.inv_w[i];
+                    inv_w += perspective[i];
+                }
+                for (uint32_t i = 0; i < 3; ++i) perspective[i] = inv_w != 0.0f ? perspective[i] / inv_w : linear[i];
+                char* memory = shader_->GetInvocationMemory((uint32_t)q * 4 + lane);
+                for (const auto& varying : draw.varyings) {
+                    uint32_t value[4] = {};
+                    switch (varying.built_in) {
+                        case SPIRV_BUILT_IN_FRAG_COORD:
+                            value[0] = ShaderBits(x + 0.5f);
+                            value[1] = ShaderBits(y + 0.5f);
+                            value[2] = ShaderBits(quad.depth[lane]);
+                            value[3] = ShaderBits(inv_w);
+                            break;
+                        case SPIRV_BUILT_IN_FRONT_FACING: value[0] = triangle.front_facing; break;
+                        case SPIRV_BUILT_IN_HELPER_INVOCATION: value[0] = !(quad.mask >> lane & 1); break;
+                        case SPIRV_BUILT_IN_NONE: {
+                            const float* weights = varying.interpolation == SPIRV_DECORATION_NO_PERSPECTIVE ? linear : perspective;
+                            for (uint32_t w = 0; w < varying.words && w < 4; ++w) {
+                                const uint32_t word = varying.word + w;
+                                const float base = ShaderFloat(vertices[0][word]);
+                                // Relative to the first vertex as well, keeping values all three share exact
+                                value[w] = varying.interpolation == SPIRV_DECORATION_FLAT
+                                               ? provoking[word]
+                                               : ShaderBits(base + weights[1] * (ShaderFloat(vertices[1][word]) - base) +
+                                                            weights[2] * (ShaderFloat(vertices[2][word]) - base));
+                            }
+                            break;
+                        }
+                        default:
+                            break;
+                    }
+                    memcpy(memory + varying.offset, value, std::min<uint32_t>(varying.words, 4) * sizeof(uint32_t));
+                }
+            }
+        }
+        shader_->Run();
+        for (size_t q = 0; q < quads_.size(); ++q) {
+            const RasterQuad& quad = quads_[q];
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                const uint32_t invocation = (uint32_t)q * 4 + lane;
+                if (!(quad.mask >> lane & 1) || shader_->Killed(invocation)) continue;
+                const uint32_t pixel = GetPixel(quad.x + (int32_t)(lane & 1), quad.y + (int32_t)(lane >> 1));
+                const char* memory = shader_->GetInvocationMemory(invocation);
+                if (draw.late_depth) {
+                    float depth = quad.depth[lane];
+                    if (draw.frag_depth != UINT32_MAX) memcpy(&depth, memory + draw.frag_depth, sizeof(depth));
+                    if (!TestDepth(draw, pixel, depth)) continue;
+                }
+                fragments_++;
+                for (const auto& output : draw.outputs) {
+                    if (output.color >= color_attachments_.size() || !color_attachments_[output.color]) continue;
+                    VkClearColorValue source = {};
+                    memcpy(&source, memory + output.offset, output.size);
+                    WriteColor(draw, output.color, pixel, source);
+                }
+            }
+        }
+        quads_.clear();
+    }
+
+    void WriteColor(const RasterDraw& draw, uint32_t color, uint32_t pixel, VkClearColorValue source) {
+        const RasterAttachment& attachment = *color_attachments_[color];
+        VkClearColorValue& destination = colors_[color * RASTER_TILE_PIXELS + pixel];
+        const auto& blend_attachments = draw.pipeline->blend_attachments;
+        const VkPipelineColorBlendAttachmentState* blend = color < blend_attachments.size() ? &blend_attachments[color] : nullptr;
+        if (!attachment.integer) {
+            for (uint32_t c = 0; c < 4; ++c) source.float32[c] = std::min(std::max(source.float32[c], attachment.low), attachment.high);
+        }
+        VkClearColorValue result = source;
+        if (!attachment.integer && blend && blend->blendEnable) {
+            const float* s = source.float32;
+            const float* d = destination.float32;
+            for (uint32_t c = 0; c < 4; ++c) {
+                const bool alpha = c == 3;
+                const float source_factor = GetBlendFactor(alpha ? blend->srcAlphaBlendFactor : blend->srcColorBlendFactor, s, d, draw.blend_constants, c);
+                const float destination_factor =
+                    GetBlendFactor(alpha ? blend->dstAlphaBlendFactor : blend->dstColorBlendFactor, s, d, draw.blend_constants, c);
+                result.float32[c] = BlendChannel(alpha ? blend->alphaBlendOp : blend->colorBlendOp, s[c], source_factor, d[c], destination_factor);
+            }
+        }
+        const VkColorComponentFlags write_mask = blend ? blend->colorWriteMask : 0xF;
+        for (uint32_t c = 0; c < 4; ++c) {
+            if (write_mask >> c & 1) destination.uint32[c] = result.uint32[c];
+        }
+    }
+
+    const RenderPassInstance& instance_;
+    const RenderSubpass& subpass_;
+    std::vector<const RasterAttachment*> color_attachments_;  // Null for unused ones and those not rendered to
+    const RasterAttachment* depth_attachment_ = nullptr;
+    std::vector<VkClearColorValue> colors_;  // A tile per color attachment
+    std::vector<float> depth_;
+    int32_t tile_x_ = 0, tile_y_ = 0;
+    int32_t x0_ = 0, y0_ = 0, x1_ = 0, y1_ = 0;
+    const RasterDraw* draw_ = nullptr;       // Of the quads batched
+    ShaderInvocations* shader_ = nullptr;    // Null without a fragment shader
+    std::map<const ShaderProgram*, std::unique_ptr<ShaderInvocations>> shaders_;
+    std::vector<RasterQuad> quads_;
+    uint64_t fragments_ = 0;
+};
+
+void RenderTiles(RenderPassInstance* instance) {
+    const auto start = std::chrono::steady_clock::now();
+    const RenderSubpass& subpass = instance->render_pass.subpasses[instance->subpass];
+    bool clears_on_load = false;
+    std::vector<uint32_t> used(subpass.colors);
+    used.push_back(subpass.depth_stencil);
+    for (uint32_t attachment : used) {
+        if (attachment < instance->attachments.size() && instance->attachments[attachment].format_info &&
+            instance->render_pass.attachments[attachment].loadOp == VK_ATTACHMENT_LOAD_OP_CLEAR &&
+            instance->render_pass.first_subpasses[attachment] == instance->subpass) {
+            clears_on_load = true;
+        }
+    }
+    if (clears_on_load || !instance->triangles.empty() || !instance->clears.empty()) {
+        std::vector<std::unique_ptr<RasterTileRenderer>> renderers(compute_pool.GetThreadCount());
+        const VkRect2D& area = instance->render_area;
+        compute_pool.Run(instance->bins.size(), [&](uint32_t thread, uint64_t tile) {
+            if (instance->bins[tile].empty() && !clears_on_load) return;
+            const int32_t tile_x = (int32_t)(tile % instance->tiles_x) * RASTER_TILE_SIZE;
+            const int32_t tile_y = (int32_t)(tile / instance->tiles_x) * RASTER_TILE_SIZE;
+            const int32_t x0 = std::max(tile_x, area.offset.x), x1 = std::min(tile_x + RASTER_TILE_SIZE, area.offset.x + (int32_t)area.extent.width);
+            const int32_t y0 = std::max(tile_y, area.offset.y), y1 = std::min(tile_y + RASTER_TILE_SIZE, area.offset.y + (int32_t)area.extent.height);
+            if (x1 <= x0 || y1 <= y0) return;
+            if (!renderers[thread]) renderers[thread].reset(new RasterTileRenderer(*instance));
+            renderers[thread]->Render(tile_x, tile_y, x0, y0, x1, y1, instance->bins[tile]);
+        });
+        for (const auto& renderer : renderers) {
+            if (renderer) raster_stats.fragments += renderer->GetFragmentCount();
+        }
+    }
+    for (auto& bin : instance->bins) bin.clear();
+    instance->draws.clear();
+    instance->triangles.clear();
+    instance->clears.clear();
+    raster_stats.tile_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace vkmock
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MOCK_ICD_RASTER_H
+#define MOCK_ICD_RASTER_H
+
+#include <stdint.h>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "vulkan/vulkan.h"
+#include "mock_icd_shader.h"
+
+namespace vkmock {
+
+// Draws in render passes are rasterized in software when VK_MOCK_RASTERIZE is set, for the pipelines
+// CreateRasterPipeline accepts. Each draw shades its vertices right away on the compute pool, then the queue's thread
+// assembles, clips and sets up its triangles and bins them into tiles of the framebuffer. At the end of each subpass
+// the tiles are rendered in parallel, each by one thread going through its bin in order: it loads the tile of every
+// attachment of the subpass, rasterizes triangles in 2x2 quads, runs the fragment shader on batches of quads, tests
+// depth, blends, and stores the tile back. Only the first layer of framebuffers is rendered, stencil is left as it is.
+// The front end, resolving pipelines, attachments, bindings and vertex buffers and shading vertices, is in
+// mock_icd.cpp with the objects it looks up, the rest in mock_icd_raster.cpp.
+static const int32_t RASTER_TILE_SIZE = 64;  // Pixels along each side of a tile
+static const uint32_t RASTER_TILE_PIXELS = RASTER_TILE_SIZE * RASTER_TILE_SIZE;
+static const int64_t RASTER_SUBPIXELS = 256;       // Per pixel along each axis, in the fixed point window coordinates of triangles
+static const double RASTER_GUARD_BAND = 8192.0;    // Pixels around the viewport triangles are not clipped in
+static const float RASTER_MIN_W = 1e-6f;           // Clip space w triangles are clipped to, keeping them in front of the eye
+static const uint64_t RASTER_MAX_VERTICES = 1 << 24;  // Draws shading more are skipped, to bound the memory they take
+static const uint32_t RASTER_VERTEX_BATCH = 256;   // Vertices a thread shades at a time
+static const uint32_t RASTER_QUAD_BATCH = 64;      // Quads a thread shades at a time
+static const uint32_t RASTER_CLEAR_BIT = 0x80000000u;  // Marks the clears in bins, which otherwise hold triangles
+static const uint32_t RASTER_POSITION_WORDS = 4;
+
+// Rasterizer work since the last present, written out by LogRasterFrame
+struct RasterStats {
+    std::atomic<uint64_t> draws{0};
+    std::atomic<uint64_t> triangles{0};  // Binned, after clipping and culling
+    std::atomic<uint64_t> fragments{0};  // Passing the depth test and not killed
+    std::atomic<uint64_t> vertex_ns{0};
+    std::atomic<uint64_t> binning_ns{0};
+    std::atomic<uint64_t> tile_ns{0};
+};
+extern RasterStats raster_stats;
+
+// When VK_MOCK_RASTER_LOG names a file, each present appends to it a CSV line of the rasterizer's work since the
+// previous one, with the time spent shading vertices, setting up and binning triangles, and rendering tiles
+void LogRasterFrame();
+
+// Texel block layouts, defined with the format tables in mock_icd.h
+struct FormatInfo;
+struct FormatComponent;
+
+// Render passes keep the attachments and the color and depth/stencil attachments of each subpass, with the subpasses
+// that use each attachment first and last. Dependencies and multiview are not kept.
+struct RenderSubpass {
+    std::vector<uint32_t> colors;  // VK_ATTACHMENT_UNUSED for unused ones
+    uint32_t depth_stencil = VK_ATTACHMENT_UNUSED;
+};
+struct RenderPass {
+    std::vector<VkAttachmentDescription> attachments;
+    std::vector<RenderSubpass> subpasses;
+    std::vector<uint32_t> first_subpasses;  // UINT32_MAX for attachments no subpass uses
+    std::vector<uint32_t> last_subpasses;
+};
+
+// State of a graphics pipeline draws rasterize with. Only filled triangles, single-sampled, with vertex and fragment
+// shaders the interpreter handles are rasterized. Stencil, depth bias, logic ops and every viewport and scissor but
+// the first are ignored.
+struct RasterPipeline {
+    std::shared_ptr<const ShaderProgram> vertex;
+    std::shared_ptr<const ShaderProgram> fragment;  // Null without a fragment shader
+    std::vector<VkVertexInputBindingDescription> bindings;
+    std::vector<VkVertexInputAttributeDescription> attributes;
+    VkPrimitiveTopology topology;
+    bool primitive_restart;
+    bool depth_clamp;
+    bool discard;  // Rasterizer discard
+    VkCullModeFlags cull_mode;
+    VkFrontFace front_face;
+    bool depth_test;
+    bool depth_write;
+    VkCompareOp depth_compare;
+    std::vector<VkPipelineColorBlendAttachmentState> blend_attachments;
+    float blend_constants[4];
+    VkViewport viewport;
+    VkRect2D scissor;
+    bool dynamic_viewport;
+    bool dynamic_scissor;
+    bool dynamic_blend_constants;
+};
+
+// Input of a fragment shader. Locations are interpolated from the words of the vertex shader output with the same
+// location, which vertices keep after their clip space position.
+struct RasterVarying {
+    uint32_t offset;  // In the fragment invocation's memory
+    uint32_t built_in;
+    uint32_t word;  // First in each vertex
+    uint32_t words;
+    uint32_t interpolation;
+};
+
+// Fragment shader output written to the color attachment of the subpass at its location
+struct RasterOutput {
+    uint32_t offset;
+    uint32_t size;
+    uint32_t color;
+};
+
+// The fragment shader bindings of a draw and the push constants they point to, defined in mock_icd.cpp
+struct RasterBindings;
+
+// What tiles need of a draw to render its triangles
+struct RasterDraw {
+    std::shared_ptr<const RasterPipeline> pipeline;
+    std::shared_ptr<const RasterBindings> bindings;  // Of the fragment shader, which the regions and textures point into
+    std::vector<ShaderRegion> regions;
+    const ShaderTexture* textures = nullptr;
+    uint32_t texture_count = 0;
+    float blend_constants[4];
+    float min_depth;  // Fragment depths are clamped to with depth clamp
+    float max_depth;
+    uint32_t vertex_size = RASTER_POSITION_WORDS;  // Words
+    std::vector<uint32_t> vertices;  // Shaded ones and then those clipping added
+    std::vector<RasterVarying> varyings;
+    std::vector<RasterOutput> outputs;
+    uint32_t frag_depth = UINT32_MAX;  // Offset of the FragDepth output, if there is one
+    bool late_depth = false;           // Depth is tested after the fragment shader runs
+};
+
+// Triangle set up for rasterization, in fixed point window coordinates with RASTER_SUBPIXELS per pixel
+struct RasterTriangle {
+    uint32_t draw;
+    uint32_t vertices[3];  // Ordered so the area is positive
+    uint32_t provoking;    // Flat inputs come from it
+    // Edge functions a * x + b * y + c, edge i being opposite vertex i. They are not negative at the pixel centers
+    // the triangle covers, and at vertex i give twice the area.
+    int64_t a[3];
+    int64_t b[3];
+    int64_t c[3];
+    double inv_area;  // Of twice the area, turning edge functions into barycentric coordinates
+    float z[3];       // Window depth
+    float inv_w[3];
+    int32_t x0, y0, x1, y1;  // Pixels it may cover, within the scissor
+    bool front_facing;
+};
+
+struct RasterClear {
+    uint32_t color;  // Color attachment of the subpass, UINT32_MAX for the depth attachment
+    VkClearValue value;
+    VkRect2D rect;  // Within the render area
+};
+
+// Framebuffer attachment resolved to host memory. Only the front end knows formats, so it converts the texels tiles
+// load and store as well.
+struct RasterAttachment {
+    char* data = nullptr;  // Texel at the origin
+    VkDeviceSize row_pitch = 0;
+    uint32_t texel_size = 0;
+    uint32_t width = 0;  // Texels
+    uint32_t height = 0;
+    const FormatInfo* format_info = nullptr;  // Null for attachments that cannot be rendered to
+    bool unorm8 = false;
+    bool integer = false;
+    const FormatComponent* depth = nullptr;  // Depth component of depth/stencil formats
+    float low = -INFINITY;                    // Range colors are clamped to before blending, or depth before testing
+    float high = INFINITY;
+    VkClearValue clear_value = {};
+};
+
+// Render pass instance draws are rasterized in, with the draws, triangles and clears of the current subpass
+struct RenderPassInstance {
+    RenderPass render_pass;
+    std::vector<RasterAttachment> attachments;
+    VkRect2D render_area;  // Within the framebuffer
+    uint32_t subpass = 0;
+    uint32_t tiles_x = 0;  // Tiles are laid out from the framebuffer's origin
+    uint32_t tiles_y = 0;
+    std::vector<std::unique_ptr<RasterDraw>> draws;
+    std::vector<RasterTriangle> triangles;
+    std::vector<RasterClear> clears;
+    std::vector<std::vector<uint32_t>> bins;  // Triangles and clears overlapping each tile, in order
+};
+
+// Fixed function state the triangles of a draw are set up with
+struct RasterSetup {
+    VkViewport viewport;
+    double guard[2];    // Clip space x and y triangles are clipped to, in multiples of w
+    int32_t bounds[4];  // Scissor within the render area, x0, y0, x1 and y1 in pixels
+    VkCullModeFlags cull_mode;
+    bool counter_clockwise;
+    bool depth_clamp;
+};
+
+// Intersects a rectangle with the render area, false if nothing is left
+bool ClipToRenderArea(const RenderPassInstance& instance, const VkRect2D& rect, VkRect2D* clipped);
+
+// Bins a clear of the current subpass, its rectangle already within the render area, into the tiles it covers
+void AddRasterClear(RenderPassInstance* instance, const RasterClear& clear);
+
+// Clips a triangle of shaded vertices and sets up what is left
+void AddRasterTriangle(RenderPassInstance* instance, RasterDraw* draw, uint32_t draw_index, const RasterSetup& setup,
+                       const uint32_t vertices[3], std::vector<uint32_t>* polygon);
+
+// Renders the tiles of the current subpass and forgets its draws. Tiles nothing was binned to are left alone,
+// unless the subpass clears an attachment on load.
+void RenderTiles(RenderPassInstance* instance);
+
+// Convert count texels of a row of an attachment to and from what tiles hold, defined with the formats in mock_icd.cpp
+void LoadRasterColors(const RasterAttachment& attachment, const char* texels, uint32_t count, VkClearColorValue* colors);
+void StoreRasterColors(const RasterAttachment& attachment, const VkClearColorValue* colors, uint32_t count, char* texels);
+void LoadRasterDepths(const RasterAttachment& attachment, const char* texels, uint32_t count, float* depths);
+void StoreRasterDepths(const RasterAttachment& attachment, const float* depths, uint32_t count, char* texels);
+
+}  // namespace vkmock
+
+#endif  // MOCK_ICD_RASTER_H
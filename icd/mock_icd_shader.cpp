@@ -0,0 +1,1768 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mock_icd_shader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+
+namespace vkmock {
+
+// Builds the program of one entry point of a module
+class ShaderTranslator {
+   public:
+    ShaderTranslator(const uint32_t* code, size_t word_count) : program_(new ShaderProgram()) {
+        program_->words.assign(code, code + word_count);
+    }
+
+    std::unique_ptr<ShaderProgram> Translate(const char* entry_point, uint32_t execution_model,
+                                             const VkSpecializationInfo* specialization) {
+        const std::vector<uint32_t>& words = program_->words;
+        if (words.size() < 5 || words[0] != SPIRV_MAGIC || words[3] > (1u << 22)) return nullptr;
+        const uint32_t bound = words[3];
+        program_->types.resize(bound);
+        program_->slots.assign(bound, UINT32_MAX);
+        decorations_.resize(bound);
+        block_indices_.assign(bound, UINT32_MAX);
+        function_indices_.assign(bound, UINT32_MAX);
+        known_.assign(bound, false);
+        program_->value_types.assign(bound, 0);
+        program_->execution_model = execution_model;
+        specialization_ = specialization;
+        // Decorations and the entry point come before everything they apply to
+        uint32_t entry_id = 0;
+        for (size_t at = 5; at < words.size();) {
+            const uint32_t op = words[at] & 0xFFFF, count = words[at] >> 16;
+            if (count == 0 || at + count > words.size()) return nullptr;
+            const uint32_t* operands = &words[at + 1];
+            if (op == SPIRV_OP_DECORATE && count >= 3) {
+                if (!Valid(operands[0])) return nullptr;
+                Decorate(&decorations_[operands[0]], operands[1], count >= 4 ? operands[2] : 0);
+            } else if (op == SPIRV_OP_MEMBER_DECORATE && count >= 4) {
+                if (!Valid(operands[0])) return nullptr;
+                auto& members = decorations_[operands[0]].members;
+                if (members.size() <= operands[1]) members.resize(operands[1] + 1);
+                Decorate(&members[operands[1]], operands[2], count >= 5 ? operands[3] : 0);
+            } else if (op == SPIRV_OP_ENTRY_POINT && count >= 4 && operands[0] == execution_model &&
+                       strncmp(reinterpret_cast<const char*>(&operands[2]), entry_point, (count - 3) * 4) == 0) {
+                entry_id = operands[1];
+            } else if (op == SPIRV_OP_EXT_INST_IMPORT && count >= 3 &&
+                       strncmp(reinterpret_cast<const char*>(&operands[1]), "GLSL.std.450", (count - 2) * 4) == 0) {
+                glsl_import_ = operands[0];
+            }
+            at += count;
+        }
+        if (!Valid(entry_id)) return nullptr;
+        for (size_t at = 5; at < words.size();) {
+            const uint32_t op = words[at] & 0xFFFF, count = words[at] >> 16;
+            if (!TranslateInstruction(op, (uint32_t)at + 1, count - 1, entry_id)) return nullptr;
+            at += count;
+        }
+        if (function_ || !Resolve(entry_id)) return nullptr;
+        return std::move(program_);
+    }
+
+   private:
+    struct Decorations {
+        uint32_t spec_id = UINT32_MAX;
+        uint32_t built_in = SPIRV_BUILT_IN_NONE;
+        uint32_t location = UINT32_MAX;
+        uint32_t set = 0;
+        uint32_t binding = 0;
+        uint32_t offset = UINT32_MAX;
+        uint32_t array_stride = 0;
+        uint32_t matrix_stride = 0;
+        uint32_t interpolation = 0;
+        bool row_major = false;
+        std::vector<Decorations> members;
+    };
+
+    static void Decorate(Decorations* decorations, uint32_t decoration, uint32_t value) {
+        switch (decoration) {
+            case SPIRV_DECORATION_SPEC_ID: decorations->spec_id = value; break;
+            case SPIRV_DECORATION_BUILT_IN: decorations->built_in = value; break;
+            case SPIRV_DECORATION_LOCATION: decorations->location = value; break;
+            case SPIRV_DECORATION_DESCRIPTOR_SET: decorations->set = value; break;
+            case SPIRV_DECORATION_BINDING: decorations->binding = value; break;
+            case SPIRV_DECORATION_OFFSET: decorations->offset = value; break;
+            case SPIRV_DECORATION_ARRAY_STRIDE: decorations->array_stride = value; break;
+            case SPIRV_DECORATION_MATRIX_STRIDE: decorations->matrix_stride = value; break;
+            case SPIRV_DECORATION_ROW_MAJOR: decorations->row_major = true; break;
+            case SPIRV_DECORATION_FLAT:
+            case SPIRV_DECORATION_NO_PERSPECTIVE: decorations->interpolation = decoration; break;
+            default: break;
+        }
+    }
+
+    bool Valid(uint32_t id) const { return id != 0 && id < program_->types.size(); }
+    bool IsType(uint32_t id) const { return Valid(id) && program_->types[id].op != 0; }
+    uint32_t Word(uint32_t index) const { return program_->words[index]; }
+
+    uint32_t AddRegister(uint32_t id, uint32_t type) {
+        if (!IsType(type) || program_->slots[id] != UINT32_MAX) return UINT32_MAX;
+        program_->slots[id] = program_->register_count;
+        program_->register_count += program_->types[type].components;
+        program_->constants.resize(program_->register_count);
+        program_->scratch_count = std::max(program_->scratch_count, program_->types[type].components);
+        return program_->slots[id];
+    }
+
+    bool DeclareType(uint32_t op, uint32_t operands, uint32_t count) {
+        if (count < 1 || !Valid(Word(operands)) || IsType(Word(operands))) return false;
+        ShaderType& type = program_->types[Word(operands)];
+        const Decorations& decorations = decorations_[Word(operands)];
+        type.op = op;
+        switch (op) {
+            case SPIRV_OP_TYPE_VOID:
+            case SPIRV_OP_TYPE_FUNCTION:
+                return true;
+            case SPIRV_OP_TYPE_BOOL:
+            case SPIRV_OP_TYPE_SAMPLER:
+                type.components = 1;
+                type.size = 4;
+                return true;
+            case SPIRV_OP_TYPE_IMAGE:
+                // Images of other dimensions or multisampled ones can be declared, but not sampled
+                if (count < 8) return false;
+                type.element = Word(operands + 1);
+                if (Word(operands + 5) == 0 && (Word(operands + 2) == SPIRV_DIM_1D || Word(operands + 2) == SPIRV_DIM_2D)) {
+                    type.dimensions = Word(operands + 2) == SPIRV_DIM_1D ? 1 : 2;
+                }
+                type.arrayed = Word(operands + 4) != 0;
+                type.components = 1;
+                type.size = 4;
+                return true;
+            case SPIRV_OP_TYPE_SAMPLED_IMAGE:
+                // The image's texture, then the sampler's
+                if (count < 2 || !IsType(Word(operands + 1))) return false;
+                type.element = Word(operands + 1);
+                type.components = 2;
+                type.size = 8;
+                return true;
+            case SPIRV_OP_TYPE_INT:
+            case SPIRV_OP_TYPE_FLOAT:
+                type.components = 1;
+                type.size = 4;
+                return count >= 2 && Word(operands + 1) == 32;
+            case SPIRV_OP_TYPE_POINTER:
+                if (count < 3) return false;
+                type.storage_class = Word(operands + 1);
+                type.element = Word(operands + 2);  // May be forward declared
+                type.components = 2;
+                type.size = 8;
+                return true;
+            case SPIRV_OP_TYPE_VECTOR:
+            case SPIRV_OP_TYPE_MATRIX:
+            case SPIRV_OP_TYPE_ARRAY:
+            case SPIRV_OP_TYPE_RUNTIME_ARRAY: {
+                if (count < 2 || !IsType(Word(operands + 1))) return false;
+                const ShaderType& element = program_->types[Word(operands + 1)];
+                type.element = Word(operands + 1);
+                if (op == SPIRV_OP_TYPE_ARRAY) {
+                    if (count < 3 || !Valid(Word(operands + 2)) || !known_[Word(operands + 2)]) return false;
+                    type.length = program_->constants[program_->slots[Word(operands + 2)]];
+                } else if (op != SPIRV_OP_TYPE_RUNTIME_ARRAY) {
+                    if (count < 3) return false;
+                    type.length = Word(operands + 2);
+                }
+                type.stride = decorations.array_stride ? decorations.array_stride : element.size;
+                if (op == SPIRV_OP_TYPE_VECTOR) type.stride = 4;
+                type.components = element.components * type.length;
+                type.size = type.stride * type.length;
+                return element.components != 0;
+            }
+            case SPIRV_OP_TYPE_STRUCT:
+                for (uint32_t i = 1; i < count; ++i) {
+                    if (!IsType(Word(operands + i))) return false;
+                    const ShaderType& member = program_->types[Word(operands + i)];
+                    const Decorations* member_decorations = i - 1 < decorations.members.size() ? &decorations.members[i - 1] : nullptr;
+                    if (member_decorations && member_decorations->row_major) return false;
+                    const uint32_t offset = member_decorations && member_decorations->offset != UINT32_MAX ? member_decorations->offset : type.size;
+                    type.members.push_back(Word(operands + i));
+                    type.member_offsets.push_back(offset);
+                    type.member_matrix_strides.push_back(member_decorations ? member_decorations->matrix_stride : 0);
+                    type.components += member.components;
+                    type.size = std::max(type.size, offset + member.size);
+                }
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Lays out the components of a type at offset, with matrices matrix_stride bytes apart if not 0
+    void AppendLayout(uint32_t type_id, uint32_t offset, uint32_t matrix_stride, std::vector<uint32_t>* layout) const {
+        const ShaderType& type = program_->types[type_id];
+        switch (type.op) {
+            case SPIRV_OP_TYPE_STRUCT:
+                for (size_t i = 0; i < type.members.size(); ++i) {
+                    AppendLayout(type.members[i], offset + type.member_offsets[i], type.member_matrix_strides[i], layout);
+                }
+                break;
+            case SPIRV_OP_TYPE_MATRIX:
+            case SPIRV_OP_TYPE_ARRAY:
+            case SPIRV_OP_TYPE_VECTOR: {
+                const uint32_t stride = type.op == SPIRV_OP_TYPE_MATRIX && matrix_stride ? matrix_stride : type.stride;
+                for (uint32_t i = 0; i < type.length; ++i) AppendLayout(type.element, offset + i * stride, matrix_stride, layout);
+                break;
+            }
+            case SPIRV_OP_TYPE_POINTER:
+            case SPIRV_OP_TYPE_SAMPLED_IMAGE:
+                layout->push_back(offset);
+                layout->push_back(offset + 4);
+                break;
+            default:
+                layout->push_back(offset);
+                break;
+        }
+    }
+
+    bool EnsureLayout(uint32_t type_id) {
+        if (!IsType(type_id)) return false;
+        ShaderType& type = program_->types[type_id];
+        if (type.layout.empty()) AppendLayout(type_id, 0, 0, &type.layout);
+        return type.layout.size() == type.components && type.components != 0;
+    }
+
+    bool DeclareConstant(uint32_t op, uint32_t operands, uint32_t count) {
+        if (count < 2 || !Valid(Word(operands + 1))) return false;
+        const uint32_t id = Word(operands + 1);
+        const uint32_t slot = AddRegister(id, Word(operands));
+        if (slot == UINT32_MAX) return false;
+        const ShaderType& type = program_->types[Word(operands)];
+        uint32_t* values = &program_->constants[slot];
+        const Decorations& decorations = decorations_[id];
+        known_[id] = true;
+        switch (op) {
+            case SPIRV_OP_CONSTANT_TRUE:
+            case SPIRV_OP_SPEC_CONSTANT_TRUE:
+            case SPIRV_OP_CONSTANT_FALSE:
+            case SPIRV_OP_SPEC_CONSTANT_FALSE:
+                values[0] = op == SPIRV_OP_CONSTANT_TRUE || op == SPIRV_OP_SPEC_CONSTANT_TRUE;
+                if (op >= SPIRV_OP_SPEC_CONSTANT_TRUE) {
+                    uint32_t value;
+                    if (GetSpecialization(decorations.spec_id, &value)) values[0] = value != 0;
+                }
+                return true;
+            case SPIRV_OP_CONSTANT:
+            case SPIRV_OP_SPEC_CONSTANT:
+                if (count < 3 || type.components != 1) return false;
+                values[0] = Word(operands + 2);
+                if (op == SPIRV_OP_SPEC_CONSTANT) GetSpecialization(decorations.spec_id, &values[0]);
+                return true;
+            case SPIRV_OP_CONSTANT_COMPOSITE:
+            case SPIRV_OP_SPEC_CONSTANT_COMPOSITE: {
+                uint32_t component = 0;
+                for (uint32_t i = 2; i < count; ++i) {
+                    const uint32_t constituent = Word(operands + i);
+                    if (!Valid(constituent) || program_->slots[constituent] == UINT32_MAX) return false;
+                    known_[id] = known_[id] && known_[constituent];
+                    const uint32_t components = program_->types[GetType(constituent)].components;
+                    if (component + components > type.components) return false;
+                    for (uint32_t c = 0; c < components; ++c) values[component++] = program_->constants[program_->slots[constituent] + c];
+                }
+                return component == type.components;
+            }
+            case SPIRV_OP_CONSTANT_NULL:
+            case SPIRV_OP_UNDEF:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool GetSpecialization(uint32_t spec_id, uint32_t* value) const {
+        if (!specialization_ || spec_id == UINT32_MAX) return false;
+        for (uint32_t i = 0; i < specialization_->mapEntryCount; ++i) {
+            const VkSpecializationMapEntry& entry = specialization_->pMapEntries[i];
+            if (entry.constantID != spec_id) continue;
+            if (entry.size != sizeof(uint32_t) || entry.offset + entry.size > specialization_->dataSize) return false;
+            memcpy(value, static_cast<const char*>(specialization_->pData) + entry.offset, sizeof(uint32_t));
+            return true;
+        }
+        return false;
+    }
+
+    uint32_t GetType(uint32_t id) const { return Valid(id) ? program_->value_types[id] : 0; }
+
+    bool DeclareVariable(uint32_t operands, uint32_t count) {
+        if (count < 3) return false;
+        const uint32_t type_id = Word(operands), id = Word(operands + 1), storage_class = Word(operands + 2);
+        if (!IsType(type_id) || program_->types[type_id].op != SPIRV_OP_TYPE_POINTER || !IsType(program_->types[type_id].element)) return false;
+        if (AddRegister(id, type_id) == UINT32_MAX) return false;
+        program_->value_types[id] = type_id;
+        const uint32_t pointee = program_->types[type_id].element;
+        const Decorations& decorations = decorations_[id];
+        uint32_t* pointer = &program_->constants[program_->slots[id]];
+        switch (storage_class) {
+            case SPIRV_STORAGE_CLASS_UNIFORM:
+            case SPIRV_STORAGE_CLASS_STORAGE_BUFFER:
+            case SPIRV_STORAGE_CLASS_UNIFORM_CONSTANT: {
+                const ShaderType& type = program_->types[pointee];
+                const bool array = type.op == SPIRV_OP_TYPE_ARRAY || type.op == SPIRV_OP_TYPE_RUNTIME_ARRAY;
+                const uint32_t element_op = program_->types[array ? type.element : pointee].op;
+                const bool image = storage_class == SPIRV_STORAGE_CLASS_UNIFORM_CONSTANT;
+                if (image && element_op != SPIRV_OP_TYPE_IMAGE && element_op != SPIRV_OP_TYPE_SAMPLER &&
+                    element_op != SPIRV_OP_TYPE_SAMPLED_IMAGE) {
+                    return true;  // Such as acceleration structures, which no instruction the interpreter runs can use
+                }
+                ShaderDescriptor descriptor = {decorations.set, decorations.binding, array ? std::max(type.length, 1u) : 1,
+                                               program_->region_count, image};
+                program_->descriptors.push_back(descriptor);
+                program_->region_count += descriptor.count;
+                pointer[0] = descriptor.region;
+                if (array) descriptor_arrays_[id] = descriptor.count;
+                return true;
+            }
+            case SPIRV_STORAGE_CLASS_PUSH_CONSTANT:
+                pointer[0] = SHADER_PUSH_CONSTANT_REGION;
+                return true;
+            case SPIRV_STORAGE_CLASS_WORKGROUP:
+                pointer[0] = SHADER_WORKGROUP_REGION;
+                pointer[1] = program_->workgroup_size;
+                program_->workgroup_size += (program_->types[pointee].size + 3) & ~3u;
+                return true;
+            case SPIRV_STORAGE_CLASS_INPUT:
+            case SPIRV_STORAGE_CLASS_OUTPUT:
+            case SPIRV_STORAGE_CLASS_PRIVATE:
+            case SPIRV_STORAGE_CLASS_FUNCTION: {
+                const uint32_t initializer = count >= 4 ? Word(operands + 3) : 0;
+                if (initializer && (!Valid(initializer) || program_->slots[initializer] == UINT32_MAX || !EnsureLayout(pointee))) return false;
+                const ShaderVariable variable = {id, storage_class, decorations.built_in, decorations.location,
+                                                 program_->invocation_size, pointee, initializer};
+                program_->variables.push_back(variable);
+                if (storage_class == SPIRV_STORAGE_CLASS_INPUT || storage_class == SPIRV_STORAGE_CLASS_OUTPUT) {
+                    AddInterface(variable, decorations);
+                }
+                program_->invocation_size += (program_->types[pointee].size + 3) & ~3u;
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    // Records the inputs or outputs of a variable, with the built-in members of blocks like gl_PerVertex on their own
+    void AddInterface(const ShaderVariable& variable, const Decorations& decorations) {
+        const ShaderType& type = program_->types[variable.type];
+        ShaderInterface entry = {variable.storage_class, variable.built_in, UINT32_MAX, variable.offset, type.size, 0};
+        if (variable.built_in != SPIRV_BUILT_IN_NONE) {
+            program_->interface.push_back(entry);
+            return;
+        }
+        const auto& members = decorations_[variable.type].members;
+        bool built_in_members = false;
+        for (size_t i = 0; type.op == SPIRV_OP_TYPE_STRUCT && i < type.members.size() && i < members.size(); ++i) {
+            if (members[i].built_in == SPIRV_BUILT_IN_NONE) continue;
+            entry.built_in = members[i].built_in;
+            entry.offset = variable.offset + type.member_offsets[i];
+            entry.size = program_->types[type.members[i]].size;
+            program_->interface.push_back(entry);
+            built_in_members = true;
+        }
+        if (built_in_members || variable.location == UINT32_MAX) return;
+        entry.built_in = SPIRV_BUILT_IN_NONE;
+        entry.location = variable.location;
+        entry.interpolation = decorations.interpolation;
+        AddLocations(variable.type, variable.offset, &entry);
+    }
+
+    // Gives the vectors and scalars of a type consecutive locations, from the location of entry on
+    void AddLocations(uint32_t type_id, uint32_t offset, ShaderInterface* entry) {
+        const ShaderType& type = program_->types[type_id];
+        if (type.op == SPIRV_OP_TYPE_STRUCT) {
+            for (size_t i = 0; i < type.members.size(); ++i) AddLocations(type.members[i], offset + type.member_offsets[i], entry);
+        } else if (type.op == SPIRV_OP_TYPE_ARRAY || type.op == SPIRV_OP_TYPE_MATRIX) {
+            for (uint32_t i = 0; i < type.length; ++i) AddLocations(type.element, offset + i * type.stride, entry);
+        } else {
+            entry->offset = offset;
+            entry->size = type.size;
+            program_->interface.push_back(*entry);
+            entry->location++;
+        }
+    }
+
+    // Records the access chain of an OpAccessChain in aux[0]
+    bool DeclareAccessChain(ShaderInstruction* instruction) {
+        if (instruction->operand_count < 1) return false;
+        const uint32_t base = Word(instruction->operands);
+        const uint32_t base_type = GetType(base);
+        if (!base_type || program_->types[base_type].op != SPIRV_OP_TYPE_POINTER) return false;
+        ShaderAccessChain chain = {0, (uint32_t)program_->access_steps.size(), 0, 0, 0};
+        uint32_t type_id = program_->types[base_type].element;
+        uint32_t matrix_stride = 0;
+        for (uint32_t i = 1; i < instruction->operand_count; ++i) {
+            const uint32_t index = Word(instruction->operands + i);
+            if (!Valid(index) || program_->slots[index] == UINT32_MAX || !IsType(type_id)) return false;
+            const ShaderType& type = program_->types[type_id];
+            const uint32_t constant = known_[index] ? program_->constants[program_->slots[index]] : UINT32_MAX;
+            if (type.op == SPIRV_OP_TYPE_STRUCT) {
+                if (constant >= type.members.size()) return false;
+                chain.offset += type.member_offsets[constant];
+                matrix_stride = type.member_matrix_strides[constant];
+                type_id = type.members[constant];
+                continue;
+            }
+            if (type.op != SPIRV_OP_TYPE_ARRAY && type.op != SPIRV_OP_TYPE_RUNTIME_ARRAY && type.op != SPIRV_OP_TYPE_VECTOR &&
+                type.op != SPIRV_OP_TYPE_MATRIX) {
+                return false;
+            }
+            if (i == 1 && descriptor_arrays_.count(base)) {
+                chain.region_index = index;
+                chain.region_limit = descriptor_arrays_[base];
+            } else {
+                const uint32_t stride = type.op == SPIRV_OP_TYPE_MATRIX && matrix_stride ? matrix_stride : type.stride;
+                if (constant != UINT32_MAX) {
+                    chain.offset += constant * stride;
+                } else {
+                    const ShaderAccessStep step = {index, stride};
+                    program_->access_steps.push_back(step);
+                    chain.step_count++;
+                }
+            }
+            if (type.op != SPIRV_OP_TYPE_MATRIX) matrix_stride = 0;
+            type_id = type.element;
+        }
+        if (!IsType(instruction->type) || program_->types[instruction->type].element != type_id) return false;
+        instruction->aux[0] = (uint32_t)program_->access_chains.size();
+        program_->access_chains.push_back(chain);
+        return true;
+    }
+
+    // Finds the component a composite's indices select, from the literals after the first operand
+    bool ResolveComponent(uint32_t type_id, uint32_t operands, uint32_t count, uint32_t* component, uint32_t* element_type) const {
+        *component = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            if (!IsType(type_id)) return false;
+            const ShaderType& type = program_->types[type_id];
+            const uint32_t index = Word(operands + i);
+            if (type.op == SPIRV_OP_TYPE_STRUCT) {
+                if (index >= type.members.size()) return false;
+                for (uint32_t member = 0; member < index; ++member) *component += program_->types[type.members[member]].components;
+                type_id = type.members[index];
+            } else if (type.op == SPIRV_OP_TYPE_ARRAY || type.op == SPIRV_OP_TYPE_VECTOR || type.op == SPIRV_OP_TYPE_MATRIX) {
+                if (index >= type.length) return false;
+                *component += index * program_->types[type.element].components;
+                type_id = type.element;
+            } else {
+                return false;
+            }
+        }
+        *element_type = type_id;
+        return true;
+    }
+
+    static bool HasResult(uint32_t op) {
+        switch (op) {
+            case SPIRV_OP_STORE:
+            case SPIRV_OP_COPY_MEMORY:
+            case SPIRV_OP_CONTROL_BARRIER:
+            case SPIRV_OP_ATOMIC_STORE:
+            case SPIRV_OP_BRANCH:
+            case SPIRV_OP_BRANCH_CONDITIONAL:
+            case SPIRV_OP_SWITCH:
+            case SPIRV_OP_KILL:
+            case SPIRV_OP_RETURN:
+            case SPIRV_OP_RETURN_VALUE:
+            case SPIRV_OP_UNREACHABLE:
+            case SPIRV_OP_TERMINATE_INVOCATION:
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    static bool IsSupported(uint32_t op) {
+        if (op >= SPIRV_OP_CONVERT_F_TO_U && op <= SPIRV_OP_QUANTIZE_TO_F16) return true;
+        if (op >= SPIRV_OP_SNEGATE && op <= SPIRV_OP_SMUL_EXTENDED) return true;
+        if (op >= SPIRV_OP_ANY && op <= SPIRV_OP_IS_INF) return true;
+        if (op >= SPIRV_OP_LOGICAL_EQUAL && op <= SPIRV_OP_FUNORD_GREATER_THAN_EQUAL) return true;
+        if (op >= SPIRV_OP_SHIFT_RIGHT_LOGICAL && op <= SPIRV_OP_BIT_COUNT) return true;
+        if (op >= SPIRV_OP_ATOMIC_LOAD && op <= SPIRV_OP_ATOMIC_XOR) return true;
+        if (op >= SPIRV_OP_VECTOR_EXTRACT_DYNAMIC && op <= SPIRV_OP_TRANSPOSE) return true;
+        if (op >= SPIRV_OP_DPDX && op <= SPIRV_OP_FWIDTH_COARSE) return true;
+        switch (op) {
+            case SPIRV_OP_EXT_INST:
+            case SPIRV_OP_FUNCTION_CALL:
+            case SPIRV_OP_LOAD:
+            case SPIRV_OP_STORE:
+            case SPIRV_OP_COPY_MEMORY:
+            case SPIRV_OP_ACCESS_CHAIN:
+            case SPIRV_OP_IN_BOUNDS_ACCESS_CHAIN:
+            case SPIRV_OP_ARRAY_LENGTH:
+            case SPIRV_OP_BITCAST:
+            case SPIRV_OP_CONTROL_BARRIER:
+            case SPIRV_OP_PHI:
+            case SPIRV_OP_BRANCH:
+            case SPIRV_OP_BRANCH_CONDITIONAL:
+            case SPIRV_OP_SWITCH:
+            case SPIRV_OP_KILL:
+            case SPIRV_OP_RETURN:
+            case SPIRV_OP_RETURN_VALUE:
+            case SPIRV_OP_UNREACHABLE:
+            case SPIRV_OP_COPY_LOGICAL:
+            case SPIRV_OP_TERMINATE_INVOCATION:
+            case SPIRV_OP_SAMPLED_IMAGE:
+            case SPIRV_OP_IMAGE:
+            case SPIRV_OP_IMAGE_SAMPLE_IMPLICIT_LOD:
+            case SPIRV_OP_IMAGE_SAMPLE_EXPLICIT_LOD:
+            case SPIRV_OP_IMAGE_FETCH:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    static bool IsSpecConstantOp(uint32_t op) {
+        return (op >= SPIRV_OP_UCONVERT && op <= SPIRV_OP_FCONVERT) || (op >= SPIRV_OP_SNEGATE && op <= SPIRV_OP_FMOD) ||
+               (op >= SPIRV_OP_LOGICAL_EQUAL && op <= SPIRV_OP_SLESS_THAN_EQUAL) || (op >= SPIRV_OP_SHIFT_RIGHT_LOGICAL && op <= SPIRV_OP_NOT) ||
+               op == SPIRV_OP_VECTOR_SHUFFLE || op == SPIRV_OP_COMPOSITE_EXTRACT || op == SPIRV_OP_COMPOSITE_INSERT ||
+               op == SPIRV_OP_QUANTIZE_TO_F16;
+    }
+
+    static bool IsSupportedGlsl(uint32_t instruction) {
+        return (instruction >= GLSL_ROUND && instruction <= GLSL_INVERSE_SQRT) ||
+               (instruction >= GLSL_FMIN && instruction <= GLSL_FMA && instruction != 47) ||
+               (instruction >= GLSL_LENGTH && instruction <= GLSL_FIND_UMSB && instruction != 72) ||
+               (instruction >= GLSL_NMIN && instruction <= GLSL_NCLAMP);
+    }
+
+    // Adds an instruction computing a value, from its operands at operands
+    bool AddInstruction(uint32_t op, uint32_t operands, uint32_t count, bool has_type) {
+        ShaderInstruction instruction = {(uint16_t)op, 0, 0, 0, operands, {0, 0}};
+        if (has_type) {
+            if (count < 2 || !IsType(Word(operands)) || !Valid(Word(operands + 1))) return false;
+            instruction.type = Word(operands);
+            instruction.result = Word(operands + 1);
+            instruction.operands += 2;
+            count -= 2;
+            if (program_->types[instruction.type].op != SPIRV_OP_TYPE_VOID && AddRegister(instruction.result, instruction.type) == UINT32_MAX) return false;
+            program_->value_types[instruction.result] = instruction.type;
+        }
+        instruction.operand_count = (uint16_t)count;
+        const uint32_t first = instruction.operands;
+        switch (op) {
+            case SPIRV_OP_ACCESS_CHAIN:
+            case SPIRV_OP_IN_BOUNDS_ACCESS_CHAIN:
+                if (!DeclareAccessChain(&instruction)) return false;
+                break;
+            case SPIRV_OP_LOAD:
+            case SPIRV_OP_ATOMIC_LOAD:
+                if (count < 1 || !EnsureLayout(instruction.type)) return false;
+                break;
+            case SPIRV_OP_STORE:
+            case SPIRV_OP_COPY_MEMORY:
+            case SPIRV_OP_ATOMIC_STORE: {
+                const uint32_t pointer_type = count >= 2 ? GetType(Word(first)) : 0;
+                if (!pointer_type || !EnsureLayout(program_->types[pointer_type].element)) return false;
+                instruction.aux[0] = program_->types[pointer_type].element;
+                break;
+            }
+            case SPIRV_OP_ARRAY_LENGTH: {
+                const uint32_t pointer_type = count >= 2 ? GetType(Word(first)) : 0;
+                if (!pointer_type) return false;
+                const ShaderType& type = program_->types[program_->types[pointer_type].element];
+                if (type.op != SPIRV_OP_TYPE_STRUCT || Word(first + 1) >= type.members.size()) return false;
+                instruction.aux[0] = type.member_offsets[Word(first + 1)];
+                instruction.aux[1] = program_->types[type.members[Word(first + 1)]].stride;
+                break;
+            }
+            case SPIRV_OP_COMPOSITE_EXTRACT: {
+                uint32_t element_type;
+                if (count < 1 || !ResolveComponent(GetType(Word(first)), first + 1, count - 1, &instruction.aux[0], &element_type)) return false;
+                break;
+            }
+            case SPIRV_OP_COMPOSITE_INSERT: {
+                uint32_t element_type;
+                if (count < 2 || !ResolveComponent(instruction.type, first + 2, count - 2, &instruction.aux[0], &element_type)) return false;
+                instruction.aux[1] = program_->types[element_type].components;
+                break;
+            }
+            case SPIRV_OP_VECTOR_SHUFFLE:
+            case SPIRV_OP_VECTOR_TIMES_MATRIX:
+            case SPIRV_OP_MATRIX_TIMES_VECTOR:
+            case SPIRV_OP_MATRIX_TIMES_MATRIX:
+            case SPIRV_OP_TRANSPOSE:
+            case SPIRV_OP_OUTER_PRODUCT:
+            case SPIRV_OP_DOT:
+                // Components of the first operand
+                if (count < 1 || !GetType(Word(first))) return false;
+                instruction.aux[0] = program_->types[GetType(Word(first))].components;
+                if (op == SPIRV_OP_MATRIX_TIMES_VECTOR || op == SPIRV_OP_MATRIX_TIMES_MATRIX || op == SPIRV_OP_TRANSPOSE) {
+                    // Rows of the matrix
+                    instruction.aux[1] = program_->types[program_->types[GetType(Word(first))].element].components;
+                }
+                break;
+            case SPIRV_OP_EXT_INST:
+                if (count < 2 || Word(first) != glsl_import_ || !IsSupportedGlsl(Word(first + 1))) return false;
+                instruction.aux[0] = Word(first + 1);
+                break;
+            case SPIRV_OP_FUNCTION_CALL:
+                if (count < 1 || !Valid(Word(first))) return false;
+                break;
+            case SPIRV_OP_SELECT:
+                // Components of the condition, a scalar selects whole vectors
+                if (count < 3 || !GetType(Word(first))) return false;
+                instruction.aux[0] = program_->types[GetType(Word(first))].components;
+                break;
+            case SPIRV_OP_ANY:
+            case SPIRV_OP_ALL:
+            case SPIRV_OP_VECTOR_EXTRACT_DYNAMIC:
+                if (count < 1 || !GetType(Word(first))) return false;
+                instruction.aux[0] = program_->types[GetType(Word(first))].components;
+                break;
+            case SPIRV_OP_IMAGE_SAMPLE_IMPLICIT_LOD:
+            case SPIRV_OP_IMAGE_SAMPLE_EXPLICIT_LOD:
+            case SPIRV_OP_IMAGE_FETCH: {
+                // The image operands go to aux[0], the image's dimensions to aux[1] with SHADER_IMAGE_ARRAYED
+                if (count < 2 || !GetType(Word(first)) || Components(instruction.type) != 4) return false;
+                const ShaderType* image = &program_->types[GetType(Word(first))];
+                if (image->op == SPIRV_OP_TYPE_SAMPLED_IMAGE) image = &program_->types[image->element];
+                if (image->op != SPIRV_OP_TYPE_IMAGE || !image->dimensions) return false;
+                instruction.aux[0] = count > 2 ? Word(first + 2) : 0;
+                instruction.aux[1] = image->dimensions | (image->arrayed ? SHADER_IMAGE_ARRAYED : 0);
+                const uint32_t supported = SPIRV_IMAGE_OPERANDS_BIAS | SPIRV_IMAGE_OPERANDS_LOD | SPIRV_IMAGE_OPERANDS_GRAD |
+                                           SPIRV_IMAGE_OPERANDS_CONST_OFFSET | SPIRV_IMAGE_OPERANDS_OFFSET;
+                if (instruction.aux[0] & ~supported) return false;
+                break;
+            }
+            case SPIRV_OP_PHI:
+                if (!current_block_ || program_->instructions.size() != program_->blocks.back().body) return false;
+                program_->blocks.back().body++;
+                phi_components_ += program_->types[instruction.type].components;
+                program_->scratch_count = std::max(program_->scratch_count, phi_components_);
+                break;
+            default:
+                // Derivatives are taken between the fragments of a quad
+                if (op >= SPIRV_OP_DPDX && op <= SPIRV_OP_FWIDTH_COARSE && program_->execution_model != SPIRV_EXECUTION_MODEL_FRAGMENT) {
+                    return false;
+                }
+                break;
+        }
+        program_->instructions.push_back(instruction);
+        return true;
+    }
+
+    uint32_t Components(uint32_t type) const { return IsType(type) ? program_->types[type].components : 0; }
+
+    bool TranslateInstruction(uint32_t op, uint32_t operands, uint32_t count, uint32_t entry_id) {
+        switch (op) {
+            case SPIRV_OP_TYPE_VOID:
+            case SPIRV_OP_TYPE_BOOL:
+            case SPIRV_OP_TYPE_INT:
+            case SPIRV_OP_TYPE_FLOAT:
+            case SPIRV_OP_TYPE_VECTOR:
+            case SPIRV_OP_TYPE_MATRIX:
+            case SPIRV_OP_TYPE_IMAGE:
+            case SPIRV_OP_TYPE_SAMPLER:
+            case SPIRV_OP_TYPE_SAMPLED_IMAGE:
+            case SPIRV_OP_TYPE_ARRAY:
+            case SPIRV_OP_TYPE_RUNTIME_ARRAY:
+            case SPIRV_OP_TYPE_STRUCT:
+            case SPIRV_OP_TYPE_POINTER:
+            case SPIRV_OP_TYPE_FUNCTION:
+                return DeclareType(op, operands, count);
+            case SPIRV_OP_CONSTANT_TRUE:
+            case SPIRV_OP_CONSTANT_FALSE:
+            case SPIRV_OP_CONSTANT:
+            case SPIRV_OP_CONSTANT_COMPOSITE:
+            case SPIRV_OP_CONSTANT_NULL:
+            case SPIRV_OP_SPEC_CONSTANT_TRUE:
+            case SPIRV_OP_SPEC_CONSTANT_FALSE:
+            case SPIRV_OP_SPEC_CONSTANT:
+            case SPIRV_OP_SPEC_CONSTANT_COMPOSITE:
+                if (!DeclareConstant(op, operands, count)) return false;
+                program_->value_types[Word(operands + 1)] = Word(operands);
+                return true;
+            case SPIRV_OP_UNDEF:
+                // Undefined values are whatever their register holds, also inside functions
+                if (!DeclareConstant(op, operands, count)) return false;
+                program_->value_types[Word(operands + 1)] = Word(operands);
+                return true;
+            case SPIRV_OP_SPEC_CONSTANT_OP: {
+                // Computed by the prologue, so that every value stays in its register
+                if (count < 3 || !IsSpecConstantOp(Word(operands + 2))) return false;
+                if (program_->prologue_end != program_->instructions.size()) return false;
+                const uint32_t inner = Word(operands + 2);
+                // Move the result type and id next to the operands, as instructions have them
+                program_->words[operands + 2] = Word(operands + 1);
+                program_->words[operands + 1] = Word(operands);
+                if (!AddInstruction(inner, operands + 1, count - 1, true)) return false;
+                program_->prologue_end++;
+                return true;
+            }
+            case SPIRV_OP_VARIABLE:
+                if (!DeclareVariable(operands, count)) return false;
+                // Variables of functions only do something when they are initialized
+                if (function_ && count >= 4) {
+                    ShaderInstruction instruction = {SPIRV_OP_STORE, 2, 0, 0, operands + 1, {program_->types[Word(operands)].element, 0}};
+                    program_->words[operands + 2] = Word(operands + 3);
+                    program_->instructions.push_back(instruction);
+                }
+                return true;
+            case SPIRV_OP_EXECUTION_MODE:
+            case SPIRV_OP_EXECUTION_MODE_ID:
+                if (count >= 5 && Word(operands) == entry_id &&
+                    (Word(operands + 1) == SPIRV_EXECUTION_MODE_LOCAL_SIZE || Word(operands + 1) == SPIRV_EXECUTION_MODE_LOCAL_SIZE_ID)) {
+                    // Constants come later than execution modes, so sizes given by id are looked up last
+                    const bool ids = Word(operands + 1) == SPIRV_EXECUTION_MODE_LOCAL_SIZE_ID;
+                    for (uint32_t i = 0; i < 3; ++i) (ids ? local_size_ids_ : program_->local_size)[i] = Word(operands + 2 + i);
+                    if (ids) local_size_ids_[3] = 1;
+                }
+                if (count >= 2 && Word(operands) == entry_id && Word(operands + 1) == SPIRV_EXECUTION_MODE_EARLY_FRAGMENT_TESTS) {
+                    program_->early_fragment_tests = true;
+                }
+                return true;
+            case SPIRV_OP_FUNCTION:
+                if (function_ || count < 2 || !Valid(Word(operands + 1))) return false;
+                function_ = Word(operands + 1);
+                function_indices_[function_] = (uint32_t)program_->functions.size();
+                program_->functions.push_back(ShaderFunction());
+                program_->functions.back().first_block = (uint32_t)program_->blocks.size();
+                program_->value_types[function_] = Word(operands);
+                return true;
+            case SPIRV_OP_FUNCTION_PARAMETER:
+                if (!function_ || count < 2 || !Valid(Word(operands + 1)) || AddRegister(Word(operands + 1), Word(operands)) == UINT32_MAX) return false;
+                program_->value_types[Word(operands + 1)] = Word(operands);
+                program_->functions.back().parameters.push_back(Word(operands + 1));
+                return true;
+            case SPIRV_OP_FUNCTION_END:
+                if (!function_ || (current_block_ && !CloseBlock())) return false;
+                function_ = 0;
+                return true;
+            case SPIRV_OP_LABEL: {
+                if (!function_ || count < 1 || !Valid(Word(operands)) || (current_block_ && !CloseBlock())) return false;
+                current_block_ = Word(operands);
+                block_indices_[current_block_] = (uint32_t)program_->blocks.size();
+                const uint32_t begin = (uint32_t)program_->instructions.size();
+                const ShaderBlock block = {begin, begin, begin};
+                program_->blocks.push_back(block);
+                phi_components_ = 0;
+                return true;
+            }
+            case SPIRV_OP_LINE:
+            case SPIRV_OP_NO_LINE:
+            case SPIRV_OP_NOP:
+            case SPIRV_OP_SELECTION_MERGE:
+            case SPIRV_OP_LOOP_MERGE:
+            case SPIRV_OP_MEMORY_BARRIER:
+                return true;
+            default:
+                if (!function_) return true;  // Debug information, decorations and the like
+                if (!current_block_ || !IsSupported(op)) return false;
+                if (!AddInstruction(op, operands, count, HasResult(op))) return false;
+                if (op == SPIRV_OP_KILL || op == SPIRV_OP_TERMINATE_INVOCATION) program_->discards = true;
+                switch (op) {
+                    case SPIRV_OP_BRANCH:
+                    case SPIRV_OP_BRANCH_CONDITIONAL:
+                    case SPIRV_OP_SWITCH:
+                    case SPIRV_OP_KILL:
+                    case SPIRV_OP_RETURN:
+                    case SPIRV_OP_RETURN_VALUE:
+                    case SPIRV_OP_UNREACHABLE:
+                    case SPIRV_OP_TERMINATE_INVOCATION:
+                        return CloseBlock();
+                    default:
+                        return true;
+                }
+        }
+    }
+
+    bool CloseBlock() {
+        if (program_->instructions.size() == program_->blocks.back().body) return false;
+        program_->blocks.back().end = (uint32_t)program_->instructions.size();
+        current_block_ = 0;
+        return true;
+    }
+
+    bool ResolveLabel(uint32_t index) {
+        const uint32_t label = Word(index);
+        if (!Valid(label) || block_indices_[label] == UINT32_MAX) return false;
+        program_->words[index] = block_indices_[label];
+        return true;
+    }
+
+    // Replaces the labels operands refer to by block indices and the functions calls refer to by function indices,
+    // once all of them are known
+    bool Resolve(uint32_t entry_id) {
+        if (function_indices_[entry_id] == UINT32_MAX) return false;
+        program_->entry_function = function_indices_[entry_id];
+        for (auto& instruction : program_->instructions) {
+            const uint32_t first = instruction.operands;
+            switch (instruction.op) {
+                case SPIRV_OP_BRANCH:
+                    if (instruction.operand_count < 1 || !ResolveLabel(first)) return false;
+                    break;
+                case SPIRV_OP_BRANCH_CONDITIONAL:
+                    if (instruction.operand_count < 3 || !ResolveLabel(first + 1) || !ResolveLabel(first + 2)) return false;
+                    break;
+                case SPIRV_OP_SWITCH:
+                    if (instruction.operand_count < 2 || !ResolveLabel(first + 1)) return false;
+                    for (uint32_t i = 3; i < instruction.operand_count; i += 2) {
+                        if (!ResolveLabel(first + i)) return false;
+                    }
+                    break;
+                case SPIRV_OP_PHI:
+                    for (uint32_t i = 1; i < instruction.operand_count; i += 2) {
+                        if (!ResolveLabel(first + i)) return false;
+                    }
+                    break;
+                case SPIRV_OP_FUNCTION_CALL: {
+                    const uint32_t function = Word(first);
+                    if (function_indices_[function] == UINT32_MAX ||
+                        program_->functions[function_indices_[function]].parameters.size() != instruction.operand_count - 1u) {
+                        return false;
+                    }
+                    instruction.aux[0] = function_indices_[function];
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        for (uint32_t i = 0; local_size_ids_[3] && i < 3; ++i) {
+            const uint32_t id = local_size_ids_[i];
+            if (!Valid(id) || !known_[id]) return false;
+            program_->local_size[i] = program_->constants[program_->slots[id]];
+        }
+        // A constant decorated as the workgroup size overrides the execution mode
+        for (uint32_t id = 0; id < decorations_.size(); ++id) {
+            if (decorations_[id].built_in != SPIRV_BUILT_IN_WORKGROUP_SIZE || program_->slots[id] == UINT32_MAX ||
+                GetType(id) == 0 || program_->types[GetType(id)].op == SPIRV_OP_TYPE_POINTER) {
+                continue;
+            }
+            if (!known_[id] || program_->types[GetType(id)].components != 3) return false;
+            for (uint32_t i = 0; i < 3; ++i) program_->local_size[i] = program_->constants[program_->slots[id] + i];
+        }
+        return true;
+    }
+
+    std::unique_ptr<ShaderProgram> program_;
+    const VkSpecializationInfo* specialization_ = nullptr;
+    std::vector<Decorations> decorations_;
+    std::vector<uint32_t> block_indices_;     // By label id
+    std::vector<uint32_t> function_indices_;  // By function id
+    std::vector<bool> known_;                 // Constants whose value is known when translating
+    std::map<uint32_t, uint32_t> descriptor_arrays_;  // Variables holding arrays of descriptors, with their length
+    uint32_t local_size_ids_[4] = {};  // Set by LocalSizeId, the last element once it is
+    uint32_t glsl_import_ = 0;
+    uint32_t function_ = 0;
+    uint32_t current_block_ = 0;
+    uint32_t phi_components_ = 0;
+};
+
+std::unique_ptr<ShaderProgram> TranslateShader(const uint32_t* code, size_t word_count, const char* entry_point,
+                                               uint32_t execution_model, const VkSpecializationInfo* specialization) {
+    if (!code || !entry_point) return nullptr;
+    return ShaderTranslator(code, word_count).Translate(entry_point, execution_model, specialization);
+}
+
+static inline uint32_t ShaderFindLsb(uint32_t value) {
+    if (!value) return UINT32_MAX;
+    uint32_t bit = 0;
+    while (!(value >> bit & 1)) bit++;
+    return bit;
+}
+
+static inline uint32_t ShaderFindMsb(uint32_t value) {
+    if (!value) return UINT32_MAX;
+    uint32_t bit = 31;
+    while (!(value >> bit & 1)) bit--;
+    return bit;
+}
+
+static inline uint32_t ShaderFloatToInt(float value, bool is_signed) {
+    if (value != value) return 0;
+    if (is_signed) return (uint32_t)(int32_t)std::max(std::min(value, 2147483520.0f), -2147483648.0f);
+    return (uint32_t)std::max(std::min(value, 4294967040.0f), 0.0f);
+}
+
+void ShaderInvocations::Execute(const ShaderInstruction& instruction, LaneMask active) {
+    const uint32_t components = instruction.type ? Components(instruction.type) : 0;
+    uint32_t* result = scratch_.data();
+    const uint32_t* a = FindRegister(instruction, 0);
+    const uint32_t* b = FindRegister(instruction, 1);
+    switch (instruction.op) {
+        case SPIRV_OP_LOAD:
+        case SPIRV_OP_ATOMIC_LOAD:
+            Load(a, instruction.type, active, result);
+            Commit(instruction.result, result, components);
+            break;
+        case SPIRV_OP_STORE:
+            Store(a, b, instruction.aux[0], active);
+            break;
+        case SPIRV_OP_ATOMIC_STORE: {
+            const uint32_t* value = OperandRegister(instruction, 3);
+            Atomic(instruction, active, [value](std::atomic<uint32_t>* target, uint32_t l) {
+                target->store(value[l]);
+                return 0u;
+            });
+            break;
+        }
+        case SPIRV_OP_COPY_MEMORY:
+            Load(b, instruction.aux[0], active, result);
+            Store(a, result, instruction.aux[0], active);
+            break;
+        case SPIRV_OP_ACCESS_CHAIN:
+        case SPIRV_OP_IN_BOUNDS_ACCESS_CHAIN:
+            AccessChain(instruction);
+            break;
+        case SPIRV_OP_ARRAY_LENGTH:
+            for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+                const uint64_t size = a[l] < regions_.size() ? regions_[a[l]].size : 0;
+                const uint64_t offset = (uint64_t)a[SHADER_LANES + l] + instruction.aux[0];
+                result[l] = size > offset && instruction.aux[1] ? (uint32_t)((size - offset) / instruction.aux[1]) : 0;
+            }
+            Commit(instruction.result, result, 1);
+            break;
+        case SPIRV_OP_COPY_OBJECT:
+        case SPIRV_OP_COPY_LOGICAL:
+        case SPIRV_OP_IMAGE:
+        case SPIRV_OP_BITCAST:
+        case SPIRV_OP_UCONVERT:
+        case SPIRV_OP_SCONVERT:
+        case SPIRV_OP_FCONVERT:
+        case SPIRV_OP_QUANTIZE_TO_F16:
+            Commit(instruction.result, a, components);
+            break;
+        case SPIRV_OP_COMPOSITE_CONSTRUCT: {
+            // Values are flattened, so constituents simply follow each other
+            uint32_t component = 0;
+            for (uint32_t i = 0; i < instruction.operand_count && component < components; ++i) {
+                const uint32_t id = Operand(instruction, i);
+                const uint32_t count = std::min(Components(program_.value_types[id]), components - component);
+                memcpy(result + component * SHADER_LANES, Register(id), count * SHADER_LANES * sizeof(uint32_t));
+                component += count;
+            }
+            Commit(instruction.result, result, component);
+            break;
+        }
+        case SPIRV_OP_COMPOSITE_EXTRACT:
+            Commit(instruction.result, a + instruction.aux[0] * SHADER_LANES, components);
+            break;
+        case SPIRV_OP_COMPOSITE_INSERT:
+            memcpy(result, b, components * SHADER_LANES * sizeof(uint32_t));
+            memcpy(result + instruction.aux[0] * SHADER_LANES, a, instruction.aux[1] * SHADER_LANES * sizeof(uint32_t));
+            Commit(instruction.result, result, components);
+            break;
+        case SPIRV_OP_VECTOR_SHUFFLE:
+            for (uint32_t c = 0; c < components; ++c) {
+                const uint32_t select = Operand(instruction, 2 + c);
+                if (select == UINT32_MAX) {
+                    memset(result + c * SHADER_LANES, 0, SHADER_LANES * sizeof(uint32_t));
+                    continue;
+                }
+                const uint32_t* source = select < instruction.aux[0] ? a + select * SHADER_LANES : b + (select - instruction.aux[0]) * SHADER_LANES;
+                memcpy(result + c * SHADER_LANES, source, SHADER_LANES * sizeof(uint32_t));
+            }
+            Commit(instruction.result, result, components);
+            break;
+        case SPIRV_OP_VECTOR_EXTRACT_DYNAMIC:
+            for (uint32_t l = 0; l < SHADER_LANES; ++l) result[l] = b[l] < instruction.aux[0] ? a[b[l] * SHADER_LANES + l] : 0;
+            Commit(instruction.result, result, 1);
+            break;
+        case SPIRV_OP_VECTOR_INSERT_DYNAMIC: {
+            const uint32_t* index = OperandRegister(instruction, 2);
+            memcpy(result, a, components * SHADER_LANES * sizeof(uint32_t));
+            for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+                if (index[l] < components) result[index[l] * SHADER_LANES + l] = b[l];
+            }
+            Commit(instruction.result, result, components);
+            break;
+        }
+        case SPIRV_OP_TRANSPOSE: {
+            const uint32_t rows = instruction.aux[1], columns = instruction.aux[0] / rows;
+            for (uint32_t r = 0; r < rows; ++r) {
+                for (uint32_t c = 0; c < columns; ++c) memcpy(result + (r * columns + c) * SHADER_LANES, a + (c * rows + r) * SHADER_LANES, SHADER_LANES * sizeof(uint32_t));
+            }
+            Commit(instruction.result, result, components);
+            break;
+        }
+        case SPIRV_OP_CONVERT_F_TO_U:
+            Map(instruction, a, [](uint32_t x) { return ShaderFloatToInt(ShaderFloat(x), false); });
+            break;
+        case SPIRV_OP_CONVERT_F_TO_S:
+            Map(instruction, a, [](uint32_t x) { return ShaderFloatToInt(ShaderFloat(x), true); });
+            break;
+        case SPIRV_OP_CONVERT_S_TO_F:
+            Map(instruction, a, [](uint32_t x) { return ShaderBits((float)(int32_t)x); });
+            break;
+        case SPIRV_OP_CONVERT_U_TO_F:
+            Map(instruction, a, [](uint32_t x) { return ShaderBits((float)x); });
+            break;
+        case SPIRV_OP_SNEGATE:
+            Map(instruction, a, [](uint32_t x) { return 0u - x; });
+            break;
+        case SPIRV_OP_FNEGATE:
+            Map(instruction, a, [](uint32_t x) { return x ^ 0x80000000u; });
+            break;
+        case SPIRV_OP_IADD:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) { return x + y; });
+            break;
+        case SPIRV_OP_ISUB:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) { return x - y; });
+            break;
+        case SPIRV_OP_IMUL:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) { return x * y; });
+            break;
+        case SPIRV_OP_UDIV:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) { return y ? x / y : 0; });
+            break;
+        case SPIRV_OP_UMOD:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) { return y ? x % y : 0; });
+            break;
+        case SPIRV_OP_SDIV:
+            // Division by zero and overflow are undefined, they give zero and the dividend
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) { return !y ? 0 : y == UINT32_MAX ? 0u - x : (uint32_t)((int32_t)x / (int32_t)y); });
+            break;
+        case SPIRV_OP_SREM:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) { return !y || y == UINT32_MAX ? 0 : (uint32_t)((int32_t)x % (int32_t)y); });
+            break;
+        case SPIRV_OP_SMOD:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) {
+                if (!y || y == UINT32_MAX) return 0u;
+                const int32_t remainder = (int32_t)x % (int32_t)y;
+                return (uint32_t)(remainder && (remainder < 0) != ((int32_t)y < 0) ? remainder + (int32_t)y : remainder);
+            });
+            break;
+        case SPIRV_OP_FADD:
+            MapFloat(instruction, a, b, [](float x, float y) { return x + y; });
+            break;
+        case SPIRV_OP_FSUB:
+            MapFloat(instruction, a, b, [](float x, float y) { return x - y; });
+            break;
+        case SPIRV_OP_FMUL:
+            MapFloat(instruction, a, b, [](float x, float y) { return x * y; });
+            break;
+        case SPIRV_OP_FDIV:
+            MapFloat(instruction, a, b, [](float x, float y) { return x / y; });
+            break;
+        case SPIRV_OP_FREM:
+            MapFloat(instruction, a, b, [](float x, float y) { return std::fmod(x, y); });
+            break;
+        case SPIRV_OP_FMOD:
+            MapFloat(instruction, a, b, [](float x, float y) { return x - y * std::floor(x / y); });
+            break;
+        case SPIRV_OP_VECTOR_TIMES_SCALAR:
+        case SPIRV_OP_MATRIX_TIMES_SCALAR:
+            for (uint32_t c = 0; c < components; ++c) {
+                for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+                    result[c * SHADER_LANES + l] = ShaderBits(ShaderFloat(a[c * SHADER_LANES + l]) * ShaderFloat(b[l]));
+                }
+            }
+            Commit(instruction.result, result, components);
+            break;
+        case SPIRV_OP_DOT:
+        case SPIRV_OP_MATRIX_TIMES_VECTOR:
+        case SPIRV_OP_VECTOR_TIMES_MATRIX:
+        case SPIRV_OP_MATRIX_TIMES_MATRIX:
+        case SPIRV_OP_OUTER_PRODUCT: {
+            // Every result component is a sum of products of components of a and b, taken with these strides
+            // Matrices are column-major, each result component sums terms products of a row of a and a column of b
+            uint32_t rows = 1, terms = instruction.aux[0], a_stride = 1;
+            if (instruction.op == SPIRV_OP_MATRIX_TIMES_VECTOR || instruction.op == SPIRV_OP_MATRIX_TIMES_MATRIX) {
+                rows = instruction.aux[1], terms = instruction.aux[0] / rows, a_stride = rows;
+            } else if (instruction.op == SPIRV_OP_OUTER_PRODUCT) {
+                rows = instruction.aux[0], terms = 1;
+            }
+            for (uint32_t c = 0; c < components; ++c) {
+                const uint32_t* x = a + (c % rows) * SHADER_LANES;
+                const uint32_t* y = b + (c / rows) * terms * SHADER_LANES;
+                float sums[SHADER_LANES] = {};
+                for (uint32_t t = 0; t < terms; ++t) {
+                    for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+                        sums[l] += ShaderFloat(x[t * a_stride * SHADER_LANES + l]) * ShaderFloat(y[t * SHADER_LANES + l]);
+                    }
+                }
+                for (uint32_t l = 0; l < SHADER_LANES; ++l) result[c * SHADER_LANES + l] = ShaderBits(sums[l]);
+            }
+            Commit(instruction.result, result, components);
+            break;
+        }
+        case SPIRV_OP_IADD_CARRY:
+        case SPIRV_OP_ISUB_BORROW:
+        case SPIRV_OP_UMUL_EXTENDED:
+        case SPIRV_OP_SMUL_EXTENDED: {
+            // Results are structs of the low and high words
+            const uint32_t count = components / 2 * SHADER_LANES;
+            for (uint32_t i = 0; i < count; ++i) {
+                uint64_t wide;
+                switch (instruction.op) {
+                    case SPIRV_OP_IADD_CARRY: wide = (uint64_t)a[i] + b[i]; break;
+                    case SPIRV_OP_ISUB_BORROW: wide = (uint64_t)(a[i] - b[i]) | ((uint64_t)(a[i] < b[i]) << 32); break;
+                    case SPIRV_OP_UMUL_EXTENDED: wide = (uint64_t)a[i] * b[i]; break;
+                    default: wide = (uint64_t)((int64_t)(int32_t)a[i] * (int32_t)b[i]); break;
+                }
+                result[i] = (uint32_t)wide;
+                result[count + i] = (uint32_t)(wide >> 32);
+            }
+            Commit(instruction.result, result, components);
+            break;
+        }
+        case SPIRV_OP_ANY:
+        case SPIRV_OP_ALL:
+            for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+                bool any = false, all = true;
+                for (uint32_t c = 0; c < instruction.aux[0]; ++c) {
+                    any = any || a[c * SHADER_LANES + l];
+                    all = all && a[c * SHADER_LANES + l];
+                }
+                result[l] = instruction.op == SPIRV_OP_ANY ? any : all;
+            }
+            Commit(instruction.result, result, 1);
+            break;
+        case SPIRV_OP_IS_NAN:
+            Map(instruction, a, [](uint32_t x) -> uint32_t { return (x & 0x7FFFFFFF) > 0x7F800000; });
+            break;
+        case SPIRV_OP_IS_INF:
+            Map(instruction, a, [](uint32_t x) -> uint32_t { return (x & 0x7FFFFFFF) == 0x7F800000; });
+            break;
+        case SPIRV_OP_LOGICAL_EQUAL:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) -> uint32_t { return !x == !y; });
+            break;
+        case SPIRV_OP_LOGICAL_NOT_EQUAL:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) -> uint32_t { return !x != !y; });
+            break;
+        case SPIRV_OP_LOGICAL_OR:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) -> uint32_t { return x || y; });
+            break;
+        case SPIRV_OP_LOGICAL_AND:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) -> uint32_t { return x && y; });
+            break;
+        case SPIRV_OP_LOGICAL_NOT:
+            Map(instruction, a, [](uint32_t x) -> uint32_t { return !x; });
+            break;
+        case SPIRV_OP_SELECT: {
+            const uint32_t* c = OperandRegister(instruction, 2);
+            for (uint32_t i = 0; i < components; ++i) {
+                const uint32_t* condition = a + (instruction.aux[0] == 1 ? 0 : i) * SHADER_LANES;
+                for (uint32_t l = 0; l < SHADER_LANES; ++l) result[i * SHADER_LANES + l] = condition[l] ? b[i * SHADER_LANES + l] : c[i * SHADER_LANES + l];
+            }
+            Commit(instruction.result, result, components);
+            break;
+        }
+        case SPIRV_OP_IEQUAL:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) -> uint32_t { return x == y; });
+            break;
+        case SPIRV_OP_INOT_EQUAL:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) -> uint32_t { return x != y; });
+            break;
+        case SPIRV_OP_UGREATER_THAN:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) -> uint32_t { return x > y; });
+            break;
+        case SPIRV_OP_SGREATER_THAN:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) -> uint32_t { return (int32_t)x > (int32_t)y; });
+            break;
+        case SPIRV_OP_UGREATER_THAN_EQUAL:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) -> uint32_t { return x >= y; });
+            break;
+        case SPIRV_OP_SGREATER_THAN_EQUAL:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) -> uint32_t { return (int32_t)x >= (int32_t)y; });
+            break;
+        case SPIRV_OP_ULESS_THAN:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) -> uint32_t { return x < y; });
+            break;
+        case SPIRV_OP_SLESS_THAN:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) -> uint32_t { return (int32_t)x < (int32_t)y; });
+            break;
+        case SPIRV_OP_ULESS_THAN_EQUAL:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) -> uint32_t { return x <= y; });
+            break;
+        case SPIRV_OP_SLESS_THAN_EQUAL:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) -> uint32_t { return (int32_t)x <= (int32_t)y; });
+            break;
+        // Comparisons with NaN are false in C++, which is what ordered comparisons want
+        case SPIRV_OP_FORD_EQUAL:
+            CompareFloat(instruction, [](float x, float y) { return x == y; });
+            break;
+        case SPIRV_OP_FUNORD_EQUAL:
+            CompareFloat(instruction, [](float x, float y) { return !(x < y || x > y); });
+            break;
+        case SPIRV_OP_FORD_NOT_EQUAL:
+            CompareFloat(instruction, [](float x, float y) { return x < y || x > y; });
+            break;
+        case SPIRV_OP_FUNORD_NOT_EQUAL:
+            CompareFloat(instruction, [](float x, float y) { return x != y; });
+            break;
+        case SPIRV_OP_FORD_LESS_THAN:
+            CompareFloat(instruction, [](float x, float y) { return x < y; });
+            break;
+        case SPIRV_OP_FUNORD_LESS_THAN:
+            CompareFloat(instruction, [](float x, float y) { return !(x >= y); });
+            break;
+        case SPIRV_OP_FORD_GREATER_THAN:
+            CompareFloat(instruction, [](float x, float y) { return x > y; });
+            break;
+        case SPIRV_OP_FUNORD_GREATER_THAN:
+            CompareFloat(instruction, [](float x, float y) { return !(x <= y); });
+            break;
+        case SPIRV_OP_FORD_LESS_THAN_EQUAL:
+            CompareFloat(instruction, [](float x, float y) { return x <= y; });
+            break;
+        case SPIRV_OP_FUNORD_LESS_THAN_EQUAL:
+            CompareFloat(instruction, [](float x, float y) { return !(x > y); });
+            break;
+        case SPIRV_OP_FORD_GREATER_THAN_EQUAL:
+            CompareFloat(instruction, [](float x, float y) { return x >= y; });
+            break;
+        case SPIRV_OP_FUNORD_GREATER_THAN_EQUAL:
+            CompareFloat(instruction, [](float x, float y) { return !(x < y); });
+            break;
+        // Shifting by the width or more is undefined, shifts take the amount modulo the width like CPUs do
+        case SPIRV_OP_SHIFT_RIGHT_LOGICAL:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) { return x >> (y & 31); });
+            break;
+        case SPIRV_OP_SHIFT_RIGHT_ARITHMETIC:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) { return (uint32_t)((int32_t)x >> (y & 31)); });
+            break;
+        case SPIRV_OP_SHIFT_LEFT_LOGICAL:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) { return x << (y & 31); });
+            break;
+        case SPIRV_OP_BITWISE_OR:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) { return x | y; });
+            break;
+        case SPIRV_OP_BITWISE_XOR:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) { return x ^ y; });
+            break;
+        case SPIRV_OP_BITWISE_AND:
+            Map(instruction, a, b, [](uint32_t x, uint32_t y) { return x & y; });
+            break;
+        case SPIRV_OP_NOT:
+            Map(instruction, a, [](uint32_t x) { return ~x; });
+            break;
+        case SPIRV_OP_BIT_FIELD_INSERT:
+        case SPIRV_OP_BIT_FIELD_S_EXTRACT:
+        case SPIRV_OP_BIT_FIELD_U_EXTRACT: {
+            // Offset and count are scalars for every component
+            const bool insert = instruction.op == SPIRV_OP_BIT_FIELD_INSERT;
+            const uint32_t* offset = OperandRegister(instruction, insert ? 2 : 1);
+            const uint32_t* count = OperandRegister(instruction, insert ? 3 : 2);
+            for (uint32_t c = 0; c < components; ++c) {
+                for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+                    const uint32_t i = c * SHADER_LANES + l, shift = offset[l] & 31, bits = std::min(count[l], 32 - shift);
+                    const uint32_t mask = bits == 32 ? ~0u : ((1u << bits) - 1);
+                    if (insert) {
+                        result[i] = (a[i] & ~(mask << shift)) | ((b[i] & mask) << shift);
+                    } else {
+                        uint32_t field = (a[i] >> shift) & mask;
+                        if (instruction.op == SPIRV_OP_BIT_FIELD_S_EXTRACT && bits && bits < 32 && (field >> (bits - 1) & 1)) field |= ~mask;
+                        result[i] = bits ? field : 0;
+                    }
+                }
+            }
+            Commit(instruction.result, result, components);
+            break;
+        }
+        case SPIRV_OP_BIT_REVERSE:
+            Map(instruction, a, [](uint32_t x) {
+                uint32_t reversed = 0;
+                for (uint32_t bit = 0; bit < 32; ++bit) reversed |= (x >> bit & 1) << (31 - bit);
+                return reversed;
+            });
+            break;
+        case SPIRV_OP_BIT_COUNT:
+            Map(instruction, a, [](uint32_t x) {
+                uint32_t count = 0;
+                for (; x; x &= x - 1) count++;
+                return count;
+            });
+            break;
+        case SPIRV_OP_ATOMIC_EXCHANGE: {
+            const uint32_t* value = OperandRegister(instruction, 3);
+            Atomic(instruction, active, [value](std::atomic<uint32_t>* target, uint32_t l) { return target->exchange(value[l]); });
+            break;
+        }
+        case SPIRV_OP_ATOMIC_COMPARE_EXCHANGE:
+        case SPIRV_OP_ATOMIC_COMPARE_EXCHANGE_WEAK: {
+            const uint32_t* value = OperandRegister(instruction, 4);
+            const uint32_t* comparator = OperandRegister(instruction, 5);
+            Atomic(instruction, active, [value, comparator](std::atomic<uint32_t>* target, uint32_t l) {
+                uint32_t expected = comparator[l];
+                target->compare_exchange_strong(expected, value[l]);
+                return expected;
+            });
+            break;
+        }
+        case SPIRV_OP_ATOMIC_IINCREMENT:
+            Atomic(instruction, active, [](std::atomic<uint32_t>* target, uint32_t) { return target->fetch_add(1); });
+            break;
+        case SPIRV_OP_ATOMIC_IDECREMENT:
+            Atomic(instruction, active, [](std::atomic<uint32_t>* target, uint32_t) { return target->fetch_sub(1); });
+            break;
+        case SPIRV_OP_ATOMIC_IADD:
+        case SPIRV_OP_ATOMIC_ISUB:
+        case SPIRV_OP_ATOMIC_SMIN:
+        case SPIRV_OP_ATOMIC_UMIN:
+        case SPIRV_OP_ATOMIC_SMAX:
+        case SPIRV_OP_ATOMIC_UMAX:
+        case SPIRV_OP_ATOMIC_AND:
+        case SPIRV_OP_ATOMIC_OR:
+        case SPIRV_OP_ATOMIC_XOR: {
+            const uint32_t* value = OperandRegister(instruction, 3);
+            const uint32_t op = instruction.op;
+            Atomic(instruction, active, [value, op](std::atomic<uint32_t>* target, uint32_t l) {
+                const uint32_t y = value[l];
+                switch (op) {
+                    case SPIRV_OP_ATOMIC_IADD: return target->fetch_add(y);
+                    case SPIRV_OP_ATOMIC_ISUB: return target->fetch_sub(y);
+                    case SPIRV_OP_ATOMIC_AND: return target->fetch_and(y);
+                    case SPIRV_OP_ATOMIC_OR: return target->fetch_or(y);
+                    case SPIRV_OP_ATOMIC_XOR: return target->fetch_xor(y);
+                    case SPIRV_OP_ATOMIC_SMIN: return AtomicUpdate(target, [y](uint32_t x) { return (int32_t)y < (int32_t)x ? y : x; });
+                    case SPIRV_OP_ATOMIC_UMIN: return AtomicUpdate(target, [y](uint32_t x) { return std::min(x, y); });
+                    case SPIRV_OP_ATOMIC_SMAX: return AtomicUpdate(target, [y](uint32_t x) { return (int32_t)y > (int32_t)x ? y : x; });
+                    default: return AtomicUpdate(target, [y](uint32_t x) { return std::max(x, y); });
+                }
+            });
+            break;
+        }
+        case SPIRV_OP_EXT_INST:
+            ExtInst(instruction);
+            break;
+        case SPIRV_OP_SAMPLED_IMAGE:
+            memcpy(result, a, SHADER_LANES * sizeof(uint32_t));
+            memcpy(result + SHADER_LANES, b, SHADER_LANES * sizeof(uint32_t));
+            Commit(instruction.result, result, 2);
+            break;
+        case SPIRV_OP_IMAGE_SAMPLE_IMPLICIT_LOD:
+        case SPIRV_OP_IMAGE_SAMPLE_EXPLICIT_LOD:
+        case SPIRV_OP_IMAGE_FETCH:
+            Sample(instruction, active);
+            break;
+        default:
+            if (instruction.op >= SPIRV_OP_DPDX && instruction.op <= SPIRV_OP_FWIDTH_COARSE) Derivative(instruction);
+            break;
+    }
+}
+
+void ShaderInvocations::ExtInst(const ShaderInstruction& instruction) {
+    const uint32_t components = Components(instruction.type);
+    const uint32_t* a = OperandRegister(instruction, 2);
+    const uint32_t* b = instruction.operand_count > 3 ? OperandRegister(instruction, 3) : a;
+    const uint32_t* c = instruction.operand_count > 4 ? OperandRegister(instruction, 4) : a;
+    const uint32_t size = Components(program_.value_types[Operand(instruction, 2)]);  // Of the first argument
+    uint32_t* result = scratch_.data();
+    // Dot products of the first argument's size, by lane
+    auto dot = [size](const uint32_t* x, const uint32_t* y, float* sums) {
+        for (uint32_t l = 0; l < SHADER_LANES; ++l) sums[l] = 0;
+        for (uint32_t i = 0; i < size; ++i) {
+            for (uint32_t l = 0; l < SHADER_LANES; ++l) sums[l] += ShaderFloat(x[i * SHADER_LANES + l]) * ShaderFloat(y[i * SHADER_LANES + l]);
+        }
+    };
+    float sums[SHADER_LANES];
+    switch (instruction.aux[0]) {
+        case GLSL_ROUND: return MapFloat(instruction, a, [](float x) { return std::round(x); });
+        case GLSL_ROUND_EVEN: return MapFloat(instruction, a, [](float x) { return std::nearbyint(x); });
+        case GLSL_TRUNC: return MapFloat(instruction, a, [](float x) { return std::trunc(x); });
+        case GLSL_FABS: return Map(instruction, a, [](uint32_t x) { return x & 0x7FFFFFFFu; });
+        case GLSL_SABS: return Map(instruction, a, [](uint32_t x) { return (int32_t)x < 0 ? 0u - x : x; });
+        case GLSL_FSIGN: return MapFloat(instruction, a, [](float x) { return x > 0 ? 1.0f : x < 0 ? -1.0f : 0.0f; });
+        case GLSL_SSIGN: return Map(instruction, a, [](uint32_t x) { return (int32_t)x > 0 ? 1u : (int32_t)x < 0 ? UINT32_MAX : 0u; });
+        case GLSL_FLOOR: return MapFloat(instruction, a, [](float x) { return std::floor(x); });
+        case GLSL_CEIL: return MapFloat(instruction, a, [](float x) { return std::ceil(x); });
+        case GLSL_FRACT: return MapFloat(instruction, a, [](float x) { return x - std::floor(x); });
+        case GLSL_RADIANS: return MapFloat(instruction, a, [](float x) { return x * 0.017453292f; });
+        case GLSL_DEGREES: return MapFloat(instruction, a, [](float x) { return x * 57.29578f; });
+        case GLSL_SIN: return MapFloat(instruction, a, [](float x) { return std::sin(x); });
+        case GLSL_COS: return MapFloat(instruction, a, [](float x) { return std::cos(x); });
+        case GLSL_TAN: return MapFloat(instruction, a, [](float x) { return std::tan(x); });
+        case GLSL_ASIN: return MapFloat(instruction, a, [](float x) { return std::asin(x); });
+        case GLSL_ACOS: return MapFloat(instruction, a, [](float x) { return std::acos(x); });
+        case GLSL_ATAN: return MapFloat(instruction, a, [](float x) { return std::atan(x); });
+        case GLSL_SINH: return MapFloat(instruction, a, [](float x) { return std::sinh(x); });
+        case GLSL_COSH: return MapFloat(instruction, a, [](float x) { return std::cosh(x); });
+        case GLSL_TANH: return MapFloat(instruction, a, [](float x) { return std::tanh(x); });
+        case GLSL_ASINH: return MapFloat(instruction, a, [](float x) { return std::asinh(x); });
+        case GLSL_ACOSH: return MapFloat(instruction, a, [](float x) { return std::acosh(x); });
+        case GLSL_ATANH: return MapFloat(instruction, a, [](float x) { return std::atanh(x); });
+        case GLSL_ATAN2: return MapFloat(instruction, a, b, [](float y, float x) { return std::atan2(y, x); });
+        case GLSL_POW: return MapFloat(instruction, a, b, [](float x, float y) { return std::pow(x, y); });
+        case GLSL_EXP: return MapFloat(instruction, a, [](float x) { return std::exp(x); });
+        case GLSL_LOG: return MapFloat(instruction, a, [](float x) { return std::log(x); });
+        case GLSL_EXP2: return MapFloat(instruction, a, [](float x) { return std::exp2(x); });
+        case GLSL_LOG2: return MapFloat(instruction, a, [](float x) { return std::log2(x); });
+        case GLSL_SQRT: return MapFloat(instruction, a, [](float x) { return std::sqrt(x); });
+        case GLSL_INVERSE_SQRT: return MapFloat(instruction, a, [](float x) { return 1 / std::sqrt(x); });
+        case GLSL_FMIN: return MapFloat(instruction, a, b, [](float x, float y) { return y < x ? y : x; });
+        case GLSL_FMAX: return MapFloat(instruction, a, b, [](float x, float y) { return x < y ? y : x; });
+        case GLSL_NMIN: return MapFloat(instruction, a, b, [](float x, float y) { return std::fmin(x, y); });
+        case GLSL_NMAX: return MapFloat(instruction, a, b, [](float x, float y) { return std::fmax(x, y); });
+        case GLSL_UMIN: return Map(instruction, a, b, [](uint32_t x, uint32_t y) { return std::min(x, y); });
+        case GLSL_UMAX: return Map(instruction, a, b, [](uint32_t x, uint32_t y) { return std::max(x, y); });
+        case GLSL_SMIN: return Map(instruction, a, b, [](uint32_t x, uint32_t y) { return (int32_t)y < (int32_t)x ? y : x; });
+        case GLSL_SMAX: return Map(instruction, a, b, [](uint32_t x, uint32_t y) { return (int32_t)x < (int32_t)y ? y : x; });
+        case GLSL_FCLAMP:
+        case GLSL_NCLAMP:
+            return MapFloat(instruction, a, b, c, [](float x, float low, float high) { return std::fmin(std::fmax(x, low), high); });
+        case GLSL_UCLAMP: return Map(instruction, a, b, c, [](uint32_t x, uint32_t low, uint32_t high) { return std::min(std::max(x, low), high); });
+        case GLSL_SCLAMP:
+            return Map(instruction, a, b, c, [](uint32_t x, uint32_t low, uint32_t high) {
+                return (uint32_t)std::min(std::max((int32_t)x, (int32_t)low), (int32_t)high);
+            });
+        case GLSL_FMIX: return MapFloat(instruction, a, b, c, [](float x, float y, float t) { return x + (y - x) * t; });
+        case GLSL_STEP: return MapFloat(instruction, a, b, [](float edge, float x) { return x < edge ? 0.0f : 1.0f; });
+        case GLSL_SMOOTH_STEP:
+            return MapFloat(instruction, a, b, c, [](float edge0, float edge1, float x) {
+                const float t = std::fmin(std::fmax((x - edge0) / (edge1 - edge0), 0.0f), 1.0f);
+                return t * t * (3 - 2 * t);
+            });
+        case GLSL_FMA: return MapFloat(instruction, a, b, c, [](float x, float y, float z) { return std::fma(x, y, z); });
+        case GLSL_FIND_ILSB: return Map(instruction, a, [](uint32_t x) { return ShaderFindLsb(x); });
+        case GLSL_FIND_UMSB: return Map(instruction, a, [](uint32_t x) { return ShaderFindMsb(x); });
+        case GLSL_FIND_SMSB: return Map(instruction, a, [](uint32_t x) { return ShaderFindMsb((int32_t)x < 0 ? ~x : x); });
+        case GLSL_LENGTH:
+        case GLSL_DISTANCE: {
+            const uint32_t* x = a;
+            if (instruction.aux[0] == GLSL_DISTANCE) {
+                for (uint32_t i = 0; i < size * SHADER_LANES; ++i) result[i] = ShaderBits(ShaderFloat(a[i]) - ShaderFloat(b[i]));
+                x = result;
+            }
+            dot(x, x, sums);
+            for (uint32_t l = 0; l < SHADER_LANES; ++l) result[l] = ShaderBits(std::sqrt(sums[l]));
+            break;
+        }
+        case GLSL_NORMALIZE:
+            dot(a, a, sums);
+            for (uint32_t i = 0; i < components; ++i) {
+                for (uint32_t l = 0; l < SHADER_LANES; ++l) result[i * SHADER_LANES + l] = ShaderBits(ShaderFloat(a[i * SHADER_LANES + l]) / std::sqrt(sums[l]));
+            }
+            break;
+        case GLSL_CROSS:
+            for (uint32_t i = 0; i < 3; ++i) {
+                const uint32_t j = (i + 1) % 3, k = (i + 2) % 3;
+                for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+                    result[i * SHADER_LANES + l] = ShaderBits(ShaderFloat(a[j * SHADER_LANES + l]) * ShaderFloat(b[k * SHADER_LANES + l]) -
+                                                              ShaderFloat(a[k * SHADER_LANES + l]) * ShaderFloat(b[j * SHADER_LANES + l]));
+                }
+            }
+            break;
+        case GLSL_FACE_FORWARD:
+            // N if dot(Nref, I) < 0, -N otherwise
+            dot(c, b, sums);
+            for (uint32_t i = 0; i < components; ++i) {
+                for (uint32_t l = 0; l < SHADER_LANES; ++l) result[i * SHADER_LANES + l] = a[i * SHADER_LANES + l] ^ (sums[l] < 0 ? 0 : 0x80000000u);
+            }
+            break;
+        case GLSL_REFLECT:
+            // I - 2 * dot(N, I) * N
+            dot(b, a, sums);
+            for (uint32_t i = 0; i < components; ++i) {
+                for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+                    const uint32_t k = i * SHADER_LANES + l;
+                    result[k] = ShaderBits(ShaderFloat(a[k]) - 2 * sums[l] * ShaderFloat(b[k]));
+                }
+            }
+            break;
+        default:
+            return;
+    }
+    Commit(instruction.result, result, components);
+}
+
+// Lane 1 of a quad is right of lane 0 and lane 2 below it. Fine derivatives take the differences in the lane's row
+// or column of the quad, coarse ones those of lane 0 for the whole quad.
+void ShaderInvocations::Derivative(const ShaderInstruction& instruction) {
+    const uint32_t kind = (instruction.op - SPIRV_OP_DPDX) % 3;  // DPdx, DPdy or Fwidth
+    const bool coarse = instruction.op >= SPIRV_OP_DPDX_COARSE;
+    const uint32_t components = Components(instruction.type);
+    const uint32_t* a = OperandRegister(instruction, 0);
+    uint32_t* result = scratch_.data();
+    for (uint32_t c = 0; c < components; ++c) {
+        const uint32_t* value = a + c * SHADER_LANES;
+        for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+            const uint32_t row = coarse ? l & ~3u : l & ~1u;
+            const uint32_t column = coarse ? l & ~3u : l & ~2u;
+            const float dx = ShaderFloat(value[row + 1]) - ShaderFloat(value[row]);
+            const float dy = ShaderFloat(value[column + 2]) - ShaderFloat(value[column]);
+            result[c * SHADER_LANES + l] = ShaderBits(kind == 0 ? dx : kind == 1 ? dy : std::fabs(dx) + std::fabs(dy));
+        }
+    }
+    Commit(instruction.result, result, components);
+}
+
+void ShaderInvocations::EnterBlock(ShaderFrame* frame) {
+    // The lanes waiting for the first block in function order go next
+    uint32_t next = UINT32_MAX;
+    for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+        if (frame->lanes >> l & 1) next = std::min(next, frame->block[l]);
+    }
+    LaneMask active = 0;
+    for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+        if ((frame->lanes >> l & 1) && frame->block[l] == next) active |= 1u << l;
+    }
+    const ShaderBlock& block = program_.blocks[next];
+    frame->active = active;
+    frame->current = next;
+    frame->pc = block.body;
+    SetActive(active);
+    // Every OpPhi of the block reads its operands before any writes its result
+    uint32_t* values = scratch_.data();
+    uint32_t at = 0;
+    for (uint32_t i = block.begin; i < block.body; ++i) {
+        const ShaderInstruction& phi = program_.instructions[i];
+        const uint32_t components = Components(phi.type);
+        for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+            if (!(active >> l & 1)) continue;
+            for (uint32_t k = 0; k + 1 < phi.operand_count; k += 2) {
+                if (Operand(phi, k + 1) != frame->previous[l]) continue;
+                const uint32_t* source = OperandRegister(phi, k);
+                for (uint32_t c = 0; c < components; ++c) values[at + c * SHADER_LANES + l] = source[c * SHADER_LANES + l];
+                break;
+            }
+        }
+        at += components * SHADER_LANES;
+    }
+    at = 0;
+    for (uint32_t i = block.begin; i < block.body; ++i) {
+        const ShaderInstruction& phi = program_.instructions[i];
+        Commit(phi.result, values + at, Components(phi.type));
+        at += Components(phi.type) * SHADER_LANES;
+    }
+}
+
+// Runs a lane group until its invocations finish, returning true, or reach a barrier
+bool ShaderInvocations::RunGroup(ShaderLaneGroup* group) {
+    std::vector<ShaderFrame>& frames = group->frames;
+    registers_ = group->registers.data();
+    SetActive(frames.back().active);
+    while (!frames.empty()) {
+        ShaderFrame* frame = &frames.back();
+        if (!frame->active) {
+            if (frame->lanes) {
+                EnterBlock(frame);
+            } else {
+                frames.pop_back();
+                if (!frames.empty()) SetActive(frames.back().active);
+            }
+            continue;
+        }
+        const ShaderInstruction& instruction = program_.instructions[frame->pc++];
+        const LaneMask active = frame->active;
+        switch (instruction.op) {
+            case SPIRV_OP_BRANCH:
+            case SPIRV_OP_BRANCH_CONDITIONAL:
+            case SPIRV_OP_SWITCH: {
+                const uint32_t* selector = instruction.op == SPIRV_OP_BRANCH ? nullptr : OperandRegister(instruction, 0);
+                for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+                    if (!(active >> l & 1)) continue;
+                    uint32_t target;
+                    if (instruction.op == SPIRV_OP_BRANCH) {
+                        target = Operand(instruction, 0);
+                    } else if (instruction.op == SPIRV_OP_BRANCH_CONDITIONAL) {
+                        target = Operand(instruction, selector[l] ? 1 : 2);
+                    } else {
+                        target = Operand(instruction, 1);
+                        for (uint32_t i = 2; i + 1 < instruction.operand_count; i += 2) {
+                            if (selector[l] == Operand(instruction, i)) target = Operand(instruction, i + 1);
+                        }
+                    }
+                    frame->previous[l] = frame->current;
+                    frame->block[l] = target;
+                }
+                frame->active = 0;
+                break;
+            }
+            case SPIRV_OP_RETURN_VALUE:
+                if (frame->call != UINT32_MAX) {
+                    const ShaderInstruction& call = program_.instructions[frame->call];
+                    Commit(call.result, OperandRegister(instruction, 0), Components(call.type));
+                }
+                frame->lanes &= ~active;
+                frame->active = 0;
+                break;
+            case SPIRV_OP_RETURN:
+                frame->lanes &= ~active;
+                frame->active = 0;
+                break;
+            case SPIRV_OP_KILL:
+            case SPIRV_OP_TERMINATE_INVOCATION:
+            case SPIRV_OP_UNREACHABLE:
+                // The invocations end, in whatever function they are
+                if (instruction.op != SPIRV_OP_UNREACHABLE) group->killed |= active;
+                for (auto& caller : frames) {
+                    caller.lanes &= ~active;
+                    caller.active &= ~active;
+                }
+                break;
+            case SPIRV_OP_FUNCTION_CALL: {
+                const ShaderFunction& function = program_.functions[instruction.aux[0]];
+                for (uint32_t i = 0; i < function.parameters.size(); ++i) {
+                    const uint32_t parameter = function.parameters[i];
+                    Commit(parameter, OperandRegister(instruction, 1 + i), Components(program_.value_types[parameter]));
+                }
+                ShaderFrame callee = {};
+                callee.function = instruction.aux[0];
+                callee.call = frame->pc - 1;
+                callee.lanes = active;
+                for (uint32_t l = 0; l < SHADER_LANES; ++l) callee.block[l] = function.first_block;
+                frames.push_back(callee);
+                break;
+            }
+            case SPIRV_OP_CONTROL_BARRIER:
+                // The other lane groups of the workgroup run up to the barrier before this one goes on
+                if (Register(Operand(instruction, 0))[0] != SPIRV_SCOPE_SUBGROUP) return false;
+                break;
+            default:
+                Execute(instruction, active);
+                break;
+        }
+    }
+    return true;
+}
+
+ComputePool::~ComputePool() {
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& thread : threads_) thread.join();
+}
+
+void ComputePool::Run(uint64_t count, const std::function<void(uint32_t, uint64_t)>& run) {
+    if (count == 0) return;
+    if (count == 1 || thread_count_ == 1) {
+        for (uint64_t item = 0; item < count; ++item) run(0, item);
+        return;
+    }
+    std::lock_guard<std::mutex> run_lock(run_lock_);
+    for (uint32_t i = 0; i < thread_count_; ++i) {
+        std::lock_guard<std::mutex> lock(ranges_[i].lock);
+        ranges_[i].begin = count * i / thread_count_;
+        ranges_[i].end = count * (i + 1) / thread_count_;
+    }
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        if (threads_.empty()) {
+            for (uint32_t i = 1; i < thread_count_; ++i) threads_.emplace_back(&ComputePool::Worker, this, i);
+        }
+        run_ = &run;
+        busy_ = thread_count_ - 1;
+        generation_++;
+    }
+    work_cv_.notify_all();
+    Work(0);
+    std::unique_lock<std::mutex> lock(lock_);
+    done_cv_.wait(lock, [this] { return busy_ == 0; });
+    run_ = nullptr;
+}
+
+uint32_t ComputePool::GetDefaultThreadCount() {
+    const char* threads = getenv("VK_MOCK_COMPUTE_THREADS");
+    const unsigned long count = threads ? strtoul(threads, nullptr, 10) : std::thread::hardware_concurrency();
+    return (uint32_t)std::max(std::min(count, 256ul), 1ul);
+}
+
+void ComputePool::Worker(uint32_t thread) {
+    uint64_t generation = 0;
+    std::unique_lock<std::mutex> lock(lock_);
+    for (;;) {
+        work_cv_.wait(lock, [&] { return stopping_ || generation_ != generation; });
+        if (stopping_) break;
+        generation = generation_;
+        lock.unlock();
+        Work(thread);
+        lock.lock();
+        if (--busy_ == 0) done_cv_.notify_one();
+    }
+}
+
+void ComputePool::Work(uint32_t thread) {
+    uint64_t item;
+    while (Take(thread, &item)) (*run_)(thread, item);
+}
+
+bool ComputePool::Take(uint32_t thread, uint64_t* item) {
+    Range& own = ranges_[thread];
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(own.lock);
+            if (own.begin < own.end) {
+                *item = own.begin++;
+                return true;
+            }
+        }
+        uint32_t victim = thread;
+        uint64_t largest = 0;
+        for (uint32_t i = 0; i < thread_count_; ++i) {
+            std::lock_guard<std::mutex> lock(ranges_[i].lock);
+            if (ranges_[i].end - ranges_[i].begin > largest) {
+                victim = i;
+                largest = ranges_[i].end - ranges_[i].begin;
+            }
+        }
+        if (largest == 0) return false;
+        uint64_t begin, end;
+        {
+            std::lock_guard<std::mutex> lock(ranges_[victim].lock);
+            Range& range = ranges_[victim];
+            // Taken by others meanwhile
+            if (range.begin >= range.end) continue;
+            begin = range.end - (range.end - range.begin + 1) / 2;
+            end = range.end;
+            range.end = begin;
+        }
+        std::lock_guard<std::mutex> lock(own.lock);
+        own.begin = begin;
+        own.end = end;
+    }
+}
+
+ComputePool compute_pool;
+
+void RunWorkgroups(const ShaderProgram& program, const std::vector<ShaderRegion>& regions, const ShaderTexture* textures,
+                   uint32_t texture_count, const uint32_t base[3], const uint32_t group_count[3]) {
+    const uint32_t* size = program.local_size;
+    const uint32_t invocation_count = size[0] * size[1] * size[2];
+    const uint64_t workgroup_count = (uint64_t)group_count[0] * group_count[1] * group_count[2];
+    if (invocation_count == 0 || workgroup_count == 0) return;
+    std::vector<std::unique_ptr<ShaderInvocations>> invocations(compute_pool.GetThreadCount());
+    compute_pool.Run(workgroup_count, [&](uint32_t thread, uint64_t workgroup) {
+        if (!invocations[thread]) {
+            invocations[thread].reset(new ShaderInvocations(&program, regions, textures, texture_count));
+        }
+        ShaderInvocations* workgroup_invocations = invocations[thread].get();
+        const uint32_t workgroup_id[3] = {base[0] + (uint32_t)(workgroup % group_count[0]),
+                                          base[1] + (uint32_t)(workgroup / group_count[0] % group_count[1]),
+                                          base[2] + (uint32_t)(workgroup / group_count[0] / group_count[1])};
+        workgroup_invocations->Begin(invocation_count);
+        for (uint32_t i = 0; i < invocation_count; ++i) {
+            const uint32_t local_id[3] = {i % size[0], i / size[0] % size[1], i / size[0] / size[1]};
+            char* memory = workgroup_invocations->GetInvocationMemory(i);
+            for (const auto& variable : program.variables) {
+                uint32_t value[3];
+                switch (variable.built_in) {
+                    case SPIRV_BUILT_IN_NUM_WORKGROUPS: memcpy(value, group_count, sizeof(value)); break;
+                    case SPIRV_BUILT_IN_WORKGROUP_SIZE: memcpy(value, size, sizeof(value)); break;
+                    case SPIRV_BUILT_IN_WORKGROUP_ID: memcpy(value, workgroup_id, sizeof(value)); break;
+                    case SPIRV_BUILT_IN_LOCAL_INVOCATION_ID: memcpy(value, local_id, sizeof(value)); break;
+                    case SPIRV_BUILT_IN_GLOBAL_INVOCATION_ID:
+                        for (uint32_t c = 0; c < 3; ++c) value[c] = workgroup_id[c] * size[c] + local_id[c];
+                        break;
+                    case SPIRV_BUILT_IN_LOCAL_INVOCATION_INDEX: value[0] = i; break;
+                    default: continue;
+                }
+                memcpy(memory + variable.offset, value, std::min<uint32_t>(program.types[variable.type].size, sizeof(value)));
+            }
+        }
+        workgroup_invocations->Run();
+    });
+}
+
+}  // namespace vkmock
@@ -0,0 +1,619 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MOCK_ICD_SHADER_H
+#define MOCK_ICD_SHADER_H
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "vulkan/vulkan.h"
+
+namespace vkmock {
+
+// Compute shaders, and the vertex and fragment shaders of rasterized draws, run on the CPU, interpreted from the SPIR-V
+// the application passed to vkCreateShaderModule. Creating a pipeline translates its shaders into ShaderPrograms:
+// instructions decoded with their branch targets resolved, types laid out in memory, specialization constants applied
+// and every value given a register. Only 32-bit scalar types and sampled images are handled, a shader needing anything
+// else (other widths, storage images, subgroup operations...) gets no program and dispatches or draws with its pipeline
+// only count in the cost model.
+//
+// Invocations run SHADER_LANES at a time as a lane group. A register holds each component of a value for every lane,
+// so every instruction is a loop over the lanes that the compiler can vectorize. Lanes that diverge run each block
+// together with the other lanes reaching it, taking blocks in function order, which brings them back together where
+// structured control flow merges. Pointers are a region and an offset in it, accesses outside their region read zero
+// and write nothing, as with robust buffer access.
+static const uint32_t SHADER_LANES = 8;
+static const uint32_t SPIRV_MAGIC = 0x07230203;
+
+// The parts of the SPIR-V and GLSL.std.450 specifications the interpreter understands
+enum SpirvOp {
+    SPIRV_OP_NOP = 0, SPIRV_OP_UNDEF = 1, SPIRV_OP_LINE = 8, SPIRV_OP_EXT_INST_IMPORT = 11, SPIRV_OP_EXT_INST = 12,
+    SPIRV_OP_ENTRY_POINT = 15, SPIRV_OP_EXECUTION_MODE = 16,
+    SPIRV_OP_TYPE_VOID = 19, SPIRV_OP_TYPE_BOOL = 20, SPIRV_OP_TYPE_INT = 21, SPIRV_OP_TYPE_FLOAT = 22,
+    SPIRV_OP_TYPE_VECTOR = 23, SPIRV_OP_TYPE_MATRIX = 24, SPIRV_OP_TYPE_IMAGE = 25, SPIRV_OP_TYPE_SAMPLER = 26,
+    SPIRV_OP_TYPE_SAMPLED_IMAGE = 27, SPIRV_OP_TYPE_ARRAY = 28, SPIRV_OP_TYPE_RUNTIME_ARRAY = 29,
+    SPIRV_OP_TYPE_STRUCT = 30, SPIRV_OP_TYPE_POINTER = 32, SPIRV_OP_TYPE_FUNCTION = 33,
+    SPIRV_OP_CONSTANT_TRUE = 41, SPIRV_OP_CONSTANT_FALSE = 42, SPIRV_OP_CONSTANT = 43, SPIRV_OP_CONSTANT_COMPOSITE = 44,
+    SPIRV_OP_CONSTANT_NULL = 46, SPIRV_OP_SPEC_CONSTANT_TRUE = 48, SPIRV_OP_SPEC_CONSTANT_FALSE = 49,
+    SPIRV_OP_SPEC_CONSTANT = 50, SPIRV_OP_SPEC_CONSTANT_COMPOSITE = 51, SPIRV_OP_SPEC_CONSTANT_OP = 52,
+    SPIRV_OP_FUNCTION = 54, SPIRV_OP_FUNCTION_PARAMETER = 55, SPIRV_OP_FUNCTION_END = 56, SPIRV_OP_FUNCTION_CALL = 57,
+    SPIRV_OP_VARIABLE = 59, SPIRV_OP_LOAD = 61, SPIRV_OP_STORE = 62, SPIRV_OP_COPY_MEMORY = 63,
+    SPIRV_OP_ACCESS_CHAIN = 65, SPIRV_OP_IN_BOUNDS_ACCESS_CHAIN = 66, SPIRV_OP_ARRAY_LENGTH = 68,
+    SPIRV_OP_DECORATE = 71, SPIRV_OP_MEMBER_DECORATE = 72,
+    SPIRV_OP_VECTOR_EXTRACT_DYNAMIC = 77, SPIRV_OP_VECTOR_INSERT_DYNAMIC = 78, SPIRV_OP_VECTOR_SHUFFLE = 79,
+    SPIRV_OP_COMPOSITE_CONSTRUCT = 80, SPIRV_OP_COMPOSITE_EXTRACT = 81, SPIRV_OP_COMPOSITE_INSERT = 82,
+    SPIRV_OP_COPY_OBJECT = 83, SPIRV_OP_TRANSPOSE = 84, SPIRV_OP_SAMPLED_IMAGE = 86,
+    SPIRV_OP_IMAGE_SAMPLE_IMPLICIT_LOD = 87, SPIRV_OP_IMAGE_SAMPLE_EXPLICIT_LOD = 88, SPIRV_OP_IMAGE_FETCH = 95,
+    SPIRV_OP_IMAGE = 100,
+    SPIRV_OP_CONVERT_F_TO_U = 109, SPIRV_OP_CONVERT_F_TO_S = 110, SPIRV_OP_CONVERT_S_TO_F = 111,
+    SPIRV_OP_CONVERT_U_TO_F = 112, SPIRV_OP_UCONVERT = 113, SPIRV_OP_SCONVERT = 114, SPIRV_OP_FCONVERT = 115,
+    SPIRV_OP_QUANTIZE_TO_F16 = 116, SPIRV_OP_BITCAST = 124,
+    SPIRV_OP_SNEGATE = 126, SPIRV_OP_FNEGATE = 127, SPIRV_OP_IADD = 128, SPIRV_OP_FADD = 129, SPIRV_OP_ISUB = 130,
+    SPIRV_OP_FSUB = 131, SPIRV_OP_IMUL = 132, SPIRV_OP_FMUL = 133, SPIRV_OP_UDIV = 134, SPIRV_OP_SDIV = 135,
+    SPIRV_OP_FDIV = 136, SPIRV_OP_UMOD = 137, SPIRV_OP_SREM = 138, SPIRV_OP_SMOD = 139, SPIRV_OP_FREM = 140,
+    SPIRV_OP_FMOD = 141, SPIRV_OP_VECTOR_TIMES_SCALAR = 142, SPIRV_OP_MATRIX_TIMES_SCALAR = 143,
+    SPIRV_OP_VECTOR_TIMES_MATRIX = 144, SPIRV_OP_MATRIX_TIMES_VECTOR = 145, SPIRV_OP_MATRIX_TIMES_MATRIX = 146,
+    SPIRV_OP_OUTER_PRODUCT = 147, SPIRV_OP_DOT = 148, SPIRV_OP_IADD_CARRY = 149, SPIRV_OP_ISUB_BORROW = 150,
+    SPIRV_OP_UMUL_EXTENDED = 151, SPIRV_OP_SMUL_EXTENDED = 152,
+    SPIRV_OP_ANY = 154, SPIRV_OP_ALL = 155, SPIRV_OP_IS_NAN = 156, SPIRV_OP_IS_INF = 157,
+    SPIRV_OP_LOGICAL_EQUAL = 164, SPIRV_OP_LOGICAL_NOT_EQUAL = 165, SPIRV_OP_LOGICAL_OR = 166,
+    SPIRV_OP_LOGICAL_AND = 167, SPIRV_OP_LOGICAL_NOT = 168, SPIRV_OP_SELECT = 169,
+    SPIRV_OP_IEQUAL = 170, SPIRV_OP_INOT_EQUAL = 171, SPIRV_OP_UGREATER_THAN = 172, SPIRV_OP_SGREATER_THAN = 173,
+    SPIRV_OP_UGREATER_THAN_EQUAL = 174, SPIRV_OP_SGREATER_THAN_EQUAL = 175, SPIRV_OP_ULESS_THAN = 176,
+    SPIRV_OP_SLESS_THAN = 177, SPIRV_OP_ULESS_THAN_EQUAL = 178, SPIRV_OP_SLESS_THAN_EQUAL = 179,
+    SPIRV_OP_FORD_EQUAL = 180, SPIRV_OP_FUNORD_EQUAL = 181, SPIRV_OP_FORD_NOT_EQUAL = 182,
+    SPIRV_OP_FUNORD_NOT_EQUAL = 183, SPIRV_OP_FORD_LESS_THAN = 184, SPIRV_OP_FUNORD_LESS_THAN = 185,
+    SPIRV_OP_FORD_GREATER_THAN = 186, SPIRV_OP_FUNORD_GREATER_THAN = 187, SPIRV_OP_FORD_LESS_THAN_EQUAL = 188,
+    SPIRV_OP_FUNORD_LESS_THAN_EQUAL = 189, SPIRV_OP_FORD_GREATER_THAN_EQUAL = 190,
+    SPIRV_OP_FUNORD_GREATER_THAN_EQUAL = 191,
+    SPIRV_OP_SHIFT_RIGHT_LOGICAL = 194, SPIRV_OP_SHIFT_RIGHT_ARITHMETIC = 195, SPIRV_OP_SHIFT_LEFT_LOGICAL = 196,
+    SPIRV_OP_BITWISE_OR = 197, SPIRV_OP_BITWISE_XOR = 198, SPIRV_OP_BITWISE_AND = 199, SPIRV_OP_NOT = 200,
+    SPIRV_OP_BIT_FIELD_INSERT = 201, SPIRV_OP_BIT_FIELD_S_EXTRACT = 202, SPIRV_OP_BIT_FIELD_U_EXTRACT = 203,
+    SPIRV_OP_BIT_REVERSE = 204, SPIRV_OP_BIT_COUNT = 205, SPIRV_OP_DPDX = 207, SPIRV_OP_DPDY = 208, SPIRV_OP_FWIDTH = 209,
+    SPIRV_OP_DPDX_FINE = 210, SPIRV_OP_DPDY_FINE = 211, SPIRV_OP_FWIDTH_FINE = 212, SPIRV_OP_DPDX_COARSE = 213,
+    SPIRV_OP_DPDY_COARSE = 214, SPIRV_OP_FWIDTH_COARSE = 215,
+    SPIRV_OP_CONTROL_BARRIER = 224, SPIRV_OP_MEMORY_BARRIER = 225, SPIRV_OP_ATOMIC_LOAD = 227,
+    SPIRV_OP_ATOMIC_STORE = 228, SPIRV_OP_ATOMIC_EXCHANGE = 229, SPIRV_OP_ATOMIC_COMPARE_EXCHANGE = 230,
+    SPIRV_OP_ATOMIC_COMPARE_EXCHANGE_WEAK = 231, SPIRV_OP_ATOMIC_IINCREMENT = 232, SPIRV_OP_ATOMIC_IDECREMENT = 233,
+    SPIRV_OP_ATOMIC_IADD = 234, SPIRV_OP_ATOMIC_ISUB = 235, SPIRV_OP_ATOMIC_SMIN = 236, SPIRV_OP_ATOMIC_UMIN = 237,
+    SPIRV_OP_ATOMIC_SMAX = 238, SPIRV_OP_ATOMIC_UMAX = 239, SPIRV_OP_ATOMIC_AND = 240, SPIRV_OP_ATOMIC_OR = 241,
+    SPIRV_OP_ATOMIC_XOR = 242,
+    SPIRV_OP_PHI = 245, SPIRV_OP_LOOP_MERGE = 246, SPIRV_OP_SELECTION_MERGE = 247, SPIRV_OP_LABEL = 248,
+    SPIRV_OP_BRANCH = 249, SPIRV_OP_BRANCH_CONDITIONAL = 250, SPIRV_OP_SWITCH = 251, SPIRV_OP_KILL = 252,
+    SPIRV_OP_RETURN = 253, SPIRV_OP_RETURN_VALUE = 254, SPIRV_OP_UNREACHABLE = 255, SPIRV_OP_NO_LINE = 317,
+    SPIRV_OP_EXECUTION_MODE_ID = 331, SPIRV_OP_COPY_LOGICAL = 400, SPIRV_OP_TERMINATE_INVOCATION = 4416,
+};
+
+enum SpirvDecoration {
+    SPIRV_DECORATION_SPEC_ID = 1, SPIRV_DECORATION_ARRAY_STRIDE = 6, SPIRV_DECORATION_MATRIX_STRIDE = 7,
+    SPIRV_DECORATION_ROW_MAJOR = 4, SPIRV_DECORATION_BUILT_IN = 11, SPIRV_DECORATION_NO_PERSPECTIVE = 13,
+    SPIRV_DECORATION_FLAT = 14, SPIRV_DECORATION_LOCATION = 30,
+    SPIRV_DECORATION_BINDING = 33, SPIRV_DECORATION_DESCRIPTOR_SET = 34, SPIRV_DECORATION_OFFSET = 35,
+};
+
+enum SpirvBuiltIn {
+    SPIRV_BUILT_IN_POSITION = 0, SPIRV_BUILT_IN_FRAG_COORD = 15, SPIRV_BUILT_IN_FRONT_FACING = 17,
+    SPIRV_BUILT_IN_FRAG_DEPTH = 22, SPIRV_BUILT_IN_HELPER_INVOCATION = 23, SPIRV_BUILT_IN_NUM_WORKGROUPS = 24, SPIRV_BUILT_IN_WORKGROUP_SIZE = 25, SPIRV_BUILT_IN_WORKGROUP_ID = 26,
+    SPIRV_BUILT_IN_LOCAL_INVOCATION_ID = 27, SPIRV_BUILT_IN_GLOBAL_INVOCATION_ID = 28,
+    SPIRV_BUILT_IN_LOCAL_INVOCATION_INDEX = 29, SPIRV_BUILT_IN_VERTEX_INDEX = 42, SPIRV_BUILT_IN_INSTANCE_INDEX = 43,
+    SPIRV_BUILT_IN_BASE_VERTEX = 4424, SPIRV_BUILT_IN_BASE_INSTANCE = 4425, SPIRV_BUILT_IN_DRAW_INDEX = 4426,
+    SPIRV_BUILT_IN_NONE = 0xFFFFFFFF,
+};
+
+enum SpirvStorageClass {
+    SPIRV_STORAGE_CLASS_UNIFORM_CONSTANT = 0, SPIRV_STORAGE_CLASS_INPUT = 1, SPIRV_STORAGE_CLASS_UNIFORM = 2,
+    SPIRV_STORAGE_CLASS_OUTPUT = 3, SPIRV_STORAGE_CLASS_WORKGROUP = 4, SPIRV_STORAGE_CLASS_PRIVATE = 6,
+    SPIRV_STORAGE_CLASS_FUNCTION = 7, SPIRV_STORAGE_CLASS_PUSH_CONSTANT = 9, SPIRV_STORAGE_CLASS_STORAGE_BUFFER = 12,
+};
+
+enum SpirvExecutionModel {
+    SPIRV_EXECUTION_MODEL_VERTEX = 0, SPIRV_EXECUTION_MODEL_FRAGMENT = 4, SPIRV_EXECUTION_MODEL_GL_COMPUTE = 5,
+};
+enum SpirvExecutionMode {
+    SPIRV_EXECUTION_MODE_EARLY_FRAGMENT_TESTS = 9, SPIRV_EXECUTION_MODE_LOCAL_SIZE = 17, SPIRV_EXECUTION_MODE_LOCAL_SIZE_ID = 38,
+};
+enum SpirvImageOperands {
+    SPIRV_IMAGE_OPERANDS_BIAS = 0x1, SPIRV_IMAGE_OPERANDS_LOD = 0x2, SPIRV_IMAGE_OPERANDS_GRAD = 0x4,
+    SPIRV_IMAGE_OPERANDS_CONST_OFFSET = 0x8, SPIRV_IMAGE_OPERANDS_OFFSET = 0x10,
+};
+static const uint32_t SPIRV_SCOPE_SUBGROUP = 3;
+static const uint32_t SPIRV_DIM_1D = 0;
+static const uint32_t SPIRV_DIM_2D = 1;
+
+enum GlslStd450 {
+    GLSL_ROUND = 1, GLSL_ROUND_EVEN = 2, GLSL_TRUNC = 3, GLSL_FABS = 4, GLSL_SABS = 5, GLSL_FSIGN = 6,
+    GLSL_SSIGN = 7, GLSL_FLOOR = 8, GLSL_CEIL = 9, GLSL_FRACT = 10, GLSL_RADIANS = 11, GLSL_DEGREES = 12,
+    GLSL_SIN = 13, GLSL_COS = 14, GLSL_TAN = 15, GLSL_ASIN = 16, GLSL_ACOS = 17, GLSL_ATAN = 18, GLSL_SINH = 19,
+    GLSL_COSH = 20, GLSL_TANH = 21, GLSL_ASINH = 22, GLSL_ACOSH = 23, GLSL_ATANH = 24, GLSL_ATAN2 = 25,
+    GLSL_POW = 26, GLSL_EXP = 27, GLSL_LOG = 28, GLSL_EXP2 = 29, GLSL_LOG2 = 30, GLSL_SQRT = 31,
+    GLSL_INVERSE_SQRT = 32, GLSL_FMIN = 37, GLSL_UMIN = 38, GLSL_SMIN = 39, GLSL_FMAX = 40, GLSL_UMAX = 41,
+    GLSL_SMAX = 42, GLSL_FCLAMP = 43, GLSL_UCLAMP = 44, GLSL_SCLAMP = 45, GLSL_FMIX = 46, GLSL_STEP = 48,
+    GLSL_SMOOTH_STEP = 49, GLSL_FMA = 50, GLSL_LENGTH = 66, GLSL_DISTANCE = 67, GLSL_CROSS = 68,
+    GLSL_NORMALIZE = 69, GLSL_FACE_FORWARD = 70, GLSL_REFLECT = 71, GLSL_FIND_ILSB = 73, GLSL_FIND_SMSB = 74,
+    GLSL_FIND_UMSB = 75, GLSL_NMIN = 79, GLSL_NMAX = 80, GLSL_NCLAMP = 81,
+};
+
+// Memory regions pointers address: nothing, push constants, workgroup variables, then the buffers bound to the
+// program's descriptors and last the variables of each invocation. The regions of image and sampler descriptors hold
+// what loading them gives, indices of the textures they are bound to.
+static const uint32_t SHADER_NULL_REGION = 0;
+static const uint32_t SHADER_PUSH_CONSTANT_REGION = 1;
+static const uint32_t SHADER_WORKGROUP_REGION = 2;
+static const uint32_t SHADER_FIRST_DESCRIPTOR_REGION = 3;
+
+// Set in aux[1] of image instructions on arrayed images, next to their dimensions
+static const uint32_t SHADER_IMAGE_ARRAYED = 0x100;
+
+struct ShaderRegion {
+    char* data;
+    uint64_t size;
+};
+
+struct ShaderType {
+    uint32_t op = 0;           // OpType* declaring the type
+    uint32_t element = 0;      // Component, element, column or pointee type
+    uint32_t length = 0;       // Components of vectors, elements of arrays (0 for runtime arrays), columns of matrices
+    uint32_t components = 0;   // 32-bit components a value of the type flattens to
+    uint32_t size = 0;         // Bytes it takes in memory
+    uint32_t stride = 0;       // Bytes between the elements of arrays and the columns of matrices
+    uint32_t storage_class = 0;  // Of pointers
+    uint32_t dimensions = 0;     // Of images, coordinates addressing a texel of a layer, 0 if not 1D or 2D
+    bool arrayed = false;        // Of images
+    std::vector<uint32_t> members;                // Of structs, with the byte offset and matrix stride of each
+    std::vector<uint32_t> member_offsets;
+    std::vector<uint32_t> member_matrix_strides;  // 0 where the member's type says
+    std::vector<uint32_t> layout;                 // Byte offset of each component in memory, once something accesses it
+};
+
+struct ShaderInstruction {
+    uint16_t op;
+    uint16_t operand_count;  // Words after the result id
+    uint32_t type;           // Result type, 0 if none
+    uint32_t result;         // Result id, 0 if none
+    uint32_t operands;       // Index of the first operand in the program's words
+    uint32_t aux[2];         // Resolved when translating, meaning depends on op
+};
+
+// Block of instructions, its OpPhi first
+struct ShaderBlock {
+    uint32_t begin;
+    uint32_t body;
+    uint32_t end;
+};
+
+struct ShaderFunction {
+    uint32_t first_block;
+    std::vector<uint32_t> parameters;
+};
+
+// Access chains add a constant offset and offsets scaled from indices to their base pointer. The first index into
+// an array of descriptors picks a region instead.
+struct ShaderAccessStep {
+    uint32_t index;  // Id of the index
+    uint32_t stride;
+};
+struct ShaderAccessChain {
+    uint32_t offset;
+    uint32_t first_step;
+    uint32_t step_count;
+    uint32_t region_index;  // Id of the descriptor index, 0 if none
+    uint32_t region_limit;  // Descriptors in the array
+};
+
+// Variables outside buffers, kept in the memory of each invocation
+struct ShaderVariable {
+    uint32_t id;
+    uint32_t storage_class;
+    uint32_t built_in;
+    uint32_t location;
+    uint32_t offset;  // In the invocation's memory
+    uint32_t type;    // Pointee type
+    uint32_t initializer;
+};
+
+// Input or output of a vertex or fragment shader, a location at a time. Built-in members of interface blocks get
+// entries of their own.
+struct ShaderInterface {
+    uint32_t storage_class;
+    uint32_t built_in;
+    uint32_t location;       // UINT32_MAX for built-ins
+    uint32_t offset;         // In the invocation's memory
+    uint32_t size;           // Bytes, at most 16 for locations
+    uint32_t interpolation;  // SPIRV_DECORATION_FLAT or SPIRV_DECORATION_NO_PERSPECTIVE, 0 for perspective
+};
+
+// Buffer or image the program reads through a descriptor, each element of descriptor arrays gets its own region
+struct ShaderDescriptor {
+    uint32_t set;
+    uint32_t binding;
+    uint32_t count;
+    uint32_t region;
+    bool image;  // Images and samplers
+};
+
+struct ShaderProgram {
+    std::vector<uint32_t> words;
+    std::vector<ShaderType> types;  // By id
+    std::vector<uint32_t> value_types;  // Type of every value, by id
+    std::vector<uint32_t> slots;        // Register of each value, by id
+    std::vector<uint32_t> constants;  // Initial value of every register component
+    uint32_t register_count = 0;      // Components
+    uint32_t scratch_count = 0;       // Components of the largest value, or of all the OpPhi of a block
+    std::vector<ShaderInstruction> instructions;
+    uint32_t prologue_end = 0;        // Instructions computing specialization constants come first
+    std::vector<ShaderBlock> blocks;
+    std::vector<ShaderFunction> functions;
+    uint32_t entry_function = 0;
+    std::vector<ShaderAccessChain> access_chains;
+    std::vector<ShaderAccessStep> access_steps;
+    std::vector<ShaderVariable> variables;
+    std::vector<ShaderInterface> interface;
+    std::vector<ShaderDescriptor> descriptors;
+    uint32_t region_count = SHADER_FIRST_DESCRIPTOR_REGION;  // Regions before those of the invocations
+    uint32_t invocation_size = 0;  // Bytes of variables per invocation
+    uint32_t workgroup_size = 0;   // Bytes of workgroup variables
+    uint32_t execution_model = SPIRV_EXECUTION_MODEL_GL_COMPUTE;
+    uint32_t local_size[3] = {1, 1, 1};
+    bool discards = false;              // Fragment shaders that may kill their invocations
+    bool early_fragment_tests = false;  // Fragment shaders that asked for them
+};
+
+inline float ShaderFloat(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+inline uint32_t ShaderBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Translates an entry point of a SPIR-V module, returns null for modules or entry points it cannot handle
+std::unique_ptr<ShaderProgram> TranslateShader(const uint32_t* code, size_t word_count, const char* entry_point,
+                                               uint32_t execution_model, const VkSpecializationInfo* specialization);
+
+typedef uint32_t LaneMask;  // Bit per lane of a lane group
+
+struct ShaderFrame {
+    uint32_t function;
+    uint32_t call;      // Instruction calling the function, UINT32_MAX for the entry point
+    LaneMask lanes;     // Lanes in the function that have not returned
+    LaneMask active;    // Lanes running the current block, none between blocks
+    uint32_t current;   // Current block
+    uint32_t pc;        // Next instruction of the current block
+    uint32_t block[SHADER_LANES];     // Next block of each lane
+    uint32_t previous[SHADER_LANES];  // Block each lane comes from, for OpPhi
+};
+
+struct ShaderLaneGroup {
+    std::vector<uint32_t> registers;  // Component-major, a lane per element
+    std::vector<ShaderFrame> frames;  // Call stack, empty once the invocations finished
+    LaneMask killed = 0;              // Lanes that ran OpKill or OpTerminateInvocation
+};
+
+struct ShaderTexture;  // Resolved from image views, defined with them in mock_icd.cpp
+
+// Runs the invocations of workgroups, or of any other batch of invocations, of one program. Invocations of a batch
+// run in lane groups taking turns, each running until it finishes or reaches a barrier. Fragment shaders run their
+// invocations in quads, lanes 0 to 3 and 4 to 7 each covering 2x2 pixels, for derivatives. Not thread safe, each
+// thread running the program needs its own.
+class ShaderInvocations {
+   public:
+    // regions holds the regions before those of the invocations, textures what image descriptors index
+    ShaderInvocations(const ShaderProgram* program, const std::vector<ShaderRegion>& regions, const ShaderTexture* textures = nullptr,
+                      uint32_t texture_count = 0)
+        : program_(*program), scratch_(program->scratch_count * SHADER_LANES) {
+        workgroup_memory_.resize(program_.workgroup_size);
+        Bind(regions, textures, texture_count);
+    }
+
+    // Binds other descriptors for the invocations Begin starts next
+    void Bind(const std::vector<ShaderRegion>& regions, const ShaderTexture* textures, uint32_t texture_count) {
+        regions_.assign(regions.begin(), regions.begin() + std::min<size_t>(regions.size(), program_.region_count));
+        regions_.resize(program_.region_count, ShaderRegion{nullptr, 0});
+        regions_[SHADER_WORKGROUP_REGION] = {workgroup_memory_.data(), workgroup_memory_.size()};
+        textures_ = textures;
+        texture_count_ = texture_count;
+    }
+
+    // Starts count invocations, with variables of their own uninitialized unless the program initializes them
+    void Begin(uint32_t count) {
+        const uint32_t group_count = (count + SHADER_LANES - 1) / SHADER_LANES;
+        if (invocation_memory_.size() < (size_t)count * program_.invocation_size) invocation_memory_.resize((size_t)count * program_.invocation_size);
+        regions_.resize(program_.region_count + count);
+        for (uint32_t i = 0; i < count; ++i) {
+            char* memory = invocation_memory_.data() + (size_t)i * program_.invocation_size;
+            regions_[program_.region_count + i] = {memory, program_.invocation_size};
+            for (const auto& variable : program_.variables) {
+                if (!variable.initializer || variable.storage_class == SPIRV_STORAGE_CLASS_FUNCTION) continue;
+                const ShaderType& type = program_.types[variable.type];
+                const uint32_t* value = &program_.constants[program_.slots[variable.initializer]];
+                for (uint32_t c = 0; c < type.components; ++c) memcpy(memory + variable.offset + type.layout[c], &value[c], 4);
+            }
+        }
+        while (groups_.size() < group_count) AddGroup((uint32_t)groups_.size());
+        for (uint32_t g = 0; g < group_count; ++g) {
+            ShaderFrame entry = {};
+            entry.function = program_.entry_function;
+            entry.call = UINT32_MAX;
+            const uint32_t lane_count = std::min(count - g * SHADER_LANES, SHADER_LANES);
+            entry.lanes = (1u << lane_count) - 1;
+            for (uint32_t l = 0; l < SHADER_LANES; ++l) entry.block[l] = program_.functions[entry.function].first_block;
+            groups_[g].frames.assign(1, entry);
+            groups_[g].killed = 0;
+        }
+        group_count_ = group_count;
+    }
+
+    // Memory holding the variables of an invocation, where built-in inputs are written and outputs read
+    char* GetInvocationMemory(uint32_t invocation) { return invocation_memory_.data() + (size_t)invocation * program_.invocation_size; }
+
+    // Runs the invocations started by Begin until they all finish
+    void Run() {
+        for (bool finished = false; !finished;) {
+            finished = true;
+            for (uint32_t g = 0; g < group_count_; ++g) {
+                if (!groups_[g].frames.empty() && !RunGroup(&groups_[g])) finished = false;
+            }
+        }
+    }
+
+    // Whether an invocation that finished ran OpKill or OpTerminateInvocation
+    bool Killed(uint32_t invocation) const { return groups_[invocation / SHADER_LANES].killed >> (invocation % SHADER_LANES) & 1; }
+
+   private:
+    void AddGroup(uint32_t index) {
+        groups_.push_back(ShaderLaneGroup());
+        ShaderLaneGroup& group = groups_.back();
+        group.registers.resize((size_t)program_.register_count * SHADER_LANES);
+        for (uint32_t c = 0; c < program_.register_count; ++c) {
+            for (uint32_t l = 0; l < SHADER_LANES; ++l) group.registers[c * SHADER_LANES + l] = program_.constants[c];
+        }
+        // Pointers to variables of the invocations differ by lane
+        for (const auto& variable : program_.variables) {
+            uint32_t* pointer = &group.registers[program_.slots[variable.id] * SHADER_LANES];
+            for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+                pointer[l] = program_.region_count + index * SHADER_LANES + l;
+                pointer[SHADER_LANES + l] = variable.offset;
+            }
+        }
+        // Specialization constants computed from others
+        registers_ = group.registers.data();
+        SetActive(~0u);
+        for (uint32_t i = 0; i < program_.prologue_end; ++i) Execute(program_.instructions[i], ~0u);
+    }
+
+    uint32_t* Register(uint32_t id) { return registers_ + (size_t)program_.slots[id] * SHADER_LANES; }
+    uint32_t Operand(const ShaderInstruction& instruction, uint32_t index) const { return program_.words[instruction.operands + index]; }
+    uint32_t* OperandRegister(const ShaderInstruction& instruction, uint32_t index) { return Register(Operand(instruction, index)); }
+    // Register of an operand that may be a literal instead, null if it is
+    uint32_t* FindRegister(const ShaderInstruction& instruction, uint32_t index) {
+        if (index >= instruction.operand_count) return nullptr;
+        const uint32_t id = Operand(instruction, index);
+        return id < program_.slots.size() && program_.slots[id] != UINT32_MAX ? Register(id) : nullptr;
+    }
+    uint32_t Components(uint32_t type) const { return program_.types[type].components; }
+
+    void SetActive(LaneMask active) {
+        for (uint32_t l = 0; l < SHADER_LANES; ++l) masks_[l] = (active >> l & 1) ? ~0u : 0;
+    }
+
+    // Writes the values of the active lanes to a register
+    void Commit(uint32_t id, const uint32_t* values, uint32_t components) {
+        uint32_t* target = Register(id);
+        for (uint32_t c = 0; c < components; ++c) {
+            for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+                const uint32_t i = c * SHADER_LANES + l;
+                target[i] = (values[i] & masks_[l]) | (target[i] & ~masks_[l]);
+            }
+        }
+    }
+
+    // Computes every component of every lane of the result from the same components of the operands
+    template <typename Function>
+    void Map(const ShaderInstruction& instruction, const uint32_t* a, Function function) {
+        const uint32_t count = Components(instruction.type) * SHADER_LANES;
+        uint32_t* result = scratch_.data();
+        for (uint32_t i = 0; i < count; ++i) result[i] = function(a[i]);
+        Commit(instruction.result, result, Components(instruction.type));
+    }
+    template <typename Function>
+    void Map(const ShaderInstruction& instruction, const uint32_t* a, const uint32_t* b, Function function) {
+        const uint32_t count = Components(instruction.type) * SHADER_LANES;
+        uint32_t* result = scratch_.data();
+        for (uint32_t i = 0; i < count; ++i) result[i] = function(a[i], b[i]);
+        Commit(instruction.result, result, Components(instruction.type));
+    }
+    template <typename Function>
+    void Map(const ShaderInstruction& instruction, const uint32_t* a, const uint32_t* b, const uint32_t* c, Function function) {
+        const uint32_t count = Components(instruction.type) * SHADER_LANES;
+        uint32_t* result = scratch_.data();
+        for (uint32_t i = 0; i < count; ++i) result[i] = function(a[i], b[i], c[i]);
+        Commit(instruction.result, result, Components(instruction.type));
+    }
+    template <typename Function>
+    void MapFloat(const ShaderInstruction& instruction, const uint32_t* a, Function function) {
+        Map(instruction, a, [&](uint32_t x) { return ShaderBits(function(ShaderFloat(x))); });
+    }
+    template <typename Function>
+    void MapFloat(const ShaderInstruction& instruction, const uint32_t* a, const uint32_t* b, Function function) {
+        Map(instruction, a, b, [&](uint32_t x, uint32_t y) { return ShaderBits(function(ShaderFloat(x), ShaderFloat(y))); });
+    }
+    template <typename Function>
+    void MapFloat(const ShaderInstruction& instruction, const uint32_t* a, const uint32_t* b, const uint32_t* c, Function function) {
+        Map(instruction, a, b, c, [&](uint32_t x, uint32_t y, uint32_t z) {
+            return ShaderBits(function(ShaderFloat(x), ShaderFloat(y), ShaderFloat(z)));
+        });
+    }
+    template <typename Function>
+    void CompareFloat(const ShaderInstruction& instruction, Function function) {
+        Map(instruction, OperandRegister(instruction, 0), OperandRegister(instruction, 1),
+            [&](uint32_t x, uint32_t y) -> uint32_t { return function(ShaderFloat(x), ShaderFloat(y)) ? 1 : 0; });
+    }
+
+    // Returns the host address of size bytes a lane's pointer points at, null if they are not all in its region
+    char* GetAddress(const uint32_t* pointer, uint32_t lane, uint32_t size) const {
+        const uint32_t region = pointer[lane];
+        const uint64_t offset = pointer[SHADER_LANES + lane];
+        if (region >= regions_.size() || offset + size > regions_[region].size) return nullptr;
+        return regions_[region].data + offset;
+    }
+
+    void Load(const uint32_t* pointer, uint32_t pointee, LaneMask active, uint32_t* result) const {
+        const ShaderType& type = program_.types[pointee];
+        for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+            if (!(active >> l & 1)) continue;
+            const char* data = GetAddress(pointer, l, type.size);
+            for (uint32_t c = 0; c < type.components; ++c) {
+                uint32_t value = 0;
+                if (data) memcpy(&value, data + type.layout[c], sizeof(value));
+                result[c * SHADER_LANES + l] = value;
+            }
+        }
+    }
+
+    void Store(const uint32_t* pointer, const uint32_t* value, uint32_t pointee, LaneMask active) {
+        const ShaderType& type = program_.types[pointee];
+        for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+            if (!(active >> l & 1)) continue;
+            char* data = GetAddress(pointer, l, type.size);
+            if (!data) continue;
+            for (uint32_t c = 0; c < type.components; ++c) memcpy(data + type.layout[c], &value[c * SHADER_LANES + l], sizeof(uint32_t));
+        }
+    }
+
+    void AccessChain(const ShaderInstruction& instruction) {
+        const ShaderAccessChain& chain = program_.access_chains[instruction.aux[0]];
+        const uint32_t* base = OperandRegister(instruction, 0);
+        uint64_t offsets[SHADER_LANES];
+        uint32_t* result = scratch_.data();
+        for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+            result[l] = base[l];
+            offsets[l] = (uint64_t)base[SHADER_LANES + l] + chain.offset;
+        }
+        if (chain.region_index) {
+            const uint32_t* index = Register(chain.region_index);
+            for (uint32_t l = 0; l < SHADER_LANES; ++l) result[l] = index[l] < chain.region_limit ? result[l] + index[l] : SHADER_NULL_REGION;
+        }
+        for (uint32_t s = 0; s < chain.step_count; ++s) {
+            const ShaderAccessStep& step = program_.access_steps[chain.first_step + s];
+            const uint32_t* index = Register(step.index);
+            for (uint32_t l = 0; l < SHADER_LANES; ++l) offsets[l] += (uint64_t)index[l] * step.stride;
+        }
+        // Offsets out of range stay out of range
+        for (uint32_t l = 0; l < SHADER_LANES; ++l) result[SHADER_LANES + l] = (uint32_t)std::min<uint64_t>(offsets[l], UINT32_MAX);
+        Commit(instruction.result, result, 2);
+    }
+
+    template <typename Function>
+    void Atomic(const ShaderInstruction& instruction, LaneMask active, Function function) {
+        static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "atomics must be plain words");
+        const uint32_t* pointer = OperandRegister(instruction, 0);
+        uint32_t* result = scratch_.data();
+        for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+            if (!(active >> l & 1)) continue;
+            char* data = GetAddress(pointer, l, sizeof(uint32_t));
+            result[l] = data ? function(reinterpret_cast<std::atomic<uint32_t>*>(data), l) : 0;
+        }
+        if (instruction.result) Commit(instruction.result, result, 1);
+    }
+
+    template <typename Function>
+    static uint32_t AtomicUpdate(std::atomic<uint32_t>* target, Function function) {
+        uint32_t value = target->load();
+        while (!target->compare_exchange_weak(value, function(value))) {
+        }
+        return value;
+    }
+
+    void ExtInst(const ShaderInstruction& instruction);
+    void Derivative(const ShaderInstruction& instruction);
+    void Sample(const ShaderInstruction& instruction, LaneMask active);  // Defined with the textures, in mock_icd.cpp
+    void Execute(const ShaderInstruction& instruction, LaneMask active);
+    bool RunGroup(ShaderLaneGroup* group);
+    void EnterBlock(ShaderFrame* frame);
+
+    const ShaderProgram& program_;
+    std::vector<ShaderRegion> regions_;
+    std::vector<char> workgroup_memory_;
+    std::vector<char> invocation_memory_;
+    std::vector<ShaderLaneGroup> groups_;
+    uint32_t group_count_ = 0;
+    const ShaderTexture* textures_ = nullptr;
+    uint32_t texture_count_ = 0;
+    std::vector<uint32_t> scratch_;
+    uint32_t* registers_ = nullptr;  // Of the lane group running
+    uint32_t masks_[SHADER_LANES];   // All ones for the active lanes
+};
+
+// Compute dispatches run their workgroups on a pool of VK_MOCK_COMPUTE_THREADS threads, by default one per CPU, the
+// thread of the queue executing the dispatch being one of them. The workgroups of a dispatch are split in a range
+// per thread. Each thread takes workgroups from the front of its own range and, once it is empty, steals the back
+// half of the largest range left, so threads that got cheap workgroups help the others finish.
+class ComputePool {
+   public:
+    ~ComputePool();
+
+    uint32_t GetThreadCount() const { return thread_count_; }
+
+    // Calls run(thread, item) for every item below count, thread telling which of the pool's threads runs it
+    void Run(uint64_t count, const std::function<void(uint32_t, uint64_t)>& run);
+
+   private:
+    struct Range {
+        std::mutex lock;
+        uint64_t begin = 0;
+        uint64_t end = 0;
+    };
+
+    static uint32_t GetDefaultThreadCount();
+    void Worker(uint32_t thread);
+    void Work(uint32_t thread);
+    bool Take(uint32_t thread, uint64_t* item);
+
+    const uint32_t thread_count_ = GetDefaultThreadCount();
+    std::unique_ptr<Range[]> ranges_{new Range[thread_count_]};
+    std::mutex run_lock_;  // Dispatches from several queues take turns
+    std::mutex lock_;      // Guards everything below
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::vector<std::thread> threads_;
+    const std::function<void(uint32_t, uint64_t)>* run_ = nullptr;
+    uint64_t generation_ = 0;
+    uint32_t busy_ = 0;
+    bool stopping_ = false;
+};
+
+// Shared by compute dispatches and rasterized draws
+extern ComputePool compute_pool;
+
+// Runs workgroups of a compute program on the threads of the pool, with the regions and textures its descriptors are
+// bound to
+void RunWorkgroups(const ShaderProgram& program, const std::vector<ShaderRegion>& regions, const ShaderTexture* textures,
+                   uint32_t texture_count, const uint32_t base[3], const uint32_t group_count[3]);
+
+}  // namespace vkmock
+
+#endif  // MOCK_ICD_SHADER_H
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MOCK_ICD_STATS_H
+#define MOCK_ICD_STATS_H
+
+#include <stdint.h>
+
+// Layout of the live statistics the mock ICD shares when VK_MOCK_STATS names a shared memory object, written by the
+// mock and read by vulkaninfo --watch-mock. The segment starts with a StatsHeader, followed at names_offset by the
+// entrypoint names and then the object type names, NUL terminated, and at slots_offset by slot_count slots of
+// counter_count 64-bit counters each. A counter's total is the sum over the slots.
+//
+// The counters of a slot are the calls of each entrypoint, the objects created of each object type, the objects
+// destroyed of each object type, the bytes allocated from each heap and the bytes freed to each heap, followed by the
+// StatsTrailingCounter ones. Counters are only ever added at the end, so readers check counter_count before reading
+// those that came later.
+namespace vkmock {
+
+static const char STATS_MAGIC[8] = {'V', 'K', 'M', 'O', 'C', 'K', 'S', 'T'};
+static const uint32_t STATS_VERSION = 1;
+
+struct StatsHeader {
+    char magic[8];  // Written last, once the rest of the segment is in place
+    uint32_t version;
+    uint32_t process_id;
+    uint32_t entrypoint_count;
+    uint32_t object_type_count;
+    uint32_t heap_count;
+    uint32_t slot_count;
+    uint32_t counter_count;
+    uint64_t names_offset;
+    uint64_t slots_offset;
+};
+static_assert(sizeof(StatsHeader) == 56, "StatsHeader is read by other processes and must keep its layout");
+
+// Counters following the per heap ones, relative to the first of them
+enum StatsTrailingCounter : uint32_t {
+    STATS_TRAILING_MEMORY_MAPPED = 0,  // Bytes
+    STATS_TRAILING_MEMORY_UNMAPPED,
+    STATS_TRAILING_DESCRIPTOR_POOLS_EXHAUSTED,   // vkAllocateDescriptorSets calls failing with VK_ERROR_OUT_OF_POOL_MEMORY
+    STATS_TRAILING_DESCRIPTOR_POOLS_FRAGMENTED,  // and with VK_ERROR_FRAGMENTED_POOL
+    STATS_TRAILING_COUNTER_COUNT
+};
+
+// Index in a slot of the first StatsTrailingCounter
+inline uint64_t GetStatsTrailingCounterIndex(const StatsHeader& header) {
+    return header.entrypoint_count + 2 * (uint64_t)header.object_type_count + 2 * (uint64_t)header.heap_count;
+}
+
+}  // namespace vkmock
+
+#endif  // MOCK_ICD_STATS_H
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2019 The Khronos Group Inc.
+# Copyright (c) 2019 Valve Corporation
+# Copyright (c) 2019 LunarG, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# Saves the frames an application running on the mock ICD presents to the shared memory ring named by
+# VK_MOCK_PRESENT_SHM as PPM images. The layout of the ring is described with PresentRingHeader in
+# mock_icd_generator.py. Linux only, the ring is read from /dev/shm.
+
+import argparse
+import mmap
+import os
+import struct
+import sys
+import time
+
+RING_MAGIC = b'VKMOCKFR'
+RING_VERSION = 1
+RING_HEADER = struct.Struct('<8sIIQQQQQ')
+SLOT_HEADER = struct.Struct('<QIIIIQ')
+
+# VkFormat values of the swapchain formats with blue in the first channel
+BGRA_FORMATS = (44, 50)  # VK_FORMAT_B8G8R8A8_UNORM, VK_FORMAT_B8G8R8A8_SRGB
+
+def OpenRing(name, timeout):
+    path = '/dev/shm/' + name.lstrip('/')
+    deadline = time.time() + timeout
+    while True:
+        try:
+            with open(path, 'rb') as ring_file:
+                ring = mmap.mmap(ring_file.fileno(), 0, access=mmap.ACCESS_READ)
+            if RING_HEADER.unpack_from(ring, 0)[0] == RING_MAGIC:
+                return ring
+            ring.close()
+        except (OSError, ValueError, struct.error):
+            pass
+        if time.time() >= deadline:
+            sys.exit('No mock ICD frames in %s' % path)
+        time.sleep(0.1)
+
+def ReadFrame(ring, slot_index):
+    # The mock may be rewriting the slot meanwhile, the copy is good if the sequence did not change
+    slot_count, slots_offset, slot_stride = RING_HEADER.unpack_from(ring, 0)[2:5]
+    offset = slots_offset + (slot_index % slot_count) * slot_stride
+    sequence, vk_format, width, height, row_pitch, size = SLOT_HEADER.unpack_from(ring, offset)
+    texels = ring[offset + SLOT_HEADER.size:offset + SLOT_HEADER.size + size]
+    if sequence == 0 or SLOT_HEADER.unpack_from(ring, offset)[0] != sequence:
+        return None
+    return sequence - 1, vk_format, width, height, row_pitch, texels
+
+def WritePpm(path, vk_format, width, height, row_pitch, texels):
+    red, blue = (2, 0) if vk_format in BGRA_FORMATS else (0, 2)
+    rgb = bytearray(width * height * 3)
+    for y in range(height):
+        row = texels[y * row_pitch:y * row_pitch + width * 4]
+        rgb[y * width * 3 + 0:(y + 1) * width * 3:3] = row[red::4]
+        rgb[y * width * 3 + 1:(y + 1) * width * 3:3] = row[1::4]
+        rgb[y * width * 3 + 2:(y + 1) * width * 3:3] = row[blue::4]
+    with open(path, 'wb') as ppm:
+        ppm.write(b'P6\n%d %d\n255\n' % (width, height))
+        ppm.write(rgb)
+
+def main():
+    parser = argparse.ArgumentParser(description='Save frames presented on the mock ICD to a shared memory ring.')
+    parser.add_argument('name', help='shared memory object named by VK_MOCK_PRESENT_SHM')
+    parser.add_argument('--output', default='frame%05d.ppm', help='file name of the frames, %%d is the frame number (default %(default)s)')
+    parser.add_argument('--once', action='store_true', help='save the latest frame and exit')
+    parser.add_argument('--timeout', type=float, default=10.0, help='seconds to wait for the ring to appear (default %(default)s)')
+    args = parser.parse_args()
+    ring = OpenRing(args.name, args.timeout)
+    version = RING_HEADER.unpack_from(ring, 0)[1]
+    if version != RING_VERSION:
+        sys.exit('Unsupported frame ring version %d' % version)
+    slot_count = RING_HEADER.unpack_from(ring, 0)[2]
+    path = '/dev/shm/' + args.name.lstrip('/')
+    saved = 0
+    while True:
+        # The mock unlinks the ring when the application exits, the frames it wrote until then are still read
+        alive = os.path.exists(path)
+        frames = RING_HEADER.unpack_from(ring, 0)[6]
+        # Frames that were overwritten before they could be read are skipped
+        first = frames - 1 if args.once else max(saved, frames - slot_count)
+        for slot_index in range(max(first, 0), frames):
+            frame = ReadFrame(ring, slot_index)
+            if frame:
+                number, vk_format, width, height, row_pitch, texels = frame
+                WritePpm(args.output % number, vk_format, width, height, row_pitch, texels)
+        saved = frames
+        if args.once or not alive:
+            break
+        time.sleep(0.005)
+
+if __name__ == '__main__':
+    main()
@@ -24,42 +24,4136 @@
 #  in its initial state. Rather it's intended to be a starting point that
 #  can be copied and customized to assist in creation of a new layer.
 
-import os,re,sys
+import os,re,sys,collections
 from generator import *
 from common_codegen import *
 
 
+# Perfect hashing of names for the NameTable lookups in HEADER_C_CODE, these must match HashName and MixNameHash
+def NameHash(name):
+    hash = 2166136261
+    for c in bytearray(name.encode()):
+        hash = ((hash ^ c) * 16777619) & 0xffffffff
+    return hash
+
+def MixNameHash(hash):
+    hash ^= hash >> 16
+    hash = (hash * 0x85ebca6b) & 0xffffffff
+    hash ^= hash >> 13
+    hash = (hash * 0xc2b2ae35) & 0xffffffff
+    return hash ^ (hash >> 16)
+
+# Returns the table's slots, each a name or None, and the per-bucket seeds. Buckets are placed largest
+# first, each with the first seed that sends all of its names to free slots.
+def BuildNameTable(names):
+    size = 1
+    while size < len(names):
+        size *= 2
+    hashes = dict((name, NameHash(name)) for name in names)
+    if len(set(hashes.values())) != len(names):
+        raise Exception('Name hash collision, change the hash function')
+    buckets = [[] for i in range(size)]
+    for name in names:
+        buckets[hashes[name] & (size - 1)].append(name)
+    slots = [None] * size
+    seeds = [0] * size
+    for bucket in sorted(range(size), key=lambda b: -len(buckets[b])):
+        if not buckets[bucket]:
+            break
+        for seed in range(65536):
+            positions = [MixNameHash(hashes[name] ^ seed) & (size - 1) for name in buckets[bucket]]
+            if len(set(positions)) == len(positions) and all(slots[pos] is None for pos in positions):
+                break
+        else:
+            raise Exception('No perfect hash seed found for bucket %d' % bucket)
+        seeds[bucket] = seed
+        for name, pos in zip(buckets[bucket], positions):
+            slots[pos] = name
+    return slots, seeds
+
+# Writes a NameTable definition. values maps names to their value expression, protect maps names to
+# the platform define guarding them, if any.
+def NameTableText(type_name, table_name, values, protect = {}):
+    slots, seeds = BuildNameTable(list(values.keys()))
+    lines = ['static const NameTable<%s, %d> %s = {{' % (type_name, len(slots), table_name)]
+    for name in slots:
+        if name is None:
+            lines.append('    {nullptr, 0, 0, %s},' % ('nullptr' if type_name.endswith('*') else '0'))
+            continue
+        entry = '    {"%s", %d, 0x%08xu, %s},' % (name, len(name), NameHash(name), values[name])
+        if protect.get(name):
+            lines += ['#ifdef %s' % protect[name], entry, '#else', '    {nullptr, 0, 0, nullptr},', '#endif']
+        else:
+            lines.append(entry)
+    lines.append('}, {')
+    for i in range(0, len(seeds), 16):
+        lines.append('    ' + ' '.join('%d,' % seed for seed in seeds[i:i + 16]))
+    lines.append('}};')
+    return '\n'.join(lines)
+
+# Bytes per block of the block-compressed format families, by the first part of the format name
+COMPRESSED_BLOCK_SIZES = {'BC1': 8, 'BC2': 16, 'BC3': 16, 'BC4': 8, 'BC5': 16, 'BC6H': 16, 'BC7': 16,
+                          'ASTC': 16, 'PVRTC1': 8, 'PVRTC2': 8}
+# Chroma width and height divisors of the subsampled formats
+CHROMA_SUBSAMPLING = {'420': (2, 2), '422': (2, 1), '444': (1, 1)}
+
+# Texel block layout of a format as (block size, block extent, planes), where each plane is
+# (block size, width divisor, height divisor). The registry does not describe formats, but their names
+# spell out the components, packing, planes and compression. Returns None for names that do not.
+def FormatBlockLayout(format_name):
+    parts = format_name[len('VK_FORMAT_'):].split('_')
+    if 'BLOCK' in parts:
+        family = parts[0]
+        if family == 'ETC2':
+            block_size = 16 if parts[1] == 'R8G8B8A8' else 8
+        elif family == 'EAC':
+            block_size = 8 if parts[1] == 'R11' else 16
+        elif family in COMPRESSED_BLOCK_SIZES:
+            block_size = COMPRESSED_BLOCK_SIZES[family]
+        else:
+            return None
+        if family == 'ASTC':
+            extent = tuple(int(n) for n in parts[1].split('x')) + (1,)
+        elif family.startswith('PVRTC'):
+            extent = (8 if parts[1] == '2BPP' else 4, 4, 1)
+        else:
+            extent = (4, 4, 1)
+        return block_size, extent[:3], [(block_size, 1, 1)]
+    components = [part for part in parts if re.match(r'^([RGBADSXE]\d+)+$', part)]
+    component_bytes = [sum(int(n) for n in re.findall(r'\d+', part)) // 8 for part in components]
+    subsampling = [CHROMA_SUBSAMPLING[part] for part in parts if part in CHROMA_SUBSAMPLING]
+    if any(re.match(r'^\dPLANE$', part) for part in parts):
+        width_divisor, height_divisor = subsampling[0]
+        planes = [(size, 1, 1) if i == 0 else (size, width_divisor, height_divisor) for i, size in enumerate(component_bytes)]
+        return sum(component_bytes), (1, 1, 1), planes
+    packing = [re.match(r'^(\d*)PACK(\d+)$', part) for part in parts]
+    packing = [match for match in packing if match]
+    block_size = int(packing[0].group(1) or 1) * int(packing[0].group(2)) // 8 if packing else sum(component_bytes)
+    if block_size == 0:
+        return None
+    # Non-planar 4:2:2 formats pack two texels into each block
+    extent = (2, 1, 1) if subsampling else (1, 1, 1)
+    return block_size, extent, [(block_size, 1, 1)]
+
+FORMAT_CHANNELS = {'R': 'FORMAT_CHANNEL_R', 'G': 'FORMAT_CHANNEL_G', 'B': 'FORMAT_CHANNEL_B', 'A': 'FORMAT_CHANNEL_A',
+                   'D': 'FORMAT_CHANNEL_DEPTH', 'S': 'FORMAT_CHANNEL_STENCIL'}
+FORMAT_NUMERICS = ['UNORM', 'SNORM', 'USCALED', 'SSCALED', 'UINT', 'SINT', 'UFLOAT', 'SFLOAT', 'SRGB']
+
+# Components of an uncompressed single-plane format as (channel, numeric format, bit offset, bits), with
+# X padding left out. Components of packed formats are named from the most significant bit of their
+# word down, the others in memory order. Returns an empty list for formats whose texels the mock does
+# not convert: compressed, subsampled and multi-planar ones, shared exponents and 64-bit components.
+def FormatComponents(format_name):
+    parts = format_name[len('VK_FORMAT_'):].split('_')
+    if 'BLOCK' in parts or any(part in CHROMA_SUBSAMPLING for part in parts):
+        return []
+    packing = [re.match(r'^(\d*)PACK(\d+)$', part) for part in parts]
+    packing = [match for match in packing if match]
+    word_bits = int(packing[0].group(2)) if packing else None
+    named = []
+    pending = []
+    for part in parts:
+        if re.match(r'^([RGBADSXE]\d+)+$', part):
+            pending += [(channel, int(bits)) for channel, bits in re.findall(r'([RGBADSXE])(\d+)', part)]
+        elif part in FORMAT_NUMERICS:
+            named += [(channel, bits, part) for channel, bits in pending]
+            pending = []
+    if not named or pending or any(channel == 'E' or bits > 32 for channel, bits, numeric in named):
+        return []
+    components = []
+    offset = 0
+    word_start = 0
+    for channel, bits, numeric in named:
+        if word_bits:
+            if offset - word_start == word_bits:
+                word_start = offset
+            component_offset = word_start + word_bits - (offset - word_start) - bits
+        else:
+            component_offset = offset
+        offset += bits
+        if channel == 'X':
+            continue
+        if numeric == 'SRGB' and channel == 'A':
+            numeric = 'UNORM'
+        components.append((FORMAT_CHANNELS[channel], 'FORMAT_NUMERIC_' + numeric, component_offset, bits))
+    return components
+
 # Mock header code
 HEADER_C_CODE = '''
 using mutex_t = std::mutex;
 using lock_guard_t = std::lock_guard<mutex_t>;
 using unique_lock_t = std::unique_lock<mutex_t>;
 
-static mutex_t global_lock;
-static uint64_t global_unique_handle = 1;
-static const uint32_t SUPPORTED_LOADER_ICD_INTERFACE_VERSION = 5;
-static uint32_t loader_interface_version = 0;
-static bool negotiate_loader_icd_interface_called = false;
-static void* CreateDispObjHandle() {
-    auto handle = new VK_LOADER_DATA;
-    set_loader_magic_value(handle);
-    return handle;
+static mutex_t global_lock;
+static const uint32_t SUPPORTED_LOADER_ICD_INTERFACE_VERSION = 5;
+static uint32_t loader_interface_version = 0;
+static bool negotiate_loader_icd_interface_called = false;
+
+// Fixed-size object allocator. Objects are carved out of chunks and recycled through an intrusive
+// free list; all chunks are released together when the allocator itself is destroyed.
+// Not thread safe, callers provide their own synchronization.
+template <typename T>
+class SlabAllocator {
+   public:
+    SlabAllocator() : free_list_(nullptr) {}
+    ~SlabAllocator() {
+        for (auto chunk : chunks_) delete[] chunk;
+    }
+    T* Allocate() {
+        if (!free_list_) Grow();
+        Block* block = free_list_;
+        free_list_ = block->next;
+        return new (&block->storage) T();
+    }
+    void Free(T* object) {
+        object->~T();
+        Block* block = reinterpret_cast<Block*>(object);
+        block->next = free_list_;
+        free_list_ = block;
+    }
+
+   private:
+    static const size_t BLOCKS_PER_CHUNK = 64;
+    union Block {
+        Block* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+    void Grow() {
+        Block* chunk = new Block[BLOCKS_PER_CHUNK];
+        chunks_.push_back(chunk);
+        for (size_t i = BLOCKS_PER_CHUNK; i > 0; --i) {
+            chunk[i - 1].next = free_list_;
+            free_list_ = &chunk[i - 1];
+        }
+    }
+    Block* free_list_;
+    std::vector<Block*> chunks_;
+};
+
+// Non-dispatchable handles encode where their object lives: the object type in the top 8 bits, the
+// generation of the object's slot in the next 24 and the index of the slot in the table of its type in
+// the low 32. A slot's generation is odd while an object lives in it and goes up when the object is
+// created and destroyed, so the handles of destroyed objects stop resolving even once the slot is reused.
+static const uint32_t HANDLE_TYPE_SHIFT = 56;
+static const uint32_t HANDLE_GENERATION_SHIFT = 32;
+static const uint32_t HANDLE_GENERATION_MASK = 0xFFFFFF;
+
+// Objects without state of their own only have their handles tracked
+struct ObjectState {};
+
+// Dense table of the objects of one handle type, holding their state in slots addressed by their
+// handles. Slots are allocated in chunks that never move, so pointers to objects stay valid until the
+// objects are destroyed. Creating, destroying and looking up objects take no lock: slots no object used
+// yet are reserved with a counter, and slots of destroyed objects are reused from a lock-free free list
+// whose head carries the generation of its top slot, so that a slot that is taken and put back while
+// another thread pops the list changes the head and fails that thread's compare-exchange. The application
+// already has to synchronize destroying an object with its other uses. The objects' state is guarded by
+// whatever guards it for callers.
+template <typename T>
+class ObjectTable {
+   public:
+    explicit ObjectTable(uint32_t type) : type_(type) {}
+    // Creates an object from args and returns its handle, or 0 once the table is full
+    template <typename... Args>
+    uint64_t Create(Args&&... args) {
+        uint32_t index;
+        if (!PopFreeSlot(&index) && !ReserveSlot(&index)) return 0;
+        Slot& slot = GetSlot(index);
+        new (&slot.storage) T(std::forward<Args>(args)...);
+        const uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+        slot.generation.store(generation, std::memory_order_release);
+        return ((uint64_t)type_ << HANDLE_TYPE_SHIFT) | ((uint64_t)generation << HANDLE_GENERATION_SHIFT) | index;
+    }
+    // Returns the object of a handle, null for handles of destroyed objects, other types or VK_NULL_HANDLE
+    template <typename Handle>
+    T* Get(Handle handle) const {
+        const uint64_t value = (uint64_t)handle;
+        const uint32_t index = (uint32_t)value;
+        if ((value >> HANDLE_TYPE_SHIFT) != type_ || index >= SLOT_COUNT) return nullptr;
+        const Page* page = pages_[index / SLOTS_PER_PAGE].load(std::memory_order_acquire);
+        if (!page) return nullptr;
+        const Chunk* chunk = page->chunks[index / CHUNK_SIZE % CHUNKS_PER_PAGE].load(std::memory_order_acquire);
+        if (!chunk) return nullptr;
+        const Slot& slot = chunk->slots[index % CHUNK_SIZE];
+        const uint32_t generation = slot.generation.load(std::memory_order_acquire);
+        if (!(generation & 1) || generation != ((value >> HANDLE_GENERATION_SHIFT) & HANDLE_GENERATION_MASK)) return nullptr;
+        return reinterpret_cast<T*>(const_cast<typename std::aligned_storage<sizeof(T), alignof(T)>::type*>(&slot.storage));
+    }
+    // Destroys the object of a handle, returns false if there is none
+    template <typename Handle>
+    bool Destroy(Handle handle) {
+        T* object = Get(handle);
+        if (!object) return false;
+        const uint32_t index = (uint32_t)(uint64_t)handle;
+        Slot& slot = GetSlot(index);
+        object->~T();
+        const uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+        slot.generation.store(generation, std::memory_order_release);
+        // Slots whose generations ran out are retired, so that no handle is ever handed out twice
+        if (generation < HANDLE_GENERATION_MASK) PushFreeSlot(index, generation);
+        return true;
+    }
+
+   private:
+    // Up to 64M objects of each type. The chunks of slots, and the directory pages that point to them, are
+    // only allocated once objects need them, so a type the application does not create costs a few pointers.
+    static const uint32_t CHUNK_SIZE = 4096;
+    static const uint32_t CHUNKS_PER_PAGE = 128;
+    static const uint32_t PAGE_COUNT = 128;
+    static const uint32_t SLOTS_PER_PAGE = CHUNK_SIZE * CHUNKS_PER_PAGE;
+    static const uint32_t SLOT_COUNT = SLOTS_PER_PAGE * PAGE_COUNT;
+    struct Slot {
+        std::atomic<uint32_t> generation;
+        std::atomic<uint32_t> next_free;  // While on the free list, index + 1 of the slot below it or 0
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+    struct Chunk {
+        Slot slots[CHUNK_SIZE];
+    };
+    struct Page {
+        std::atomic<Chunk*> chunks[CHUNKS_PER_PAGE];
+    };
+    Slot& GetSlot(uint32_t index) const {
+        Page* page = pages_[index / SLOTS_PER_PAGE].load(std::memory_order_acquire);
+        return page->chunks[index / CHUNK_SIZE % CHUNKS_PER_PAGE].load(std::memory_order_acquire)->slots[index % CHUNK_SIZE];
+    }
+    // Stores a page or chunk unless another thread stored one first, and returns the one stored. Both are
+    // value initialized, which leaves every pointer null and every generation 0.
+    template <typename U>
+    static U* Publish(std::atomic<U*>& pointer) {
+        U* stored = pointer.load(std::memory_order_acquire);
+        if (stored) return stored;
+        U* created = new U();
+        if (pointer.compare_exchange_strong(stored, created, std::memory_order_acq_rel, std::memory_order_acquire)) return created;
+        delete created;
+        return stored;
+    }
+    // Takes a slot no object used yet
+    bool ReserveSlot(uint32_t* index) {
+        uint32_t count = slot_count_.load(std::memory_order_relaxed);
+        do {
+            if (count == SLOT_COUNT) return false;
+        } while (!slot_count_.compare_exchange_weak(count, count + 1, std::memory_order_relaxed));
+        Page* page = Publish(pages_[count / SLOTS_PER_PAGE]);
+        Publish(page->chunks[count / CHUNK_SIZE % CHUNKS_PER_PAGE]);
+        *index = count;
+        return true;
+    }
+    // The free list's head holds index + 1 of its top slot, 0 when empty, and that slot's generation in the high bits
+    bool PopFreeSlot(uint32_t* index) {
+        uint64_t head = free_head_.load(std::memory_order_acquire);
+        while ((uint32_t)head) {
+            const uint32_t top = (uint32_t)head - 1;
+            const uint32_t next = GetSlot(top).next_free.load(std::memory_order_relaxed);
+            const uint64_t next_head = next ? ((uint64_t)GetSlot(next - 1).generation.load(std::memory_order_relaxed) << 32) | next : 0;
+            if (free_head_.compare_exchange_weak(head, next_head, std::memory_order_acquire, std::memory_order_acquire)) {
+                *index = top;
+                return true;
+            }
+        }
+        return false;
+    }
+    void PushFreeSlot(uint32_t index, uint32_t generation) {
+        Slot& slot = GetSlot(index);
+        const uint64_t new_head = ((uint64_t)generation << 32) | (index + 1);
+        uint64_t head = free_head_.load(std::memory_order_relaxed);
+        do {
+            slot.next_free.store((uint32_t)head, std::memory_order_relaxed);
+        } while (!free_head_.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
+    }
+    const uint32_t type_;
+    std::atomic<uint32_t> slot_count_{0};
+    std::atomic<uint64_t> free_head_{0};
+    // Never released, threads may still use objects while the process exits. Null from static initialization.
+    std::atomic<Page*> pages_[PAGE_COUNT];
+};
+
+// Instances, physical devices, devices and queues share one slab with its own lock so that
+// creating them never contends with global_lock
+static mutex_t disp_obj_lock;
+static SlabAllocator<VK_LOADER_DATA> disp_obj_slab;
+static void* CreateDispObjHandle() {
+    lock_guard_t lock(disp_obj_lock);
+    auto handle = disp_obj_slab.Allocate();
+    set_loader_magic_value(handle);
+    return handle;
+}
+static void DestroyDispObjHandle(void* handle) {
+    lock_guard_t lock(disp_obj_lock);
+    disp_obj_slab.Free(reinterpret_cast<VK_LOADER_DATA*>(handle));
+}
+
+// Entrypoint and extension names are looked up in perfect hash tables built by the generator. A
+// name's FNV-1a hash selects a bucket, whose seed scrambles the hash into the one slot that name can
+// occupy. The slot's length and hash reject nearly every other string before the names are compared.
+static inline uint32_t HashName(const char* name, uint32_t* length) {
+    uint32_t hash = 2166136261u;
+    const char* c = name;
+    for (; *c; ++c) hash = (hash ^ (uint8_t)*c) * 16777619u;
+    *length = (uint32_t)(c - name);
+    return hash;
+}
+
+static inline uint32_t MixNameHash(uint32_t hash) {
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    return hash ^ (hash >> 16);
+}
+
+template <typename T>
+struct NameTableEntry {
+    const char* name;  // Null for unused slots
+    uint32_t length;
+    uint32_t hash;
+    T value;
+};
+
+template <typename T, size_t SIZE>
+struct NameTable {
+    static_assert((SIZE & (SIZE - 1)) == 0, "NameTable size must be a power of two");
+    NameTableEntry<T> entries[SIZE];
+    uint16_t seeds[SIZE];
+    const T* Find(const char* name) const {
+        if (!name) return nullptr;
+        uint32_t length;
+        const uint32_t hash = HashName(name, &length);
+        const NameTableEntry<T>& entry = entries[MixNameHash(hash ^ seeds[hash & (SIZE - 1)]) & (SIZE - 1)];
+        if (entry.hash != hash || entry.length != length || !entry.name || memcmp(entry.name, name, length) != 0) return nullptr;
+        return &entry.value;
+    }
+};
+
+// Members of Vulkan structures that device profiles can set. The tables of them are generated from the registry.
+enum ProfileFieldType { PROFILE_FIELD_UINT32, PROFILE_FIELD_INT32, PROFILE_FIELD_UINT64, PROFILE_FIELD_SIZE, PROFILE_FIELD_FLOAT };
+struct ProfileField {
+    const char* name;
+    size_t offset;
+    ProfileFieldType type;
+    uint32_t count;  // Number of elements of array members
+};
+
+// Texel block layout of a format. The table of them is generated from the format names in the registry.
+static const uint32_t MAX_FORMAT_PLANES = 3;
+struct FormatPlane {
+    uint32_t block_size;
+    uint32_t width_divisor;  // Chroma planes of subsampled formats are smaller than the image
+    uint32_t height_divisor;
+};
+// Components of the formats whose texels clears, blits and resolves convert, at bit offsets within the block.
+// Packed formats count bits from the least significant one of their little-endian words.
+static const uint32_t MAX_FORMAT_COMPONENTS = 4;
+enum FormatChannel { FORMAT_CHANNEL_R, FORMAT_CHANNEL_G, FORMAT_CHANNEL_B, FORMAT_CHANNEL_A, FORMAT_CHANNEL_DEPTH, FORMAT_CHANNEL_STENCIL };
+enum FormatNumeric {
+    FORMAT_NUMERIC_UNORM,
+    FORMAT_NUMERIC_SNORM,
+    FORMAT_NUMERIC_USCALED,
+    FORMAT_NUMERIC_SSCALED,
+    FORMAT_NUMERIC_UINT,
+    FORMAT_NUMERIC_SINT,
+    FORMAT_NUMERIC_UFLOAT,
+    FORMAT_NUMERIC_SFLOAT,
+    FORMAT_NUMERIC_SRGB
+};
+struct FormatComponent {
+    FormatChannel channel;
+    FormatNumeric numeric;
+    uint32_t offset;
+    uint32_t bits;
+};
+struct FormatInfo {
+    VkFormat format;
+    uint32_t block_size;  // Summed over the planes of multi-planar formats
+    VkExtent3D block_extent;
+    uint32_t plane_count;
+    FormatPlane planes[MAX_FORMAT_PLANES];
+    uint32_t component_count;  // 0 for compressed, subsampled and multi-planar formats, and others not converted
+    FormatComponent components[MAX_FORMAT_COMPONENTS];
+};
+'''
+
+# Manual code at the top of the cpp source file
+SOURCE_CPP_PREFIX = '''
+// Backing store for device memory. Small allocations are carved out of per size class arenas and
+// recycled through free lists, large ones get their own reserved but uncommitted mapping so that
+// the advertised heaps can be used without consuming RAM until pages are actually written.
+static const VkDeviceSize MIN_MEMORY_SIZE_CLASS = 256;
+static const VkDeviceSize LARGE_MEMORY_ALLOCATION_SIZE = 256 * 1024;
+static const size_t MEMORY_ARENA_BLOCK_SIZE = 4 * 1024 * 1024;
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+static const size_t MEMORY_MAP_ALIGNMENT = 64;
+static const uint32_t MEMORY_SIZE_CLASS_COUNT = 11;  // MIN_MEMORY_SIZE_CLASS up to LARGE_MEMORY_ALLOCATION_SIZE
+static const uint32_t LARGE_MEMORY_SIZE_CLASS = UINT32_MAX;
+
+struct DeviceMemory {
+    void* data;
+    VkDeviceSize size;  // Size of the backing store, at least the requested allocation size
+    uint32_t size_class;
+    int fd;  // memfd backing exportable or imported memory, -1 otherwise
+    VkDeviceSize allocation_size;
+    uint32_t heap_index;
+    uint32_t physical_device_mask;  // Of the physical devices the memory takes heap space on
+    VkDeviceSize mapped_size;  // Size of the current mapping, 0 when unmapped
+};
+static ObjectTable<DeviceMemory> device_memory_table(STATS_OBJECT_VkDeviceMemory);
+
+static void* AllocateBackingPages(size_t size) {
+#if defined(__linux__) || defined(__APPLE__)
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (data == MAP_FAILED) return nullptr;
+#if defined(MADV_HUGEPAGE)
+    if (size >= HUGE_PAGE_SIZE) madvise(data, size, MADV_HUGEPAGE);
+#endif
+    return data;
+#else
+    // Keep the original pointer right in front of the aligned block so it can be released
+    char* base = static_cast<char*>(malloc(size + MEMORY_MAP_ALIGNMENT));
+    if (!base) return nullptr;
+    char* data = base + MEMORY_MAP_ALIGNMENT - (reinterpret_cast<uintptr_t>(base) & (MEMORY_MAP_ALIGNMENT - 1));
+    reinterpret_cast<char**>(data)[-1] = base;
+    return data;
+#endif
+}
+
+static void ReleaseBackingPages(void* data, size_t size) {
+#if defined(__linux__) || defined(__APPLE__)
+    munmap(data, size);
+#else
+    free(reinterpret_cast<char**>(data)[-1]);
+#endif
+}
+
+static mutex_t memory_arena_lock;
+static std::vector<void*> memory_arena_free_lists[MEMORY_SIZE_CLASS_COUNT];
+static char* memory_arena_cursors[MEMORY_SIZE_CLASS_COUNT];
+static char* memory_arena_ends[MEMORY_SIZE_CLASS_COUNT];
+
+static uint32_t GetMemorySizeClass(VkDeviceSize size) {
+    if (size > LARGE_MEMORY_ALLOCATION_SIZE) return LARGE_MEMORY_SIZE_CLASS;
+    uint32_t size_class = 0;
+    while ((MIN_MEMORY_SIZE_CLASS << size_class) < size) ++size_class;
+    return size_class;
+}
+
+static bool AllocateDeviceMemoryBacking(VkDeviceSize size, DeviceMemory* memory) {
+    memory->fd = -1;
+    memory->size_class = GetMemorySizeClass(size);
+    if (memory->size_class == LARGE_MEMORY_SIZE_CLASS) {
+        memory->size = size;
+        memory->data = AllocateBackingPages((size_t)size);
+        return memory->data != nullptr;
+    }
+    const size_t class_size = (size_t)(MIN_MEMORY_SIZE_CLASS << memory->size_class);
+    memory->size = class_size;
+    lock_guard_t lock(memory_arena_lock);
+    auto& free_list = memory_arena_free_lists[memory->size_class];
+    if (!free_list.empty()) {
+        memory->data = free_list.back();
+        free_list.pop_back();
+        return true;
+    }
+    // Each size class carves from its own block, which keeps every allocation aligned to its class size
+    char*& cursor = memory_arena_cursors[memory->size_class];
+    if (cursor == memory_arena_ends[memory->size_class]) {
+        // A failed block leaves the class as it was, to try again on the next allocation
+        char* block = static_cast<char*>(AllocateBackingPages(MEMORY_ARENA_BLOCK_SIZE));
+        if (!block) return false;
+        cursor = block;
+        memory_arena_ends[memory->size_class] = block + MEMORY_ARENA_BLOCK_SIZE;
+    }
+    memory->data = cursor;
+    cursor += class_size;
+    return true;
+}
+
+static void FreeDeviceMemoryBacking(const DeviceMemory& memory) {
+    if (memory.size_class == LARGE_MEMORY_SIZE_CLASS) {
+        ReleaseBackingPages(memory.data, (size_t)memory.size);
+#if defined(__linux__)
+        if (memory.fd >= 0) close(memory.fd);
+#endif
+        return;
+    }
+    lock_guard_t lock(memory_arena_lock);
+    memory_arena_free_lists[memory.size_class].push_back(memory.data);
+}
+
+// Memory that may be exported as an opaque fd lives in a memfd mapped shared, so every process that
+// imports the fd maps the very same pages and sees writes without any copies
+static bool MapDeviceMemoryFd(int fd, VkDeviceSize size, DeviceMemory* memory) {
+#if defined(__linux__)
+    void* data = mmap(nullptr, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) return false;
+    memory->data = data;
+    memory->size = size;
+    memory->size_class = LARGE_MEMORY_SIZE_CLASS;
+    memory->fd = fd;
+    return true;
+#else
+    return false;
+#endif
+}
+
+static bool AllocateDeviceMemoryFd(VkDeviceSize size, DeviceMemory* memory) {
+#if defined(__linux__) && defined(SYS_memfd_create)
+    const unsigned int memfd_cloexec = 0x1U;  // MFD_CLOEXEC
+    int fd = (int)syscall(SYS_memfd_create, "mock_icd_device_memory", memfd_cloexec);
+    if (fd < 0) return false;
+    if (ftruncate(fd, (off_t)size) != 0 || !MapDeviceMemoryFd(fd, size, memory)) {
+        close(fd);
+        return false;
+    }
+    return true;
+#else
+    return AllocateDeviceMemoryBacking(size, memory);
+#endif
+}
+
+static bool ImportDeviceMemoryFd(int fd, VkDeviceSize size, DeviceMemory* memory) {
+#if defined(__linux__)
+    struct stat fd_stat;
+    if (fstat(fd, &fd_stat) != 0 || (VkDeviceSize)fd_stat.st_size < size) return false;
+#endif
+    return MapDeviceMemoryFd(fd, size, memory);
+}
+
+// Physical devices, VK_MOCK_PHYSICAL_DEVICES of them (default 1), all reporting the device profile. With
+// VK_MOCK_DEVICE_GROUP set to something other than 0 they form one device group, otherwise each is a group of its own.
+// Created by the first vkEnumeratePhysicalDevices or vkEnumeratePhysicalDeviceGroups and destroyed with the instance.
+static const uint32_t MAX_PHYSICAL_DEVICES = 8;
+struct PhysicalDevice {
+    VK_LOADER_DATA loader_data;  // Must come first, the VkPhysicalDevice handle points at it
+    uint32_t index;              // In physical_devices
+    std::atomic<VkDeviceSize> heap_usage[VK_MAX_MEMORY_HEAPS];  // Bytes allocated from each heap
+};
+static PhysicalDevice* physical_devices[MAX_PHYSICAL_DEVICES];
+static uint32_t physical_device_count = 0;
+static bool physical_device_group = false;
+
+static void InitPhysicalDevices() {
+    lock_guard_t lock(global_lock);
+    if (physical_device_count) return;
+    const char* count = getenv("VK_MOCK_PHYSICAL_DEVICES");
+    physical_device_count = count ? std::min(std::max((uint32_t)strtoul(count, nullptr, 10), 1u), MAX_PHYSICAL_DEVICES) : 1;
+    physical_device_group = getenv("VK_MOCK_DEVICE_GROUP") && strcmp(getenv("VK_MOCK_DEVICE_GROUP"), "0") != 0;
+    for (uint32_t i = 0; i < physical_device_count; ++i) {
+        physical_devices[i] = new PhysicalDevice();
+        set_loader_magic_value(&physical_devices[i]->loader_data);
+        physical_devices[i]->index = i;
+    }
+}
+
+// Fences and semaphores are signalled by the queue workers and waited on by the host and by the queues of the device
+// they belong to. Every signal bumps the device's epoch, waiters sleep on it (a futex on Linux) and then re-check
+// whatever they are waiting for, so signals on one device never wake the waiters of another.
+struct SyncEpoch {
+    std::atomic<uint32_t> epoch{0};
+    std::atomic<uint32_t> waiters{0};
+#if !defined(__linux__)
+    mutex_t lock;
+    std::condition_variable cv;
+#endif
+};
+
+// Devices only lock their own objects, so threads using different devices never contend. Queues are created the
+// first time they are retrieved, and kept by family and index.
+struct Device {
+    VK_LOADER_DATA loader_data;  // Must come first, the VkDevice handle points at it
+    std::vector<PhysicalDevice*> physical_devices;  // By device index, more than one for devices of a device group
+    mutex_t lock;  // Guards queues
+    std::vector<std::vector<VkQueue>> queues;
+    mutex_t descriptor_lock;  // Guards the descriptor pools and sets
+    mutex_t sync_lock;        // Guards the submitted counters of the semaphores, and the swapchains
+    SyncEpoch sync;
+    std::atomic<uint64_t> pending_submissions{0};  // Enqueued on the queues and not finished executing
+};
+
+// Memory bound to a buffer or image. Queue workers look the memory up when they execute transfers, so
+// commands using memory freed since the binding are skipped rather than touching freed pages.
+struct MemoryBinding {
+    VkDeviceMemory memory;
+    VkDeviceSize offset;
+};
+
+struct Buffer {
+    VkBufferCreateInfo create_info;  // pNext is not kept
+    MemoryBinding binding;
+};
+static ObjectTable<Buffer> buffer_table(STATS_OBJECT_VkBuffer);
+
+// Descriptor types are counted in arrays indexed by GetDescriptorTypeIndex
+static const uint32_t DESCRIPTOR_TYPE_COUNT = VK_DESCRIPTOR_TYPE_RANGE_SIZE + 2;
+
+// DESCRIPTOR_TYPE_COUNT for types the mock does not know
+static uint32_t GetDescriptorTypeIndex(VkDescriptorType type) {
+    if (type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) return VK_DESCRIPTOR_TYPE_RANGE_SIZE;
+    if (type == VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_NV) return VK_DESCRIPTOR_TYPE_RANGE_SIZE + 1;
+    return (uint32_t)type < VK_DESCRIPTOR_TYPE_RANGE_SIZE ? (uint32_t)type : DESCRIPTOR_TYPE_COUNT;
+}
+
+static bool IsBufferDescriptor(VkDescriptorType type) {
+    return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+           type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+}
+
+static bool IsDynamicBufferDescriptor(VkDescriptorType type) {
+    return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+}
+
+static bool IsTexelBufferDescriptor(VkDescriptorType type) {
+    return type == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+}
+
+// Descriptors shaders sample through
+static bool IsImageDescriptor(VkDescriptorType type) {
+    return type == VK_DESCRIPTOR_TYPE_SAMPLER || type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER || type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+}
+
+// A descriptor written to a set, held in the member the type of its binding uses
+union Descriptor {
+    VkDescriptorBufferInfo buffer;  // Uniform and storage buffers
+    VkDescriptorImageInfo image;    // Samplers, images and input attachments
+    VkBufferView texel_buffer;      // Uniform and storage texel buffers
+};
+
+// A set holds the descriptors of all the bindings of its layout in one array, each binding's from its first, in
+// binding order. Inline uniform blocks count bytes, which are not kept, so they take no descriptors.
+struct DescriptorLayoutBinding {
+    VkDescriptorType type;
+    uint32_t count;    // 0 for binding numbers the layout does not use
+    uint32_t first;    // Index of the binding's first descriptor in a set's
+    uint32_t dynamic;  // Index of the binding's first dynamic offset, for dynamic buffers
+    std::vector<VkSampler> immutable_samplers;  // Empty without
+};
+struct DescriptorTypeCount {
+    uint32_t index;  // GetDescriptorTypeIndex of the type
+    uint32_t count;
+};
+// Sets share the layout they were allocated with, which outlives its handle as long as they do
+struct DescriptorSetLayout {
+    std::vector<DescriptorLayoutBinding> bindings;  // By binding number
+    std::vector<DescriptorTypeCount> type_counts;   // Descriptors of each type the layout uses a set takes from its pool
+    uint32_t descriptor_count = 0;                  // Size of a set's array
+    uint32_t dynamic_count = 0;                     // Dynamic offsets binding a set takes
+    bool variable_count = false;  // The last binding's count is given when sets are allocated, up to the count above
+};
+static ObjectTable<std::shared_ptr<const DescriptorSetLayout>> descriptor_set_layout_table(STATS_OBJECT_VkDescriptorSetLayout);
+
+// Descriptor pools keep the descriptors of their sets in one array, with room for all their pool sizes. Each set
+// takes a range of it: one a freed set of the same size left, else the next one no set has used. Sets or descriptors
+// of a type beyond what the pool was created with fail with VK_ERROR_OUT_OF_POOL_MEMORY, and like a driver's, a pool
+// whose sets are freed and allocated with layouts of different sizes can fail with VK_ERROR_FRAGMENTED_POOL with
+// descriptors to spare. Guarded by the descriptor_lock of their device.
+struct DescriptorPool {
+    uint32_t max_sets = 0;
+    uint32_t capacity[DESCRIPTOR_TYPE_COUNT] = {};   // Descriptors of each type, from the pool sizes
+    uint32_t allocated[DESCRIPTOR_TYPE_COUNT] = {};  // Taken by the pool's sets
+    std::unique_ptr<Descriptor[]> descriptors;      // Left uninitialized until sets take them
+    uint32_t descriptor_count = 0;
+    uint32_t next_descriptor = 0;  // First of the descriptors no set has used
+    std::map<uint32_t, std::vector<uint32_t>> free_ranges;  // First descriptors of the ranges freed sets left, by size
+    std::vector<VkDescriptorSet> sets;  // Destroyed along with the pool when it is reset or destroyed
+};
+struct DescriptorSet {
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    size_t pool_index = 0;  // Position in the pool's sets
+    std::shared_ptr<const DescriptorSetLayout> layout;
+    Descriptor* descriptors = nullptr;  // In the pool's array
+    uint32_t first = 0;                 // Index of the set's first descriptor in the pool's array
+    uint32_t descriptor_count = 0;
+    uint32_t variable_count = 0;  // Count of the last binding of layouts with a variable count
+};
+static ObjectTable<DescriptorPool> descriptor_pool_table(STATS_OBJECT_VkDescriptorPool);
+static ObjectTable<DescriptorSet> descriptor_set_table(STATS_OBJECT_VkDescriptorSet);
+
+static std::shared_ptr<const DescriptorSetLayout> CreateDescriptorSetLayoutState(const VkDescriptorSetLayoutCreateInfo& create_info) {
+    std::shared_ptr<DescriptorSetLayout> layout(new DescriptorSetLayout());
+    const auto flags_info = lvl_find_in_chain<VkDescriptorSetLayoutBindingFlagsCreateInfo>(create_info.pNext);
+    uint32_t variable_binding = UINT32_MAX;
+    for (uint32_t i = 0; i < create_info.bindingCount; ++i) {
+        const VkDescriptorSetLayoutBinding& binding = create_info.pBindings[i];
+        if (binding.binding >= layout->bindings.size()) layout->bindings.resize(binding.binding + 1);
+        DescriptorLayoutBinding& entry = layout->bindings[binding.binding];
+        entry.type = binding.descriptorType;
+        entry.count = binding.descriptorCount;
+        if (binding.pImmutableSamplers &&
+            (binding.descriptorType == VK_DESCRIPTOR_TYPE_SAMPLER || binding.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)) {
+            entry.immutable_samplers.assign(binding.pImmutableSamplers, binding.pImmutableSamplers + binding.descriptorCount);
+        }
+        if (flags_info && i < flags_info->bindingCount && (flags_info->pBindingFlags[i] & VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT)) {
+            variable_binding = binding.binding;
+        }
+    }
+    layout->variable_count = variable_binding != UINT32_MAX && variable_binding + 1 == layout->bindings.size();
+    uint32_t type_counts[DESCRIPTOR_TYPE_COUNT] = {};
+    for (auto& binding : layout->bindings) {
+        binding.first = layout->descriptor_count;
+        binding.dynamic = layout->dynamic_count;
+        if (binding.type != VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) layout->descriptor_count += binding.count;
+        if (IsDynamicBufferDescriptor(binding.type)) layout->dynamic_count += binding.count;
+        const uint32_t index = GetDescriptorTypeIndex(binding.type);
+        if (index < DESCRIPTOR_TYPE_COUNT) type_counts[index] += binding.count;
+    }
+    for (uint32_t i = 0; i < DESCRIPTOR_TYPE_COUNT; ++i) {
+        if (type_counts[i]) layout->type_counts.push_back({i, type_counts[i]});
+    }
+    return layout;
+}
+
+static DescriptorPool CreateDescriptorPoolState(const VkDescriptorPoolCreateInfo& create_info) {
+    DescriptorPool pool;
+    pool.max_sets = create_info.maxSets;
+    for (uint32_t i = 0; i < create_info.poolSizeCount; ++i) {
+        const VkDescriptorPoolSize& size = create_info.pPoolSizes[i];
+        const uint32_t index = GetDescriptorTypeIndex(size.type);
+        if (index == DESCRIPTOR_TYPE_COUNT) continue;
+        pool.capacity[index] += size.descriptorCount;
+        if (size.type != VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) pool.descriptor_count += size.descriptorCount;
+    }
+    pool.descriptors.reset(new Descriptor[pool.descriptor_count]);
+    return pool;
+}
+
+static uint32_t GetBindingCount(const DescriptorSet& set, uint32_t binding) {
+    const DescriptorSetLayout& layout = *set.layout;
+    if (layout.variable_count && binding + 1 == layout.bindings.size()) return std::min(set.variable_count, layout.bindings[binding].count);
+    return layout.bindings[binding].count;
+}
+
+// Descriptors of one of the types of its layout a set takes from its pool
+static uint32_t GetDescriptorCount(const DescriptorSet& set, const DescriptorTypeCount& type_count) {
+    const DescriptorSetLayout& layout = *set.layout;
+    if (!layout.variable_count || GetDescriptorTypeIndex(layout.bindings.back().type) != type_count.index) return type_count.count;
+    return type_count.count - (layout.bindings.back().count - GetBindingCount(set, (uint32_t)layout.bindings.size() - 1));
+}
+
+// The following helpers must be called with the descriptor_lock of the device held
+
+// Takes the descriptors of a set with its layout and variable count from the pool, and clears them
+static VkResult AllocateDescriptors(DescriptorPool* pool, DescriptorSet* set) {
+    if (pool->sets.size() >= pool->max_sets) return VK_ERROR_OUT_OF_POOL_MEMORY;
+    const DescriptorSetLayout& layout = *set->layout;
+    for (const auto& type_count : layout.type_counts) {
+        if (GetDescriptorCount(*set, type_count) > pool->capacity[type_count.index] - pool->allocated[type_count.index]) {
+            return VK_ERROR_OUT_OF_POOL_MEMORY;
+        }
+    }
+    set->descriptor_count = layout.descriptor_count;
+    if (layout.variable_count && layout.bindings.back().type != VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) {
+        set->descriptor_count -= layout.bindings.back().count - GetBindingCount(*set, (uint32_t)layout.bindings.size() - 1);
+    }
+    auto range = pool->free_ranges.find(set->descriptor_count);
+    if (range != pool->free_ranges.end()) {
+        set->first = range->second.back();
+        range->second.pop_back();
+        if (range->second.empty()) pool->free_ranges.erase(range);
+    } else if (set->descriptor_count <= pool->descriptor_count - pool->next_descriptor) {
+        set->first = pool->next_descriptor;
+        pool->next_descriptor += set->descriptor_count;
+    } else {
+        return VK_ERROR_FRAGMENTED_POOL;
+    }
+    for (const auto& type_count : layout.type_counts) pool->allocated[type_count.index] += GetDescriptorCount(*set, type_count);
+    set->descriptors = pool->descriptors.get() + set->first;
+    std::fill(set->descriptors, set->descriptors + set->descriptor_count, Descriptor{});
+    for (uint32_t b = 0; b < layout.bindings.size(); ++b) {
+        const auto& samplers = layout.bindings[b].immutable_samplers;
+        const uint32_t count = std::min((uint32_t)samplers.size(), GetBindingCount(*set, b));
+        for (uint32_t i = 0; i < count; ++i) set->descriptors[layout.bindings[b].first + i].image.sampler = samplers[i];
+    }
+    return VK_SUCCESS;
+}
+
+static void FreeDescriptorSet(VkDescriptorSet descriptor_set) {
+    const DescriptorSet* set = descriptor_set_table.Get(descriptor_set);
+    if (!set) return;
+    if (DescriptorPool* pool = descriptor_pool_table.Get(set->pool)) {
+        for (const auto& type_count : set->layout->type_counts) pool->allocated[type_count.index] -= GetDescriptorCount(*set, type_count);
+        if (set->first + set->descriptor_count == pool->next_descriptor) {
+            pool->next_descriptor = set->first;
+        } else if (set->descriptor_count) {
+            pool->free_ranges[set->descriptor_count].push_back(set->first);
+        }
+        pool->sets[set->pool_index] = pool->sets.back();
+        descriptor_set_table.Get(pool->sets.back())->pool_index = set->pool_index;
+        pool->sets.pop_back();
+        // An empty pool is no longer fragmented
+        if (pool->sets.empty()) {
+            pool->next_descriptor = 0;
+            pool->free_ranges.clear();
+        }
+    }
+    descriptor_set_table.Destroy(descriptor_set);
+}
+
+static void FreeDescriptorPoolSets(DescriptorPool* pool) {
+    for (auto set : pool->sets) descriptor_set_table.Destroy(set);
+    pool->sets.clear();
+    std::fill(pool->allocated, pool->allocated + DESCRIPTOR_TYPE_COUNT, 0);
+    pool->next_descriptor = 0;
+    pool->free_ranges.clear();
+}
+
+// Position of an update in a set. Updates running past the end of a binding continue with the next one.
+struct DescriptorCursor {
+    // Returns the descriptor at the position and moves past it, null once the update runs out of bindings of its type
+    Descriptor* Next(VkDescriptorType type) {
+        const auto& bindings = set->layout->bindings;
+        while (binding < bindings.size() && element >= GetBindingCount(*set, binding)) {
+            element -= GetBindingCount(*set, binding);
+            ++binding;
+        }
+        if (binding >= bindings.size() || bindings[binding].type != type || type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) return nullptr;
+        entry = &bindings[binding];
+        return &set->descriptors[entry->first + element++];
+    }
+    const DescriptorSet* set;
+    uint32_t binding;
+    uint32_t element;
+    const DescriptorLayoutBinding* entry;  // Of the descriptor Next returned last
+};
+
+static void WriteDescriptors(DescriptorSet* set, const VkWriteDescriptorSet& write) {
+    const VkDescriptorType type = write.descriptorType;
+    const bool image = IsImageDescriptor(type) || type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE || type == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    const bool has_info = IsBufferDescriptor(type) ? write.pBufferInfo != nullptr
+                          : IsTexelBufferDescriptor(type) ? write.pTexelBufferView != nullptr
+                          : image && write.pImageInfo != nullptr;
+    if (!has_info) return;
+    DescriptorCursor cursor = {set, write.dstBinding, write.dstArrayElement, nullptr};
+    for (uint32_t i = 0; i < write.descriptorCount; ++i) {
+        Descriptor* descriptor = cursor.Next(type);
+        if (!descriptor) return;
+        if (IsBufferDescriptor(type)) {
+            descriptor->buffer = write.pBufferInfo[i];
+        } else if (IsTexelBufferDescriptor(type)) {
+            descriptor->texel_buffer = write.pTexelBufferView[i];
+        } else {
+            const VkSampler sampler = descriptor->image.sampler;
+            descriptor->image = write.pImageInfo[i];
+            if (!cursor.entry->immutable_samplers.empty()) descriptor->image.sampler = sampler;
+        }
+    }
+}
+
+static void CopyDescriptors(const VkCopyDescriptorSet& copy) {
+    const DescriptorSet* src = descriptor_set_table.Get(copy.srcSet);
+    const DescriptorSet* dst = descriptor_set_table.Get(copy.dstSet);
+    if (!src || !dst || copy.srcBinding >= src->layout->bindings.size()) return;
+    const VkDescriptorType type = src->layout->bindings[copy.srcBinding].type;
+    DescriptorCursor source = {src, copy.srcBinding, copy.srcArrayElement, nullptr};
+    DescriptorCursor destination = {dst, copy.dstBinding, copy.dstArrayElement, nullptr};
+    for (uint32_t i = 0; i < copy.descriptorCount; ++i) {
+        const Descriptor* from = source.Next(type);
+        Descriptor* to = destination.Next(type);
+        if (!from || !to) return;
+        if (destination.entry->immutable_samplers.empty()) {
+            *to = *from;
+        } else {
+            const VkSampler sampler = to->image.sampler;
+            *to = *from;
+            to->image.sampler = sampler;
+        }
+    }
+}
+
+// Identity of the mock device unless a profile says otherwise
+static const uint32_t MOCK_VENDOR_ID = 0xba5eba11;
+static const uint32_t MOCK_DEVICE_ID = 0xf005ba11;
+static const uint8_t PIPELINE_CACHE_UUID[VK_UUID_SIZE] = {18, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1};
+
+// Formats the mock knows about, in the same ranges vulkaninfo reports. Format tables hold an entry for
+// every format of these ranges in order.
+struct FormatRange {
+    VkFormat first;
+    VkFormat last;
+};
+static const FormatRange format_ranges[] = {
+    {VK_FORMAT_BEGIN_RANGE, VK_FORMAT_END_RANGE},
+    {VK_FORMAT_G8B8G8R8_422_UNORM, VK_FORMAT_G16_B16_R16_3PLANE_444_UNORM},
+    {VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG, VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG},
+};
+static const uint32_t FORMAT_COUNT = (VK_FORMAT_END_RANGE - VK_FORMAT_BEGIN_RANGE + 1) +
+                                     (VK_FORMAT_G16_B16_R16_3PLANE_444_UNORM - VK_FORMAT_G8B8G8R8_422_UNORM + 1) +
+                                     (VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG - VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG + 1);
+
+// Returns the format's index in format tables, FORMAT_COUNT for formats the mock does not know
+static uint32_t GetFormatIndex(VkFormat format) {
+    uint32_t base = 0;
+    for (const auto& range : format_ranges) {
+        if (format >= range.first && format <= range.last) return base + (format - range.first);
+        base += range.last - range.first + 1;
+    }
+    return FORMAT_COUNT;
+}
+
+// Returns the texel block layout of a format, nullptr for formats the mock does not know
+static const FormatInfo* GetFormatInfo(VkFormat format) {
+    struct FormatInfoIndex {
+        const FormatInfo* infos[FORMAT_COUNT + 1] = {};  // The last entry collects formats outside the ranges
+        FormatInfoIndex() {
+            for (const auto& info : format_infos) infos[GetFormatIndex(info.format)] = &info;
+            infos[FORMAT_COUNT] = nullptr;
+        }
+    };
+    static const FormatInfoIndex index;
+    return index.infos[GetFormatIndex(format)];
+}
+
+// Images are laid out the way common desktop drivers lay out linear images, whatever their tiling. Each
+// array layer holds a full mip chain, levels start on IMAGE_SUBRESOURCE_ALIGNMENT and rows are padded to
+// IMAGE_ROW_PITCH_ALIGNMENT. The planes of multi-planar formats follow each other, each with all its layers.
+static const VkDeviceSize IMAGE_ROW_PITCH_ALIGNMENT = 256;
+static const VkDeviceSize IMAGE_SUBRESOURCE_ALIGNMENT = 256;
+static const VkDeviceSize IMAGE_ALIGNMENT = 4096;
+// Formats missing from format_infos get the layout of the widest uncompressed texel
+static const FormatInfo UNKNOWN_FORMAT_INFO = {VK_FORMAT_UNDEFINED, 32, {1, 1, 1}, 1, {{32, 1, 1}}};
+
+static inline VkDeviceSize AlignDeviceSize(VkDeviceSize size, VkDeviceSize alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+struct Image {
+    VkImageCreateInfo create_info;  // pNext and the queue family indices are not kept
+    // Layout of every mip level of every plane in array layer 0, indexed by plane * mipLevels + level
+    std::vector<VkSubresourceLayout> subresources;
+    VkDeviceSize plane_offsets[MAX_FORMAT_PLANES + 1];  // The last one is the size of the image
+    // Memory bound to each plane. Planes of disjoint images are bound on their own, the others all share the binding
+    // of the whole image. Swapchain images are backed by their swapchain instead.
+    MemoryBinding bindings[MAX_FORMAT_PLANES] = {};
+    char* swapchain_data = nullptr;
+};
+static ObjectTable<Image> image_table(STATS_OBJECT_VkImage);
+
+static Image CreateImageState(const VkImageCreateInfo& create_info) {
+    Image image;
+    image.create_info = create_info;
+    image.create_info.pNext = nullptr;
+    image.create_info.queueFamilyIndexCount = 0;
+    image.create_info.pQueueFamilyIndices = nullptr;
+    image.create_info.mipLevels = std::max(create_info.mipLevels, 1u);
+    image.create_info.arrayLayers = std::max(create_info.arrayLayers, 1u);
+    const VkImageCreateInfo& info = image.create_info;
+    const FormatInfo* format_info = GetFormatInfo(info.format);
+    if (!format_info) format_info = &UNKNOWN_FORMAT_INFO;
+    // Sample count bits have the value of the count
+    const VkDeviceSize samples = std::max<VkDeviceSize>(info.samples, 1);
+    image.subresources.resize(format_info->plane_count * info.mipLevels);
+    VkDeviceSize offset = 0;
+    for (uint32_t plane = 0; plane < format_info->plane_count; ++plane) {
+        const FormatPlane& plane_info = format_info->planes[plane];
+        const VkExtent3D& block = format_info->block_extent;
+        offset = AlignDeviceSize(offset, IMAGE_ALIGNMENT);
+        image.plane_offsets[plane] = offset;
+        for (uint32_t level = 0; level < info.mipLevels; ++level) {
+            const uint32_t width = std::max(info.extent.width >> level, 1u);
+            const uint32_t height = std::max(info.extent.height >> level, 1u);
+            const uint32_t depth = std::max(info.extent.depth >> level, 1u);
+            const VkDeviceSize blocks_x = (width + plane_info.width_divisor * block.width - 1) / (plane_info.width_divisor * block.width);
+            const VkDeviceSize blocks_y = (height + plane_info.height_divisor * block.height - 1) / (plane_info.height_divisor * block.height);
+            const VkDeviceSize blocks_z = (depth + block.depth - 1) / block.depth;
+            VkSubresourceLayout& layout = image.subresources[plane * info.mipLevels + level];
+            offset = AlignDeviceSize(offset, IMAGE_SUBRESOURCE_ALIGNMENT);
+            layout.offset = offset;
+            layout.rowPitch = AlignDeviceSize(blocks_x * plane_info.block_size, IMAGE_ROW_PITCH_ALIGNMENT);
+            layout.depthPitch = layout.rowPitch * blocks_y;
+            layout.size = layout.depthPitch * blocks_z * samples;
+            offset += layout.size;
+        }
+        const VkDeviceSize array_pitch = AlignDeviceSize(offset - image.plane_offsets[plane], IMAGE_SUBRESOURCE_ALIGNMENT);
+        for (uint32_t level = 0; level < info.mipLevels; ++level) {
+            image.subresources[plane * info.mipLevels + level].arrayPitch = array_pitch;
+        }
+        offset = image.plane_offsets[plane] + array_pitch * info.arrayLayers;
+    }
+    for (uint32_t plane = format_info->plane_count; plane <= MAX_FORMAT_PLANES; ++plane) image.plane_offsets[plane] = offset;
+    return image;
+}
+
+// Returns the plane of a multi-planar format that an aspect selects, 0 for other aspects
+static uint32_t GetAspectPlane(VkImageAspectFlags aspect_mask) {
+    if (aspect_mask & VK_IMAGE_ASPECT_PLANE_1_BIT) return 1;
+    if (aspect_mask & VK_IMAGE_ASPECT_PLANE_2_BIT) return 2;
+    return 0;
+}
+
+// Image views keep the subresources they view, with VK_REMAINING_MIP_LEVELS and VK_REMAINING_ARRAY_LAYERS resolved
+struct ImageView {
+    VkImage image;
+    VkImageViewType view_type;
+    VkFormat format;
+    VkComponentMapping components;
+    VkImageSubresourceRange range;
+};
+static ObjectTable<ImageView> image_view_table(STATS_OBJECT_VkImageView);
+
+static ImageView CreateImageViewState(const VkImageViewCreateInfo& create_info) {
+    ImageView view = {create_info.image, create_info.viewType, create_info.format, create_info.components, create_info.subresourceRange};
+    if (const Image* image = image_table.Get(create_info.image)) {
+        const VkImageCreateInfo& info = image->create_info;
+        if (view.range.levelCount == VK_REMAINING_MIP_LEVELS) view.range.levelCount = info.mipLevels - std::min(view.range.baseMipLevel, info.mipLevels);
+        if (view.range.layerCount == VK_REMAINING_ARRAY_LAYERS) {
+            view.range.layerCount = info.arrayLayers - std::min(view.range.baseArrayLayer, info.arrayLayers);
+        }
+    }
+    return view;
+}
+
+struct Sampler {
+    VkSamplerCreateInfo create_info;  // pNext is not kept
+};
+static ObjectTable<Sampler> sampler_table(STATS_OBJECT_VkSampler);
+
+static ObjectTable<RenderPass> render_pass_table(STATS_OBJECT_VkRenderPass);
+
+// Takes VkRenderPassCreateInfo or VkRenderPassCreateInfo2, whose structures share the members kept
+template <typename CreateInfo>
+static RenderPass CreateRenderPassState(const CreateInfo& create_info) {
+    RenderPass render_pass;
+    for (uint32_t i = 0; i < create_info.attachmentCount; ++i) {
+        const auto& attachment = create_info.pAttachments[i];
+        const VkAttachmentDescription description = {attachment.flags,         attachment.format,        attachment.samples,
+                                                     attachment.loadOp,        attachment.storeOp,       attachment.stencilLoadOp,
+                                                     attachment.stencilStoreOp, attachment.initialLayout, attachment.finalLayout};
+        render_pass.attachments.push_back(description);
+    }
+    render_pass.first_subpasses.assign(create_info.attachmentCount, UINT32_MAX);
+    render_pass.last_subpasses.assign(create_info.attachmentCount, UINT32_MAX);
+    for (uint32_t s = 0; s < create_info.subpassCount; ++s) {
+        const auto& description = create_info.pSubpasses[s];
+        const auto use = [&render_pass, s](uint32_t attachment) {
+            if (attachment >= render_pass.attachments.size()) return;
+            if (render_pass.first_subpasses[attachment] == UINT32_MAX) render_pass.first_subpasses[attachment] = s;
+            render_pass.last_subpasses[attachment] = s;
+        };
+        RenderSubpass subpass;
+        for (uint32_t i = 0; i < description.colorAttachmentCount; ++i) {
+            subpass.colors.push_back(description.pColorAttachments[i].attachment);
+            use(description.pColorAttachments[i].attachment);
+            if (description.pResolveAttachments) use(description.pResolveAttachments[i].attachment);
+        }
+        for (uint32_t i = 0; i < description.inputAttachmentCount; ++i) use(description.pInputAttachments[i].attachment);
+        if (description.pDepthStencilAttachment) {
+            subpass.depth_stencil = description.pDepthStencilAttachment->attachment;
+            use(subpass.depth_stencil);
+        }
+        render_pass.subpasses.push_back(subpass);
+    }
+    return render_pass;
+}
+
+// Imageless framebuffers get their attachments when a render pass begins, which the mock does not record, so they
+// have none
+struct Framebuffer {
+    std::vector<VkImageView> attachments;
+    uint32_t width;
+    uint32_t height;
+    uint32_t layers;
+};
+static ObjectTable<Framebuffer> framebuffer_table(STATS_OBJECT_VkFramebuffer);
+
+// Everything the physical device reports, set up once by the first vkCreateInstance either from the
+// built-in defaults or from the vulkaninfo JSON profile named by VK_MOCK_PROFILE
+static const uint32_t MAX_PROFILE_QUEUE_FAMILIES = 16;
+struct DeviceProfile {
+    bool loaded = false;
+    bool from_file = false;
+    VkPhysicalDeviceProperties properties;
+    VkPhysicalDeviceFeatures features;
+    VkPhysicalDeviceMemoryProperties memory_properties;
+    uint32_t queue_family_count;
+    VkQueueFamilyProperties queue_families[MAX_PROFILE_QUEUE_FAMILIES];
+    VkFormatProperties format_properties[FORMAT_COUNT];
+};
+static DeviceProfile device_profile;
+
+static const VkFormatProperties* GetProfileFormatProperties(VkFormat format) {
+    const uint32_t index = GetFormatIndex(format);
+    return index < FORMAT_COUNT ? &device_profile.format_properties[index] : nullptr;
+}
+
+// Physical devices keep count of the bytes of each heap the application's allocations take, reported through
+// VK_EXT_memory_budget. The application has the device to itself, so its budget is the whole heap, and allocations
+// that would go past the size the profile gives the heap fail with VK_ERROR_OUT_OF_DEVICE_MEMORY. Memory allocated on
+// several physical devices of a group counts on each of them, though they share a single copy of it.
+
+// Physical devices, as a mask of their indices in physical_devices, an allocation of a device is made on
+static uint32_t GetAllocationPhysicalDeviceMask(const Device& device, const VkMemoryAllocateFlagsInfo* flags_info) {
+    const bool masked = flags_info && (flags_info->flags & VK_MEMORY_ALLOCATE_DEVICE_MASK_BIT);
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < device.physical_devices.size(); ++i) {
+        if (!masked || (flags_info->deviceMask & (1u << i))) mask |= 1u << device.physical_devices[i]->index;
+    }
+    return mask;
+}
+
+static void ReleaseHeapMemory(uint32_t physical_device_mask, uint32_t heap_index, VkDeviceSize size) {
+    for (uint32_t i = 0; i < physical_device_count; ++i) {
+        if (physical_device_mask & (1u << i)) physical_devices[i]->heap_usage[heap_index].fetch_sub(size, std::memory_order_relaxed);
+    }
+}
+
+// Returns false, taking nothing, if the heap has less than size bytes left on any of the physical devices
+static bool ReserveHeapMemory(uint32_t physical_device_mask, uint32_t heap_index, VkDeviceSize size) {
+    if (heap_index >= device_profile.memory_properties.memoryHeapCount) return false;
+    const VkDeviceSize heap_size = device_profile.memory_properties.memoryHeaps[heap_index].size;
+    for (uint32_t i = 0; i < physical_device_count; ++i) {
+        if (!(physical_device_mask & (1u << i))) continue;
+        std::atomic<VkDeviceSize>& heap_usage = physical_devices[i]->heap_usage[heap_index];
+        VkDeviceSize usage = heap_usage.load(std::memory_order_relaxed);
+        do {
+            if (size > heap_size - std::min(usage, heap_size)) {
+                ReleaseHeapMemory(physical_device_mask & ((1u << i) - 1), heap_index, size);
+                return false;
+            }
+        } while (!heap_usage.compare_exchange_weak(usage, usage + size, std::memory_order_relaxed));
+    }
+    return true;
+}
+
+// Every memory type of the profile can back buffers and images
+static uint32_t GetMemoryTypeBits() {
+    return (uint32_t)((1ull << device_profile.memory_properties.memoryTypeCount) - 1);
+}
+
+// Pipeline cache data is only accepted back when its header matches the device
+static const size_t PIPELINE_CACHE_HEADER_SIZE = 16 + VK_UUID_SIZE;
+
+// 64-bit FNV-1a. Pipelines are identified by a hash of everything in their create info that affects
+// the compiled result: shader code, entry points, specialization constants and fixed-function state.
+// Layout and render pass handles are left out so that keys are stable across runs.
+struct Hasher {
+    uint64_t hash = 14695981039346656037ULL;
+    void Add(const void* data, size_t size) {
+        auto bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    template <typename T>
+    void AddValue(const T& value) { Add(&value, sizeof(T)); }
+    // Hashes the fields from first to last inclusive, which must all be 4 bytes wide
+    template <typename F, typename L>
+    void AddFields(const F& first, const L& last) {
+        Add(&first, reinterpret_cast<const char*>(&last + 1) - reinterpret_cast<const char*>(&first));
+    }
+    template <typename T>
+    void AddArray(const T* data, uint32_t count) {
+        AddValue(data ? count : 0);
+        if (data) Add(data, sizeof(T) * count);
+    }
+    void AddString(const char* string) {
+        if (string) Add(string, strlen(string));
+        AddValue('\\0');
+    }
+};
+
+// Pipelines translate the SPIR-V of their stages into the programs mock_icd_shader.h runs
+struct ShaderModule {
+    uint64_t hash;               // Hash of the SPIR-V
+    std::vector<uint32_t> code;  // Translated when pipelines are created
+};
+static ObjectTable<ShaderModule> shader_module_table(STATS_OBJECT_VkShaderModule);
+
+static void HashShaderStage(Hasher* hasher, const VkPipelineShaderStageCreateInfo& stage) {
+    hasher->AddFields(stage.flags, stage.stage);
+    const ShaderModule* module = shader_module_table.Get(stage.module);
+    hasher->AddValue(module ? module->hash : 0);
+    hasher->AddString(stage.pName);
+    const VkSpecializationInfo* specialization = stage.pSpecializationInfo;
+    hasher->AddValue(specialization != nullptr);
+    if (specialization) {
+        hasher->AddArray(specialization->pMapEntries, specialization->mapEntryCount);
+        hasher->AddValue(specialization->dataSize);
+        if (specialization->pData) hasher->Add(specialization->pData, specialization->dataSize);
+    }
+}
+
+static uint64_t GetGraphicsPipelineKey(const VkGraphicsPipelineCreateInfo& create_info) {
+    Hasher hasher;
+    hasher.AddValue(VK_PIPELINE_BIND_POINT_GRAPHICS);
+    hasher.AddFields(create_info.flags, create_info.stageCount);
+    for (uint32_t i = 0; i < create_info.stageCount; ++i) HashShaderStage(&hasher, create_info.pStages[i]);
+    if (const auto state = create_info.pVertexInputState) {
+        hasher.AddValue(state->flags);
+        hasher.AddArray(state->pVertexBindingDescriptions, state->vertexBindingDescriptionCount);
+        hasher.AddArray(state->pVertexAttributeDescriptions, state->vertexAttributeDescriptionCount);
+    }
+    if (const auto state = create_info.pInputAssemblyState) hasher.AddFields(state->flags, state->primitiveRestartEnable);
+    if (const auto state = create_info.pTessellationState) hasher.AddFields(state->flags, state->patchControlPoints);
+    if (const auto state = create_info.pViewportState) {
+        hasher.AddValue(state->flags);
+        hasher.AddArray(state->pViewports, state->viewportCount);
+        hasher.AddArray(state->pScissors, state->scissorCount);
+    }
+    if (const auto state = create_info.pRasterizationState) hasher.AddFields(state->flags, state->lineWidth);
+    if (const auto state = create_info.pMultisampleState) {
+        hasher.AddFields(state->flags, state->minSampleShading);
+        hasher.AddArray(state->pSampleMask, (state->rasterizationSamples + 31) / 32);
+        hasher.AddFields(state->alphaToCoverageEnable, state->alphaToOneEnable);
+    }
+    if (const auto state = create_info.pDepthStencilState) hasher.AddFields(state->flags, state->maxDepthBounds);
+    if (const auto state = create_info.pColorBlendState) {
+        hasher.AddFields(state->flags, state->logicOp);
+        hasher.AddArray(state->pAttachments, state->attachmentCount);
+        hasher.AddValue(state->blendConstants);
+    }
+    if (const auto state = create_info.pDynamicState) {
+        hasher.AddValue(state->flags);
+        hasher.AddArray(state->pDynamicStates, state->dynamicStateCount);
+    }
+    hasher.AddValue(create_info.subpass);
+    return hasher.hash;
+}
+
+static uint64_t GetComputePipelineKey(const VkComputePipelineCreateInfo& create_info) {
+    Hasher hasher;
+    hasher.AddValue(VK_PIPELINE_BIND_POINT_COMPUTE);
+    hasher.AddValue(create_info.flags);
+    HashShaderStage(&hasher, create_info.stage);
+    return hasher.hash;
+}
+
+static std::unique_ptr<ShaderProgram> TranslateShaderStage(const VkPipelineShaderStageCreateInfo& stage, uint32_t execution_model) {
+    const ShaderModule* module = shader_module_table.Get(stage.module);
+    if (!module) return nullptr;
+    return TranslateShader(module->code.data(), module->code.size(), stage.pName, execution_model, stage.pSpecializationInfo);
+}
+
+// Draws are rasterized when VK_MOCK_RASTERIZE is set to something other than 0
+static bool GetRasterizationEnabled() {
+    static const bool enabled = getenv("VK_MOCK_RASTERIZE") && strcmp(getenv("VK_MOCK_RASTERIZE"), "0") != 0;
+    return enabled;
+}
+
+static std::shared_ptr<const RasterPipeline> CreateRasterPipeline(const VkGraphicsPipelineCreateInfo& create_info) {
+    const auto input_assembly = create_info.pInputAssemblyState;
+    const auto rasterization = create_info.pRasterizationState;
+    const auto multisample = create_info.pMultisampleState;
+    if (!input_assembly || !rasterization || rasterization->polygonMode != VK_POLYGON_MODE_FILL) return nullptr;
+    if (input_assembly->topology != VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST && input_assembly->topology != VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP &&
+        input_assembly->topology != VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN) {
+        return nullptr;
+    }
+    if (!rasterization->rasterizerDiscardEnable && multisample && multisample->rasterizationSamples != VK_SAMPLE_COUNT_1_BIT) return nullptr;
+    std::shared_ptr<RasterPipeline> pipeline(new RasterPipeline());
+    for (uint32_t i = 0; i < create_info.stageCount; ++i) {
+        const VkPipelineShaderStageCreateInfo& stage = create_info.pStages[i];
+        if (stage.stage == VK_SHADER_STAGE_VERTEX_BIT) {
+            pipeline->vertex = TranslateShaderStage(stage, SPIRV_EXECUTION_MODEL_VERTEX);
+            if (!pipeline->vertex) return nullptr;
+        } else if (stage.stage == VK_SHADER_STAGE_FRAGMENT_BIT) {
+            pipeline->fragment = TranslateShaderStage(stage, SPIRV_EXECUTION_MODEL_FRAGMENT);
+            if (!pipeline->fragment) return nullptr;
+        } else {
+            return nullptr;
+        }
+    }
+    if (!pipeline->vertex) return nullptr;
+    if (const auto state = create_info.pVertexInputState) {
+        pipeline->bindings.assign(state->pVertexBindingDescriptions, state->pVertexBindingDescriptions + state->vertexBindingDescriptionCount);
+        pipeline->attributes.assign(state->pVertexAttributeDescriptions, state->pVertexAttributeDescriptions + state->vertexAttributeDescriptionCount);
+    }
+    pipeline->topology = input_assembly->topology;
+    pipeline->primitive_restart = input_assembly->primitiveRestartEnable;
+    pipeline->depth_clamp = rasterization->depthClampEnable;
+    pipeline->discard = rasterization->rasterizerDiscardEnable;
+    pipeline->cull_mode = rasterization->cullMode;
+    pipeline->front_face = rasterization->frontFace;
+    const auto depth_stencil = create_info.pDepthStencilState;
+    pipeline->depth_test = depth_stencil && depth_stencil->depthTestEnable;
+    pipeline->depth_write = pipeline->depth_test && depth_stencil->depthWriteEnable;
+    pipeline->depth_compare = depth_stencil ? depth_stencil->depthCompareOp : VK_COMPARE_OP_ALWAYS;
+    if (const auto state = create_info.pColorBlendState) {
+        pipeline->blend_attachments.assign(state->pAttachments, state->pAttachments + state->attachmentCount);
+        memcpy(pipeline->blend_constants, state->blendConstants, sizeof(pipeline->blend_constants));
+    }
+    const auto viewport = create_info.pViewportState;
+    pipeline->viewport = viewport && viewport->viewportCount && viewport->pViewports ? viewport->pViewports[0] : VkViewport();
+    pipeline->scissor = viewport && viewport->scissorCount && viewport->pScissors ? viewport->pScissors[0] : VkRect2D();
+    if (const auto state = create_info.pDynamicState) {
+        for (uint32_t i = 0; i < state->dynamicStateCount; ++i) {
+            switch (state->pDynamicStates[i]) {
+                case VK_DYNAMIC_STATE_VIEWPORT: pipeline->dynamic_viewport = true; break;
+                case VK_DYNAMIC_STATE_SCISSOR: pipeline->dynamic_scissor = true; break;
+                case VK_DYNAMIC_STATE_BLEND_CONSTANTS: pipeline->dynamic_blend_constants = true; break;
+                default: break;
+            }
+        }
+    }
+    return pipeline;
+}
+
+// Compute pipelines hold the program their shader translated to, unless the interpreter does not handle it, and
+// graphics pipelines the state to rasterize their draws with
+struct Pipeline {
+    std::shared_ptr<const ShaderProgram> program;
+    std::shared_ptr<const RasterPipeline> raster;
+};
+static ObjectTable<Pipeline> pipeline_table(STATS_OBJECT_VkPipeline);
+
+// Pipeline caches hold the keys of the pipelines created with them. Their data is the standard header
+// followed by the keys in ascending order. Caches are internally synchronized.
+struct PipelineCache {
+    mutex_t lock;
+    std::set<uint64_t> keys;
+};
+static ObjectTable<PipelineCache> pipeline_cache_table(STATS_OBJECT_VkPipelineCache);
+
+static PipelineCache* GetPipelineCache(VkPipelineCache pipeline_cache) {
+    return pipeline_cache_table.Get(pipeline_cache);
+}
+
+static void WritePipelineCacheHeader(char* data) {
+    const VkPhysicalDeviceProperties& properties = device_profile.properties;
+    const uint32_t header[4] = {(uint32_t)PIPELINE_CACHE_HEADER_SIZE, VK_PIPELINE_CACHE_HEADER_VERSION_ONE, properties.vendorID, properties.deviceID};
+    memcpy(data, header, sizeof(header));
+    memcpy(data + sizeof(header), properties.pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+// Data from a different device or cache format is ignored, as the spec requires
+static void LoadPipelineCacheData(PipelineCache* cache, const void* data, size_t size) {
+    if (!data || size < PIPELINE_CACHE_HEADER_SIZE) return;
+    char header[PIPELINE_CACHE_HEADER_SIZE];
+    WritePipelineCacheHeader(header);
+    if (memcmp(data, header, PIPELINE_CACHE_HEADER_SIZE) != 0) return;
+    const size_t count = (size - PIPELINE_CACHE_HEADER_SIZE) / sizeof(uint64_t);
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t key;
+        memcpy(&key, static_cast<const char*>(data) + PIPELINE_CACHE_HEADER_SIZE + i * sizeof(uint64_t), sizeof(key));
+        cache->keys.insert(key);
+    }
+}
+
+// Simulated time to compile a pipeline that misses the cache, in microseconds from VK_MOCK_PIPELINE_COMPILE_US
+static std::chrono::microseconds GetPipelineCompileCost() {
+    static const std::chrono::microseconds cost(getenv("VK_MOCK_PIPELINE_COMPILE_US") ? strtoull(getenv("VK_MOCK_PIPELINE_COMPILE_US"), nullptr, 10) : 0);
+    return cost;
+}
+
+// Looks the pipeline up in the cache, "compiles" it on a miss and reports the outcome through
+// VK_EXT_pipeline_creation_feedback
+static VkPipeline CreatePipeline(VkPipelineCache pipeline_cache, uint64_t key, const void* create_info_next, Pipeline pipeline) {
+    const auto start = std::chrono::steady_clock::now();
+    bool hit = false;
+    if (PipelineCache* cache = GetPipelineCache(pipeline_cache)) {
+        lock_guard_t lock(cache->lock);
+        hit = !cache->keys.insert(key).second;
+    }
+    if (!hit && GetPipelineCompileCost().count() > 0) std::this_thread::sleep_for(GetPipelineCompileCost());
+    const auto feedback_info = lvl_find_in_chain<VkPipelineCreationFeedbackCreateInfoEXT>(create_info_next);
+    if (feedback_info) {
+        VkPipelineCreationFeedbackFlagsEXT flags = VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT;
+        if (hit) flags |= VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT;
+        feedback_info->pPipelineCreationFeedback->flags = flags;
+        feedback_info->pPipelineCreationFeedback->duration =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        // Stages are compiled together, so they get no duration of their own
+        for (uint32_t i = 0; i < feedback_info->pipelineStageCreationFeedbackCount; ++i) {
+            feedback_info->pPipelineStageCreationFeedbacks[i].flags = flags;
+            feedback_info->pPipelineStageCreationFeedbacks[i].duration = 0;
+        }
+    }
+    return (VkPipeline)pipeline_table.Create(std::move(pipeline));
+}
+
+// Recorded commands are stored as a stream of packets, each a CommandHeader followed by the
+// command's parameter record and any arrays it points to. Arrays are copied into the packet and the
+// record's pointers are redirected to those copies; pNext chains are not captured.
+struct ExecutionContext;
+struct CommandInfo {
+    const char* name;
+    void (*execute)(const void* record, ExecutionContext* context);  // Null for commands with no effect at execution
+};
+struct CommandHeader {
+    const CommandInfo* info;
+    size_t size;  // Size of the whole packet, header included
+};
+static const size_t COMMAND_ALIGNMENT = 8;
+static const size_t COMMAND_CHUNK_SIZE = 64 * 1024;
+
+static inline size_t AlignCommandSize(size_t size) { return (size + COMMAND_ALIGNMENT - 1) & ~(COMMAND_ALIGNMENT - 1); }
+
+// Command streams live in chunks owned by the command pool and chained per command buffer
+struct CommandChunk {
+    CommandChunk* next;
+    size_t capacity;  // Bytes available for packets after the chunk header
+    size_t used;      // Bytes of packets written, final for every chunk but the one being recorded
+    char* Data() { return reinterpret_cast<char*>(this) + AlignCommandSize(sizeof(CommandChunk)); }
+};
+
+struct CommandPool;
+struct CommandBuffer {
+    VK_LOADER_DATA loader_data;  // Must come first, the VkCommandBuffer handle points at it
+    CommandPool* pool;
+    CommandChunk* first_chunk;
+    CommandChunk* last_chunk;
+    char* cursor;
+    char* end;
+    uint64_t reset_epoch;  // Chunks are only valid while this matches the pool's reset_epoch
+    uint32_t command_count;
+    VkResult result;  // VK_ERROR_OUT_OF_HOST_MEMORY once a command could not be recorded, returned by vkEndCommandBuffer
+};
+
+// Command buffers and their command streams are allocated from their pool. Access to a pool is
+// externally synchronized by the application, so recording, allocating and freeing take no lock.
+// Resetting a command buffer splices its chunks back onto the pool's free list; resetting the pool
+// bumps its epoch and makes every chunk available again, both without visiting individual chunks.
+struct CommandPool {
+    SlabAllocator<CommandBuffer> command_buffers;
+    std::vector<CommandChunk*> chunks;
+    size_t next_unused_chunk = 0;  // chunks from this index on are not used since the last pool reset
+    CommandChunk* free_chunks = nullptr;
+    uint64_t reset_epoch = 0;
+    ~CommandPool() {
+        for (auto chunk : chunks) free(chunk);
+    }
+};
+static ObjectTable<CommandPool> command_pool_table(STATS_OBJECT_VkCommandPool);
+
+static CommandChunk* AcquireCommandChunk(CommandPool* pool, size_t size) {
+    if (pool->free_chunks && pool->free_chunks->capacity >= size) {
+        CommandChunk* chunk = pool->free_chunks;
+        pool->free_chunks = chunk->next;
+        return chunk;
+    }
+    while (pool->next_unused_chunk < pool->chunks.size()) {
+        CommandChunk* chunk = pool->chunks[pool->next_unused_chunk++];
+        if (chunk->capacity >= size) return chunk;
+        chunk->next = pool->free_chunks;
+        pool->free_chunks = chunk;
+    }
+    const size_t capacity = size > COMMAND_CHUNK_SIZE ? size : COMMAND_CHUNK_SIZE;
+    auto chunk = static_cast<CommandChunk*>(malloc(AlignCommandSize(sizeof(CommandChunk)) + capacity));
+    if (!chunk) return nullptr;
+    chunk->capacity = capacity;
+    pool->chunks.push_back(chunk);
+    pool->next_unused_chunk = pool->chunks.size();
+    return chunk;
+}
+
+static void ResetCommandStream(CommandBuffer* command_buffer) {
+    CommandPool* pool = command_buffer->pool;
+    if (command_buffer->reset_epoch == pool->reset_epoch && command_buffer->first_chunk) {
+        command_buffer->last_chunk->next = pool->free_chunks;
+        pool->free_chunks = command_buffer->first_chunk;
+    }
+    command_buffer->first_chunk = nullptr;
+    command_buffer->last_chunk = nullptr;
+    command_buffer->cursor = nullptr;
+    command_buffer->end = nullptr;
+    command_buffer->reset_epoch = pool->reset_epoch;
+    command_buffer->command_count = 0;
+    command_buffer->result = VK_SUCCESS;
+}
+
+static bool GrowCommandStream(CommandBuffer* command_buffer, size_t size) {
+    CommandChunk* chunk = AcquireCommandChunk(command_buffer->pool, size);
+    if (!chunk) return false;
+    chunk->next = nullptr;
+    chunk->used = 0;
+    if (command_buffer->last_chunk) {
+        command_buffer->last_chunk->used = command_buffer->cursor - command_buffer->last_chunk->Data();
+        command_buffer->last_chunk->next = chunk;
+    } else {
+        command_buffer->first_chunk = chunk;
+    }
+    command_buffer->last_chunk = chunk;
+    command_buffer->cursor = chunk->Data();
+    command_buffer->end = command_buffer->cursor + chunk->capacity;
+    return true;
+}
+
+// Reserves a packet for one command and returns its parameter record, extra_size bytes of storage
+// for copied arrays follow the record. Returns null, and fails the command buffer, when the pool
+// cannot get the memory for it.
+template <typename T>
+static inline T* RecordCommand(VkCommandBuffer commandBuffer, size_t extra_size, char** storage) {
+    auto command_buffer = reinterpret_cast<CommandBuffer*>(commandBuffer);
+    const size_t size = AlignCommandSize(sizeof(CommandHeader)) + AlignCommandSize(sizeof(T)) + extra_size;
+    if ((size_t)(command_buffer->end - command_buffer->cursor) < size && !GrowCommandStream(command_buffer, size)) {
+        command_buffer->result = VK_ERROR_OUT_OF_HOST_MEMORY;
+        return nullptr;
+    }
+    auto header = reinterpret_cast<CommandHeader*>(command_buffer->cursor);
+    header->info = &T::info;
+    header->size = size;
+    command_buffer->cursor += size;
+    command_buffer->command_count++;
+    char* record = reinterpret_cast<char*>(header) + AlignCommandSize(sizeof(CommandHeader));
+    *storage = record + AlignCommandSize(sizeof(T));
+    return reinterpret_cast<T*>(record);
+}
+
+template <typename T>
+static inline T* RecordCommand(VkCommandBuffer commandBuffer) {
+    char* storage;
+    return RecordCommand<T>(commandBuffer, 0, &storage);
+}
+
+template <typename T>
+static inline size_t CommandArraySize(const T* data, size_t count) {
+    return data ? AlignCommandSize(sizeof(T) * count) : 0;
+}
+static inline size_t CommandArraySize(const void* data, size_t size) { return data ? AlignCommandSize(size) : 0; }
+static inline size_t CommandArraySize(const char* data) { return data ? AlignCommandSize(strlen(data) + 1) : 0; }
+
+template <typename T>
+static inline T* CopyCommandArray(char** storage, const T* data, size_t count) {
+    if (!data) return nullptr;
+    T* copy = reinterpret_cast<T*>(*storage);
+    memcpy(copy, data, sizeof(T) * count);
+    *storage += AlignCommandSize(sizeof(T) * count);
+    return copy;
+}
+static inline void* CopyCommandArray(char** storage, const void* data, size_t size) {
+    if (!data) return nullptr;
+    void* copy = *storage;
+    memcpy(copy, data, size);
+    *storage += AlignCommandSize(size);
+    return copy;
+}
+static inline const char* CopyCommandArray(char** storage, const char* data) {
+    return data ? static_cast<char*>(CopyCommandArray(storage, static_cast<const void*>(data), strlen(data) + 1)) : nullptr;
+}
+
+// Structures passed to vkCmd* that point at further arrays overload these to capture them as well,
+// everything else is copied shallowly
+template <typename T>
+static inline size_t CommandNestedSize(const T* data, size_t count) { return 0; }
+template <typename T>
+static inline void CopyCommandNested(char** storage, T* data, size_t count) {}
+
+static inline size_t CommandNestedSize(const VkRenderPassBeginInfo* data, size_t count) {
+    size_t size = 0;
+    for (size_t i = 0; data && i < count; ++i) size += CommandArraySize(data[i].pClearValues, data[i].clearValueCount);
+    return size;
+}
+static inline void CopyCommandNested(char** storage, VkRenderPassBeginInfo* data, size_t count) {
+    for (size_t i = 0; data && i < count; ++i) data[i].pClearValues = CopyCommandArray(storage, data[i].pClearValues, data[i].clearValueCount);
+}
+
+static inline size_t CommandNestedSize(const VkDebugUtilsLabelEXT* data, size_t count) {
+    size_t size = 0;
+    for (size_t i = 0; data && i < count; ++i) size += CommandArraySize(data[i].pLabelName);
+    return size;
+}
+static inline void CopyCommandNested(char** storage, VkDebugUtilsLabelEXT* data, size_t count) {
+    for (size_t i = 0; data && i < count; ++i) data[i].pLabelName = CopyCommandArray(storage, data[i].pLabelName);
+}
+
+static inline size_t CommandNestedSize(const VkDebugMarkerMarkerInfoEXT* data, size_t count) {
+    size_t size = 0;
+    for (size_t i = 0; data && i < count; ++i) size += CommandArraySize(data[i].pMarkerName);
+    return size;
+}
+static inline void CopyCommandNested(char** storage, VkDebugMarkerMarkerInfoEXT* data, size_t count) {
+    for (size_t i = 0; data && i < count; ++i) data[i].pMarkerName = CopyCommandArray(storage, data[i].pMarkerName);
+}
+
+static inline size_t CommandNestedSize(const VkWriteDescriptorSet* data, size_t count) {
+    size_t size = 0;
+    for (size_t i = 0; data && i < count; ++i) {
+        switch (data[i].descriptorType) {
+            case VK_DESCRIPTOR_TYPE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                size += CommandArraySize(data[i].pImageInfo, data[i].descriptorCount);
+                break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                size += CommandArraySize(data[i].pTexelBufferView, data[i].descriptorCount);
+                break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                size += CommandArraySize(data[i].pBufferInfo, data[i].descriptorCount);
+                break;
+            default:
+                break;
+        }
+    }
+    return size;
+}
+static inline void CopyCommandNested(char** storage, VkWriteDescriptorSet* data, size_t count) {
+    for (size_t i = 0; data && i < count; ++i) {
+        switch (data[i].descriptorType) {
+            case VK_DESCRIPTOR_TYPE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                data[i].pImageInfo = CopyCommandArray(storage, data[i].pImageInfo, data[i].descriptorCount);
+                break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                data[i].pTexelBufferView = CopyCommandArray(storage, data[i].pTexelBufferView, data[i].descriptorCount);
+                break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                data[i].pBufferInfo = CopyCommandArray(storage, data[i].pBufferInfo, data[i].descriptorCount);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static CommandPool* GetCommandPool(VkCommandPool command_pool) {
+    return command_pool_table.Get(command_pool);
+}
+
+static void SignalSyncObjects(Device* device) {
+    SyncEpoch& sync = device->sync;
+    sync.epoch.fetch_add(1);
+    if (sync.waiters.load() == 0) return;
+#if defined(__linux__)
+    syscall(SYS_futex, &sync.epoch, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+    { lock_guard_t lock(sync.lock); }
+    sync.cv.notify_all();
+#endif
+}
+
+static std::chrono::steady_clock::time_point GetSyncDeadline(uint64_t timeout_ns) {
+    // Anything beyond a century is as good as UINT64_MAX, which means no timeout
+    if (timeout_ns > (uint64_t)INT64_MAX / 2) return std::chrono::steady_clock::time_point::max();
+    return std::chrono::steady_clock::now() + std::chrono::nanoseconds(timeout_ns);
+}
+
+// Blocks until done() holds or the deadline passes, returns whether done() held. Only the signals of the device
+// wake the wait.
+template <typename Predicate>
+static bool WaitForSyncObjects(Device* device, Predicate done, std::chrono::steady_clock::time_point deadline) {
+    SyncEpoch& sync = device->sync;
+    const bool infinite = deadline == std::chrono::steady_clock::time_point::max();
+    bool result = false;
+    sync.waiters.fetch_add(1);
+    for (;;) {
+        const uint32_t epoch = sync.epoch.load();
+        if (done()) {
+            result = true;
+            break;
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) break;
+#if defined(__linux__)
+        struct timespec timeout;
+        if (!infinite) {
+            const int64_t remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+            timeout.tv_sec = (time_t)(remaining / 1000000000);
+            timeout.tv_nsec = (long)(remaining % 1000000000);
+        }
+        syscall(SYS_futex, &sync.epoch, FUTEX_WAIT_PRIVATE, epoch, infinite ? nullptr : &timeout, nullptr, 0);
+#else
+        unique_lock_t lock(sync.lock);
+        auto changed = [&sync, epoch] { return sync.epoch.load() != epoch; };
+        if (infinite) {
+            sync.cv.wait(lock, changed);
+        } else {
+            sync.cv.wait_until(lock, deadline, changed);
+        }
+#endif
+    }
+    sync.waiters.fetch_sub(1);
+    return result;
+}
+
+struct Fence {
+    std::atomic<bool> signaled{false};
+};
+
+// Every semaphore is waited on by waiting for its value to reach a target. For timeline semaphores
+// value is the payload. Binary semaphores hand out tickets instead: value counts completed signals and
+// a wait submitted after the n-th signal was submitted waits for value to reach n.
+// The submitted counters are guarded by the sync_lock of the semaphore's device.
+struct Semaphore {
+    VkSemaphoreType type = VK_SEMAPHORE_TYPE_BINARY;
+    uint64_t signals_submitted = 0;
+    uint64_t waits_submitted = 0;
+    std::atomic<uint64_t> value{0};
+};
+
+static ObjectTable<Fence> fence_table(STATS_OBJECT_VkFence);
+static ObjectTable<Semaphore> semaphore_table(STATS_OBJECT_VkSemaphore);
+
+struct Submission {
+    std::vector<std::pair<Semaphore*, uint64_t>> waits;    // Semaphore and the value to wait for
+    std::vector<std::pair<Semaphore*, uint64_t>> signals;  // Semaphore and the value to set
+    std::vector<VkCommandBuffer> command_buffers;
+    std::vector<std::pair<VkSwapchainKHR, uint32_t>> presents;  // Swapchain and the index of the image to present
+    Fence* fence = nullptr;
+};
+
+// Each queue executes its submissions in order on its own worker thread
+struct Queue {
+    VK_LOADER_DATA loader_data;  // Must come first, the VkQueue handle points at it
+    Device* device;
+    mutex_t lock;
+    std::condition_variable work_cv;
+    std::condition_variable idle_cv;
+    std::deque<Submission> submissions;
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+};
+
+// Device timestamps count nanoseconds of CLOCK_MONOTONIC, so they line up with the host's clock
+static uint64_t GetDeviceTimestamp() {
+#if defined(__linux__) || defined(__APPLE__)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Query results are written by the queue workers when they execute the commands that produce them.
+// A query's values are only read by the host once its available flag is set.
+struct QueryPool {
+    VkQueryType type;
+    VkQueryPipelineStatisticFlags pipeline_statistics;
+    uint32_t values_per_query;
+    std::vector<uint64_t> values;
+    std::vector<std::atomic<bool>> available;
+    explicit QueryPool(const VkQueryPoolCreateInfo* create_info)
+        : type(create_info->queryType),
+          pipeline_statistics(create_info->pipelineStatistics),
+          values_per_query(1),
+          available(create_info->queryCount) {
+        if (type == VK_QUERY_TYPE_PIPELINE_STATISTICS) {
+            values_per_query = 0;
+            for (uint32_t bits = pipeline_statistics; bits; bits &= bits - 1) values_per_query++;
+        }
+        values.resize((size_t)create_info->queryCount * values_per_query);
+        for (auto& flag : available) flag = false;
+    }
+};
+static ObjectTable<QueryPool> query_pool_table(STATS_OBJECT_VkQueryPool);
+
+static QueryPool* GetQueryPool(VkQueryPool query_pool) {
+    return query_pool_table.Get(query_pool);
+}
+
+// Cost model of the simulated device. Topology is not tracked, every draw is taken to be a triangle
+// list covering SAMPLES_PER_PRIMITIVE samples per triangle, and every workgroup of a pipeline without a program
+// to run INVOCATIONS_PER_WORKGROUP invocations. Indirect draw parameters are not read: each indirect draw
+// counts as a single triangle.
+static const uint64_t SAMPLES_PER_PRIMITIVE = 64;
+static const uint64_t INVOCATIONS_PER_WORKGROUP = 64;
+static const uint64_t COMMAND_COST_NS = 100;
+static const uint64_t PRIMITIVE_COST_NS = 1;
+static const uint64_t WORKGROUP_COST_NS = 10;
+
+// Counters that queries sample, the pipeline statistics in VkQueryPipelineStatisticFlagBits order
+enum QueryCounter {
+    COUNTER_INPUT_ASSEMBLY_VERTICES,
+    COUNTER_INPUT_ASSEMBLY_PRIMITIVES,
+    COUNTER_VERTEX_SHADER_INVOCATIONS,
+    COUNTER_GEOMETRY_SHADER_INVOCATIONS,
+    COUNTER_GEOMETRY_SHADER_PRIMITIVES,
+    COUNTER_CLIPPING_INVOCATIONS,
+    COUNTER_CLIPPING_PRIMITIVES,
+    COUNTER_FRAGMENT_SHADER_INVOCATIONS,
+    COUNTER_TESSELLATION_CONTROL_SHADER_PATCHES,
+    COUNTER_TESSELLATION_EVALUATION_SHADER_INVOCATIONS,
+    COUNTER_COMPUTE_SHADER_INVOCATIONS,
+    COUNTER_SAMPLES_PASSED,
+    QUERY_COUNTER_COUNT
+};
+
+struct ActiveQuery {
+    QueryPool* pool;
+    uint32_t query;
+    uint64_t begin_counters[QUERY_COUNTER_COUNT];
+};
+
+// Largest number of descriptor sets and bytes of push constants commands can bind, whatever the limits say
+static const uint32_t MAX_BOUND_DESCRIPTOR_SETS = 32;
+static const uint32_t MAX_PUSH_CONSTANTS_SIZE = 256;
+
+struct BoundDescriptorSet {
+    const DescriptorSet* set = nullptr;
+    std::vector<uint32_t> dynamic_offsets;  // Of the set's dynamic buffers in binding order
+};
+
+// What the commands of a command buffer bound to a pipeline bind point
+struct BindPointState {
+    std::shared_ptr<const ShaderProgram> program;
+    BoundDescriptorSet sets[MAX_BOUND_DESCRIPTOR_SETS];
+    DescriptorSet pushed_sets[MAX_BOUND_DESCRIPTOR_SETS];  // Written by vkCmdPushDescriptorSetKHR
+    std::vector<Descriptor> pushed_descriptors[MAX_BOUND_DESCRIPTOR_SETS];  // Of the pushed sets
+    char push_constants[MAX_PUSH_CONSTANTS_SIZE] = {};
+};
+
+static const uint32_t MAX_BOUND_VERTEX_BUFFERS = 32;
+
+// What the commands of a command buffer set for draws besides the graphics bind point
+struct DrawState {
+    std::shared_ptr<const RasterPipeline> pipeline;  // Null unless the bound pipeline's draws are rasterized
+    VkViewport viewport = {};
+    VkRect2D scissor = {};
+    float blend_constants[4] = {};
+    VkBuffer vertex_buffers[MAX_BOUND_VERTEX_BUFFERS] = {};
+    VkDeviceSize vertex_offsets[MAX_BOUND_VERTEX_BUFFERS] = {};
+    VkBuffer index_buffer = VK_NULL_HANDLE;
+    VkDeviceSize index_offset = 0;
+    VkIndexType index_type = VK_INDEX_TYPE_UINT16;
+};
+
+struct RenderPassInstance;
+
+// State of one batch of command buffers while a queue worker executes it
+struct ExecutionContext {
+    uint64_t start_time = 0;  // Device timestamp when the batch started executing
+    uint64_t elapsed = 0;     // Simulated time spent on the batch so far, in nanoseconds
+    uint64_t counters[QUERY_COUNTER_COUNT] = {};
+    std::vector<ActiveQuery> active_queries;
+    BindPointState compute;   // Reset by every command buffer
+    BindPointState graphics;  // Reset by every command buffer
+    DrawState draw;           // Reset by every command buffer
+    // Render pass draws are rasterized in, which secondary command buffers continue
+    std::shared_ptr<RenderPassInstance> render_pass;
+};
+
+// Null for bind points commands are not executed for
+static BindPointState* GetBindPointState(ExecutionContext* context, VkPipelineBindPoint bind_point) {
+    if (bind_point == VK_PIPELINE_BIND_POINT_COMPUTE) return &context->compute;
+    if (bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS) return &context->graphics;
+    return nullptr;
+}
+
+static void ExecuteCommandBuffer(VkCommandBuffer commandBuffer, ExecutionContext* context) {
+    auto command_buffer = reinterpret_cast<CommandBuffer*>(commandBuffer);
+    // Nothing recorded survives a reset of the pool
+    if (command_buffer->reset_epoch != command_buffer->pool->reset_epoch) return;
+    context->compute = BindPointState();
+    context->graphics = BindPointState();
+    context->draw = DrawState();
+    for (CommandChunk* chunk = command_buffer->first_chunk; chunk; chunk = chunk->next) {
+        const char* data = chunk->Data();
+        const char* end = chunk == command_buffer->last_chunk ? command_buffer->cursor : data + chunk->used;
+        while (data < end) {
+            auto header = reinterpret_cast<const CommandHeader*>(data);
+            if (header->info->execute) header->info->execute(data + AlignCommandSize(sizeof(CommandHeader)), context);
+            data += header->size;
+        }
+    }
+}
+
+static void ExecuteDraw(ExecutionContext* context, uint64_t vertex_count, uint64_t instance_count) {
+    const uint64_t vertices = vertex_count * instance_count;
+    const uint64_t primitives = vertex_count / 3 * instance_count;
+    context->counters[COUNTER_INPUT_ASSEMBLY_VERTICES] += vertices;
+    context->counters[COUNTER_INPUT_ASSEMBLY_PRIMITIVES] += primitives;
+    context->counters[COUNTER_VERTEX_SHADER_INVOCATIONS] += vertices;
+    context->counters[COUNTER_CLIPPING_INVOCATIONS] += primitives;
+    context->counters[COUNTER_CLIPPING_PRIMITIVES] += primitives;
+    context->counters[COUNTER_FRAGMENT_SHADER_INVOCATIONS] += primitives * SAMPLES_PER_PRIMITIVE;
+    context->counters[COUNTER_SAMPLES_PASSED] += primitives * SAMPLES_PER_PRIMITIVE;
+    context->elapsed += COMMAND_COST_NS + primitives * PRIMITIVE_COST_NS;
+}
+
+static void ExecuteBindDescriptorSets(BindPointState* state, uint32_t first_set, uint32_t set_count, const VkDescriptorSet* sets,
+                                      uint32_t dynamic_offset_count, const uint32_t* dynamic_offsets) {
+    uint32_t next_offset = 0;
+    for (uint32_t i = 0; i < set_count && first_set + i < MAX_BOUND_DESCRIPTOR_SETS; ++i) {
+        BoundDescriptorSet& bound = state->sets[first_set + i];
+        bound.set = descriptor_set_table.Get(sets[i]);
+        bound.dynamic_offsets.clear();
+        if (!bound.set) continue;
+        const uint32_t count = std::min(bound.set->layout->dynamic_count, dynamic_offset_count - next_offset);
+        bound.dynamic_offsets.assign(dynamic_offsets + next_offset, dynamic_offsets + next_offset + count);
+        next_offset += count;
+    }
+}
+
+// Pushed sets get a layout of their own, which grows to fit what is pushed to them
+static void ExecutePushDescriptorSet(BindPointState* state, uint32_t set, uint32_t write_count, const VkWriteDescriptorSet* writes) {
+    if (set >= MAX_BOUND_DESCRIPTOR_SETS) return;
+    DescriptorSet* pushed = &state->pushed_sets[set];
+    std::vector<Descriptor>& descriptors = state->pushed_descriptors[set];
+    if (!pushed->layout) pushed->layout.reset(new DescriptorSetLayout());
+    for (uint32_t i = 0; i < write_count; ++i) {
+        const VkWriteDescriptorSet& write = writes[i];
+        if (write.descriptorType == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) continue;
+        const auto& bindings = pushed->layout->bindings;
+        const uint32_t count = write.dstArrayElement + write.descriptorCount;
+        if (write.dstBinding >= bindings.size() || bindings[write.dstBinding].type != write.descriptorType ||
+            bindings[write.dstBinding].count < count) {
+            // The binding moves to the end of the descriptors, keeping them unless its type changes
+            std::shared_ptr<DescriptorSetLayout> layout(new DescriptorSetLayout(*pushed->layout));
+            if (write.dstBinding >= layout->bindings.size()) layout->bindings.resize(write.dstBinding + 1);
+            DescriptorLayoutBinding& binding = layout->bindings[write.dstBinding];
+            descriptors.resize(descriptors.size() + count, Descriptor{});
+            if (binding.type == write.descriptorType) {
+                std::copy(descriptors.begin() + binding.first, descriptors.begin() + binding.first + binding.count, descriptors.end() - count);
+            }
+            binding.type = write.descriptorType;
+            binding.count = count;
+            binding.first = (uint32_t)(descriptors.size() - count);
+            layout->descriptor_count = (uint32_t)descriptors.size();
+            pushed->layout = std::move(layout);
+            pushed->descriptors = descriptors.data();
+            pushed->descriptor_count = (uint32_t)descriptors.size();
+        }
+        WriteDescriptors(pushed, write);
+    }
+    state->sets[set].set = pushed;
+    state->sets[set].dynamic_offsets.clear();
+}
+
+static void MakeQueryAvailable(QueryPool* pool, uint32_t query, bool available) {
+    if (query < pool->available.size()) pool->available[query].store(available, std::memory_order_release);
+}
+
+static void ExecuteWriteTimestamp(ExecutionContext* context, VkQueryPool query_pool, uint32_t query) {
+    QueryPool* pool = GetQueryPool(query_pool);
+    if (!pool || query >= pool->available.size()) return;
+    pool->values[(size_t)query * pool->values_per_query] = context->start_time + context->elapsed;
+    MakeQueryAvailable(pool, query, true);
+}
+
+static void ExecuteBeginQuery(ExecutionContext* context, VkQueryPool query_pool, uint32_t query) {
+    QueryPool* pool = GetQueryPool(query_pool);
+    if (!pool || query >= pool->available.size()) return;
+    ActiveQuery active;
+    active.pool = pool;
+    active.query = query;
+    memcpy(active.begin_counters, context->counters, sizeof(context->counters));
+    context->active_queries.push_back(active);
+}
+
+static void ExecuteEndQuery(ExecutionContext* context, VkQueryPool query_pool, uint32_t query) {
+    QueryPool* pool = GetQueryPool(query_pool);
+    auto active = std::find_if(context->active_queries.begin(), context->active_queries.end(),
+                               [&](const ActiveQuery& active) { return active.pool == pool && active.query == query; });
+    // A query begun in another submission has nothing counted
+    if (active == context->active_queries.end()) return;
+    uint64_t* values = &pool->values[(size_t)query * pool->values_per_query];
+    if (pool->type == VK_QUERY_TYPE_OCCLUSION) {
+        values[0] = context->counters[COUNTER_SAMPLES_PASSED] - active->begin_counters[COUNTER_SAMPLES_PASSED];
+    } else if (pool->type == VK_QUERY_TYPE_PIPELINE_STATISTICS) {
+        uint32_t value = 0;
+        for (uint32_t counter = 0; counter < COUNTER_SAMPLES_PASSED; ++counter) {
+            if (pool->pipeline_statistics & (1u << counter)) values[value++] = context->counters[counter] - active->begin_counters[counter];
+        }
+    }
+    context->active_queries.erase(active);
+    MakeQueryAvailable(pool, query, true);
+}
+
+// Writes the results of one query where vkGetQueryPoolResults and vkCmdCopyQueryPoolResults put them
+static void WriteQueryResult(const QueryPool* pool, uint32_t query, bool available, char* data, VkQueryResultFlags flags) {
+    auto write_value = [flags](char* data, uint32_t index, uint64_t value) {
+        if (flags & VK_QUERY_RESULT_64_BIT) {
+            memcpy(data + index * sizeof(uint64_t), &value, sizeof(uint64_t));
+        } else {
+            const uint32_t value32 = (uint32_t)value;
+            memcpy(data + index * sizeof(uint32_t), &value32, sizeof(uint32_t));
+        }
+    };
+    if (available || (flags & VK_QUERY_RESULT_PARTIAL_BIT)) {
+        const uint64_t* values = &pool->values[(size_t)query * pool->values_per_query];
+        for (uint32_t value = 0; value < pool->values_per_query; ++value) write_value(data, value, available ? values[value] : 0);
+    }
+    if (flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) write_value(data, pool->values_per_query, available ? 1 : 0);
+}
+
+// Transfer commands run on the queue workers, straight on the memory bound to their buffers and images. A command
+// reaching past a resource or the memory bound to it, or using one without memory, is skipped as a whole.
+
+// Returns the host address of size bytes at offset in a buffer, nullptr if they are not all backed by memory
+static char* GetBufferData(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size) {
+    const Buffer* buffer_state = buffer_table.Get(buffer);
+    if (!buffer_state || offset > buffer_state->create_info.size || size > buffer_state->create_info.size - offset) return nullptr;
+    const DeviceMemory* memory = device_memory_table.Get(buffer_state->binding.memory);
+    const VkDeviceSize memory_offset = buffer_state->binding.offset + offset;
+    if (!memory || memory_offset > memory->allocation_size || size > memory->allocation_size - memory_offset) return nullptr;
+    return static_cast<char*>(memory->data) + memory_offset;
+}
+
+// Returns the host address of a plane of an image and in size the bytes backing it from there, nullptr if it has no memory
+static char* GetImagePlaneData(const Image* image, uint32_t plane, VkDeviceSize* size) {
+    if (image->swapchain_data) {
+        *size = image->plane_offsets[MAX_FORMAT_PLANES] - image->plane_offsets[plane];
+        return image->swapchain_data + image->plane_offsets[plane];
+    }
+    const MemoryBinding& binding = image->bindings[plane];
+    const DeviceMemory* memory = device_memory_table.Get(binding.memory);
+    const bool disjoint = (image->create_info.flags & VK_IMAGE_CREATE_DISJOINT_BIT) != 0;
+    const VkDeviceSize offset = binding.offset + (disjoint ? 0 : image->plane_offsets[plane]);
+    if (!memory || offset > memory->allocation_size) return nullptr;
+    *size = memory->allocation_size - offset;
+    return static_cast<char*>(memory->data) + offset;
+}
+
+static inline uint32_t DivideRoundingUp(uint32_t value, uint32_t divisor) { return value / divisor + (value % divisor != 0); }
+
+// A box of texel blocks of one aspect of an image subresource, resolved to host memory. The box is a stack of
+// slices, the layers of array images or the depth slices of 3D ones. Combined depth/stencil formats keep the depth
+// bytes of each texel before its stencil byte, while buffers hold either aspect on its own, with D24 depth in the
+// low bytes of 4. Both aspects together cover whole texels. The samples of multisampled images follow each other
+// like the depth slices of a 3D image.
+struct ImageRegion {
+    char* data;  // First block of the box
+    const FormatInfo* format_info;
+    VkDeviceSize row_pitch;
+    VkDeviceSize slice_pitch;
+    VkDeviceSize sample_pitch;
+    VkExtent3D block_extent;
+    uint32_t block_size;
+    uint32_t aspect_offset;  // Bytes of each block the aspect occupies
+    uint32_t aspect_size;
+    uint32_t buffer_block_size;  // Bytes a block of the aspect takes in a buffer
+    uint32_t blocks_x;
+    uint32_t blocks_y;
+    uint32_t depth;  // Slices of each layer
+    uint32_t slices;
+    uint32_t samples;
+};
+
+// Resolves the box of an image subresource at a texel offset with a texel extent, clipped to the subresource.
+// Returns false if it is empty, out of range or not backed by memory.
+static bool GetImageRegion(VkImage image, const VkImageSubresourceLayers& subresource, VkOffset3D offset, VkExtent3D extent,
+                           ImageRegion* region) {
+    const Image* image_state = image_table.Get(image);
+    if (!image_state) return false;
+    const VkImageCreateInfo& info = image_state->create_info;
+    const FormatInfo* format_info = GetFormatInfo(info.format);
+    if (!format_info) format_info = &UNKNOWN_FORMAT_INFO;
+    const uint32_t plane = GetAspectPlane(subresource.aspectMask);
+    if (plane >= format_info->plane_count || subresource.mipLevel >= info.mipLevels ||
+        subresource.baseArrayLayer >= info.arrayLayers || offset.x < 0 || offset.y < 0 || offset.z < 0) {
+        return false;
+    }
+    const FormatPlane& plane_info = format_info->planes[plane];
+    const VkSubresourceLayout& layout = image_state->subresources[plane * info.mipLevels + subresource.mipLevel];
+    const VkExtent3D block = format_info->plane_count > 1 ? VkExtent3D{1, 1, 1} : format_info->block_extent;
+    const uint32_t width = DivideRoundingUp(std::max(info.extent.width >> subresource.mipLevel, 1u), plane_info.width_divisor);
+    const uint32_t height = DivideRoundingUp(std::max(info.extent.height >> subresource.mipLevel, 1u), plane_info.height_divisor);
+    const uint32_t depth = std::max(info.extent.depth >> subresource.mipLevel, 1u);
+    const uint32_t x = offset.x / block.width;
+    const uint32_t y = offset.y / block.height;
+    const uint32_t z = offset.z / block.depth;
+    const uint32_t level_blocks_x = DivideRoundingUp(width, block.width);
+    const uint32_t level_blocks_y = DivideRoundingUp(height, block.height);
+    const uint32_t level_blocks_z = DivideRoundingUp(depth, block.depth);
+    if (x >= level_blocks_x || y >= level_blocks_y || z >= level_blocks_z) return false;
+    const uint32_t layers = std::min(subresource.layerCount, info.arrayLayers - subresource.baseArrayLayer);
+    region->block_extent = block;
+    region->blocks_x = std::min(DivideRoundingUp(extent.width, block.width), level_blocks_x - x);
+    region->blocks_y = std::min(DivideRoundingUp(extent.height, block.height), level_blocks_y - y);
+    region->depth = std::min(DivideRoundingUp(extent.depth, block.depth), level_blocks_z - z);
+    region->slices = layers * region->depth;
+    if (!region->blocks_x || !region->blocks_y || !region->slices) return false;
+    region->format_info = format_info;
+    region->row_pitch = layout.rowPitch;
+    region->slice_pitch = info.imageType == VK_IMAGE_TYPE_3D ? layout.depthPitch : layout.arrayPitch;
+    region->samples = std::max<uint32_t>(info.samples, 1);
+    region->sample_pitch = layout.size / region->samples;
+    region->block_size = plane_info.block_size;
+    region->aspect_offset = 0;
+    region->aspect_size = plane_info.block_size;
+    region->buffer_block_size = plane_info.block_size;
+    const VkImageAspectFlags depth_stencil = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    if ((info.format == VK_FORMAT_D16_UNORM_S8_UINT || info.format == VK_FORMAT_D24_UNORM_S8_UINT ||
+         info.format == VK_FORMAT_D32_SFLOAT_S8_UINT) && (subresource.aspectMask & depth_stencil) != depth_stencil) {
+        if (subresource.aspectMask & VK_IMAGE_ASPECT_STENCIL_BIT) {
+            region->aspect_offset = region->block_size - 1;
+            region->aspect_size = 1;
+            region->buffer_block_size = 1;
+        } else {
+            region->aspect_size = region->block_size - 1;
+            region->buffer_block_size = info.format == VK_FORMAT_D16_UNORM_S8_UINT ? 2 : 4;
+        }
+    }
+    const VkDeviceSize start = layout.offset + subresource.baseArrayLayer * layout.arrayPitch + z * layout.depthPitch +
+                               y * layout.rowPitch + (VkDeviceSize)x * region->block_size;
+    const VkDeviceSize end = start + (region->slices - 1) * region->slice_pitch + (region->samples - 1) * region->sample_pitch +
+                             (region->blocks_y - 1) * layout.rowPitch + (VkDeviceSize)region->blocks_x * region->block_size;
+    VkDeviceSize size;
+    char* data = GetImagePlaneData(image_state, plane, &size);
+    if (!data || end > size) return false;
+    region->data = data + start;
+    return true;
+}
+
+// Copies count blocks of size bytes, stepping through dst and src by their own block sizes. With zero_fill the
+// bytes of each dst block past the copied ones are cleared, for depth copied into buffers.
+static void CopyBlocks(char* dst, uint32_t dst_step, const char* src, uint32_t src_step, uint32_t size, uint32_t count, bool zero_fill) {
+    if (dst_step == size && src_step == size) {
+        memmove(dst, src, (size_t)count * size);
+        return;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        memcpy(dst + (size_t)i * dst_step, src + (size_t)i * src_step, size);
+        if (zero_fill) memset(dst + (size_t)i * dst_step + size, 0, dst_step - size);
+    }
+}
+
+// Copies between a buffer and an image as vkCmdCopyBufferToImage and vkCmdCopyImageToBuffer lay them out
+static void CopyBufferImage(VkBuffer buffer, VkImage image, const VkBufferImageCopy& copy, bool to_image) {
+    ImageRegion region;
+    if (!GetImageRegion(image, copy.imageSubresource, copy.imageOffset, copy.imageExtent, &region)) return;
+    // Buffer rows and slices are given in texels, and are as long as the copy when left 0
+    const uint32_t row_length = std::max(copy.bufferRowLength, copy.imageExtent.width);
+    const uint32_t image_height = std::max(copy.bufferImageHeight, copy.imageExtent.height);
+    const VkDeviceSize row_pitch = (VkDeviceSize)DivideRoundingUp(row_length, region.block_extent.width) * region.buffer_block_size;
+    const VkDeviceSize slice_pitch = DivideRoundingUp(image_height, region.block_extent.height) * row_pitch;
+    const VkDeviceSize size = (region.slices - 1) * slice_pitch + (region.blocks_y - 1) * row_pitch +
+                              (VkDeviceSize)region.blocks_x * region.buffer_block_size;
+    char* buffer_data = GetBufferData(buffer, copy.bufferOffset, size);
+    if (!buffer_data) return;
+    for (uint32_t slice = 0; slice < region.slices; ++slice) {
+        for (uint32_t y = 0; y < region.blocks_y; ++y) {
+            char* image_row = region.data + slice * region.slice_pitch + y * region.row_pitch + region.aspect_offset;
+            char* buffer_row = buffer_data + slice * slice_pitch + y * row_pitch;
+            if (to_image) {
+                CopyBlocks(image_row, region.block_size, buffer_row, region.buffer_block_size, region.aspect_size, region.blocks_x, false);
+            } else {
+                CopyBlocks(buffer_row, region.buffer_block_size, image_row, region.block_size, region.aspect_size, region.blocks_x, true);
+            }
+        }
+    }
+}
+
+// Copies between images as vkCmdCopyImage does. The extent is in texels of the source, and covers as many blocks
+// of the destination as of the source when the formats have blocks of different sizes.
+static void CopyImageToImage(VkImage src_image, VkImage dst_image, const VkImageCopy& copy) {
+    ImageRegion src;
+    ImageRegion dst;
+    const VkExtent3D whole_level = {UINT32_MAX, UINT32_MAX, UINT32_MAX};
+    if (!GetImageRegion(src_image, copy.srcSubresource, copy.srcOffset, copy.extent, &src) ||
+        !GetImageRegion(dst_image, copy.dstSubresource, copy.dstOffset, whole_level, &dst) || src.aspect_size != dst.aspect_size) {
+        return;
+    }
+    const uint32_t slices = std::min(src.slices, dst.slices);
+    const uint32_t samples = std::min(src.samples, dst.samples);
+    const uint32_t blocks_x = std::min(src.blocks_x, dst.blocks_x);
+    const uint32_t blocks_y = std::min(src.blocks_y, dst.blocks_y);
+    for (uint32_t slice = 0; slice < slices; ++slice) {
+        for (uint32_t sample = 0; sample < samples; ++sample) {
+            for (uint32_t y = 0; y < blocks_y; ++y) {
+                CopyBlocks(dst.data + slice * dst.slice_pitch + sample * dst.sample_pitch + y * dst.row_pitch + dst.aspect_offset,
+                           dst.block_size,
+                           src.data + slice * src.slice_pitch + sample * src.sample_pitch + y * src.row_pitch + src.aspect_offset,
+                           src.block_size, src.aspect_size, blocks_x, false);
+            }
+        }
+    }
+}
+
+// Fills size bytes, a multiple of pattern_size, with copies of a pattern. Past the first copy the fill doubles what
+// is written with memcpy, which uses the widest stores the host has, in steps of at most FILL_STEP_SIZE bytes so the
+// source stays in cache.
+static const VkDeviceSize FILL_STEP_SIZE = 64 * 1024;
+static void FillPattern(char* data, VkDeviceSize size, const void* pattern, uint32_t pattern_size) {
+    if (size < pattern_size) return;
+    memcpy(data, pattern, pattern_size);
+    const VkDeviceSize max_step = FILL_STEP_SIZE / pattern_size * pattern_size;
+    VkDeviceSize filled = pattern_size;
+    while (filled < size) {
+        const VkDeviceSize step = std::min(std::min(filled, max_step), size - filled);
+        memcpy(data + filled, data, step);
+        filled += step;
+    }
+}
+
+// Fills size bytes, a multiple of 4, with a 32-bit pattern
+static void FillMemory(char* data, VkDeviceSize size, uint32_t pattern) {
+    const uint8_t byte = (uint8_t)pattern;
+    if (pattern == byte * 0x01010101u) {
+        memset(data, byte, size);
+        return;
+    }
+    FillPattern(data, size, &pattern, sizeof(pattern));
+}
+
+static void ExecuteCopyBuffer(ExecutionContext* context, VkBuffer src_buffer, VkBuffer dst_buffer, uint32_t region_count,
+                              const VkBufferCopy* regions) {
+    for (uint32_t i = 0; i < region_count; ++i) {
+        const char* src = GetBufferData(src_buffer, regions[i].srcOffset, regions[i].size);
+        char* dst = GetBufferData(dst_buffer, regions[i].dstOffset, regions[i].size);
+        if (src && dst) memmove(dst, src, regions[i].size);
+    }
+    context->elapsed += COMMAND_COST_NS;
+}
+
+static void ExecuteFillBuffer(ExecutionContext* context, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, uint32_t data) {
+    const Buffer* buffer_state = buffer_table.Get(buffer);
+    if (buffer_state && size == VK_WHOLE_SIZE) size = offset < buffer_state->create_info.size ? (buffer_state->create_info.size - offset) & ~3ull : 0;
+    if (char* dst = GetBufferData(buffer, offset, size)) FillMemory(dst, size, data);
+    context->elapsed += COMMAND_COST_NS;
+}
+
+static void ExecuteUpdateBuffer(ExecutionContext* context, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, const void* data) {
+    if (char* dst = GetBufferData(buffer, offset, size)) memcpy(dst, data, size);
+    context->elapsed += COMMAND_COST_NS;
+}
+
+static void ExecuteCopyBufferImage(ExecutionContext* context, VkBuffer buffer, VkImage image, uint32_t region_count,
+                                   const VkBufferImageCopy* regions, bool to_image) {
+    for (uint32_t i = 0; i < region_count; ++i) CopyBufferImage(buffer, image, regions[i], to_image);
+    context->elapsed += COMMAND_COST_NS;
+}
+
+static void ExecuteCopyImage(ExecutionContext* context, VkImage src_image, VkImage dst_image, uint32_t region_count,
+                             const VkImageCopy* regions) {
+    for (uint32_t i = 0; i < region_count; ++i) CopyImageToImage(src_image, dst_image, regions[i]);
+    context->elapsed += COMMAND_COST_NS;
+}
+
+// Results are never waited for on the queue. Queries written by earlier commands of the queue are available by
+// then, those that only another queue can still make available are copied as unavailable.
+static void ExecuteCopyQueryPoolResults(ExecutionContext* context, VkQueryPool query_pool, uint32_t first_query, uint32_t query_count,
+                                        VkBuffer buffer, VkDeviceSize offset, VkDeviceSize stride, VkQueryResultFlags flags) {
+    context->elapsed += COMMAND_COST_NS;
+    const QueryPool* pool = GetQueryPool(query_pool);
+    if (!pool || !query_count) return;
+    const uint32_t value_count = pool->values_per_query + ((flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) ? 1 : 0);
+    const VkDeviceSize value_size = (flags & VK_QUERY_RESULT_64_BIT) ? sizeof(uint64_t) : sizeof(uint32_t);
+    char* data = GetBufferData(buffer, offset, (query_count - 1) * stride + value_count * value_size);
+    if (!data) return;
+    for (uint32_t i = 0; i < query_count && first_query + i < pool->available.size(); ++i) {
+        const uint32_t query = first_query + i;
+        WriteQueryResult(pool, query, pool->available[query].load(std::memory_order_acquire), data + i * stride, flags);
+    }
+}
+
+// Clears, blits and resolves run on the queue workers like transfers. Texels are converted through
+// VkClearColorValue, which holds floats for normalized, scaled and floating point formats and 32-bit integers for
+// integer ones, so they only work on formats with components in format_infos. The host is taken to be
+// little-endian, as the packed words of formats are. Images large enough are split into bands of rows that the
+// threads of compute_pool work on.
+static const uint32_t MAX_CONVERTED_BLOCK_SIZE = 16;
+static const VkDeviceSize MIN_ROW_BAND_SIZE = 1024 * 1024;
+
+// Calls function(first_row, end_row) for bands of rows covering row_count rows, one per thread of compute_pool at
+// most and none smaller than MIN_ROW_BAND_SIZE of the size bytes the rows hold
+template <typename Function>
+static void ForEachRowBand(uint32_t row_count, VkDeviceSize size, const Function& function) {
+    const uint32_t band_count = (uint32_t)std::min<VkDeviceSize>(std::min(compute_pool.GetThreadCount(), row_count),
+                                                                 std::max<VkDeviceSize>(size / MIN_ROW_BAND_SIZE, 1));
+    if (band_count <= 1) {
+        function(0, row_count);
+        return;
+    }
+    compute_pool.Run(band_count, [&](uint32_t, uint64_t band) {
+        function((uint32_t)(row_count * band / band_count), (uint32_t)(row_count * (band + 1) / band_count));
+    });
+}
+
+// Returns the first byte of the aspect in a row of a region, counting rows through every sample of every slice
+static inline char* GetRegionRow(const ImageRegion& region, uint32_t row) {
+    const uint32_t y = row % region.blocks_y;
+    const uint32_t sample = row / region.blocks_y % region.samples;
+    const uint32_t slice = row / region.blocks_y / region.samples;
+    return region.data + slice * region.slice_pitch + sample * region.sample_pitch + y * region.row_pitch + region.aspect_offset;
+}
+
+static inline bool IsColorFormat(const FormatInfo& info) {
+    return info.component_count && info.components[0].channel <= FORMAT_CHANNEL_A;
+}
+
+static inline bool IsIntegerFormat(const FormatInfo& info) {
+    return info.component_count &&
+           (info.components[0].numeric == FORMAT_NUMERIC_UINT || info.components[0].numeric == FORMAT_NUMERIC_SINT);
+}
+
+// Formats whose every byte is an 8-bit unsigned normalized component can be filtered and averaged byte by byte
+static bool IsUnorm8Format(const FormatInfo& info) {
+    if (info.plane_count != 1 || info.component_count != info.block_size) return false;
+    for (uint32_t i = 0; i < info.component_count; ++i) {
+        const FormatComponent& component = info.components[i];
+        if (component.numeric != FORMAT_NUMERIC_UNORM || component.bits != 8 || component.offset % 8) return false;
+    }
+    return true;
+}
+
+// Components are at most 32 bits wide, so with the bits before them in their first byte they span at most 5 bytes
+static inline uint32_t ReadComponent(const char* block, const FormatComponent& component) {
+    if (component.offset % 8 == 0) {
+        const char* data = block + component.offset / 8;
+        if (component.bits == 8) return (uint8_t)*data;
+        if (component.bits == 16) {
+            uint16_t bits;
+            memcpy(&bits, data, sizeof(bits));
+            return bits;
+        }
+        if (component.bits == 32) {
+            uint32_t bits;
+            memcpy(&bits, data, sizeof(bits));
+            return bits;
+        }
+    }
+    uint64_t bits = 0;
+    memcpy(&bits, block + component.offset / 8, (component.offset % 8 + component.bits + 7) / 8);
+    return (uint32_t)((bits >> (component.offset % 8)) & ((1ull << component.bits) - 1));
+}
+
+static inline void WriteComponent(char* block, const FormatComponent& component, uint32_t value) {
+    const uint32_t shift = component.offset % 8;
+    const size_t size = (shift + component.bits + 7) / 8;
+    const uint64_t mask = ((1ull << component.bits) - 1) << shift;
+    uint64_t bits = 0;
+    memcpy(&bits, block + component.offset / 8, size);
+    bits = (bits & ~mask) | (((uint64_t)value << shift) & mask);
+    memcpy(block + component.offset / 8, &bits, size);
+}
+
+// Converts floats to the 16-bit floats of SFLOAT formats, or with 6 and 5 mantissa bits and no sign to the 11 and
+// 10-bit floats of UFLOAT formats. Rounds to nearest, saturating to infinity and flushing negative values of unsigned
+// floats to 0.
+static uint32_t PackSmallFloat(float value, uint32_t mantissa_bits, bool is_signed) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = is_signed ? (bits >> 31) << (mantissa_bits + 5) : 0;
+    const uint32_t magnitude = bits & 0x7fffffff;
+    const uint32_t infinity = 0x1fu << mantissa_bits;
+    if (magnitude > 0x7f800000) return infinity | 1;
+    if (!is_signed && (bits >> 31)) return 0;
+    const int32_t exponent = (int32_t)(magnitude >> 23) - 127 + 15;
+    const uint32_t mantissa = magnitude & 0x7fffff;
+    if (exponent >= 31) return sign | infinity;
+    if (exponent <= 0) {
+        const uint32_t shift = (uint32_t)(24 - (int32_t)mantissa_bits - exponent);
+        if (shift > 24) return sign;
+        return sign | (((mantissa | 0x800000) + (1u << (shift - 1))) >> shift);
+    }
+    const uint32_t packed = ((uint32_t)exponent << mantissa_bits) | (mantissa >> (23 - mantissa_bits));
+    return sign | (packed + ((mantissa >> (22 - mantissa_bits)) & 1));
+}
+
+static float UnpackSmallFloat(uint32_t bits, uint32_t mantissa_bits, bool is_signed) {
+    const uint32_t mantissa = bits & ((1u << mantissa_bits) - 1);
+    const uint32_t exponent = (bits >> mantissa_bits) & 0x1f;
+    float value;
+    if (exponent == 0x1f) {
+        value = mantissa ? NAN : INFINITY;
+    } else if (exponent == 0) {
+        value = std::ldexp((float)mantissa, -14 - (int32_t)mantissa_bits);
+    } else {
+        value = std::ldexp((float)(mantissa | (1u << mantissa_bits)), (int32_t)exponent - 15 - (int32_t)mantissa_bits);
+    }
+    return is_signed && ((bits >> (mantissa_bits + 5)) & 1) ? -value : value;
+}
+
+static inline float SrgbToLinear(float value) {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static inline float LinearToSrgb(float value) {
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+// Linear values of the components of sRGB formats, which are all 8 bits wide
+static const float* GetSrgbDecodeTable() {
+    static const struct SrgbDecodeTable {
+        SrgbDecodeTable() {
+            for (uint32_t i = 0; i < 256; ++i) values[i] = SrgbToLinear(i / 255.0f);
+        }
+        float values[256];
+    } table;
+    return table.values;
+}
+
+// Rounds to the nearest integer in [low, high], NaN to low
+static inline int64_t ClampRound(double value, double low, double high) {
+    return (int64_t)std::floor(std::min(std::max(low, value), high) + 0.5);
+}
+
+// Converts the component of a texel block to the channels of a color, missing channels read as 0 and alpha as 1
+static void DecodeTexel(const FormatInfo& info, const char* block, VkClearColorValue* color) {
+    color->uint32[0] = color->uint32[1] = color->uint32[2] = 0;
+    if (IsIntegerFormat(info)) {
+        color->uint32[3] = 1;
+    } else {
+        color->float32[3] = 1.0f;
+    }
+    for (uint32_t i = 0; i < info.component_count; ++i) {
+        const FormatComponent& component = info.components[i];
+        if (component.channel > FORMAT_CHANNEL_A) continue;
+        const uint32_t bits = ReadComponent(block, component);
+        const uint32_t max = (uint32_t)((1ull << component.bits) - 1);
+        const int32_t value = (bits >> (component.bits - 1)) ? (int32_t)(bits | ~max) : (int32_t)bits;
+        float& channel = color->float32[component.channel];
+        switch (component.numeric) {
+            case FORMAT_NUMERIC_UNORM:
+                channel = bits / (float)max;
+                break;
+            case FORMAT_NUMERIC_SNORM:
+                channel = std::max(value / (float)(max >> 1), -1.0f);
+                break;
+            case FORMAT_NUMERIC_USCALED:
+                channel = (float)bits;
+                break;
+            case FORMAT_NUMERIC_SSCALED:
+                channel = (float)value;
+                break;
+            case FORMAT_NUMERIC_UINT:
+                color->uint32[component.channel] = bits;
+                break;
+            case FORMAT_NUMERIC_SINT:
+                color->int32[component.channel] = value;
+                break;
+            case FORMAT_NUMERIC_UFLOAT:
+                channel = UnpackSmallFloat(bits, component.bits - 5, false);
+                break;
+            case FORMAT_NUMERIC_SFLOAT:
+                if (component.bits == 32) {
+                    memcpy(&channel, &bits, sizeof(channel));
+                } else {
+                    channel = UnpackSmallFloat(bits, 10, true);
+                }
+                break;
+            case FORMAT_NUMERIC_SRGB:
+                channel = GetSrgbDecodeTable()[bits & 0xff];
+                break;
+        }
+    }
+}
+
+// Converts channel index of a color to the bits of a component, clamped to what the component holds
+static uint32_t EncodeComponent(const FormatComponent& component, const VkClearColorValue& color, uint32_t index) {
+    const uint32_t max = (uint32_t)((1ull << component.bits) - 1);
+    const double half = max >> 1;
+    const float value = color.float32[index];
+    switch (component.numeric) {
+        case FORMAT_NUMERIC_UNORM:
+            return (uint32_t)ClampRound((double)value * max, 0, max);
+        case FORMAT_NUMERIC_SNORM:
+            return (uint32_t)ClampRound((double)value * half, -half, half) & max;
+        case FORMAT_NUMERIC_USCALED:
+            return (uint32_t)ClampRound(value, 0, max);
+        case FORMAT_NUMERIC_SSCALED:
+            return (uint32_t)ClampRound(value, -half - 1, half) & max;
+        case FORMAT_NUMERIC_UINT:
+            return std::min(color.uint32[index], max);
+        case FORMAT_NUMERIC_SINT:
+            return (uint32_t)std::max(-(int32_t)half - 1, std::min(color.int32[index], (int32_t)half)) & max;
+        case FORMAT_NUMERIC_UFLOAT:
+            return PackSmallFloat(value, component.bits - 5, false);
+        case FORMAT_NUMERIC_SFLOAT:
+            if (component.bits == 32) {
+                uint32_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                return bits;
+            }
+            return PackSmallFloat(value, 10, true);
+        case FORMAT_NUMERIC_SRGB:
+            return (uint32_t)ClampRound((double)LinearToSrgb(value) * max, 0, max);
+    }
+    return 0;
+}
+
+// Writes the color channels of a texel block, leaving padding bits as they are
+static void EncodeTexel(const FormatInfo& info, const VkClearColorValue& color, char* block) {
+    for (uint32_t i = 0; i < info.component_count; ++i) {
+        const FormatComponent& component = info.components[i];
+        if (component.channel <= FORMAT_CHANNEL_A) WriteComponent(block, component, EncodeComponent(component, color, component.channel));
+    }
+}
+
+// Sets the aspects each range selects of every texel in the ranges to those of block. The first row of each band
+// is filled with copies of the block and copied to the others.
+static void ClearImage(VkImage image, const char* block, uint32_t range_count, const VkImageSubresourceRange* ranges) {
+    const Image* image_state = image_table.Get(image);
+    if (!image_state) return;
+    const VkImageCreateInfo& info = image_state->create_info;
+    const VkExtent3D whole_level = {UINT32_MAX, UINT32_MAX, UINT32_MAX};
+    for (uint32_t i = 0; i < range_count; ++i) {
+        const VkImageSubresourceRange& range = ranges[i];
+        if (range.baseMipLevel >= info.mipLevels) continue;
+        const uint32_t end_level = range.baseMipLevel + std::min(range.levelCount, info.mipLevels - range.baseMipLevel);
+        for (uint32_t level = range.baseMipLevel; level < end_level; ++level) {
+            ImageRegion region;
+            const VkImageSubresourceLayers subresource = {range.aspectMask, level, range.baseArrayLayer, range.layerCount};
+            if (!GetImageRegion(image, subresource, {0, 0, 0}, whole_level, &region)) continue;
+            const bool whole_blocks = region.aspect_size == region.block_size;
+            const uint32_t row_size = region.blocks_x * region.block_size;
+            const uint32_t row_count = region.slices * region.samples * region.blocks_y;
+            ForEachRowBand(row_count, (VkDeviceSize)row_count * row_size, [&](uint32_t first_row, uint32_t end_row) {
+                char* first = GetRegionRow(region, first_row);
+                if (whole_blocks) {
+                    FillPattern(first, row_size, block, region.block_size);
+                } else {
+                    CopyBlocks(first, region.block_size, block + region.aspect_offset, 0, region.aspect_size, region.blocks_x, false);
+                }
+                for (uint32_t row = first_row + 1; row < end_row; ++row) {
+                    if (whole_blocks) {
+                        memcpy(GetRegionRow(region, row), first, row_size);
+                    } else {
+                        CopyBlocks(GetRegionRow(region, row), region.block_size, first, region.block_size, region.aspect_size,
+                                   region.blocks_x, false);
+                    }
+                }
+            });
+        }
+    }
+}
+
+// Source texels that a destination texel of a blit samples along one axis, with the weight of the second one
+struct BlitSample {
+    uint32_t first;
+    uint32_t second;
+    float weight;
+};
+
+// Maps the destination texels of a blit along one axis to the source texels they sample. The centers of the texels
+// in the destination box map linearly into the source box, mirrored when one box is given from its far end, and
+// samples are clamped to the edge of the source level. Returns false if the destination box is empty.
+static bool GetBlitSamples(int32_t src0, int32_t src1, int32_t dst0, int32_t dst1, uint32_t src_size, uint32_t dst_size, bool linear,
+                           uint32_t* dst_begin, std::vector<BlitSample>* samples) {
+    const int64_t begin = std::max<int64_t>(std::min(dst0, dst1), 0);
+    const int64_t end = std::min<int64_t>(std::max(dst0, dst1), dst_size);
+    if (begin >= end || src0 == src1) return false;
+    const double scale = (double)(src1 - src0) / (dst1 - dst0);
+    *dst_begin = (uint32_t)begin;
+    samples->resize(end - begin);
+    for (int64_t dst = begin; dst < end; ++dst) {
+        const double position = src0 + (dst + 0.5 - dst0) * scale - (linear ? 0.5 : 0.0);
+        const double first = std::floor(position);
+        BlitSample& sample = (*samples)[dst - begin];
+        sample.first = (uint32_t)std::min(std::max(first, 0.0), src_size - 1.0);
+        sample.second = (uint32_t)std::min(std::max(first + 1, 0.0), src_size - 1.0);
+        sample.weight = linear ? (float)(position - first) : 0.0f;
+    }
+    return true;
+}
+
+// Blits a region as vkCmdBlitImage does. Nearest filtering between images of the same format moves the aspects
+// unconverted, everything else decodes the source rows it samples, filters them and encodes the result.
+static void BlitImageRegion(VkImage src_image, VkImage dst_image, const VkImageBlit& blit, VkFilter filter) {
+    ImageRegion src;
+    ImageRegion dst;
+    const VkExtent3D whole_level = {UINT32_MAX, UINT32_MAX, UINT32_MAX};
+    if (!GetImageRegion(src_image, blit.srcSubresource, {0, 0, 0}, whole_level, &src) ||
+        !GetImageRegion(dst_image, blit.dstSubresource, {0, 0, 0}, whole_level, &dst)) {
+        return;
+    }
+    const FormatInfo& src_format = *src.format_info;
+    const FormatInfo& dst_format = *dst.format_info;
+    for (const FormatInfo* format : {&src_format, &dst_format}) {
+        if (format->plane_count != 1 || format->block_extent.width != 1 || format->block_extent.height != 1) return;
+    }
+    const bool linear = filter == VK_FILTER_LINEAR && IsColorFormat(src_format) && !IsIntegerFormat(src_format);
+    const bool convert = linear || &src_format != &dst_format;
+    // Linear blits within a format of 8-bit normalized components, as mip generation does, filter each byte as a
+    // channel of its own instead of converting texels
+    const bool byte_channels = linear && &src_format == &dst_format && IsUnorm8Format(src_format) && src_format.block_size <= 4;
+    if (convert ? !IsColorFormat(src_format) || !IsColorFormat(dst_format) : src.aspect_size != dst.aspect_size) return;
+    uint32_t x_begin, y_begin, z_begin;
+    std::vector<BlitSample> xs, ys, zs;
+    if (!GetBlitSamples(blit.srcOffsets[0].x, blit.srcOffsets[1].x, blit.dstOffsets[0].x, blit.dstOffsets[1].x, src.blocks_x,
+                        dst.blocks_x, linear, &x_begin, &xs) ||
+        !GetBlitSamples(blit.srcOffsets[0].y, blit.srcOffsets[1].y, blit.dstOffsets[0].y, blit.dstOffsets[1].y, src.blocks_y,
+                        dst.blocks_y, linear, &y_begin, &ys) ||
+        !GetBlitSamples(blit.srcOffsets[0].z, blit.srcOffsets[1].z, blit.dstOffsets[0].z, blit.dstOffsets[1].z, src.depth,
+                        dst.depth, linear, &z_begin, &zs)) {
+        return;
+    }
+    uint32_t x_min = UINT32_MAX;
+    uint32_t x_max = 0;
+    bool contiguous = src.aspect_size == src.block_size;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        x_min = std::min(x_min, std::min(xs[i].first, xs[i].second));
+        x_max = std::max(x_max, std::max(xs[i].first, xs[i].second));
+        contiguous = contiguous && xs[i].first == xs[0].first + i;
+    }
+    const uint32_t layers = std::min(src.slices / src.depth, dst.slices / dst.depth);
+    const uint32_t rows_per_layer = (uint32_t)(zs.size() * ys.size());
+    const uint32_t row_count = layers * rows_per_layer;
+    ForEachRowBand(row_count, (VkDeviceSize)row_count * xs.size() * dst.block_size, [&](uint32_t first_row, uint32_t end_row) {
+        // Decoded source rows, least recently used first out. Destination rows sample at most four and often share
+        // them with the previous row.
+        struct DecodedRow {
+            uint64_t key = UINT64_MAX;
+            uint64_t last_use = 0;
+            std::vector<VkClearColorValue> texels;
+        };
+        DecodedRow decoded_rows[4];
+        uint64_t use = 0;
+        for (uint32_t row = first_row; row < end_row; ++row) {
+            const uint32_t layer = row / rows_per_layer;
+            const uint32_t dst_z = row / (uint32_t)ys.size() % (uint32_t)zs.size();
+            const uint32_t dst_y = row % (uint32_t)ys.size();
+            const BlitSample& z = zs[dst_z];
+            const BlitSample& y = ys[dst_y];
+            char* dst_row = dst.data + (layer * dst.depth + z_begin + dst_z) * dst.slice_pitch + (y_begin + dst_y) * dst.row_pitch +
+                            (VkDeviceSize)x_begin * dst.block_size + dst.aspect_offset;
+            auto get_src_row = [&](uint32_t src_z, uint32_t src_y) {
+                return src.data + (layer * src.depth + src_z) * src.slice_pitch + src_y * src.row_pitch + src.aspect_offset;
+            };
+            if (!convert) {
+                const char* src_row = get_src_row(z.first, y.first);
+                if (contiguous) {
+                    memcpy(dst_row, src_row + (VkDeviceSize)xs[0].first * src.block_size, xs.size() * src.block_size);
+                    continue;
+                }
+                for (size_t i = 0; i < xs.size(); ++i) {
+                    memcpy(dst_row + i * dst.block_size, src_row + (VkDeviceSize)xs[i].first * src.block_size, src.aspect_size);
+                }
+                continue;
+            }
+            auto decode_row = [&](uint32_t src_z, uint32_t src_y) -> const VkClearColorValue* {
+                const uint64_t key = ((uint64_t)(layer * src.depth + src_z) << 32) | src_y;
+                DecodedRow* decoded = &decoded_rows[0];
+                for (DecodedRow& candidate : decoded_rows) {
+                    if (candidate.key == key) {
+                        candidate.last_use = ++use;
+                        return candidate.texels.data();
+                    }
+                    if (candidate.last_use < decoded->last_use) decoded = &candidate;
+                }
+                decoded->key = key;
+                decoded->last_use = ++use;
+                decoded->texels.resize(x_max - x_min + 1);
+                const char* src_row = get_src_row(src_z, src_y) + (VkDeviceSize)x_min * src.block_size;
+                for (uint32_t i = 0; i <= x_max - x_min; ++i) {
+                    const char* block = src_row + i * src.block_size;
+                    if (byte_channels) {
+                        for (uint32_t c = 0; c < 4; ++c) decoded->texels[i].float32[c] = c < src.block_size ? (uint8_t)block[c] : 0.0f;
+                    } else {
+                        DecodeTexel(src_format, block, &decoded->texels[i]);
+                    }
+                }
+                return decoded->texels.data();
+            };
+            const VkClearColorValue* row00 = decode_row(z.first, y.first);
+            if (!linear) {
+                for (size_t i = 0; i < xs.size(); ++i) EncodeTexel(dst_format, row00[xs[i].first - x_min], dst_row + i * dst.block_size);
+                continue;
+            }
+            const VkClearColorValue* row01 = decode_row(z.first, y.second);
+            const VkClearColorValue* row10 = decode_row(z.second, y.first);
+            const VkClearColorValue* row11 = decode_row(z.second, y.second);
+            for (size_t i = 0; i < xs.size(); ++i) {
+                const uint32_t x0 = xs[i].first - x_min;
+                const uint32_t x1 = xs[i].second - x_min;
+                const float wx = xs[i].weight;
+                VkClearColorValue texel;
+                for (uint32_t c = 0; c < 4; ++c) {
+                    const float v00 = row00[x0].float32[c] + (row00[x1].float32[c] - row00[x0].float32[c]) * wx;
+                    const float v01 = row01[x0].float32[c] + (row01[x1].float32[c] - row01[x0].float32[c]) * wx;
+                    const float v10 = row10[x0].float32[c] + (row10[x1].float32[c] - row10[x0].float32[c]) * wx;
+                    const float v11 = row11[x0].float32[c] + (row11[x1].float32[c] - row11[x0].float32[c]) * wx;
+                    const float v0 = v00 + (v01 - v00) * y.weight;
+                    const float v1 = v10 + (v11 - v10) * y.weight;
+                    texel.float32[c] = v0 + (v1 - v0) * z.weight;
+                }
+                if (byte_channels) {
+                    for (uint32_t c = 0; c < dst.block_size; ++c) dst_row[i * dst.block_size + c] = (char)(uint8_t)(texel.float32[c] + 0.5f);
+                } else {
+                    EncodeTexel(dst_format, texel, dst_row + i * dst.block_size);
+                }
+            }
+        }
+    });
+}
+
+// Resolves a region as vkCmdResolveImage does. Normalized and floating point formats average the samples of each
+// texel, integer formats take sample 0. Formats of 8-bit unsigned normalized components average the bytes of whole
+// rows at once without decoding them.
+static void ResolveImageRegion(VkImage src_image, VkImage dst_image, const VkImageResolve& resolve) {
+    ImageRegion src;
+    ImageRegion dst;
+    if (!GetImageRegion(src_image, resolve.srcSubresource, resolve.srcOffset, resolve.extent, &src) ||
+        !GetImageRegion(dst_image, resolve.dstSubresource, resolve.dstOffset, resolve.extent, &dst) ||
+        src.format_info != dst.format_info || !IsColorFormat(*src.format_info)) {
+        return;
+    }
+    const FormatInfo& format = *src.format_info;
+    const uint32_t blocks_x = std::min(src.blocks_x, dst.blocks_x);
+    const uint32_t blocks_y = std::min(src.blocks_y, dst.blocks_y);
+    const uint32_t slices = std::min(src.slices, dst.slices);
+    const uint32_t row_size = blocks_x * format.block_size;
+    const uint32_t samples = src.samples;
+    const bool average = samples > 1 && !IsIntegerFormat(format);
+    const bool unorm8 = IsUnorm8Format(format);
+    // Sample counts are powers of two
+    uint32_t sample_shift = 0;
+    while ((1u << sample_shift) < samples) ++sample_shift;
+    const uint32_t row_count = slices * blocks_y;
+    ForEachRowBand(row_count, (VkDeviceSize)row_count * row_size * samples, [&](uint32_t first_row, uint32_t end_row) {
+        std::vector<uint16_t> sums;
+        std::vector<VkClearColorValue> texels;
+        for (uint32_t row = first_row; row < end_row; ++row) {
+            const char* src_row = src.data + row / blocks_y * src.slice_pitch + row % blocks_y * src.row_pitch;
+            char* dst_row = dst.data + row / blocks_y * dst.slice_pitch + row % blocks_y * dst.row_pitch;
+            if (!average) {
+                memcpy(dst_row, src_row, row_size);
+            } else if (unorm8) {
+                sums.assign(row_size, 0);
+                for (uint32_t sample = 0; sample < samples; ++sample) {
+                    const uint8_t* sample_row = reinterpret_cast<const uint8_t*>(src_row + sample * src.sample_pitch);
+                    for (uint32_t i = 0; i < row_size; ++i) sums[i] += sample_row[i];
+                }
+                for (uint32_t i = 0; i < row_size; ++i) dst_row[i] = (char)((sums[i] + (samples >> 1)) >> sample_shift);
+            } else {
+                texels.resize(blocks_x);
+                for (uint32_t x = 0; x < blocks_x; ++x) {
+                    VkClearColorValue& texel = texels[x];
+                    texel = {};
+                    for (uint32_t sample = 0; sample < samples; ++sample) {
+                        VkClearColorValue value;
+                        DecodeTexel(format, src_row + sample * src.sample_pitch + x * format.block_size, &value);
+                        for (uint32_t c = 0; c < 4; ++c) texel.float32[c] += value.float32[c];
+                    }
+                    for (uint32_t c = 0; c < 4; ++c) texel.float32[c] /= samples;
+                    EncodeTexel(format, texel, dst_row + x * format.block_size);
+                }
+            }
+        }
+    });
+}
+
+static void ExecuteClearColorImage(ExecutionContext* context, VkImage image, const VkClearColorValue& color, uint32_t range_count,
+                                   const VkImageSubresourceRange* ranges) {
+    context->elapsed += COMMAND_COST_NS;
+    const Image* image_state = image_table.Get(image);
+    const FormatInfo* format_info = image_state ? GetFormatInfo(image_state->create_info.format) : nullptr;
+    if (!format_info || !IsColorFormat(*format_info) || format_info->block_size > MAX_CONVERTED_BLOCK_SIZE) return;
+    char block[MAX_CONVERTED_BLOCK_SIZE] = {};
+    EncodeTexel(*format_info, color, block);
+    ClearImage(image, block, range_count, ranges);
+}
+
+static void ExecuteClearDepthStencilImage(ExecutionContext* context, VkImage image, const VkClearDepthStencilValue& depth_stencil,
+                                          uint32_t range_count, const VkImageSubresourceRange* ranges) {
+    context->elapsed += COMMAND_COST_NS;
+    const Image* image_state = image_table.Get(image);
+    const FormatInfo* format_info = image_state ? GetFormatInfo(image_state->create_info.format) : nullptr;
+    if (!format_info || !format_info->component_count || IsColorFormat(*format_info) ||
+        format_info->block_size > MAX_CONVERTED_BLOCK_SIZE) {
+        return;
+    }
+    // Depth goes through the first channel as a float, stencil through the second as an integer
+    VkClearColorValue value = {};
+    value.float32[0] = depth_stencil.depth;
+    value.uint32[1] = depth_stencil.stencil;
+    char block[MAX_CONVERTED_BLOCK_SIZE] = {};
+    for (uint32_t i = 0; i < format_info->component_count; ++i) {
+        const FormatComponent& component = format_info->components[i];
+        WriteComponent(block, component, EncodeComponent(component, value, component.channel == FORMAT_CHANNEL_DEPTH ? 0 : 1));
+    }
+    ClearImage(image, block, range_count, ranges);
+}
+
+static void ExecuteBlitImage(ExecutionContext* context, VkImage src_image, VkImage dst_image, uint32_t region_count,
+                             const VkImageBlit* regions, VkFilter filter) {
+    for (uint32_t i = 0; i < region_count; ++i) BlitImageRegion(src_image, dst_image, regions[i], filter);
+    context->elapsed += COMMAND_COST_NS;
+}
+
+static void ExecuteResolveImage(ExecutionContext* context, VkImage src_image, VkImage dst_image, uint32_t region_count,
+                                const VkImageResolve* regions) {
+    for (uint32_t i = 0; i < region_count; ++i) ResolveImageRegion(src_image, dst_image, regions[i]);
+    context->elapsed += COMMAND_COST_NS;
+}
+
+// Shaders sample image views through textures resolved to host memory when a dispatch or draw starts. 1D and 2D
+// views, arrayed or not, of the formats clears convert can be sampled, with depth read as red. Filtering follows the
+// sampler's filters, mipmap mode, address modes, border color and LOD bias and clamps; integer formats are always
+// sampled nearest. Anisotropy, compare ops and cube maps are not implemented.
+struct ShaderTexture {
+    const FormatInfo* format_info = nullptr;  // Null without an image view, or with one that cannot be sampled
+    bool unorm8 = false;
+    bool depth = false;
+    VkComponentMapping components = {};
+    std::vector<ImageRegion> levels;  // Of the view, each with all the view's layers
+    bool has_sampler = false;
+    VkSamplerCreateInfo sampler;
+};
+
+// Samplers missing from descriptors, such as immutable ones, sample nearest texels clamped to the edge
+static const VkSamplerCreateInfo& GetDefaultSampler() {
+    static const struct DefaultSampler {
+        DefaultSampler() {
+            memset(&create_info, 0, sizeof(create_info));
+            create_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+            create_info.addressModeU = create_info.addressModeV = create_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            create_info.maxLod = VK_LOD_CLAMP_NONE;
+        }
+        VkSamplerCreateInfo create_info;
+    } sampler;
+    return sampler.create_info;
+}
+
+// Reads the depth of a texel block, 0 for formats without depth
+static float DecodeDepth(const FormatInfo& info, const char* block) {
+    for (uint32_t i = 0; i < info.component_count; ++i) {
+        const FormatComponent& component = info.components[i];
+        if (component.channel != FORMAT_CHANNEL_DEPTH) continue;
+        const uint32_t bits = ReadComponent(block, component);
+        if (component.numeric == FORMAT_NUMERIC_SFLOAT) return ShaderFloat(bits);
+        return bits / (float)((1ull << component.bits) - 1);
+    }
+    return 0.0f;
+}
+
+static void ResolveShaderTexture(VkImageView image_view, ShaderTexture* texture) {
+    const ImageView* view = image_view_table.Get(image_view);
+    if (!view) return;
+    const FormatInfo* format_info = GetFormatInfo(view->format);
+    if (!format_info || format_info->plane_count != 1 || !format_info->component_count || format_info->block_size > MAX_CONVERTED_BLOCK_SIZE ||
+        format_info->block_extent.width != 1 || format_info->block_extent.height != 1 || format_info->block_extent.depth != 1) {
+        return;
+    }
+    switch (view->view_type) {
+        case VK_IMAGE_VIEW_TYPE_1D:
+        case VK_IMAGE_VIEW_TYPE_2D:
+        case VK_IMAGE_VIEW_TYPE_1D_ARRAY:
+        case VK_IMAGE_VIEW_TYPE_2D_ARRAY:
+            break;
+        default:
+            return;
+    }
+    const bool depth = !IsColorFormat(*format_info);
+    for (uint32_t level = 0; level < view->range.levelCount; ++level) {
+        const VkImageSubresourceLayers subresource = {depth ? (VkImageAspectFlags)VK_IMAGE_ASPECT_DEPTH_BIT : (VkImageAspectFlags)VK_IMAGE_ASPECT_COLOR_BIT,
+                                                      view->range.baseMipLevel + level, view->range.baseArrayLayer, view->range.layerCount};
+        ImageRegion region;
+        if (!GetImageRegion(view->image, subresource, {0, 0, 0}, {UINT32_MAX, UINT32_MAX, 1}, &region) || region.samples != 1) break;
+        texture->levels.push_back(region);
+    }
+    if (texture->levels.empty()) return;
+    texture->format_info = format_info;
+    texture->unorm8 = IsUnorm8Format(*format_info);
+    texture->depth = depth;
+    texture->components = view->components;
+}
+
+static inline int32_t FloorTexelCoordinate(float value) {
+    if (!(value > -1e9f)) return -1000000000;  // NaN too
+    return (int32_t)std::floor(std::min(value, 1e9f));
+}
+
+// Applies an address mode to a texel coordinate, giving -1 outside the level with CLAMP_TO_BORDER
+static int32_t WrapTexelCoordinate(int32_t i, int32_t size, VkSamplerAddressMode mode) {
+    switch (mode) {
+        case VK_SAMPLER_ADDRESS_MODE_REPEAT:
+            return ((i % size) + size) % size;
+        case VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT: {
+            const int32_t t = ((i % (2 * size)) + 2 * size) % (2 * size);
+            return t < size ? t : 2 * size - 1 - t;
+        }
+        case VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE:
+            return std::min(i < 0 ? -1 - i : i, size - 1);
+        case VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER:
+            return i < 0 || i >= size ? -1 : i;
+        default:
+            return std::min(std::max(i, 0), size - 1);
+    }
+}
+
+static void ReadTexture(const ShaderTexture& texture, const ImageRegion& level, const char* block, VkClearColorValue* color) {
+    const FormatInfo& info = *texture.format_info;
+    if (texture.unorm8) {
+        color->float32[0] = color->float32[1] = color->float32[2] = 0.0f;
+        color->float32[3] = 1.0f;
+        for (uint32_t i = 0; i < info.component_count; ++i) {
+            color->float32[info.components[i].channel] = (uint8_t)block[info.components[i].offset / 8] * (1.0f / 255.0f);
+        }
+    } else if (texture.depth) {
+        color->float32[0] = DecodeDepth(info, block);
+        color->float32[1] = color->float32[2] = 0.0f;
+        color->float32[3] = 1.0f;
+    } else {
+        DecodeTexel(info, block, color);
+    }
+}
+
+// Reads a texel of a level, or the sampler's border color outside it with CLAMP_TO_BORDER
+static void ReadTexel(const ShaderTexture& texture, const ImageRegion& level, const VkSamplerCreateInfo& sampler, int32_t x, int32_t y,
+                      uint32_t layer, VkClearColorValue* color) {
+    x = WrapTexelCoordinate(x, (int32_t)level.blocks_x, sampler.addressModeU);
+    y = WrapTexelCoordinate(y, (int32_t)level.blocks_y, sampler.addressModeV);
+    if (x < 0 || y < 0) {
+        const bool integer = IsIntegerFormat(*texture.format_info);
+        const bool opaque = sampler.borderColor >= VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+        const bool white = sampler.borderColor >= VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+        for (uint32_t c = 0; c < 4; ++c) {
+            const bool one = c == 3 ? opaque : white;
+            color->uint32[c] = one ? (integer ? 1 : ShaderBits(1.0f)) : 0;
+        }
+        return;
+    }
+    const char* block = level.data + layer * level.slice_pitch + (VkDeviceSize)y * level.row_pitch + (VkDeviceSize)x * level.block_size;
+    ReadTexture(texture, level, block, color);
+}
+
+// Filters a level at coordinates normalized unless the sampler says otherwise
+static void FilterTexture(const ShaderTexture& texture, uint32_t level_index, const VkSamplerCreateInfo& sampler, VkFilter filter,
+                          uint32_t dimensions, const float* coordinates, uint32_t layer, const int32_t* offset, VkClearColorValue* color) {
+    const ImageRegion& level = texture.levels[level_index];
+    float u = coordinates[0];
+    float v = dimensions > 1 ? coordinates[1] : 0.0f;
+    if (!sampler.unnormalizedCoordinates) {
+        u *= level.blocks_x;
+        v *= level.blocks_y;
+    }
+    if (filter == VK_FILTER_NEAREST || IsIntegerFormat(*texture.format_info)) {
+        ReadTexel(texture, level, sampler, FloorTexelCoordinate(u) + offset[0], dimensions > 1 ? FloorTexelCoordinate(v) + offset[1] : 0,
+                  layer, color);
+        return;
+    }
+    u -= 0.5f;
+    v -= 0.5f;
+    const int32_t x = FloorTexelCoordinate(u) + offset[0];
+    const int32_t y = dimensions > 1 ? FloorTexelCoordinate(v) + offset[1] : 0;
+    const float a = u - std::floor(u);
+    const float b = dimensions > 1 ? v - std::floor(v) : 0.0f;
+    VkClearColorValue texels[4];
+    ReadTexel(texture, level, sampler, x, y, layer, &texels[0]);
+    ReadTexel(texture, level, sampler, x + 1, y, layer, &texels[1]);
+    if (dimensions > 1) {
+        ReadTexel(texture, level, sampler, x, y + 1, layer, &texels[2]);
+        ReadTexel(texture, level, sampler, x + 1, y + 1, layer, &texels[3]);
+    } else {
+        texels[2] = texels[0];
+        texels[3] = texels[1];
+    }
+    for (uint32_t c = 0; c < 4; ++c) {
+        const float top = texels[0].float32[c] + (texels[1].float32[c] - texels[0].float32[c]) * a;
+        const float bottom = texels[2].float32[c] + (texels[3].float32[c] - texels[2].float32[c]) * a;
+        color->float32[c] = top + (bottom - top) * b;
+    }
+}
+
+static void SwizzleColor(const VkComponentMapping& mapping, bool integer, VkClearColorValue* color) {
+    const VkClearColorValue source = *color;
+    const VkComponentSwizzle swizzles[4] = {mapping.r, mapping.g, mapping.b, mapping.a};
+    for (uint32_t c = 0; c < 4; ++c) {
+        switch (swizzles[c]) {
+            case VK_COMPONENT_SWIZZLE_ZERO: color->uint32[c] = 0; break;
+            case VK_COMPONENT_SWIZZLE_ONE: color->uint32[c] = integer ? 1 : ShaderBits(1.0f); break;
+            case VK_COMPONENT_SWIZZLE_R:
+            case VK_COMPONENT_SWIZZLE_G:
+            case VK_COMPONENT_SWIZZLE_B:
+            case VK_COMPONENT_SWIZZLE_A: color->uint32[c] = source.uint32[swizzles[c] - VK_COMPONENT_SWIZZLE_R]; break;
+            default: break;
+        }
+    }
+}
+
+// Samples a texture at a level of detail, before the sampler's bias and clamps
+static void SampleTexture(const ShaderTexture& texture, const VkSamplerCreateInfo& sampler, uint32_t dimensions, bool arrayed,
+                          const float* coordinates, float lambda, const int32_t* offset, VkClearColorValue* color) {
+    const uint32_t layer = arrayed ? (uint32_t)ClampRound(coordinates[dimensions], 0, texture.levels[0].slices - 1) : 0;
+    lambda = std::fmin(std::fmax(lambda + sampler.mipLodBias, sampler.minLod), sampler.maxLod);
+    const VkFilter filter = lambda > 0.0f ? sampler.minFilter : sampler.magFilter;
+    const float level = std::max(lambda, 0.0f);
+    const float last = (float)(texture.levels.size() - 1);
+    const bool integer = IsIntegerFormat(*texture.format_info);
+    if (sampler.mipmapMode == VK_SAMPLER_MIPMAP_MODE_NEAREST || integer) {
+        const uint32_t index = level <= 0.5f ? 0 : (uint32_t)std::min(std::ceil(level + 0.5f) - 1.0f, last);
+        FilterTexture(texture, index, sampler, filter, dimensions, coordinates, layer, offset, color);
+    } else {
+        const float first = std::min(std::floor(level), last);
+        const float weight = first < last ? level - first : 0.0f;
+        FilterTexture(texture, (uint32_t)first, sampler, filter, dimensions, coordinates, layer, offset, color);
+        if (weight > 0.0f) {
+            VkClearColorValue next;
+            FilterTexture(texture, (uint32_t)first + 1, sampler, filter, dimensions, coordinates, layer, offset, &next);
+            for (uint32_t c = 0; c < 4; ++c) color->float32[c] += (next.float32[c] - color->float32[c]) * weight;
+        }
+    }
+    SwizzleColor(texture.components, integer, color);
+}
+
+// Texel fetches read a level at integer coordinates, 0 outside it
+static void FetchTexture(const ShaderTexture& texture, uint32_t dimensions, bool arrayed, const int32_t* coordinates, int32_t lod,
+                         VkClearColorValue* color) {
+    memset(color, 0, sizeof(*color));
+    if (lod < 0 || (uint32_t)lod >= texture.levels.size()) return;
+    const ImageRegion& level = texture.levels[lod];
+    const int32_t x = coordinates[0];
+    const int32_t y = dimensions > 1 ? coordinates[1] : 0;
+    const int32_t layer = arrayed ? coordinates[dimensions] : 0;
+    if (x < 0 || y < 0 || layer < 0 || (uint32_t)x >= level.blocks_x || (uint32_t)y >= level.blocks_y || (uint32_t)layer >= level.slices) return;
+    ReadTexture(texture, level, level.data + layer * level.slice_pitch + (VkDeviceSize)y * level.row_pitch + (VkDeviceSize)x * level.block_size,
+                color);
+    SwizzleColor(texture.components, IsIntegerFormat(*texture.format_info), color);
+}
+
+// Sampled images hold the texture index plus one of their image and of their sampler. Implicit LODs come from the
+// coarse derivatives of the coordinates in the lane's quad, and are 0 outside fragment shaders.
+void ShaderInvocations::Sample(const ShaderInstruction& instruction, LaneMask active) {
+    const uint32_t operands = instruction.aux[0];
+    const uint32_t dimensions = instruction.aux[1] & 0xff;
+    const bool arrayed = (instruction.aux[1] & SHADER_IMAGE_ARRAYED) != 0;
+    const bool fetch = instruction.op == SPIRV_OP_IMAGE_FETCH;
+    const uint32_t* image = OperandRegister(instruction, 0);
+    const uint32_t* coordinates = OperandRegister(instruction, 1);
+    const uint32_t coordinate_count = Components(program_.value_types[Operand(instruction, 1)]);
+    // Optional operands follow the mask in the order of its bits
+    const uint32_t* bias = nullptr;
+    const uint32_t* lod = nullptr;
+    const uint32_t* gradients[2] = {};
+    const uint32_t* offset = nullptr;
+    uint32_t next = 3;
+    if (operands & SPIRV_IMAGE_OPERANDS_BIAS) bias = FindRegister(instruction, next++);
+    if (operands & SPIRV_IMAGE_OPERANDS_LOD) lod = FindRegister(instruction, next++);
+    if (operands & SPIRV_IMAGE_OPERANDS_GRAD) {
+        gradients[0] = FindRegister(instruction, next++);
+        gradients[1] = FindRegister(instruction, next++);
+    }
+    if (operands & (SPIRV_IMAGE_OPERANDS_CONST_OFFSET | SPIRV_IMAGE_OPERANDS_OFFSET)) offset = FindRegister(instruction, next++);
+    const bool implicit = instruction.op == SPIRV_OP_IMAGE_SAMPLE_IMPLICIT_LOD && !gradients[0] &&
+                          program_.execution_model == SPIRV_EXECUTION_MODEL_FRAGMENT;
+    uint32_t* result = scratch_.data();
+    for (uint32_t l = 0; l < SHADER_LANES; ++l) {
+        VkClearColorValue color = {};
+        const uint32_t texture_index = image[l] - 1;
+        if ((active >> l & 1) && texture_index < texture_count_ && textures_[texture_index].format_info) {
+            const ShaderTexture& texture = textures_[texture_index];
+            float position[3] = {};
+            int32_t texel[3] = {};
+            int32_t texel_offset[2] = {};
+            for (uint32_t c = 0; c < 3 && c < coordinate_count; ++c) {
+                position[c] = ShaderFloat(coordinates[c * SHADER_LANES + l]);
+                texel[c] = (int32_t)coordinates[c * SHADER_LANES + l];
+            }
+            for (uint32_t c = 0; offset && c < dimensions; ++c) texel_offset[c] = (int32_t)offset[c * SHADER_LANES + l];
+            if (fetch) {
+                FetchTexture(texture, dimensions, arrayed, texel, lod ? (int32_t)lod[l] : 0, &color);
+            } else {
+                const uint32_t sampler_index = image[SHADER_LANES + l] - 1;
+                const VkSamplerCreateInfo& sampler = sampler_index < texture_count_ && textures_[sampler_index].has_sampler
+                                                         ? textures_[sampler_index].sampler
+                                                         : GetDefaultSampler();
+                // Scale of texels per unit of the derivatives, 1 for unnormalized coordinates
+                const float scale[2] = {sampler.unnormalizedCoordinates ? 1.0f : (float)texture.levels[0].blocks_x,
+                                        sampler.unnormalizedCoordinates ? 1.0f : (float)texture.levels[0].blocks_y};
+                float lambda = 0.0f;
+                if (lod) {
+                    lambda = ShaderFloat(lod[l]);
+                } else if (gradients[0] || implicit) {
+                    float rho[2] = {};
+                    for (uint32_t d = 0; d < 2; ++d) {
+                        for (uint32_t c = 0; c < dimensions; ++c) {
+                            const uint32_t* value = coordinates + c * SHADER_LANES;
+                            const uint32_t quad = l & ~3u;
+                            const float derivative = gradients[0] ? ShaderFloat(gradients[d][c * SHADER_LANES + l])
+                                                                  : ShaderFloat(value[quad + 1 + d]) - ShaderFloat(value[quad]);
+                            rho[d] += derivative * scale[c] * derivative * scale[c];
+                        }
+                    }
+                    lambda = 0.5f * std::log2(std::max(rho[0], rho[1]));
+                }
+                if (bias) lambda += ShaderFloat(bias[l]);
+                SampleTexture(texture, sampler, dimensions, arrayed, position, lambda, texel_offset, &color);
+            }
+        }
+        for (uint32_t c = 0; c < 4; ++c) result[c * SHADER_LANES + l] = color.uint32[c];
+    }
+    Commit(instruction.result, result, 4);
+}
+
+// What the descriptors of a program are bound to. Buffer descriptors get regions of their buffers, left null like the
+// ranges that do not fit in their buffer or its memory. Image and sampler descriptors get regions holding the index
+// plus one of their texture twice, where loading an image, a sampler or a combined image sampler finds it.
+struct ShaderBindings {
+    std::vector<ShaderRegion> regions;
+    std::vector<ShaderTexture> textures;
+    std::vector<uint32_t> texture_indices;  // Backing the regions of image and sampler descriptors
+};
+
+static void GetShaderBindings(BindPointState* state, const ShaderProgram& program, ShaderBindings* bindings) {
+    std::vector<ShaderRegion>& regions = bindings->regions;
+    regions.assign(program.region_count, ShaderRegion{nullptr, 0});
+    regions[SHADER_PUSH_CONSTANT_REGION] = {state->push_constants, sizeof(state->push_constants)};
+    size_t index_count = 0;
+    for (const auto& descriptor : program.descriptors) {
+        if (descriptor.image) index_count += 2 * (size_t)descriptor.count;
+    }
+    // Regions point into the indices, which must not move
+    bindings->texture_indices.reserve(index_count);
+    for (const auto& descriptor : program.descriptors) {
+        if (descriptor.set >= MAX_BOUND_DESCRIPTOR_SETS || !state->sets[descriptor.set].set) continue;
+        const BoundDescriptorSet& bound = state->sets[descriptor.set];
+        const DescriptorSet& set = *bound.set;
+        if (descriptor.binding >= set.layout->bindings.size()) continue;
+        const DescriptorLayoutBinding& binding = set.layout->bindings[descriptor.binding];
+        const Descriptor* descriptors = set.descriptors + binding.first;
+        const uint32_t count = std::min(descriptor.count, GetBindingCount(set, descriptor.binding));
+        for (uint32_t i = 0; descriptor.image && IsImageDescriptor(binding.type) && i < count; ++i) {
+            ShaderTexture texture;
+            if (binding.type != VK_DESCRIPTOR_TYPE_SAMPLER) ResolveShaderTexture(descriptors[i].image.imageView, &texture);
+            const Sampler* sampler = binding.type != VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE ? sampler_table.Get(descriptors[i].image.sampler) : nullptr;
+            if (sampler) {
+                texture.has_sampler = true;
+                texture.sampler = sampler->create_info;
+            }
+            bindings->textures.push_back(std::move(texture));
+            bindings->texture_indices.push_back((uint32_t)bindings->textures.size());
+            bindings->texture_indices.push_back((uint32_t)bindings->textures.size());
+            regions[descriptor.region + i] = {reinterpret_cast<char*>(&bindings->texture_indices.back() - 1), 2 * sizeof(uint32_t)};
+        }
+        const bool dynamic = IsDynamicBufferDescriptor(binding.type);
+        for (uint32_t i = 0; !descriptor.image && IsBufferDescriptor(binding.type) && i < count; ++i) {
+            const VkDescriptorBufferInfo& info = descriptors[i].buffer;
+            const Buffer* buffer = buffer_table.Get(info.buffer);
+            VkDeviceSize offset = info.offset;
+            if (dynamic && binding.dynamic + i < bound.dynamic_offsets.size()) offset += bound.dynamic_offsets[binding.dynamic + i];
+            if (!buffer || offset > buffer->create_info.size) continue;
+            const VkDeviceSize size = info.range == VK_WHOLE_SIZE ? buffer->create_info.size - offset : info.range;
+            if (char* data = GetBufferData(info.buffer, offset, size)) regions[descriptor.region + i] = {data, size};
+        }
+    }
+}
+
+// Dispatches run the program of the bound pipeline, when it has one, and are charged by the cost model either way
+static void ExecuteDispatch(ExecutionContext* context, const uint32_t base[3], const uint32_t group_count[3]) {
+    const uint64_t workgroups = (uint64_t)group_count[0] * group_count[1] * group_count[2];
+    const ShaderProgram* program = context->compute.program.get();
+    const uint64_t invocations =
+        program ? (uint64_t)program->local_size[0] * program->local_size[1] * program->local_size[2] : INVOCATIONS_PER_WORKGROUP;
+    context->counters[COUNTER_COMPUTE_SHADER_INVOCATIONS] += workgroups * invocations;
+    context->elapsed += COMMAND_COST_NS + workgroups * WORKGROUP_COST_NS;
+    if (!program) return;
+    ShaderBindings bindings;
+    GetShaderBindings(&context->compute, *program, &bindings);
+    RunWorkgroups(*program, bindings.regions, bindings.textures.data(), (uint32_t)bindings.textures.size(), base, group_count);
+}
+
+static void ExecuteDispatchIndirect(ExecutionContext* context, VkBuffer buffer, VkDeviceSize offset) {
+    VkDispatchIndirectCommand command = {};
+    if (const char* data = GetBufferData(buffer, offset, sizeof(command))) memcpy(&command, data, sizeof(command));
+    const uint32_t base[3] = {0, 0, 0};
+    const uint32_t group_count[3] = {command.x, command.y, command.z};
+    ExecuteDispatch(context, base, group_count);
+}
+
+// Draws in render passes are rasterized by mock_icd_raster.cpp, with the front end below resolving what they use to
+// host memory and shading their vertices
+
+// Fragment shader bindings of a draw, with the copy of the push constants their push constant region points to
+struct RasterBindings {
+    ShaderBindings bindings;
+    char push_constants[MAX_PUSH_CONSTANTS_SIZE];
+};
+
+// Vertex attribute read by a location of the vertex shader, resolved to the bound vertex buffer
+struct RasterVertexInput {
+    uint32_t offset;  // Of the location in the vertex invocation's memory
+    uint32_t size;
+    const FormatInfo* format_info;
+    const char* data;  // Vertex buffer from its bound offset on
+    VkDeviceSize data_size;
+    uint32_t attribute_offset;
+    uint32_t stride;
+    bool per_instance;
+};
+
+static void ResolveRasterAttachment(VkImageView image_view, RasterAttachment* attachment) {
+    const ImageView* view = image_view_table.Get(image_view);
+    const FormatInfo* format_info = view ? GetFormatInfo(view->format) : nullptr;
+    if (!format_info || format_info->plane_count != 1 || !format_info->component_count || format_info->block_size > MAX_CONVERTED_BLOCK_SIZE ||
+        format_info->block_extent.width != 1 || format_info->block_extent.height != 1 || format_info->block_extent.depth != 1) {
+        return;
+    }
+    const bool color = IsColorFormat(*format_info);
+    const VkImageSubresourceLayers subresource = {color ? (VkImageAspectFlags)VK_IMAGE_ASPECT_COLOR_BIT : (VkImageAspectFlags)VK_IMAGE_ASPECT_DEPTH_BIT,
+                                                  view->range.baseMipLevel, view->range.baseArrayLayer, 1};
+    ImageRegion region;
+    if (!GetImageRegion(view->image, subresource, {0, 0, 0}, {UINT32_MAX, UINT32_MAX, 1}, &region) || region.samples != 1 ||
+        region.block_size != format_info->block_size) {
+        return;
+    }
+    attachment->data = region.data;
+    attachment->row_pitch = region.row_pitch;
+    attachment->texel_size = region.block_size;
+    attachment->width = region.blocks_x;
+    attachment->height = region.blocks_y;
+    if (color) {
+        const FormatNumeric numeric = format_info->components[0].numeric;
+        if (numeric == FORMAT_NUMERIC_UNORM || numeric == FORMAT_NUMERIC_SRGB) attachment->low = 0.0f;
+        if (numeric == FORMAT_NUMERIC_SNORM) attachment->low = -1.0f;
+        if (numeric == FORMAT_NUMERIC_UNORM || numeric == FORMAT_NUMERIC_SRGB || numeric == FORMAT_NUMERIC_SNORM) attachment->high = 1.0f;
+        attachment->unorm8 = IsUnorm8Format(*format_info);
+        attachment->integer = IsIntegerFormat(*format_info);
+    } else {
+        for (uint32_t i = 0; i < format_info->component_count; ++i) {
+            if (format_info->components[i].channel == FORMAT_CHANNEL_DEPTH) attachment->depth = &format_info->components[i];
+        }
+        // Stencil only formats are left alone
+        if (!attachment->depth) return;
+        if (attachment->depth->numeric == FORMAT_NUMERIC_UNORM) {
+            attachment->low = 0.0f;
+            attachment->high = 1.0f;
+        }
+    }
+    attachment->format_info = format_info;
+}
+
+// Conversions of the rows of texels tiles load and store, for the attachments resolved above
+void LoadRasterColors(const RasterAttachment& attachment, const char* texels, uint32_t count, VkClearColorValue* colors) {
+    const FormatInfo& info = *attachment.format_info;
+    for (uint32_t x = 0; x < count; ++x, texels += info.block_size) {
+        VkClearColorValue& value = colors[x];
+        if (attachment.unorm8) {
+            value.float32[0] = value.float32[1] = value.float32[2] = 0.0f;
+            value.float32[3] = 1.0f;
+            for (uint32_t i = 0; i < info.component_count; ++i) {
+                value.float32[info.components[i].channel] = (uint8_t)texels[info.components[i].offset / 8] * (1.0f / 255.0f);
+            }
+        } else {
+            DecodeTexel(info, texels, &value);
+        }
+    }
+}
+
+void StoreRasterColors(const RasterAttachment& attachment, const VkClearColorValue* colors, uint32_t count, char* texels) {
+    const FormatInfo& info = *attachment.format_info;
+    for (uint32_t x = 0; x < count; ++x, texels += info.block_size) {
+        if (attachment.unorm8) {
+            for (uint32_t i = 0; i < info.component_count; ++i) {
+                texels[info.components[i].offset / 8] = (char)ClampRound(colors[x].float32[info.components[i].channel] * 255.0, 0, 255);
+            }
+        } else {
+            EncodeTexel(info, colors[x], texels);
+        }
+    }
+}
+
+void LoadRasterDepths(const RasterAttachment& attachment, const char* texels, uint32_t count, float* depths) {
+    for (uint32_t x = 0; x < count; ++x, texels += attachment.texel_size) depths[x] = DecodeDepth(*attachment.format_info, texels);
+}
+
+void StoreRasterDepths(const RasterAttachment& attachment, const float* depths, uint32_t count, char* texels) {
+    const FormatComponent& component = *attachment.depth;
+    for (uint32_t x = 0; x < count; ++x, texels += attachment.texel_size) {
+        VkClearColorValue value;
+        value.float32[0] = depths[x];
+        WriteComponent(texels, component, EncodeComponent(component, value, 0));
+    }
+}
+
+static void ExecuteBeginRenderPass(ExecutionContext* context, const VkRenderPassBeginInfo& begin_info) {
+    context->render_pass.reset();
+    if (!GetRasterizationEnabled()) return;
+    const RenderPass* render_pass = render_pass_table.Get(begin_info.renderPass);
+    const Framebuffer* framebuffer = framebuffer_table.Get(begin_info.framebuffer);
+    if (!render_pass || !framebuffer || render_pass->subpasses.empty()) return;
+    std::shared_ptr<RenderPassInstance> instance(new RenderPassInstance());
+    instance->render_area = {{0, 0}, {framebuffer->width, framebuffer->height}};
+    if (!ClipToRenderArea(*instance, begin_info.renderArea, &instance->render_area)) return;
+    instance->render_pass = *render_pass;
+    instance->attachments.resize(render_pass->attachments.size());
+    for (size_t i = 0; i < instance->attachments.size() && i < framebuffer->attachments.size(); ++i) {
+        RasterAttachment& attachment = instance->attachments[i];
+        if (begin_info.pClearValues && i < begin_info.clearValueCount) attachment.clear_value = begin_info.pClearValues[i];
+        ResolveRasterAttachment(framebuffer->attachments[i], &attachment);
+    }
+    const VkRect2D& area = instance->render_area;
+    instance->tiles_x = DivideRoundingUp(area.offset.x + area.extent.width, RASTER_TILE_SIZE);
+    instance->tiles_y = DivideRoundingUp(area.offset.y + area.extent.height, RASTER_TILE_SIZE);
+    instance->bins.resize((size_t)instance->tiles_x * instance->tiles_y);
+    context->render_pass = std::move(instance);
+}
+
+static void ExecuteClearAttachments(ExecutionContext* context, uint32_t attachment_count, const VkClearAttachment* attachments,
+                                    uint32_t rect_count, const VkClearRect* rects) {
+    RenderPassInstance* instance = context->render_pass.get();
+    if (!instance) return;
+    const RenderSubpass& subpass = instance->render_pass.subpasses[instance->subpass];
+    for (uint32_t i = 0; i < attachment_count; ++i) {
+        const VkClearAttachment& attachment = attachments[i];
+        RasterClear clear;
+        clear.value = attachment.clearValue;
+        if (attachment.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT) {
+            if (attachment.colorAttachment >= subpass.colors.size() || subpass.colors[attachment.colorAttachment] == VK_ATTACHMENT_UNUSED) continue;
+            clear.color = attachment.colorAttachment;
+        } else if ((attachment.aspectMask & VK_IMAGE_ASPECT_DEPTH_BIT) && subpass.depth_stencil != VK_ATTACHMENT_UNUSED) {
+            clear.color = UINT32_MAX;
+        } else {
+            continue;
+        }
+        for (uint32_t r = 0; r < rect_count; ++r) {
+            if (rects[r].baseArrayLayer != 0 || rects[r].layerCount == 0 || !ClipToRenderArea(*instance, rects[r].rect, &clear.rect)) continue;
+            AddRasterClear(instance, clear);
+        }
+    }
+}
+
+// Shades the vertices of a draw and bins its triangles, for the tiles to render at the end of the subpass
+static void RasterizeDraw(ExecutionContext* context, bool indexed, uint32_t count, uint32_t instance_count, uint32_t first,
+                          int32_t vertex_offset, uint32_t first_instance, uint32_t draw_index) {
+    RenderPassInstance* instance = context->render_pass.get();
+    const DrawState& state = context->draw;
+    const RasterPipeline* pipeline = state.pipeline.get();
+    const uint64_t vertex_count = (uint64_t)count * instance_count;
+    if (!instance || !pipeline || pipeline->discard || vertex_count == 0 || vertex_count > RASTER_MAX_VERTICES) return;
+    RasterSetup setup;
+    setup.viewport = pipeline->dynamic_viewport ? state.viewport : pipeline->viewport;
+    VkRect2D scissor;
+    if (setup.viewport.width == 0.0f || setup.viewport.height == 0.0f ||
+        !ClipToRenderArea(*instance, pipeline->dynamic_scissor ? state.scissor : pipeline->scissor, &scissor)) {
+        return;
+    }
+    setup.guard[0] = std::max(1.0, 2.0 * RASTER_GUARD_BAND / std::fabs(setup.viewport.width));
+    setup.guard[1] = std::max(1.0, 2.0 * RASTER_GUARD_BAND / std::fabs(setup.viewport.height));
+    setup.bounds[0] = scissor.offset.x;
+    setup.bounds[1] = scissor.offset.y;
+    setup.bounds[2] = scissor.offset.x + (int32_t)scissor.extent.width;
+    setup.bounds[3] = scissor.offset.y + (int32_t)scissor.extent.height;
+    setup.cull_mode = pipeline->cull_mode;
+    setup.counter_clockwise = pipeline->front_face == VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    setup.depth_clamp = pipeline->depth_clamp;
+
+    // Vertex indices, with primitive restarts marked
+    std::vector<uint32_t> indices(count);
+    std::vector<bool> restarts;
+    if (indexed) {
+        const uint32_t index_size = state.index_type == VK_INDEX_TYPE_UINT16 ? 2 : state.index_type == VK_INDEX_TYPE_UINT32 ? 4 : 0;
+        const char* data = index_size ? GetBufferData(state.index_buffer, state.index_offset + (VkDeviceSize)first * index_size,
+                                                      (VkDeviceSize)count * index_size)
+                                      : nullptr;
+        if (!data) return;
+        restarts.resize(count);
+        const uint32_t restart_index = index_size == 2 ? 0xFFFF : 0xFFFFFFFF;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t index = 0;
+            memcpy(&index, data + (size_t)i * index_size, index_size);
+            restarts[i] = pipeline->primitive_restart && index == restart_index;
+            indices[i] = restarts[i] ? 0 : index + (uint32_t)vertex_offset;
+        }
+    } else {
+        for (uint32_t i = 0; i < count; ++i) indices[i] = first + i;
+    }
+
+    const uint64_t vertex_start = GetDeviceTimestamp();
+    const ShaderProgram& vertex_program = *pipeline->vertex;
+    const ShaderProgram* fragment_program = pipeline->fragment.get();
+    std::unique_ptr<RasterDraw> draw(new RasterDraw());
+    draw->pipeline = state.pipeline;
+    uint32_t position = UINT32_MAX;
+    for (const auto& entry : vertex_program.interface) {
+        if (entry.storage_class == SPIRV_STORAGE_CLASS_OUTPUT && entry.built_in == SPIRV_BUILT_IN_POSITION && entry.size >= 16) position = entry.offset;
+    }
+    if (position == UINT32_MAX) return;
+    // Fragment inputs with a location come from the vertex shader output with the same location, or are 0 without one
+    struct VaryingSource {
+        uint32_t offset;  // In the vertex invocation's memory, UINT32_MAX without an output
+        uint32_t word;
+        uint32_t words;
+    };
+    std::vector<VaryingSource> sources;
+    static const std::vector<ShaderInterface> no_interface;
+    for (const auto& entry : fragment_program ? fragment_program->interface : no_interface) {
+        if (entry.storage_class == SPIRV_STORAGE_CLASS_OUTPUT) {
+            if (entry.built_in == SPIRV_BUILT_IN_FRAG_DEPTH) draw->frag_depth = entry.offset;
+            if (entry.location != UINT32_MAX) draw->outputs.push_back({entry.offset, std::min(entry.size, 16u), entry.location});
+            continue;
+        }
+        RasterVarying varying = {entry.offset, entry.built_in, draw->vertex_size, entry.size / 4, entry.interpolation};
+        if (entry.location != UINT32_MAX) {
+            VaryingSource source = {UINT32_MAX, draw->vertex_size, varying.words};
+            for (const auto& output : vertex_program.interface) {
+                if (output.storage_class != SPIRV_STORAGE_CLASS_OUTPUT || output.location != entry.location) continue;
+                source.offset = output.offset;
+                source.words = std::min(output.size, entry.size) / 4;
+            }
+            sources.push_back(source);
+            draw->vertex_size += varying.words;
+        }
+        draw->varyings.push_back(varying);
+    }
+    draw->late_depth = fragment_program && !fragment_program->early_fragment_tests && (fragment_program->discards || draw->frag_depth != UINT32_MAX);
+    memcpy(draw->blend_constants, pipeline->dynamic_blend_constants ? state.blend_constants : pipeline->blend_constants, sizeof(draw->blend_constants));
+    draw->min_depth = std::min(setup.viewport.minDepth, setup.viewport.maxDepth);
+    draw->max_depth = std::max(setup.viewport.minDepth, setup.viewport.maxDepth);
+    if (fragment_program) {
+        std::shared_ptr<RasterBindings> bindings(new RasterBindings());
+        memcpy(bindings->push_constants, context->graphics.push_constants, sizeof(bindings->push_constants));
+        GetShaderBindings(&context->graphics, *fragment_program, &bindings->bindings);
+        bindings->bindings.regions[SHADER_PUSH_CONSTANT_REGION] = {bindings->push_constants, sizeof(bindings->push_constants)};
+        draw->regions = bindings->bindings.regions;
+        draw->textures = bindings->bindings.textures.data();
+        draw->texture_count = (uint32_t)bindings->bindings.textures.size();
+        draw->bindings = std::move(bindings);
+    }
+
+    // Vertex attributes, those outside their buffer read as 0
+    std::vector<RasterVertexInput> inputs;
+    for (const auto& attribute : pipeline->attributes) {
+        const FormatInfo* format_info = GetFormatInfo(attribute.format);
+        if (!format_info || !format_info->component_count || format_info->plane_count != 1 || format_info->block_size > MAX_CONVERTED_BLOCK_SIZE ||
+            attribute.binding >= MAX_BOUND_VERTEX_BUFFERS) {
+            continue;
+        }
+        const VkVertexInputBindingDescription* binding = nullptr;
+        for (const auto& description : pipeline->bindings) {
+            if (description.binding == attribute.binding) binding = &description;
+        }
+        const Buffer* buffer = buffer_table.Get(state.vertex_buffers[attribute.binding]);
+        const VkDeviceSize offset = state.vertex_offsets[attribute.binding];
+        if (!binding || !buffer || offset >= buffer->create_info.size) continue;
+        const VkDeviceSize size = buffer->create_info.size - offset;
+        const char* data = GetBufferData(state.vertex_buffers[attribute.binding], offset, size);
+        for (const auto& entry : vertex_program.interface) {
+            if (!data || entry.storage_class != SPIRV_STORAGE_CLASS_INPUT || entry.location != attribute.location) continue;
+            inputs.push_back({entry.offset, std::min(entry.size, 16u), format_info, data, size, attribute.offset, binding->stride,
+                              binding->inputRate == VK_VERTEX_INPUT_RATE_INSTANCE});
+        }
+    }
+    ShaderBindings vertex_bindings;
+    GetShaderBindings(&context->graphics, vertex_program, &vertex_bindings);
+    draw->vertices.resize(vertex_count * draw->vertex_size);
+    std::vector<std::unique_ptr<ShaderInvocations>> invocations(compute_pool.GetThreadCount());
+    compute_pool.Run((vertex_count + RASTER_VERTEX_BATCH - 1) / RASTER_VERTEX_BATCH, [&](uint32_t thread, uint64_t batch) {
+        if (!invocations[thread]) {
+            invocations[thread].reset(new ShaderInvocations(&vertex_program, vertex_bindings.regions, vertex_bindings.textures.data(),
+                                                            (uint32_t)vertex_bindings.textures.size()));
+        }
+        ShaderInvocations* shader = invocations[thread].get();
+        const uint64_t begin = batch * RASTER_VERTEX_BATCH;
+        const uint32_t batch_size = (uint32_t)std::min<uint64_t>(RASTER_VERTEX_BATCH, vertex_count - begin);
+        shader->Begin(batch_size);
+        for (uint32_t i = 0; i < batch_size; ++i) {
+            const uint32_t instance_index = first_instance + (uint32_t)((begin + i) / count);
+            const uint32_t vertex_index = indices[(begin + i) % count];
+            char* memory = shader->GetInvocationMemory(i);
+            for (const auto& input : inputs) {
+                VkClearColorValue value = {};
+                const VkDeviceSize address = input.attribute_offset + (VkDeviceSize)(input.per_instance ? instance_index : vertex_index) * input.stride;
+                if (address < input.data_size && input.format_info->block_size <= input.data_size - address) {
+                    DecodeTexel(*input.format_info, input.data + address, &value);
+                }
+                memcpy(memory + input.offset, &value, input.size);
+            }
+            for (const auto& entry : vertex_program.interface) {
+                uint32_t value;
+                switch (entry.storage_class == SPIRV_STORAGE_CLASS_INPUT ? entry.built_in : SPIRV_BUILT_IN_NONE) {
+                    case SPIRV_BUILT_IN_VERTEX_INDEX: value = vertex_index; break;
+                    case SPIRV_BUILT_IN_INSTANCE_INDEX: value = instance_index; break;
+                    case SPIRV_BUILT_IN_BASE_VERTEX: value = indexed ? (uint32_t)vertex_offset : first; break;
+                    case SPIRV_BUILT_IN_BASE_INSTANCE: value = first_instance; break;
+                    case SPIRV_BUILT_IN_DRAW_INDEX: value = draw_index; break;
+                    default: continue;
+                }
+                memcpy(memory + entry.offset, &value, sizeof(value));
+            }
+        }
+        shader->Run();
+        for (uint32_t i = 0; i < batch_size; ++i) {
+            const char* memory = shader->GetInvocationMemory(i);
+            uint32_t* vertex = &draw->vertices[(begin + i) * draw->vertex_size];
+            memcpy(vertex, memory + position, RASTER_POSITION_WORDS * sizeof(uint32_t));
+            for (const auto& source : sources) {
+                if (source.offset != UINT32_MAX) memcpy(vertex + source.word, memory + source.offset, source.words * sizeof(uint32_t));
+                if (source.offset == UINT32_MAX) memset(vertex + source.word, 0, source.words * sizeof(uint32_t));
+            }
+        }
+    });
+    invocations.clear();
+    const uint64_t binning_start = GetDeviceTimestamp();
+    raster_stats.vertex_ns += binning_start - vertex_start;
+
+    // Triangles in the order of the spec's primitive topologies, each starting with its provoking vertex
+    const uint32_t index = (uint32_t)instance->draws.size();
+    std::vector<uint32_t> polygon;
+    for (uint32_t instance_index = 0; instance_index < instance_count; ++instance_index) {
+        const uint32_t base = instance_index * count;
+        uint32_t start = 0;  // First vertex since the last restart
+        for (uint32_t i = 0; i < count; ++i) {
+            if (indexed && restarts[i]) {
+                start = i + 1;
+                continue;
+            }
+            const uint32_t n = i - start + 1;
+            uint32_t vertices[3];
+            if (pipeline->topology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST) {
+                if (n % 3) continue;
+                vertices[0] = i - 2, vertices[1] = i - 1, vertices[2] = i;
+            } else if (pipeline->topology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP) {
+                if (n < 3) continue;
+                vertices[0] = i - 2, vertices[1] = n % 2 ? i - 1 : i, vertices[2] = n % 2 ? i : i - 1;
+            } else {
+                if (n < 3) continue;
+                vertices[0] = i - 1, vertices[1] = i, vertices[2] = start;
+            }
+            for (uint32_t v = 0; v < 3; ++v) vertices[v] += base;
+            AddRasterTriangle(instance, draw.get(), index, setup, vertices, &polygon);
+        }
+    }
+    instance->draws.push_back(std::move(draw));
+    raster_stats.draws++;
+    raster_stats.binning_ns += GetDeviceTimestamp() - binning_start;
+}
+
+static void RasterizeIndirectDraws(ExecutionContext* context, bool indexed, VkBuffer buffer, VkDeviceSize offset, uint32_t draw_count,
+                                   uint32_t stride, VkBuffer count_buffer, VkDeviceSize count_offset) {
+    if (!context->render_pass || !context->draw.pipeline) return;
+    if (count_buffer != VK_NULL_HANDLE) {
+        const char* data = GetBufferData(count_buffer, count_offset, sizeof(uint32_t));
+        if (!data) return;
+        uint32_t count;
+        memcpy(&count, data, sizeof(count));
+        draw_count = std::min(draw_count, count);
+    }
+    for (uint32_t i = 0; i < draw_count; ++i) {
+        if (indexed) {
+            VkDrawIndexedIndirectCommand command;
+            const char* data = GetBufferData(buffer, offset + (VkDeviceSize)i * stride, sizeof(command));
+            if (!data) return;
+            memcpy(&command, data, sizeof(command));
+            RasterizeDraw(context, true, command.indexCount, command.instanceCount, command.firstIndex, command.vertexOffset, command.firstInstance, i);
+        } else {
+            VkDrawIndirectCommand command;
+            const char* data = GetBufferData(buffer, offset + (VkDeviceSize)i * stride, sizeof(command));
+            if (!data) return;
+            memcpy(&command, data, sizeof(command));
+            RasterizeDraw(context, false, command.vertexCount, command.instanceCount, command.firstVertex, 0, command.firstInstance, i);
+        }
+    }
+}
+
+static void ExecuteNextSubpass(ExecutionContext* context) {
+    RenderPassInstance* instance = context->render_pass.get();
+    if (!instance) return;
+    RenderTiles(instance);
+    if (instance->subpass + 1 < instance->render_pass.subpasses.size()) instance->subpass++;
+}
+
+static void ExecuteEndRenderPass(ExecutionContext* context) {
+    if (!context->render_pass) return;
+    RenderTiles(context->render_pass.get());
+    context->render_pass.reset();
+}
+
+// Minimum simulated execution time of every batch of command buffers, in microseconds from VK_MOCK_SUBMIT_DELAY_US
+static std::chrono::microseconds GetSubmitDelay() {
+    static const std::chrono::microseconds delay(getenv("VK_MOCK_SUBMIT_DELAY_US") ? strtoull(getenv("VK_MOCK_SUBMIT_DELAY_US"), nullptr, 10) : 0);
+    return delay;
+}
+
+// Presented frames can be written out, to see what an application renders without a display. When
+// VK_MOCK_PRESENT_FILE is set, each frame goes to a file named by it with %u replaced by the frame number, as a binary
+// PPM image when the name ends in .ppm and as raw texels otherwise. When VK_MOCK_PRESENT_SHM names a shared memory
+// object, frames go to a ring in it for viewers to read the latest ones from. The queue executing a present copies the
+// image into a frame and a writer thread writes it out. Presents wait for the writer once it falls PRESENT_QUEUE_DEPTH
+// frames behind, so no frame is lost. Frames are numbered from 0 in the order their presents execute.
+static const uint32_t PRESENT_QUEUE_DEPTH = 3;
+static const char PRESENT_RING_MAGIC[8] = {'V', 'K', 'M', 'O', 'C', 'K', 'F', 'R'};
+static const uint32_t PRESENT_RING_VERSION = 1;
+static const uint32_t PRESENT_RING_SLOT_COUNT = 3;
+
+// The ring starts with a PresentRingHeader followed at slots_offset by slot_count slots slot_stride bytes apart, each a
+// PresentRingSlot followed by up to slot_size bytes of texels, rows of row_pitch bytes. The ring is created when the
+// first frame is presented and slot_size is the size of that frame, larger frames are dropped. Frame n goes to slot
+// n % slot_count. A slot's sequence is 0 while it is written and n + 1 once it holds frame n, so readers copy a slot
+// and then check its sequence is unchanged.
+struct PresentRingHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t slot_count;
+    uint64_t slots_offset;
+    uint64_t slot_stride;
+    uint64_t slot_size;
+    std::atomic<uint64_t> frames;   // Frames written to the ring
+    std::atomic<uint64_t> dropped;  // Frames too large for a slot
+};
+
+struct PresentRingSlot {
+    std::atomic<uint64_t> sequence;
+    uint32_t format;  // VkFormat
+    uint32_t width;
+    uint32_t height;
+    uint32_t row_pitch;
+    uint64_t size;
+};
+
+struct PresentFrame {
+    uint64_t number;
+    VkFormat format;
+    VkExtent2D extent;
+    std::vector<char> texels;
+};
+
+static void PresentWriter();
+
+struct PresentSink {
+    PresentSink() {
+        const char* pattern = getenv("VK_MOCK_PRESENT_FILE");
+        if (pattern && *pattern && IsFramePattern(pattern)) file_pattern = pattern;
+#if defined(__linux__) || defined(__APPLE__)
+        const char* name = getenv("VK_MOCK_PRESENT_SHM");
+        if (name && *name) shm_name = name[0] == '/' ? name : std::string("/") + name;
+#endif
+        enabled = !file_pattern.empty() || !shm_name.empty();
+    }
+    // Writes out the frames still queued, before the ring goes away
+    ~PresentSink() {
+        if (!enabled) return;
+        {
+            lock_guard_t lock(this->lock);
+            stopping = true;
+        }
+        work_cv.notify_all();
+        if (writer.joinable()) writer.join();
+#if defined(__linux__) || defined(__APPLE__)
+        if (ring) {
+            munmap(ring, ring_size);
+            shm_unlink(shm_name.c_str());
+        }
+#endif
+    }
+    // The pattern is used as a printf format, so it may only convert the frame number
+    static bool IsFramePattern(const char* pattern) {
+        uint32_t conversions = 0;
+        for (const char* c = pattern; *c; ++c) {
+            if (*c != '%') continue;
+            if (*++c == '%') continue;
+            while (isdigit((unsigned char)*c)) ++c;
+            if (*c != 'u' || ++conversions > 1) return false;
+        }
+        return true;
+    }
+    bool enabled = false;
+    std::string file_pattern;
+    std::string shm_name;
+    PresentRingHeader* ring = nullptr;  // Only used by the writer thread
+    size_t ring_size = 0;
+    mutex_t lock;  // Guards everything below
+    std::condition_variable work_cv;
+    std::condition_variable space_cv;
+    std::deque<PresentFrame> frames;
+    std::vector<std::vector<char>> spare_texels;  // Buffers of frames written out, for reuse
+    uint32_t frames_in_flight = 0;                // Frames being copied, queued or written
+    uint64_t frame_count = 0;
+    bool stopping = false;
+    std::thread writer;
+};
+static PresentSink present_sink;
+
+static void WritePresentFile(const PresentFrame& frame) {
+    std::vector<char> path(present_sink.file_pattern.size() + 24);
+    snprintf(path.data(), path.size(), present_sink.file_pattern.c_str(), (unsigned)frame.number);
+    FILE* file = fopen(path.data(), "wb");
+    if (!file) return;
+    const size_t length = strlen(path.data());
+    if (length >= 4 && strcmp(path.data() + length - 4, ".ppm") == 0) {
+        // Swapchain images have four 8-bit channels, written out without alpha
+        const bool bgra = frame.format == VK_FORMAT_B8G8R8A8_UNORM || frame.format == VK_FORMAT_B8G8R8A8_SRGB;
+        std::vector<char> row(frame.extent.width * 3);
+        fprintf(file, "P6\\n%u %u\\n255\\n", frame.extent.width, frame.extent.height);
+        for (uint32_t y = 0; y < frame.extent.height; ++y) {
+            const char* texel = frame.texels.data() + (size_t)y * frame.extent.width * 4;
+            for (uint32_t x = 0; x < frame.extent.width; ++x, texel += 4) {
+                row[x * 3 + 0] = texel[bgra ? 2 : 0];
+                row[x * 3 + 1] = texel[1];
+                row[x * 3 + 2] = texel[bgra ? 0 : 2];
+            }
+            fwrite(row.data(), 1, row.size(), file);
+        }
+    } else {
+        fwrite(frame.texels.data(), 1, frame.texels.size(), file);
+    }
+    fclose(file);
+}
+
+static PresentRingHeader* CreatePresentRing(uint64_t slot_size) {
+#if defined(__linux__) || defined(__APPLE__)
+    const uint64_t slot_stride = (sizeof(PresentRingSlot) + slot_size + 63) & ~uint64_t(63);
+    const uint64_t slots_offset = (sizeof(PresentRingHeader) + 63) & ~uint64_t(63);
+    const size_t size = (size_t)(slots_offset + PRESENT_RING_SLOT_COUNT * slot_stride);
+    const int fd = shm_open(present_sink.shm_name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) return nullptr;
+    void* data = MAP_FAILED;
+    if (ftruncate(fd, 0) == 0 && ftruncate(fd, size) == 0) data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        shm_unlink(present_sink.shm_name.c_str());
+        return nullptr;
+    }
+    auto ring = static_cast<PresentRingHeader*>(data);
+    ring->version = PRESENT_RING_VERSION;
+    ring->slot_count = PRESENT_RING_SLOT_COUNT;
+    ring->slots_offset = slots_offset;
+    ring->slot_stride = slot_stride;
+    ring->slot_size = slot_size;
+    present_sink.ring_size = size;
+    // Readers check the magic last, once everything else is in place
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(ring->magic, PRESENT_RING_MAGIC, sizeof(PRESENT_RING_MAGIC));
+    return ring;
+#else
+    return nullptr;
+#endif
+}
+
+static void WritePresentRing(const PresentFrame& frame) {
+    if (!present_sink.ring && !(present_sink.ring = CreatePresentRing(frame.texels.size()))) return;
+    PresentRingHeader* ring = present_sink.ring;
+    if (frame.texels.size() > ring->slot_size) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const uint64_t slot_index = ring->frames.load(std::memory_order_relaxed) % ring->slot_count;
+    auto slot = reinterpret_cast<PresentRingSlot*>(reinterpret_cast<char*>(ring) + ring->slots_offset + slot_index * ring->slot_stride);
+    slot->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->format = frame.format;
+    slot->width = frame.extent.width;
+    slot->height = frame.extent.height;
+    slot->row_pitch = frame.extent.width * 4;
+    slot->size = frame.texels.size();
+    memcpy(reinterpret_cast<char*>(slot + 1), frame.texels.data(), frame.texels.size());
+    slot->sequence.store(frame.number + 1, std::memory_order_release);
+    ring->frames.fetch_add(1, std::memory_order_release);
+}
+
+static void PresentWriter() {
+    unique_lock_t lock(present_sink.lock);
+    for (;;) {
+        present_sink.work_cv.wait(lock, [] { return present_sink.stopping || !present_sink.frames.empty(); });
+        if (present_sink.frames.empty()) break;
+        PresentFrame frame = std::move(present_sink.frames.front());
+        present_sink.frames.pop_front();
+        lock.unlock();
+        if (!present_sink.file_pattern.empty()) WritePresentFile(frame);
+        if (!present_sink.shm_name.empty()) WritePresentRing(frame);
+        lock.lock();
+        present_sink.spare_texels.push_back(std::move(frame.texels));
+        present_sink.frames_in_flight--;
+        present_sink.space_cv.notify_all();
+    }
 }
-static void DestroyDispObjHandle(void* handle) {
-    delete reinterpret_cast<VK_LOADER_DATA*>(handle);
+
+// Copies a presented image into a frame for the writer thread. Surfaces only report formats with four 8-bit
+// channels, frames keep the image's rows without their padding.
+static void SendPresentedFrame(VkFormat format, VkExtent2D extent, const void* texels, size_t row_pitch) {
+    unique_lock_t lock(present_sink.lock);
+    present_sink.space_cv.wait(lock, [] { return present_sink.stopping || present_sink.frames_in_flight < PRESENT_QUEUE_DEPTH; });
+    if (present_sink.stopping) return;
+    present_sink.frames_in_flight++;
+    PresentFrame frame;
+    frame.format = format;
+    frame.extent = extent;
+    if (!present_sink.spare_texels.empty()) {
+        frame.texels = std::move(present_sink.spare_texels.back());
+        present_sink.spare_texels.pop_back();
+    }
+    lock.unlock();
+    const size_t row_size = (size_t)extent.width * 4;
+    frame.texels.resize(row_size * extent.height);
+    for (uint32_t y = 0; y < extent.height; ++y) {
+        memcpy(&frame.texels[y * row_size], static_cast<const char*>(texels) + y * row_pitch, row_size);
+    }
+    lock.lock();
+    frame.number = present_sink.frame_count++;
+    present_sink.frames.push_back(std::move(frame));
+    if (!present_sink.writer.joinable() && !present_sink.stopping) present_sink.writer = std::thread(PresentWriter);
+    lock.unlock();
+    present_sink.work_cv.notify_one();
 }
-'''
 
-# Manual code at the top of the cpp source file
-SOURCE_CPP_PREFIX = '''
-using std::unordered_map;
+// Swapchains rotate their images through a simulated presentation engine that flips on the vblanks of a
+// display refreshing VK_MOCK_REFRESH_HZ times a second (default 60). The image on screen stays there until
+// a flip replaces it, and only then becomes available to acquire again. FIFO modes flip to the oldest
+// queued image on each vblank, MAILBOX to the newest one with the images it replaced released unshown, and
+// IMMEDIATE flips as soon as the present executes. FIFO_RELAXED flips right away when the image is late,
+// that is when the last vblank passed without a flip. Shared modes have a single image that stays acquired.
+// Nothing ticks the vblank clock: a swapchain catches up with the vblanks that passed whenever it is looked at.
+// Swapchain state is guarded by the sync_lock of the swapchain's device.
+struct QueuedPresent {
+    uint32_t image_index;
+    uint64_t first_vblank;  // The image cannot be shown before this vblank
+};
+
+struct Swapchain {
+    VkPresentModeKHR present_mode = VK_PRESENT_MODE_FIFO_KHR;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkExtent2D extent = {0, 0};
+    std::vector<VkImage> images;
+    std::vector<void*> image_data;      // Backing store of each image, laid out like any other image
+    size_t image_size = 0;
+    size_t row_pitch = 0;
+    std::deque<uint32_t> available;     // Images that can be acquired, in the order they became available
+    std::deque<QueuedPresent> queued;   // Presented images waiting for a flip
+    uint32_t displayed = UINT32_MAX;    // Image on screen
+    uint64_t displayed_vblank = 0;      // Vblank the image on screen was shown at
+    uint64_t vblank = 0;                // Last vblank the swapchain has caught up with
+    bool retired = false;               // Replaced by a newer swapchain
+    uint32_t pending_presents = 0;      // Presents the queues have not executed yet, which still read the images
+    bool destroyed = false;             // Destroyed by the application, the last pending present frees it
+};
+
+static ObjectTable<Swapchain> swapchain_table(STATS_OBJECT_VkSwapchainKHR);
+
+static std::chrono::nanoseconds GetRefreshPeriod() {
+    static const double refresh_rate = getenv("VK_MOCK_REFRESH_HZ") ? strtod(getenv("VK_MOCK_REFRESH_HZ"), nullptr) : 60.0;
+    static const std::chrono::nanoseconds period((int64_t)(1e9 / (refresh_rate > 0.0 ? refresh_rate : 60.0)));
+    return period;
+}
+
+// Vblanks are numbered from the epoch of the steady clock, so all swapchains share one display
+static uint64_t GetVblank(std::chrono::steady_clock::time_point time) {
+    return (uint64_t)(time.time_since_epoch() / GetRefreshPeriod());
+}
+
+static std::chrono::steady_clock::time_point GetVblankTime(uint64_t vblank) {
+    return std::chrono::steady_clock::time_point(GetRefreshPeriod() * (int64_t)vblank);
+}
+
+static void DestroySwapchainImages(Swapchain* swapchain) {
+    for (auto image : swapchain->images) image_table.Destroy(image);
+    for (auto data : swapchain->image_data) ReleaseBackingPages(data, std::max<size_t>(swapchain->image_size, 1));
+    swapchain->images.clear();
+    swapchain->image_data.clear();
+}
+
+static bool IsSharedPresentMode(VkPresentModeKHR present_mode) {
+    return present_mode == VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR || present_mode == VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR;
+}
+
+static void ShowSwapchainImage(Swapchain* swapchain, uint32_t image_index, uint64_t vblank) {
+    if (swapchain->displayed != UINT32_MAX) swapchain->available.push_back(swapchain->displayed);
+    swapchain->displayed = image_index;
+    swapchain->displayed_vblank = vblank;
+}
+
+// Flips to the queued images whose vblanks have passed, at most one per vblank
+static void UpdateSwapchain(Swapchain* swapchain) {
+    const uint64_t now = GetVblank(std::chrono::steady_clock::now());
+    while (!swapchain->queued.empty()) {
+        const QueuedPresent& next = swapchain->queued.front();
+        const uint64_t vblank = std::max(swapchain->vblank + 1, next.first_vblank);
+        if (vblank > now) break;
+        ShowSwapchainImage(swapchain, next.image_index, vblank);
+        swapchain->queued.pop_front();
+        swapchain->vblank = vblank;
+    }
+    swapchain->vblank = std::max(swapchain->vblank, now);
+}
+
+// Takes the next available image, or returns false and when the next flip makes one available
+static bool AcquireSwapchainImage(Swapchain* swapchain, uint32_t* image_index, std::chrono::steady_clock::time_point* next_flip) {
+    UpdateSwapchain(swapchain);
+    if (swapchain->available.empty()) {
+        *next_flip = swapchain->queued.empty() ? std::chrono::steady_clock::time_point::max()
+                                               : GetVblankTime(std::max(swapchain->vblank + 1, swapchain->queued.front().first_vblank));
+        return false;
+    }
+    *image_index = swapchain->available.front();
+    swapchain->available.pop_front();
+    return true;
+}
+
+// Hands a presented image to the presentation engine once the present's semaphore waits are done
+static void PresentSwapchainImage(Device* device, VkSwapchainKHR handle, uint32_t image_index) {
+    LogRasterFrame();
+    unique_lock_t lock(device->sync_lock);
+    Swapchain* swapchain = swapchain_table.Get(handle);
+    if (!swapchain) return;
+    if (present_sink.enabled && !swapchain->destroyed) {
+        // The image does not change until the presentation engine releases it, and the pending present keeps the
+        // swapchain alive, so it is copied without the lock
+        lock.unlock();
+        SendPresentedFrame(swapchain->format, swapchain->extent, swapchain->image_data[image_index], swapchain->row_pitch);
+        lock.lock();
+    }
+    swapchain->pending_presents--;
+    if (swapchain->destroyed) {
+        if (!swapchain->pending_presents) {
+            DestroySwapchainImages(swapchain);
+            swapchain_table.Destroy(handle);
+        }
+        return;
+    }
+    UpdateSwapchain(swapchain);
+    const uint64_t vblank = swapchain->vblank;
+    switch (swapchain->present_mode) {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:
+            ShowSwapchainImage(swapchain, image_index, vblank);
+            break;
+        case VK_PRESENT_MODE_MAILBOX_KHR:
+            for (const auto& replaced : swapchain->queued) swapchain->available.push_back(replaced.image_index);
+            swapchain->queued.clear();
+            swapchain->queued.push_back({image_index, vblank + 1});
+            break;
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+            if (swapchain->queued.empty() && swapchain->displayed_vblank < vblank) {
+                ShowSwapchainImage(swapchain, image_index, vblank);
+                break;
+            }
+            swapchain->queued.push_back({image_index, vblank + 1});
+            break;
+        case VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR:
+        case VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR:
+            // The shared image is never given back
+            break;
+        default:
+            swapchain->queued.push_back({image_index, vblank + 1});
+            break;
+    }
+}
+
+static void ExecuteSubmission(Queue* queue, const Submission& submission) {
+    for (const auto& wait : submission.waits) {
+        Semaphore* semaphore = wait.first;
+        const uint64_t value = wait.second;
+        WaitForSyncObjects(queue->device, [&] { return semaphore->value.load() >= value || queue->stopping.load(); },
+                           std::chrono::steady_clock::time_point::max());
+    }
+    if (!submission.command_buffers.empty()) {
+        ExecutionContext context;
+        context.start_time = GetDeviceTimestamp();
+        for (auto command_buffer : submission.command_buffers) ExecuteCommandBuffer(command_buffer, &context);
+        // The batch takes as long as the cost model says, or the submit delay if that is longer
+        const uint64_t duration = std::max<uint64_t>(context.elapsed, std::chrono::duration_cast<std::chrono::nanoseconds>(GetSubmitDelay()).count());
+        const uint64_t now = GetDeviceTimestamp();
+        if (context.start_time + duration > now) std::this_thread::sleep_for(std::chrono::nanoseconds(context.start_time + duration - now));
+    }
+    for (const auto& present : submission.presents) PresentSwapchainImage(queue->device, present.first, present.second);
+    for (const auto& signal : submission.signals) signal.first->value = signal.second;
+    if (submission.fence) submission.fence->signaled = true;
+    // Also wakes hosts waiting on query results, which may have become available
+    queue->device->pending_submissions.fetch_sub(1);
+    SignalSyncObjects(queue->device);
+}
+
+static void QueueWorker(Queue* queue) {
+    unique_lock_t lock(queue->lock);
+    for (;;) {
+        queue->work_cv.wait(lock, [queue] { return queue->stopping.load() || !queue->submissions.empty(); });
+        if (queue->submissions.empty()) break;
+        Submission submission = std::move(queue->submissions.front());
+        queue->submissions.pop_front();
+        lock.unlock();
+        ExecuteSubmission(queue, submission);
+        lock.lock();
+        queue->completed++;
+        queue->idle_cv.notify_all();
+    }
+}
+
+static Queue* CreateQueue(Device* device) {
+    auto queue = new Queue();
+    set_loader_magic_value(&queue->loader_data);
+    queue->device = device;
+    queue->worker = std::thread(QueueWorker, queue);
+    return queue;
+}
+
+static void DestroyQueue(Queue* queue) {
+    {
+        lock_guard_t lock(queue->lock);
+        queue->stopping = true;
+    }
+    queue->work_cv.notify_all();
+    // Releases the worker if it is stuck on a semaphore that will never be signalled
+    SignalSyncObjects(queue->device);
+    queue->worker.join();
+    delete queue;
+}
+
+static void EnqueueSubmissions(Queue* queue, std::vector<Submission>& submissions) {
+    if (submissions.empty()) return;
+    lock_guard_t lock(queue->lock);
+    for (auto& submission : submissions) queue->submissions.push_back(std::move(submission));
+    queue->submitted += submissions.size();
+    queue->device->pending_submissions.fetch_add(submissions.size());
+    queue->work_cv.notify_one();
+}
+
+static void WaitQueueIdle(Queue* queue) {
+    unique_lock_t lock(queue->lock);
+    queue->idle_cv.wait(lock, [queue] { return queue->completed == queue->submitted; });
+}
+
+static Fence* GetFence(VkFence fence) {
+    return fence_table.Get(fence);
+}
+
+static Semaphore* GetSemaphore(VkSemaphore semaphore) {
+    return semaphore_table.Get(semaphore);
+}
+
+// Acquires a swapchain image for vkAcquireNextImageKHR and vkAcquireNextImage2KHR
+static VkResult AcquireNextImage(Device* device, VkSwapchainKHR swapchain, uint64_t timeout, VkSemaphore semaphore, VkFence fence,
+                                 uint32_t* pImageIndex) {
+    const auto deadline = GetSyncDeadline(timeout);
+    unique_lock_t lock(device->sync_lock);
+    // Stale handles, and swapchains destroyed while presents were pending, are out of date
+    Swapchain* acquire_swapchain = swapchain_table.Get(swapchain);
+    if (!acquire_swapchain || acquire_swapchain->destroyed || acquire_swapchain->retired) return VK_ERROR_OUT_OF_DATE_KHR;
+    if (IsSharedPresentMode(acquire_swapchain->present_mode)) {
+        *pImageIndex = 0;
+    } else {
+        // Flips happen on the vblank clock without waking anyone, so wait until the next flip at most. Presents
+        // do wake waiters, and when one queues an image the wait starts over to wait for its flip instead.
+        auto next_flip = std::chrono::steady_clock::now();
+        bool acquired = false;
+        bool out_of_date = false;
+        lock.unlock();
+        for (;;) {
+            const auto wait_deadline = std::min(deadline, next_flip);
+            WaitForSyncObjects(device, [&] {
+                lock_guard_t acquire_lock(device->sync_lock);
+                // The swapchain is looked up again on every wake, as the last pending present may have freed it
+                acquire_swapchain = swapchain_table.Get(swapchain);
+                out_of_date = !acquire_swapchain || acquire_swapchain->destroyed;
+                if (out_of_date) return true;
+                acquired = AcquireSwapchainImage(acquire_swapchain, pImageIndex, &next_flip);
+                return acquired || next_flip < wait_deadline;
+            }, wait_deadline);
+            if (out_of_date) return VK_ERROR_OUT_OF_DATE_KHR;
+            if (acquired) break;
+            if (std::chrono::steady_clock::now() >= deadline) return timeout ? VK_TIMEOUT : VK_NOT_READY;
+        }
+        lock.lock();
+    }
+    // The image is available once it is acquired, signal the semaphore and fence from the host
+    Semaphore* acquire_semaphore = GetSemaphore(semaphore);
+    if (acquire_semaphore) acquire_semaphore->value = ++acquire_semaphore->signals_submitted;
+    Fence* acquire_fence = GetFence(fence);
+    if (acquire_fence) acquire_fence->signaled = true;
+    lock.unlock();
+    SignalSyncObjects(device);
+    return VK_SUCCESS;
+}
+
+// The following helpers must be called with the sync_lock of the semaphores' device held
+// timeline_value is ignored for binary semaphores
+static void AddSemaphoreWait(Submission* submission, VkSemaphore handle, uint64_t timeline_value) {
+    Semaphore* semaphore = GetSemaphore(handle);
+    if (!semaphore) return;
+    if (semaphore->type == VK_SEMAPHORE_TYPE_TIMELINE) {
+        // Timeline waits may be submitted before their signal, the worker simply blocks until it arrives
+        submission->waits.push_back(std::make_pair(semaphore, timeline_value));
+    } else if (semaphore->waits_submitted < semaphore->signals_submitted) {
+        // Waiting on a binary semaphore with no signal pending is invalid, skip it rather than stall the queue forever
+        submission->waits.push_back(std::make_pair(semaphore, ++semaphore->waits_submitted));
+    }
+}
 
-// Map device memory handle to any mapped allocations that we'll need to free on unmap
-static unordered_map<VkDeviceMemory, std::vector<void*>> mapped_memory_map;
+static void AddSemaphoreSignal(Submission* submission, VkSemaphore handle, uint64_t timeline_value) {
+    Semaphore* semaphore = GetSemaphore(handle);
+    if (!semaphore) return;
+    if (semaphore->type == VK_SEMAPHORE_TYPE_TIMELINE) {
+        submission->signals.push_back(std::make_pair(semaphore, timeline_value));
+    } else {
+        submission->signals.push_back(std::make_pair(semaphore, ++semaphore->signals_submitted));
+    }
+}
 
-static VkPhysicalDevice physical_device = nullptr;
-static unordered_map<VkDevice, unordered_map<uint32_t, unordered_map<uint32_t, VkQueue>>> queue_map;
-static unordered_map<VkDevice, unordered_map<VkBuffer, VkBufferCreateInfo>> buffer_map;
+// Values for the semaphores of a VkSubmitInfo or VkBindSparseInfo, zero when none are chained
+static uint64_t GetTimelineWaitValue(const VkTimelineSemaphoreSubmitInfo* timeline_info, uint32_t index) {
+    return (timeline_info && timeline_info->pWaitSemaphoreValues && index < timeline_info->waitSemaphoreValueCount) ? timeline_info->pWaitSemaphoreValues[index] : 0;
+}
+static uint64_t GetTimelineSignalValue(const VkTimelineSemaphoreSubmitInfo* timeline_info, uint32_t index) {
+    return (timeline_info && timeline_info->pSignalSemaphoreValues && index < timeline_info->signalSemaphoreValueCount) ? timeline_info->pSignalSemaphoreValues[index] : 0;
+}
 
 // TODO: Would like to codegen this but limits aren't in XML
 static VkPhysicalDeviceLimits SetLimits(VkPhysicalDeviceLimits *limits) {
@@ -187,6 +4281,620 @@ void SetBoolArrayTrue(VkBool32* bool_array, uint32_t num_bools)
         bool_array[i] = VK_TRUE;
     }
 }
+
+static uint64_t GetJsonUint(const JsonValue* value, uint64_t default_value) {
+    if (!value) return default_value;
+    if (value->type == JsonValue::BOOLEAN) return value->boolean ? 1 : 0;
+    if (value->type != JsonValue::NUMBER) return default_value;
+    return value->exact ? value->integer : (uint64_t)(int64_t)value->number;
+}
+
+static void SetProfileField(void* base, const ProfileField& field, uint32_t element, const JsonValue& value) {
+    char* data = static_cast<char*>(base) + field.offset;
+    switch (field.type) {
+        case PROFILE_FIELD_UINT32:
+            reinterpret_cast<uint32_t*>(data)[element] = (uint32_t)GetJsonUint(&value, 0);
+            break;
+        case PROFILE_FIELD_INT32:
+            reinterpret_cast<int32_t*>(data)[element] = (int32_t)value.number;
+            break;
+        case PROFILE_FIELD_UINT64:
+            reinterpret_cast<uint64_t*>(data)[element] = GetJsonUint(&value, 0);
+            break;
+        case PROFILE_FIELD_SIZE:
+            reinterpret_cast<size_t*>(data)[element] = (size_t)GetJsonUint(&value, 0);
+            break;
+        case PROFILE_FIELD_FLOAT:
+            reinterpret_cast<float*>(data)[element] = (float)value.number;
+            break;
+    }
+}
+
+// Sets the members of base named in object, members the profile leaves out keep their defaults
+template <size_t FIELD_COUNT>
+static void ApplyProfileFields(void* base, const ProfileField (&fields)[FIELD_COUNT], const JsonValue* object) {
+    if (!object) return;
+    for (const auto& field : fields) {
+        const JsonValue* value = object->Find(field.name);
+        if (!value) continue;
+        if (value->type == JsonValue::ARRAY) {
+            for (uint32_t i = 0; i < field.count && i < value->elements.size(); ++i) SetProfileField(base, field, i, value->elements[i]);
+        } else {
+            SetProfileField(base, field, 0, *value);
+        }
+    }
+}
+
+static void SetDefaultDeviceProfile(DeviceProfile* profile) {
+    VkPhysicalDeviceProperties& properties = profile->properties;
+    properties.apiVersion = VK_API_VERSION_1_0;
+    properties.driverVersion = 1;
+    properties.vendorID = MOCK_VENDOR_ID;
+    properties.deviceID = MOCK_DEVICE_ID;
+    properties.deviceType = VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU;
+    strcpy(properties.deviceName, "Vulkan Mock Device");
+    memcpy(properties.pipelineCacheUUID, PIPELINE_CACHE_UUID, VK_UUID_SIZE);
+    SetLimits(&properties.limits);
+    properties.sparseProperties = { VK_TRUE, VK_TRUE, VK_TRUE, VK_TRUE, VK_TRUE };
+
+    SetBoolArrayTrue(&profile->features.robustBufferAccess, sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32));
+
+    VkPhysicalDeviceMemoryProperties& memory_properties = profile->memory_properties;
+    memory_properties.memoryTypeCount = 2;
+    memory_properties.memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    memory_properties.memoryTypes[0].heapIndex = 0;
+    memory_properties.memoryTypes[1].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    memory_properties.memoryTypes[1].heapIndex = 1;
+    memory_properties.memoryHeapCount = 2;
+    memory_properties.memoryHeaps[0].flags = 0;
+    memory_properties.memoryHeaps[0].size = 8000000000;
+    memory_properties.memoryHeaps[1].flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+    memory_properties.memoryHeaps[1].size = 8000000000;
+
+    profile->queue_family_count = 1;
+    profile->queue_families[0].queueFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT | VK_QUEUE_SPARSE_BINDING_BIT;
+    profile->queue_families[0].queueCount = 1;
+    profile->queue_families[0].timestampValidBits = 64;
+    profile->queue_families[0].minImageTransferGranularity = {1,1,1};
+
+    // TODO: Just returning full support for everything initially
+    for (auto& format_properties : profile->format_properties) format_properties = { 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF };
+    profile->format_properties[GetFormatIndex(VK_FORMAT_UNDEFINED)] = { 0x0, 0x0, 0x0 };
+}
+
+// Reads a profile in the format of vulkaninfo --json on top of the defaults. Only formats the profile
+// lists are supported, everything else it leaves out keeps its default.
+static bool LoadDeviceProfile(const char* path, DeviceProfile* profile) {
+    JsonValue root;
+    if (!ParseJsonFile(path, &root) || root.type != JsonValue::OBJECT) return false;
+
+    if (const JsonValue* properties = root.Find("VkPhysicalDeviceProperties")) {
+        VkPhysicalDeviceProperties& device_properties = profile->properties;
+        device_properties.apiVersion = (uint32_t)GetJsonUint(properties->Find("apiVersion"), device_properties.apiVersion);
+        device_properties.driverVersion = (uint32_t)GetJsonUint(properties->Find("driverVersion"), device_properties.driverVersion);
+        device_properties.vendorID = (uint32_t)GetJsonUint(properties->Find("vendorID"), device_properties.vendorID);
+        device_properties.deviceID = (uint32_t)GetJsonUint(properties->Find("deviceID"), device_properties.deviceID);
+        device_properties.deviceType = (VkPhysicalDeviceType)GetJsonUint(properties->Find("deviceType"), device_properties.deviceType);
+        const JsonValue* name = properties->Find("deviceName");
+        if (name && name->type == JsonValue::STRING) {
+            strncpy(device_properties.deviceName, name->string.c_str(), VK_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1);
+            device_properties.deviceName[VK_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1] = '\\0';
+        }
+        const JsonValue* uuid = properties->Find("pipelineCacheUUID");
+        if (uuid && uuid->type == JsonValue::ARRAY && uuid->elements.size() == VK_UUID_SIZE) {
+            for (uint32_t i = 0; i < VK_UUID_SIZE; ++i) device_properties.pipelineCacheUUID[i] = (uint8_t)GetJsonUint(&uuid->elements[i], 0);
+        }
+        ApplyProfileFields(&device_properties.limits, physical_device_limits_fields, properties->Find("VkPhysicalDeviceLimits"));
+        ApplyProfileFields(&device_properties.sparseProperties, physical_device_sparse_properties_fields, properties->Find("VkPhysicalDeviceSparseProperties"));
+    }
+    ApplyProfileFields(&profile->features, physical_device_features_fields, root.Find("VkPhysicalDeviceFeatures"));
+
+    if (const JsonValue* memory = root.Find("VkPhysicalDeviceMemoryProperties")) {
+        VkPhysicalDeviceMemoryProperties& memory_properties = profile->memory_properties;
+        const JsonValue* heaps = memory->Find("memoryHeaps");
+        if (heaps && heaps->type == JsonValue::ARRAY) {
+            memory_properties.memoryHeapCount = std::min<uint32_t>((uint32_t)heaps->elements.size(), VK_MAX_MEMORY_HEAPS);
+            for (uint32_t i = 0; i < memory_properties.memoryHeapCount; ++i) {
+                memory_properties.memoryHeaps[i].flags = (VkMemoryHeapFlags)GetJsonUint(heaps->elements[i].Find("flags"), 0);
+                memory_properties.memoryHeaps[i].size = GetJsonUint(heaps->elements[i].Find("size"), 0);
+            }
+        }
+        const JsonValue* types = memory->Find("memoryTypes");
+        if (types && types->type == JsonValue::ARRAY) {
+            memory_properties.memoryTypeCount = std::min<uint32_t>((uint32_t)types->elements.size(), VK_MAX_MEMORY_TYPES);
+            for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i) {
+                memory_properties.memoryTypes[i].heapIndex = (uint32_t)GetJsonUint(types->elements[i].Find("heapIndex"), 0);
+                memory_properties.memoryTypes[i].propertyFlags = (VkMemoryPropertyFlags)GetJsonUint(types->elements[i].Find("propertyFlags"), 0);
+            }
+        }
+    }
+
+    const JsonValue* queue_families = root.Find("ArrayOfVkQueueFamilyProperties");
+    if (queue_families && queue_families->type == JsonValue::ARRAY && !queue_families->elements.empty()) {
+        profile->queue_family_count = std::min<uint32_t>((uint32_t)queue_families->elements.size(), MAX_PROFILE_QUEUE_FAMILIES);
+        for (uint32_t i = 0; i < profile->queue_family_count; ++i) {
+            const JsonValue& family = queue_families->elements[i];
+            VkQueueFamilyProperties& properties = profile->queue_families[i];
+            properties.queueFlags = (VkQueueFlags)GetJsonUint(family.Find("queueFlags"), 0);
+            properties.queueCount = (uint32_t)GetJsonUint(family.Find("queueCount"), 1);
+            properties.timestampValidBits = (uint32_t)GetJsonUint(family.Find("timestampValidBits"), 0);
+            properties.minImageTransferGranularity = {1, 1, 1};
+            if (const JsonValue* granularity = family.Find("minImageTransferGranularity")) {
+                properties.minImageTransferGranularity.width = (uint32_t)GetJsonUint(granularity->Find("width"), 1);
+                properties.minImageTransferGranularity.height = (uint32_t)GetJsonUint(granularity->Find("height"), 1);
+                properties.minImageTransferGranularity.depth = (uint32_t)GetJsonUint(granularity->Find("depth"), 1);
+            }
+        }
+    }
+
+    const JsonValue* formats = root.Find("ArrayOfVkFormatProperties");
+    if (formats && formats->type == JsonValue::ARRAY) {
+        for (auto& format_properties : profile->format_properties) format_properties = { 0x0, 0x0, 0x0 };
+        for (const auto& format : formats->elements) {
+            const VkFormat id = (VkFormat)GetJsonUint(format.Find("formatID"), VK_FORMAT_UNDEFINED);
+            const uint32_t index = GetFormatIndex(id);
+            if (index == FORMAT_COUNT || id == VK_FORMAT_UNDEFINED) continue;
+            profile->format_properties[index].linearTilingFeatures = (VkFormatFeatureFlags)GetJsonUint(format.Find("linearTilingFeatures"), 0);
+            profile->format_properties[index].optimalTilingFeatures = (VkFormatFeatureFlags)GetJsonUint(format.Find("optimalTilingFeatures"), 0);
+            profile->format_properties[index].bufferFeatures = (VkFormatFeatureFlags)GetJsonUint(format.Find("bufferFeatures"), 0);
+        }
+    }
+    profile->from_file = true;
+    return true;
+}
+
+// Called by vkCreateInstance, fails if VK_MOCK_PROFILE names a profile that cannot be read. A profile is only
+// taken once it loads completely, so a failed call leaves nothing behind for the next one.
+static bool InitDeviceProfile() {
+    unique_lock_t lock(global_lock);
+    if (device_profile.loaded) return true;
+    std::unique_ptr<DeviceProfile> profile(new DeviceProfile());
+    SetDefaultDeviceProfile(profile.get());
+    const char* path = getenv("VK_MOCK_PROFILE");
+    if (path && *path && !LoadDeviceProfile(path, profile.get())) return false;
+    profile->loaded = true;
+    device_profile = *profile;
+    return true;
+}
+
+// Entrypoint tracing. When VK_MOCK_TRACE names a file, every entrypoint the application calls appends a record to a
+// ring owned by the calling thread, and a flush thread, started with the first ring and woken whenever one fills up
+// past half its size, drains the rings into the file. vkDestroyInstance flushes too. Callers never lock or wait:
+// a record that does not fit in a full ring is dropped and counted instead. The file starts with a TraceFileHeader
+// and the entrypoint names, NUL terminated and in Entrypoint order, followed by blocks of one thread's records.
+// scripts/mock_icd_trace_decoder.py prints them.
+static const char TRACE_FILE_MAGIC[8] = {'V', 'K', 'M', 'O', 'C', 'K', 'T', 'R'};
+static const uint32_t TRACE_FILE_VERSION = 1;
+static const uint64_t TRACE_RING_SIZE = 1 << 20;  // Bytes per thread, a power of two
+static const uint64_t TRACE_FLUSH_WATERMARK = TRACE_RING_SIZE / 2;  // Filling a ring past this wakes the flush thread
+
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entrypoint_count;
+};
+
+struct TraceBlockHeader {
+    uint32_t thread;   // Threads are numbered in the order they first call an entrypoint
+    uint32_t size;     // Bytes of records following the header
+    uint64_t dropped;  // Records the thread dropped since its previous block
+};
+
+// Followed by the values of the entrypoint's handle parameters
+struct TraceRecord {
+    uint64_t timestamp;  // Same clock as device timestamps
+    uint32_t entrypoint;
+    uint32_t handle_count;
+};
+
+struct TraceRing {
+    uint32_t thread = 0;
+    std::atomic<uint64_t> head{0};    // Bytes written by the owning thread
+    std::atomic<uint64_t> dropped{0};
+    char padding[64];                 // Keeps the flush thread's writes off the owning thread's cache line
+    std::atomic<uint64_t> tail{0};    // Bytes written out by the flush thread
+    std::atomic<bool> retired{false};  // The owning thread has exited, the ring is freed once drained
+    char data[TRACE_RING_SIZE];
+};
+
+static void FlushTraceRings();
+static void TraceFlusher();
+static void RequestTraceFlush();
+
+struct TraceWriter {
+    TraceWriter() {
+        const char* path = getenv("VK_MOCK_TRACE");
+        if (!path || !*path || !(file = fopen(path, "wb"))) return;
+        TraceFileHeader header = {{}, TRACE_FILE_VERSION, ENTRYPOINT_COUNT};
+        memcpy(header.magic, TRACE_FILE_MAGIC, sizeof(TRACE_FILE_MAGIC));
+        fwrite(&header, sizeof(header), 1, file);
+        for (auto name : entrypoint_names) fwrite(name, strlen(name) + 1, 1, file);
+        enabled = true;
+    }
+    // Runs when the process exits or the ICD is unloaded, after the exiting thread has retired its ring
+    ~TraceWriter() {
+        if (!enabled) return;
+        {
+            lock_guard_t lock(this->lock);
+            stopping = true;
+        }
+        RequestTraceFlush();
+        if (flusher.joinable()) flusher.join();
+        lock_guard_t lock(this->lock);
+        FlushTraceRings();
+        fclose(file);
+        file = nullptr;
+    }
+    bool enabled = false;
+    mutex_t lock;  // Guards everything below
+    FILE* file = nullptr;
+    std::vector<TraceRing*> rings;
+    uint32_t thread_count = 0;
+    bool stopping = false;
+    std::thread flusher;
+    // The flush thread sleeps until this changes, a futex on Linux
+    std::atomic<uint32_t> flush_requests{0};
+#if !defined(__linux__)
+    mutex_t flush_lock;
+    std::condition_variable flush_cv;
+#endif
+};
+static TraceWriter trace_writer;
+
+// Wakes the flush thread. Threads tracing calls only do so when their ring fills past the watermark or they exit,
+// so an idle or lightly traced application leaves the flush thread asleep.
+static void RequestTraceFlush() {
+    trace_writer.flush_requests.fetch_add(1, std::memory_order_release);
+#if defined(__linux__)
+    syscall(SYS_futex, &trace_writer.flush_requests, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+    { lock_guard_t lock(trace_writer.flush_lock); }
+    trace_writer.flush_cv.notify_one();
+#endif
+}
+
+// Writes out every ring's records, the caller holds trace_writer.lock
+static void FlushTraceRings() {
+    if (!trace_writer.file) return;
+    for (auto it = trace_writer.rings.begin(); it != trace_writer.rings.end();) {
+        TraceRing* ring = *it;
+        // Checked before reading head, so the records a retired ring ends with are not missed
+        const bool retired = ring->retired.load(std::memory_order_acquire);
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        const uint64_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+        if (head != tail || dropped) {
+            const TraceBlockHeader block = {ring->thread, (uint32_t)(head - tail), dropped};
+            const uint64_t start = tail & (TRACE_RING_SIZE - 1);
+            const uint64_t first = std::min(head - tail, TRACE_RING_SIZE - start);
+            fwrite(&block, sizeof(block), 1, trace_writer.file);
+            fwrite(ring->data + start, 1, first, trace_writer.file);
+            fwrite(ring->data, 1, head - tail - first, trace_writer.file);
+            ring->tail.store(head, std::memory_order_release);
+        }
+        if (retired) {
+            delete ring;
+            it = trace_writer.rings.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+static void TraceFlusher() {
+    for (;;) {
+        // Read before flushing, so a request made while the rings are written out is not slept through
+        const uint32_t requests = trace_writer.flush_requests.load(std::memory_order_acquire);
+        {
+            lock_guard_t lock(trace_writer.lock);
+            if (trace_writer.stopping) break;
+            FlushTraceRings();
+        }
+#if defined(__linux__)
+        syscall(SYS_futex, &trace_writer.flush_requests, FUTEX_WAIT_PRIVATE, requests, nullptr, nullptr, 0);
+#else
+        unique_lock_t lock(trace_writer.flush_lock);
+        trace_writer.flush_cv.wait(lock, [requests] { return trace_writer.flush_requests.load() != requests; });
+#endif
+    }
+}
+
+// Writes out everything traced so far, so the file is complete even if the process does not exit cleanly
+static void FlushTrace() {
+    if (!trace_writer.enabled) return;
+    lock_guard_t lock(trace_writer.lock);
+    FlushTraceRings();
+    if (trace_writer.file) fflush(trace_writer.file);
+}
+
+static TraceRing* CreateTraceRing() {
+    auto ring = new TraceRing;
+    lock_guard_t lock(trace_writer.lock);
+    ring->thread = trace_writer.thread_count++;
+    trace_writer.rings.push_back(ring);
+    if (!trace_writer.flusher.joinable() && !trace_writer.stopping) trace_writer.flusher = std::thread(TraceFlusher);
+    return ring;
+}
+
+static void WriteTraceRing(TraceRing* ring, uint64_t position, const void* data, uint64_t size) {
+    const uint64_t start = position & (TRACE_RING_SIZE - 1);
+    const uint64_t first = std::min(size, TRACE_RING_SIZE - start);
+    memcpy(ring->data + start, data, first);
+    memcpy(ring->data, static_cast<const char*>(data) + first, size - first);
+}
+
+static void AppendTraceRecord(TraceRing* ring, Entrypoint entrypoint, const uint64_t* handles, uint32_t handle_count) {
+    const TraceRecord record = {GetDeviceTimestamp(), entrypoint, handle_count};
+    const uint64_t size = sizeof(record) + handle_count * sizeof(uint64_t);
+    const uint64_t head = ring->head.load(std::memory_order_relaxed);
+    const uint64_t tail = ring->tail.load(std::memory_order_acquire);
+    if (head + size - tail > TRACE_RING_SIZE) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    WriteTraceRing(ring, head, &record, sizeof(record));
+    WriteTraceRing(ring, head + sizeof(record), handles, size - sizeof(record));
+    ring->head.store(head + size, std::memory_order_release);
+    if (head - tail < TRACE_FLUSH_WATERMARK && head + size - tail >= TRACE_FLUSH_WATERMARK) RequestTraceFlush();
+}
+
+template <typename T>
+static uint64_t TraceHandle(T* handle) { return (uint64_t)(uintptr_t)handle; }
+static uint64_t TraceHandle(uint64_t handle) { return handle; }
+
+// Cost model. VK_MOCK_COST_MODEL names a JSON file that maps entrypoint names to the time a call takes, as
+//   "vkUpdateDescriptorSets": { "fixed_us": 2, "per_element_us": 0.25, "wait": "spin" }
+// where the elements of a call are the entries of its array parameters, such as descriptorWriteCount +
+// descriptorCopyCount. A call spins on the clock for its cost, so it shows up as CPU time in a profile like a real
+// driver's, or sleeps when "wait" is "sleep".
+struct EntrypointCost {
+    uint64_t fixed = 0;        // Nanoseconds
+    uint64_t per_element = 0;  // Nanoseconds
+    bool sleep = false;
+};
+
+struct CostModel {
+    std::atomic<bool> enabled{false};
+    bool loaded = false;
+    EntrypointCost costs[ENTRYPOINT_COUNT];
+};
+static CostModel cost_model;
+
+static bool LoadCostModel(const char* path, EntrypointCost* costs) {
+    JsonValue root;
+    if (!ParseJsonFile(path, &root) || root.type != JsonValue::OBJECT) return false;
+    for (size_t i = 0; i < root.keys.size(); ++i) {
+        // Unknown names are rejected rather than ignored, a misspelt entrypoint would silently cost nothing
+        const auto name = std::find_if(std::begin(entrypoint_names), std::end(entrypoint_names),
+                                       [&](const char* entrypoint_name) { return root.keys[i] == entrypoint_name; });
+        const JsonValue& entry = root.elements[i];
+        if (name == std::end(entrypoint_names) || entry.type != JsonValue::OBJECT) return false;
+        EntrypointCost& cost = costs[name - std::begin(entrypoint_names)];
+        const JsonValue* fixed = entry.Find("fixed_us");
+        const JsonValue* per_element = entry.Find("per_element_us");
+        const JsonValue* wait = entry.Find("wait");
+        cost.fixed = fixed ? (uint64_t)std::max(fixed->number * 1000.0, 0.0) : 0;
+        cost.per_element = per_element ? (uint64_t)std::max(per_element->number * 1000.0, 0.0) : 0;
+        cost.sleep = wait && wait->string == "sleep";
+    }
+    return true;
+}
+
+// Called by vkCreateInstance, fails if VK_MOCK_COST_MODEL names a cost model that cannot be read. Like the device
+// profile, the costs are only taken from a file that loads completely.
+static bool InitCostModel() {
+    unique_lock_t lock(global_lock);
+    if (cost_model.loaded) return true;
+    const char* path = getenv("VK_MOCK_COST_MODEL");
+    if (path && *path) {
+        std::unique_ptr<EntrypointCost[]> costs(new EntrypointCost[ENTRYPOINT_COUNT]);
+        if (!LoadCostModel(path, costs.get())) return false;
+        std::copy(costs.get(), costs.get() + ENTRYPOINT_COUNT, cost_model.costs);
+        cost_model.enabled = true;
+    }
+    cost_model.loaded = true;
+    return true;
+}
+
+static void ChargeCost(Entrypoint entrypoint, uint64_t elements) {
+    const EntrypointCost& cost = cost_model.costs[entrypoint];
+    const uint64_t duration = cost.fixed + cost.per_element * elements;
+    if (!duration) return;
+    if (cost.sleep) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(duration));
+        return;
+    }
+    const uint64_t end = GetDeviceTimestamp() + duration;
+    while (GetDeviceTimestamp() < end) {
+    }
+}
+
+
+// Live statistics. When VK_MOCK_STATS names a shared memory object, the first vkCreateInstance creates it and the
+// mock counts calls, objects, memory and descriptor pool failures in it for other processes to read while the
+// application runs, as vulkaninfo --watch-mock does. mock_icd_stats.h describes the layout. A thread owns a slot and
+// is its only writer, threads beyond the slots share the last one.
+static const uint32_t STATS_SLOT_COUNT = 64;
+
+// Counters of a slot, in this order
+enum StatsCounter : uint32_t {
+    STATS_CALLS = 0,                                                  // Per entrypoint
+    STATS_OBJECTS_CREATED = STATS_CALLS + ENTRYPOINT_COUNT,           // Per object type
+    STATS_OBJECTS_DESTROYED = STATS_OBJECTS_CREATED + STATS_OBJECT_COUNT,
+    STATS_MEMORY_ALLOCATED = STATS_OBJECTS_DESTROYED + STATS_OBJECT_COUNT,  // Bytes per heap
+    STATS_MEMORY_FREED = STATS_MEMORY_ALLOCATED + VK_MAX_MEMORY_HEAPS,
+    STATS_MEMORY_MAPPED = STATS_MEMORY_FREED + VK_MAX_MEMORY_HEAPS,    // First of the StatsTrailingCounter ones
+    STATS_MEMORY_UNMAPPED = STATS_MEMORY_MAPPED + STATS_TRAILING_MEMORY_UNMAPPED,
+    STATS_DESCRIPTOR_POOLS_EXHAUSTED = STATS_MEMORY_MAPPED + STATS_TRAILING_DESCRIPTOR_POOLS_EXHAUSTED,
+    STATS_DESCRIPTOR_POOLS_FRAGMENTED = STATS_MEMORY_MAPPED + STATS_TRAILING_DESCRIPTOR_POOLS_FRAGMENTED,
+    STATS_COUNTER_COUNT = STATS_MEMORY_MAPPED + STATS_TRAILING_COUNTER_COUNT
+};
+
+struct StatsSlot {
+    std::atomic<uint64_t> counters[STATS_COUNTER_COUNT];
+};
+static_assert(sizeof(StatsSlot) == STATS_COUNTER_COUNT * sizeof(uint64_t), "Readers see the counters as plain 64-bit integers");
+
+struct StatsWriter {
+    void Open() {
+#if defined(__linux__) || defined(__APPLE__)
+        const char* name = getenv("VK_MOCK_STATS");
+        if (!name || !*name) return;
+        shm_name = name[0] == '/' ? name : std::string("/") + name;
+        size_t names_size = 0;
+        for (auto entrypoint_name : entrypoint_names) names_size += strlen(entrypoint_name) + 1;
+        for (auto object_name : stats_object_names) names_size += strlen(object_name) + 1;
+        const size_t slots_offset = (sizeof(StatsHeader) + names_size + 63) & ~size_t(63);
+        const size_t size = slots_offset + STATS_SLOT_COUNT * sizeof(StatsSlot);
+        // A segment left under the name, by a process that crashed or still runs, is replaced rather than truncated,
+        // as truncating it would fault the process that maps it. Unlinking only removes the name, its mappings stay valid.
+        shm_unlink(shm_name.c_str());
+        const int fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) return;
+        void* data = MAP_FAILED;
+        if (ftruncate(fd, size) == 0) data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            shm_unlink(shm_name.c_str());
+            return;
+        }
+        // The segment is never unmapped, threads may still count into it while the process exits
+        header = static_cast<StatsHeader*>(data);
+        header->version = STATS_VERSION;
+        header->process_id = (uint32_t)getpid();
+        header->entrypoint_count = ENTRYPOINT_COUNT;
+        header->object_type_count = STATS_OBJECT_COUNT;
+        header->heap_count = VK_MAX_MEMORY_HEAPS;
+        header->slot_count = STATS_SLOT_COUNT;
+        header->counter_count = STATS_COUNTER_COUNT;
+        header->names_offset = sizeof(StatsHeader);
+        header->slots_offset = slots_offset;
+        char* names = static_cast<char*>(data) + sizeof(StatsHeader);
+        for (auto entrypoint_name : entrypoint_names) names = strcpy(names, entrypoint_name) + strlen(entrypoint_name) + 1;
+        for (auto object_name : stats_object_names) names = strcpy(names, object_name) + strlen(object_name) + 1;
+        slots = reinterpret_cast<StatsSlot*>(static_cast<char*>(data) + slots_offset);
+        // Readers check the magic last, once everything else is in place
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(header->magic, STATS_MAGIC, sizeof(STATS_MAGIC));
+        enabled.store(true, std::memory_order_release);
+#endif
+    }
+    ~StatsWriter() {
+#if defined(__linux__) || defined(__APPLE__)
+        if (enabled) shm_unlink(shm_name.c_str());
+#endif
+    }
+    std::atomic<bool> enabled{false};
+    std::string shm_name;
+    StatsHeader* header = nullptr;
+    StatsSlot* slots = nullptr;
+    mutex_t lock;  // Guards the slot assignment below
+    uint32_t slots_used = 0;
+    std::vector<StatsSlot*> free_slots;  // Slots of threads that have exited
+};
+static StatsWriter stats_writer;
+
+// Called by vkCreateInstance
+static void InitStats() {
+    static std::once_flag once;
+    std::call_once(once, [] { stats_writer.Open(); });
+}
+
+// Returns the slot the calling thread counts into, shared is set if other threads count into it too
+static StatsSlot* AcquireStatsSlot(bool* shared) {
+    lock_guard_t lock(stats_writer.lock);
+    *shared = false;
+    if (!stats_writer.free_slots.empty()) {
+        StatsSlot* slot = stats_writer.free_slots.back();
+        stats_writer.free_slots.pop_back();
+        return slot;
+    }
+    if (stats_writer.slots_used == STATS_SLOT_COUNT - 1) {
+        *shared = true;
+        return &stats_writer.slots[STATS_SLOT_COUNT - 1];
+    }
+    return &stats_writer.slots[stats_writer.slots_used++];
+}
+
+// A slot keeps its counts when its thread exits, the next thread to start continues from them
+static void ReleaseStatsSlot(StatsSlot* slot) {
+    lock_guard_t lock(stats_writer.lock);
+    stats_writer.free_slots.push_back(slot);
+}
+
+// Per thread state of the entrypoint calls in progress. Hands the thread's trace ring over to the flush thread
+// and its statistics slot to the next thread when the thread exits.
+struct EntrypointThread {
+    ~EntrypointThread() {
+        if (ring) {
+            ring->retired.store(true, std::memory_order_release);
+            RequestTraceFlush();
+        }
+        if (stats_slot && !stats_shared) ReleaseStatsSlot(stats_slot);
+    }
+    uint32_t depth = 0;  // Nesting of entrypoint calls, the mock calls its own entrypoints too
+    TraceRing* ring = nullptr;
+    StatsSlot* stats_slot = nullptr;
+    bool stats_shared = false;
+};
+static thread_local EntrypointThread entrypoint_thread;
+
+static void AddStat(uint32_t counter, uint64_t value) {
+    if (!stats_writer.enabled.load(std::memory_order_acquire) || !value) return;
+    EntrypointThread& thread = entrypoint_thread;
+    if (!thread.stats_slot) thread.stats_slot = AcquireStatsSlot(&thread.stats_shared);
+    std::atomic<uint64_t>& total = thread.stats_slot->counters[counter];
+    if (thread.stats_shared) {
+        total.fetch_add(value, std::memory_order_relaxed);
+    } else {
+        total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+}
+
+// Declared first in every entrypoint. Traces, counts and charges the cost of the call, unless the mock made the
+// call itself.
+class EntrypointScope {
+   public:
+    template <typename... Handles>
+    EntrypointScope(Entrypoint entrypoint, uint64_t elements, Handles... handles) {
+        if (!trace_writer.enabled && !stats_writer.enabled.load(std::memory_order_relaxed) && !cost_model.enabled.load(std::memory_order_relaxed)) return;
+        thread_ = &entrypoint_thread;
+        if (thread_->depth++ != 0) return;
+        outermost_ = true;
+        AddStat(STATS_CALLS + entrypoint, 1);
+        if (trace_writer.enabled) {
+            if (!thread_->ring) thread_->ring = CreateTraceRing();
+            const uint64_t values[] = {0, TraceHandle(handles)...};
+            AppendTraceRecord(thread_->ring, entrypoint, values + 1, sizeof...(handles));
+        }
+        if (cost_model.enabled.load(std::memory_order_relaxed)) ChargeCost(entrypoint, elements);
+    }
+    ~EntrypointScope() {
+        if (thread_) thread_->depth--;
+    }
+    EntrypointScope(const EntrypointScope&) = delete;
+    EntrypointScope& operator=(const EntrypointScope&) = delete;
+
+    // Objects the call creates or destroys, as requested by the application. A scope opened while nothing was
+    // enabled is outermost as well, which counts the instance of the vkCreateInstance that enables the statistics.
+    void CountCreated(StatsObject object, uint64_t count) {
+        if (outermost_ || !thread_) AddStat(STATS_OBJECTS_CREATED + object, count);
+    }
+    void CountDestroyed(StatsObject object, uint64_t count) {
+        if (outermost_) AddStat(STATS_OBJECTS_DESTROYED + object, count);
+    }
+    // Freeing an array of handles destroys its elements that are not VK_NULL_HANDLE
+    template <typename Handle>
+    void CountDestroyed(StatsObject object, const Handle* handles, uint32_t count) {
+        if (!outermost_) return;
+        AddStat(STATS_OBJECTS_DESTROYED + object,
+                std::count_if(handles, handles + count, [](Handle handle) { return handle != VK_NULL_HANDLE; }));
+    }
+
+   private:
+    EntrypointThread* thread_ = nullptr;
+    bool outermost_ = false;
+};
 '''
 
 # Manual code at the end of the cpp source file
@@ -194,9 +4902,9 @@ SOURCE_CPP_POSTFIX = '''
 
 static VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetPhysicalDeviceProcAddr(VkInstance instance, const char *funcName) {
     // TODO: This function should only care about physical device functions and return nullptr for other functions
-    const auto &item = name_to_funcptr_map.find(funcName);
-    if (item != name_to_funcptr_map.end()) {
-        return reinterpret_cast<PFN_vkVoidFunction>(item->second);
+    const auto item = name_to_funcptr_map.Find(funcName);
+    if (item) {
+        return reinterpret_cast<PFN_vkVoidFunction>(*item);
     }
     // Mock should intercept all functions so if we get here just return null
     return nullptr;
@@ -412,6 +5120,38 @@ EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateMacOSSurfaceMVK(
 
 '''
 
+# Object tables declared in SOURCE_CPP_PREFIX along with the state their objects hold, keyed by handle
+# type. The other non-dispatchable handle types get a generated table of ObjectState.
+OBJECT_TABLES = {
+    'VkBuffer': 'buffer_table',
+    'VkCommandPool': 'command_pool_table',
+    'VkDescriptorPool': 'descriptor_pool_table',
+    'VkDescriptorSet': 'descriptor_set_table',
+    'VkDescriptorSetLayout': 'descriptor_set_layout_table',
+    'VkDeviceMemory': 'device_memory_table',
+    'VkFence': 'fence_table',
+    'VkFramebuffer': 'framebuffer_table',
+    'VkImage': 'image_table',
+    'VkImageView': 'image_view_table',
+    'VkPipeline': 'pipeline_table',
+    'VkPipelineCache': 'pipeline_cache_table',
+    'VkQueryPool': 'query_pool_table',
+    'VkRenderPass': 'render_pass_table',
+    'VkSampler': 'sampler_table',
+    'VkSemaphore': 'semaphore_table',
+    'VkShaderModule': 'shader_module_table',
+    'VkSwapchainKHR': 'swapchain_table',
+}
+
+def ObjectTableName(handle_type):
+    if handle_type in OBJECT_TABLES:
+        return OBJECT_TABLES[handle_type]
+    return re.sub(r'([a-z0-9])([A-Z])', r'\1_\2', handle_type[2:]).lower() + '_table'
+
+# Creation entrypoints whose intercepts count the object they create themselves, once they know the call succeeds.
+# The others count them on entry.
+COUNTED_CREATE_INTERCEPTS = ['vkCreateInstance']
+
 CUSTOM_C_INTERCEPTS = {
 'vkCreateInstance': '''
     // TODO: If loader ver <=4 ICD must fail with VK_ERROR_INCOMPATIBLE_DRIVER for all vkCreateInstance calls with
@@ -420,56 +5160,73 @@ CUSTOM_C_INTERCEPTS = {
     if (loader_interface_version <= 4) {
         return VK_ERROR_INCOMPATIBLE_DRIVER;
     }
+    // The device profile is read once, every physical device query after this answers from it
+    if (!InitDeviceProfile() || !InitCostModel()) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    InitStats();
     *pInstance = (VkInstance)CreateDispObjHandle();
-    // TODO: If emulating specific device caps, will need to add intelligence here
+    entrypoint_scope.CountCreated(STATS_OBJECT_VkInstance, 1);
     return VK_SUCCESS;
 ''',
 'vkDestroyInstance': '''
-    // Destroy physical device
-    DestroyDispObjHandle((void*)physical_device);
+    // Destroy physical devices
+    unique_lock_t lock(global_lock);
+    for (uint32_t i = 0; i < physical_device_count; ++i) delete physical_devices[i];
+    physical_device_count = 0;
+    lock.unlock();
 
     DestroyDispObjHandle((void*)instance);
+    FlushTrace();
 ''',
 'vkEnumeratePhysicalDevices': '''
-    if (pPhysicalDevices) {
-        if (!physical_device) {
-            physical_device = (VkPhysicalDevice)CreateDispObjHandle();
-        }
-        *pPhysicalDevices = physical_device;
-    } else {
-        *pPhysicalDeviceCount = 1;
+    InitPhysicalDevices();
+    if (!pPhysicalDevices) {
+        *pPhysicalDeviceCount = physical_device_count;
+        return VK_SUCCESS;
     }
-    return VK_SUCCESS;
+    const uint32_t count = std::min(*pPhysicalDeviceCount, physical_device_count);
+    for (uint32_t i = 0; i < count; ++i) pPhysicalDevices[i] = reinterpret_cast<VkPhysicalDevice>(physical_devices[i]);
+    *pPhysicalDeviceCount = count;
+    return count < physical_device_count ? VK_INCOMPLETE : VK_SUCCESS;
 ''',
 'vkCreateDevice': '''
-    *pDevice = (VkDevice)CreateDispObjHandle();
+    auto new_device = new Device();
+    set_loader_magic_value(&new_device->loader_data);
+    const auto *group_info = lvl_find_in_chain<VkDeviceGroupDeviceCreateInfo>(pCreateInfo->pNext);
+    if (group_info && group_info->physicalDeviceCount) {
+        for (uint32_t i = 0; i < group_info->physicalDeviceCount; ++i) {
+            new_device->physical_devices.push_back(reinterpret_cast<PhysicalDevice*>(group_info->pPhysicalDevices[i]));
+        }
+    } else {
+        new_device->physical_devices.push_back(reinterpret_cast<PhysicalDevice*>(physicalDevice));
+    }
+    *pDevice = reinterpret_cast<VkDevice>(new_device);
     // TODO: If emulating specific device caps, will need to add intelligence here
     return VK_SUCCESS;
 ''',
 'vkDestroyDevice': '''
-    unique_lock_t lock(global_lock);
     // First destroy sub-device objects
-    // Destroy Queues
-    for (auto dev_queue_map_pair : queue_map) {
-        for (auto queue_family_map_pair : queue_map[dev_queue_map_pair.first]) {
-            for (auto index_queue_pair : queue_map[dev_queue_map_pair.first][queue_family_map_pair.first]) {
-                DestroyDispObjHandle((void*)index_queue_pair.second);
-            }
+    // Destroy Queues, stopping their workers. Only this device's queues, the others are still running.
+    Device* destroyed_device = reinterpret_cast<Device*>(device);
+    for (const auto& family_queues : destroyed_device->queues) {
+        for (auto queue : family_queues) {
+            if (queue) DestroyQueue(reinterpret_cast<Queue*>(queue));
         }
     }
-    queue_map.clear();
     // Now destroy device
-    DestroyDispObjHandle((void*)device);
+    delete destroyed_device;
     // TODO: If emulating specific device caps, will need to add intelligence here
 ''',
 'vkGetDeviceQueue': '''
-    unique_lock_t lock(global_lock);
-    auto queue = queue_map[device][queueFamilyIndex][queueIndex];
-    if (queue) {
-        *pQueue = queue;
-    } else {
-        *pQueue = queue_map[device][queueFamilyIndex][queueIndex] = (VkQueue)CreateDispObjHandle();
-    }
+    Device* mock_device = reinterpret_cast<Device*>(device);
+    unique_lock_t lock(mock_device->lock);
+    auto& queues = mock_device->queues;
+    if (queueFamilyIndex >= queues.size()) queues.resize(queueFamilyIndex + 1);
+    if (queueIndex >= queues[queueFamilyIndex].size()) queues[queueFamilyIndex].resize(queueIndex + 1);
+    VkQueue& queue = queues[queueFamilyIndex][queueIndex];
+    if (!queue) queue = reinterpret_cast<VkQueue>(CreateQueue(mock_device));
+    *pQueue = queue;
     // TODO: If emulating specific device caps, will need to add intelligence here
     return;
 ''',
@@ -486,23 +5243,22 @@ CUSTOM_C_INTERCEPTS = {
 'vkEnumerateInstanceExtensionProperties': '''
     // If requesting number of extensions, return that
     if (!pLayerName) {
-        if (!pProperties) {
-            *pPropertyCount = (uint32_t)instance_extension_map.size();
-        } else {
-            uint32_t i = 0;
-            for (const auto &name_ver_pair : instance_extension_map) {
+        uint32_t i = 0;
+        for (const auto &entry : instance_extension_map.entries) {
+            if (!entry.name) {
+                continue;
+            }
+            if (pProperties) {
                 if (i == *pPropertyCount) {
-                    break;
+                    return VK_INCOMPLETE;
                 }
-                std::strncpy(pProperties[i].extensionName, name_ver_pair.first.c_str(), sizeof(pProperties[i].extensionName));
+                std::strncpy(pProperties[i].extensionName, entry.name, sizeof(pProperties[i].extensionName));
                 pProperties[i].extensionName[sizeof(pProperties[i].extensionName) - 1] = 0;
-                pProperties[i].specVersion = name_ver_pair.second;
-                ++i;
-            }
-            if (i != instance_extension_map.size()) {
-                return VK_INCOMPLETE;
+                pProperties[i].specVersion = entry.value;
             }
+            ++i;
         }
+        *pPropertyCount = i;
     }
     // If requesting extension properties, fill in data struct for number of extensions
     return VK_SUCCESS;
@@ -510,23 +5266,22 @@ CUSTOM_C_INTERCEPTS = {
 'vkEnumerateDeviceExtensionProperties': '''
     // If requesting number of extensions, return that
     if (!pLayerName) {
-        if (!pProperties) {
-            *pPropertyCount = (uint32_t)device_extension_map.size();
-        } else {
-            uint32_t i = 0;
-            for (const auto &name_ver_pair : device_extension_map) {
+        uint32_t i = 0;
+        for (const auto &entry : device_extension_map.entries) {
+            if (!entry.name) {
+                continue;
+            }
+            if (pProperties) {
                 if (i == *pPropertyCount) {
-                    break;
+                    return VK_INCOMPLETE;
                 }
-                std::strncpy(pProperties[i].extensionName, name_ver_pair.first.c_str(), sizeof(pProperties[i].extensionName));
+                std::strncpy(pProperties[i].extensionName, entry.name, sizeof(pProperties[i].extensionName));
                 pProperties[i].extensionName[sizeof(pProperties[i].extensionName) - 1] = 0;
-                pProperties[i].specVersion = name_ver_pair.second;
-                ++i;
-            }
-            if (i != device_extension_map.size()) {
-                return VK_INCOMPLETE;
+                pProperties[i].specVersion = entry.value;
             }
+            ++i;
         }
+        *pPropertyCount = i;
     }
     // If requesting extension properties, fill in data struct for number of extensions
     return VK_SUCCESS;
@@ -648,9 +5403,9 @@ CUSTOM_C_INTERCEPTS = {
     if (!negotiate_loader_icd_interface_called) {
         loader_interface_version = 0;
     }
-    const auto &item = name_to_funcptr_map.find(pName);
-    if (item != name_to_funcptr_map.end()) {
-        return reinterpret_cast<PFN_vkVoidFunction>(item->second);
+    const auto item = name_to_funcptr_map.Find(pName);
+    if (item) {
+        return reinterpret_cast<PFN_vkVoidFunction>(*item);
     }
     // Mock should intercept all functions so if we get here just return null
     return nullptr;
@@ -659,43 +5414,42 @@ CUSTOM_C_INTERCEPTS = {
     return GetInstanceProcAddr(nullptr, pName);
 ''',
 'vkGetPhysicalDeviceMemoryProperties': '''
-    pMemoryProperties->memoryTypeCount = 2;
-    pMemoryProperties->memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-    pMemoryProperties->memoryTypes[0].heapIndex = 0;
-    pMemoryProperties->memoryTypes[1].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-    pMemoryProperties->memoryTypes[1].heapIndex = 1;
-    pMemoryProperties->memoryHeapCount = 2;
-    pMemoryProperties->memoryHeaps[0].flags = 0;
-    pMemoryProperties->memoryHeaps[0].size = 8000000000;
-    pMemoryProperties->memoryHeaps[1].flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
-    pMemoryProperties->memoryHeaps[1].size = 8000000000;
+    *pMemoryProperties = device_profile.memory_properties;
 ''',
 'vkGetPhysicalDeviceMemoryProperties2KHR': '''
     GetPhysicalDeviceMemoryProperties(physicalDevice, &pMemoryProperties->memoryProperties);
+    const auto *budget_props = lvl_find_in_chain<VkPhysicalDeviceMemoryBudgetPropertiesEXT>(pMemoryProperties->pNext);
+    if (budget_props) {
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT* write_props = (VkPhysicalDeviceMemoryBudgetPropertiesEXT*)budget_props;
+        const VkPhysicalDeviceMemoryProperties& memory_properties = device_profile.memory_properties;
+        const PhysicalDevice* physical_device = reinterpret_cast<PhysicalDevice*>(physicalDevice);
+        for (uint32_t i = 0; i < VK_MAX_MEMORY_HEAPS; ++i) {
+            const bool used = i < memory_properties.memoryHeapCount;
+            write_props->heapBudget[i] = used ? memory_properties.memoryHeaps[i].size : 0;
+            write_props->heapUsage[i] = used ? physical_device->heap_usage[i].load(std::memory_order_relaxed) : 0;
+        }
+    }
 ''',
 'vkGetPhysicalDeviceQueueFamilyProperties': '''
     if (!pQueueFamilyProperties) {
-        *pQueueFamilyPropertyCount = 1;
+        *pQueueFamilyPropertyCount = device_profile.queue_family_count;
     } else {
-        if (*pQueueFamilyPropertyCount) {
-            pQueueFamilyProperties[0].queueFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT | VK_QUEUE_SPARSE_BINDING_BIT;
-            pQueueFamilyProperties[0].queueCount = 1;
-            pQueueFamilyProperties[0].timestampValidBits = 0;
-            pQueueFamilyProperties[0].minImageTransferGranularity = {1,1,1};
-        }
+        *pQueueFamilyPropertyCount = std::min(*pQueueFamilyPropertyCount, device_profile.queue_family_count);
+        memcpy(pQueueFamilyProperties, device_profile.queue_families, *pQueueFamilyPropertyCount * sizeof(VkQueueFamilyProperties));
     }
 ''',
 'vkGetPhysicalDeviceQueueFamilyProperties2KHR': '''
-    if (pQueueFamilyPropertyCount && pQueueFamilyProperties) {
-        GetPhysicalDeviceQueueFamilyProperties(physicalDevice, pQueueFamilyPropertyCount, &pQueueFamilyProperties->queueFamilyProperties);
+    if (!pQueueFamilyProperties) {
+        *pQueueFamilyPropertyCount = device_profile.queue_family_count;
     } else {
-        GetPhysicalDeviceQueueFamilyProperties(physicalDevice, pQueueFamilyPropertyCount, nullptr);
+        *pQueueFamilyPropertyCount = std::min(*pQueueFamilyPropertyCount, device_profile.queue_family_count);
+        for (uint32_t i = 0; i < *pQueueFamilyPropertyCount; ++i) {
+            pQueueFamilyProperties[i].queueFamilyProperties = device_profile.queue_families[i];
+        }
     }
 ''',
 'vkGetPhysicalDeviceFeatures': '''
-    uint32_t num_bools = sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32);
-    VkBool32 *bool_array = &pFeatures->robustBufferAccess;
-    SetBoolArrayTrue(bool_array, num_bools);
+    *pFeatures = device_profile.features;
 ''',
 'vkGetPhysicalDeviceFeatures2KHR': '''
     GetPhysicalDeviceFeatures(physicalDevice, &pFeatures->features);
@@ -715,50 +5469,94 @@ CUSTOM_C_INTERCEPTS = {
         feat_bools = (VkBool32*)&blendop_features->advancedBlendCoherentOperations;
         SetBoolArrayTrue(feat_bools, num_bools);
     }
+    const auto *timeline_features = lvl_find_in_chain<VkPhysicalDeviceTimelineSemaphoreFeatures>(pFeatures->pNext);
+    if (timeline_features) {
+        ((VkPhysicalDeviceTimelineSemaphoreFeatures*)timeline_features)->timelineSemaphore = VK_TRUE;
+    }
+    const auto *host_query_reset_features = lvl_find_in_chain<VkPhysicalDeviceHostQueryResetFeatures>(pFeatures->pNext);
+    if (host_query_reset_features) {
+        ((VkPhysicalDeviceHostQueryResetFeatures*)host_query_reset_features)->hostQueryReset = VK_TRUE;
+    }
 ''',
 'vkGetPhysicalDeviceFormatProperties': '''
-    if (VK_FORMAT_UNDEFINED == format) {
-        *pFormatProperties = { 0x0, 0x0, 0x0 };
-    } else {
-        // TODO: Just returning full support for everything initially
-        *pFormatProperties = { 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF };
-    }
+    const VkFormatProperties* format_properties = GetProfileFormatProperties(format);
+    *pFormatProperties = format_properties ? *format_properties : VkFormatProperties{ 0x0, 0x0, 0x0 };
 ''',
 'vkGetPhysicalDeviceFormatProperties2KHR': '''
     GetPhysicalDeviceFormatProperties(physicalDevice, format, &pFormatProperties->formatProperties);
 ''',
 'vkGetPhysicalDeviceImageFormatProperties': '''
-    // A hardcoded unsupported format
-    if (format == VK_FORMAT_E5B9G9R9_UFLOAT_PACK32) {
+    const VkFormatProperties* format_properties = GetProfileFormatProperties(format);
+    const VkFormatFeatureFlags features = !format_properties ? 0 :
+        VK_IMAGE_TILING_LINEAR == tiling ? format_properties->linearTilingFeatures : format_properties->optimalTilingFeatures;
+    if (!features) {
         return VK_ERROR_FORMAT_NOT_SUPPORTED;
     }
-
-    // TODO: Just hard-coding some values for now
-    // TODO: If tiling is linear, limit the mips, levels, & sample count
-    if (VK_IMAGE_TILING_LINEAR == tiling) {
-        *pImageFormatProperties = { { 4096, 4096, 256 }, 1, 1, VK_SAMPLE_COUNT_1_BIT, 4294967296 };
-    } else {
-        // We hard-code support for all sample counts except 64 bits.
-        *pImageFormatProperties = { { 4096, 4096, 256 }, 12, 256, 0x7F & ~VK_SAMPLE_COUNT_64_BIT, 4294967296 };
+    if (!device_profile.from_file) {
+        // A hardcoded unsupported format
+        if (format == VK_FORMAT_E5B9G9R9_UFLOAT_PACK32) {
+            return VK_ERROR_FORMAT_NOT_SUPPORTED;
+        }
+        if (VK_IMAGE_TILING_LINEAR == tiling) {
+            *pImageFormatProperties = { { 4096, 4096, 256 }, 1, 1, VK_SAMPLE_COUNT_1_BIT, 4294967296 };
+        } else {
+            // We hard-code support for all sample counts except 64 bits.
+            *pImageFormatProperties = { { 4096, 4096, 256 }, 12, 256, 0x7F & ~VK_SAMPLE_COUNT_64_BIT, 4294967296 };
+        }
+        return VK_SUCCESS;
+    }
+
+    // Otherwise derive the answer from the profile's format features and limits
+    static const struct { VkImageUsageFlags usage; VkFormatFeatureFlags feature; } usage_features[] = {
+        { VK_IMAGE_USAGE_SAMPLED_BIT, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT },
+        { VK_IMAGE_USAGE_STORAGE_BIT, VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT },
+        { VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT },
+        { VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT },
+    };
+    for (const auto& usage_feature : usage_features) {
+        if ((usage & usage_feature.usage) && !(features & usage_feature.feature)) {
+            return VK_ERROR_FORMAT_NOT_SUPPORTED;
+        }
+    }
+    const VkPhysicalDeviceLimits& limits = device_profile.properties.limits;
+    uint32_t max_dimension;
+    switch (type) {
+        case VK_IMAGE_TYPE_1D:
+            max_dimension = limits.maxImageDimension1D;
+            pImageFormatProperties->maxExtent = { max_dimension, 1, 1 };
+            break;
+        case VK_IMAGE_TYPE_3D:
+            max_dimension = limits.maxImageDimension3D;
+            pImageFormatProperties->maxExtent = { max_dimension, max_dimension, max_dimension };
+            break;
+        default:
+            max_dimension = (flags & VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT) ? limits.maxImageDimensionCube : limits.maxImageDimension2D;
+            pImageFormatProperties->maxExtent = { max_dimension, max_dimension, 1 };
+            break;
+    }
+    uint32_t mip_levels = 1;
+    while (max_dimension >> mip_levels) ++mip_levels;
+    const bool linear = VK_IMAGE_TILING_LINEAR == tiling;
+    pImageFormatProperties->maxMipLevels = linear ? 1 : mip_levels;
+    pImageFormatProperties->maxArrayLayers = (linear || VK_IMAGE_TYPE_3D == type) ? 1 : limits.maxImageArrayLayers;
+    pImageFormatProperties->sampleCounts = VK_SAMPLE_COUNT_1_BIT;
+    if (!linear && VK_IMAGE_TYPE_2D == type && !(flags & VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT)) {
+        pImageFormatProperties->sampleCounts = (features & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) ?
+            limits.framebufferDepthSampleCounts : limits.framebufferColorSampleCounts;
+        if (usage & VK_IMAGE_USAGE_STORAGE_BIT) pImageFormatProperties->sampleCounts &= limits.storageImageSampleCounts;
+        pImageFormatProperties->sampleCounts |= VK_SAMPLE_COUNT_1_BIT;
+    }
+    pImageFormatProperties->maxResourceSize = 0;
+    for (uint32_t i = 0; i < device_profile.memory_properties.memoryHeapCount; ++i) {
+        pImageFormatProperties->maxResourceSize = std::max(pImageFormatProperties->maxResourceSize, device_profile.memory_properties.memoryHeaps[i].size);
     }
     return VK_SUCCESS;
 ''',
 'vkGetPhysicalDeviceImageFormatProperties2KHR': '''
-    GetPhysicalDeviceImageFormatProperties(physicalDevice, pImageFormatInfo->format, pImageFormatInfo->type, pImageFormatInfo->tiling, pImageFormatInfo->usage, pImageFormatInfo->flags, &pImageFormatProperties->imageFormatProperties);
-    return VK_SUCCESS;
+    return GetPhysicalDeviceImageFormatProperties(physicalDevice, pImageFormatInfo->format, pImageFormatInfo->type, pImageFormatInfo->tiling, pImageFormatInfo->usage, pImageFormatInfo->flags, &pImageFormatProperties->imageFormatProperties);
 ''',
 'vkGetPhysicalDeviceProperties': '''
-    // TODO: Just hard-coding some values for now
-    pProperties->apiVersion = VK_API_VERSION_1_0;
-    pProperties->driverVersion = 1;
-    pProperties->vendorID = 0xba5eba11;
-    pProperties->deviceID = 0xf005ba11;
-    pProperties->deviceType = VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU;
-    //std::string devName = "Vulkan Mock Device";
-    strcpy(pProperties->deviceName, "Vulkan Mock Device");
-    pProperties->pipelineCacheUUID[0] = 18;
-    pProperties->limits = SetLimits(&pProperties->limits);
-    pProperties->sparseProperties = { VK_TRUE, VK_TRUE, VK_TRUE, VK_TRUE, VK_TRUE };
+    *pProperties = device_profile.properties;
 ''',
 'vkGetPhysicalDeviceProperties2KHR': '''
     GetPhysicalDeviceProperties(physicalDevice, &pProperties->properties);
@@ -802,6 +5600,24 @@ CUSTOM_C_INTERCEPTS = {
         write_props->supportedDepthResolveModes = VK_RESOLVE_MODE_SAMPLE_ZERO_BIT_KHR;
         write_props->supportedStencilResolveModes = VK_RESOLVE_MODE_SAMPLE_ZERO_BIT_KHR;
     }
+
+    const auto *timeline_semaphore_props = lvl_find_in_chain<VkPhysicalDeviceTimelineSemaphoreProperties>(pProperties->pNext);
+    if (timeline_semaphore_props) {
+        VkPhysicalDeviceTimelineSemaphoreProperties* write_props = (VkPhysicalDeviceTimelineSemaphoreProperties*)timeline_semaphore_props;
+        write_props->maxTimelineSemaphoreValueDifference = UINT64_MAX;
+    }
+
+    const auto *id_props = lvl_find_in_chain<VkPhysicalDeviceIDProperties>(pProperties->pNext);
+    if (id_props) {
+        VkPhysicalDeviceIDProperties* write_props = (VkPhysicalDeviceIDProperties*)id_props;
+        // Physical devices only differ in the last byte of their UUID
+        memcpy(write_props->deviceUUID, PIPELINE_CACHE_UUID, VK_UUID_SIZE);
+        write_props->deviceUUID[VK_UUID_SIZE - 1] = (uint8_t)reinterpret_cast<PhysicalDevice*>(physicalDevice)->index;
+        memcpy(write_props->driverUUID, PIPELINE_CACHE_UUID, VK_UUID_SIZE);
+        memset(write_props->deviceLUID, 0, VK_LUID_SIZE);
+        write_props->deviceNodeMask = 0;
+        write_props->deviceLUIDValid = VK_FALSE;
+    }
 ''',
 'vkGetPhysicalDeviceExternalSemaphoreProperties':'''
     // Hard code support for all handle types and features
@@ -809,6 +5625,30 @@ CUSTOM_C_INTERCEPTS = {
     pExternalSemaphoreProperties->compatibleHandleTypes = 0x1F;
     pExternalSemaphoreProperties->externalSemaphoreFeatures = 0x3;
 ''',
+'vkEnumeratePhysicalDeviceGroupsKHR': '''
+    InitPhysicalDevices();
+    const uint32_t group_count = physical_device_group ? 1 : physical_device_count;
+    if (!pPhysicalDeviceGroupProperties) {
+        *pPhysicalDeviceGroupCount = group_count;
+        return VK_SUCCESS;
+    }
+    const uint32_t count = std::min(*pPhysicalDeviceGroupCount, group_count);
+    for (uint32_t i = 0; i < count; ++i) {
+        VkPhysicalDeviceGroupProperties& group = pPhysicalDeviceGroupProperties[i];
+        group.physicalDeviceCount = physical_device_group ? physical_device_count : 1;
+        for (uint32_t j = 0; j < group.physicalDeviceCount; ++j) {
+            group.physicalDevices[j] = reinterpret_cast<VkPhysicalDevice>(physical_devices[physical_device_group ? j : i]);
+        }
+        group.subsetAllocation = group.physicalDeviceCount > 1;
+    }
+    *pPhysicalDeviceGroupCount = count;
+    return count < group_count ? VK_INCOMPLETE : VK_SUCCESS;
+''',
+'vkGetDeviceGroupPeerMemoryFeaturesKHR': '''
+    // The physical devices of a group share all their memory
+    *pPeerMemoryFeatures = VK_PEER_MEMORY_FEATURE_COPY_SRC_BIT | VK_PEER_MEMORY_FEATURE_COPY_DST_BIT |
+                           VK_PEER_MEMORY_FEATURE_GENERIC_SRC_BIT | VK_PEER_MEMORY_FEATURE_GENERIC_DST_BIT;
+''',
 'vkGetPhysicalDeviceExternalSemaphorePropertiesKHR':'''
     GetPhysicalDeviceExternalSemaphoreProperties(physicalDevice, pExternalSemaphoreInfo, pExternalSemaphoreProperties);
 ''',
@@ -834,75 +5674,861 @@ CUSTOM_C_INTERCEPTS = {
     // TODO: Just hard-coding reqs for now
     pMemoryRequirements->size = 4096;
     pMemoryRequirements->alignment = 1;
-    pMemoryRequirements->memoryTypeBits = 0xFFFF;
+    pMemoryRequirements->memoryTypeBits = GetMemoryTypeBits();
     // Return a better size based on the buffer size from the create info.
-    auto d_iter = buffer_map.find(device);
-    if (d_iter != buffer_map.end()) {
-        auto iter = d_iter->second.find(buffer);
-        if (iter != d_iter->second.end()) {
-            pMemoryRequirements->size = ((iter->second.size + 4095) / 4096) * 4096;
-        }
+    if (const Buffer* buffer_state = buffer_table.Get(buffer)) {
+        pMemoryRequirements->size = ((buffer_state->create_info.size + 4095) / 4096) * 4096;
     }
 ''',
 'vkGetBufferMemoryRequirements2KHR': '''
     GetBufferMemoryRequirements(device, pInfo->buffer, &pMemoryRequirements->memoryRequirements);
 ''',
 'vkGetImageMemoryRequirements': '''
-    // TODO: Just hard-coding reqs for now
-    pMemoryRequirements->size = 4096;
-    pMemoryRequirements->alignment = 1;
+    const Image* image_state = image_table.Get(image);
+    pMemoryRequirements->size = image_state ? AlignDeviceSize(image_state->plane_offsets[MAX_FORMAT_PLANES], IMAGE_ALIGNMENT) : IMAGE_ALIGNMENT;
+    pMemoryRequirements->alignment = IMAGE_ALIGNMENT;
 
     // Here we hard-code that the memory type at index 3 doesn't support this image.
-    pMemoryRequirements->memoryTypeBits = 0xFFFF & ~(0x1 << 3);
+    pMemoryRequirements->memoryTypeBits = GetMemoryTypeBits() & ~(0x1 << 3);
 ''',
 'vkGetImageMemoryRequirements2KHR': '''
     GetImageMemoryRequirements(device, pInfo->image, &pMemoryRequirements->memoryRequirements);
+    // The planes of disjoint images are bound one at a time
+    const auto *plane_info = lvl_find_in_chain<VkImagePlaneMemoryRequirementsInfo>(pInfo->pNext);
+    const Image* image_state = image_table.Get(pInfo->image);
+    if (plane_info && image_state && (image_state->create_info.flags & VK_IMAGE_CREATE_DISJOINT_BIT)) {
+        const uint32_t plane = GetAspectPlane(plane_info->planeAspect);
+        const VkDeviceSize plane_size = image_state->plane_offsets[plane + 1] - image_state->plane_offsets[plane];
+        pMemoryRequirements->memoryRequirements.size = AlignDeviceSize(plane_size, IMAGE_ALIGNMENT);
+    }
+''',
+'vkBindBufferMemory': '''
+    if (Buffer* buffer_state = buffer_table.Get(buffer)) buffer_state->binding = {memory, memoryOffset};
+    return VK_SUCCESS;
+''',
+'vkBindBufferMemory2KHR': '''
+    for (uint32_t i = 0; i < bindInfoCount; ++i) {
+        BindBufferMemory(device, pBindInfos[i].buffer, pBindInfos[i].memory, pBindInfos[i].memoryOffset);
+    }
+    return VK_SUCCESS;
+''',
+'vkBindImageMemory': '''
+    if (Image* image_state = image_table.Get(image)) {
+        for (auto& binding : image_state->bindings) binding = {memory, memoryOffset};
+    }
+    return VK_SUCCESS;
+''',
+'vkBindImageMemory2KHR': '''
+    for (uint32_t i = 0; i < bindInfoCount; ++i) {
+        const auto *plane_info = lvl_find_in_chain<VkBindImagePlaneMemoryInfo>(pBindInfos[i].pNext);
+        Image* image_state = image_table.Get(pBindInfos[i].image);
+        if (plane_info && image_state) {
+            image_state->bindings[GetAspectPlane(plane_info->planeAspect)] = {pBindInfos[i].memory, pBindInfos[i].memoryOffset};
+        } else {
+            BindImageMemory(device, pBindInfos[i].image, pBindInfos[i].memory, pBindInfos[i].memoryOffset);
+        }
+    }
+    return VK_SUCCESS;
+''',
+'vkAllocateMemory': '''
+    DeviceMemory memory;
+    memory.allocation_size = pAllocateInfo->allocationSize;
+    memory.heap_index = device_profile.memory_properties.memoryTypes[pAllocateInfo->memoryTypeIndex].heapIndex;
+    memory.physical_device_mask = GetAllocationPhysicalDeviceMask(*reinterpret_cast<Device*>(device),
+                                                                  lvl_find_in_chain<VkMemoryAllocateFlagsInfo>(pAllocateInfo->pNext));
+    memory.mapped_size = 0;
+    // A full heap fails before anything is allocated
+    if (!ReserveHeapMemory(memory.physical_device_mask, memory.heap_index, memory.allocation_size)) {
+        entrypoint_scope.CountDestroyed(STATS_OBJECT_VkDeviceMemory, 1);
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+    VkResult result = VK_SUCCESS;
+    const auto *import_fd_info = lvl_find_in_chain<VkImportMemoryFdInfoKHR>(pAllocateInfo->pNext);
+    const auto *export_info = lvl_find_in_chain<VkExportMemoryAllocateInfo>(pAllocateInfo->pNext);
+    if (import_fd_info && import_fd_info->handleType) {
+        // On success the implementation owns the fd, it is closed when the memory is freed
+        if (!ImportDeviceMemoryFd(import_fd_info->fd, pAllocateInfo->allocationSize, &memory)) result = VK_ERROR_INVALID_EXTERNAL_HANDLE;
+    } else if (export_info && (export_info->handleTypes & VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT)) {
+        if (!AllocateDeviceMemoryFd(pAllocateInfo->allocationSize, &memory)) result = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    } else if (!AllocateDeviceMemoryBacking(pAllocateInfo->allocationSize, &memory)) {
+        result = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+    if (result != VK_SUCCESS) {
+        ReleaseHeapMemory(memory.physical_device_mask, memory.heap_index, memory.allocation_size);
+        entrypoint_scope.CountDestroyed(STATS_OBJECT_VkDeviceMemory, 1);
+        return result;
+    }
+    AddStat(STATS_MEMORY_ALLOCATED + memory.heap_index, memory.allocation_size);
+    *pMemory = (VkDeviceMemory)device_memory_table.Create(memory);
+    return VK_SUCCESS;
+''',
+'vkFreeMemory': '''
+    DeviceMemory* device_memory = device_memory_table.Get(memory);
+    if (!device_memory) return;
+    DeviceMemory backing = *device_memory;
+    device_memory_table.Destroy(memory);
+    // Freeing memory implicitly unmaps it
+    AddStat(STATS_MEMORY_UNMAPPED, backing.mapped_size);
+    AddStat(STATS_MEMORY_FREED + backing.heap_index, backing.allocation_size);
+    FreeDeviceMemoryBacking(backing);
+    ReleaseHeapMemory(backing.physical_device_mask, backing.heap_index, backing.allocation_size);
 ''',
 'vkMapMemory': '''
-    unique_lock_t lock(global_lock);
-    // TODO: Just hard-coding 64k whole size for now
-    if (VK_WHOLE_SIZE == size)
-        size = 0x10000;
-    void* map_addr = malloc((size_t)size);
-    mapped_memory_map[memory].push_back(map_addr);
-    *ppData = map_addr;
+    DeviceMemory* device_memory = device_memory_table.Get(memory);
+    if (!device_memory) return VK_ERROR_MEMORY_MAP_FAILED;
+    // Mappings point straight into the backing store, so they persist and keep their contents across unmap
+    *ppData = static_cast<char*>(device_memory->data) + offset;
+    device_memory->mapped_size = size == VK_WHOLE_SIZE ? device_memory->allocation_size - offset : size;
+    AddStat(STATS_MEMORY_MAPPED, device_memory->mapped_size);
+    return VK_SUCCESS;
+''',
+'vkGetMemoryFdKHR': '''
+    DeviceMemory* device_memory = device_memory_table.Get(pGetFdInfo->memory);
+    if (!device_memory || device_memory->fd < 0) return VK_ERROR_TOO_MANY_OBJECTS;
+#if defined(__linux__)
+    // Each export hands out a new reference to the same memfd, owned by the application
+    *pFd = dup(device_memory->fd);
+    if (*pFd < 0) return VK_ERROR_TOO_MANY_OBJECTS;
+    return VK_SUCCESS;
+#else
+    return VK_ERROR_TOO_MANY_OBJECTS;
+#endif
+''',
+'vkGetMemoryFdPropertiesKHR': '''
+    // Opaque fds are imported through AllocateInfo, only non-opaque types report properties
+    if (handleType == VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT) return VK_ERROR_INVALID_EXTERNAL_HANDLE;
+    pMemoryFdProperties->memoryTypeBits = 0x3;
     return VK_SUCCESS;
 ''',
 'vkUnmapMemory': '''
-    unique_lock_t lock(global_lock);
-    for (auto map_addr : mapped_memory_map[memory]) {
-        free(map_addr);
-    }
-    mapped_memory_map.erase(memory);
+    // Mappings alias the backing store which lives until the memory is freed, nothing to release here
+    DeviceMemory* device_memory = device_memory_table.Get(memory);
+    if (!device_memory) return;
+    AddStat(STATS_MEMORY_UNMAPPED, device_memory->mapped_size);
+    device_memory->mapped_size = 0;
 ''',
 'vkGetImageSubresourceLayout': '''
     // Need safe values. Callers are computing memory offsets from pLayout, with no return code to flag failure. 
     *pLayout = VkSubresourceLayout(); // Default constructor zero values.
+    const Image* image_state = image_table.Get(image);
+    if (!image_state) return;
+    const VkImageCreateInfo& info = image_state->create_info;
+    const uint32_t plane = GetAspectPlane(pSubresource->aspectMask);
+    const size_t index = plane * info.mipLevels + pSubresource->mipLevel;
+    if (pSubresource->mipLevel >= info.mipLevels || pSubresource->arrayLayer >= info.arrayLayers || index >= image_state->subresources.size()) return;
+    *pLayout = image_state->subresources[index];
+    pLayout->offset += pSubresource->arrayLayer * pLayout->arrayPitch;
+    // Offsets into the planes of disjoint images are relative to the memory bound to the plane
+    if (info.flags & VK_IMAGE_CREATE_DISJOINT_BIT) pLayout->offset -= image_state->plane_offsets[plane];
+''',
+'vkCreateSwapchainKHR': '''
+    Swapchain new_swapchain;
+    new_swapchain.present_mode = pCreateInfo->presentMode;
+    new_swapchain.format = pCreateInfo->imageFormat;
+    new_swapchain.extent = pCreateInfo->imageExtent;
+    // Swapchain images answer layout queries like the images the application creates
+    VkImageCreateInfo image_info = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+    image_info.flags = (pCreateInfo->flags & VK_SWAPCHAIN_CREATE_MUTABLE_FORMAT_BIT_KHR) ? VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT : 0;
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.format = pCreateInfo->imageFormat;
+    image_info.extent = {pCreateInfo->imageExtent.width, pCreateInfo->imageExtent.height, 1};
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = pCreateInfo->imageArrayLayers;
+    image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_info.usage = pCreateInfo->imageUsage;
+    image_info.sharingMode = pCreateInfo->imageSharingMode;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    const Image image_state = CreateImageState(image_info);
+    new_swapchain.image_size = (size_t)image_state.plane_offsets[MAX_FORMAT_PLANES];
+    new_swapchain.row_pitch = (size_t)image_state.subresources[0].rowPitch;
+    // One image is always on screen, so it takes two to have one to acquire
+    const uint32_t image_count = IsSharedPresentMode(pCreateInfo->presentMode) ? 1 : std::max(pCreateInfo->minImageCount, 2u);
+    for (uint32_t i = 0; i < image_count; ++i) {
+        void* data = AllocateBackingPages(std::max<size_t>(new_swapchain.image_size, 1));
+        if (!data) {
+            DestroySwapchainImages(&new_swapchain);
+            return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+        }
+        Image image = image_state;
+        image.swapchain_data = static_cast<char*>(data);
+        new_swapchain.images.push_back((VkImage)image_table.Create(std::move(image)));
+        new_swapchain.image_data.push_back(data);
+        new_swapchain.available.push_back(i);
+    }
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->sync_lock);
+    if (Swapchain* old_swapchain = swapchain_table.Get(pCreateInfo->oldSwapchain)) old_swapchain->retired = true;
+    *pSwapchain = (VkSwapchainKHR)swapchain_table.Create(std::move(new_swapchain));
+    return VK_SUCCESS;
+''',
+'vkDestroySwapchainKHR': '''
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->sync_lock);
+    if (Swapchain* destroyed_swapchain = swapchain_table.Get(swapchain)) {
+        // Presents still queued read the images, so the last of them destroys the swapchain instead
+        if (destroyed_swapchain->pending_presents) {
+            destroyed_swapchain->destroyed = true;
+            destroyed_swapchain->retired = true;
+        } else {
+            DestroySwapchainImages(destroyed_swapchain);
+            swapchain_table.Destroy(swapchain);
+        }
+    }
 ''',
 'vkGetSwapchainImagesKHR': '''
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->sync_lock);
+    const Swapchain* images_swapchain = swapchain_table.Get(swapchain);
+    if (!images_swapchain || images_swapchain->destroyed) {
+        *pSwapchainImageCount = 0;
+        return VK_ERROR_OUT_OF_DATE_KHR;
+    }
+    const std::vector<VkImage>& images = images_swapchain->images;
     if (!pSwapchainImages) {
-        *pSwapchainImageCount = 1;
-    } else if (*pSwapchainImageCount > 0) {
-        pSwapchainImages[0] = (VkImage)global_unique_handle++;
-        if (*pSwapchainImageCount != 1) {
-            return VK_INCOMPLETE;
+        *pSwapchainImageCount = (uint32_t)images.size();
+        return VK_SUCCESS;
+    }
+    const uint32_t count = std::min(*pSwapchainImageCount, (uint32_t)images.size());
+    std::copy(images.begin(), images.begin() + count, pSwapchainImages);
+    *pSwapchainImageCount = count;
+    return count < images.size() ? VK_INCOMPLETE : VK_SUCCESS;
+''',
+'vkAcquireNextImageKHR': '''
+    return AcquireNextImage(reinterpret_cast<Device*>(device), swapchain, timeout, semaphore, fence, pImageIndex);
+''',
+'vkAcquireNextImage2KHR': '''
+    return AcquireNextImage(reinterpret_cast<Device*>(device), pAcquireInfo->swapchain, pAcquireInfo->timeout, pAcquireInfo->semaphore,
+                            pAcquireInfo->fence, pImageIndex);
+''',
+'vkQueuePresentKHR': '''
+    // Images go to the presentation engine once the semaphores are waited for in queue order
+    Queue* present_queue = reinterpret_cast<Queue*>(queue);
+    std::vector<Submission> submissions(1);
+    VkResult result = VK_SUCCESS;
+    unique_lock_t lock(present_queue->device->sync_lock);
+    for (uint32_t i = 0; i < pPresentInfo->waitSemaphoreCount; ++i) AddSemaphoreWait(&submissions[0], pPresentInfo->pWaitSemaphores[i], 0);
+    for (uint32_t i = 0; i < pPresentInfo->swapchainCount; ++i) {
+        // Images of a swapchain that was replaced are not shown any more
+        Swapchain* swapchain = swapchain_table.Get(pPresentInfo->pSwapchains[i]);
+        const VkResult swapchain_result = swapchain && !swapchain->retired ? VK_SUCCESS : VK_ERROR_OUT_OF_DATE_KHR;
+        if (swapchain_result == VK_SUCCESS) {
+            swapchain->pending_presents++;
+            submissions[0].presents.emplace_back(pPresentInfo->pSwapchains[i], pPresentInfo->pImageIndices[i]);
+        } else {
+            result = swapchain_result;
+        }
+        if (pPresentInfo->pResults) pPresentInfo->pResults[i] = swapchain_result;
+    }
+    lock.unlock();
+    EnqueueSubmissions(present_queue, submissions);
+    return result;
+''',
+'vkQueueSubmit': '''
+    Queue* submit_queue = reinterpret_cast<Queue*>(queue);
+    std::vector<Submission> submissions(submitCount);
+    unique_lock_t lock(submit_queue->device->sync_lock);
+    for (uint32_t i = 0; i < submitCount; ++i) {
+        const VkSubmitInfo& submit = pSubmits[i];
+        const auto *timeline_info = lvl_find_in_chain<VkTimelineSemaphoreSubmitInfo>(submit.pNext);
+        for (uint32_t j = 0; j < submit.waitSemaphoreCount; ++j) {
+            AddSemaphoreWait(&submissions[i], submit.pWaitSemaphores[j], GetTimelineWaitValue(timeline_info, j));
+        }
+        for (uint32_t j = 0; j < submit.signalSemaphoreCount; ++j) {
+            AddSemaphoreSignal(&submissions[i], submit.pSignalSemaphores[j], GetTimelineSignalValue(timeline_info, j));
+        }
+        submissions[i].command_buffers.assign(submit.pCommandBuffers, submit.pCommandBuffers + submit.commandBufferCount);
+    }
+    if (fence != VK_NULL_HANDLE) {
+        if (submissions.empty()) submissions.resize(1);
+        submissions.back().fence = GetFence(fence);
+    }
+    lock.unlock();
+    EnqueueSubmissions(submit_queue, submissions);
+    return VK_SUCCESS;
+''',
+'vkQueueBindSparse': '''
+    // Binds take effect immediately, only the semaphores and fence go through the queue
+    Queue* bind_queue = reinterpret_cast<Queue*>(queue);
+    std::vector<Submission> submissions(bindInfoCount);
+    unique_lock_t lock(bind_queue->device->sync_lock);
+    for (uint32_t i = 0; i < bindInfoCount; ++i) {
+        const VkBindSparseInfo& bind = pBindInfo[i];
+        const auto *timeline_info = lvl_find_in_chain<VkTimelineSemaphoreSubmitInfo>(bind.pNext);
+        for (uint32_t j = 0; j < bind.waitSemaphoreCount; ++j) {
+            AddSemaphoreWait(&submissions[i], bind.pWaitSemaphores[j], GetTimelineWaitValue(timeline_info, j));
+        }
+        for (uint32_t j = 0; j < bind.signalSemaphoreCount; ++j) {
+            AddSemaphoreSignal(&submissions[i], bind.pSignalSemaphores[j], GetTimelineSignalValue(timeline_info, j));
+        }
+    }
+    if (fence != VK_NULL_HANDLE) {
+        if (submissions.empty()) submissions.resize(1);
+        submissions.back().fence = GetFence(fence);
+    }
+    lock.unlock();
+    EnqueueSubmissions(bind_queue, submissions);
+    return VK_SUCCESS;
+''',
+'vkQueueWaitIdle': '''
+    WaitQueueIdle(reinterpret_cast<Queue*>(queue));
+    return VK_SUCCESS;
+''',
+'vkDeviceWaitIdle': '''
+    std::vector<Queue*> queues;
+    Device* mock_device = reinterpret_cast<Device*>(device);
+    unique_lock_t lock(mock_device->lock);
+    for (const auto& family_queues : mock_device->queues) {
+        for (auto queue : family_queues) {
+            if (queue) queues.push_back(reinterpret_cast<Queue*>(queue));
+        }
+    }
+    lock.unlock();
+    for (auto queue : queues) WaitQueueIdle(queue);
+    return VK_SUCCESS;
+''',
+'vkCreateDescriptorSetLayout': '''
+    *pSetLayout = (VkDescriptorSetLayout)descriptor_set_layout_table.Create(CreateDescriptorSetLayoutState(*pCreateInfo));
+    return VK_SUCCESS;
+''',
+'vkCreateDescriptorPool': '''
+    *pDescriptorPool = (VkDescriptorPool)descriptor_pool_table.Create(CreateDescriptorPoolState(*pCreateInfo));
+    return VK_SUCCESS;
+''',
+'vkAllocateDescriptorSets': '''
+    // Sets allocated with layouts the mock does not know hold no descriptors
+    static const std::shared_ptr<const DescriptorSetLayout> empty_layout(new DescriptorSetLayout());
+    const auto variable_info = lvl_find_in_chain<VkDescriptorSetVariableDescriptorCountAllocateInfo>(pAllocateInfo->pNext);
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->descriptor_lock);
+    DescriptorPool* pool = descriptor_pool_table.Get(pAllocateInfo->descriptorPool);
+    for (uint32_t i = 0; i < pAllocateInfo->descriptorSetCount; ++i) {
+        const auto layout = descriptor_set_layout_table.Get(pAllocateInfo->pSetLayouts[i]);
+        DescriptorSet set;
+        set.pool = pAllocateInfo->descriptorPool;
+        set.pool_index = pool ? pool->sets.size() : 0;
+        set.layout = layout ? *layout : empty_layout;
+        if (variable_info && i < variable_info->descriptorSetCount) set.variable_count = variable_info->pDescriptorCounts[i];
+        const VkResult result = pool ? AllocateDescriptors(pool, &set) : VK_ERROR_OUT_OF_POOL_MEMORY;
+        if (result != VK_SUCCESS) {
+            // Nothing is allocated when a set fails. The sets are freed last first, which gives each its descriptors
+            // back where it took them and leaves the pool as the call found it.
+            for (uint32_t j = i; j-- > 0;) FreeDescriptorSet(pDescriptorSets[j]);
+            std::fill(pDescriptorSets, pDescriptorSets + pAllocateInfo->descriptorSetCount, (VkDescriptorSet)VK_NULL_HANDLE);
+            lock.unlock();
+            entrypoint_scope.CountDestroyed(STATS_OBJECT_VkDescriptorSet, pAllocateInfo->descriptorSetCount);
+            AddStat(result == VK_ERROR_FRAGMENTED_POOL ? STATS_DESCRIPTOR_POOLS_FRAGMENTED : STATS_DESCRIPTOR_POOLS_EXHAUSTED, 1);
+            return result;
+        }
+        pDescriptorSets[i] = (VkDescriptorSet)descriptor_set_table.Create(std::move(set));
+        pool->sets.push_back(pDescriptorSets[i]);
+    }
+    return VK_SUCCESS;
+''',
+'vkUpdateDescriptorSets': '''
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->descriptor_lock);
+    for (uint32_t i = 0; i < descriptorWriteCount; ++i) {
+        if (DescriptorSet* set = descriptor_set_table.Get(pDescriptorWrites[i].dstSet)) WriteDescriptors(set, pDescriptorWrites[i]);
+    }
+    for (uint32_t i = 0; i < descriptorCopyCount; ++i) CopyDescriptors(pDescriptorCopies[i]);
+''',
+'vkFreeDescriptorSets': '''
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->descriptor_lock);
+    for (uint32_t i = 0; i < descriptorSetCount; ++i) FreeDescriptorSet(pDescriptorSets[i]);
+    return VK_SUCCESS;
+''',
+'vkResetDescriptorPool': '''
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->descriptor_lock);
+    if (DescriptorPool* pool = descriptor_pool_table.Get(descriptorPool)) FreeDescriptorPoolSets(pool);
+    return VK_SUCCESS;
+''',
+'vkDestroyDescriptorPool': '''
+    unique_lock_t lock(reinterpret_cast<Device*>(device)->descriptor_lock);
+    if (DescriptorPool* pool = descriptor_pool_table.Get(descriptorPool)) FreeDescriptorPoolSets(pool);
+    descriptor_pool_table.Destroy(descriptorPool);
+''',
+'vkCreateFence': '''
+    *pFence = (VkFence)fence_table.Create();
+    GetFence(*pFence)->signaled = (pCreateInfo->flags & VK_FENCE_CREATE_SIGNALED_BIT) != 0;
+    return VK_SUCCESS;
+''',
+'vkDestroyFence': '''
+    fence_table.Destroy(fence);
+''',
+'vkResetFences': '''
+    for (uint32_t i = 0; i < fenceCount; ++i) {
+        Fence* reset_fence = GetFence(pFences[i]);
+        if (reset_fence) reset_fence->signaled = false;
+    }
+    return VK_SUCCESS;
+''',
+'vkGetFenceStatus': '''
+    Fence* status_fence = GetFence(fence);
+    return (!status_fence || status_fence->signaled.load()) ? VK_SUCCESS : VK_NOT_READY;
+''',
+'vkWaitForFences': '''
+    std::vector<Fence*> fences;
+    for (uint32_t i = 0; i < fenceCount; ++i) {
+        Fence* wait_fence = GetFence(pFences[i]);
+        if (wait_fence) fences.push_back(wait_fence);
+    }
+    const bool wait_all = waitAll == VK_TRUE;
+    auto signaled = [&fences, wait_all] {
+        for (auto wait_fence : fences) {
+            const bool fence_signaled = wait_fence->signaled.load();
+            if (wait_all && !fence_signaled) return false;
+            if (!wait_all && fence_signaled) return true;
         }
+        return wait_all || fences.empty();
+    };
+    return WaitForSyncObjects(reinterpret_cast<Device*>(device), signaled, GetSyncDeadline(timeout)) ? VK_SUCCESS : VK_TIMEOUT;
+''',
+'vkCreateSemaphore': '''
+    *pSemaphore = (VkSemaphore)semaphore_table.Create();
+    Semaphore* new_semaphore = GetSemaphore(*pSemaphore);
+    const auto *type_info = lvl_find_in_chain<VkSemaphoreTypeCreateInfo>(pCreateInfo->pNext);
+    if (type_info && type_info->semaphoreType == VK_SEMAPHORE_TYPE_TIMELINE) {
+        new_semaphore->type = VK_SEMAPHORE_TYPE_TIMELINE;
+        new_semaphore->value = type_info->initialValue;
     }
     return VK_SUCCESS;
 ''',
-'vkAcquireNextImagesKHR': '''
-    *pImageIndex = 0;
+'vkGetSemaphoreCounterValueKHR': '''
+    Semaphore* counter_semaphore = GetSemaphore(semaphore);
+    *pValue = counter_semaphore ? counter_semaphore->value.load() : 0;
+    return VK_SUCCESS;
+''',
+'vkSignalSemaphoreKHR': '''
+    Semaphore* signal_semaphore = GetSemaphore(pSignalInfo->semaphore);
+    if (signal_semaphore) signal_semaphore->value = pSignalInfo->value;
+    SignalSyncObjects(reinterpret_cast<Device*>(device));
+    return VK_SUCCESS;
+''',
+'vkWaitSemaphoresKHR': '''
+    std::vector<std::pair<Semaphore*, uint64_t>> waits;
+    for (uint32_t i = 0; i < pWaitInfo->semaphoreCount; ++i) {
+        Semaphore* wait_semaphore = GetSemaphore(pWaitInfo->pSemaphores[i]);
+        if (wait_semaphore) waits.push_back(std::make_pair(wait_semaphore, pWaitInfo->pValues[i]));
+    }
+    const bool wait_any = (pWaitInfo->flags & VK_SEMAPHORE_WAIT_ANY_BIT) != 0;
+    auto reached = [&waits, wait_any] {
+        for (const auto& wait : waits) {
+            const bool wait_reached = wait.first->value.load() >= wait.second;
+            if (!wait_any && !wait_reached) return false;
+            if (wait_any && wait_reached) return true;
+        }
+        return !wait_any || waits.empty();
+    };
+    return WaitForSyncObjects(reinterpret_cast<Device*>(device), reached, GetSyncDeadline(timeout)) ? VK_SUCCESS : VK_TIMEOUT;
+''',
+'vkDestroySemaphore': '''
+    semaphore_table.Destroy(semaphore);
+''',
+'vkCreateImage': '''
+    *pImage = (VkImage)image_table.Create(CreateImageState(*pCreateInfo));
+    return VK_SUCCESS;
+''',
+'vkCreateImageView': '''
+    *pView = (VkImageView)image_view_table.Create(CreateImageViewState(*pCreateInfo));
+    return VK_SUCCESS;
+''',
+'vkCreateSampler': '''
+    Sampler sampler = {*pCreateInfo};
+    sampler.create_info.pNext = nullptr;
+    *pSampler = (VkSampler)sampler_table.Create(sampler);
+    return VK_SUCCESS;
+''',
+'vkCreateRenderPass': '''
+    *pRenderPass = (VkRenderPass)render_pass_table.Create(CreateRenderPassState(*pCreateInfo));
+    return VK_SUCCESS;
+''',
+'vkCreateRenderPass2': '''
+    *pRenderPass = (VkRenderPass)render_pass_table.Create(CreateRenderPassState(*pCreateInfo));
+    return VK_SUCCESS;
+''',
+'vkCreateRenderPass2KHR': '''
+    *pRenderPass = (VkRenderPass)render_pass_table.Create(CreateRenderPassState(*pCreateInfo));
+    return VK_SUCCESS;
+''',
+'vkCreateFramebuffer': '''
+    Framebuffer framebuffer = {{}, pCreateInfo->width, pCreateInfo->height, pCreateInfo->layers};
+    if (!(pCreateInfo->flags & VK_FRAMEBUFFER_CREATE_IMAGELESS_BIT)) {
+        framebuffer.attachments.assign(pCreateInfo->pAttachments, pCreateInfo->pAttachments + pCreateInfo->attachmentCount);
+    }
+    *pFramebuffer = (VkFramebuffer)framebuffer_table.Create(framebuffer);
     return VK_SUCCESS;
 ''',
 'vkCreateBuffer': '''
-    unique_lock_t lock(global_lock);
-    *pBuffer = (VkBuffer)global_unique_handle++;
-    buffer_map[device][*pBuffer] = *pCreateInfo;
+    Buffer buffer = {*pCreateInfo};
+    buffer.create_info.pNext = nullptr;
+    *pBuffer = (VkBuffer)buffer_table.Create(buffer);
     return VK_SUCCESS;
 ''',
 'vkDestroyBuffer': '''
-    unique_lock_t lock(global_lock);
-    buffer_map[device].erase(buffer);
+    buffer_table.Destroy(buffer);
+''',
+'vkCreateCommandPool': '''
+    *pCommandPool = (VkCommandPool)command_pool_table.Create();
+    return VK_SUCCESS;
+''',
+'vkDestroyCommandPool': '''
+    // Frees every command buffer still allocated from the pool
+    command_pool_table.Destroy(commandPool);
+''',
+'vkAllocateCommandBuffers': '''
+    auto pool = GetCommandPool(pAllocateInfo->commandPool);
+    if (!pool) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    for (uint32_t i = 0; i < pAllocateInfo->commandBufferCount; ++i) {
+        auto command_buffer = pool->command_buffers.Allocate();
+        set_loader_magic_value(&command_buffer->loader_data);
+        command_buffer->pool = pool;
+        ResetCommandStream(command_buffer);
+        pCommandBuffers[i] = reinterpret_cast<VkCommandBuffer>(command_buffer);
+    }
+    return VK_SUCCESS;
+''',
+'vkFreeCommandBuffers': '''
+    auto pool = GetCommandPool(commandPool);
+    if (!pool) return;
+    for (uint32_t i = 0; i < commandBufferCount; ++i) {
+        if (!pCommandBuffers[i]) continue;
+        auto command_buffer = reinterpret_cast<CommandBuffer*>(pCommandBuffers[i]);
+        ResetCommandStream(command_buffer);
+        pool->command_buffers.Free(command_buffer);
+    }
+''',
+'vkResetCommandPool': '''
+    auto pool = GetCommandPool(commandPool);
+    if (!pool) return VK_SUCCESS;
+    // Invalidates the streams of all command buffers at once, they notice the new epoch when next reset
+    pool->reset_epoch++;
+    pool->next_unused_chunk = 0;
+    pool->free_chunks = nullptr;
+    return VK_SUCCESS;
+''',
+'vkBeginCommandBuffer': '''
+    ResetCommandStream(reinterpret_cast<CommandBuffer*>(commandBuffer));
+    return VK_SUCCESS;
+''',
+'vkEndCommandBuffer': '''
+    return reinterpret_cast<CommandBuffer*>(commandBuffer)->result;
+''',
+'vkResetCommandBuffer': '''
+    ResetCommandStream(reinterpret_cast<CommandBuffer*>(commandBuffer));
+    return VK_SUCCESS;
+''',
+'vkCreateQueryPool': '''
+    *pQueryPool = (VkQueryPool)query_pool_table.Create(pCreateInfo);
+    return VK_SUCCESS;
+''',
+'vkDestroyQueryPool': '''
+    query_pool_table.Destroy(queryPool);
+''',
+'vkGetQueryPoolResults': '''
+    QueryPool* pool = GetQueryPool(queryPool);
+    if (!pool) return VK_SUCCESS;
+    VkResult result = VK_SUCCESS;
+    for (uint32_t i = 0; i < queryCount; ++i) {
+        const uint32_t query = firstQuery + i;
+        if (query >= pool->available.size()) break;
+        bool available = pool->available[query].load(std::memory_order_acquire);
+        if (!available && (flags & VK_QUERY_RESULT_WAIT_BIT)) {
+            // Once all submitted work has executed nothing is left that could make the query available
+            Device* query_device = reinterpret_cast<Device*>(device);
+            WaitForSyncObjects(query_device, [&] { return pool->available[query].load() || query_device->pending_submissions.load() == 0; },
+                               std::chrono::steady_clock::time_point::max());
+            available = pool->available[query].load(std::memory_order_acquire);
+        }
+        if (!available) result = VK_NOT_READY;
+        WriteQueryResult(pool, query, available, static_cast<char*>(pData) + i * stride, flags);
+    }
+    return result;
+''',
+'vkResetQueryPool': '''
+    QueryPool* pool = GetQueryPool(queryPool);
+    if (!pool) return;
+    for (uint32_t i = 0; i < queryCount; ++i) MakeQueryAvailable(pool, firstQuery + i, false);
+''',
+'vkResetQueryPoolEXT': '''
+    ResetQueryPool(device, queryPool, firstQuery, queryCount);
+''',
+'vkGetPhysicalDeviceCalibrateableTimeDomainsEXT': '''
+#if defined(__linux__)
+    static const VkTimeDomainEXT time_domains[] = {VK_TIME_DOMAIN_DEVICE_EXT, VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT,
+                                                   VK_TIME_DOMAIN_CLOCK_MONOTONIC_RAW_EXT};
+#else
+    static const VkTimeDomainEXT time_domains[] = {VK_TIME_DOMAIN_DEVICE_EXT};
+#endif
+    const uint32_t count = sizeof(time_domains) / sizeof(time_domains[0]);
+    if (!pTimeDomains) {
+        *pTimeDomainCount = count;
+        return VK_SUCCESS;
+    }
+    *pTimeDomainCount = std::min(*pTimeDomainCount, count);
+    memcpy(pTimeDomains, time_domains, *pTimeDomainCount * sizeof(VkTimeDomainEXT));
+    return *pTimeDomainCount < count ? VK_INCOMPLETE : VK_SUCCESS;
+''',
+'vkGetCalibratedTimestampsEXT': '''
+    // Device timestamps are CLOCK_MONOTONIC, so both domains share one reading. Only the raw clock needs
+    // a reading of its own, the deviation is the time spent taking all of them.
+    const uint64_t begin = GetDeviceTimestamp();
+    for (uint32_t i = 0; i < timestampCount; ++i) {
+        switch (pTimestampInfos[i].timeDomain) {
+#if defined(__linux__)
+            case VK_TIME_DOMAIN_CLOCK_MONOTONIC_RAW_EXT: {
+                struct timespec now;
+                clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+                pTimestamps[i] = (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+                break;
+            }
+#endif
+            default:
+                pTimestamps[i] = begin;
+                break;
+        }
+    }
+    *pMaxDeviation = std::max<uint64_t>(GetDeviceTimestamp() - begin, 1);
+    return VK_SUCCESS;
+''',
+'vkCreateShaderModule': '''
+    Hasher hasher;
+    hasher.Add(pCreateInfo->pCode, pCreateInfo->codeSize);
+    ShaderModule module = {hasher.hash, std::vector<uint32_t>(pCreateInfo->pCode, pCreateInfo->pCode + pCreateInfo->codeSize / sizeof(uint32_t))};
+    *pShaderModule = (VkShaderModule)shader_module_table.Create(std::move(module));
+    return VK_SUCCESS;
+''',
+'vkDestroyShaderModule': '''
+    shader_module_table.Destroy(shaderModule);
+''',
+'vkCreatePipelineCache': '''
+    *pPipelineCache = (VkPipelineCache)pipeline_cache_table.Create();
+    LoadPipelineCacheData(GetPipelineCache(*pPipelineCache), pCreateInfo->pInitialData, pCreateInfo->initialDataSize);
+    return VK_SUCCESS;
+''',
+'vkDestroyPipelineCache': '''
+    pipeline_cache_table.Destroy(pipelineCache);
+''',
+'vkGetPipelineCacheData': '''
+    PipelineCache* cache = GetPipelineCache(pipelineCache);
+    if (!cache) {
+        *pDataSize = 0;
+        return VK_SUCCESS;
+    }
+    lock_guard_t lock(cache->lock);
+    const size_t size = PIPELINE_CACHE_HEADER_SIZE + cache->keys.size() * sizeof(uint64_t);
+    if (!pData) {
+        *pDataSize = size;
+        return VK_SUCCESS;
+    }
+    // Only whole entries are written, and nothing at all if the header does not fit
+    if (*pDataSize < PIPELINE_CACHE_HEADER_SIZE) {
+        *pDataSize = 0;
+        return VK_INCOMPLETE;
+    }
+    char* data = static_cast<char*>(pData);
+    WritePipelineCacheHeader(data);
+    const size_t count = std::min(cache->keys.size(), (*pDataSize - PIPELINE_CACHE_HEADER_SIZE) / sizeof(uint64_t));
+    auto key = cache->keys.begin();
+    for (size_t i = 0; i < count; ++i, ++key) memcpy(data + PIPELINE_CACHE_HEADER_SIZE + i * sizeof(uint64_t), &*key, sizeof(uint64_t));
+    *pDataSize = PIPELINE_CACHE_HEADER_SIZE + count * sizeof(uint64_t);
+    return count < cache->keys.size() ? VK_INCOMPLETE : VK_SUCCESS;
+''',
+'vkMergePipelineCaches': '''
+    PipelineCache* dst = GetPipelineCache(dstCache);
+    if (!dst) return VK_SUCCESS;
+    for (uint32_t i = 0; i < srcCacheCount; ++i) {
+        PipelineCache* src = GetPipelineCache(pSrcCaches[i]);
+        if (!src || src == dst) continue;
+        std::lock(dst->lock, src->lock);
+        lock_guard_t dst_lock(dst->lock, std::adopt_lock);
+        lock_guard_t src_lock(src->lock, std::adopt_lock);
+        dst->keys.insert(src->keys.begin(), src->keys.end());
+    }
+    return VK_SUCCESS;
+''',
+'vkCreateGraphicsPipelines': '''
+    std::vector<uint64_t> keys(createInfoCount);
+    std::vector<Pipeline> pipelines(createInfoCount);
+    for (uint32_t i = 0; i < createInfoCount; ++i) {
+        keys[i] = GetGraphicsPipelineKey(pCreateInfos[i]);
+        if (GetRasterizationEnabled()) pipelines[i].raster = CreateRasterPipeline(pCreateInfos[i]);
+    }
+    for (uint32_t i = 0; i < createInfoCount; ++i) {
+        pPipelines[i] = CreatePipeline(pipelineCache, keys[i], pCreateInfos[i].pNext, std::move(pipelines[i]));
+    }
+    return VK_SUCCESS;
+''',
+'vkCreateComputePipelines': '''
+    std::vector<uint64_t> keys(createInfoCount);
+    std::vector<Pipeline> pipelines(createInfoCount);
+    for (uint32_t i = 0; i < createInfoCount; ++i) {
+        keys[i] = GetComputePipelineKey(pCreateInfos[i]);
+        pipelines[i].program = TranslateShaderStage(pCreateInfos[i].stage, SPIRV_EXECUTION_MODEL_GL_COMPUTE);
+    }
+    for (uint32_t i = 0; i < createInfoCount; ++i) {
+        pPipelines[i] = CreatePipeline(pipelineCache, keys[i], pCreateInfos[i].pNext, std::move(pipelines[i]));
+    }
+    return VK_SUCCESS;
+''',
+}
+
+# Effects of recorded vkCmd* commands when a queue executes them, keyed by command name. Each body
+# sees the command's parameter record as `record` and the batch's ExecutionContext as `context`.
+# Aliases share the record and executor of the command they forward to.
+COMMAND_EXECUTORS = {
+'vkCmdDraw': '''
+    ExecuteDraw(context, record.vertexCount, record.instanceCount);
+    RasterizeDraw(context, false, record.vertexCount, record.instanceCount, record.firstVertex, 0, record.firstInstance, 0);
+''',
+'vkCmdDrawIndexed': '''
+    ExecuteDraw(context, record.indexCount, record.instanceCount);
+    RasterizeDraw(context, true, record.indexCount, record.instanceCount, record.firstIndex, record.vertexOffset, record.firstInstance, 0);
+''',
+'vkCmdDrawIndirect': '''
+    ExecuteDraw(context, 3, record.drawCount);
+    RasterizeIndirectDraws(context, false, record.buffer, record.offset, record.drawCount, record.stride, VK_NULL_HANDLE, 0);
+''',
+'vkCmdDrawIndexedIndirect': '''
+    ExecuteDraw(context, 3, record.drawCount);
+    RasterizeIndirectDraws(context, true, record.buffer, record.offset, record.drawCount, record.stride, VK_NULL_HANDLE, 0);
+''',
+'vkCmdDrawIndirectCount': '''
+    ExecuteDraw(context, 3, record.maxDrawCount);
+    RasterizeIndirectDraws(context, false, record.buffer, record.offset, record.maxDrawCount, record.stride, record.countBuffer,
+                           record.countBufferOffset);
+''',
+'vkCmdDrawIndexedIndirectCount': '''
+    ExecuteDraw(context, 3, record.maxDrawCount);
+    RasterizeIndirectDraws(context, true, record.buffer, record.offset, record.maxDrawCount, record.stride, record.countBuffer,
+                           record.countBufferOffset);
+''',
+'vkCmdSetViewport': '''
+    if (record.firstViewport == 0 && record.viewportCount > 0) context->draw.viewport = record.pViewports[0];
+''',
+'vkCmdSetScissor': '''
+    if (record.firstScissor == 0 && record.scissorCount > 0) context->draw.scissor = record.pScissors[0];
+''',
+'vkCmdSetBlendConstants': '''
+    memcpy(context->draw.blend_constants, record.blendConstants, sizeof(record.blendConstants));
+''',
+'vkCmdBindVertexBuffers': '''
+    for (uint32_t i = 0; i < record.bindingCount && record.firstBinding + i < MAX_BOUND_VERTEX_BUFFERS; ++i) {
+        context->draw.vertex_buffers[record.firstBinding + i] = record.pBuffers[i];
+        context->draw.vertex_offsets[record.firstBinding + i] = record.pOffsets[i];
+    }
+''',
+'vkCmdBindIndexBuffer': '''
+    context->draw.index_buffer = record.buffer;
+    context->draw.index_offset = record.offset;
+    context->draw.index_type = record.indexType;
+''',
+'vkCmdBeginRenderPass': '''
+    ExecuteBeginRenderPass(context, *record.pRenderPassBegin);
+''',
+'vkCmdBeginRenderPass2': '''
+    ExecuteBeginRenderPass(context, *record.pRenderPassBegin);
+''',
+'vkCmdNextSubpass': '''
+    ExecuteNextSubpass(context);
+''',
+'vkCmdNextSubpass2': '''
+    ExecuteNextSubpass(context);
+''',
+'vkCmdEndRenderPass': '''
+    ExecuteEndRenderPass(context);
+''',
+'vkCmdEndRenderPass2': '''
+    ExecuteEndRenderPass(context);
+''',
+'vkCmdClearAttachments': '''
+    ExecuteClearAttachments(context, record.attachmentCount, record.pAttachments, record.rectCount, record.pRects);
+''',
+'vkCmdBindPipeline': '''
+    const Pipeline* pipeline = pipeline_table.Get(record.pipeline);
+    if (record.pipelineBindPoint == VK_PIPELINE_BIND_POINT_COMPUTE) context->compute.program = pipeline ? pipeline->program : nullptr;
+    if (record.pipelineBindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS) context->draw.pipeline = pipeline ? pipeline->raster : nullptr;
+''',
+'vkCmdBindDescriptorSets': '''
+    BindPointState* state = GetBindPointState(context, record.pipelineBindPoint);
+    if (!state) return;
+    ExecuteBindDescriptorSets(state, record.firstSet, record.descriptorSetCount, record.pDescriptorSets, record.dynamicOffsetCount,
+                              record.pDynamicOffsets);
+''',
+'vkCmdPushDescriptorSetKHR': '''
+    BindPointState* state = GetBindPointState(context, record.pipelineBindPoint);
+    if (!state) return;
+    ExecutePushDescriptorSet(state, record.set, record.descriptorWriteCount, record.pDescriptorWrites);
+''',
+'vkCmdPushConstants': '''
+    if (record.offset > MAX_PUSH_CONSTANTS_SIZE || record.size > MAX_PUSH_CONSTANTS_SIZE - record.offset) return;
+    if (record.stageFlags & VK_SHADER_STAGE_COMPUTE_BIT) memcpy(context->compute.push_constants + record.offset, record.pValues, record.size);
+    if (record.stageFlags & VK_SHADER_STAGE_ALL_GRAPHICS) memcpy(context->graphics.push_constants + record.offset, record.pValues, record.size);
+''',
+'vkCmdDispatch': '''
+    const uint32_t base[3] = {0, 0, 0};
+    const uint32_t group_count[3] = {record.groupCountX, record.groupCountY, record.groupCountZ};
+    ExecuteDispatch(context, base, group_count);
+''',
+'vkCmdDispatchBase': '''
+    const uint32_t base[3] = {record.baseGroupX, record.baseGroupY, record.baseGroupZ};
+    const uint32_t group_count[3] = {record.groupCountX, record.groupCountY, record.groupCountZ};
+    ExecuteDispatch(context, base, group_count);
+''',
+'vkCmdDispatchIndirect': '''
+    ExecuteDispatchIndirect(context, record.buffer, record.offset);
+''',
+'vkCmdWriteTimestamp': '''
+    ExecuteWriteTimestamp(context, record.queryPool, record.query);
+''',
+'vkCmdResetQueryPool': '''
+    QueryPool* pool = GetQueryPool(record.queryPool);
+    if (!pool) return;
+    for (uint32_t i = 0; i < record.queryCount; ++i) MakeQueryAvailable(pool, record.firstQuery + i, false);
+''',
+'vkCmdBeginQuery': '''
+    ExecuteBeginQuery(context, record.queryPool, record.query);
+''',
+'vkCmdEndQuery': '''
+    ExecuteEndQuery(context, record.queryPool, record.query);
+''',
+'vkCmdBeginQueryIndexedEXT': '''
+    ExecuteBeginQuery(context, record.queryPool, record.query);
+''',
+'vkCmdEndQueryIndexedEXT': '''
+    ExecuteEndQuery(context, record.queryPool, record.query);
+''',
+'vkCmdCopyBuffer': '''
+    ExecuteCopyBuffer(context, record.srcBuffer, record.dstBuffer, record.regionCount, record.pRegions);
+''',
+'vkCmdFillBuffer': '''
+    ExecuteFillBuffer(context, record.dstBuffer, record.dstOffset, record.size, record.data);
+''',
+'vkCmdUpdateBuffer': '''
+    ExecuteUpdateBuffer(context, record.dstBuffer, record.dstOffset, record.dataSize, record.pData);
+''',
+'vkCmdCopyBufferToImage': '''
+    ExecuteCopyBufferImage(context, record.srcBuffer, record.dstImage, record.regionCount, record.pRegions, true);
+''',
+'vkCmdCopyImageToBuffer': '''
+    ExecuteCopyBufferImage(context, record.dstBuffer, record.srcImage, record.regionCount, record.pRegions, false);
+''',
+'vkCmdCopyImage': '''
+    ExecuteCopyImage(context, record.srcImage, record.dstImage, record.regionCount, record.pRegions);
+''',
+'vkCmdCopyQueryPoolResults': '''
+    ExecuteCopyQueryPoolResults(context, record.queryPool, record.firstQuery, record.queryCount, record.dstBuffer, record.dstOffset,
+                                record.stride, record.flags);
+''',
+'vkCmdClearColorImage': '''
+    ExecuteClearColorImage(context, record.image, *record.pColor, record.rangeCount, record.pRanges);
+''',
+'vkCmdClearDepthStencilImage': '''
+    ExecuteClearDepthStencilImage(context, record.image, *record.pDepthStencil, record.rangeCount, record.pRanges);
+''',
+'vkCmdBlitImage': '''
+    ExecuteBlitImage(context, record.srcImage, record.dstImage, record.regionCount, record.pRegions, record.filter);
+''',
+'vkCmdResolveImage': '''
+    ExecuteResolveImage(context, record.srcImage, record.dstImage, record.regionCount, record.pRegions);
+''',
+'vkCmdExecuteCommands': '''
+    for (uint32_t i = 0; i < record.commandBufferCount; ++i) ExecuteCommandBuffer(record.pCommandBuffers[i], context);
 ''',
 }
 
@@ -1016,6 +6642,40 @@ class MockICDOutputGenerator(OutputGenerator):
         self.sections = dict([(section, []) for section in self.ALL_SECTIONS])
         self.intercepts = []
 
+    # Generate the ProfileField table of a structure's members
+    def profileFieldsText(self, struct_name, table_name):
+        field_types = {'int32_t': 'PROFILE_FIELD_INT32', 'float': 'PROFILE_FIELD_FLOAT',
+                       'VkDeviceSize': 'PROFILE_FIELD_UINT64', 'size_t': 'PROFILE_FIELD_SIZE'}
+        lines = ['static const ProfileField %s[] = {' % table_name]
+        for member in self.registry.tree.findall("types/type[@name='%s']/member" % struct_name):
+            member_type = member.find('type').text
+            member_name = member.find('name').text
+            length = re.search(r'\[(\d+)\]', member.find('name').tail or '')
+            lines.append('    {"%s", offsetof(%s, %s), %s, %s},' % (member_name, struct_name, member_name,
+                         field_types.get(member_type, 'PROFILE_FIELD_UINT32'), length.group(1) if length else '1'))
+        lines.append('};')
+        return '\n'.join(lines)
+
+    # Generate the FormatInfo table of the formats of the core API and the enabled extensions
+    def formatInfosText(self):
+        tree = self.registry.tree
+        enums = tree.findall("enums[@name='VkFormat']/enum") + tree.findall("feature/require/enum[@extends='VkFormat']")
+        for ext in tree.findall('extensions/extension'):
+            if ext.attrib['supported'] != 'disabled':
+                enums += ext.findall("require/enum[@extends='VkFormat']")
+        lines = ['static constexpr FormatInfo format_infos[] = {']
+        for name in collections.OrderedDict((enum.get('name'), None) for enum in enums if enum.get('alias') is None):
+            layout = FormatBlockLayout(name)
+            if not layout:
+                continue
+            block_size, extent, planes = layout
+            components = FormatComponents(name)
+            lines.append('    {%s, %d, {%d, %d, %d}, %d, {%s}, %d, {%s}},' % (name, block_size, extent[0], extent[1], extent[2],
+                         len(planes), ', '.join('{%d, %d, %d}' % plane for plane in planes), len(components),
+                         ', '.join('{%s, %s, %d, %d}' % component for component in components)))
+        lines.append('};')
+        return '\n'.join(lines)
+
     # Check if the parameter passed in is a pointer to an array
     def paramIsArray(self, param):
         return param.attrib.get('len') is not None
@@ -1029,6 +6689,131 @@ class MockICDOutputGenerator(OutputGenerator):
         return ispointer
 
     # Check if an object is a non-dispatchable handle
+    #
+    # Generate a vkCmd* intercept that records its parameters into the command buffer's stream.
+    # Aliases of already recorded commands forward to them so both share a single record type.
+    def genCmdRecord(self, cmdinfo, name, alias, decls):
+        params = cmdinfo.elem.findall('param')[1:]
+        param_names = [param.find('name').text for param in params]
+        resulttype = cmdinfo.elem.find('proto/type')
+        has_result = resulttype != None and resulttype.text != 'void'
+        if alias != None:
+            self.appendSection('command', '')
+            self.appendSection('command', 'static %s' % (decls[0][:-1]))
+            self.appendSection('command', '{%s\n    %s%s(%s);\n}' % (self.entrypointText(cmdinfo, name), 'return ' if has_result else '', alias[2:], ', '.join(['commandBuffer'] + param_names)))
+            return
+        record_name = name[2:] + 'Record'
+        members = []
+        sizes = []
+        copies = []
+        for param, param_name in zip(params, param_names):
+            decl = ' '.join(''.join(param.itertext()).split())
+            param_type = param.find('type').text
+            is_pointer = '*' in (param.find('type').tail or '')
+            if not is_pointer:
+                if decl.startswith('const '):
+                    decl = decl[len('const '):]
+                members.append('    %s;' % decl)
+                if decl.endswith(']'):
+                    copies.append('    memcpy(record->%s, %s, sizeof(record->%s));' % (param_name, param_name, param_name))
+                else:
+                    copies.append('    record->%s = %s;' % (param_name, param_name))
+                continue
+            members.append('    %s;' % decl)
+            length = param.attrib.get('len')
+            if param_type == 'void' and length == None:
+                # Opaque pointers are recorded as they are
+                copies.append('    record->%s = %s;' % (param_name, param_name))
+                continue
+            length = length.replace('::', '->') if length != None else '1'
+            sizes.append('CommandArraySize(%s, %s)' % (param_name, length))
+            if param_type.startswith('Vk') and not self.isHandleTypeDispatchable(param_type) and not self.isHandleTypeNonDispatchable(param_type):
+                sizes.append('CommandNestedSize(%s, %s)' % (param_name, length))
+                copies.append('    auto %s_copy = CopyCommandArray(&storage, %s, %s);' % (param_name, param_name, length))
+                copies.append('    CopyCommandNested(&storage, %s_copy, %s);' % (param_name, length))
+                copies.append('    record->%s = %s_copy;' % (param_name, param_name))
+            else:
+                copies.append('    record->%s = CopyCommandArray(&storage, %s, %s);' % (param_name, param_name, length))
+        self.appendSection('command', '')
+        self.appendSection('command', 'struct %s {' % record_name)
+        self.appendSection('command', '    static const CommandInfo info;')
+        for member in members:
+            self.appendSection('command', member)
+        self.appendSection('command', '};')
+        if name in COMMAND_EXECUTORS:
+            self.appendSection('command', '')
+            uses_record = 'record.' in COMMAND_EXECUTORS[name]
+            self.appendSection('command', 'static void Execute%s(const void*%s, ExecutionContext* context) {' % (name[2:], ' data' if uses_record else ''))
+            if uses_record:
+                self.appendSection('command', '    const auto& record = *static_cast<const %s*>(data);' % record_name)
+            self.appendSection('command', COMMAND_EXECUTORS[name].strip('\n'))
+            self.appendSection('command', '}')
+            self.appendSection('command', 'const CommandInfo %s::info = {"%s", Execute%s};' % (record_name, name, name[2:]))
+        else:
+            self.appendSection('command', 'const CommandInfo %s::info = {"%s", nullptr};' % (record_name, name))
+        self.appendSection('command', '')
+        self.appendSection('command', 'static %s' % (decls[0][:-1]))
+        self.appendSection('command', '{' + self.entrypointText(cmdinfo, name))
+        if len(sizes) > 0:
+            self.appendSection('command', '    char* storage;')
+            self.appendSection('command', '    auto record = RecordCommand<%s>(commandBuffer, %s, &storage);' % (record_name, ' + '.join(sizes)))
+        elif len(copies) > 0:
+            self.appendSection('command', '    auto record = RecordCommand<%s>(commandBuffer);' % (record_name))
+        else:
+            self.appendSection('command', '    RecordCommand<%s>(commandBuffer);' % (record_name))
+        if len(copies) > 0:
+            self.appendSection('command', '    if (!record) return%s;' % (' VK_ERROR_OUT_OF_HOST_MEMORY' if has_result else ''))
+        for copy in copies:
+            self.appendSection('command', copy)
+        if has_result:
+            self.appendSection('command', '    return VK_SUCCESS;')
+        self.appendSection('command', '}')
+
+    # Generate the statement that traces calls of an entrypoint and charges their cost
+    def entrypointText(self, cmdinfo, name):
+        handles = []
+        for param in cmdinfo.elem.findall('param'):
+            param_type = param.find('type')
+            if '*' in (param_type.tail or '') or '[' in (param.find('name').tail or ''):
+                continue
+            if self.isHandleTypeDispatchable(param_type.text) or self.isHandleTypeNonDispatchable(param_type.text):
+                handles.append(param.find('name').text)
+        # Elements the cost model charges for are the entries of the array parameters
+        lengths = []
+        for param in cmdinfo.elem.findall('param'):
+            length = param.attrib.get('len', '').split(',')[0]
+            if not re.match(r'^\w+(::\w+)?$', length) or length in lengths:
+                continue
+            length_param = cmdinfo.elem.find("param/[name='%s']" % length.split('::')[0])
+            if length_param is None or ('::' not in length and '*' in (length_param.find('type').tail or '')):
+                continue
+            lengths.append(length)
+        elements = ' + '.join(length.replace('::', '->') for length in lengths) if lengths else '0'
+        text = '\n    EntrypointScope entrypoint_scope(%s);' % ', '.join(['ENTRYPOINT_' + name, elements] + handles)
+        # Count the objects created by the handles the call returns, or destroyed by the last handle it takes
+        params = cmdinfo.elem.findall('param')
+        if re.match(r'vk(Create|Allocate|Register)', name) and name not in COUNTED_CREATE_INTERCEPTS:
+            param = params[-1]
+            param_type = param.find('type').text
+            if self.isHandleType(param_type) and '*' in (param.find('type').tail or '') and param.text is None:
+                length = param.attrib.get('len')
+                text += '\n    entrypoint_scope.CountCreated(STATS_OBJECT_%s, %s);' % (param_type, length.replace('::', '->') if length else '1')
+        elif re.match(r'vk(Destroy|Free)', name):
+            for param in reversed(params):
+                param_type = param.find('type').text
+                if not self.isHandleType(param_type):
+                    continue
+                param_name = param.find('name').text
+                if '*' in (param.find('type').tail or ''):
+                    text += '\n    entrypoint_scope.CountDestroyed(STATS_OBJECT_%s, %s, %s);' % (param_type, param_name, param.attrib['len'])
+                else:
+                    text += '\n    entrypoint_scope.CountDestroyed(STATS_OBJECT_%s, %s != VK_NULL_HANDLE);' % (param_type, param_name)
+                break
+        return text
+
+    def isHandleType(self, handletype):
+        return self.isHandleTypeDispatchable(handletype) or self.isHandleTypeNonDispatchable(handletype)
+
     def isHandleTypeNonDispatchable(self, handletype):
         handle = self.registry.tree.find("types/type/[name='" + handletype + "'][@category='handle']")
         if handle is not None and handle.find('type').text == 'VK_DEFINE_NON_DISPATCHABLE_HANDLE':
@@ -1062,24 +6847,56 @@ class MockICDOutputGenerator(OutputGenerator):
             for s in genOpts.prefixText:
                 write(s, file=self.outFile)
         if self.header:
-            write('#include <unordered_map>', file=self.outFile)
+            write('#include <atomic>', file=self.outFile)
             write('#include <mutex>', file=self.outFile)
             write('#include <string>', file=self.outFile)
+            write('#include <cstddef>', file=self.outFile)
             write('#include <cstring>', file=self.outFile)
+            write('#include <new>', file=self.outFile)
+            write('#include <type_traits>', file=self.outFile)
+            write('#include <vector>', file=self.outFile)
             write('#include "vulkan/vk_icd.h"', file=self.outFile)
         else:
             write('#include "mock_icd.h"', file=self.outFile)
             write('#include <stdlib.h>', file=self.outFile)
             write('#include <vector>', file=self.outFile)
+            write('#include <algorithm>', file=self.outFile)
+            write('#include <chrono>', file=self.outFile)
+            write('#include <cctype>', file=self.outFile)
+            write('#include <climits>', file=self.outFile)
+            write('#include <cmath>', file=self.outFile)
+            write('#include <condition_variable>', file=self.outFile)
+            write('#include <cstdio>', file=self.outFile)
+            write('#include <deque>', file=self.outFile)
+            write('#include <functional>', file=self.outFile)
+            write('#include <map>', file=self.outFile)
+            write('#include <memory>', file=self.outFile)
+            write('#include <set>', file=self.outFile)
+            write('#include <thread>', file=self.outFile)
+            write('#if defined(__linux__) || defined(__APPLE__)', file=self.outFile)
+            write('#include <fcntl.h>', file=self.outFile)
+            write('#include <sys/mman.h>', file=self.outFile)
+            write('#include <time.h>', file=self.outFile)
+            write('#include <unistd.h>', file=self.outFile)
+            write('#endif', file=self.outFile)
+            write('#if defined(__linux__)', file=self.outFile)
+            write('#include <linux/futex.h>', file=self.outFile)
+            write('#include <sys/stat.h>', file=self.outFile)
+            write('#include <sys/syscall.h>', file=self.outFile)
+            write('#endif', file=self.outFile)
             write('#include "vk_typemap_helper.h"', file=self.outFile)
+            write('#include "mock_icd_stats.h"', file=self.outFile)
+            write('#include "mock_icd_json.h"', file=self.outFile)
+            write('#include "mock_icd_shader.h"', file=self.outFile)
+            write('#include "mock_icd_raster.h"', file=self.outFile)
 
         write('namespace vkmock {', file=self.outFile)
         if self.header:
             self.newline()
             write(HEADER_C_CODE, file=self.outFile)
             # Include all of the extensions in ICD except specific ignored ones
-            device_exts = []
-            instance_exts = []
+            device_exts = collections.OrderedDict()
+            instance_exts = collections.OrderedDict()
             # Ignore extensions that ICDs should not implement or are not safe to report
             ignore_exts = ['VK_EXT_validation_cache']
             for ext in self.registry.tree.findall("extensions/extension"):
@@ -1087,17 +6904,20 @@ class MockICDOutputGenerator(OutputGenerator):
                     if (ext.attrib['name'] in ignore_exts):
                         pass
                     elif (ext.attrib.get('type') and 'instance' == ext.attrib['type']):
-                        instance_exts.append('    {"%s", %s},' % (ext.attrib['name'], ext[0][0].attrib['value']))
+                        instance_exts[ext.attrib['name']] = ext[0][0].attrib['value']
                     else:
-                        device_exts.append('    {"%s", %s},' % (ext.attrib['name'], ext[0][0].attrib['value']))
+                        device_exts[ext.attrib['name']] = ext[0][0].attrib['value']
             write('// Map of instance extension name to version', file=self.outFile)
-            write('static const std::unordered_map<std::string, uint32_t> instance_extension_map = {', file=self.outFile)
-            write('\n'.join(instance_exts), file=self.outFile)
-            write('};', file=self.outFile)
+            write(NameTableText('uint32_t', 'instance_extension_map', instance_exts), file=self.outFile)
             write('// Map of device extension name to version', file=self.outFile)
-            write('static const std::unordered_map<std::string, uint32_t> device_extension_map = {', file=self.outFile)
-            write('\n'.join(device_exts), file=self.outFile)
-            write('};', file=self.outFile)
+            write(NameTableText('uint32_t', 'device_extension_map', device_exts), file=self.outFile)
+            write('// Fields of the structures that device profiles set', file=self.outFile)
+            for struct_name, table_name in [('VkPhysicalDeviceLimits', 'physical_device_limits_fields'),
+                                            ('VkPhysicalDeviceSparseProperties', 'physical_device_sparse_properties_fields'),
+                                            ('VkPhysicalDeviceFeatures', 'physical_device_features_fields')]:
+                write(self.profileFieldsText(struct_name, table_name), file=self.outFile)
+            write('// Texel blocks of the formats', file=self.outFile)
+            write(self.formatInfosText(), file=self.outFile)
 
         else:
             self.newline()
@@ -1110,9 +6930,37 @@ class MockICDOutputGenerator(OutputGenerator):
         if self.header:
             # record intercepted procedures
             write('// Map of all APIs to be intercepted by this layer', file=self.outFile)
-            write('static const std::unordered_map<std::string, void*> name_to_funcptr_map = {', file=self.outFile)
-            write('\n'.join(self.intercepts), file=self.outFile)
-            write('};\n', file=self.outFile)
+            intercepts = collections.OrderedDict((name, '(void*)%s' % name[2:]) for name, protect in self.intercepts)
+            write(NameTableText('void*', 'name_to_funcptr_map', intercepts, dict(self.intercepts)), file=self.outFile)
+            write('', file=self.outFile)
+            write('// Entrypoints as numbered in trace files and the cost model', file=self.outFile)
+            write('enum Entrypoint {', file=self.outFile)
+            for name in intercepts:
+                write('    ENTRYPOINT_%s,' % name, file=self.outFile)
+            write('    ENTRYPOINT_COUNT', file=self.outFile)
+            write('};', file=self.outFile)
+            write('static const char* const entrypoint_names[ENTRYPOINT_COUNT] = {', file=self.outFile)
+            for name in intercepts:
+                write('    "%s",' % name, file=self.outFile)
+            write('};', file=self.outFile)
+            write('', file=self.outFile)
+            handles = [handle.find('name').text for handle in self.registry.tree.findall("types/type[@category='handle']") if handle.find('name') is not None]
+            write('// Object types counted in the statistics', file=self.outFile)
+            write('enum StatsObject {', file=self.outFile)
+            for handle in handles:
+                write('    STATS_OBJECT_%s,' % handle, file=self.outFile)
+            write('    STATS_OBJECT_COUNT', file=self.outFile)
+            write('};', file=self.outFile)
+            write('static const char* const stats_object_names[STATS_OBJECT_COUNT] = {', file=self.outFile)
+            for handle in handles:
+                write('    "%s",' % handle, file=self.outFile)
+            write('};', file=self.outFile)
+            write('', file=self.outFile)
+            write('// Tables of the objects without state of their own', file=self.outFile)
+            for handle in handles:
+                if self.isHandleTypeNonDispatchable(handle) and handle not in OBJECT_TABLES:
+                    write('static ObjectTable<ObjectState> %s(STATS_OBJECT_%s);' % (ObjectTableName(handle), handle), file=self.outFile)
+            write('', file=self.outFile)
             self.newline()
             write('} // namespace vkmock', file=self.outFile)
             self.newline()
@@ -1207,11 +7055,7 @@ class MockICDOutputGenerator(OutputGenerator):
         if self.header: # In the header declare all intercepts
             self.appendSection('command', '')
             self.appendSection('command', 'static %s' % (decls[0]))
-            if (self.featureExtraProtect != None):
-                self.intercepts += [ '#ifdef %s' % self.featureExtraProtect ]
-            self.intercepts += [ '    {"%s", (void*)%s},' % (name,name[2:]) ]
-            if (self.featureExtraProtect != None):
-                self.intercepts += [ '#endif' ]
+            self.intercepts.append((name, self.featureExtraProtect))
             return
 
         manual_functions = [
@@ -1237,22 +7081,21 @@ class MockICDOutputGenerator(OutputGenerator):
                 self.appendSection('command', '// TODO: Implement custom intercept body')
             else:
                 self.appendSection('command', 'static %s' % (decls[0][:-1]))
-                self.appendSection('command', '{\n%s}' % (CUSTOM_C_INTERCEPTS[name]))
-            self.intercepts += [ '    {"%s", (void*)%s},' % (name,name[2:]) ]
+                self.appendSection('command', '{%s\n%s}' % (self.entrypointText(cmdinfo, name), CUSTOM_C_INTERCEPTS[name]))
+            self.intercepts.append((name, None))
             return
         # record that the function will be intercepted
-        if (self.featureExtraProtect != None):
-            self.intercepts += [ '#ifdef %s' % self.featureExtraProtect ]
-        self.intercepts += [ '    {"%s", (void*)%s},' % (name,name[2:]) ]
-        if (self.featureExtraProtect != None):
-            self.intercepts += [ '#endif' ]
+        self.intercepts.append((name, self.featureExtraProtect))
 
         OutputGenerator.genCmd(self, cmdinfo, name, alias)
         #
+        if name.startswith('vkCmd') and name not in CUSTOM_C_INTERCEPTS and (name + 'KHR') not in CUSTOM_C_INTERCEPTS:
+            self.genCmdRecord(cmdinfo, name, alias, decls)
+            return
         self.appendSection('command', '')
         self.appendSection('command', 'static %s' % (decls[0][:-1]))
         if name in CUSTOM_C_INTERCEPTS:
-            self.appendSection('command', '{%s}' % (CUSTOM_C_INTERCEPTS[name]))
+            self.appendSection('command', '{%s%s}' % (self.entrypointText(cmdinfo, name), CUSTOM_C_INTERCEPTS[name]))
             return
 
         # Declare result variable, if any.
@@ -1270,9 +7113,9 @@ class MockICDOutputGenerator(OutputGenerator):
             param_names = []
             for param in params:
                 param_names.append(param.text)
-            self.appendSection('command', '{\n    %s%s(%s);\n}' % (return_string, khr_name[2:], ", ".join(param_names)))
+            self.appendSection('command', '{%s\n    %s%s(%s);\n}' % (self.entrypointText(cmdinfo, name), return_string, khr_name[2:], ", ".join(param_names)))
             return
-        self.appendSection('command', '{')
+        self.appendSection('command', '{' + self.entrypointText(cmdinfo, name))
 
         api_function_name = cmdinfo.elem.attrib.get('name')
         # GET THE TYPE OF FUNCTION
@@ -1289,9 +7132,7 @@ class MockICDOutputGenerator(OutputGenerator):
             allocator_txt = 'CreateDispObjHandle()';
             if (self.isHandleTypeNonDispatchable(lp_type)):
                 handle_type = 'non-' + handle_type
-                allocator_txt = 'global_unique_handle++';
-            # Need to lock in both cases
-            self.appendSection('command', '    unique_lock_t lock(global_lock);')
+                allocator_txt = '%s.Create()' % ObjectTableName(lp_type);
             if (lp_len != None):
                 #print("%s last params (%s) has len %s" % (handle_type, lp_txt, lp_len))
                 self.appendSection('command', '    for (uint32_t i = 0; i < %s; ++i) {' % (lp_len))
@@ -1301,7 +7142,19 @@ class MockICDOutputGenerator(OutputGenerator):
                 #print("Single %s last param is '%s' w/ type '%s'" % (handle_type, lp_txt, lp_type))
                 self.appendSection('command', '    *%s = (%s)%s;' % (lp_txt, lp_type, allocator_txt))
         elif True in [ftxt in api_function_name for ftxt in ['Destroy', 'Free']]:
-            self.appendSection('command', '//Destroy object')
+            # The object is the last handle the call takes
+            for param in reversed(cmdinfo.elem.findall('param')):
+                param_type = param.find('type').text
+                if not self.isHandleType(param_type):
+                    continue
+                param_name = param.find('name').text
+                if not self.isHandleTypeNonDispatchable(param_type):
+                    self.appendSection('command', '//Destroy object')
+                elif '*' in (param.find('type').tail or ''):
+                    self.appendSection('command', '    for (uint32_t i = 0; i < %s; ++i) %s.Destroy(%s[i]);' % (param.attrib['len'], ObjectTableName(param_type), param_name))
+                else:
+                    self.appendSection('command', '    %s.Destroy(%s);' % (ObjectTableName(param_type), param_name))
+                break
         else:
             self.appendSection('command', '//Not a CREATE or DESTROY function')
 
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2019 The Khronos Group Inc.
+# Copyright (c) 2019 Valve Corporation
+# Copyright (c) 2019 LunarG, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# Prints the entrypoint trace the mock ICD writes to the file named by VK_MOCK_TRACE.
+# The layout of the file is described with TraceFileHeader in mock_icd_generator.py.
+
+import argparse
+import collections
+import struct
+import sys
+
+TRACE_FILE_MAGIC = b'VKMOCKTR'
+TRACE_FILE_VERSION = 1
+FILE_HEADER = struct.Struct('<8sII')
+BLOCK_HEADER = struct.Struct('<IIQ')
+RECORD = struct.Struct('<QII')
+
+# Entrypoint that ends a frame for --frames
+FRAME_END = 'vkQueuePresentKHR'
+
+Record = collections.namedtuple('Record', ['timestamp', 'thread', 'entrypoint', 'handles'])
+
+def ReadTrace(data):
+    magic, version, entrypoint_count = FILE_HEADER.unpack_from(data, 0)
+    if magic != TRACE_FILE_MAGIC:
+        sys.exit('Not a mock ICD trace file')
+    if version != TRACE_FILE_VERSION:
+        sys.exit('Unsupported trace file version %d' % version)
+    offset = FILE_HEADER.size
+    names = []
+    for i in range(entrypoint_count):
+        end = data.index(b'\0', offset)
+        names.append(data[offset:end].decode('ascii'))
+        offset = end + 1
+    records = []
+    dropped = collections.Counter()
+    while offset + BLOCK_HEADER.size <= len(data):
+        thread, size, block_dropped = BLOCK_HEADER.unpack_from(data, offset)
+        offset += BLOCK_HEADER.size
+        dropped[thread] += block_dropped
+        end = min(offset + size, len(data))
+        while offset + RECORD.size <= end:
+            timestamp, entrypoint, handle_count = RECORD.unpack_from(data, offset)
+            offset += RECORD.size
+            handles = struct.unpack_from('<%dQ' % handle_count, data, offset)
+            offset += 8 * handle_count
+            records.append(Record(timestamp, thread, names[entrypoint], handles))
+        offset = end
+    # Blocks of different threads are interleaved in the order they were flushed
+    records.sort(key=lambda record: record.timestamp)
+    return records, dropped
+
+def PrintRecords(records):
+    start = records[0].timestamp if records else 0
+    for record in records:
+        handles = ', '.join('0x%x' % handle for handle in record.handles)
+        print('%14.3f us  thread %-3d %s(%s)' % ((record.timestamp - start) / 1000.0, record.thread, record.entrypoint, handles))
+
+def PrintSummary(records):
+    counts = collections.Counter(record.entrypoint for record in records)
+    for name, count in counts.most_common():
+        print('%10d  %s' % (count, name))
+    print('%10d  total' % len(records))
+
+def PrintFrames(records):
+    frame = collections.Counter()
+    frame_count = 0
+    for record in records:
+        frame[record.entrypoint] += 1
+        if record.entrypoint == FRAME_END:
+            calls = ', '.join('%s x%d' % (name, count) for name, count in sorted(frame.items()))
+            print('frame %d: %d calls: %s' % (frame_count, sum(frame.values()), calls))
+            frame.clear()
+            frame_count += 1
+    if frame:
+        print('after last frame: %d calls' % sum(frame.values()))
+
+def main():
+    parser = argparse.ArgumentParser(description='Print an entrypoint trace written by the mock ICD.')
+    parser.add_argument('trace', help='trace file written to the path in VK_MOCK_TRACE')
+    mode = parser.add_mutually_exclusive_group()
+    mode.add_argument('--summary', action='store_true', help='count the calls of each entrypoint')
+    mode.add_argument('--frames', action='store_true', help='count the calls made in each frame, frames end with %s' % FRAME_END)
+    args = parser.parse_args()
+    with open(args.trace, 'rb') as trace_file:
+        records, dropped = ReadTrace(trace_file.read())
+    if args.summary:
+        PrintSummary(records)
+    elif args.frames:
+        PrintFrames(records)
+    else:
+        PrintRecords(records)
+    for thread, count in sorted(dropped.items()):
+        if count:
+            sys.stderr.write('thread %d dropped %d records\n' % (thread, count))
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include "mock_icd_test.h"
+
+static VkDescriptorSetLayout CreateLayout(const MockIcdDevice& device, VkDescriptorType type, uint32_t count) {
+    VkDescriptorSetLayoutBinding binding = {};
+    binding.descriptorType = type;
+    binding.descriptorCount = count;
+    binding.stageFlags = VK_SHADER_STAGE_ALL;
+    VkDescriptorSetLayoutCreateInfo layout_info = {};
+    layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_info.bindingCount = 1;
+    layout_info.pBindings = &binding;
+    VkDescriptorSetLayout layout;
+    CHECK_VK(vk.CreateDescriptorSetLayout(device.device, &layout_info, nullptr, &layout));
+    return layout;
+}
+
+// A pool of uniform buffers whose sets can be freed
+static VkDescriptorPool CreatePool(const MockIcdDevice& device, uint32_t max_sets, uint32_t uniform_buffers) {
+    const VkDescriptorPoolSize size = {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, uniform_buffers};
+    VkDescriptorPoolCreateInfo pool_info = {};
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    pool_info.maxSets = max_sets;
+    pool_info.poolSizeCount = 1;
+    pool_info.pPoolSizes = &size;
+    VkDescriptorPool pool;
+    CHECK_VK(vk.CreateDescriptorPool(device.device, &pool_info, nullptr, &pool));
+    return pool;
+}
+
+// Allocates a set with the layout for each of sets, checking that a failed call leaves none of them allocated
+static VkResult Allocate(const MockIcdDevice& device, VkDescriptorPool pool, VkDescriptorSetLayout layout,
+                         std::vector<VkDescriptorSet>* sets) {
+    const std::vector<VkDescriptorSetLayout> layouts(sets->size(), layout);
+    VkDescriptorSetAllocateInfo allocate_info = {};
+    allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocate_info.descriptorPool = pool;
+    allocate_info.descriptorSetCount = (uint32_t)layouts.size();
+    allocate_info.pSetLayouts = layouts.data();
+    const VkResult result = vk.AllocateDescriptorSets(device.device, &allocate_info, sets->data());
+    for (VkDescriptorSet set : *sets) CHECK(result == VK_SUCCESS ? set != VK_NULL_HANDLE : set == VK_NULL_HANDLE);
+    return result;
+}
+
+static VkResult Allocate(const MockIcdDevice& device, VkDescriptorPool pool, VkDescriptorSetLayout layout, uint32_t count) {
+    std::vector<VkDescriptorSet> sets(count);
+    return Allocate(device, pool, layout, &sets);
+}
+
+// Pools fail allocations beyond their maxSets or their descriptors of a type with VK_ERROR_OUT_OF_POOL_MEMORY
+static void TestExhaustion(const MockIcdDevice& device) {
+    const VkDescriptorSetLayout one_buffer = CreateLayout(device, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1);
+    const VkDescriptorSetLayout two_buffers = CreateLayout(device, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2);
+    const VkDescriptorSetLayout storage_buffer = CreateLayout(device, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1);
+
+    VkDescriptorPool pool = CreatePool(device, 2, 8);
+    CHECK(Allocate(device, pool, one_buffer, 3) == VK_ERROR_OUT_OF_POOL_MEMORY);
+    CHECK_VK(Allocate(device, pool, one_buffer, 2));
+    CHECK(Allocate(device, pool, one_buffer, 1) == VK_ERROR_OUT_OF_POOL_MEMORY);
+    vk.DestroyDescriptorPool(device.device, pool, nullptr);
+
+    pool = CreatePool(device, 8, 4);
+    CHECK(Allocate(device, pool, storage_buffer, 1) == VK_ERROR_OUT_OF_POOL_MEMORY);
+    CHECK(Allocate(device, pool, two_buffers, 3) == VK_ERROR_OUT_OF_POOL_MEMORY);
+    CHECK_VK(Allocate(device, pool, two_buffers, 2));
+    CHECK(Allocate(device, pool, one_buffer, 1) == VK_ERROR_OUT_OF_POOL_MEMORY);
+    vk.DestroyDescriptorPool(device.device, pool, nullptr);
+
+    vk.DestroyDescriptorSetLayout(device.device, one_buffer, nullptr);
+    vk.DestroyDescriptorSetLayout(device.device, two_buffers, nullptr);
+    vk.DestroyDescriptorSetLayout(device.device, storage_buffer, nullptr);
+}
+
+// A call that fails gives back the descriptors of the sets it allocated before failing, so that they can be taken
+// again as one range
+static void TestFailedAllocationRollback(const MockIcdDevice& device) {
+    const VkDescriptorSetLayout one_buffer = CreateLayout(device, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1);
+    const VkDescriptorSetLayout two_buffers = CreateLayout(device, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2);
+    const VkDescriptorSetLayout seven_buffers = CreateLayout(device, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 7);
+
+    const VkDescriptorPool pool = CreatePool(device, 8, 8);
+    CHECK_VK(Allocate(device, pool, one_buffer, 1));
+    // The first three sets fit, the fourth does not
+    CHECK(Allocate(device, pool, two_buffers, 4) == VK_ERROR_OUT_OF_POOL_MEMORY);
+    CHECK_VK(Allocate(device, pool, seven_buffers, 1));
+    vk.DestroyDescriptorPool(device.device, pool, nullptr);
+
+    vk.DestroyDescriptorSetLayout(device.device, one_buffer, nullptr);
+    vk.DestroyDescriptorSetLayout(device.device, two_buffers, nullptr);
+    vk.DestroyDescriptorSetLayout(device.device, seven_buffers, nullptr);
+}
+
+// Freeing every other set leaves enough descriptors for a larger set but no range to hold it, until the pool is reset
+static void TestFragmentation(const MockIcdDevice& device) {
+    const VkDescriptorSetLayout one_buffer = CreateLayout(device, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1);
+    const VkDescriptorSetLayout two_buffers = CreateLayout(device, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2);
+    const VkDescriptorSetLayout eight_buffers = CreateLayout(device, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 8);
+
+    const VkDescriptorPool pool = CreatePool(device, 8, 8);
+    std::vector<VkDescriptorSet> sets(8);
+    CHECK_VK(Allocate(device, pool, one_buffer, &sets));
+    const VkDescriptorSet freed[4] = {sets[0], sets[2], sets[4], sets[6]};
+    CHECK_VK(vk.FreeDescriptorSets(device.device, pool, 4, freed));
+    CHECK(Allocate(device, pool, two_buffers, 1) == VK_ERROR_FRAGMENTED_POOL);
+    // Sets of the size of the freed ones still fit
+    CHECK_VK(Allocate(device, pool, one_buffer, 4));
+    CHECK(Allocate(device, pool, one_buffer, 1) == VK_ERROR_OUT_OF_POOL_MEMORY);
+    CHECK_VK(vk.ResetDescriptorPool(device.device, pool, 0));
+    CHECK_VK(Allocate(device, pool, eight_buffers, 1));
+    vk.DestroyDescriptorPool(device.device, pool, nullptr);
+
+    vk.DestroyDescriptorSetLayout(device.device, one_buffer, nullptr);
+    vk.DestroyDescriptorSetLayout(device.device, two_buffers, nullptr);
+    vk.DestroyDescriptorSetLayout(device.device, eight_buffers, nullptr);
+}
+
+// Allocates sets of four uniform buffers in batches, writes their buffers and frees them, as a renderer recycling
+// per draw sets does, and prints the sets per second of each step
+static void BenchmarkAllocateUpdateFree(const MockIcdDevice& device, uint32_t rounds) {
+    const uint32_t SET_COUNT = 1024;
+    const uint32_t BATCH_SIZE = 64;
+    const uint32_t BUFFERS_PER_SET = 4;
+    const VkDescriptorSetLayout layout = CreateLayout(device, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, BUFFERS_PER_SET);
+    const VkDescriptorPool pool = CreatePool(device, SET_COUNT, SET_COUNT * BUFFERS_PER_SET);
+    VkBufferCreateInfo buffer_info = {};
+    buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_info.size = 256 * BUFFERS_PER_SET;
+    buffer_info.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    VkBuffer buffer;
+    CHECK_VK(vk.CreateBuffer(device.device, &buffer_info, nullptr, &buffer));
+    VkDescriptorBufferInfo buffer_infos[BUFFERS_PER_SET];
+    for (uint32_t i = 0; i < BUFFERS_PER_SET; ++i) buffer_infos[i] = {buffer, 256 * i, 256};
+
+    std::vector<VkDescriptorSet> sets(SET_COUNT);
+    std::vector<VkWriteDescriptorSet> writes(SET_COUNT);
+    double seconds[3] = {};
+    for (uint32_t round = 0; round < rounds; ++round) {
+        Timer allocate_timer;
+        for (uint32_t first = 0; first < SET_COUNT; first += BATCH_SIZE) {
+            std::vector<VkDescriptorSet> batch(BATCH_SIZE);
+            CHECK_VK(Allocate(device, pool, layout, &batch));
+            std::copy(batch.begin(), batch.end(), sets.begin() + first);
+        }
+        seconds[0] += allocate_timer.GetSeconds();
+        // A pool full of sets of one size is out of memory rather than fragmented
+        CHECK(Allocate(device, pool, layout, 1) == VK_ERROR_OUT_OF_POOL_MEMORY);
+
+        for (uint32_t i = 0; i < SET_COUNT; ++i) {
+            writes[i] = {};
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = sets[i];
+            writes[i].descriptorCount = BUFFERS_PER_SET;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            writes[i].pBufferInfo = buffer_infos;
+        }
+        Timer update_timer;
+        vk.UpdateDescriptorSets(device.device, SET_COUNT, writes.data(), 0, nullptr);
+        seconds[1] += update_timer.GetSeconds();
+
+        Timer free_timer;
+        for (uint32_t first = 0; first < SET_COUNT; first += BATCH_SIZE) {
+            CHECK_VK(vk.FreeDescriptorSets(device.device, pool, BATCH_SIZE, &sets[first]));
+        }
+        seconds[2] += free_timer.GetSeconds();
+    }
+
+    const char* const labels[3] = {"vkAllocateDescriptorSets", "vkUpdateDescriptorSets", "vkFreeDescriptorSets"};
+    printf("%-28s %16s\n", "command", "sets/s");
+    for (uint32_t i = 0; i < 3; ++i) printf("%-28s %16.0f\n", labels[i], (double)SET_COUNT * rounds / seconds[i]);
+
+    vk.DestroyBuffer(device.device, buffer, nullptr);
+    vk.DestroyDescriptorPool(device.device, pool, nullptr);
+    vk.DestroyDescriptorSetLayout(device.device, layout, nullptr);
+}
+
+int main(int argc, char** argv) {
+    MockIcdDevice device;
+    TestExhaustion(device);
+    TestFailedAllocationRollback(device);
+    TestFragmentation(device);
+    BenchmarkAllocateUpdateFree(device, 100 * GetBenchmarkScale(argc, argv));
+    return 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unordered_set>
+#include "mock_icd_test.h"
+
+// Creates and destroys buffers and samplers on 1 to 64 threads at once, checking that every handle is distinct
+int main(int argc, char** argv) {
+    const uint32_t handle_count = 65536 * GetBenchmarkScale(argc, argv);
+    MockIcdDevice device;
+
+    VkBufferCreateInfo buffer_info = {};
+    buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_info.size = 256;
+    buffer_info.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    VkSamplerCreateInfo sampler_info = {};
+    sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+
+    printf("%8s %16s %16s\n", "threads", "creates/s", "destroys/s");
+    for (uint32_t thread_count = 1; thread_count <= 64; thread_count *= 2) {
+        // Each thread creates a buffer and a sampler per iteration
+        const uint32_t per_thread = handle_count / 2 / thread_count;
+        std::vector<std::vector<VkBuffer>> buffers(thread_count, std::vector<VkBuffer>(per_thread));
+        std::vector<std::vector<VkSampler>> samplers(thread_count, std::vector<VkSampler>(per_thread));
+
+        const double create_seconds = RunOnThreads(thread_count, [&](uint32_t thread_index) {
+            for (uint32_t i = 0; i < per_thread; ++i) {
+                CHECK_VK(vk.CreateBuffer(device.device, &buffer_info, nullptr, &buffers[thread_index][i]));
+                CHECK_VK(vk.CreateSampler(device.device, &sampler_info, nullptr, &samplers[thread_index][i]));
+            }
+        });
+
+        std::unordered_set<uint64_t> handles;
+        for (uint32_t t = 0; t < thread_count; ++t) {
+            for (uint32_t i = 0; i < per_thread; ++i) {
+                CHECK(buffers[t][i] != VK_NULL_HANDLE && samplers[t][i] != VK_NULL_HANDLE);
+                CHECK(handles.insert((uint64_t)buffers[t][i]).second);
+                CHECK(handles.insert((uint64_t)samplers[t][i]).second);
+            }
+        }
+
+        const double destroy_seconds = RunOnThreads(thread_count, [&](uint32_t thread_index) {
+            for (uint32_t i = 0; i < per_thread; ++i) {
+                vk.DestroyBuffer(device.device, buffers[thread_index][i], nullptr);
+                vk.DestroySampler(device.device, samplers[thread_index][i], nullptr);
+            }
+        });
+
+        const double count = 2.0 * per_thread * thread_count;
+        printf("%8u %16.0f %16.0f\n", thread_count, count / create_seconds, count / destroy_seconds);
+    }
+    return 0;
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include "mock_icd_test.h"
+
+// A 2D R8G8B8A8_UNORM image bound to mapped memory. The mock lays out every image linearly, whatever its tiling, with
+// the samples of a multisampled image one after another, so the test reads and writes texels through the mapping.
+struct TestImage {
+    const MockIcdDevice& device;
+    VkImage image;
+    VkDeviceMemory memory;
+    char* data;
+    VkSubresourceLayout layout;
+    uint32_t width;
+    uint32_t height;
+    uint32_t samples;
+
+    TestImage(const MockIcdDevice& device, uint32_t width, uint32_t height, VkSampleCountFlagBits samples)
+        : device(device), width(width), height(height), samples(samples) {
+        VkImageCreateInfo image_info = {};
+        image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_info.imageType = VK_IMAGE_TYPE_2D;
+        image_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+        image_info.extent = {width, height, 1};
+        image_info.mipLevels = 1;
+        image_info.arrayLayers = 1;
+        image_info.samples = samples;
+        // Multisampled images cannot be linear
+        image_info.tiling = samples == VK_SAMPLE_COUNT_1_BIT ? VK_IMAGE_TILING_LINEAR : VK_IMAGE_TILING_OPTIMAL;
+        image_info.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        CHECK_VK(vk.CreateImage(device.device, &image_info, nullptr, &image));
+        VkMemoryRequirements requirements;
+        vk.GetImageMemoryRequirements(device.device, image, &requirements);
+        memory = device.AllocateMemory(requirements);
+        CHECK_VK(vk.BindImageMemory(device.device, image, memory, 0));
+        void* mapped;
+        CHECK_VK(vk.MapMemory(device.device, memory, 0, VK_WHOLE_SIZE, 0, &mapped));
+        data = static_cast<char*>(mapped);
+        const VkImageSubresource subresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0};
+        vk.GetImageSubresourceLayout(device.device, image, &subresource, &layout);
+        CHECK(layout.rowPitch >= width * 4 && layout.size >= layout.rowPitch * height * samples);
+    }
+
+    ~TestImage() {
+        vk.UnmapMemory(device.device, memory);
+        vk.DestroyImage(device.device, image, nullptr);
+        vk.FreeMemory(device.device, memory, nullptr);
+    }
+
+    uint8_t* GetTexel(uint32_t x, uint32_t y, uint32_t sample = 0) const {
+        return reinterpret_cast<uint8_t*>(data + layout.offset + sample * (layout.size / samples) + y * layout.rowPitch + x * 4);
+    }
+
+    // Bytes the texels of the image take
+    double GetSize() const { return 4.0 * width * height * samples; }
+};
+
+// Checks that every texel of an image has the given bytes
+static void CheckTexels(const TestImage& image, const uint8_t (&expected)[4]) {
+    for (uint32_t y = 0; y < image.height; ++y) {
+        for (uint32_t x = 0; x < image.width; ++x) {
+            const uint8_t* texel = image.GetTexel(x, y);
+            CHECK(texel[0] == expected[0] && texel[1] == expected[1] && texel[2] == expected[2] && texel[3] == expected[3]);
+        }
+    }
+}
+
+// Records repeats copies of a command into a command buffer and returns the seconds the queue took to execute them
+template <typename Record>
+static double TimeCommand(const MockIcdDevice& device, VkCommandBuffer command_buffer, uint32_t repeats, Record record) {
+    VkCommandBufferBeginInfo begin_info = {};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    CHECK_VK(vk.BeginCommandBuffer(command_buffer, &begin_info));
+    for (uint32_t i = 0; i < repeats; ++i) record();
+    CHECK_VK(vk.EndCommandBuffer(command_buffer));
+    Timer timer;
+    device.Execute(command_buffer);
+    return timer.GetSeconds();
+}
+
+static void PrintThroughput(const char* command, double bytes, double seconds) {
+    printf("%-36s %10.2f\n", command, bytes / seconds * 1e-9);
+}
+
+// Clears, blits and resolves images on the queue, checking the texels they produce, and prints the bytes per second
+// each moves, counting every texel read and written once
+int main(int argc, char** argv) {
+    const uint32_t repeats = 10 * GetBenchmarkScale(argc, argv);
+    MockIcdDevice device;
+
+    VkCommandPool pool;
+    VkCommandPoolCreateInfo pool_info = {};
+    pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    CHECK_VK(vk.CreateCommandPool(device.device, &pool_info, nullptr, &pool));
+    VkCommandBuffer command_buffer;
+    VkCommandBufferAllocateInfo allocate_info = {};
+    allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocate_info.commandPool = pool;
+    allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocate_info.commandBufferCount = 1;
+    CHECK_VK(vk.AllocateCommandBuffers(device.device, &allocate_info, &command_buffer));
+    const VkImageSubresourceRange range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    const VkImageSubresourceLayers layers = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+
+    printf("%-36s %10s\n", "command", "GB/s");
+
+    // Clear to a color whose channels all round differently
+    {
+        TestImage image(device, 2048, 2048, VK_SAMPLE_COUNT_1_BIT);
+        VkClearColorValue color;
+        color.float32[0] = 1.0f;
+        color.float32[1] = 0.5f;
+        color.float32[2] = 0.0f;
+        color.float32[3] = 0.25f;
+        const double seconds = TimeCommand(device, command_buffer, repeats, [&]() {
+            vk.CmdClearColorImage(command_buffer, image.image, VK_IMAGE_LAYOUT_GENERAL, &color, 1, &range);
+        });
+        const uint8_t expected[4] = {255, 128, 0, 64};
+        CheckTexels(image, expected);
+        PrintThroughput("vkCmdClearColorImage 2048x2048", image.GetSize() * repeats, seconds);
+    }
+
+    // Halve a checkerboard of black and white texels with linear filtering, as mip generation does. Every destination
+    // texel samples two of each, giving mid gray.
+    {
+        TestImage src(device, 2048, 2048, VK_SAMPLE_COUNT_1_BIT);
+        TestImage dst(device, 1024, 1024, VK_SAMPLE_COUNT_1_BIT);
+        for (uint32_t y = 0; y < src.height; ++y) {
+            for (uint32_t x = 0; x < src.width; ++x) {
+                const uint8_t value = (x + y) % 2 ? 255 : 0;
+                uint8_t* texel = src.GetTexel(x, y);
+                texel[0] = texel[1] = texel[2] = texel[3] = value;
+            }
+        }
+        VkImageBlit blit = {};
+        blit.srcSubresource = layers;
+        blit.srcOffsets[1] = {(int32_t)src.width, (int32_t)src.height, 1};
+        blit.dstSubresource = layers;
+        blit.dstOffsets[1] = {(int32_t)dst.width, (int32_t)dst.height, 1};
+        const double seconds = TimeCommand(device, command_buffer, repeats, [&]() {
+            vk.CmdBlitImage(command_buffer, src.image, VK_IMAGE_LAYOUT_GENERAL, dst.image, VK_IMAGE_LAYOUT_GENERAL, 1, &blit,
+                            VK_FILTER_LINEAR);
+        });
+        const uint8_t expected[4] = {128, 128, 128, 128};
+        CheckTexels(dst, expected);
+        PrintThroughput("vkCmdBlitImage 2048x2048 to 1024x1024", (src.GetSize() + dst.GetSize()) * repeats, seconds);
+    }
+
+    // Resolve 4 samples of 0, 64, 128 and 192, which average to 96
+    {
+        TestImage src(device, 1024, 1024, VK_SAMPLE_COUNT_4_BIT);
+        TestImage dst(device, 1024, 1024, VK_SAMPLE_COUNT_1_BIT);
+        for (uint32_t sample = 0; sample < src.samples; ++sample) {
+            for (uint32_t y = 0; y < src.height; ++y) memset(src.GetTexel(0, y, sample), sample * 64, src.width * 4);
+        }
+        VkImageResolve resolve = {};
+        resolve.srcSubresource = layers;
+        resolve.dstSubresource = layers;
+        resolve.extent = {src.width, src.height, 1};
+        const double seconds = TimeCommand(device, command_buffer, repeats, [&]() {
+            vk.CmdResolveImage(command_buffer, src.image, VK_IMAGE_LAYOUT_GENERAL, dst.image, VK_IMAGE_LAYOUT_GENERAL, 1, &resolve);
+        });
+        const uint8_t expected[4] = {96, 96, 96, 96};
+        CheckTexels(dst, expected);
+        PrintThroughput("vkCmdResolveImage 4x 1024x1024", (src.GetSize() + dst.GetSize()) * repeats, seconds);
+    }
+
+    vk.DestroyCommandPool(device.device, pool, nullptr);
+    return 0;
+}
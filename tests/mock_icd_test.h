@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MOCK_ICD_TEST_H
+#define MOCK_ICD_TEST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "vulkan/vulkan.h"
+
+// Tests and benchmarks of the mock ICD. They link the ICD and take its entrypoints from vk_icdGetInstanceProcAddr,
+// without a loader in between, so what they time is the ICD alone. Each is a program that exits with 1 when a check
+// fails. Benchmarks print what they measured and take the amount of work to do as a multiple of a default small
+// enough for CTest as their only argument.
+extern "C" VKAPI_ATTR VkResult VKAPI_CALL vk_icdNegotiateLoaderICDInterfaceVersion(uint32_t* pSupportedVersion);
+extern "C" VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vk_icdGetInstanceProcAddr(VkInstance instance, const char* pName);
+
+#define CHECK(condition)                                                                          \
+    do {                                                                                          \
+        if (!(condition)) {                                                                       \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);         \
+            exit(1);                                                                              \
+        }                                                                                         \
+    } while (0)
+#define CHECK_VK(call) CHECK((call) == VK_SUCCESS)
+
+// Entrypoints the tests call
+#define MOCK_ICD_TEST_ENTRYPOINTS(X)      \
+    X(CreateInstance)                     \
+    X(DestroyInstance)                    \
+    X(EnumeratePhysicalDevices)           \
+    X(GetPhysicalDeviceMemoryProperties)  \
+    X(CreateDevice)                       \
+    X(DestroyDevice)                      \
+    X(GetDeviceQueue)                     \
+    X(QueueSubmit)                        \
+    X(QueueWaitIdle)                      \
+    X(AllocateMemory)                     \
+    X(FreeMemory)                         \
+    X(MapMemory)                          \
+    X(UnmapMemory)                        \
+    X(CreateBuffer)                       \
+    X(DestroyBuffer)                      \
+    X(GetBufferMemoryRequirements)        \
+    X(BindBufferMemory)                   \
+    X(CreateImage)                        \
+    X(DestroyImage)                       \
+    X(GetImageMemoryRequirements)         \
+    X(BindImageMemory)                    \
+    X(GetImageSubresourceLayout)          \
+    X(CreateSampler)                      \
+    X(DestroySampler)                     \
+    X(CreateDescriptorSetLayout)          \
+    X(DestroyDescriptorSetLayout)         \
+    X(CreateDescriptorPool)               \
+    X(DestroyDescriptorPool)              \
+    X(ResetDescriptorPool)                \
+    X(AllocateDescriptorSets)             \
+    X(FreeDescriptorSets)                 \
+    X(UpdateDescriptorSets)               \
+    X(CreateCommandPool)                  \
+    X(DestroyCommandPool)                 \
+    X(ResetCommandPool)                   \
+    X(AllocateCommandBuffers)             \
+    X(BeginCommandBuffer)                 \
+    X(EndCommandBuffer)                   \
+    X(CmdSetViewport)                     \
+    X(CmdSetScissor)                      \
+    X(CmdSetBlendConstants)               \
+    X(CmdDraw)                            \
+    X(CmdDrawIndexed)                     \
+    X(CmdClearColorImage)                 \
+    X(CmdBlitImage)                       \
+    X(CmdResolveImage)
+
+struct MockIcdEntrypoints {
+#define MOCK_ICD_TEST_DECLARE(name) PFN_vk##name name = nullptr;
+    MOCK_ICD_TEST_ENTRYPOINTS(MOCK_ICD_TEST_DECLARE)
+#undef MOCK_ICD_TEST_DECLARE
+};
+static MockIcdEntrypoints vk;
+
+// An instance and a device with one queue, of the mock's first physical device
+struct MockIcdDevice {
+    VkInstance instance = VK_NULL_HANDLE;
+    VkPhysicalDevice physical_device = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+
+    MockIcdDevice() {
+        // As the loader would, so that the mock accepts instances of Vulkan 1.1
+        uint32_t interface_version = 5;
+        CHECK_VK(vk_icdNegotiateLoaderICDInterfaceVersion(&interface_version));
+        CHECK(interface_version == 5);
+
+        // The mock returns every entrypoint whatever the instance, as the loader expects of ICDs
+#define MOCK_ICD_TEST_LOAD(name) vk.name = reinterpret_cast<PFN_vk##name>(vk_icdGetInstanceProcAddr(VK_NULL_HANDLE, "vk" #name));
+        MOCK_ICD_TEST_ENTRYPOINTS(MOCK_ICD_TEST_LOAD)
+#undef MOCK_ICD_TEST_LOAD
+#define MOCK_ICD_TEST_CHECK(name) CHECK(vk.name);
+        MOCK_ICD_TEST_ENTRYPOINTS(MOCK_ICD_TEST_CHECK)
+#undef MOCK_ICD_TEST_CHECK
+
+        VkApplicationInfo application_info = {};
+        application_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+        application_info.apiVersion = VK_API_VERSION_1_1;
+        VkInstanceCreateInfo instance_info = {};
+        instance_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+        instance_info.pApplicationInfo = &application_info;
+        CHECK_VK(vk.CreateInstance(&instance_info, nullptr, &instance));
+        uint32_t count = 1;
+        const VkResult result = vk.EnumeratePhysicalDevices(instance, &count, &physical_device);
+        CHECK((result == VK_SUCCESS || result == VK_INCOMPLETE) && count == 1);
+
+        const float priority = 1.0f;
+        VkDeviceQueueCreateInfo queue_info = {};
+        queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queue_info.queueFamilyIndex = 0;
+        queue_info.queueCount = 1;
+        queue_info.pQueuePriorities = &priority;
+        VkDeviceCreateInfo device_info = {};
+        device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        device_info.queueCreateInfoCount = 1;
+        device_info.pQueueCreateInfos = &queue_info;
+        CHECK_VK(vk.CreateDevice(physical_device, &device_info, nullptr, &device));
+        vk.GetDeviceQueue(device, 0, 0, &queue);
+    }
+
+    ~MockIcdDevice() {
+        vk.DestroyDevice(device, nullptr);
+        vk.DestroyInstance(instance, nullptr);
+    }
+
+    // Host visible memory for resources with these requirements
+    VkDeviceMemory AllocateMemory(const VkMemoryRequirements& requirements) const {
+        VkPhysicalDeviceMemoryProperties properties;
+        vk.GetPhysicalDeviceMemoryProperties(physical_device, &properties);
+        VkMemoryAllocateInfo allocate_info = {};
+        allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocate_info.allocationSize = requirements.size;
+        allocate_info.memoryTypeIndex = UINT32_MAX;
+        for (uint32_t i = 0; i < properties.memoryTypeCount && allocate_info.memoryTypeIndex == UINT32_MAX; ++i) {
+            const bool host_visible = (properties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+            if ((requirements.memoryTypeBits >> i & 1) && host_visible) allocate_info.memoryTypeIndex = i;
+        }
+        CHECK(allocate_info.memoryTypeIndex != UINT32_MAX);
+        VkDeviceMemory memory;
+        CHECK_VK(vk.AllocateMemory(device, &allocate_info, nullptr, &memory));
+        return memory;
+    }
+
+    // Submits a command buffer and waits for the queue to execute it
+    void Execute(VkCommandBuffer command_buffer) const {
+        VkSubmitInfo submit_info = {};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &command_buffer;
+        CHECK_VK(vk.QueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE));
+        CHECK_VK(vk.QueueWaitIdle(queue));
+    }
+};
+
+// Multiple of the default amount of work of a benchmark, from its first argument
+inline uint32_t GetBenchmarkScale(int argc, char** argv) {
+    const long scale = argc > 1 ? strtol(argv[1], nullptr, 10) : 1;
+    return scale > 0 ? (uint32_t)scale : 1;
+}
+
+// Seconds since the timer started
+class Timer {
+   public:
+    double GetSeconds() const { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count(); }
+
+   private:
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+};
+
+// Calls function(thread_index) on thread_count threads and returns the seconds from when all of them were ready to when
+// the last one returned
+template <typename Function>
+double RunOnThreads(uint32_t thread_count, Function function) {
+    std::atomic<uint32_t> ready(0);
+    std::atomic<bool> start(false);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&, i]() {
+            ready.fetch_add(1);
+            while (!start.load()) std::this_thread::yield();
+            function(i);
+        });
+    }
+    while (ready.load() != thread_count) std::this_thread::yield();
+    Timer timer;
+    start.store(true);
+    for (auto& thread : threads) thread.join();
+    return timer.GetSeconds();
+}
+
+#endif  // MOCK_ICD_TEST_H
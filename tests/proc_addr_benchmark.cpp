@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include "mock_icd_test.h"
+
+// What a loader and a layer would query at startup: the core entrypoints and some of the WSI ones
+static const char* const ENTRYPOINT_NAMES[] = {
+    "vkAllocateCommandBuffers", "vkAllocateDescriptorSets", "vkAllocateMemory", "vkBeginCommandBuffer",
+    "vkBindBufferMemory", "vkBindBufferMemory2", "vkBindImageMemory", "vkBindImageMemory2", "vkCmdBeginQuery",
+    "vkCmdBeginRenderPass", "vkCmdBeginRenderPass2", "vkCmdBindDescriptorSets", "vkCmdBindIndexBuffer",
+    "vkCmdBindPipeline", "vkCmdBindVertexBuffers", "vkCmdBlitImage", "vkCmdClearAttachments", "vkCmdClearColorImage",
+    "vkCmdClearDepthStencilImage", "vkCmdCopyBuffer", "vkCmdCopyBufferToImage", "vkCmdCopyImage",
+    "vkCmdCopyImageToBuffer", "vkCmdCopyQueryPoolResults", "vkCmdDispatch", "vkCmdDispatchBase",
+    "vkCmdDispatchIndirect", "vkCmdDraw", "vkCmdDrawIndexed", "vkCmdDrawIndexedIndirect",
+    "vkCmdDrawIndexedIndirectCount", "vkCmdDrawIndirect", "vkCmdDrawIndirectCount", "vkCmdEndQuery",
+    "vkCmdEndRenderPass", "vkCmdEndRenderPass2", "vkCmdExecuteCommands", "vkCmdFillBuffer", "vkCmdNextSubpass",
+    "vkCmdNextSubpass2", "vkCmdPipelineBarrier", "vkCmdPushConstants", "vkCmdResetEvent", "vkCmdResetQueryPool",
+    "vkCmdResolveImage", "vkCmdSetBlendConstants", "vkCmdSetDepthBias", "vkCmdSetDepthBounds", "vkCmdSetDeviceMask",
+    "vkCmdSetEvent", "vkCmdSetLineWidth", "vkCmdSetScissor", "vkCmdSetStencilCompareMask", "vkCmdSetStencilReference",
+    "vkCmdSetStencilWriteMask", "vkCmdSetViewport", "vkCmdUpdateBuffer", "vkCmdWaitEvents", "vkCmdWriteTimestamp",
+    "vkCreateBuffer", "vkCreateBufferView", "vkCreateCommandPool", "vkCreateComputePipelines", "vkCreateDescriptorPool",
+    "vkCreateDescriptorSetLayout", "vkCreateDescriptorUpdateTemplate", "vkCreateDevice", "vkCreateEvent",
+    "vkCreateFence", "vkCreateFramebuffer", "vkCreateGraphicsPipelines", "vkCreateImage", "vkCreateImageView",
+    "vkCreateInstance", "vkCreatePipelineCache", "vkCreatePipelineLayout", "vkCreateQueryPool", "vkCreateRenderPass",
+    "vkCreateRenderPass2", "vkCreateSampler", "vkCreateSamplerYcbcrConversion", "vkCreateSemaphore",
+    "vkCreateShaderModule", "vkDestroyBuffer", "vkDestroyBufferView", "vkDestroyCommandPool", "vkDestroyDescriptorPool",
+    "vkDestroyDescriptorSetLayout", "vkDestroyDescriptorUpdateTemplate", "vkDestroyDevice", "vkDestroyEvent",
+    "vkDestroyFence", "vkDestroyFramebuffer", "vkDestroyImage", "vkDestroyImageView", "vkDestroyInstance",
+    "vkDestroyPipeline", "vkDestroyPipelineCache", "vkDestroyPipelineLayout", "vkDestroyQueryPool",
+    "vkDestroyRenderPass", "vkDestroySampler", "vkDestroySamplerYcbcrConversion", "vkDestroySemaphore",
+    "vkDestroyShaderModule", "vkDeviceWaitIdle", "vkEndCommandBuffer", "vkEnumerateDeviceExtensionProperties",
+    "vkEnumerateDeviceLayerProperties", "vkEnumerateInstanceExtensionProperties", "vkEnumerateInstanceLayerProperties",
+    "vkEnumerateInstanceVersion", "vkEnumeratePhysicalDeviceGroups", "vkEnumeratePhysicalDevices",
+    "vkFlushMappedMemoryRanges", "vkFreeCommandBuffers", "vkFreeDescriptorSets", "vkFreeMemory",
+    "vkGetBufferDeviceAddress", "vkGetBufferMemoryRequirements", "vkGetBufferMemoryRequirements2",
+    "vkGetBufferOpaqueCaptureAddress", "vkGetDescriptorSetLayoutSupport", "vkGetDeviceGroupPeerMemoryFeatures",
+    "vkGetDeviceMemoryCommitment", "vkGetDeviceMemoryOpaqueCaptureAddress", "vkGetDeviceProcAddr", "vkGetDeviceQueue",
+    "vkGetDeviceQueue2", "vkGetEventStatus", "vkGetFenceStatus", "vkGetImageMemoryRequirements",
+    "vkGetImageMemoryRequirements2", "vkGetImageSparseMemoryRequirements", "vkGetImageSparseMemoryRequirements2",
+    "vkGetImageSubresourceLayout", "vkGetInstanceProcAddr", "vkGetPhysicalDeviceExternalBufferProperties",
+    "vkGetPhysicalDeviceExternalFenceProperties", "vkGetPhysicalDeviceExternalSemaphoreProperties",
+    "vkGetPhysicalDeviceFeatures", "vkGetPhysicalDeviceFeatures2", "vkGetPhysicalDeviceFormatProperties",
+    "vkGetPhysicalDeviceFormatProperties2", "vkGetPhysicalDeviceImageFormatProperties",
+    "vkGetPhysicalDeviceImageFormatProperties2", "vkGetPhysicalDeviceMemoryProperties",
+    "vkGetPhysicalDeviceMemoryProperties2", "vkGetPhysicalDeviceProperties", "vkGetPhysicalDeviceProperties2",
+    "vkGetPhysicalDeviceQueueFamilyProperties", "vkGetPhysicalDeviceQueueFamilyProperties2",
+    "vkGetPhysicalDeviceSparseImageFormatProperties", "vkGetPhysicalDeviceSparseImageFormatProperties2",
+    "vkGetPipelineCacheData", "vkGetQueryPoolResults", "vkGetRenderAreaGranularity", "vkGetSemaphoreCounterValue",
+    "vkInvalidateMappedMemoryRanges", "vkMapMemory", "vkMergePipelineCaches", "vkQueueBindSparse", "vkQueueSubmit",
+    "vkQueueWaitIdle", "vkResetCommandBuffer", "vkResetCommandPool", "vkResetDescriptorPool", "vkResetEvent",
+    "vkResetFences", "vkResetQueryPool", "vkSetEvent", "vkSignalSemaphore", "vkTrimCommandPool", "vkUnmapMemory",
+    "vkUpdateDescriptorSetWithTemplate", "vkUpdateDescriptorSets", "vkWaitForFences", "vkWaitSemaphores",
+    "vkCreateSwapchainKHR", "vkGetPhysicalDeviceSurfaceSupportKHR", "vkGetPhysicalDeviceSurfaceCapabilitiesKHR",
+    "vkAcquireNextImageKHR", "vkQueuePresentKHR", "vkCreateDebugUtilsMessengerEXT", "vkCmdPushDescriptorSetKHR",
+    "vkGetPhysicalDeviceFeatures2KHR",
+};
+
+// Names close to real ones, none of which the mock implements
+static const char* const BOGUS_NAMES[] = {
+    "", "vk", "vkCreateInstanc", "vkCreateInstancf", "vkCreateInstanceX", "vkcreateinstance", "CreateInstance",
+    "vkNotAnEntrypoint",
+};
+
+// Looks every name up with vk_icdGetInstanceProcAddr and vkGetDeviceProcAddr and with a std::unordered_map of
+// std::string keys, which is how the mock looked them up before the perfect hash, checking all three agree
+int main(int argc, char** argv) {
+    const uint32_t rounds = 2000 * GetBenchmarkScale(argc, argv);
+    MockIcdDevice device;
+    const auto get_device_proc_addr =
+        reinterpret_cast<PFN_vkGetDeviceProcAddr>(vk_icdGetInstanceProcAddr(device.instance, "vkGetDeviceProcAddr"));
+    CHECK(get_device_proc_addr);
+
+    // Copies, so that no lookup can rely on the address of a name
+    std::vector<std::string> names(std::begin(ENTRYPOINT_NAMES), std::end(ENTRYPOINT_NAMES));
+    std::unordered_map<std::string, PFN_vkVoidFunction> baseline;
+    for (const auto& name : names) {
+        const PFN_vkVoidFunction function = vk_icdGetInstanceProcAddr(device.instance, name.c_str());
+        CHECK(function);
+        CHECK(get_device_proc_addr(device.device, name.c_str()) == function);
+        baseline[name] = function;
+    }
+    for (const char* name : BOGUS_NAMES) {
+        CHECK(!vk_icdGetInstanceProcAddr(device.instance, name));
+        CHECK(!get_device_proc_addr(device.device, name));
+    }
+
+    // Each pass sums the functions it finds, so the compiler keeps every lookup and the passes can be compared
+    uintptr_t sums[3] = {};
+    double seconds[3] = {};
+    {
+        Timer timer;
+        for (uint32_t r = 0; r < rounds; ++r) {
+            for (const auto& name : names) sums[0] += (uintptr_t)vk_icdGetInstanceProcAddr(device.instance, name.c_str());
+        }
+        seconds[0] = timer.GetSeconds();
+    }
+    {
+        Timer timer;
+        for (uint32_t r = 0; r < rounds; ++r) {
+            for (const auto& name : names) sums[1] += (uintptr_t)get_device_proc_addr(device.device, name.c_str());
+        }
+        seconds[1] = timer.GetSeconds();
+    }
+    {
+        Timer timer;
+        for (uint32_t r = 0; r < rounds; ++r) {
+            for (const auto& name : names) {
+                const auto item = baseline.find(name.c_str());
+                sums[2] += item != baseline.end() ? (uintptr_t)item->second : 0;
+            }
+        }
+        seconds[2] = timer.GetSeconds();
+    }
+    CHECK(sums[0] == sums[2] && sums[1] == sums[2]);
+
+    const char* const labels[3] = {"vk_icdGetInstanceProcAddr", "vkGetDeviceProcAddr", "std::unordered_map"};
+    const double lookups = (double)rounds * names.size();
+    printf("%-28s %16s %12s\n", "lookup", "lookups/s", "ns/lookup");
+    for (uint32_t i = 0; i < 3; ++i) {
+        printf("%-28s %16.0f %12.1f\n", labels[i], lookups / seconds[i], seconds[i] * 1e9 / lookups);
+    }
+    return 0;
+}
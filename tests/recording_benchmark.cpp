@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include "mock_icd_test.h"
+
+// Commands recorded per command buffer, in groups of five
+static const uint32_t COMMANDS_PER_BUFFER = 5000;
+
+// Records state and draw commands on up to 64 threads, each into a command buffer of its own pool, which it resets
+// after every command buffer
+int main(int argc, char** argv) {
+    const uint32_t buffers_per_thread = 200 * GetBenchmarkScale(argc, argv);
+    const uint32_t max_thread_count = std::min(64u, std::max(1u, std::thread::hardware_concurrency()));
+    MockIcdDevice device;
+
+    const VkViewport viewport = {0.0f, 0.0f, 1920.0f, 1080.0f, 0.0f, 1.0f};
+    const VkRect2D scissor = {{0, 0}, {1920, 1080}};
+    const float blend_constants[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+
+    printf("%8s %16s %20s\n", "threads", "commands/s", "commands/s/thread");
+    for (uint32_t thread_count = 1; thread_count <= max_thread_count; thread_count *= 2) {
+        std::vector<VkCommandPool> pools(thread_count);
+        std::vector<VkCommandBuffer> command_buffers(thread_count);
+        for (uint32_t t = 0; t < thread_count; ++t) {
+            VkCommandPoolCreateInfo pool_info = {};
+            pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            CHECK_VK(vk.CreateCommandPool(device.device, &pool_info, nullptr, &pools[t]));
+            VkCommandBufferAllocateInfo allocate_info = {};
+            allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocate_info.commandPool = pools[t];
+            allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocate_info.commandBufferCount = 1;
+            CHECK_VK(vk.AllocateCommandBuffers(device.device, &allocate_info, &command_buffers[t]));
+        }
+
+        const double seconds = RunOnThreads(thread_count, [&](uint32_t thread_index) {
+            const VkCommandBuffer command_buffer = command_buffers[thread_index];
+            VkCommandBufferBeginInfo begin_info = {};
+            begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            for (uint32_t b = 0; b < buffers_per_thread; ++b) {
+                CHECK_VK(vk.BeginCommandBuffer(command_buffer, &begin_info));
+                for (uint32_t i = 0; i < COMMANDS_PER_BUFFER; i += 5) {
+                    vk.CmdSetViewport(command_buffer, 0, 1, &viewport);
+                    vk.CmdSetScissor(command_buffer, 0, 1, &scissor);
+                    vk.CmdSetBlendConstants(command_buffer, blend_constants);
+                    vk.CmdDraw(command_buffer, 3, 1, i, 0);
+                    vk.CmdDrawIndexed(command_buffer, 36, 1, 0, (int32_t)i, 0);
+                }
+                CHECK_VK(vk.EndCommandBuffer(command_buffer));
+                CHECK_VK(vk.ResetCommandPool(device.device, pools[thread_index], 0));
+            }
+        });
+
+        for (uint32_t t = 0; t < thread_count; ++t) vk.DestroyCommandPool(device.device, pools[t], nullptr);
+        const double commands = (double)COMMANDS_PER_BUFFER * buffers_per_thread * thread_count;
+        printf("%8u %16.0f %20.0f\n", thread_count, commands / seconds, commands / seconds / thread_count);
+    }
+    return 0;
+}
@@ -700,6 +700,94 @@ static void ConsoleEnlarge() {
 }
 #endif
 
+#if defined(__linux__) || defined(__APPLE__)
+// Prints the statistics of an application running on the mock ICD once a second, until the application exits
+static int WatchMockStats(const char *name) {
+    const std::string shm_name = name[0] == '/' ? name : std::string("/") + name;
+    const int fd = shm_open(shm_name.c_str(), O_RDONLY, 0);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(vkmock::StatsHeader)) {
+        fprintf(stderr, "No mock ICD statistics named %s, run the application with VK_MOCK_STATS=%s\n", name, name);
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+    const size_t size = (size_t)info.st_size;
+    void *data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    const vkmock::StatsHeader *header = static_cast<const vkmock::StatsHeader *>(data);
+    if (data == MAP_FAILED || memcmp(header->magic, vkmock::STATS_MAGIC, sizeof(vkmock::STATS_MAGIC)) != 0 ||
+        header->version != vkmock::STATS_VERSION ||
+        header->slots_offset + (uint64_t)header->slot_count * header->counter_count * sizeof(uint64_t) > size) {
+        fprintf(stderr, "%s does not hold mock ICD statistics this vulkaninfo can read\n", name);
+        if (data != MAP_FAILED) munmap(data, size);
+        return 1;
+    }
+
+    const char *names = static_cast<const char *>(data) + header->names_offset;
+    std::vector<std::string> entrypoint_names, object_names;
+    for (uint32_t i = 0; i < header->entrypoint_count + header->object_type_count; ++i) {
+        (i < header->entrypoint_count ? entrypoint_names : object_names).push_back(names);
+        names += strlen(names) + 1;
+    }
+    const uint32_t created = header->entrypoint_count;
+    const uint32_t destroyed = created + header->object_type_count;
+    const uint32_t allocated = destroyed + header->object_type_count;
+    const uint32_t freed = allocated + header->heap_count;
+    const uint32_t trailing = (uint32_t)vkmock::GetStatsTrailingCounterIndex(*header);
+    const uint32_t mapped = trailing + vkmock::STATS_TRAILING_MEMORY_MAPPED;
+    const uint32_t unmapped = trailing + vkmock::STATS_TRAILING_MEMORY_UNMAPPED;
+    const uint32_t exhausted = trailing + vkmock::STATS_TRAILING_DESCRIPTOR_POOLS_EXHAUSTED;
+    const uint32_t fragmented = trailing + vkmock::STATS_TRAILING_DESCRIPTOR_POOLS_FRAGMENTED;
+    const volatile uint64_t *slots = reinterpret_cast<const volatile uint64_t *>(static_cast<const char *>(data) + header->slots_offset);
+
+    std::vector<uint64_t> totals(header->counter_count), previous(header->counter_count);
+    for (bool first = true; kill(header->process_id, 0) == 0 || errno != ESRCH; first = false) {
+        std::fill(totals.begin(), totals.end(), 0);
+        for (uint32_t slot = 0; slot < header->slot_count; ++slot) {
+            for (uint32_t counter = 0; counter < header->counter_count; ++counter) {
+                totals[counter] += slots[slot * header->counter_count + counter];
+            }
+        }
+        if (!first) {
+            std::vector<std::pair<uint64_t, uint32_t>> calls;
+            uint64_t total_calls = 0;
+            for (uint32_t i = 0; i < header->entrypoint_count; ++i) {
+                if (totals[i] != previous[i]) calls.emplace_back(totals[i] - previous[i], i);
+                total_calls += totals[i] - previous[i];
+            }
+            std::sort(calls.rbegin(), calls.rend());
+            printf("Process %u: %" PRIu64 " calls/s\n", header->process_id, total_calls);
+            for (const auto &call : calls) printf("    %-48s %12" PRIu64 "/s\n", entrypoint_names[call.second].c_str(), call.first);
+            printf("Live objects:\n");
+            for (uint32_t i = 0; i < header->object_type_count; ++i) {
+                if (!totals[created + i]) continue;
+                printf("    %-48s %12" PRId64 " (%" PRIu64 " created/s)\n", object_names[i].c_str(),
+                       (int64_t)(totals[created + i] - totals[destroyed + i]), totals[created + i] - previous[created + i]);
+            }
+            printf("Memory:\n");
+            for (uint32_t i = 0; i < header->heap_count; ++i) {
+                if (!totals[allocated + i]) continue;
+                printf("    Heap %-43u %12" PRIu64 " bytes allocated\n", i, totals[allocated + i] - totals[freed + i]);
+            }
+            printf("    %-48s %12" PRIu64 " bytes\n", "Mapped", totals[mapped] - totals[unmapped]);
+            if (header->counter_count > fragmented) {
+                printf("Descriptor pools:\n");
+                printf("    %-48s %12" PRIu64 " (%" PRIu64 "/s)\n", "Out of pool memory", totals[exhausted],
+                       totals[exhausted] - previous[exhausted]);
+                printf("    %-48s %12" PRIu64 " (%" PRIu64 "/s)\n", "Fragmented", totals[fragmented],
+                       totals[fragmented] - previous[fragmented]);
+            }
+            printf("\n");
+            fflush(stdout);
+        }
+        previous.swap(totals);
+        sleep(1);
+    }
+    munmap(data, size);
+    return 0;
+}
+#endif
+
 void print_usage(const char *argv0) {
     std::cout << "\nvulkaninfo - Summarize Vulkan information in relation to the current environment.\n\n";
     std::cout << "USAGE: " << argv0 << " [options]\n\n";
@@ -716,7 +804,13 @@ void print_usage(const char *argv0) {
     std::cout << "                      vulkaninfo without any options specified.\n";
     std::cout << "--show-formats        Display the format properties of each physical device.\n";
     std::cout << "                      Note: This option does not affect html or json output;\n";
-    std::cout << "                      they will always print format properties.\n\n";
+    std::cout << "                      they will always print format properties.\n";
+#if defined(__linux__) || defined(__APPLE__)
+    std::cout << "--watch-mock=<name>   Print the calls, live objects and memory of an application\n";
+    std::cout << "                      running on the mock ICD with VK_MOCK_STATS=<name> once a\n";
+    std::cout << "                      second, until the application exits.\n";
+#endif
+    std::cout << "\n";
 }
 
 int main(int argc, char **argv) {
@@ -745,6 +839,10 @@ int main(int argc, char **argv) {
             html_output = true;
         } else if (strcmp(argv[i], "--show-formats") == 0) {
             show_formats = true;
+#if defined(__linux__) || defined(__APPLE__)
+        } else if (strncmp("--watch-mock=", argv[i], 13) == 0 && argv[i][13] != '\0') {
+            return WatchMockStats(argv[i] + 13);
+#endif
         } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
             print_usage(argv[0]);
             return 1;
@@ -58,6 +58,18 @@
 #include <io.h>
 #endif  // _WIN32
 
+#if defined(__linux__) || defined(__APPLE__)
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mock_icd_stats.h"
+#endif
+
 #if defined(VK_USE_PLATFORM_XLIB_KHR) || defined(VK_USE_PLATFORM_XCB_KHR)
 #include <X11/Xutil.h>
 #endif